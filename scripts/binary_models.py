@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Reader for the binary model output of `--binary-model-output`.
+See `source/BinaryJson.h` for the format.
+
+Usage:
+  python3 binary_models.py model@00000-of-00001.mtb > models.json
+or, as a library:
+  for model in binary_models.read_directory("."): ...
+"""
+
+import json
+import os
+import struct
+import sys
+from typing import Any, BinaryIO, Iterable, List, Tuple
+
+MAGIC = b"MTBJ"
+VERSION = 1
+
+
+def _read_exact(file: BinaryIO, size: int) -> bytes:
+    data = file.read(size)
+    if len(data) != size:
+        raise ValueError("unexpected end of binary json input")
+    return data
+
+
+def _read_varint(file: BinaryIO) -> int:
+    value = 0
+    shift = 0
+    while True:
+        byte = _read_exact(file, 1)[0]
+        value |= (byte & 0x7F) << shift
+        if byte & 0x80 == 0:
+            return value
+        shift += 7
+
+
+def _decode_varint(record: bytes, position: int) -> Tuple[int, int]:
+    value = 0
+    shift = 0
+    while True:
+        byte = record[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        if byte & 0x80 == 0:
+            return (value, position)
+        shift += 7
+
+
+def _decode(record: bytes, position: int, strings: List[str]) -> Tuple[Any, int]:
+    tag = record[position]
+    position += 1
+    if tag == 0:
+        return (None, position)
+    if tag == 1:
+        return (False, position)
+    if tag == 2:
+        return (True, position)
+    if tag == 3:
+        zigzag, position = _decode_varint(record, position)
+        return ((zigzag >> 1) ^ -(zigzag & 1), position)
+    if tag == 4:
+        return _decode_varint(record, position)
+    if tag == 5:
+        (real,) = struct.unpack_from("<d", record, position)
+        return (real, position + 8)
+    if tag == 6:
+        index, position = _decode_varint(record, position)
+        return (strings[index], position)
+    if tag == 7:
+        size, position = _decode_varint(record, position)
+        elements = []
+        for _ in range(size):
+            element, position = _decode(record, position, strings)
+            elements.append(element)
+        return (elements, position)
+    if tag == 8:
+        size, position = _decode_varint(record, position)
+        members = {}
+        for _ in range(size):
+            index, position = _decode_varint(record, position)
+            members[strings[index]], position = _decode(record, position, strings)
+        return (members, position)
+    raise ValueError(f"invalid tag {tag} in binary json")
+
+
+def read_file(path: str) -> Iterable[Any]:
+    """Yield the models stored in the given binary shard."""
+    with open(path, "rb") as file:
+        if _read_exact(file, len(MAGIC)) != MAGIC:
+            raise ValueError(f"`{path}` is not binary json")
+        version = _read_varint(file)
+        if version != VERSION:
+            raise ValueError(f"unsupported binary json version {version}")
+
+        strings = [
+            _read_exact(file, _read_varint(file)).decode("utf-8", "surrogateescape")
+            for _ in range(_read_varint(file))
+        ]
+        for _ in range(_read_varint(file)):
+            record = _read_exact(file, _read_varint(file))
+            value, _ = _decode(record, 0, strings)
+            yield value
+
+
+def read_directory(directory: str = ".") -> Iterable[Any]:
+    """Yield the models stored in all binary shards of the given directory."""
+    for path in sorted(os.listdir(directory)):
+        if path.startswith("model@") and path.endswith(".mtb"):
+            yield from read_file(os.path.join(directory, path))
+
+
+def main() -> None:
+    for path in sys.argv[1:]:
+        for model in read_file(path):
+            print(json.dumps(model, separators=(",", ":"), sort_keys=True))
+
+
+if __name__ == "__main__":
+    main()
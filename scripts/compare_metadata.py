@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+#
+# This source code is licensed under the MIT license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Compare the performance statistics of two runs of the analysis, from the
+`stats` field of their `metadata.json`.
+
+Reports the per-phase time, peak RSS and global iteration deltas, as well as
+the methods that are among the slowest methods of the new run only. Exits with
+code 1 if a delta exceeds its threshold, which allows to catch performance
+regressions when rolling out new configurations or versions.
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Dict, List, NamedTuple, Optional
+
+
+class Statistics(NamedTuple):
+    times: Dict[str, float]
+    rss: float
+    iterations: int
+    slowest_methods: Dict[str, float]
+
+
+def load_statistics(path: Path) -> Statistics:
+    if path.is_dir():
+        path = path / "metadata.json"
+    with open(path) as file:
+        statistics = json.load(file)["stats"]
+    return Statistics(
+        times={name: float(time) for name, time in statistics["times"].items()},
+        rss=float(statistics.get("rss", 0.0)),
+        iterations=int(statistics.get("iterations", 0)),
+        slowest_methods={
+            method: float(time)
+            for method, time in statistics.get("slowest_methods", [])
+        },
+    )
+
+
+def relative_delta(baseline: float, current: float) -> Optional[float]:
+    if baseline == 0.0:
+        return None
+    return (current - baseline) / baseline * 100.0
+
+
+def format_delta(baseline: float, current: float) -> str:
+    delta = relative_delta(baseline, current)
+    if delta is None:
+        return "new"
+    return f"{delta:+.1f}%"
+
+
+def compare(
+    baseline: Statistics, current: Statistics, arguments: argparse.Namespace
+) -> List[str]:
+    """Print the comparison and return the regressions."""
+    regressions = []
+
+    print("Phase times (s):")
+    for phase in sorted(set(baseline.times) | set(current.times)):
+        baseline_time = baseline.times.get(phase, 0.0)
+        current_time = current.times.get(phase, 0.0)
+        print(
+            f"  {phase:<40} {baseline_time:>10.3f} {current_time:>10.3f} "
+            f"{format_delta(baseline_time, current_time):>8}"
+        )
+        # Short phases are too noisy to be compared.
+        if max(baseline_time, current_time) < arguments.minimum_time:
+            continue
+        delta = relative_delta(baseline_time, current_time)
+        if delta is None or delta > arguments.time_threshold:
+            regressions.append(
+                f"Phase `{phase}` took {current_time:.3f}s instead of "
+                f"{baseline_time:.3f}s."
+            )
+
+    print(
+        f"Peak RSS (GB): {baseline.rss:.3f} {current.rss:.3f} "
+        f"{format_delta(baseline.rss, current.rss)}"
+    )
+    rss_delta = relative_delta(baseline.rss, current.rss)
+    if rss_delta is not None and rss_delta > arguments.rss_threshold:
+        regressions.append(
+            f"Peak RSS is {current.rss:.3f}GB instead of {baseline.rss:.3f}GB."
+        )
+
+    print(f"Global iterations: {baseline.iterations} {current.iterations}")
+    if current.iterations - baseline.iterations > arguments.iterations_threshold:
+        regressions.append(
+            f"The analysis took {current.iterations} global iterations instead "
+            f"of {baseline.iterations}."
+        )
+
+    new_slow_methods = sorted(
+        (
+            (time, method)
+            for method, time in current.slowest_methods.items()
+            if method not in baseline.slowest_methods
+        ),
+        reverse=True,
+    )
+    if new_slow_methods:
+        print("New slow methods (s):")
+    for time, method in new_slow_methods:
+        print(f"  {time:>10.3f} {method}")
+        if (
+            arguments.slow_method_threshold is not None
+            and time > arguments.slow_method_threshold
+        ):
+            regressions.append(f"Method `{method}` took {time:.3f}s.")
+
+    return regressions
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "baseline",
+        type=Path,
+        help="The metadata file of the baseline run, or its output directory.",
+    )
+    parser.add_argument(
+        "current",
+        type=Path,
+        help="The metadata file of the new run, or its output directory.",
+    )
+    parser.add_argument(
+        "--time-threshold",
+        type=float,
+        default=20.0,
+        help="Maximum increase of the time of a phase, in percent.",
+    )
+    parser.add_argument(
+        "--minimum-time",
+        type=float,
+        default=5.0,
+        help="Ignore phases faster than this, in seconds, in both runs.",
+    )
+    parser.add_argument(
+        "--rss-threshold",
+        type=float,
+        default=10.0,
+        help="Maximum increase of the peak RSS, in percent.",
+    )
+    parser.add_argument(
+        "--iterations-threshold",
+        type=int,
+        default=0,
+        help="Maximum increase of the number of global iterations.",
+    )
+    parser.add_argument(
+        "--slow-method-threshold",
+        type=float,
+        help="Maximum time of methods that are not among the slowest methods of the baseline, in seconds. New slow methods are only reported by default.",
+    )
+    arguments: argparse.Namespace = parser.parse_args()
+
+    regressions = compare(
+        load_statistics(arguments.baseline),
+        load_statistics(arguments.current),
+        arguments,
+    )
+    if regressions:
+        print("Performance regressions:")
+        for regression in regressions:
+            print(f"  {regression}")
+        sys.exit(1)
@@ -4,13 +4,25 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import functools
+import gzip
 import json
 import multiprocessing
 import os
 import re
 import subprocess
 import sys
-from typing import Any, Dict, Iterable, List, NamedTuple, Tuple, Union
+from typing import (
+    Any,
+    BinaryIO,
+    Dict,
+    Iterable,
+    List,
+    NamedTuple,
+    Optional,
+    Tuple,
+    Union,
+)
 
 """
 Set of functions that can be used to explore models.
@@ -19,6 +31,12 @@ Usage: python3 -i explore_models.py
 
 Model = Dict[str, Any]
 
+# See `JsonStringTable` in `source/JsonWriter.h`.
+STRING_TABLE_PREFIX = "string-table-"
+INTERNED_KEYS = {"field", "kind", "method", "path", "resolves_to"}
+# See `--dump-model-index` in `source/Options.cpp`.
+MODEL_INDEX = "model_index.json"
+
 
 class FilePosition(NamedTuple):
     path: str
@@ -54,18 +72,58 @@ def _iter_with_offset(lines: Iterable[bytes]) -> Iterable[Tuple[bytes, int]]:
         offset += len(line)
 
 
+def _open(path: str) -> BinaryIO:
+    # Offsets of compressed shards are offsets in the decompressed stream.
+    if path.endswith(".gz"):
+        return gzip.open(path, "rb")
+    return open(path, "rb")
+
+
+@functools.lru_cache(maxsize=16)
+def _string_table(path: str) -> Optional[List[str]]:
+    """Strings of a shard written with `--output-string-tables`."""
+    table_path = os.path.join(
+        os.path.dirname(path), STRING_TABLE_PREFIX + os.path.basename(path)
+    )
+    if not os.path.exists(table_path):
+        return None
+    with _open(table_path) as file:
+        return [json.loads(line) for line in file if not line.startswith(b"//")]
+
+
+def _expand_strings(value: Any, strings: List[str], interned: bool = False) -> Any:
+    if isinstance(value, dict):
+        return {
+            key: _expand_strings(element, strings, key in INTERNED_KEYS)
+            for key, element in value.items()
+        }
+    if isinstance(value, list):
+        return [_expand_strings(element, strings) for element in value]
+    if interned and isinstance(value, int) and not isinstance(value, bool):
+        return strings[value]
+    return value
+
+
+def _load_model(path: str, line: bytes) -> Model:
+    model = json.loads(line)
+    strings = _string_table(path)
+    if strings is not None:
+        model = _expand_strings(model, strings)
+    return model
+
+
 def _index_file(path: str) -> Tuple[Dict[str, FilePosition], Dict[str, FilePosition]]:
     print(f"Indexing `{path}`")
     index = {}
     field_index = {}
 
-    with open(path, "rb") as file:
+    with _open(path) as file:
         for line, offset in _iter_with_offset(file):
             if line.startswith(b"//"):
                 continue
 
             position = FilePosition(path=path, offset=offset, length=len(line))
-            model = json.loads(line)
+            model = _load_model(path, line)
             if "method" in list(model.keys()):
                 method = _method_string(model["method"])
                 index[method] = position
@@ -75,15 +133,45 @@ def _index_file(path: str) -> Tuple[Dict[str, FilePosition], Dict[str, FilePosit
     return (index, field_index)
 
 
+def _load_model_index(results_directory: str) -> bool:
+    """Load the index written with `--dump-model-index`, if any."""
+    index_path = os.path.join(results_directory, MODEL_INDEX)
+    if not os.path.exists(index_path):
+        return False
+
+    print(f"Loading `{index_path}`")
+    with open(index_path, "rb") as file:
+        for line in file:
+            if line.startswith(b"//"):
+                continue
+
+            entry = json.loads(line)
+            position = FilePosition(
+                path=os.path.join(results_directory, entry["shard"]),
+                offset=entry["offset"],
+                length=entry["length"],
+            )
+            if "method" in entry:
+                __index[_method_string(entry["method"])] = position
+            elif "field" in entry:
+                __field_index[entry["field"]] = position
+
+    return True
+
+
 def index(results_directory: str = ".") -> None:
     """Index all available method and field models in the given directory."""
     global __index, __field_index
     __index = {}
     __field_index = {}
 
+    if _load_model_index(results_directory):
+        print(f"Indexed {len(__index)} models")
+        return
+
     paths = []
     for path in os.listdir(results_directory):
-        if not path.startswith("model@"):
+        if not path.startswith("model@") or path.endswith(".mtb"):
             continue
 
         paths.append(os.path.join(results_directory, path))
@@ -139,9 +227,13 @@ def _get_model_bytes(key: str, index: Dict[str, Any]) -> bytes:
         raise AssertionError(f"no model for `{key}`.")
 
     file_position = index[key]
-    with open(file_position.path, "rb") as file:
+    with _open(file_position.path) as file:
         file.seek(file_position.offset)
-        return file.read(file_position.length)
+        line = file.read(file_position.length)
+
+    if _string_table(file_position.path) is None:
+        return line
+    return json.dumps(_load_model(file_position.path, line)).encode()
 
 
 def get_model(method: str) -> Model:
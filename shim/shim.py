@@ -15,7 +15,7 @@ import sys
 import tempfile
 import traceback
 from pathlib import Path
-from typing import Any, List, Optional
+from typing import Any, List, Optional, Tuple
 
 from pyre_extensions import none_throws, safe_json
 
@@ -275,6 +275,11 @@ def _add_target_arguments(parser: argparse.ArgumentParser) -> None:
         type=_path_exists,
         help="The APK to analyze.",
     )
+    target_arguments.add_argument(
+        "--batch-configuration-path",
+        type=_path_exists,
+        help="A json list of `{\"apk_path\": ..., \"output_directory\": ...}` objects. The APKs are analyzed one after the other, sharing the analysis cache directory, which avoids re-analyzing the code they have in common (e.g, flavors of the same app).",
+    )
     if configuration.FACEBOOK_SHIM:
         target_arguments.add_argument(
             "--java-target",
@@ -301,6 +306,63 @@ def _add_output_arguments(parser: argparse.ArgumentParser) -> None:
         type=_directory_exists,
         help="Save generated models to this directory.",
     )
+    output_arguments.add_argument(
+        "--binary-model-output",
+        action="store_true",
+        help="Write models in the compact binary format read by `scripts/binary_models.py` instead of json lines.",
+    )
+    output_arguments.add_argument(
+        "--output-compression-level",
+        type=int,
+        choices=range(0, 10),
+        default=0,
+        help="Compress each model shard with gzip at the given level, from 1 (fastest) to 9 (smallest). 0 disables compression.",
+    )
+    output_arguments.add_argument(
+        "--stream-models",
+        action="store_true",
+        help="Postprocess and write the models of each strongly connected component as soon as it is stable. Requires `--enable-scc-fixpoint` and `--skip-source-indexing`.",
+    )
+    output_arguments.add_argument(
+        "--resident-set-size-target",
+        type=float,
+        help="Resident set size, in GB, above which the models of stable components are released once all their callers are stable. Requires `--stream-models`, and is not supported with options reading models after the fixpoint, e.g `--dump-issues` or `--shards`.",
+    )
+    output_arguments.add_argument(
+        "--dump-model-fingerprints",
+        action="store_true",
+        help="Write a content hash of every model in `model_fingerprints.txt`, to be used as `--previous-model-fingerprints` of a later run.",
+    )
+    output_arguments.add_argument(
+        "--previous-model-fingerprints",
+        type=_path_exists,
+        help="The `model_fingerprints.txt` of a previous run. Only the models that changed since that run are written, and the models that no longer exist are listed in `model_tombstones.txt`.",
+    )
+    output_arguments.add_argument(
+        "--output-string-tables",
+        action="store_true",
+        help="Replace file paths, method and field signatures and kinds in the models by their index in a string table per shard, written in `string-table-model@*.json`.",
+    )
+    output_arguments.add_argument(
+        "--dump-issues",
+        action="store_true",
+        help="Also write the issues of all methods in `issues.json`, merging the issues with the same rule, callee, sink index and position.",
+    )
+    output_arguments.add_argument(
+        "--dump-model-index",
+        action="store_true",
+        help="Also write the shard, offset and length of each model in `model_index.json`, so that models can be read without indexing all shards.",
+    )
+    output_arguments.add_argument(
+        "--analysis-cache-directory",
+        type=_directory_exists,
+        help="Read and store the incremental analysis cache, the global type analysis results, the model generator matches, the source index and the intent routing results in this directory.",
+    )
+    output_arguments.add_argument(
+        "--precomputed-graphs-directory",
+        type=_directory_exists,
+        help="Read and store snapshots of the class hierarchies, class intervals and override graph in this directory.",
+    )
 
 
 def _add_binary_arguments(parser: argparse.ArgumentParser) -> None:
@@ -366,6 +428,11 @@ def _add_configuration_arguments(parser: argparse.ArgumentParser) -> None:
         action="store_true",
         help="Disables global type analysis. If a proguard configuration path is passed in, it will be ignored.",
     )
+    configuration_arguments.add_argument(
+        "--disable-class-intervals",
+        action="store_true",
+        help="Disables class intervals, trading precision on virtual calls for analysis speed.",
+    )
     configuration_arguments.add_argument(
         "--remove-unreachable-code",
         action="store_true",
@@ -415,6 +482,16 @@ def _add_configuration_arguments(parser: argparse.ArgumentParser) -> None:
         type=_separated_paths_exist,
         help="A `;` separated list of literal models files and directories containing literal models files.",
     )
+    configuration_arguments.add_argument(
+        "--library-models-paths",
+        type=_separated_paths_exist,
+        help="A `;` separated list of models files and directories containing models files, for methods that may not exist in the analyzed program. Only the models of existing methods are parsed.",
+    )
+    configuration_arguments.add_argument(
+        "--library-summaries-paths",
+        type=_separated_paths_exist,
+        help="A `;` separated list of library summaries written by `--summarize-library`. Methods with a valid summary are not analyzed.",
+    )
     configuration_arguments.add_argument(
         "--maximum-source-sink-distance",
         type=int,
@@ -477,13 +554,177 @@ def _add_analysis_arguments(parser: argparse.ArgumentParser) -> None:
     analysis_arguments.add_argument(
         "--maximum-method-analysis-time",
         type=int,
-        help="Specify number of seconds as a bound. If the analysis of a method takes longer than this then make the method obscure (default taint-in-taint-out).",
+        help="Specify number of seconds as a bound. If the analysis of a method takes longer than this then it is aborted and the method is made obscure (default taint-in-taint-out).",
+    )
+    analysis_arguments.add_argument(
+        "--maximum-analysis-time",
+        type=int,
+        help="Specify number of seconds as a bound for the global fixpoint. Once exceeded, remaining methods are made obscure (default taint-in-taint-out).",
+    )
+    analysis_arguments.add_argument(
+        "--maximum-cached-type-environments",
+        type=int,
+        help="Once the call graph is built, only keep the inferred types of this many methods in memory. Types of evicted methods are inferred again when needed.",
     )
     analysis_arguments.add_argument(
         "--enable-cross-component-analysis",
         action="store_true",
         help="Compute taint flows across Android components.",
     )
+    analysis_arguments.add_argument(
+        "--enable-worklist-fixpoint",
+        action="store_true",
+        help="Re-analyze methods as soon as one of their callees changes, instead of using global iterations.",
+    )
+    analysis_arguments.add_argument(
+        "--enable-scc-fixpoint",
+        action="store_true",
+        help="Iterate each strongly connected component of the dependency graph to its local fixpoint before analyzing its callers.",
+    )
+    analysis_arguments.add_argument(
+        "--enable-alias-analysis-cache",
+        action="store_true",
+        help="Reuse forward alias analysis results across iterations. This uses more memory.",
+    )
+    analysis_arguments.add_argument(
+        "--enable-callsite-model-cache",
+        action="store_true",
+        help="Reuse callee models instantiated at call sites across iterations. This uses more memory.",
+    )
+    analysis_arguments.add_argument(
+        "--release-control-flow-graphs",
+        action="store_true",
+        help="Free the control flow graphs of each strongly connected component once it is stable. Requires `--enable-scc-fixpoint`.",
+    )
+    analysis_arguments.add_argument(
+        "--intern-stable-frames",
+        action="store_true",
+        help="Share the data of equal frames across stable models. Requires `--enable-scc-fixpoint`.",
+    )
+    analysis_arguments.add_argument(
+        "--checkpoint-interval",
+        type=int,
+        help="Write the state of the global fixpoint every given number of global iterations.",
+    )
+    analysis_arguments.add_argument(
+        "--resume-from",
+        type=str,
+        help="Resume the global fixpoint from a checkpoint written with `--checkpoint-interval`.",
+    )
+    analysis_arguments.add_argument(
+        "--daemon",
+        action="store_true",
+        help="Keep the analysis state resident and re-analyze the methods given in json requests on the standard input.",
+    )
+    analysis_arguments.add_argument(
+        "--pin-worker-threads",
+        action="store_true",
+        help="Pin the fixpoint worker threads to the NUMA nodes of the host.",
+    )
+    analysis_arguments.add_argument(
+        "--deterministic",
+        action="store_true",
+        help="Make iteration counts and results of the fixpoints independent of the number of threads.",
+    )
+    analysis_arguments.add_argument(
+        "--tiered-analysis",
+        action="store_true",
+        help="Only analyze the methods that may hold taint, skipping the others with taint-in-taint-out propagations.",
+    )
+    analysis_arguments.add_argument(
+        "--sparse-taint-analysis",
+        action="store_true",
+        help="Skip the forward and backward taint analyses of methods where no taint is introduced.",
+    )
+    analysis_arguments.add_argument(
+        "--relevance-prescan",
+        action="store_true",
+        help="Keep the initial model of methods whose model cannot change, found by a scan of their code and callee models.",
+    )
+    analysis_arguments.add_argument(
+        "--fuse-forward-analyses",
+        action="store_true",
+        help="Run the forward alias and forward taint analyses of a method in a single fixpoint.",
+    )
+    analysis_arguments.add_argument(
+        "--incremental-reanalysis",
+        action="store_true",
+        help="Restart the forward taint analysis of large methods from the calls to callees whose model changed.",
+    )
+    analysis_arguments.add_argument(
+        "--prune-unreachable-methods",
+        action="store_true",
+        help="Skip the analysis of methods that are not reachable from an entry point in the call graph.",
+    )
+    analysis_arguments.add_argument(
+        "--entry-point",
+        action="append",
+        metavar="METHOD_PREFIX",
+        help="Use the methods whose signature starts with the given prefix as entry points of `--prune-unreachable-methods`.",
+    )
+    analysis_arguments.add_argument(
+        "--rule-codes",
+        type=int,
+        nargs="+",
+        metavar="CODE",
+        help="Only run the rules with the given codes, skipping what they do not need.",
+    )
+    analysis_arguments.add_argument(
+        "--source-sink-slicing",
+        action="store_true",
+        help="Only analyze the methods through which a source may reach a sink.",
+    )
+    analysis_arguments.add_argument(
+        "--reduced-precision-class",
+        action="append",
+        metavar="CLASS_PREFIX",
+        help="Analyze the methods of classes with the given prefix with reduced precision, e.g for third party libraries.",
+    )
+    analysis_arguments.add_argument(
+        "--maximum-parameter-type-overrides",
+        type=int,
+        help="Create at most this many variants of a method with parameter type overrides.",
+    )
+    analysis_arguments.add_argument(
+        "--previous-method-profiles-directory",
+        type=_directory_exists,
+        help="Output directory of a previous run with `--dump-method-profiles`, used to schedule expensive methods first and skip methods that timed out.",
+    )
+    analysis_arguments.add_argument(
+        "--trim-allocator-memory",
+        action="store_true",
+        help="Return freed memory to the operating system between the analysis phases.",
+    )
+    analysis_arguments.add_argument(
+        "--transparent-huge-pages",
+        action="store_true",
+        help="Back the heap with transparent huge pages, through the `glibc.malloc.hugetlb` tunable (glibc 2.35 or later).",
+    )
+    analysis_arguments.add_argument(
+        "--parallel-taint-analysis-minimum-blocks",
+        type=int,
+        help="Run the forward and backward taint analyses of methods with at least this number of basic blocks concurrently, after their forward alias analysis. This is disabled with multi-source/sink rules, since the backward taint analysis depends on the partial sinks fulfilled by the forward taint analysis.",
+    )
+    analysis_arguments.add_argument(
+        "--maximum-callsite-model-cache-entries",
+        type=int,
+        help="Bound the number of call sites in the callsite model cache, to bound its memory usage. Once the cache is full, only call sites that are already cached are updated. Requires `--enable-callsite-model-cache`.",
+    )
+    analysis_arguments.add_argument(
+        "--skip-call-site-origins",
+        action="store_true",
+        help="Do not propagate origins into the frames of call sites during the analysis. Only origin frames, which are the leaves of traces, keep their origins. These are the only frames whose origins are exported without `--always-export-origins`, except for issues, which then lose the origins of frames of call sites.",
+    )
+    analysis_arguments.add_argument(
+        "--dry-run-model-generation",
+        action="store_true",
+        help="Stop after running the model generators, to measure their cost. The call graph is not built and only the generated models are written. The metadata holds the time, number of candidates and number of models of each generator and of its slowest items. Use `--precomputed-graphs-directory` to load the class hierarchies and override graph from snapshots.",
+    )
+    analysis_arguments.add_argument(
+        "--widen-changing-models",
+        action="store_true",
+        help="Widen the new models of methods whose model changed many times during the fixpoint, as for `--reduced-precision-classes`. Models that keep growing slightly then stabilize instead of reaching the iteration limit, at the cost of precision.",
+    )
     analysis_arguments.add_argument(
         "--extra-analysis-arguments",
         type=str,
@@ -566,6 +807,100 @@ def _add_debug_arguments(parser: argparse.ArgumentParser) -> None:
         action="store_true",
         help="Dumps file coverage info into `file_coverage.txt` and rule coverage info into `rule_coverage.json`.",
     )
+    debug_arguments.add_argument(
+        "--dump-trace",
+        action="store_true",
+        help="Dump a timeline of the analysis in `trace.json`, in the Chrome trace event format.",
+    )
+    debug_arguments.add_argument(
+        "--dump-method-profiles",
+        action="store_true",
+        help="Dump a profile of the analyses of each method next to the models, in `method_profile@*.json` shards sorted by decreasing analysis time.",
+    )
+    debug_arguments.add_argument(
+        "--track-model-sizes",
+        action="store_true",
+        help="Add the sizes and growth of the largest models to the metadata.",
+    )
+    debug_arguments.add_argument(
+        "--model-size-warning-threshold",
+        type=int,
+        help="Warn when the model of a method exceeds this number of frames. Implies `--track-model-sizes`.",
+    )
+    debug_arguments.add_argument(
+        "--convergence-report",
+        action="store_true",
+        help="Add the methods with most analyses and the callees causing most invalidations during the fixpoint to the metadata.",
+    )
+    debug_arguments.add_argument(
+        "--partitions",
+        type=int,
+        help="Partition the graph of strongly connected components for a distributed analysis, and write the partitions in `partitions.json`.",
+    )
+    debug_arguments.add_argument(
+        "--shards",
+        type=int,
+        help="Analyze the program in the given number of shard processes exchanging boundary models through `--shard-directory`.",
+    )
+    debug_arguments.add_argument(
+        "--shard-index",
+        type=int,
+        help="Index of the shard analyzed by this process.",
+    )
+    debug_arguments.add_argument(
+        "--merge-shards",
+        action="store_true",
+        help="Join the models written by each shard in `--shard-directory` instead of analyzing the program.",
+    )
+    debug_arguments.add_argument(
+        "--shard-directory",
+        type=_directory_exists,
+        help="Directory shared by the shards to exchange their models.",
+    )
+    debug_arguments.add_argument(
+        "--summarize-library",
+        action="append",
+        metavar="CLASS_PREFIX",
+        help="Write the inferred models of the methods of classes with the given prefix in `library_summaries.json`, for `--library-summaries-paths`.",
+    )
+    debug_arguments.add_argument(
+        "--collect-cache-statistics",
+        action="store_true",
+        help="Add the number of lookups, hits and inserts of the caches, per phase, to the metadata.",
+    )
+    debug_arguments.add_argument(
+        "--write-status",
+        action="store_true",
+        help="Periodically rewrite `status.json` in the output directory with the progress of the analysis.",
+    )
+    debug_arguments.add_argument(
+        "--status-interval",
+        type=int,
+        default=10,
+        help="Number of seconds between two writes of `status.json`.",
+    )
+    debug_arguments.add_argument(
+        "--memory-accounting",
+        action="store_true",
+        help="Estimate the memory used by the main data structures at each phase and report it in the metadata.",
+    )
+    debug_arguments.add_argument(
+        "--memory-accounting-sampling-rate",
+        type=int,
+        default=1,
+        help="Only measure the models, types and control flow graphs of one method out of the given number when accounting memory.",
+    )
+    debug_arguments.add_argument(
+        "--sample-analyzed-methods",
+        action="store_true",
+        help="Sample native stacks by analyzed method and write them in `method_samples.folded`, for flame graphs.",
+    )
+    debug_arguments.add_argument(
+        "--sampling-frequency",
+        type=int,
+        default=99,
+        help="Number of samples per second of CPU time for `--sample-analyzed-methods`.",
+    )
     debug_arguments.add_argument(
         "--always-export-origins",
         action="store_true",
@@ -573,6 +908,35 @@ def _add_debug_arguments(parser: argparse.ArgumentParser) -> None:
     )
 
 
+def _read_batch_configuration(path: str) -> List[Tuple[str, str]]:
+    with open(path) as file:
+        batch = json.load(file)
+    if not isinstance(batch, list):
+        raise ConfigurationError(
+            message=f"Expected a list in batch configuration `{path}`."
+        )
+    targets = []
+    for target in batch:
+        if (
+            not isinstance(target, dict)
+            or not isinstance(target.get("apk_path"), str)
+            or not isinstance(target.get("output_directory"), str)
+        ):
+            raise ConfigurationError(
+                message=f"Expected `apk_path` and `output_directory` in every target of batch configuration `{path}`."
+            )
+        try:
+            targets.append(
+                (
+                    _path_exists(target["apk_path"]),
+                    _directory_exists(target["output_directory"]),
+                )
+            )
+        except argparse.ArgumentTypeError as error:
+            raise ConfigurationError(message=str(error))
+    return targets
+
+
 def _get_command_options(
     arguments: argparse.Namespace, apk_directory: str, dex_directory: str
 ) -> List[str]:
@@ -618,6 +982,12 @@ def _get_command_options(
     if arguments.literal_models_paths:
         options.append("--literal-models-paths")
         options.append(arguments.literal_models_paths)
+    if arguments.library_models_paths:
+        options.append("--library-models-paths")
+        options.append(arguments.library_models_paths)
+    if arguments.library_summaries_paths:
+        options.append("--library-summaries-paths")
+        options.append(arguments.library_summaries_paths)
 
     if arguments.proguard_configuration_paths:
         options.append("--proguard-configuration-paths")
@@ -643,6 +1013,14 @@ def _get_command_options(
         options.append("--generated-models-directory")
         options.append(arguments.generated_models_directory)
 
+    if arguments.analysis_cache_directory:
+        options.append("--analysis-cache-directory")
+        options.append(arguments.analysis_cache_directory)
+
+    if arguments.precomputed_graphs_directory:
+        options.append("--precomputed-graphs-directory")
+        options.append(arguments.precomputed_graphs_directory)
+
     if arguments.emit_all_via_cast_features:
         options.append("--emit-all-via-cast-features")
     if arguments.propagate_across_arguments:
@@ -661,13 +1039,93 @@ def _get_command_options(
         options.append("--disable-parameter-type-overrides")
     if arguments.disable_global_type_analysis:
         options.append("--disable-global-type-analysis")
+    if arguments.disable_class_intervals:
+        options.append("--disable-class-intervals")
     if arguments.remove_unreachable_code:
         options.append("--remove-unreachable-code")
     if arguments.maximum_method_analysis_time is not None:
         options.append("--maximum-method-analysis-time")
         options.append(str(arguments.maximum_method_analysis_time))
+    if arguments.maximum_analysis_time is not None:
+        options.append("--maximum-analysis-time")
+        options.append(str(arguments.maximum_analysis_time))
+    if arguments.maximum_cached_type_environments is not None:
+        options.append("--maximum-cached-type-environments")
+        options.append(str(arguments.maximum_cached_type_environments))
     if arguments.enable_cross_component_analysis:
         options.append("--enable-cross-component-analysis")
+    if arguments.enable_worklist_fixpoint:
+        options.append("--enable-worklist-fixpoint")
+    if arguments.enable_scc_fixpoint:
+        options.append("--enable-scc-fixpoint")
+    if arguments.enable_alias_analysis_cache:
+        options.append("--enable-alias-analysis-cache")
+    if arguments.enable_callsite_model_cache:
+        options.append("--enable-callsite-model-cache")
+    if arguments.release_control_flow_graphs:
+        options.append("--release-control-flow-graphs")
+    if arguments.intern_stable_frames:
+        options.append("--intern-stable-frames")
+    if arguments.checkpoint_interval is not None:
+        options.append("--checkpoint-interval")
+        options.append(str(arguments.checkpoint_interval))
+    if arguments.resume_from:
+        options.append("--resume-from")
+        options.append(arguments.resume_from)
+    if arguments.daemon:
+        options.append("--daemon")
+    if arguments.pin_worker_threads:
+        options.append("--pin-worker-threads")
+    if arguments.deterministic:
+        options.append("--deterministic")
+    if arguments.tiered_analysis:
+        options.append("--tiered-analysis")
+    if arguments.sparse_taint_analysis:
+        options.append("--sparse-taint-analysis")
+    if arguments.relevance_prescan:
+        options.append("--relevance-prescan")
+    if arguments.fuse_forward_analyses:
+        options.append("--fuse-forward-analyses")
+    if arguments.incremental_reanalysis:
+        options.append("--incremental-reanalysis")
+    if arguments.prune_unreachable_methods:
+        options.append("--prune-unreachable-methods")
+    if arguments.entry_point:
+        for method_prefix in arguments.entry_point:
+            options.append("--entry-point=%s" % method_prefix.strip())
+    if arguments.rule_codes:
+        options.append("--rule-codes")
+        options.extend(str(code) for code in arguments.rule_codes)
+    if arguments.source_sink_slicing:
+        options.append("--source-sink-slicing")
+    if arguments.reduced_precision_class:
+        for class_prefix in arguments.reduced_precision_class:
+            options.append("--reduced-precision-classes=%s" % class_prefix.strip())
+    if arguments.maximum_parameter_type_overrides is not None:
+        options.append("--maximum-parameter-type-overrides")
+        options.append(str(arguments.maximum_parameter_type_overrides))
+    if arguments.previous_method_profiles_directory:
+        options.append("--previous-method-profiles-directory")
+        options.append(arguments.previous_method_profiles_directory)
+    if arguments.trim_allocator_memory:
+        options.append("--trim-allocator-memory")
+    if arguments.transparent_huge_pages:
+        tunables = ["glibc.malloc.hugetlb=1"]
+        if "GLIBC_TUNABLES" in os.environ:
+            tunables.insert(0, os.environ["GLIBC_TUNABLES"])
+        os.environ["GLIBC_TUNABLES"] = ":".join(tunables)
+    if arguments.parallel_taint_analysis_minimum_blocks is not None:
+        options.append("--parallel-taint-analysis-minimum-blocks")
+        options.append(str(arguments.parallel_taint_analysis_minimum_blocks))
+    if arguments.maximum_callsite_model_cache_entries is not None:
+        options.append("--maximum-callsite-model-cache-entries")
+        options.append(str(arguments.maximum_callsite_model_cache_entries))
+    if arguments.skip_call_site_origins:
+        options.append("--skip-call-site-origins")
+    if arguments.dry_run_model_generation:
+        options.append("--dry-run-model-generation")
+    if arguments.widen_changing_models:
+        options.append("--widen-changing-models")
     if arguments.extra_analysis_arguments:
         options.extend(shlex.split(arguments.extra_analysis_arguments))
 
@@ -701,11 +1159,99 @@ def _get_command_options(
         options.append("--dump-methods")
     if arguments.dump_coverage_info:
         options.append("--dump-coverage-info")
+    if arguments.dump_trace:
+        options.append("--dump-trace")
+    if arguments.dump_method_profiles:
+        options.append("--dump-method-profiles")
+    if arguments.track_model_sizes:
+        options.append("--track-model-sizes")
+    if arguments.model_size_warning_threshold is not None:
+        options.append("--model-size-warning-threshold")
+        options.append(str(arguments.model_size_warning_threshold))
+    if arguments.convergence_report:
+        options.append("--convergence-report")
+    if arguments.partitions is not None:
+        options.append("--partitions")
+        options.append(str(arguments.partitions))
+    if arguments.shards is not None:
+        options.append("--shards")
+        options.append(str(arguments.shards))
+    if arguments.shard_index is not None:
+        options.append("--shard-index")
+        options.append(str(arguments.shard_index))
+    if arguments.merge_shards:
+        options.append("--merge-shards")
+    if arguments.shard_directory:
+        options.append("--shard-directory")
+        options.append(arguments.shard_directory)
+    if arguments.summarize_library:
+        for class_prefix in arguments.summarize_library:
+            options.append("--summarize-library=%s" % class_prefix.strip())
+    if arguments.collect_cache_statistics:
+        options.append("--collect-cache-statistics")
+    if arguments.write_status:
+        options.append("--write-status")
+        options.append("--status-interval")
+        options.append(str(arguments.status_interval))
+    if arguments.memory_accounting:
+        options.append("--memory-accounting")
+        options.append("--memory-accounting-sampling-rate")
+        options.append(str(arguments.memory_accounting_sampling_rate))
+    if arguments.sample_analyzed_methods:
+        options.append("--sample-analyzed-methods")
+        options.append("--sampling-frequency")
+        options.append(str(arguments.sampling_frequency))
+    if arguments.binary_model_output:
+        options.append("--binary-model-output")
+    if arguments.output_compression_level > 0:
+        options.append("--output-compression-level")
+        options.append(str(arguments.output_compression_level))
+    if arguments.stream_models:
+        options.append("--stream-models")
+    if arguments.resident_set_size_target is not None:
+        options.append("--resident-set-size-target")
+        options.append(str(arguments.resident_set_size_target))
+    if arguments.dump_model_fingerprints:
+        options.append("--dump-model-fingerprints")
+    if arguments.previous_model_fingerprints:
+        options.append("--previous-model-fingerprints")
+        options.append(arguments.previous_model_fingerprints)
+    if arguments.output_string_tables:
+        options.append("--output-string-tables")
+    if arguments.dump_issues:
+        options.append("--dump-issues")
+    if arguments.dump_model_index:
+        options.append("--dump-model-index")
     if arguments.always_export_origins:
         options.append("--always-export-origins")
     return options
 
 
+def _analyze_apk(binary: Path, arguments: argparse.Namespace) -> int:
+    LOG.info(f"Extracting `{arguments.apk_path}`...")
+    apk_directory = tempfile.mkdtemp(suffix="_apk")
+    dex_directory = tempfile.mkdtemp(suffix="_dex")
+    pyredex.utils.unzip_apk(arguments.apk_path, apk_directory)
+    dex_mode = pyredex.unpacker.detect_secondary_dex_mode(apk_directory)
+    dex_mode.unpackage(apk_directory, dex_directory)
+    LOG.info(f"Extracted APK into `{apk_directory}` and DEX into `{dex_directory}`")
+
+    if configuration.FACEBOOK_SHIM and arguments.analyze_third_party:
+        output = start_third_party_analysis(
+            binary, arguments, apk_directory, dex_directory
+        )
+    else:
+        options = _get_command_options(arguments, apk_directory, dex_directory)
+        command = [os.fspath(binary.resolve())] + options
+        if arguments.gdb:
+            command = ["gdb", "--args"] + command
+        elif arguments.lldb:
+            command = ["lldb", "--"] + command
+        LOG.info(f"Running Mariana Trench: {' '.join(command)}")
+        output = subprocess.run(command)
+    return output.returncode
+
+
 def main() -> None:
     logging.basicConfig(level=logging.INFO, format="%(levelname)s %(message)s")
     build_directory = Path(tempfile.mkdtemp())
@@ -765,13 +1311,31 @@ def main() -> None:
             configuration.FACEBOOK_SHIM
             and arguments.java_target is None
             and arguments.apk_path is None
+            and arguments.batch_configuration_path is None
         ):
             parser.error(
                 "The analysis target should either be a java target (--java-target)"
                 + " or an apk file (--apk-path)."
             )
-        if not configuration.FACEBOOK_SHIM and arguments.apk_path is None:
-            parser.error("The argument --apk-path is required.")
+        if (
+            arguments.batch_configuration_path is not None
+            and arguments.apk_path is not None
+        ) or (
+            configuration.FACEBOOK_SHIM
+            and arguments.batch_configuration_path is not None
+            and arguments.java_target is not None
+        ):
+            parser.error(
+                "The argument --batch-configuration-path cannot be used with another analysis target."
+            )
+        if (
+            not configuration.FACEBOOK_SHIM
+            and arguments.apk_path is None
+            and arguments.batch_configuration_path is None
+        ):
+            parser.error(
+                "The argument --apk-path or --batch-configuration-path is required."
+            )
 
         # Build the vanilla java project.
         if configuration.FACEBOOK_SHIM and arguments.java_target:
@@ -789,30 +1353,24 @@ def main() -> None:
         # Build the mariana trench binary if necessary.
         binary = _get_analysis_binary(arguments)
 
-        LOG.info(f"Extracting `{arguments.apk_path}`...")
-        apk_directory = tempfile.mkdtemp(suffix="_apk")
-        dex_directory = tempfile.mkdtemp(suffix="_dex")
-        pyredex.utils.unzip_apk(arguments.apk_path, apk_directory)
-        dex_mode = pyredex.unpacker.detect_secondary_dex_mode(apk_directory)
-        dex_mode.unpackage(apk_directory, dex_directory)
-        LOG.info(f"Extracted APK into `{apk_directory}` and DEX into `{dex_directory}`")
-
-        if configuration.FACEBOOK_SHIM and arguments.analyze_third_party:
-            output = start_third_party_analysis(
-                binary, arguments, apk_directory, dex_directory
-            )
+        if arguments.batch_configuration_path is not None:
+            targets = _read_batch_configuration(arguments.batch_configuration_path)
+            # The analysis cache is keyed by method fingerprints, hence it is
+            # only reused for the code that is identical across targets.
+            if arguments.analysis_cache_directory is None:
+                arguments.analysis_cache_directory = _directory_exists(
+                    tempfile.mkdtemp(suffix="_cache", dir=build_directory)
+                )
         else:
-            options = _get_command_options(arguments, apk_directory, dex_directory)
-            command = [os.fspath(binary.resolve())] + options
-            if arguments.gdb:
-                command = ["gdb", "--args"] + command
-            elif arguments.lldb:
-                command = ["lldb", "--"] + command
-            LOG.info(f"Running Mariana Trench: {' '.join(command)}")
-            output = subprocess.run(command)
-        if output.returncode != 0:
-            LOG.fatal(f"Analysis binary exited with exit code {output.returncode}.")
-            sys.exit(output.returncode)
+            targets = [(arguments.apk_path, arguments.output_directory)]
+
+        for apk_path, output_directory in targets:
+            arguments.apk_path = apk_path
+            arguments.output_directory = output_directory
+            returncode = _analyze_apk(binary, arguments)
+            if returncode != 0:
+                LOG.fatal(f"Analysis binary exited with exit code {returncode}.")
+                sys.exit(returncode)
     except (ClientError, ConfigurationError) as error:
         LOG.fatal(f"{type(error).__name__}: {error.args[0]}")
         LOG.fatal(error.exit_code)
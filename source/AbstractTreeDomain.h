@@ -62,8 +62,8 @@ enum class UpdateKind {
  *
  * ```
  * struct Configuration {
- *   // Maximum tree depth after widening.
- *   static std::size_t max_tree_height_after_widening();
+ *   // Maximum tree depth after widening. This must be a constant expression.
+ *   static constexpr std::size_t max_tree_height_after_widening();
  *
  *   // Transform elements that are collapsed during widening.
  *   static Elements transform_on_widening_collapse(Elements);
@@ -91,6 +91,10 @@ class AbstractTreeDomain final
   static_assert(std::is_same_v<
                 decltype(Configuration::max_tree_height_after_widening()),
                 std::size_t>);
+  // The widening height is a compile-time constant, which allows the compiler
+  // to unroll the recursion in `widen_with_internal`.
+  static constexpr std::size_t k_max_tree_height_after_widening =
+      Configuration::max_tree_height_after_widening();
   static_assert(std::is_same_v<
                 decltype(Configuration::transform_on_widening_collapse(
                     std::declval<const Elements>())),
@@ -321,6 +325,8 @@ class AbstractTreeDomain final
       return;
     } else if (is_bottom()) {
       *this = other;
+    } else if (ValueInterface::equals(*this, other)) {
+      return;
     } else {
       join_with_internal(other, Elements::bottom());
     }
@@ -360,7 +366,10 @@ class AbstractTreeDomain final
 
     const auto new_accumulator_tree = AbstractTreeDomain{
         Configuration::transform_on_sink(accumulator.join(elements_))};
-    Map new_children;
+    // Start from the current children, so that subtrees left unchanged by the
+    // join keep sharing their nodes with `this`. This keeps the pointer
+    // equality fast paths effective across iterations.
+    Map new_children = children_;
     const auto& subtree_star = children_.at(PathElement::any_index());
     const auto& other_subtree_star =
         other.children_.at(PathElement::any_index());
@@ -427,24 +436,20 @@ class AbstractTreeDomain final
       const AbstractTreeDomain& accumulator_tree,
       const AbstractTreeDomain& left_subtree,
       const AbstractTreeDomain& right_subtree) {
-    if (!right_subtree.is_bottom()) {
-      auto left_subtree_copy = left_subtree;
-      left_subtree_copy.join_with_internal(
-          right_subtree, accumulator_tree.elements_);
+    if (right_subtree.is_bottom() && left_subtree.leq(accumulator_tree)) {
+      children.remove(path_element);
+      return;
+    }
 
-      if (!left_subtree_copy.is_bottom()) {
-        children.insert_or_assign(path_element, std::move(left_subtree_copy));
-      }
-    } else {
-      if (!left_subtree.leq(accumulator_tree)) {
-        auto left_subtree_copy = left_subtree;
-        left_subtree_copy.join_with_internal(
-            right_subtree, accumulator_tree.elements_);
+    auto left_subtree_copy = left_subtree;
+    left_subtree_copy.join_with_internal(
+        right_subtree, accumulator_tree.elements_);
 
-        if (!left_subtree_copy.is_bottom()) {
-          children.insert_or_assign(path_element, std::move(left_subtree_copy));
-        }
-      }
+    if (left_subtree_copy.is_bottom()) {
+      children.remove(path_element);
+    } else if (!ValueInterface::equals(
+                   left_subtree_copy, children.at(path_element))) {
+      children.insert_or_assign(path_element, std::move(left_subtree_copy));
     }
   }
 
@@ -457,27 +462,33 @@ class AbstractTreeDomain final
     } else if (is_bottom()) {
       *this = other;
     } else {
-      widen_with_internal(
-          other,
-          Elements::bottom(),
-          Configuration::max_tree_height_after_widening());
+      widen_with_internal<k_max_tree_height_after_widening>(
+          other, Elements::bottom());
     }
 
     mt_expensive_assert(previous.leq(*this) && other.leq(*this));
   }
 
  private:
+  template <std::size_t MaxHeight>
   void widen_with_internal(
       const AbstractTreeDomain& other,
-      const Elements& accumulator,
-      std::size_t max_height) {
-    if (max_height == 0) {
+      const Elements& accumulator) {
+    if constexpr (MaxHeight == 0) {
       collapse_inplace(Configuration::transform_on_widening_collapse);
       elements_.join_with(
           other.collapse(Configuration::transform_on_widening_collapse));
       elements_.difference_with(accumulator);
-      return;
+    } else {
+      widen_with_internal_nonzero_height<MaxHeight>(other, accumulator);
     }
+  }
+
+  template <std::size_t MaxHeight>
+  void widen_with_internal_nonzero_height(
+      const AbstractTreeDomain& other,
+      const Elements& accumulator) {
+    static_assert(MaxHeight > 0);
 
     // The read semantics implies that an element on a node is implicitly
     // propagated to all its children. The `accumulator` contains all elements
@@ -488,7 +499,7 @@ class AbstractTreeDomain final
 
     if (children_.reference_equals(other.children_)) {
       collapse_deeper_than(
-          max_height, Configuration::transform_on_widening_collapse);
+          MaxHeight, Configuration::transform_on_widening_collapse);
       return;
     }
 
@@ -501,8 +512,8 @@ class AbstractTreeDomain final
 
       if (!other_subtree.is_bottom()) {
         auto subtree_copy = subtree;
-        subtree_copy.widen_with_internal(
-            other_subtree, new_accumulator_tree.elements_, max_height - 1);
+        subtree_copy.widen_with_internal<MaxHeight - 1>(
+            other_subtree, new_accumulator_tree.elements_);
 
         if (!subtree_copy.is_bottom()) {
           new_children.insert_or_assign(path_element, std::move(subtree_copy));
@@ -511,7 +522,7 @@ class AbstractTreeDomain final
         if (!subtree.leq(new_accumulator_tree)) {
           auto subtree_copy = subtree;
           subtree_copy.collapse_deeper_than(
-              max_height - 1, Configuration::transform_on_widening_collapse);
+              MaxHeight - 1, Configuration::transform_on_widening_collapse);
           new_children.insert_or_assign(path_element, subtree_copy);
         }
       }
@@ -527,7 +538,7 @@ class AbstractTreeDomain final
       if (!other_subtree.leq(new_accumulator_tree)) {
         auto other_subtree_copy = other_subtree;
         other_subtree_copy.collapse_deeper_than(
-            max_height - 1, Configuration::transform_on_widening_collapse);
+            MaxHeight - 1, Configuration::transform_on_widening_collapse);
         new_children.insert_or_assign(path_element, other_subtree_copy);
       }
     }
@@ -617,7 +628,7 @@ class AbstractTreeDomain final
   void collapse_deeper_than(std::size_t height) {
     if (height == 0) {
       collapse_inplace();
-    } else {
+    } else if (!children_.empty()) {
       children_.transform([height](AbstractTreeDomain subtree) {
         subtree.collapse_deeper_than(height - 1);
         return subtree;
@@ -672,6 +683,11 @@ class AbstractTreeDomain final
           is_valid,
       const Accumulator& accumulator,
       const std::function<Elements(Elements)>& transform_on_collapse) {
+    if (children_.empty()) {
+      // Leaves have no path to collapse, skip rebuilding the children.
+      return;
+    }
+
     Map new_children;
     for (const auto& [path_element, subtree] : children_) {
       const auto& [valid, accumulator_for_subtree] =
@@ -719,6 +735,10 @@ class AbstractTreeDomain final
   /* Return the depth at which the tree exceeds the given number of leaves. */
   std::optional<std::size_t> depth_exceeding_max_leaves(
       std::size_t max_leaves) const {
+    if (children_.empty()) {
+      return std::nullopt;
+    }
+
     // Set of trees at the current depth.
     std::vector<const AbstractTreeDomain*> trees = {this};
     std::size_t depth = 0;
@@ -13,6 +13,7 @@
 #include <string_view>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/functional/hash.hpp>
 #include <json/json.h>
 
@@ -337,7 +338,16 @@ namespace marianatrench {
 class Path final {
  public:
   using Element = PathElement;
-  using ConstIterator = std::vector<Element>::const_iterator;
+
+ private:
+  /**
+   * Paths are copied with every access path, and are rarely longer than the
+   * maximum height of taint trees, hence short paths are stored inline.
+   */
+  using Elements = boost::container::small_vector<Element, 4>;
+
+ public:
+  using ConstIterator = Elements::const_iterator;
 
  public:
   // C++ container concept member types
@@ -397,7 +407,7 @@ class Path final {
   friend std::ostream& operator<<(std::ostream& out, const Path& path);
 
  private:
-  std::vector<Element> elements_;
+  Elements elements_;
 };
 
 } // namespace marianatrench
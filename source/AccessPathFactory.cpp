@@ -6,11 +6,18 @@
  */
 
 #include <mariana-trench/AccessPathFactory.h>
+#include <mariana-trench/CacheStatistics.h>
 
 namespace marianatrench {
 
 const AccessPath* AccessPathFactory::get(const AccessPath& access_path) const {
-  return access_paths_.insert(access_path).first;
+  auto [result, inserted] = access_paths_.insert(access_path);
+  CacheStatistics::lookup(
+      CacheStatistics::Cache::AccessPaths, /* hit */ !inserted);
+  if (inserted) {
+    CacheStatistics::insert(CacheStatistics::Cache::AccessPaths);
+  }
+  return result;
 }
 
 const AccessPathFactory& AccessPathFactory::singleton() {
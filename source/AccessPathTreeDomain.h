@@ -206,8 +206,12 @@ class AccessPathTreeDomain final
           is_valid,
       const std::function<Accumulator(const Root&)>& initial_accumulator,
       const std::function<Elements(Elements)>& transform_on_collapse) {
-    Map new_map;
+    // Only trees with children may change, others are shared with `map_`.
+    Map new_map = map_;
     for (const auto& [root, tree] : map_) {
+      if (tree.successors().empty()) {
+        continue;
+      }
       auto copy = tree;
       copy.collapse_invalid_paths(
           is_valid,
@@ -278,6 +282,11 @@ class AccessPathTreeDomain final
                     transform_on_collapse =
                         std::forward<Transform>(transform_on_collapse)](
                        const AbstractTreeDomainT& tree) {
+      if (tree.successors().empty()) {
+        // A tree without children already fits any mold built from it.
+        return tree;
+      }
+
       auto mold = tree;
       mold.transform(make_mold);
 
@@ -7,6 +7,8 @@
 
 #include <fmt/format.h>
 
+#include <ControlFlow.h>
+#include <IRCode.h>
 #include <Show.h>
 
 #include <mariana-trench/AliasAnalysisResults.h>
@@ -14,6 +16,18 @@
 
 namespace marianatrench {
 
+namespace {
+
+std::size_t number_of_instructions(const Method* method) {
+  const auto* code = method->get_code();
+  if (code == nullptr || !code->cfg_built()) {
+    return 0;
+  }
+  return code->cfg().num_opcodes();
+}
+
+} // namespace
+
 InstructionAliasResults::InstructionAliasResults(
     RegisterMemoryLocationsMap register_memory_locations_map,
     std::optional<MemoryLocationsDomain> result_memory_locations,
@@ -64,6 +78,10 @@ DexPosition* MT_NULLABLE InstructionAliasResults::position() const {
   return position_;
 }
 
+AliasAnalysisResults::AliasAnalysisResults(std::size_t instructions) {
+  instructions_.reserve(instructions);
+}
+
 const InstructionAliasResults& AliasAnalysisResults::get(
     const IRInstruction* instruction) const {
   mt_assert(instruction != nullptr);
@@ -79,10 +97,22 @@ const InstructionAliasResults& AliasAnalysisResults::get(
   return it->second;
 }
 
+const InstructionAliasResults* MT_NULLABLE
+AliasAnalysisResults::get_or_null(const IRInstruction* instruction) const {
+  auto it = instructions_.find(instruction);
+  return it != instructions_.end() ? &it->second : nullptr;
+}
+
 void AliasAnalysisResults::store(
     const IRInstruction* instruction,
     InstructionAliasResults results) {
   instructions_.insert_or_assign(instruction, std::move(results));
 }
 
+ForwardAliasResults::ForwardAliasResults(const Method* method)
+    : memory_factory(method),
+      aliasing(number_of_instructions(method)),
+      inline_as_getter(AccessPathConstantDomain::top()),
+      inline_as_setter(SetterAccessPathConstantDomain::top()) {}
+
 } // namespace marianatrench
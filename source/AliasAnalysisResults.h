@@ -7,19 +7,25 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <unordered_map>
 
 #include <IRInstruction.h>
 
+#include <mariana-trench/Access.h>
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/Compiler.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/MemoryLocation.h>
 #include <mariana-trench/MemoryLocationEnvironment.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/SetterAccessPathConstantDomain.h>
 
 namespace marianatrench {
 
+class ForwardTaintStates;
+
 /* Alias information about a specific instruction. */
 class InstructionAliasResults final {
  public:
@@ -65,10 +71,17 @@ class AliasAnalysisResults final {
  public:
   AliasAnalysisResults() = default;
 
+  /* Reserve space for the results of the given number of instructions. */
+  explicit AliasAnalysisResults(std::size_t instructions);
+
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(AliasAnalysisResults)
 
   const InstructionAliasResults& get(const IRInstruction* instruction) const;
 
+  /* Results of the given instruction, or nullptr if they were not stored. */
+  const InstructionAliasResults* MT_NULLABLE
+  get_or_null(const IRInstruction* instruction) const;
+
   void store(const IRInstruction* instruction, InstructionAliasResults results);
 
  private:
@@ -76,4 +89,46 @@ class AliasAnalysisResults final {
       instructions_;
 };
 
+/* The parts of a callee model that the forward alias analysis depends on. */
+struct AliasCalleeSummary {
+  // Access path returned by the callee, or top if it cannot be inlined.
+  AccessPathConstantDomain inline_as_getter;
+  bool alias_memory_location_on_invoke;
+
+  bool operator==(const AliasCalleeSummary& other) const {
+    return inline_as_getter == other.inline_as_getter &&
+        alias_memory_location_on_invoke ==
+            other.alias_memory_location_on_invoke;
+  }
+};
+
+/**
+ * Results of the forward alias analysis of a method, along with the memory
+ * locations they refer to.
+ *
+ * These only depend on the code of the method and on the summaries of its
+ * callee models, hence they can be reused as long as the summaries of the
+ * callees are unchanged.
+ */
+class ForwardAliasResults final {
+ public:
+  explicit ForwardAliasResults(const Method* method);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ForwardAliasResults)
+
+  MemoryFactory memory_factory;
+  AliasAnalysisResults aliasing;
+
+  // Summaries of the callee models at each invoke instruction.
+  std::unordered_map<const IRInstruction*, AliasCalleeSummary> callees;
+
+  // Inlining information inferred for the method.
+  AccessPathConstantDomain inline_as_getter;
+  SetterAccessPathConstantDomain inline_as_setter;
+
+  // States of the forward taint fixpoint over these results, only kept with
+  // `--incremental-reanalysis`.
+  std::shared_ptr<ForwardTaintStates> forward_taint_states;
+};
+
 } // namespace marianatrench
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <fmt/format.h>
+
+#include <IRCode.h>
+
+#include <mariana-trench/AnalysisCache.h>
+#include <mariana-trench/Filesystem.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the analysis changes in a way that invalidates results.
+constexpr int k_version = 1;
+
+void hash_files(std::size_t& seed, const std::vector<std::string>& paths) {
+  for (const auto& path : paths) {
+    std::string content;
+    filesystem::load_string_file(path, content);
+    boost::hash_combine(seed, content);
+  }
+}
+
+} // namespace
+
+AnalysisCache::AnalysisCache(
+    const std::filesystem::path& cache_directory,
+    const Options& options,
+    const Methods& methods,
+    const Dependencies& dependencies,
+    const Registry& registry)
+    : path_(cache_directory / "analysis_cache.json"),
+      configuration_(configuration_fingerprint(options)) {
+  std::unordered_map<const Method*, std::vector<std::string>> callees;
+  for (const auto* method : methods) {
+    initial_models_.emplace(method, registry.get_snapshot(method));
+    for (const auto* dependency : dependencies.dependencies(method)) {
+      callees[dependency].push_back(method->show());
+    }
+  }
+
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        std::size_t seed = 0;
+
+        const auto* code = method->get_code();
+        if (code != nullptr && code->cfg_built()) {
+          boost::hash_combine(
+              seed, Method::show_control_flow_graph(code->cfg()));
+        }
+
+        boost::hash_combine(
+            seed,
+            JsonValidation::to_styled_string(
+                initial_models_.at(method)->to_json(
+                    ExportOriginsMode::Always)));
+
+        auto callees_iterator = callees.find(method);
+        if (callees_iterator != callees.end()) {
+          auto method_callees = callees_iterator->second;
+          std::sort(method_callees.begin(), method_callees.end());
+          for (const auto& callee : method_callees) {
+            boost::hash_combine(seed, callee);
+          }
+        }
+
+        fingerprints_.emplace(method, std::to_string(seed));
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  load(dependencies);
+}
+
+bool AnalysisCache::skip(const Method* method) const {
+  return skipped_methods_.count(method) > 0;
+}
+
+std::size_t AnalysisCache::skipped_methods_size() const {
+  return skipped_methods_.size();
+}
+
+void AnalysisCache::store(const Registry& registry) const {
+  auto methods_value = Json::Value(Json::objectValue);
+  for (const auto& [method, fingerprint] : fingerprints_) {
+    auto method_value = Json::Value(Json::objectValue);
+    method_value["fingerprint"] = fingerprint;
+    method_value["unchanged"] =
+        *registry.get_snapshot(method) == *initial_models_.at(method);
+    methods_value[method->show()] = method_value;
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["version"] = k_version;
+  value["configuration"] = configuration_;
+  value["methods"] = methods_value;
+
+  LOG(1, "Writing analysis cache to `{}`.", path_.native());
+  JsonValidation::write_json_file(path_, value);
+}
+
+std::string AnalysisCache::configuration_fingerprint(const Options& options) {
+  std::size_t seed = 0;
+  hash_files(seed, options.rules_paths());
+  hash_files(seed, options.field_models_paths());
+  hash_files(seed, options.literal_models_paths());
+  hash_files(seed, options.lifecycles_paths());
+  hash_files(seed, options.shims_paths());
+  boost::hash_combine(seed, options.maximum_source_sink_distance());
+  boost::hash_combine(seed, options.emit_all_via_cast_features());
+  boost::hash_combine(seed, options.enable_cross_component_analysis());
+  boost::hash_combine(seed, options.propagate_across_arguments());
+  return std::to_string(seed);
+}
+
+void AnalysisCache::load(const Dependencies& dependencies) {
+  if (!std::filesystem::exists(path_)) {
+    LOG(1, "No analysis cache found at `{}`.", path_.native());
+    return;
+  }
+
+  auto value = JsonValidation::parse_json_file(path_);
+  JsonValidation::validate_object(value);
+  if (JsonValidation::integer(value, /* field */ "version") != k_version ||
+      JsonValidation::string(value, /* field */ "configuration") !=
+          configuration_) {
+    WARNING(1, "Analysis cache `{}` is outdated, ignoring it.", path_.native());
+    return;
+  }
+  const auto& methods_value =
+      JsonValidation::object(value, /* field */ "methods");
+
+  // Methods that changed, along with their transitive callers.
+  std::unordered_set<const Method*> invalid_methods;
+  std::vector<const Method*> worklist;
+  std::vector<const Method*> unchanged_methods;
+  for (const auto& [method, fingerprint] : fingerprints_) {
+    const auto& method_value = methods_value[method->show()];
+    if (method_value.isNull() ||
+        JsonValidation::string(method_value, /* field */ "fingerprint") !=
+            fingerprint) {
+      invalid_methods.insert(method);
+      worklist.push_back(method);
+    } else if (JsonValidation::boolean(method_value, /* field */ "unchanged")) {
+      unchanged_methods.push_back(method);
+    }
+  }
+
+  while (!worklist.empty()) {
+    const auto* method = worklist.back();
+    worklist.pop_back();
+    for (const auto* dependency : dependencies.dependencies(method)) {
+      if (invalid_methods.insert(dependency).second) {
+        worklist.push_back(dependency);
+      }
+    }
+  }
+
+  for (const auto* method : unchanged_methods) {
+    if (invalid_methods.count(method) == 0) {
+      skipped_methods_.insert(method);
+    }
+  }
+
+  LOG(1,
+      "Loaded analysis cache from `{}`: {} methods changed, {} methods skipped.",
+      path_.native(),
+      invalid_methods.size(),
+      skipped_methods_.size());
+}
+
+} // namespace marianatrench
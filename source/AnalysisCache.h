@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <json/json.h>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Options.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Cache of the global fixpoint across runs, used for incremental analysis.
+ *
+ * Each method has a fingerprint computed from its code, its initial model and
+ * the methods it depends on. The cache stores the fingerprints along with the
+ * set of methods whose model was left unchanged by the analysis.
+ *
+ * On the next run, a method is not analyzed in the first iteration of the
+ * fixpoint if its model was left unchanged and neither the method nor any of
+ * its transitive callees changed. These methods are still analyzed if the
+ * model of one of their callees changes during the fixpoint.
+ *
+ * Inferred models are not stored, since the output format of models is lossy.
+ * The whole cache is invalidated when rules, field models, literal models,
+ * lifecycles, shims or analysis options change.
+ */
+class AnalysisCache final {
+ public:
+  /* Read the cache from `cache_directory`, if it exists. */
+  explicit AnalysisCache(
+      const std::filesystem::path& cache_directory,
+      const Options& options,
+      const Methods& methods,
+      const Dependencies& dependencies,
+      const Registry& registry);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(AnalysisCache)
+
+  /* Return true if the method does not need to be analyzed initially. */
+  bool skip(const Method* method) const;
+
+  std::size_t skipped_methods_size() const;
+
+  /* Write the cache for the models computed by the fixpoint. */
+  void store(const Registry& registry) const;
+
+  /**
+   * Fingerprint of the configuration files and options affecting the models
+   * of all methods.
+   */
+  static std::string configuration_fingerprint(const Options& options);
+
+ private:
+  void load(const Dependencies& dependencies);
+
+ private:
+  std::filesystem::path path_;
+  std::string configuration_;
+  ConcurrentMap<const Method*, std::string> fingerprints_;
+  std::unordered_map<const Method*, std::shared_ptr<const Model>>
+      initial_models_;
+  std::unordered_set<const Method*> skipped_methods_;
+};
+
+} // namespace marianatrench
@@ -5,6 +5,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <utility>
+
 #include <mariana-trench/ArtificialMethods.h>
 #include <mariana-trench/Methods.h>
 #include <mariana-trench/Redex.h>
@@ -61,7 +63,7 @@ std::vector<Model> ArtificialMethods::models(Context& context) const {
           /* local_positions */ {},
           /* locally_inferred_features */ FeatureMayAlwaysSet::bottom(),
           /* extra_traces */ {}));
-  models.push_back(model);
+  models.push_back(std::move(model));
 
   return models;
 }
@@ -5,6 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <optional>
+#include <unordered_set>
+
+#include <ControlFlow.h>
+#include <IRCode.h>
+#include <IRInstruction.h>
 #include <Show.h>
 
 #include <mariana-trench/Assert.h>
@@ -21,13 +27,75 @@ Taint BackwardTaintEnvironment::propagate_output_path(
   return taint;
 }
 
+namespace {
+
+void add_parameter_positions(
+    const MemoryLocationsDomain& memory_locations,
+    std::unordered_set<ParameterPosition>& positions) {
+  for (auto* memory_location : memory_locations.elements()) {
+    if (auto* parameter =
+            memory_location->root()->as<ParameterMemoryLocation>()) {
+      positions.insert(parameter->position());
+    }
+  }
+}
+
+/**
+ * Parameters whose memory is read by the backward transfer functions, to taint
+ * other registers: targets of field and array writes, arguments and results of
+ * calls. Instructions without alias results are not analyzed.
+ */
+std::unordered_set<ParameterPosition> written_parameters(
+    MethodContext& context) {
+  std::unordered_set<ParameterPosition> positions;
+  for (const auto* block : context.method()->get_code()->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      auto opcode = instruction->opcode();
+      if (!opcode::is_an_iput(opcode) && !opcode::is_an_aput(opcode) &&
+          !opcode::is_an_invoke(opcode)) {
+        continue;
+      }
+      const auto* aliasing = context.aliasing.get_or_null(instruction);
+      if (aliasing == nullptr) {
+        continue;
+      }
+      if (!opcode::is_an_invoke(opcode)) {
+        add_parameter_positions(
+            aliasing->register_memory_locations(instruction->src(1)),
+            positions);
+        continue;
+      }
+      for (auto register_id : instruction->srcs()) {
+        add_parameter_positions(
+            aliasing->register_memory_locations(register_id), positions);
+      }
+      if (instruction->has_move_result_any()) {
+        add_parameter_positions(aliasing->result_memory_locations(), positions);
+      }
+    }
+  }
+  return positions;
+}
+
+} // namespace
+
 BackwardTaintEnvironment BackwardTaintEnvironment::initial(
     MethodContext& context) {
   auto taint = TaintEnvironment::bottom();
 
+  std::optional<std::unordered_set<ParameterPosition>> seeded_parameters =
+      std::nullopt;
+  if (context.options.sparse_taint_analysis()) {
+    seeded_parameters = written_parameters(context);
+  }
+  auto is_seeded = [&seeded_parameters](ParameterPosition position) {
+    return !seeded_parameters || seeded_parameters->count(position) > 0;
+  };
+
   const Method* method = context.method();
   const bool is_static = method->is_static();
-  if (!is_static) {
+  if (!is_static && is_seeded(0)) {
     taint.set(
         context.memory_factory.make_parameter(0),
         TaintTree(Taint::propagation_taint(
@@ -46,7 +114,8 @@ BackwardTaintEnvironment BackwardTaintEnvironment::initial(
          i < method->number_of_parameters();
          ++i) {
       const DexType* argument_type = method->parameter_type(i);
-      if (argument_type == nullptr || !type::is_object(argument_type)) {
+      if (argument_type == nullptr || !type::is_object(argument_type) ||
+          !is_seeded(i)) {
         continue;
       }
 
@@ -28,6 +28,13 @@ class BackwardTaintEnvironment final
   explicit BackwardTaintEnvironment(TaintEnvironment taint)
       : taint_(std::move(taint)) {}
 
+  /**
+   * Seed the receiver and the arguments with their local kinds, to infer
+   * propagations. With `--sparse-taint-analysis`, only parameters whose memory
+   * may be written by the method are seeded: other seeds can only infer the
+   * trivial propagations `Argument(i) -> Argument(i)`, which are dropped.
+   * This requires the forward alias analysis results.
+   */
   static BackwardTaintEnvironment initial(MethodContext& context);
 
   INCLUDE_ABSTRACT_DOMAIN_METHODS(
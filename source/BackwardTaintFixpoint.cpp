@@ -11,9 +11,11 @@
 namespace marianatrench {
 
 BackwardTaintFixpoint::BackwardTaintFixpoint(
+    const MethodContext& context,
     const cfg::ControlFlowGraph& cfg,
     InstructionAnalyzer<BackwardTaintEnvironment> instruction_analyzer)
     : MonotonicFixpointIterator(cfg, cfg.num_blocks()),
+      context_(context),
       instruction_analyzer_(instruction_analyzer) {}
 
 BackwardTaintFixpoint::~BackwardTaintFixpoint() {}
@@ -21,6 +23,7 @@ BackwardTaintFixpoint::~BackwardTaintFixpoint() {}
 void BackwardTaintFixpoint::analyze_node(
     const NodeId& block,
     BackwardTaintEnvironment* taint) const {
+  context_.visit_block();
   LOG(4, "Analyzing block {}\n{}", block->id(), *taint);
   for (auto it = block->rbegin(); it != block->rend(); ++it) {
     if (it->type == MFLOW_OPCODE) {
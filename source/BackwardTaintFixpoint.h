@@ -14,6 +14,7 @@
 
 #include <mariana-trench/BackwardTaintEnvironment.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MethodContext.h>
 
 namespace marianatrench {
 
@@ -23,6 +24,7 @@ class BackwardTaintFixpoint final
           BackwardTaintEnvironment> {
  public:
   BackwardTaintFixpoint(
+      const MethodContext& context,
       const cfg::ControlFlowGraph& cfg,
       InstructionAnalyzer<BackwardTaintEnvironment> instruction_analyzer);
 
@@ -36,6 +38,7 @@ class BackwardTaintFixpoint final
       const BackwardTaintEnvironment& taint) const override;
 
  private:
+  const MethodContext& context_;
   InstructionAnalyzer<BackwardTaintEnvironment> instruction_analyzer_;
 };
 
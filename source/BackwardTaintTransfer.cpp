@@ -781,6 +781,10 @@ void check_flows_to_field_sink(
       opcode::is_an_sput(instruction->opcode()) ||
       opcode::is_an_iput(instruction->opcode()));
 
+  if (!context->registry.may_have_field_model(instruction->get_field())) {
+    return;
+  }
+
   const auto field_target =
       context->call_graph.resolved_field_access(context->method(), instruction);
   if (!field_target) {
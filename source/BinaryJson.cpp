@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/BinaryJson.h>
+#include <mariana-trench/Filesystem.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+constexpr char k_magic[] = {'M', 'T', 'B', 'J'};
+
+// Bump this whenever the encoding changes.
+constexpr std::uint64_t k_version = 1;
+
+enum class Tag : std::uint8_t {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Int = 3,
+  UInt = 4,
+  Real = 5,
+  String = 6,
+  Array = 7,
+  Object = 8,
+};
+
+void write_tag(std::string& output, Tag tag) {
+  output.push_back(static_cast<char>(tag));
+}
+
+void write_varint(std::string& output, std::uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+std::uint64_t read_varint(std::istream& input) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int byte = input.get();
+    if (byte == std::char_traits<char>::eof()) {
+      throw std::invalid_argument("Unexpected end of binary json input.");
+    }
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw std::invalid_argument("Invalid varint in binary json input.");
+}
+
+std::uint64_t read_varint(const std::string& input, std::size_t& position) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (position >= input.size()) {
+      throw std::invalid_argument("Unexpected end of binary json record.");
+    }
+    auto byte = static_cast<unsigned char>(input[position++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw std::invalid_argument("Invalid varint in binary json record.");
+}
+
+std::string read_bytes(std::istream& input, std::uint64_t size) {
+  std::string bytes(size, '\0');
+  input.read(bytes.data(), static_cast<std::streamsize>(size));
+  if (static_cast<std::uint64_t>(input.gcount()) != size) {
+    throw std::invalid_argument("Unexpected end of binary json input.");
+  }
+  return bytes;
+}
+
+} // namespace
+
+void BinaryJsonWriter::add(const Json::Value& value) {
+  record_buffer_.clear();
+  encode(value, record_buffer_);
+  write_varint(records_, record_buffer_.size());
+  records_.append(record_buffer_);
+  number_records_++;
+}
+
+void BinaryJsonWriter::write(std::ostream& output) const {
+  std::string header(k_magic, sizeof(k_magic));
+  write_varint(header, k_version);
+  write_varint(header, strings_.size());
+  for (const auto* string : strings_) {
+    write_varint(header, string->size());
+    header.append(*string);
+  }
+  write_varint(header, number_records_);
+
+  output.write(header.data(), static_cast<std::streamsize>(header.size()));
+  output.write(records_.data(), static_cast<std::streamsize>(records_.size()));
+}
+
+void BinaryJsonWriter::encode(const Json::Value& value, std::string& output) {
+  switch (value.type()) {
+    case Json::nullValue:
+      write_tag(output, Tag::Null);
+      break;
+    case Json::booleanValue:
+      write_tag(output, value.asBool() ? Tag::True : Tag::False);
+      break;
+    case Json::intValue: {
+      auto integer = value.asInt64();
+      write_tag(output, Tag::Int);
+      write_varint(
+          output,
+          (static_cast<std::uint64_t>(integer) << 1) ^
+              static_cast<std::uint64_t>(integer >> 63));
+      break;
+    }
+    case Json::uintValue:
+      write_tag(output, Tag::UInt);
+      write_varint(output, value.asUInt64());
+      break;
+    case Json::realValue: {
+      double real = value.asDouble();
+      std::uint64_t bits;
+      std::memcpy(&bits, &real, sizeof(bits));
+      write_tag(output, Tag::Real);
+      for (int byte = 0; byte < 8; byte++) {
+        output.push_back(static_cast<char>((bits >> (8 * byte)) & 0xff));
+      }
+      break;
+    }
+    case Json::stringValue:
+      write_tag(output, Tag::String);
+      write_varint(output, string_index(value.asString()));
+      break;
+    case Json::arrayValue:
+      write_tag(output, Tag::Array);
+      write_varint(output, value.size());
+      for (const auto& element : value) {
+        encode(element, output);
+      }
+      break;
+    case Json::objectValue:
+      write_tag(output, Tag::Object);
+      write_varint(output, value.size());
+      for (auto iterator = value.begin(); iterator != value.end(); ++iterator) {
+        write_varint(output, string_index(iterator.name()));
+        encode(*iterator, output);
+      }
+      break;
+  }
+}
+
+std::uint64_t BinaryJsonWriter::string_index(const std::string& string) {
+  auto [iterator, inserted] =
+      string_indices_.emplace(string, string_indices_.size());
+  if (inserted) {
+    strings_.push_back(&iterator->first);
+  }
+  return iterator->second;
+}
+
+void BinaryJsonWriter::write_sharded_files(
+    const std::filesystem::path& output_directory,
+    const std::size_t batch_size,
+    const std::size_t total_elements,
+    const std::string& filename_prefix,
+    const std::function<Json::Value(std::size_t)>& get_value) {
+  filesystem::remove_files_with_prefix(output_directory, filename_prefix);
+
+  const auto total_batch = total_elements / batch_size + 1;
+  const auto padded_total_batch = fmt::format("{:0>5}", total_batch);
+
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t batch) {
+        const auto padded_batch = fmt::format("{:0>5}", batch);
+        const auto batch_path = output_directory /
+            (filename_prefix + padded_batch + "-of-" + padded_total_batch +
+             ".mtb");
+
+        BinaryJsonWriter writer;
+        for (std::size_t i = batch_size * batch;
+             i < batch_size * (batch + 1) && i < total_elements;
+             i++) {
+          writer.add(get_value(i));
+        }
+
+        std::ofstream batch_stream(batch_path, std::ios_base::binary);
+        if (!batch_stream.is_open()) {
+          ERROR(1, "Unable to write binary json to `{}`.", batch_path.native());
+          return;
+        }
+        writer.write(batch_stream);
+      },
+      sparta::parallel::default_num_threads());
+
+  for (std::size_t batch = 0; batch < total_batch; batch++) {
+    queue.add_item(batch);
+  }
+  queue.run_all();
+
+  LOG(1, "Wrote binary json to {} shards.", total_batch);
+}
+
+BinaryJsonReader::BinaryJsonReader(std::istream& input) : input_(input) {
+  auto magic = read_bytes(input_, sizeof(k_magic));
+  if (std::memcmp(magic.data(), k_magic, sizeof(k_magic)) != 0) {
+    throw std::invalid_argument("Input is not binary json.");
+  }
+  auto version = read_varint(input_);
+  if (version != k_version) {
+    throw std::invalid_argument(
+        fmt::format("Unsupported binary json version {}.", version));
+  }
+
+  auto number_strings = read_varint(input_);
+  strings_.reserve(number_strings);
+  for (std::uint64_t i = 0; i < number_strings; i++) {
+    strings_.push_back(read_bytes(input_, read_varint(input_)));
+  }
+  remaining_records_ = read_varint(input_);
+}
+
+std::optional<Json::Value> BinaryJsonReader::next() {
+  if (remaining_records_ == 0) {
+    return std::nullopt;
+  }
+  remaining_records_--;
+
+  auto record = read_bytes(input_, read_varint(input_));
+  std::size_t position = 0;
+  auto value = decode(record, position);
+  if (position != record.size()) {
+    throw std::invalid_argument("Trailing bytes in binary json record.");
+  }
+  return value;
+}
+
+Json::Value BinaryJsonReader::decode(
+    const std::string& record,
+    std::size_t& position) const {
+  if (position >= record.size()) {
+    throw std::invalid_argument("Unexpected end of binary json record.");
+  }
+
+  auto string = [&]() -> const std::string& {
+    auto index = read_varint(record, position);
+    if (index >= strings_.size()) {
+      throw std::invalid_argument("Invalid string index in binary json.");
+    }
+    return strings_[index];
+  };
+
+  switch (static_cast<Tag>(record[position++])) {
+    case Tag::Null:
+      return Json::Value(Json::nullValue);
+    case Tag::False:
+      return Json::Value(false);
+    case Tag::True:
+      return Json::Value(true);
+    case Tag::Int: {
+      auto zigzag = read_varint(record, position);
+      return Json::Value(static_cast<Json::Int64>(
+          (zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+    }
+    case Tag::UInt:
+      return Json::Value(
+          static_cast<Json::UInt64>(read_varint(record, position)));
+    case Tag::Real: {
+      if (position + 8 > record.size()) {
+        throw std::invalid_argument("Unexpected end of binary json record.");
+      }
+      std::uint64_t bits = 0;
+      for (int byte = 0; byte < 8; byte++) {
+        bits |= static_cast<std::uint64_t>(
+                    static_cast<unsigned char>(record[position++]))
+            << (8 * byte);
+      }
+      double real;
+      std::memcpy(&real, &bits, sizeof(real));
+      return Json::Value(real);
+    }
+    case Tag::String:
+      return Json::Value(string());
+    case Tag::Array: {
+      auto value = Json::Value(Json::arrayValue);
+      auto size = read_varint(record, position);
+      for (std::uint64_t i = 0; i < size; i++) {
+        value.append(decode(record, position));
+      }
+      return value;
+    }
+    case Tag::Object: {
+      auto value = Json::Value(Json::objectValue);
+      auto size = read_varint(record, position);
+      for (std::uint64_t i = 0; i < size; i++) {
+        const auto& key = string();
+        value[key] = decode(record, position);
+      }
+      return value;
+    }
+    default:
+      throw std::invalid_argument("Invalid tag in binary json.");
+  }
+}
+
+} // namespace marianatrench
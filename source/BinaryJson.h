@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Compact binary encoding of a sequence of json values, used for the model
+ * output with `--binary-model-output`.
+ *
+ * A file is made of:
+ * - the magic bytes `MTBJ` and the format version;
+ * - the string table: the number of strings, then each string as its length
+ *   followed by its bytes;
+ * - the number of records, then each record as its length in bytes followed
+ *   by one encoded value.
+ *
+ * Every string of a value, including object keys, is stored as an index in
+ * the string table, hence repeated method signatures, kinds, features and
+ * paths are only stored once per file. Records can be decoded independently
+ * once the string table is read.
+ *
+ * Counts, lengths and indices are unsigned LEB128 varints. A value starts with
+ * its tag:
+ * - 0: null, 1: false, 2: true;
+ * - 3: signed integer, zigzag encoded;
+ * - 4: unsigned integer;
+ * - 5: double, as 8 little-endian bytes;
+ * - 6: string, as a string index;
+ * - 7: array, as the number of elements followed by the elements;
+ * - 8: object, as the number of members followed by the key string index and
+ *   the value of each member.
+ *
+ * See `scripts/binary_models.py` for a python reader.
+ */
+class BinaryJsonWriter final {
+ public:
+  BinaryJsonWriter() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(BinaryJsonWriter)
+
+  /* Append a record. */
+  void add(const Json::Value& value);
+
+  /* Write the header, the string table and all records. */
+  void write(std::ostream& output) const;
+
+  /**
+   * Same as `JsonValidation::write_sharded_json_files`, but writes binary
+   * shards with the `.mtb` extension.
+   */
+  static void write_sharded_files(
+      const std::filesystem::path& output_directory,
+      const std::size_t batch_size,
+      const std::size_t total_elements,
+      const std::string& filename_prefix,
+      const std::function<Json::Value(std::size_t)>& get_value);
+
+ private:
+  void encode(const Json::Value& value, std::string& output);
+  std::uint64_t string_index(const std::string& string);
+
+ private:
+  std::unordered_map<std::string, std::uint64_t> string_indices_;
+  std::vector<const std::string*> strings_;
+  std::string records_;
+  std::uint64_t number_records_ = 0;
+  std::string record_buffer_;
+};
+
+class BinaryJsonReader final {
+ public:
+  /* Read the header and the string table. Throws on invalid input. */
+  explicit BinaryJsonReader(std::istream& input);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(BinaryJsonReader)
+
+  /* Read the next record, or return `std::nullopt` after the last one. */
+  std::optional<Json::Value> next();
+
+ private:
+  Json::Value decode(const std::string& record, std::size_t& position) const;
+
+ private:
+  std::istream& input_;
+  std::vector<std::string> strings_;
+  std::uint64_t remaining_records_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <mariana-trench/CacheStatistics.h>
+
+namespace marianatrench {
+
+std::atomic<bool> CacheStatistics::enabled_ = false;
+
+namespace {
+
+constexpr std::array<const char*, CacheStatistics::kNumberOfCaches>
+    k_cache_names = {
+        "method_callsite_models",
+        "callsite_models",
+        "joined_callsite_models",
+        "kinds",
+        "features",
+        "origins",
+        "transforms",
+        "extra_traces",
+        "override_sets",
+        "access_paths",
+        "positions",
+        "type_environments",
+};
+
+constexpr std::array<const char*, CacheStatistics::kNumberOfEvents>
+    k_event_names = {"lookups", "hits", "inserts", "contention"};
+
+/* Counters of a single thread. Only written by their thread. */
+struct ThreadCounters {
+  std::array<
+      std::array<std::atomic<std::uint64_t>, CacheStatistics::kNumberOfEvents>,
+      CacheStatistics::kNumberOfCaches>
+      counters{};
+};
+
+/**
+ * Counters of all threads. Worker threads only live for a single run of a
+ * work queue, hence the counters of exited threads are reused by new ones.
+ */
+class ThreadCountersRegistry {
+ public:
+  ThreadCounters* acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!available_.empty()) {
+      auto* counters = available_.back();
+      available_.pop_back();
+      return counters;
+    }
+    return all_.emplace_back(std::make_unique<ThreadCounters>()).get();
+  }
+
+  void release(ThreadCounters* counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_.push_back(counters);
+  }
+
+  CacheStatistics::Counters sum() {
+    CacheStatistics::Counters result{};
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& counters : all_) {
+      for (std::size_t cache = 0; cache < CacheStatistics::kNumberOfCaches;
+           cache++) {
+        for (std::size_t event = 0; event < CacheStatistics::kNumberOfEvents;
+             event++) {
+          result[cache][event] +=
+              counters->counters[cache][event].load(std::memory_order_relaxed);
+        }
+      }
+    }
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadCounters>> all_;
+  std::vector<ThreadCounters*> available_;
+};
+
+ThreadCountersRegistry& thread_counters_registry() {
+  // Never destroyed, since threads may exit after static destructors run.
+  static auto* registry = new ThreadCountersRegistry();
+  return *registry;
+}
+
+/* Counters of the current thread, released when the thread exits. */
+struct ThreadCountersHandle {
+  ThreadCounters* counters = thread_counters_registry().acquire();
+
+  ~ThreadCountersHandle() {
+    thread_counters_registry().release(counters);
+  }
+};
+
+} // namespace
+
+void CacheStatistics::enable() {
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void CacheStatistics::increment(Cache cache, Event event) {
+  thread_local ThreadCountersHandle handle;
+  auto& counter = handle.counters->counters[static_cast<std::size_t>(cache)]
+                                           [static_cast<std::size_t>(event)];
+  // Only this thread writes the counter, a read-modify-write is not needed.
+  counter.store(
+      counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+CacheStatistics::Counters CacheStatistics::snapshot() {
+  return thread_counters_registry().sum();
+}
+
+CacheStatistics::Counters CacheStatistics::difference(
+    const Counters& after,
+    const Counters& before) {
+  Counters result{};
+  for (std::size_t cache = 0; cache < kNumberOfCaches; cache++) {
+    for (std::size_t event = 0; event < kNumberOfEvents; event++) {
+      result[cache][event] = after[cache][event] - before[cache][event];
+    }
+  }
+  return result;
+}
+
+Json::Value CacheStatistics::to_json(const Counters& counters) {
+  auto value = Json::Value(Json::objectValue);
+  for (std::size_t cache = 0; cache < kNumberOfCaches; cache++) {
+    const auto& events = counters[cache];
+    if (events[static_cast<std::size_t>(Event::Lookup)] == 0 &&
+        events[static_cast<std::size_t>(Event::Insert)] == 0) {
+      continue;
+    }
+    auto cache_value = Json::Value(Json::objectValue);
+    for (std::size_t event = 0; event < kNumberOfEvents; event++) {
+      cache_value[k_event_names[event]] =
+          Json::Value(static_cast<Json::UInt64>(events[event]));
+    }
+    value[k_cache_names[cache]] = cache_value;
+  }
+  return value;
+}
+
+} // namespace marianatrench
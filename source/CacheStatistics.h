@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <json/json.h>
+
+namespace marianatrench {
+
+/**
+ * Counters of the lookups in the caches and unique pointer factories of the
+ * analysis, enabled with `--collect-cache-statistics`.
+ *
+ * Counters are always compiled in. When disabled, recording an event costs a
+ * relaxed atomic load. When enabled, each thread increments its own counters
+ * without synchronization, and `snapshot` sums the counters of all threads.
+ */
+class CacheStatistics final {
+ public:
+  enum class Cache : std::size_t {
+    // `MethodContext` cache of virtual call models, private to an analysis.
+    MethodCallsiteModels = 0,
+    // Global `CallsiteModelCache`.
+    CallsiteModels,
+    // Joined virtual call models in the global `CallsiteModelCache`.
+    JoinedCallsiteModels,
+    Kinds,
+    Features,
+    Origins,
+    Transforms,
+    ExtraTraces,
+    OverrideSets,
+    AccessPaths,
+    Positions,
+    TypeEnvironments,
+  };
+  constexpr static std::size_t kNumberOfCaches =
+      static_cast<std::size_t>(Cache::TypeEnvironments) + 1;
+
+  enum class Event : std::size_t {
+    Lookup = 0,
+    Hit,
+    Insert,
+    // Concurrent insertion of the same key, where the value computed by one of
+    // the threads is discarded.
+    Contention,
+  };
+  constexpr static std::size_t kNumberOfEvents =
+      static_cast<std::size_t>(Event::Contention) + 1;
+
+  using Counters = std::array<
+      std::array<std::uint64_t, kNumberOfEvents>,
+      kNumberOfCaches>;
+
+  CacheStatistics() = delete;
+
+  static void enable();
+
+  static bool enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  static void lookup(Cache cache, bool hit) {
+    if (enabled()) {
+      increment(cache, Event::Lookup);
+      if (hit) {
+        increment(cache, Event::Hit);
+      }
+    }
+  }
+
+  static void insert(Cache cache) {
+    if (enabled()) {
+      increment(cache, Event::Insert);
+    }
+  }
+
+  static void contention(Cache cache) {
+    if (enabled()) {
+      increment(cache, Event::Contention);
+    }
+  }
+
+  /* Sum of the counters of all threads since the beginning of the process. */
+  static Counters snapshot();
+
+  /* Counters recorded between two snapshots. */
+  static Counters difference(const Counters& after, const Counters& before);
+
+  /* Counters of caches that were looked up, by cache name. */
+  static Json::Value to_json(const Counters& counters);
+
+ private:
+  static void increment(Cache cache, Event event);
+
+  static std::atomic<bool> enabled_;
+};
+
+} // namespace marianatrench
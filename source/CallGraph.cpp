@@ -6,13 +6,16 @@
  */
 
 #include <algorithm>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/functional/hash.hpp>
 #include <re2/re2.h>
 
-#include <sparta/WorkQueue.h>
-
 #include <GraphUtil.h>
 #include <IRInstruction.h>
 #include <Resolver.h>
@@ -25,6 +28,7 @@
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/WorkerPool.h>
 #include <mariana-trench/shim-generator/Shim.h>
 
 namespace marianatrench {
@@ -182,6 +186,60 @@ ParameterTypeOverrides anonymous_class_arguments(
   return parameters;
 }
 
+// Remove the overrides of parameters that the callee never reads, since they
+// cannot change the call graph of the callee. This avoids analyzing identical
+// variants of a method. Overrides are kept for virtual calls, since they also
+// apply to the overrides of the callee.
+ParameterTypeOverrides read_parameter_type_overrides(
+    const IRInstruction* instruction,
+    const DexMethod* callee,
+    const ParameterTypeOverrides& parameter_type_overrides) {
+  const auto* code = callee->get_code();
+  if (parameter_type_overrides.empty() || code == nullptr ||
+      !code->cfg_built() ||
+      (instruction->opcode() != OPCODE_INVOKE_STATIC &&
+       instruction->opcode() != OPCODE_INVOKE_DIRECT)) {
+    return parameter_type_overrides;
+  }
+
+  const auto& cfg = code->cfg();
+  std::unordered_set<Register> read_registers;
+  for (const auto* block : cfg.blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      for (auto source : entry.insn->srcs()) {
+        read_registers.insert(source);
+      }
+    }
+  }
+
+  ParameterTypeOverrides result;
+  // Parameters are loaded in order at the beginning of the entry block.
+  ParameterPosition position = 0;
+  for (const auto& entry : InstructionIterable(cfg.entry_block())) {
+    const auto* load_param = entry.insn;
+    if (!opcode::is_a_load_param(load_param->opcode())) {
+      break;
+    }
+    if (!is_static(callee) && position == 0) {
+      // Skip `this`, which is not overridden.
+      position++;
+      continue;
+    }
+    auto parameter = is_static(callee) ? position : position - 1;
+    auto override = parameter_type_overrides.find(parameter);
+    if (override != parameter_type_overrides.end() &&
+        read_registers.count(load_param->dest()) > 0) {
+      result.emplace(override->first, override->second);
+    }
+    position++;
+  }
+  if (position == 0) {
+    // The parameters are not loaded explicitly.
+    return parameter_type_overrides;
+  }
+  return result;
+}
+
 ArtificialCallees anonymous_class_artificial_callees(
     const Methods& method_factory,
     const IRInstruction* instruction,
@@ -228,7 +286,8 @@ ArtificialCallees artificial_callees_from_arguments(
     const DexMethod* callee,
     const ParameterTypeOverrides& parameter_type_overrides,
     std::unordered_map<std::string, TextualOrderIndex>&
-        sink_textual_order_index) {
+        sink_textual_order_index,
+    const std::string& feature = "via-anonymous-class-to-obscure") {
   ArtificialCallees callees;
 
   // For each anonymous class parameter, simulate calls to all its methods.
@@ -241,7 +300,7 @@ ArtificialCallees artificial_callees_from_arguments(
         instruction->src(parameter + (is_static(callee) ? 0 : 1)),
         sink_textual_order_index,
         /* features */
-        FeatureSet{feature_factory.get("via-anonymous-class-to-obscure")});
+        FeatureSet{feature_factory.get(feature)});
     callees.insert(
         callees.end(),
         std::make_move_iterator(artificial_callees_from_parameter.begin()),
@@ -286,14 +345,142 @@ const Method* get_callee_from_resolved_call(
   } else if (options.disable_parameter_type_overrides()) {
     callee = method_factory.get(dex_callee);
   } else {
-    // Analyze the callee with these particular types.
-    callee = method_factory.create(dex_callee, parameter_type_overrides);
-    method_mappings.create_mappings_for_method(callee);
+    auto read_overrides =
+        read_parameter_type_overrides(
+            instruction, dex_callee, parameter_type_overrides);
+    auto maximum_variants = options.maximum_parameter_type_overrides();
+    if (read_overrides.empty()) {
+      callee = method_factory.get(dex_callee);
+    } else if (maximum_variants) {
+      callee = method_factory.create_bounded(
+          dex_callee, read_overrides, *maximum_variants);
+      if (callee == nullptr) {
+        // Too many variants: call the method without overrides, and simulate
+        // calls to the methods of the anonymous classes as for external
+        // callees.
+        artificial_callees = artificial_callees_from_arguments(
+            method_factory,
+            feature_factory,
+            instruction,
+            dex_callee,
+            read_overrides,
+            sink_textual_order_index,
+            /* feature */ "via-parameter-type-overrides-limit");
+        callee = method_factory.get(dex_callee);
+      } else {
+        method_mappings.create_mappings_for_method(callee);
+      }
+    } else {
+      // Analyze the callee with these particular types.
+      callee = method_factory.create(dex_callee, std::move(read_overrides));
+      method_mappings.create_mappings_for_method(callee);
+    }
   }
   mt_assert(callee != nullptr);
   return callee;
 }
 
+/**
+ * Parts of the artificial callees of shims that do not depend on the call
+ * site, shared by all call sites of the shimmed methods. This is thread-safe.
+ */
+class ShimCache final {
+ private:
+  using FeaturesKey = std::pair<const Method*, const Feature*>;
+  using TargetKey = std::pair<const Method*, const DexType*>;
+  using MethodSpecKey = std::pair<const DexString*, const DexProto*>;
+  using ReflectionKey = std::pair<MethodSpecKey, const DexType*>;
+
+ public:
+  ShimCache() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ShimCache)
+
+  /* Features of the artificial callees of the given shimmed callee. */
+  FeatureSet features(
+      const FeatureFactory& feature_factory,
+      const Method* callee,
+      const Feature* MT_NULLABLE extra_feature) {
+    auto key = FeaturesKey(callee, extra_feature);
+    if (auto features = features_.get(key, /* default */ std::nullopt)) {
+      return *features;
+    }
+    auto features = FeatureSet{feature_factory.get_via_shim_feature(callee)};
+    if (extra_feature != nullptr) {
+      features.add(extra_feature);
+    }
+    features_.emplace(key, features);
+    return features;
+  }
+
+  /* Resolve the virtual shim target on the given receiver type. */
+  const Method* MT_NULLABLE resolve_target(
+      const Methods& method_factory,
+      const Method* method,
+      const DexType* receiver_type) {
+    auto key = TargetKey(method, receiver_type);
+    if (auto target = targets_.get(key, /* default */ std::nullopt)) {
+      return *target;
+    }
+    const auto* dex_runtime_method = resolve_method(
+        type_class(receiver_type),
+        method->dex_method()->get_name(),
+        method->get_proto(),
+        MethodSearch::Virtual);
+    const Method* target = nullptr;
+    if (dex_runtime_method != nullptr) {
+      target = method_factory.get(dex_runtime_method);
+    } else {
+      WARNING(
+          1,
+          "Could not resolve method for artificial call to: {}",
+          method->show());
+    }
+    targets_.emplace(key, target);
+    return target;
+  }
+
+  /* Resolve the reflection shim target on the given reflected type. */
+  const Method* MT_NULLABLE resolve_reflection(
+      const Methods& method_factory,
+      const DexMethodSpec& method_spec,
+      const DexType* reflection_type) {
+    auto key = ReflectionKey(
+        MethodSpecKey(method_spec.name, method_spec.proto), reflection_type);
+    if (auto target = reflections_.get(key, /* default */ std::nullopt)) {
+      return *target;
+    }
+    const auto* dex_reflection_method = resolve_method(
+        type_class(reflection_type),
+        method_spec.name,
+        method_spec.proto,
+        MethodSearch::Virtual);
+    const Method* target = nullptr;
+    if (dex_reflection_method != nullptr) {
+      target = method_factory.get(dex_reflection_method);
+    }
+    reflections_.emplace(key, target);
+    return target;
+  }
+
+ private:
+  ConcurrentMap<
+      FeaturesKey,
+      std::optional<FeatureSet>,
+      boost::hash<FeaturesKey>>
+      features_;
+  ConcurrentMap<
+      TargetKey,
+      std::optional<const Method*>,
+      boost::hash<TargetKey>>
+      targets_;
+  ConcurrentMap<
+      ReflectionKey,
+      std::optional<const Method*>,
+      boost::hash<ReflectionKey>>
+      reflections_;
+};
+
 void process_shim_target(
     const Method* caller,
     const Method* callee,
@@ -304,54 +491,40 @@ void process_shim_target(
     const Overrides& override_factory,
     const ClassHierarchies& class_hierarchies,
     const FeatureFactory& feature_factory,
+    ShimCache& shim_cache,
     std::unordered_map<std::string, TextualOrderIndex>&
         sink_textual_order_index,
     std::vector<ArtificialCallee>& artificial_callees,
-    const FeatureSet& extra_features) {
+    const Feature* MT_NULLABLE extra_feature) {
   const auto* method = shim_target.method();
   mt_assert(method != nullptr);
 
-  auto receiver_register = shim_target.receiver_register(instruction);
-  auto root_registers = shim_target.root_registers(instruction);
-
   auto call_index = update_index(sink_textual_order_index, method->signature());
-  auto features = FeatureSet{feature_factory.get_via_shim_feature(callee)}.join(
-      extra_features);
+  auto features = shim_cache.features(feature_factory, callee, extra_feature);
 
   if (method->is_static()) {
     artificial_callees.push_back(ArtificialCallee{
         /* call_target */ CallTarget::static_call(
             instruction, method, call_index),
-        /* root_registers */ root_registers,
-        /* features */ features,
+        /* root_registers */ shim_target.root_registers(instruction),
+        /* features */ std::move(features),
     });
     return;
   }
 
   const auto* receiver_type = method->get_class();
   // Try to refine the virtual call using the runtime type.
-  if (receiver_register) {
+  if (auto receiver_register = shim_target.receiver_register(instruction)) {
     auto register_type =
         types.register_type(caller, instruction, *receiver_register);
     receiver_type = register_type ? register_type : receiver_type;
   }
 
-  auto dex_runtime_method = resolve_method(
-      type_class(receiver_type),
-      method->dex_method()->get_name(),
-      method->get_proto(),
-      MethodSearch::Virtual);
-
-  if (!dex_runtime_method) {
-    WARNING(
-        1,
-        "Could not resolve method for artificial call to: {}",
-        method->show());
+  method = shim_cache.resolve_target(method_factory, method, receiver_type);
+  if (method == nullptr) {
     return;
   }
 
-  method = method_factory.get(dex_runtime_method);
-
   artificial_callees.push_back(ArtificialCallee{
       /* call_target */ CallTarget::virtual_call(
           instruction,
@@ -360,8 +533,8 @@ void process_shim_target(
           receiver_type,
           class_hierarchies,
           override_factory),
-      /* root_registers */ root_registers,
-      /* features */ features,
+      /* root_registers */ shim_target.root_registers(instruction),
+      /* features */ std::move(features),
   });
 }
 
@@ -374,7 +547,8 @@ void process_shim_reflection(
     const Types& types,
     const Overrides& override_factory,
     const ClassHierarchies& class_hierarchies,
-    const FeatureFactory& FeatureFactory,
+    const FeatureFactory& feature_factory,
+    ShimCache& shim_cache,
     std::unordered_map<std::string, TextualOrderIndex>&
         sink_textual_order_index,
     std::vector<ArtificialCallee>& artificial_callees) {
@@ -405,22 +579,17 @@ void process_shim_reflection(
     return;
   }
 
-  auto dex_reflection_method = resolve_method(
-      type_class(reflection_type),
-      method_spec.name,
-      method_spec.proto,
-      MethodSearch::Virtual);
-
-  if (!dex_reflection_method) {
+  const auto* reflection_method = shim_cache.resolve_reflection(
+      method_factory, method_spec, reflection_type);
+  if (reflection_method == nullptr) {
     WARNING(
         1,
         "Could not resolve method for artificial call to: {} in caller: {}",
-        show(dex_reflection_method),
+        shim_reflection,
         caller->show());
     return;
   }
 
-  const auto* reflection_method = method_factory.get(dex_reflection_method);
   auto root_registers =
       shim_reflection.root_registers(reflection_method, instruction);
   auto call_index =
@@ -436,7 +605,8 @@ void process_shim_reflection(
           override_factory),
       /* root_registers */ root_registers,
       /* features */
-      FeatureSet{FeatureFactory.get_via_shim_feature(callee)},
+      shim_cache.features(
+          feature_factory, callee, /* extra_feature */ nullptr),
   });
 }
 
@@ -451,6 +621,7 @@ void process_shim_lifecycle(
     const Overrides& override_factory,
     const ClassHierarchies& class_hierarchies,
     const FeatureFactory& feature_factory,
+    ShimCache& shim_cache,
     std::unordered_map<std::string, TextualOrderIndex>&
         sink_textual_order_index,
     std::vector<ArtificialCallee>& artificial_callees) {
@@ -503,6 +674,8 @@ void process_shim_lifecycle(
     return;
   }
 
+  auto features =
+      shim_cache.features(feature_factory, callee, /* extra_feature */ nullptr);
   for (const auto* lifecycle_method : target_lifecycle_methods) {
     auto root_registers =
         shim_lifecycle.root_registers(callee, lifecycle_method, instruction);
@@ -513,7 +686,7 @@ void process_shim_lifecycle(
         /* call_target */ CallTarget::direct_call(
             instruction, lifecycle_method, call_index, receiver_type),
         /* root_registers */ root_registers,
-        /* features */ FeatureSet{feature_factory.get_via_shim_feature(callee)},
+        /* features */ features,
     });
   }
 }
@@ -528,10 +701,14 @@ std::vector<ArtificialCallee> shim_artificial_callees(
     const Overrides& override_factory,
     const ClassHierarchies& class_hierarchies,
     const FeatureFactory& feature_factory,
+    ShimCache& shim_cache,
     const Shim& shim,
     std::unordered_map<std::string, TextualOrderIndex>&
         sink_textual_order_index) {
   std::vector<ArtificialCallee> artificial_callees;
+  artificial_callees.reserve(
+      shim.targets().size() + shim.reflections().size() +
+      shim.intent_routing_targets().size());
 
   for (const auto& shim_target : shim.targets()) {
     process_shim_target(
@@ -544,9 +721,10 @@ std::vector<ArtificialCallee> shim_artificial_callees(
         override_factory,
         class_hierarchies,
         feature_factory,
+        shim_cache,
         sink_textual_order_index,
         artificial_callees,
-        /* extra_features */ {});
+        /* extra_feature */ nullptr);
   }
 
   for (const auto& shim_reflection : shim.reflections()) {
@@ -560,6 +738,7 @@ std::vector<ArtificialCallee> shim_artificial_callees(
         override_factory,
         class_hierarchies,
         feature_factory,
+        shim_cache,
         sink_textual_order_index,
         artificial_callees);
   }
@@ -576,6 +755,7 @@ std::vector<ArtificialCallee> shim_artificial_callees(
         override_factory,
         class_hierarchies,
         feature_factory,
+        shim_cache,
         sink_textual_order_index,
         artificial_callees);
   }
@@ -591,10 +771,10 @@ std::vector<ArtificialCallee> shim_artificial_callees(
         override_factory,
         class_hierarchies,
         feature_factory,
+        shim_cache,
         sink_textual_order_index,
         artificial_callees,
-        /* extra_features */
-        FeatureSet{feature_factory.get_intent_routing_feature()});
+        /* extra_feature */ feature_factory.get_intent_routing_feature());
   }
 
   return artificial_callees;
@@ -626,6 +806,7 @@ InstructionCallGraphInformation process_instruction(
     const LifecycleMethods& lifecycle_methods,
     const Shims& shims,
     const FeatureFactory& feature_factory,
+    ShimCache& shim_cache,
     ConcurrentSet<const Method*>& worklist,
     ConcurrentSet<const Method*>& processed,
     Methods& method_factory,
@@ -706,6 +887,7 @@ InstructionCallGraphInformation process_instruction(
         override_factory,
         class_hierarchies,
         feature_factory,
+        shim_cache,
         *shim,
         sink_textual_order_index);
     instruction_information.artificial_callees = std::move(artificial_callees);
@@ -767,6 +949,45 @@ InstructionCallGraphInformation process_instruction(
   return instruction_information;
 }
 
+template <typename Value>
+using MethodInstructionMaps =
+    std::vector<std::pair<const Method*, InstructionMap<Value>>>;
+
+/**
+ * Call graph information computed by a single worker thread.
+ *
+ * Workers do not write into the shared maps directly, which would require
+ * locking for every processed method. Their results are merged once all
+ * workers are done instead.
+ */
+struct WorkerCallGraph {
+  MethodInstructionMaps<CallTarget> resolved_base_callees;
+  MethodInstructionMaps<FieldTarget> resolved_fields;
+  MethodInstructionMaps<ArtificialCallees> artificial_callees;
+  MethodInstructionMaps<TextualOrderIndex> indexed_returns;
+  MethodInstructionMaps<TextualOrderIndex> indexed_array_allocations;
+};
+
+template <typename Value>
+void add_instruction_map(
+    MethodInstructionMaps<Value>& maps,
+    const Method* method,
+    std::unordered_map<const IRInstruction*, Value> map) {
+  if (!map.empty()) {
+    maps.emplace_back(method, InstructionMap<Value>(std::move(map)));
+  }
+}
+
+template <typename Value>
+void merge_instruction_maps(
+    MethodInstructionMaps<Value>& maps,
+    ConcurrentMap<const Method*, InstructionMap<Value>>& result) {
+  for (auto& [method, map] : maps) {
+    result.insert_or_assign(std::make_pair(method, std::move(map)));
+  }
+  maps.clear();
+}
+
 } // namespace
 
 CallTarget::CallTarget(
@@ -774,13 +995,15 @@ CallTarget::CallTarget(
     const Method* MT_NULLABLE resolved_base_callee,
     TextualOrderIndex call_index,
     const DexType* MT_NULLABLE receiver_type,
-    const std::unordered_set<const Method*>* MT_NULLABLE overrides,
+    const Overrides::IntervalIndex* MT_NULLABLE overrides,
+    std::pair<std::size_t, std::size_t> overrides_range,
     const std::unordered_set<const DexType*>* MT_NULLABLE receiver_extends)
     : instruction_(instruction),
       resolved_base_callee_(resolved_base_callee),
       call_index_(call_index),
       receiver_type_(receiver_type),
       overrides_(overrides),
+      overrides_range_(overrides_range),
       receiver_extends_(receiver_extends) {}
 
 CallTarget CallTarget::static_call(
@@ -805,6 +1028,7 @@ CallTarget CallTarget::direct_call(
       /* call_index */ call_index,
       /* receiver_type */ receiver_type,
       /* overrides */ nullptr,
+      /* overrides_range */ {0, 0},
       /* receiver_extends */ nullptr);
 }
 
@@ -816,12 +1040,13 @@ CallTarget CallTarget::virtual_call(
     const ClassHierarchies& class_hierarchies,
     const Overrides& override_factory) {
   // All overrides are potential callees.
-  const std::unordered_set<const Method*>* overrides = nullptr;
+  const Overrides::IntervalIndex* overrides = nullptr;
   if (resolved_base_callee != nullptr) {
-    overrides = &override_factory.get(resolved_base_callee);
+    overrides = &override_factory.get_interval_index(resolved_base_callee);
   } else {
-    overrides = &override_factory.empty_method_set();
+    overrides = &override_factory.empty_interval_index();
   }
+  auto overrides_range = std::make_pair(std::size_t(0), overrides->size());
 
   // If the receiver type does not define the method, `resolved_base_callee`
   // will reference a method on a parent class. Taking all overrides of
@@ -839,9 +1064,18 @@ CallTarget CallTarget::virtual_call(
   // A virtual call to `B::f` has a resolved base callee of `A::f`. Overrides
   // of `A::f` includes `D::f`, but `D::f` cannot be called since `D` does not
   // extend `B`.
+  //
+  // When the receiver type is a class, these are exactly the overrides within
+  // its class interval, which is a range query on the sorted index. Otherwise,
+  // we need to filter on the classes extending the receiver type.
   const std::unordered_set<const DexType*>* receiver_extends = nullptr;
   if (receiver_type != nullptr && receiver_type != type::java_lang_Object()) {
-    receiver_extends = &class_hierarchies.extends(receiver_type);
+    if (auto subclasses_range =
+            override_factory.subclasses_range(*overrides, receiver_type)) {
+      overrides_range = *subclasses_range;
+    } else {
+      receiver_extends = &class_hierarchies.extends(receiver_type);
+    }
   }
 
   return CallTarget(
@@ -850,6 +1084,7 @@ CallTarget CallTarget::virtual_call(
       call_index,
       receiver_type,
       overrides,
+      overrides_range,
       receiver_extends);
 }
 
@@ -890,11 +1125,14 @@ CallTarget::OverridesRange CallTarget::overrides() const {
   mt_assert(resolved());
   mt_assert(is_virtual());
 
+  auto begin = boost::make_transform_iterator(
+      overrides_->cbegin() + overrides_range_.first, ExposeOverride());
+  auto end = boost::make_transform_iterator(
+      overrides_->cbegin() + overrides_range_.second, ExposeOverride());
+  auto filter = FilterOverrides{receiver_extends_};
   return boost::make_iterator_range(
-      boost::make_filter_iterator(
-          FilterOverrides{receiver_extends_}, overrides_->cbegin()),
-      boost::make_filter_iterator(
-          FilterOverrides{receiver_extends_}, overrides_->cend()));
+      boost::make_filter_iterator(filter, begin, end),
+      boost::make_filter_iterator(filter, end, end));
 }
 
 bool CallTarget::operator==(const CallTarget& other) const {
@@ -903,6 +1141,7 @@ bool CallTarget::operator==(const CallTarget& other) const {
       call_index_ == other.call_index_ &&
       receiver_type_ == other.receiver_type_ &&
       overrides_ == other.overrides_ &&
+      overrides_range_ == other.overrides_range_ &&
       receiver_extends_ == other.receiver_extends_;
 }
 
@@ -969,9 +1208,13 @@ CallGraph::CallGraph(
   std::atomic<std::size_t> method_iteration(0);
   std::size_t number_methods = 0;
 
+  auto number_of_threads = sparta::parallel::default_num_threads();
+  std::vector<WorkerCallGraph> worker_call_graphs(number_of_threads);
+  ShimCache shim_cache;
+
   while (worklist.size() > 0) {
-    auto queue = sparta::work_queue<const Method*>(
-        [&](const Method* caller) {
+    auto queue = work_queue<const Method*>(
+        [&](WorkerState<const Method*>* worker_state, const Method* caller) {
           method_iteration++;
           if (method_iteration % 10000 == 0) {
             LOG_IF_INTERACTIVE(
@@ -1032,6 +1275,7 @@ CallGraph::CallGraph(
                   lifecycle_methods,
                   shims,
                   feature_factory,
+                  shim_cache,
                   worklist,
                   processed,
                   method_factory,
@@ -1041,7 +1285,8 @@ CallGraph::CallGraph(
                   sink_textual_order_index);
               if (instruction_information.artificial_callees.size() > 0) {
                 artificial_callees.emplace(
-                    instruction, instruction_information.artificial_callees);
+                    instruction,
+                    std::move(instruction_information.artificial_callees));
               }
               if (instruction_information.callee) {
                 callees.emplace(instruction, *(instruction_information.callee));
@@ -1052,28 +1297,30 @@ CallGraph::CallGraph(
             }
           }
 
-          if (!callees.empty()) {
-            resolved_base_callees_.insert_or_assign(
-                std::make_pair(caller, std::move(callees)));
-          }
-          if (!artificial_callees.empty()) {
-            artificial_callees_.insert_or_assign(
-                std::make_pair(caller, std::move(artificial_callees)));
-          }
-          if (!field_accesses.empty()) {
-            resolved_fields_.insert_or_assign(
-                std::make_pair(caller, std::move(field_accesses)));
-          }
-          if (!indexed_array_allocations.empty()) {
-            indexed_array_allocations_.insert_or_assign(
-                std::make_pair(caller, std::move(indexed_array_allocations)));
-          }
-          if (!indexed_returns.empty()) {
-            indexed_returns_.insert_or_assign(
-                std::make_pair(caller, std::move(indexed_returns)));
-          }
+          auto& worker_call_graph =
+              worker_call_graphs[worker_state->worker_id()];
+          add_instruction_map(
+              worker_call_graph.resolved_base_callees,
+              caller,
+              std::move(callees));
+          add_instruction_map(
+              worker_call_graph.artificial_callees,
+              caller,
+              std::move(artificial_callees));
+          add_instruction_map(
+              worker_call_graph.resolved_fields,
+              caller,
+              std::move(field_accesses));
+          add_instruction_map(
+              worker_call_graph.indexed_array_allocations,
+              caller,
+              std::move(indexed_array_allocations));
+          add_instruction_map(
+              worker_call_graph.indexed_returns,
+              caller,
+              std::move(indexed_returns));
         },
-        sparta::parallel::default_num_threads());
+        number_of_threads);
     for (const auto* method : worklist) {
       queue.add_item(method);
       processed.insert(method);
@@ -1081,6 +1328,20 @@ CallGraph::CallGraph(
     worklist.clear();
     number_methods = method_factory.size();
     queue.run_all();
+
+    for (auto& worker_call_graph : worker_call_graphs) {
+      merge_instruction_maps(
+          worker_call_graph.resolved_base_callees, resolved_base_callees_);
+      merge_instruction_maps(
+          worker_call_graph.artificial_callees, artificial_callees_);
+      merge_instruction_maps(
+          worker_call_graph.resolved_fields, resolved_fields_);
+      merge_instruction_maps(
+          worker_call_graph.indexed_array_allocations,
+          indexed_array_allocations_);
+      merge_instruction_maps(
+          worker_call_graph.indexed_returns, indexed_returns_);
+    }
   }
 
   if (options.dump_call_graph()) {
@@ -1090,18 +1351,23 @@ CallGraph::CallGraph(
 }
 
 std::vector<CallTarget> CallGraph::callees(const Method* caller) const {
+  auto call_targets = this->call_targets(caller);
+  return std::vector<CallTarget>(call_targets.begin(), call_targets.end());
+}
+
+CallGraph::CallTargetsRange CallGraph::call_targets(
+    const Method* caller) const {
   // Note that `find` is not thread-safe, but this is fine because
   // `resolved_base_callees_` is read-only after the constructor completed.
   auto callees = resolved_base_callees_.find(caller);
-  if (callees == resolved_base_callees_.end()) {
-    return {};
-  }
-
-  std::vector<CallTarget> call_targets;
-  for (auto [instruction, call_target] : callees->second) {
-    call_targets.push_back(call_target);
-  }
-  return call_targets;
+  const auto& callees_map = callees == resolved_base_callees_.end()
+      ? empty_callees_map_
+      : callees->second;
+  auto begin =
+      boost::make_transform_iterator(callees_map.begin(), ExposeCallTarget());
+  auto end =
+      boost::make_transform_iterator(callees_map.end(), ExposeCallTarget());
+  return boost::make_iterator_range(begin, end);
 }
 
 CallTarget CallGraph::callee(
@@ -1122,16 +1388,16 @@ CallTarget CallGraph::callee(
     return empty_resolved_callee;
   }
 
-  auto callee = callees->second.find(instruction);
-  if (callee == callees->second.end()) {
+  const auto* callee = callees->second.find(instruction);
+  if (callee == nullptr) {
     return empty_resolved_callee;
   }
 
-  return callee->second;
+  return *callee;
 }
 
-const std::unordered_map<const IRInstruction*, ArtificialCallees>&
-CallGraph::artificial_callees(const Method* caller) const {
+const InstructionMap<ArtificialCallees>& CallGraph::artificial_callees(
+    const Method* caller) const {
   // Note that `find` is not thread-safe, but this is fine because
   // `artificial_callees_` is read-only after the constructor completed.
   auto artificial_callees_map = artificial_callees_.find(caller);
@@ -1146,11 +1412,11 @@ const ArtificialCallees& CallGraph::artificial_callees(
     const Method* caller,
     const IRInstruction* instruction) const {
   const auto& artificial_callees_map = this->artificial_callees(caller);
-  auto artificial_callees = artificial_callees_map.find(instruction);
-  if (artificial_callees == artificial_callees_map.end()) {
+  const auto* artificial_callees = artificial_callees_map.find(instruction);
+  if (artificial_callees == nullptr) {
     return empty_artificial_callees_;
   } else {
-    return artificial_callees->second;
+    return *artificial_callees;
   }
 }
 
@@ -1164,12 +1430,12 @@ const std::optional<FieldTarget> CallGraph::resolved_field_access(
     return std::nullopt;
   }
 
-  auto field = fields->second.find(instruction);
-  if (field == fields->second.end()) {
+  const auto* field = fields->second.find(instruction);
+  if (field == nullptr) {
     return std::nullopt;
   }
 
-  return field->second;
+  return *field;
 }
 
 const std::vector<FieldTarget> CallGraph::resolved_field_accesses(
@@ -1196,11 +1462,11 @@ TextualOrderIndex CallGraph::return_index(
   auto returns = indexed_returns_.find(caller);
   mt_assert(returns != indexed_returns_.end());
 
-  auto index = returns->second.find(instruction);
-  if (index == returns->second.end()) {
+  const auto* index = returns->second.find(instruction);
+  if (index == nullptr) {
     return 0;
   }
-  return index->second;
+  return *index;
 }
 
 const std::vector<TextualOrderIndex> CallGraph::return_indices(
@@ -1223,11 +1489,11 @@ TextualOrderIndex CallGraph::array_allocation_index(
   auto array_allocations = indexed_array_allocations_.find(caller);
   mt_assert(array_allocations != indexed_returns_.end());
 
-  auto index = array_allocations->second.find(instruction);
-  if (index == array_allocations->second.end()) {
+  const auto* index = array_allocations->second.find(instruction);
+  if (index == nullptr) {
     return 0;
   }
-  return index->second;
+  return *index;
 }
 
 const std::vector<TextualOrderIndex> CallGraph::array_allocation_indices(
@@ -1244,7 +1510,7 @@ const std::vector<TextualOrderIndex> CallGraph::array_allocation_indices(
   return array_allocation_indices;
 }
 
-bool CallGraph::has_callees(const Method* caller) {
+bool CallGraph::has_callees(const Method* caller) const {
   // Note that `find` is not thread-safe, but this is fine because
   // `resolved_base_callees_` and `artificial_callees_` are read-only
   // after the constructor completed.
@@ -1262,61 +1528,103 @@ bool CallGraph::has_callees(const Method* caller) {
   return false;
 }
 
-Json::Value CallGraph::to_json(const Method* method, bool with_overrides)
-    const {
-  auto method_value = Json::Value(Json::objectValue);
+CallGraph::JsonCallees CallGraph::json_callees(
+    const Method* method,
+    bool with_overrides) const {
+  JsonCallees json_callees;
 
   auto resolved_callee = resolved_base_callees_.find(method);
   if (resolved_callee != resolved_base_callees_.end()) {
-    std::unordered_set<const Method*> static_callees;
-    std::unordered_set<const Method*> virtual_callees;
     for (const auto& [instruction, call_target] : resolved_callee->second) {
       if (!call_target.resolved()) {
         continue;
       } else if (call_target.is_virtual()) {
-        virtual_callees.insert(call_target.resolved_base_callee());
+        json_callees.virtual_callees.insert(call_target.resolved_base_callee());
         if (with_overrides) {
           for (const auto* override : call_target.overrides()) {
-            virtual_callees.insert(override);
+            json_callees.virtual_callees.insert(override);
           }
         }
       } else {
-        static_callees.insert(call_target.resolved_base_callee());
+        json_callees.static_callees.insert(call_target.resolved_base_callee());
       }
     }
-
-    if (!static_callees.empty()) {
-      auto static_callees_value = Json::Value(Json::arrayValue);
-      for (const auto* callee : static_callees) {
-        static_callees_value.append(Json::Value(show(callee)));
-      }
-      method_value["static"] = static_callees_value;
-    }
-
-    if (!virtual_callees.empty()) {
-      auto virtual_callees_value = Json::Value(Json::arrayValue);
-      for (const auto* callee : virtual_callees) {
-        virtual_callees_value.append(Json::Value(show(callee)));
-      }
-      method_value["virtual"] = virtual_callees_value;
-    }
   }
 
   auto instruction_artificial_callees = artificial_callees_.find(method);
   if (instruction_artificial_callees != artificial_callees_.end()) {
-    std::unordered_set<const Method*> callees;
+    auto& callees = json_callees.artificial_callees.emplace();
     for (const auto& [instruction, artificial_callees] :
          instruction_artificial_callees->second) {
       for (const auto& artificial_callee : artificial_callees) {
         callees.insert(artificial_callee.call_target.resolved_base_callee());
       }
     }
+  }
+
+  return json_callees;
+}
 
+std::size_t CallGraph::memory_usage() const {
+  std::size_t bytes = 0;
+  auto add = [&bytes](const auto& map) {
+    using Entry = typename std::decay_t<decltype(map)>::value_type;
+    bytes += memory_usage::nodes<Entry>(map.size());
+    for (const auto& [method, instruction_map] : map) {
+      bytes += instruction_map.memory_usage();
+    }
+  };
+  add(resolved_base_callees_);
+  add(resolved_fields_);
+  add(artificial_callees_);
+  add(indexed_returns_);
+  add(indexed_array_allocations_);
+  for (const auto& [method, instruction_map] : artificial_callees_) {
+    for (const auto& [instruction, callees] : instruction_map) {
+      bytes += memory_usage::contiguous(callees);
+    }
+  }
+  return bytes;
+}
+
+std::vector<const Method*> CallGraph::methods_with_callees() const {
+  std::vector<const Method*> methods;
+  methods.reserve(resolved_base_callees_.size());
+  for (const auto& [method, _callees] : resolved_base_callees_) {
+    methods.push_back(method);
+  }
+
+  // Add methods that only have artificial callees
+  for (const auto& [method, _callees] : artificial_callees_) {
+    if (resolved_base_callees_.find(method) == resolved_base_callees_.end()) {
+      methods.push_back(method);
+    }
+  }
+
+  return methods;
+}
+
+Json::Value CallGraph::to_json(const Method* method, bool with_overrides)
+    const {
+  auto method_value = Json::Value(Json::objectValue);
+  auto callees_to_json = [](const std::unordered_set<const Method*>& callees) {
     auto callees_value = Json::Value(Json::arrayValue);
     for (const auto* callee : callees) {
       callees_value.append(Json::Value(show(callee)));
     }
-    method_value["artificial"] = callees_value;
+    return callees_value;
+  };
+
+  auto json_callees = this->json_callees(method, with_overrides);
+  if (!json_callees.static_callees.empty()) {
+    method_value["static"] = callees_to_json(json_callees.static_callees);
+  }
+  if (!json_callees.virtual_callees.empty()) {
+    method_value["virtual"] = callees_to_json(json_callees.virtual_callees);
+  }
+  if (json_callees.artificial_callees) {
+    method_value["artificial"] =
+        callees_to_json(*json_callees.artificial_callees);
   }
 
   JsonValidation::validate_object(method_value);
@@ -1326,17 +1634,9 @@ Json::Value CallGraph::to_json(const Method* method, bool with_overrides)
 
 Json::Value CallGraph::to_json(bool with_overrides) const {
   auto value = Json::Value(Json::objectValue);
-  for (const auto& [method, _callees] : resolved_base_callees_) {
+  for (const auto* method : methods_with_callees()) {
     value[method->show()] = to_json(method, with_overrides);
   }
-
-  // Add methods that only have artificial callees
-  for (const auto& [method, _callees] : artificial_callees_) {
-    if (resolved_base_callees_.find(method) == resolved_base_callees_.end()) {
-      value[method->show()] = to_json(method, with_overrides);
-    }
-  }
-
   return value;
 }
 
@@ -1346,34 +1646,59 @@ void CallGraph::dump_call_graph(
     const std::size_t batch_size) const {
   LOG(1, "Writing call graph to `{}`", output_directory.native());
 
-  // Collect all methods in the callgraph
-  std::vector<const Method*> methods;
-  methods.reserve(resolved_base_callees_.size());
-  for (const auto& [method, _callees] : resolved_base_callees_) {
-    methods.push_back(method);
-  }
+  auto methods = methods_with_callees();
 
-  // Add methods that only have artificial callees
-  for (const auto& [method, _callees] : artificial_callees_) {
-    if (resolved_base_callees_.find(method) == resolved_base_callees_.end()) {
-      methods.push_back(method);
+  // Lines are written directly, in the same format as `to_json`, to avoid
+  // building a `Json::Value` for each method.
+  auto write_callees = [](std::ostream& output,
+                          const char* field,
+                          const std::unordered_set<const Method*>& callees,
+                          bool& first_field) {
+    if (!first_field) {
+      output << ",";
     }
-  }
-  std::size_t total_elements = methods.size();
+    first_field = false;
+    output << "\"" << field << "\":[";
+    bool first_callee = true;
+    for (const auto* callee : callees) {
+      if (!first_callee) {
+        output << ",";
+      }
+      first_callee = false;
+      JsonValidation::write_json_string(output, callee->show());
+    }
+    output << "]";
+  };
 
-  auto get_json_line = [&](std::size_t i) -> Json::Value {
-    auto value = Json::Value(Json::objectValue);
+  auto write_json_line = [&](std::size_t i, std::ostream& output) {
     const auto* method = methods.at(i);
-    value[method->show()] = to_json(method, with_overrides);
-    return value;
+    auto json_callees = this->json_callees(method, with_overrides);
+
+    output << "{";
+    JsonValidation::write_json_string(output, method->show());
+    output << ":{";
+    bool first_field = true;
+    if (json_callees.artificial_callees) {
+      write_callees(
+          output, "artificial", *json_callees.artificial_callees, first_field);
+    }
+    if (!json_callees.static_callees.empty()) {
+      write_callees(
+          output, "static", json_callees.static_callees, first_field);
+    }
+    if (!json_callees.virtual_callees.empty()) {
+      write_callees(
+          output, "virtual", json_callees.virtual_callees, first_field);
+    }
+    output << "}}";
   };
 
-  JsonValidation::write_sharded_json_files(
+  JsonValidation::write_sharded_json_lines(
       output_directory,
       batch_size,
-      total_elements,
+      methods.size(),
       "call-graph@",
-      get_json_line);
+      write_json_line);
 }
 
 } // namespace marianatrench
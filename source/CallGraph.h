@@ -7,11 +7,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
 #include <boost/range/iterator_range.hpp>
 #include <json/json.h>
 
@@ -27,6 +31,7 @@
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Issue.h>
 #include <mariana-trench/LifecycleMethods.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Overrides.h>
@@ -47,10 +52,19 @@ class CallTarget final {
     const std::unordered_set<const DexType*>* MT_NULLABLE extends;
   };
 
+  struct ExposeOverride {
+    const Method* operator()(
+        const Overrides::IntervalIndex::value_type& entry) const {
+      return entry.second;
+    }
+  };
+
  public:
   using OverridesRange = boost::iterator_range<boost::filter_iterator<
       FilterOverrides,
-      std::unordered_set<const Method*>::const_iterator>>;
+      boost::transform_iterator<
+          ExposeOverride,
+          Overrides::IntervalIndex::const_iterator>>>;
 
  public:
   /**
@@ -153,7 +167,8 @@ class CallTarget final {
       const Method* MT_NULLABLE resolved_base_callee,
       TextualOrderIndex call_index,
       const DexType* MT_NULLABLE receiver_type,
-      const std::unordered_set<const Method*>* MT_NULLABLE overrides,
+      const Overrides::IntervalIndex* MT_NULLABLE overrides,
+      std::pair<std::size_t, std::size_t> overrides_range,
       const std::unordered_set<const DexType*>* MT_NULLABLE receiver_extends);
 
  private:
@@ -161,7 +176,10 @@ class CallTarget final {
   const Method* MT_NULLABLE resolved_base_callee_;
   TextualOrderIndex call_index_;
   const DexType* MT_NULLABLE receiver_type_;
-  const std::unordered_set<const Method*>* MT_NULLABLE overrides_;
+  const Overrides::IntervalIndex* MT_NULLABLE overrides_;
+  // Range of `overrides_` that could be called.
+  std::pair<std::size_t, std::size_t> overrides_range_;
+  // If set, only overrides in these classes could be called.
   const std::unordered_set<const DexType*>* MT_NULLABLE receiver_extends_;
 };
 
@@ -176,6 +194,7 @@ struct std::hash<marianatrench::CallTarget> {
     boost::hash_combine(seed, call_target.call_index_);
     boost::hash_combine(seed, call_target.receiver_type_);
     boost::hash_combine(seed, call_target.overrides_);
+    boost::hash_combine(seed, call_target.overrides_range_);
     boost::hash_combine(seed, call_target.receiver_extends_);
     return seed;
   }
@@ -218,7 +237,91 @@ struct FieldTarget {
   friend std::ostream& operator<<(std::ostream& out, const FieldTarget& callee);
 };
 
+/**
+ * A read-only mapping from instructions to values, stored contiguously and
+ * sorted by instruction.
+ *
+ * The call graph information of a method never changes after construction, so
+ * this is used instead of a node-based hash map to reduce memory usage.
+ */
+template <typename Value>
+class InstructionMap final {
+ public:
+  using Entry = std::pair<const IRInstruction*, Value>;
+  using const_iterator = typename std::vector<Entry>::const_iterator;
+
+ public:
+  InstructionMap() = default;
+
+  explicit InstructionMap(std::unordered_map<const IRInstruction*, Value> map) {
+    entries_.reserve(map.size());
+    for (auto& [instruction, value] : map) {
+      entries_.emplace_back(instruction, std::move(value));
+    }
+    std::sort(
+        entries_.begin(),
+        entries_.end(),
+        [](const Entry& left, const Entry& right) {
+          return std::less<const IRInstruction*>()(left.first, right.first);
+        });
+  }
+
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(InstructionMap)
+
+  /* Return the value for the given instruction, or nullptr. */
+  const Value* MT_NULLABLE find(const IRInstruction* instruction) const {
+    auto found = std::lower_bound(
+        entries_.begin(),
+        entries_.end(),
+        instruction,
+        [](const Entry& entry, const IRInstruction* instruction) {
+          return std::less<const IRInstruction*>()(entry.first, instruction);
+        });
+    if (found == entries_.end() || found->first != instruction) {
+      return nullptr;
+    }
+    return &found->second;
+  }
+
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  /* Approximate memory used by the entries, in bytes. */
+  std::size_t memory_usage() const {
+    return memory_usage::contiguous(entries_);
+  }
+
+  const_iterator begin() const {
+    return entries_.cbegin();
+  }
+
+  const_iterator end() const {
+    return entries_.cend();
+  }
+
+ private:
+  std::vector<Entry> entries_;
+};
+
 class CallGraph final {
+ private:
+  struct ExposeCallTarget {
+    const CallTarget& operator()(
+        const InstructionMap<CallTarget>::Entry& entry) const {
+      return entry.second;
+    }
+  };
+
+ public:
+  using CallTargetsRange = boost::iterator_range<boost::transform_iterator<
+      ExposeCallTarget,
+      InstructionMap<CallTarget>::const_iterator>>;
+
  public:
   explicit CallGraph(
       const Options& options,
@@ -237,13 +340,32 @@ class CallGraph final {
   /* Return all call targets for the given method. */
   std::vector<CallTarget> callees(const Method* caller) const;
 
+  /* Iterate over the call targets of the given method, without copying them. */
+  CallTargetsRange call_targets(const Method* caller) const;
+
+  /**
+   * Call `visitor(const CallTarget&)` on each call target of the given method,
+   * followed by the call targets of its artificial callees.
+   */
+  template <typename Visitor>
+  void visit_call_targets(const Method* caller, Visitor&& visitor) const {
+    for (const auto& call_target : call_targets(caller)) {
+      visitor(call_target);
+    }
+    for (const auto& [_instruction, callees] : artificial_callees(caller)) {
+      for (const auto& artificial_callee : callees) {
+        visitor(artificial_callee.call_target);
+      }
+    }
+  }
+
   /* Return the call target for the given method and instruction. */
   CallTarget callee(const Method* caller, const IRInstruction* instruction)
       const;
 
   /* Return a mapping from invoke instruction to artificial callees. */
-  const std::unordered_map<const IRInstruction*, ArtificialCallees>&
-  artificial_callees(const Method* caller) const;
+  const InstructionMap<ArtificialCallees>& artificial_callees(
+      const Method* caller) const;
 
   /* Return the artificial callees for an invoke instruction. */
   const ArtificialCallees& artificial_callees(
@@ -281,44 +403,49 @@ class CallGraph final {
 
   /* Returns whether the caller has any callees without constructing the
      intermediate structures. */
-  bool has_callees(const Method* caller);
+  bool has_callees(const Method* caller) const;
 
   Json::Value to_json(const Method* method, bool with_overrides = true) const;
   Json::Value to_json(bool with_overrides = true) const;
 
+  /* Approximate memory used, in bytes. This is not thread-safe. */
+  std::size_t memory_usage() const;
+
   void dump_call_graph(
       const std::filesystem::path& output_directory,
       bool with_overrides = true,
       const std::size_t batch_size =
           JsonValidation::k_default_shard_limit) const;
 
+ private:
+  /* Callees of a method, as exported in json. */
+  struct JsonCallees {
+    std::unordered_set<const Method*> static_callees;
+    std::unordered_set<const Method*> virtual_callees;
+    std::optional<std::unordered_set<const Method*>> artificial_callees;
+  };
+
+  JsonCallees json_callees(const Method* method, bool with_overrides) const;
+
+  /* Collect all methods with callees, in an unspecified order. */
+  std::vector<const Method*> methods_with_callees() const;
+
  private:
   const Types& types_;
   const ClassHierarchies& class_hierarchies_;
   const Overrides& overrides_;
 
-  ConcurrentMap<
-      const Method*,
-      std::unordered_map<const IRInstruction*, CallTarget>>
+  ConcurrentMap<const Method*, InstructionMap<CallTarget>>
       resolved_base_callees_;
-  ConcurrentMap<
-      const Method*,
-      std::unordered_map<const IRInstruction*, FieldTarget>>
-      resolved_fields_;
-  ConcurrentMap<
-      const Method*,
-      std::unordered_map<const IRInstruction*, ArtificialCallees>>
+  ConcurrentMap<const Method*, InstructionMap<FieldTarget>> resolved_fields_;
+  ConcurrentMap<const Method*, InstructionMap<ArtificialCallees>>
       artificial_callees_;
-  std::unordered_map<const IRInstruction*, ArtificialCallees>
-      empty_artificial_callees_map_;
+  InstructionMap<CallTarget> empty_callees_map_;
+  InstructionMap<ArtificialCallees> empty_artificial_callees_map_;
   ArtificialCallees empty_artificial_callees_;
-  ConcurrentMap<
-      const Method*,
-      std::unordered_map<const IRInstruction*, TextualOrderIndex>>
+  ConcurrentMap<const Method*, InstructionMap<TextualOrderIndex>>
       indexed_returns_;
-  ConcurrentMap<
-      const Method*,
-      std::unordered_map<const IRInstruction*, TextualOrderIndex>>
+  ConcurrentMap<const Method*, InstructionMap<TextualOrderIndex>>
       indexed_array_allocations_;
 };
 
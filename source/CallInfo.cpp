@@ -74,6 +74,24 @@ Json::Value CallInfo::to_json() const {
   return result;
 }
 
+void CallInfo::write_json_members(JsonWriter& writer) const {
+  writer.key("call_info");
+  writer.begin_object();
+  writer.key("call_kind").value(call_kind().to_trace_string());
+  if (callee_port_ != nullptr && !callee_port_->root().is_leaf()) {
+    writer.key("port").value(callee_port_->to_json());
+  }
+  if (call_position_ != nullptr) {
+    writer.key("position");
+    call_position_->write_json(writer);
+  }
+  const auto* callee = this->callee();
+  if (callee != nullptr) {
+    writer.key("resolves_to").value(callee->to_json());
+  }
+  writer.end_object();
+}
+
 bool operator==(const CallInfo& self, const CallInfo& other) {
   return self.method_call_kind_ == other.method_call_kind_ &&
       self.callee_port_ == other.callee_port_ &&
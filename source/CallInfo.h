@@ -8,6 +8,7 @@
 #pragma once
 
 #include <mariana-trench/CallKind.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/OriginSet.h>
 #include <mariana-trench/PointerIntPair.h>
@@ -88,6 +89,8 @@ class CallInfo final {
       Context& context) const;
 
   Json::Value to_json() const;
+  /* Write the members of `to_json()` in the current object. */
+  void write_json_members(JsonWriter& writer) const;
 
   friend bool operator==(const CallInfo& self, const CallInfo& other);
 
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/CallSitePropagation.h>
+#include <mariana-trench/Context.h>
+#include <mariana-trench/FeatureFactory.h>
+
+namespace marianatrench {
+
+CallSitePropagation::CallSitePropagation(
+    const Method* MT_NULLABLE callee,
+    const Position* call_position,
+    int maximum_source_sink_distance,
+    const FeatureMayAlwaysSet& extra_features,
+    Context& context,
+    const std::vector<const DexType * MT_NULLABLE>& source_register_types,
+    const std::vector<std::optional<std::string>>& source_constant_arguments,
+    const CallClassIntervalContext& class_interval_context,
+    const ClassIntervals::Interval& caller_class_interval)
+    : callee_(callee),
+      call_position_(call_position),
+      maximum_source_sink_distance_(maximum_source_sink_distance),
+      extra_features_(extra_features),
+      context_(context),
+      source_register_types_(source_register_types),
+      source_constant_arguments_(source_constant_arguments),
+      class_interval_context_(class_interval_context),
+      caller_class_interval_(caller_class_interval),
+      via_type_of_features_(source_register_types.size(), nullptr),
+      via_value_of_features_(source_constant_arguments.size(), nullptr) {}
+
+const Feature* MT_NULLABLE
+CallSitePropagation::via_type_of_feature(ParameterPosition position) const {
+  if (position >= source_register_types_.size()) {
+    return nullptr;
+  }
+  auto& feature = via_type_of_features_[position];
+  if (feature == nullptr) {
+    feature = context_.feature_factory->get_via_type_of_feature(
+        source_register_types_[position]);
+  }
+  return feature;
+}
+
+const Feature* MT_NULLABLE
+CallSitePropagation::via_value_of_feature(ParameterPosition position) const {
+  if (position >= source_constant_arguments_.size()) {
+    return nullptr;
+  }
+  auto& feature = via_value_of_features_[position];
+  if (feature == nullptr) {
+    feature = context_.feature_factory->get_via_value_of_feature(
+        source_constant_arguments_[position]);
+  }
+  return feature;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <DexClass.h>
+
+#include <mariana-trench/Access.h>
+#include <mariana-trench/CallClassIntervalContext.h>
+#include <mariana-trench/ClassIntervals.h>
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/Feature.h>
+#include <mariana-trench/FeatureMayAlwaysSet.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Position.h>
+
+namespace marianatrench {
+
+class Context;
+
+/**
+ * Parameters of the propagation of a callee model to a call site, along with
+ * the computations shared by all its ports: via-type-of and via-value-of
+ * features are materialized once per argument, instead of once per frame.
+ *
+ * This only references the given vectors and features, which must outlive it.
+ * It is meant to be used by a single thread, for a single call site.
+ */
+class CallSitePropagation final {
+ public:
+  CallSitePropagation(
+      const Method* MT_NULLABLE callee,
+      const Position* call_position,
+      int maximum_source_sink_distance,
+      const FeatureMayAlwaysSet& extra_features,
+      Context& context,
+      const std::vector<const DexType * MT_NULLABLE>& source_register_types,
+      const std::vector<std::optional<std::string>>& source_constant_arguments,
+      const CallClassIntervalContext& class_interval_context,
+      const ClassIntervals::Interval& caller_class_interval);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(CallSitePropagation)
+
+  const Method* MT_NULLABLE callee() const {
+    return callee_;
+  }
+
+  const Position* call_position() const {
+    return call_position_;
+  }
+
+  int maximum_source_sink_distance() const {
+    return maximum_source_sink_distance_;
+  }
+
+  const FeatureMayAlwaysSet& extra_features() const {
+    return extra_features_;
+  }
+
+  Context& context() const {
+    return context_;
+  }
+
+  const std::vector<const DexType * MT_NULLABLE>& source_register_types()
+      const {
+    return source_register_types_;
+  }
+
+  const std::vector<std::optional<std::string>>& source_constant_arguments()
+      const {
+    return source_constant_arguments_;
+  }
+
+  const CallClassIntervalContext& class_interval_context() const {
+    return class_interval_context_;
+  }
+
+  const ClassIntervals::Interval& caller_class_interval() const {
+    return caller_class_interval_;
+  }
+
+  /**
+   * Return the via-type-of feature of the argument at the given position, or
+   * nullptr if there is no such argument.
+   */
+  const Feature* MT_NULLABLE via_type_of_feature(ParameterPosition position)
+      const;
+
+  /**
+   * Return the via-value-of feature of the argument at the given position, or
+   * nullptr if there is no such argument.
+   */
+  const Feature* MT_NULLABLE via_value_of_feature(ParameterPosition position)
+      const;
+
+ private:
+  const Method* MT_NULLABLE callee_;
+  const Position* call_position_;
+  int maximum_source_sink_distance_;
+  const FeatureMayAlwaysSet& extra_features_;
+  Context& context_;
+  const std::vector<const DexType * MT_NULLABLE>& source_register_types_;
+  const std::vector<std::optional<std::string>>& source_constant_arguments_;
+  const CallClassIntervalContext& class_interval_context_;
+  const ClassIntervals::Interval& caller_class_interval_;
+
+  // Materialized features, by argument position.
+  mutable std::vector<const Feature * MT_NULLABLE> via_type_of_features_;
+  mutable std::vector<const Feature * MT_NULLABLE> via_value_of_features_;
+};
+
+} // namespace marianatrench
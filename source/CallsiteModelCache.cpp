@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <boost/functional/hash.hpp>
+
+#include <mariana-trench/CacheStatistics.h>
+#include <mariana-trench/CallsiteModelCache.h>
+
+namespace marianatrench {
+
+bool CallsiteModelCache::Key::operator==(const Key& other) const {
+  return caller == other.caller && callee == other.callee &&
+      position == other.position &&
+      source_register_types == other.source_register_types &&
+      source_constant_arguments == other.source_constant_arguments &&
+      class_interval_context == other.class_interval_context &&
+      tainted_arguments == other.tainted_arguments;
+}
+
+std::size_t CallsiteModelCache::KeyHash::operator()(const Key& key) const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, key.caller);
+  boost::hash_combine(seed, key.callee);
+  boost::hash_combine(seed, key.position);
+  for (const auto* type : key.source_register_types) {
+    boost::hash_combine(seed, type);
+  }
+  for (const auto& argument : key.source_constant_arguments) {
+    boost::hash_combine(
+        seed, std::hash<std::optional<std::string>>()(argument));
+  }
+  boost::hash_combine(
+      seed,
+      std::hash<CallClassIntervalContext>()(key.class_interval_context));
+  boost::hash_combine(
+      seed,
+      std::hash<std::optional<std::vector<bool>>>()(key.tainted_arguments));
+  return seed;
+}
+
+CallsiteModelCache::CallsiteModelCache(
+    std::optional<std::size_t> maximum_entries)
+    : maximum_entries_(maximum_entries) {}
+
+std::optional<Model> CallsiteModelCache::get(
+    const Key& key,
+    const std::shared_ptr<const Model>& callee_model) const {
+  auto entry = entries_.get(key, Entry{});
+  if (entry.callee_model.lock() != callee_model) {
+    CacheStatistics::lookup(
+        CacheStatistics::Cache::CallsiteModels, /* hit */ false);
+    return std::nullopt;
+  }
+  CacheStatistics::lookup(
+      CacheStatistics::Cache::CallsiteModels, /* hit */ true);
+  return std::move(entry.model);
+}
+
+void CallsiteModelCache::set(
+    const Key& key,
+    const std::shared_ptr<const Model>& callee_model,
+    const Model& model) {
+  if (full() && entries_.count(key) == 0) {
+    return;
+  }
+  entries_.update(
+      key,
+      [this, &callee_model, &model](
+          const Key& /* key */, Entry& entry, bool exists) {
+        if (!exists) {
+          size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        entry = Entry{callee_model, model};
+      });
+  CacheStatistics::insert(CacheStatistics::Cache::CallsiteModels);
+}
+
+std::optional<Model> CallsiteModelCache::get_joined(
+    const Key& key,
+    const std::vector<std::shared_ptr<const Model>>& callee_models) const {
+  auto entry = joined_entries_.get(key, JoinedEntry{});
+  bool hit = entry.callee_models.size() == callee_models.size();
+  for (std::size_t index = 0; hit && index < callee_models.size(); index++) {
+    hit = entry.callee_models[index].lock() == callee_models[index];
+  }
+  CacheStatistics::lookup(CacheStatistics::Cache::JoinedCallsiteModels, hit);
+  if (!hit) {
+    return std::nullopt;
+  }
+  return std::move(entry.model);
+}
+
+void CallsiteModelCache::set_joined(
+    const Key& key,
+    const std::vector<std::shared_ptr<const Model>>& callee_models,
+    const Model& model) {
+  if (full() && joined_entries_.count(key) == 0) {
+    return;
+  }
+  joined_entries_.update(
+      key,
+      [this, &callee_models, &model](
+          const Key& /* key */, JoinedEntry& entry, bool exists) {
+        if (!exists) {
+          size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        entry = JoinedEntry{
+            std::vector<std::weak_ptr<const Model>>(
+                callee_models.begin(), callee_models.end()),
+            model};
+      });
+  CacheStatistics::insert(CacheStatistics::Cache::JoinedCallsiteModels);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/CallClassIntervalContext.h>
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Position.h>
+
+namespace marianatrench {
+
+/**
+ * Global cache of callee models instantiated at call sites.
+ *
+ * `Model::at_callsite` is recomputed every time a caller is analyzed, even
+ * though most callee models did not change since the previous iteration. This
+ * caches the result for each call site, along with the callee model snapshot
+ * it was computed from. An entry is only reused if the callee model snapshot
+ * is still the current one and the call site inputs are identical.
+ *
+ * The call position is part of the key, since it is embedded in the call
+ * information of propagated frames.
+ *
+ * Virtual call sites also cache the approximated join of the base callee and
+ * override models, which is reused as long as none of these models changed.
+ *
+ * The number of cached call sites can be bounded. Once the cache is full, only
+ * the entries of call sites that are already cached are updated.
+ */
+class CallsiteModelCache final {
+ public:
+  struct Key {
+    const Method* caller;
+    const Method* callee;
+    const Position* position;
+    std::vector<const DexType * MT_NULLABLE> source_register_types;
+    std::vector<std::optional<std::string>> source_constant_arguments;
+    CallClassIntervalContext class_interval_context;
+    std::optional<std::vector<bool>> tainted_arguments;
+
+    bool operator==(const Key& other) const;
+  };
+
+ private:
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    // Do not extend the lifetime of outdated models.
+    std::weak_ptr<const Model> callee_model;
+    Model model;
+  };
+
+  struct JoinedEntry {
+    std::vector<std::weak_ptr<const Model>> callee_models;
+    Model model;
+  };
+
+ public:
+  CallsiteModelCache() = default;
+
+  explicit CallsiteModelCache(std::optional<std::size_t> maximum_entries);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(CallsiteModelCache)
+
+  /**
+   * Return the cached model at the given call site, if it was computed from
+   * the given callee model snapshot.
+   */
+  std::optional<Model> get(
+      const Key& key,
+      const std::shared_ptr<const Model>& callee_model) const;
+
+  void set(
+      const Key& key,
+      const std::shared_ptr<const Model>& callee_model,
+      const Model& model);
+
+  /**
+   * Return the cached joined model at the given virtual call site, where the
+   * key callee is the resolved base callee, if it was computed from the given
+   * snapshots of the base callee and override models, in the same order.
+   */
+  std::optional<Model> get_joined(
+      const Key& key,
+      const std::vector<std::shared_ptr<const Model>>& callee_models) const;
+
+  void set_joined(
+      const Key& key,
+      const std::vector<std::shared_ptr<const Model>>& callee_models,
+      const Model& model);
+
+  /* Number of cached call sites, including joined models. */
+  std::size_t size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /* Whether a new call site would exceed the maximum number of entries. */
+  bool full() const {
+    return maximum_entries_ && size() >= *maximum_entries_;
+  }
+
+ private:
+  std::optional<std::size_t> maximum_entries_;
+  std::atomic<std::size_t> size_{0};
+  ConcurrentMap<Key, Entry, KeyHash> entries_;
+  ConcurrentMap<Key, JoinedEntry, KeyHash> joined_entries_;
+};
+
+} // namespace marianatrench
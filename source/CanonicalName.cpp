@@ -33,20 +33,16 @@ void convert_to_lower_underscore(std::string& input) {
 } // namespace
 
 bool CanonicalName::is_via_type_of_template() const {
-  auto value = template_value();
-  if (!value) {
-    return false;
-  }
-
-  return value->find(k_via_type_of_marker) != std::string::npos;
+  return is_template() &&
+      value().find(k_via_type_of_marker) != std::string::npos;
 }
 
 std::optional<CanonicalName> CanonicalName::instantiate(
     const Method* method,
     const std::vector<const Feature*>& via_type_ofs) const {
-  auto value = template_value();
-  mt_assert(value);
-  auto canonical_name = *value;
+  mt_assert(is_template());
+  const auto& value = this->value();
+  auto canonical_name = value;
 
   if (canonical_name.find(k_leaf_name_marker) != std::string::npos) {
     auto callee_name = method->signature();
@@ -79,13 +75,13 @@ std::optional<CanonicalName> CanonicalName::instantiate(
       WARNING(
           2,
           "Could not instantiate canonical name template '{}'. Via-type-of feature not available.",
-          *value);
+          value);
       return std::nullopt;
     } else if (via_type_ofs.size() > 1) {
       ERROR(
           1,
           "Could not instantiate canonical name template '{}'. Unable to disambiguate between {} via-type-of features.",
-          *value,
+          value,
           via_type_ofs.size());
       // Should have been verified when parsing models during model-generation.
       mt_assert(false);
@@ -128,19 +124,7 @@ CanonicalName CanonicalName::from_json(const Json::Value& value) {
 
 Json::Value CanonicalName::to_json() const {
   auto result = Json::Value(Json::objectValue);
-  auto value = template_value();
-  if (value) {
-    result["template"] = *value;
-    return result;
-  }
-
-  value = instantiated_value();
-  if (value) {
-    result["instantiated"] = *value;
-    return result;
-  }
-
-  mt_unreachable();
+  result[is_template() ? "template" : "instantiated"] = value();
   return result;
 }
 
@@ -150,26 +134,17 @@ OriginSet CanonicalName::propagate(
     const AccessPath& callee_port) {
   OriginSet origins;
   for (const auto& name : instantiated_canonical_names.elements()) {
+    mt_assert(name.is_instantiated());
     origins.add(OriginFactory::singleton().crtex_origin(
-        /* canonical_name */ *name.instantiated_value(),
+        /* canonical_name */ name.value(),
         /* port */ AccessPathFactory::singleton().get(callee_port)));
   }
   return origins;
 }
 
 std::ostream& operator<<(std::ostream& out, const CanonicalName& root) {
-  auto value = root.template_value();
-  if (value) {
-    return out << "template=" << *value;
-  }
-
-  value = root.instantiated_value();
-  if (value) {
-    return out << "instantiated=" << *value;
-  }
-
-  mt_unreachable();
-  return out;
+  return out << (root.is_template() ? "template=" : "instantiated=")
+             << root.value();
 }
 
 } // namespace marianatrench
@@ -102,6 +102,20 @@ class CanonicalName final {
     }
   }
 
+  bool is_template() const {
+    return std::holds_alternative<TemplateValue>(value_);
+  }
+
+  bool is_instantiated() const {
+    return std::holds_alternative<InstantiatedValue>(value_);
+  }
+
+  /* The templated or instantiated string, without copying it. */
+  const std::string& value() const {
+    return is_template() ? std::get<TemplateValue>(value_).value
+                         : std::get<InstantiatedValue>(value_).value;
+  }
+
   bool is_via_type_of_template() const;
 
   /**
@@ -146,8 +160,8 @@ template <>
 struct std::hash<marianatrench::CanonicalName> {
   std::size_t operator()(const marianatrench::CanonicalName& name) const {
     std::size_t seed = 0;
-    boost::hash_combine(seed, name.template_value());
-    boost::hash_combine(seed, name.instantiated_value());
+    boost::hash_combine(seed, name.is_template());
+    boost::hash_combine(seed, name.value());
     return seed;
   }
 };
@@ -0,0 +1,1000 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <ConcurrentContainers.h>
+#include <ControlFlow.h>
+#include <IRCode.h>
+
+#include <mariana-trench/AccessPathFactory.h>
+#include <mariana-trench/AnalysisCache.h>
+#include <mariana-trench/Checkpoint.h>
+#include <mariana-trench/Field.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/LocalArgumentKind.h>
+#include <mariana-trench/LocalReturnKind.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/MultiSourceMultiSinkRule.h>
+#include <mariana-trench/NamedKind.h>
+#include <mariana-trench/OriginFactory.h>
+#include <mariana-trench/PartialKind.h>
+#include <mariana-trench/Positions.h>
+#include <mariana-trench/Rules.h>
+#include <mariana-trench/TransformKind.h>
+#include <mariana-trench/TransformsFactory.h>
+#include <mariana-trench/TriggeredPartialKind.h>
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/model-generator/ModelGeneratorNameFactory.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the format of checkpoints changes.
+constexpr int k_version = 1;
+
+// Members of `Model::to_json` that `Model::from_json` restores exactly.
+const std::vector<std::string> k_declaration_members = {
+    "modes",
+    "freeze",
+    "sanitizers",
+    "attach_to_sources",
+    "attach_to_sinks",
+    "attach_to_propagations",
+    "add_features_to_arguments",
+    "inline_as_getter",
+    "inline_as_setter",
+};
+
+std::vector<const IRInstruction*> instructions_of(const Method* method) {
+  std::vector<const IRInstruction*> instructions;
+  const auto* code = method->get_code();
+  if (code == nullptr || !code->cfg_built()) {
+    return instructions;
+  }
+  for (const auto* block : code->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      instructions.push_back(entry.insn);
+    }
+  }
+  return instructions;
+}
+
+Json::Value transforms_to_json(const TransformList& transforms) {
+  auto value = Json::Value(Json::arrayValue);
+  for (const auto* transform : transforms) {
+    value.append(Json::Value(transform->name()));
+  }
+  return value;
+}
+
+Json::Value kind_to_json(const Kind* kind) {
+  auto value = Json::Value(Json::objectValue);
+  if (const auto* named_kind = kind->as<NamedKind>()) {
+    value["name"] = named_kind->name();
+  } else if (const auto* partial_kind = kind->as<PartialKind>()) {
+    value["name"] = partial_kind->name();
+    value["label"] = partial_kind->label();
+  } else if (
+      const auto* triggered_kind = kind->as<TriggeredPartialKind>()) {
+    value["name"] = triggered_kind->partial_kind()->name();
+    value["label"] = triggered_kind->partial_kind()->label();
+    value["rule"] = triggered_kind->rule()->code();
+  } else if (kind->as<LocalReturnKind>() != nullptr) {
+    value["local_return"] = true;
+  } else if (
+      const auto* local_argument_kind = kind->as<LocalArgumentKind>()) {
+    value["local_argument"] =
+        Json::Value(static_cast<Json::UInt>(
+            local_argument_kind->parameter_position()));
+  } else if (const auto* transform_kind = kind->as<TransformKind>()) {
+    value["base"] = kind_to_json(transform_kind->base_kind());
+    if (const auto* local_transforms = transform_kind->local_transforms()) {
+      value["local_transforms"] = transforms_to_json(*local_transforms);
+    }
+    if (const auto* global_transforms = transform_kind->global_transforms()) {
+      value["global_transforms"] = transforms_to_json(*global_transforms);
+    }
+  } else {
+    throw std::runtime_error(fmt::format(
+        "Unable to checkpoint kind `{}`.", kind->to_trace_string()));
+  }
+  return value;
+}
+
+Json::Value features_to_json(const FeatureMayAlwaysSet& features) {
+  if (features.is_bottom()) {
+    return Json::Value("bottom");
+  } else if (features.is_top()) {
+    return Json::Value("top");
+  }
+  auto value = Json::Value(Json::objectValue);
+  value["may"] = features.may().to_json();
+  value["always"] = features.always().to_json();
+  return value;
+}
+
+FeatureMayAlwaysSet features_from_json(
+    const Json::Value& value,
+    Context& context) {
+  if (value.isString()) {
+    auto state = JsonValidation::string(value);
+    if (state == "bottom") {
+      return FeatureMayAlwaysSet::bottom();
+    } else if (state == "top") {
+      return FeatureMayAlwaysSet::top();
+    }
+    throw JsonValidationError(
+        value, /* field */ std::nullopt, "`bottom`, `top` or an object");
+  }
+  return FeatureMayAlwaysSet(
+      FeatureSet::from_json(
+          JsonValidation::null_or_array(value, /* field */ "may"), context),
+      FeatureSet::from_json(
+          JsonValidation::null_or_array(value, /* field */ "always"),
+          context));
+}
+
+Json::Value roots_to_json(const RootSetAbstractDomain& roots) {
+  auto value = Json::Value(Json::arrayValue);
+  for (const auto& root : roots) {
+    value.append(root.to_json());
+  }
+  return value;
+}
+
+RootSetAbstractDomain roots_from_json(const Json::Value& value) {
+  RootSetAbstractDomain roots;
+  for (const auto& root_value : JsonValidation::null_or_array(value)) {
+    roots.add(Root::from_json(root_value));
+  }
+  return roots;
+}
+
+Json::Value origin_to_json(const Origin* origin) {
+  auto value = origin->to_json();
+  if (origin->is<MethodOrigin>()) {
+    value["type"] = "method";
+  } else if (origin->is<FieldOrigin>()) {
+    value["type"] = "field";
+  } else if (origin->is<CrtexOrigin>()) {
+    value["type"] = "crtex";
+  } else {
+    mt_assert(origin->is<StringOrigin>());
+    value["type"] = "string";
+  }
+  return value;
+}
+
+const Origin* origin_from_json(const Json::Value& value, Context& context) {
+  const auto& origin_factory = OriginFactory::singleton();
+  const auto& access_path_factory = AccessPathFactory::singleton();
+  auto type = JsonValidation::string(value, /* field */ "type");
+  if (type == "method") {
+    return origin_factory.method_origin(
+        Method::from_json(value["method"], context),
+        access_path_factory.get(AccessPath::from_json(value["port"])));
+  } else if (type == "field") {
+    return origin_factory.field_origin(
+        Field::from_json(value["field"], context));
+  } else if (type == "crtex") {
+    return origin_factory.crtex_origin(
+        JsonValidation::string(value, /* field */ "canonical_name"),
+        access_path_factory.get(AccessPath::from_json(value["port"])));
+  } else if (type == "string") {
+    return origin_factory.string_origin(
+        JsonValidation::string(value, /* field */ "method"));
+  }
+  throw JsonValidationError(
+      value,
+      /* field */ "type",
+      "`method`, `field`, `crtex` or `string`");
+}
+
+Json::Value interval_context_to_json(
+    const CallClassIntervalContext& interval_context) {
+  auto value = Json::Value(Json::objectValue);
+  const auto& interval = interval_context.callee_interval();
+  value["interval"] = interval.is_top()
+      ? Json::Value("top")
+      : ClassIntervals::interval_to_json(interval);
+  value["preserves_type_context"] = interval_context.preserves_type_context();
+  return value;
+}
+
+CallClassIntervalContext interval_context_from_json(const Json::Value& value) {
+  const auto& interval_value = value["interval"];
+  auto interval = ClassIntervals::Interval::top();
+  if (interval_value.isArray()) {
+    if (interval_value.empty()) {
+      interval = ClassIntervals::Interval::bottom();
+    } else {
+      interval = ClassIntervals::Interval::finite(
+          static_cast<std::uint32_t>(interval_value[0].asUInt64()),
+          static_cast<std::uint32_t>(interval_value[1].asUInt64()));
+    }
+  }
+  return CallClassIntervalContext(
+      interval,
+      JsonValidation::boolean(value, /* field */ "preserves_type_context"));
+}
+
+/* Serializes models, sharing positions in a table. This is thread-safe. */
+class CheckpointWriter final {
+ public:
+  CheckpointWriter() : positions_size_(0) {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(CheckpointWriter)
+
+  Json::Value model_to_json(const Model& model) {
+    auto value = Json::Value(Json::objectValue);
+    value["method"] = model.method()->to_json();
+
+    auto model_value = model.to_json(ExportOriginsMode::Always);
+    auto declarations = Json::Value(Json::objectValue);
+    for (const auto& member : k_declaration_members) {
+      if (model_value.isMember(member)) {
+        declarations[member] = model_value[member];
+      }
+    }
+    // `Model::to_json` only exports constant access paths.
+    if (model.inline_as_getter().is_top()) {
+      declarations["inline_as_getter"] = "top";
+    }
+    if (model.inline_as_setter().is_top()) {
+      declarations["inline_as_setter"] = "top";
+    }
+    value["declarations"] = declarations;
+
+    value["generations"] = tree_to_json(model.generations());
+    value["parameter_sources"] = tree_to_json(model.parameter_sources());
+    value["sinks"] = tree_to_json(model.sinks());
+    value["effect_sources"] = tree_to_json(model.call_effect_sources());
+    value["effect_sinks"] = tree_to_json(model.call_effect_sinks());
+    value["propagations"] = tree_to_json(model.propagations());
+
+    auto model_generators = Json::Value(Json::arrayValue);
+    for (const auto* model_generator : model.model_generators()) {
+      auto model_generator_value = Json::Value(Json::objectValue);
+      model_generator_value["identifier"] = model_generator->identifier();
+      if (model_generator->part()) {
+        model_generator_value["part"] = *model_generator->part();
+      }
+      model_generators.append(model_generator_value);
+    }
+    value["model_generators"] = model_generators;
+
+    auto issues = Json::Value(Json::arrayValue);
+    for (const auto& issue : model.issues()) {
+      auto issue_value = Json::Value(Json::objectValue);
+      issue_value["rule"] = issue.rule()->code();
+      issue_value["callee"] = std::string(issue.callee());
+      issue_value["sink_index"] =
+          Json::Value(static_cast<Json::UInt>(issue.sink_index()));
+      issue_value["position"] = position_to_json(issue.position());
+      issue_value["sources"] = taint_to_json(issue.sources());
+      issue_value["sinks"] = taint_to_json(issue.sinks());
+      issues.append(issue_value);
+    }
+    value["issues"] = issues;
+    return value;
+  }
+
+  /**
+   * Return the table of positions referenced by the serialized models. This
+   * must be called once all models are serialized.
+   */
+  Json::Value positions_to_json(const Context& context) const {
+    std::vector<const Position*> positions(positions_size_.load());
+    std::unordered_set<const IRInstruction*> instructions;
+    for (const auto& [position, index] : positions_) {
+      positions[index] = position;
+      if (position->instruction() != nullptr) {
+        instructions.insert(position->instruction());
+      }
+    }
+
+    // Locate instructions by their index in the control flow graph.
+    ConcurrentMap<const IRInstruction*, std::pair<const Method*, std::size_t>>
+        instruction_indices;
+    if (!instructions.empty()) {
+      auto queue = work_queue<const Method*>(
+          [&](const Method* method) {
+            std::size_t index = 0;
+            for (const auto* instruction : instructions_of(method)) {
+              if (instructions.count(instruction) > 0) {
+                instruction_indices.emplace(
+                    instruction, std::make_pair(method, index));
+              }
+              index++;
+            }
+          },
+          sparta::parallel::default_num_threads());
+      for (const auto* method : *context.methods) {
+        queue.add_item(method);
+      }
+      queue.run_all();
+    }
+
+    std::size_t unresolved_instructions = 0;
+    auto value = Json::Value(Json::arrayValue);
+    for (const auto* position : positions) {
+      auto position_value = position->to_json();
+      if (auto port = position->port()) {
+        position_value["port"] = port->to_json();
+      }
+      if (const auto* instruction = position->instruction()) {
+        auto [method, index] = instruction_indices.get(
+            instruction,
+            std::pair<const Method*, std::size_t>(nullptr, 0));
+        if (method != nullptr) {
+          position_value["method"] = method->to_json();
+          position_value["instruction"] =
+              Json::Value(static_cast<Json::UInt64>(index));
+        } else {
+          unresolved_instructions++;
+        }
+      }
+      value.append(position_value);
+    }
+    if (unresolved_instructions > 0) {
+      WARNING(
+          1,
+          "Unable to locate the instructions of {} positions in the checkpoint.",
+          unresolved_instructions);
+    }
+    return value;
+  }
+
+ private:
+  Json::Value position_to_json(const Position* MT_NULLABLE position) {
+    if (position == nullptr) {
+      return Json::Value(Json::nullValue);
+    }
+    std::size_t result = 0;
+    positions_.update(
+        position,
+        [&](const Position* /* position */, std::size_t& index, bool exists) {
+          if (!exists) {
+            index = positions_size_++;
+          }
+          result = index;
+        });
+    return Json::Value(static_cast<Json::UInt64>(result));
+  }
+
+  Json::Value tree_to_json(const TaintAccessPathTree& tree) {
+    auto value = Json::Value(Json::arrayValue);
+    for (const auto& [port, taint] : tree.elements()) {
+      auto element = Json::Value(Json::objectValue);
+      element["port"] = port.to_json();
+      element["taint"] = taint_to_json(taint);
+      value.append(element);
+    }
+    return value;
+  }
+
+  Json::Value taint_to_json(const Taint& taint) {
+    auto value = Json::Value(Json::arrayValue);
+    taint.visit_local_taint([&](const LocalTaint& local_taint) {
+      auto local_taint_value = Json::Value(Json::objectValue);
+      if (const auto* callee = local_taint.callee()) {
+        local_taint_value["callee"] = callee->to_json();
+      }
+      local_taint_value["call_kind"] = Json::Value(
+          static_cast<Json::UInt>(local_taint.call_kind().encode()));
+      if (const auto* callee_port = local_taint.callee_port()) {
+        local_taint_value["callee_port"] = callee_port->to_json();
+      }
+      local_taint_value["call_position"] =
+          position_to_json(local_taint.call_position());
+
+      const auto& local_positions = local_taint.local_positions();
+      if (local_positions.is_top()) {
+        local_taint_value["local_positions"] = "top";
+      } else {
+        auto local_positions_value = Json::Value(Json::arrayValue);
+        for (const auto* position : local_positions) {
+          local_positions_value.append(position_to_json(position));
+        }
+        local_taint_value["local_positions"] = local_positions_value;
+      }
+      local_taint_value["locally_inferred_features"] =
+          features_to_json(local_taint.locally_inferred_features());
+
+      auto frames = Json::Value(Json::arrayValue);
+      local_taint.visit_frames(
+          [&](const CallInfo& /* call_info */, const Frame& frame) {
+            frames.append(frame_to_json(frame));
+          });
+      local_taint_value["frames"] = frames;
+      value.append(local_taint_value);
+    });
+    return value;
+  }
+
+  Json::Value frame_to_json(const Frame& frame) {
+    auto value = Json::Value(Json::objectValue);
+    value["kind"] = kind_to_json(frame.kind());
+    if (!frame.class_interval_context().is_default()) {
+      value["class_interval_context"] =
+          interval_context_to_json(frame.class_interval_context());
+    }
+    if (frame.distance() != 0) {
+      value["distance"] = frame.distance();
+    }
+    if (!frame.origins().empty()) {
+      auto origins = Json::Value(Json::arrayValue);
+      for (const auto* origin : frame.origins()) {
+        origins.append(origin_to_json(origin));
+      }
+      value["origins"] = origins;
+    }
+    if (!(frame.inferred_features() == FeatureMayAlwaysSet())) {
+      value["inferred_features"] = features_to_json(frame.inferred_features());
+    }
+    if (!frame.user_features().empty()) {
+      value["user_features"] = frame.user_features().to_json();
+    }
+    if (!frame.via_type_of_ports().empty()) {
+      value["via_type_of"] = roots_to_json(frame.via_type_of_ports());
+    }
+    if (!frame.via_value_of_ports().empty()) {
+      value["via_value_of"] = roots_to_json(frame.via_value_of_ports());
+    }
+
+    const auto& canonical_names = frame.canonical_names();
+    if (canonical_names.is_bottom()) {
+      value["canonical_names"] = "bottom";
+    } else if (canonical_names.is_top()) {
+      value["canonical_names"] = "top";
+    } else if (!canonical_names.elements().empty()) {
+      auto canonical_names_value = Json::Value(Json::arrayValue);
+      for (const auto& canonical_name : canonical_names.elements()) {
+        canonical_names_value.append(canonical_name.to_json());
+      }
+      value["canonical_names"] = canonical_names_value;
+    }
+
+    if (!frame.output_paths().is_bottom()) {
+      auto output_paths = Json::Value(Json::arrayValue);
+      for (const auto& [path, collapse_depth] :
+           frame.output_paths().elements()) {
+        auto output_path = Json::Value(Json::objectValue);
+        output_path["path"] =
+            AccessPath(Root(Root::Kind::Leaf), path).to_json();
+        output_path["collapse_depth"] =
+            Json::Value(static_cast<std::int64_t>(collapse_depth.value()));
+        output_paths.append(output_path);
+      }
+      value["output_paths"] = output_paths;
+    }
+
+    if (!frame.extra_traces().empty()) {
+      auto extra_traces = Json::Value(Json::arrayValue);
+      for (const auto* extra_trace : frame.extra_traces()) {
+        auto extra_trace_value = Json::Value(Json::objectValue);
+        extra_trace_value["kind"] = kind_to_json(extra_trace->kind());
+        if (const auto* callee = extra_trace->callee()) {
+          extra_trace_value["callee"] = callee->to_json();
+        }
+        extra_trace_value["position"] =
+            position_to_json(extra_trace->position());
+        extra_trace_value["callee_port"] =
+            extra_trace->callee_port()->to_json();
+        extra_trace_value["call_kind"] = Json::Value(
+            static_cast<Json::UInt>(extra_trace->call_kind().encode()));
+        extra_traces.append(extra_trace_value);
+      }
+      value["extra_traces"] = extra_traces;
+    }
+    return value;
+  }
+
+ private:
+  ConcurrentMap<const Position*, std::size_t> positions_;
+  std::atomic<std::size_t> positions_size_;
+};
+
+/* Parses models serialized by the `CheckpointWriter`. */
+class CheckpointReader final {
+ public:
+  CheckpointReader(Context& context, const Json::Value& positions_value)
+      : context_(context), positions_(positions_value.size(), nullptr) {
+    for (const auto* rule : *context.rules) {
+      rules_.emplace(rule->code(), rule);
+    }
+
+    std::unordered_map<const Method*, std::vector<Json::ArrayIndex>>
+        instruction_positions;
+    for (Json::ArrayIndex index = 0; index < positions_value.size();
+         index++) {
+      const auto& position_value = positions_value[index];
+      if (position_value.isMember("method")) {
+        instruction_positions[Method::from_json(
+                                  position_value["method"], context)]
+            .push_back(index);
+      } else {
+        positions_[index] = position_from_json(position_value, nullptr);
+      }
+    }
+
+    std::vector<const Method*> methods;
+    for (const auto& [method, _indices] : instruction_positions) {
+      methods.push_back(method);
+    }
+    auto queue = work_queue<const Method*>(
+        [&](const Method* method) {
+          auto method_instructions = instructions_of(method);
+          for (auto index : instruction_positions.at(method)) {
+            const auto& position_value = positions_value[index];
+            auto instruction_index = static_cast<std::size_t>(
+                JsonValidation::integer(
+                    position_value, /* field */ "instruction"));
+            if (instruction_index >= method_instructions.size()) {
+              throw JsonValidationError(
+                  position_value,
+                  /* field */ "instruction",
+                  fmt::format(
+                      "instruction index of `{}`", method->show()));
+            }
+            positions_[index] = position_from_json(
+                position_value, method_instructions[instruction_index]);
+          }
+        },
+        sparta::parallel::default_num_threads());
+    for (const auto* method : methods) {
+      queue.add_item(method);
+    }
+    queue.run_all();
+  }
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(CheckpointReader)
+
+  /* This is thread-safe. */
+  Model model_from_json(const Json::Value& value) const {
+    const auto* method = Method::from_json(value["method"], context_);
+
+    const auto& declarations_value =
+        JsonValidation::object(value, /* field */ "declarations");
+    bool inline_as_getter_top =
+        declarations_value["inline_as_getter"] == "top";
+    bool inline_as_setter_top =
+        declarations_value["inline_as_setter"] == "top";
+    auto declarations = declarations_value;
+    if (inline_as_getter_top) {
+      declarations.removeMember("inline_as_getter");
+    }
+    if (inline_as_setter_top) {
+      declarations.removeMember("inline_as_setter");
+    }
+    auto model = Model::from_trusted_json(method, declarations, context_);
+    if (inline_as_getter_top) {
+      model.set_inline_as_getter(AccessPathConstantDomain::top());
+    }
+    if (inline_as_setter_top) {
+      model.set_inline_as_setter(SetterAccessPathConstantDomain::top());
+    }
+
+    model.set_generations(tree_from_json(value["generations"]));
+    model.set_parameter_sources(tree_from_json(value["parameter_sources"]));
+    model.set_sinks(tree_from_json(value["sinks"]));
+    model.set_call_effect_sources(tree_from_json(value["effect_sources"]));
+    model.set_call_effect_sinks(tree_from_json(value["effect_sinks"]));
+    model.set_propagations(tree_from_json(value["propagations"]));
+
+    for (const auto& model_generator_value :
+         JsonValidation::null_or_array(value, /* field */ "model_generators")) {
+      auto identifier = JsonValidation::string(
+          model_generator_value, /* field */ "identifier");
+      model.add_model_generator(
+          model_generator_value.isMember("part")
+              ? context_.model_generator_name_factory->create(
+                    identifier,
+                    JsonValidation::string(
+                        model_generator_value, /* field */ "part"))
+              : context_.model_generator_name_factory->create(identifier));
+    }
+
+    for (const auto& issue_value :
+         JsonValidation::null_or_array(value, /* field */ "issues")) {
+      model.add_issue(Issue(
+          taint_from_json(issue_value["sources"]),
+          taint_from_json(issue_value["sinks"]),
+          rule_from_json(issue_value["rule"]),
+          JsonValidation::string(issue_value, /* field */ "callee"),
+          static_cast<TextualOrderIndex>(
+              issue_value["sink_index"].asUInt()),
+          position_from_index(issue_value["position"])));
+    }
+    return model;
+  }
+
+ private:
+  const Position* position_from_json(
+      const Json::Value& value,
+      const IRInstruction* MT_NULLABLE instruction) const {
+    std::optional<std::string> path;
+    if (value.isMember("path")) {
+      path = JsonValidation::string(value, /* field */ "path");
+    }
+    std::optional<Root> port;
+    if (value.isMember("port")) {
+      port = Root::from_json(value["port"]);
+    }
+    return context_.positions->get(
+        path,
+        JsonValidation::optional_integer(value, /* field */ "line")
+            .value_or(k_unknown_line),
+        port,
+        instruction,
+        JsonValidation::optional_integer(value, /* field */ "start")
+            .value_or(k_unknown_start),
+        JsonValidation::optional_integer(value, /* field */ "end")
+            .value_or(k_unknown_end));
+  }
+
+  const Position* MT_NULLABLE position_from_index(
+      const Json::Value& value) const {
+    if (value.isNull()) {
+      return nullptr;
+    }
+    auto index = value.asUInt64();
+    if (index >= positions_.size()) {
+      throw JsonValidationError(
+          value, /* field */ std::nullopt, "valid position index");
+    }
+    return positions_[index];
+  }
+
+  const Rule* rule_from_json(const Json::Value& value) const {
+    auto found = rules_.find(JsonValidation::integer(value));
+    if (found == rules_.end()) {
+      throw JsonValidationError(
+          value, /* field */ std::nullopt, "code of an existing rule");
+    }
+    return found->second;
+  }
+
+  const TransformList* transforms_from_json(const Json::Value& value) const {
+    return context_.transforms_factory->create(
+        TransformList::from_json(value, context_));
+  }
+
+  const Kind* kind_from_json(const Json::Value& value) const {
+    const auto& kind_factory = *context_.kind_factory;
+    if (value.isMember("base")) {
+      return kind_factory.transform_kind(
+          kind_from_json(value["base"]),
+          value.isMember("local_transforms")
+              ? transforms_from_json(value["local_transforms"])
+              : nullptr,
+          value.isMember("global_transforms")
+              ? transforms_from_json(value["global_transforms"])
+              : nullptr);
+    } else if (value.isMember("local_return")) {
+      return kind_factory.local_return();
+    } else if (value.isMember("local_argument")) {
+      return kind_factory.local_argument(
+          static_cast<ParameterPosition>(value["local_argument"].asUInt()));
+    }
+
+    auto name = JsonValidation::string(value, /* field */ "name");
+    if (!value.isMember("label")) {
+      return kind_factory.get(name);
+    }
+    const auto* partial_kind = kind_factory.get_partial(
+        name, JsonValidation::string(value, /* field */ "label"));
+    if (!value.isMember("rule")) {
+      return partial_kind;
+    }
+    const auto* rule =
+        rule_from_json(value["rule"])->as<MultiSourceMultiSinkRule>();
+    if (rule == nullptr) {
+      throw JsonValidationError(
+          value, /* field */ "rule", "code of a multi source rule");
+    }
+    return kind_factory.get_triggered(partial_kind, rule);
+  }
+
+  TaintAccessPathTree tree_from_json(const Json::Value& value) const {
+    TaintAccessPathTree tree;
+    for (const auto& element : JsonValidation::null_or_array(value)) {
+      tree.write(
+          AccessPath::from_json(element["port"]),
+          taint_from_json(element["taint"]),
+          UpdateKind::Weak);
+    }
+    return tree;
+  }
+
+  Taint taint_from_json(const Json::Value& value) const {
+    Taint taint;
+    for (const auto& local_taint_value : JsonValidation::null_or_array(value)) {
+      const auto* callee = local_taint_value.isMember("callee")
+          ? Method::from_json(local_taint_value["callee"], context_)
+          : nullptr;
+      auto call_kind =
+          CallKind::decode(local_taint_value["call_kind"].asUInt());
+      auto callee_port = local_taint_value.isMember("callee_port")
+          ? AccessPath::from_json(local_taint_value["callee_port"])
+          : AccessPath(Root(Root::Kind::Leaf));
+      const auto* call_position =
+          position_from_index(local_taint_value["call_position"]);
+
+      auto local_positions = LocalPositionSet::top();
+      if (local_taint_value["local_positions"].isArray()) {
+        local_positions = LocalPositionSet{};
+        for (const auto& index : local_taint_value["local_positions"]) {
+          local_positions.add(position_from_index(index));
+        }
+      }
+      auto locally_inferred_features = features_from_json(
+          local_taint_value["locally_inferred_features"], context_);
+
+      LocalTaint local_taint;
+      for (const auto& frame_value : JsonValidation::null_or_array(
+               local_taint_value, /* field */ "frames")) {
+        local_taint.add(frame_from_json(
+            frame_value,
+            callee_port,
+            callee,
+            call_kind,
+            call_position,
+            local_positions,
+            locally_inferred_features));
+      }
+      taint.add(local_taint);
+    }
+    return taint;
+  }
+
+  TaintConfig frame_from_json(
+      const Json::Value& value,
+      const AccessPath& callee_port,
+      const Method* MT_NULLABLE callee,
+      CallKind call_kind,
+      const Position* MT_NULLABLE call_position,
+      const LocalPositionSet& local_positions,
+      const FeatureMayAlwaysSet& locally_inferred_features) const {
+    OriginSet origins;
+    for (const auto& origin_value :
+         JsonValidation::null_or_array(value, /* field */ "origins")) {
+      origins.add(origin_from_json(origin_value, context_));
+    }
+
+    auto canonical_names = CanonicalNameSetAbstractDomain{};
+    const auto& canonical_names_value = value["canonical_names"];
+    if (canonical_names_value == "bottom") {
+      canonical_names = CanonicalNameSetAbstractDomain::bottom();
+    } else if (canonical_names_value == "top") {
+      canonical_names = CanonicalNameSetAbstractDomain::top();
+    } else {
+      for (const auto& canonical_name_value :
+           JsonValidation::null_or_array(canonical_names_value)) {
+        canonical_names.add(CanonicalName::from_json(canonical_name_value));
+      }
+    }
+
+    PathTreeDomain output_paths;
+    for (const auto& output_path :
+         JsonValidation::null_or_array(value, /* field */ "output_paths")) {
+      output_paths.write(
+          AccessPath::from_json(output_path["path"]).path(),
+          CollapseDepth(static_cast<CollapseDepth::IntType>(
+              output_path["collapse_depth"].asInt64())),
+          UpdateKind::Weak);
+    }
+
+    ExtraTraceSet extra_traces;
+    for (const auto& extra_trace_value :
+         JsonValidation::null_or_array(value, /* field */ "extra_traces")) {
+      extra_traces.add(ExtraTrace(
+          kind_from_json(extra_trace_value["kind"]),
+          extra_trace_value.isMember("callee")
+              ? Method::from_json(extra_trace_value["callee"], context_)
+              : nullptr,
+          position_from_index(extra_trace_value["position"]),
+          AccessPathFactory::singleton().get(
+              AccessPath::from_json(extra_trace_value["callee_port"])),
+          CallKind::decode(extra_trace_value["call_kind"].asUInt())));
+    }
+
+    return TaintConfig(
+        kind_from_json(value["kind"]),
+        callee_port,
+        callee,
+        call_kind,
+        call_position,
+        value.isMember("class_interval_context")
+            ? interval_context_from_json(value["class_interval_context"])
+            : CallClassIntervalContext(),
+        JsonValidation::optional_integer(value, /* field */ "distance")
+            .value_or(0),
+        origins,
+        value.isMember("inferred_features")
+            ? features_from_json(value["inferred_features"], context_)
+            : FeatureMayAlwaysSet(),
+        FeatureSet::from_json(value["user_features"], context_),
+        roots_from_json(value["via_type_of"]),
+        roots_from_json(value["via_value_of"]),
+        canonical_names,
+        output_paths,
+        local_positions,
+        locally_inferred_features,
+        extra_traces);
+  }
+
+ private:
+  Context& context_;
+  std::vector<const Position*> positions_;
+  std::unordered_map<int, const Rule*> rules_;
+};
+
+/* Models of the given methods, along with the program they belong to. */
+Json::Value models_to_json(
+    const std::vector<const Method*>& methods,
+    const Context& context,
+    const Registry& registry) {
+  std::vector<Json::Value> models(methods.size());
+  CheckpointWriter writer;
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        models[index] =
+            writer.model_to_json(*registry.get_snapshot(methods[index]));
+      },
+      sparta::parallel::default_num_threads());
+  for (std::size_t index = 0; index < methods.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+
+  auto value = Json::Value(Json::objectValue);
+  value["version"] = k_version;
+  value["configuration"] =
+      AnalysisCache::configuration_fingerprint(*context.options);
+  value["methods"] =
+      Json::Value(static_cast<Json::UInt64>(context.methods->size()));
+  value["positions"] = writer.positions_to_json(context);
+  auto& models_value = value["models"] = Json::Value(Json::arrayValue);
+  for (auto& model : models) {
+    models_value.append(std::move(model));
+  }
+  return value;
+}
+
+/* Call `visit` on each model in parallel. */
+void visit_models(
+    const std::filesystem::path& path,
+    const Json::Value& value,
+    Context& context,
+    const std::function<void(Model)>& visit) {
+  JsonValidation::validate_object(value);
+  if (JsonValidation::integer(value, /* field */ "version") != k_version ||
+      JsonValidation::string(value, /* field */ "configuration") !=
+          AnalysisCache::configuration_fingerprint(*context.options) ||
+      value["methods"].asUInt64() != context.methods->size()) {
+    throw std::invalid_argument(fmt::format(
+        "Checkpoint `{}` was written with a different configuration or program.",
+        path.native()));
+  }
+
+  CheckpointReader reader(
+      context, JsonValidation::null_or_array(value, /* field */ "positions"));
+  const auto& models_value =
+      JsonValidation::null_or_array(value, /* field */ "models");
+  auto queue = work_queue<Json::ArrayIndex>(
+      [&](Json::ArrayIndex index) {
+        visit(reader.model_from_json(models_value[index]));
+      },
+      sparta::parallel::default_num_threads());
+  for (Json::ArrayIndex index = 0; index < models_value.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+}
+
+// Write to a temporary file first, so that an interruption never leaves a
+// partial file behind.
+void write_atomically(
+    const std::filesystem::path& path,
+    const Json::Value& value) {
+  auto temporary_path = path;
+  temporary_path += ".tmp";
+  JsonValidation::write_json_file(temporary_path, value);
+  std::filesystem::rename(temporary_path, path);
+}
+
+} // namespace
+
+void Checkpoint::store(
+    const std::filesystem::path& path,
+    std::size_t iteration,
+    const ConcurrentMethodSet& methods_to_analyze,
+    const Context& context,
+    const Registry& registry) {
+  auto value = models_to_json(
+      std::vector<const Method*>(
+          context.methods->begin(), context.methods->end()),
+      context,
+      registry);
+
+  auto methods_to_analyze_value = Json::Value(Json::arrayValue);
+  methods_to_analyze.visit([&](const Method* method) {
+    methods_to_analyze_value.append(method->to_json());
+  });
+  value["iteration"] = Json::Value(static_cast<Json::UInt64>(iteration));
+  value["methods_to_analyze"] = methods_to_analyze_value;
+
+  LOG(1,
+      "Writing checkpoint of global iteration {} to `{}`.",
+      iteration,
+      path.native());
+  write_atomically(path, value);
+}
+
+Checkpoint::State Checkpoint::load(
+    const std::filesystem::path& path,
+    Context& context,
+    Registry& registry) {
+  auto value = JsonValidation::parse_json_file(path);
+  visit_models(path, value, context, [&registry](Model model) {
+    registry.set(std::move(model));
+  });
+
+  State state{
+      /* iteration */ static_cast<std::size_t>(value["iteration"].asUInt64()),
+      /* methods_to_analyze */ {}};
+  for (const auto& method_value : JsonValidation::null_or_array(
+           value, /* field */ "methods_to_analyze")) {
+    state.methods_to_analyze.push_back(
+        Method::from_json(method_value, context));
+  }
+
+  LOG(1,
+      "Resuming from global iteration {} with {} models from `{}`.",
+      state.iteration,
+      value["models"].size(),
+      path.native());
+  return state;
+}
+
+void Checkpoint::store_models(
+    const std::filesystem::path& path,
+    const std::vector<const Method*>& methods,
+    const Context& context,
+    const Registry& registry) {
+  write_atomically(path, models_to_json(methods, context, registry));
+}
+
+std::vector<Model> Checkpoint::load_models(
+    const std::filesystem::path& path,
+    Context& context) {
+  std::mutex mutex;
+  std::vector<Model> models;
+  visit_models(
+      path,
+      JsonValidation::parse_json_file(path),
+      context,
+      [&mutex, &models](Model model) {
+        std::lock_guard<std::mutex> lock(mutex);
+        models.push_back(std::move(model));
+      });
+  return models;
+}
+
+} // namespace marianatrench
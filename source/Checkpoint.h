@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include <mariana-trench/ConcurrentMethodSet.h>
+#include <mariana-trench/Context.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Checkpoint of the global iterations fixpoint, used to resume an analysis
+ * that was interrupted.
+ *
+ * With `--checkpoint-interval`, the models of all methods, the methods to
+ * analyze in the next iteration and the number of completed iterations are
+ * written in `checkpoint.json` at the end of every given number of global
+ * iterations. The file is replaced atomically.
+ *
+ * With `--resume-from`, the models are restored into the registry once the
+ * structures preceding the fixpoint (call graph, dependencies, initial models)
+ * are rebuilt, and the fixpoint continues from the next iteration.
+ *
+ * Unlike the model output format, the checkpoint format is lossless: frames
+ * keep their call information, user and inferred features, class intervals
+ * and extra traces, and issues are stored. Positions refer to instructions
+ * by their index in the control flow graph of their method, which is
+ * deterministic for a given program.
+ */
+class Checkpoint final {
+ public:
+  struct State {
+    // Number of completed global iterations.
+    std::size_t iteration;
+    std::vector<const Method*> methods_to_analyze;
+  };
+
+ public:
+  static void store(
+      const std::filesystem::path& path,
+      std::size_t iteration,
+      const ConcurrentMethodSet& methods_to_analyze,
+      const Context& context,
+      const Registry& registry);
+
+  /* Restore the models into the registry and return the fixpoint state. */
+  static State
+  load(const std::filesystem::path& path, Context& context, Registry& registry);
+
+  /* Write the models of the given methods, without fixpoint state. */
+  static void store_models(
+      const std::filesystem::path& path,
+      const std::vector<const Method*>& methods,
+      const Context& context,
+      const Registry& registry);
+
+  /* Read the models written by `store_models`, in no particular order. */
+  static std::vector<Model> load_models(
+      const std::filesystem::path& path,
+      Context& context);
+};
+
+} // namespace marianatrench
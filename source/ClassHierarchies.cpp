@@ -12,108 +12,165 @@
 #include <mariana-trench/ClassHierarchies.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/Redex.h>
 
 namespace marianatrench {
 
-namespace {
-
-class Graph {
- public:
-  void add_edge(const DexType* child, const DexType* parent) {
-    extends_.update(
-        parent,
-        [=](const DexType* /* parent */,
-            std::unordered_set<const DexType*>& children,
-            bool /* exists */) { children.insert(child); });
-  }
-
-  std::unordered_set<const DexType*> extends(const DexType* parent) const {
-    std::unordered_set<const DexType*> result;
-    std::vector<const DexType*> worklist;
-    worklist.push_back(parent);
-
-    while (!worklist.empty()) {
-      const DexType* klass = worklist.back();
-      worklist.pop_back();
-
-      auto children = extends_.find(klass);
-      if (children != extends_.end()) {
-        for (const auto* child : children->second) {
-          if (result.insert(child).second) {
-            worklist.push_back(child);
-          }
-        }
-      }
-    }
-
-    return result;
-  }
-
- private:
-  // Map a class to all classes that *directly* extend it.
-  ConcurrentMap<const DexType*, std::unordered_set<const DexType*>> extends_;
-};
-
-} // namespace
-
 ClassHierarchies::ClassHierarchies(
     const Options& options,
     const DexStoresVector& stores) {
-  Graph graph;
+  // Only classes of the stores have extends, even if other classes are
+  // extended.
+  std::unordered_set<const DexType*> types;
+  for (const auto& scope : DexStoreClassesIterator(stores)) {
+    for (const auto* klass : scope) {
+      types.insert(klass->get_type());
+    }
+  }
 
   // Compute the class hierarchy graph.
   for (const auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::classes(scope, [&graph](const DexClass* klass) {
+    walk::parallel::classes(scope, [this, &types](const DexClass* klass) {
       const DexType* super = klass->get_super_class();
-      if (super != type::java_lang_Object()) {
-        graph.add_edge(/* child */ klass->get_type(), /* parent */ super);
+      if (super != type::java_lang_Object() && types.count(super) > 0) {
+        add_edge(/* child */ klass->get_type(), /* parent */ super);
       }
       for (DexType* interface : *klass->get_interfaces()) {
-        graph.add_edge(/* child */ klass->get_type(), /* parent */ interface);
+        if (types.count(interface) > 0) {
+          add_edge(/* child */ klass->get_type(), /* parent */ interface);
+        }
       }
     });
   }
 
-  // Record the results.
-  for (const auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::classes(scope, [&graph, this](const DexClass* klass) {
-      auto extends = graph.extends(klass->get_type());
-
-      if (!extends.empty()) {
-        extends_.emplace(
-            klass->get_type(),
-            std::make_unique<std::unordered_set<const DexType*>>(
-                std::move(extends)));
+  dump(options);
+}
+
+std::unique_ptr<ClassHierarchies> ClassHierarchies::from_snapshot(
+    const Options& options,
+    const GraphSnapshot::Edges& edges) {
+  // Cannot use `std::make_unique` with a private constructor.
+  auto class_hierarchies =
+      std::unique_ptr<ClassHierarchies>(new ClassHierarchies());
+  for (const auto& [klass_name, extends_names] : edges) {
+    const auto* klass = redex::get_type(klass_name);
+    if (klass == nullptr) {
+      return nullptr;
+    }
+
+    // Snapshots hold transitive sets, which are valid graph edges.
+    for (const auto& extend_name : extends_names) {
+      const auto* extend = redex::get_type(extend_name);
+      if (extend == nullptr) {
+        return nullptr;
       }
-    });
+      class_hierarchies->add_edge(/* child */ extend, /* parent */ klass);
+    }
   }
 
-  if (options.dump_class_hierarchies()) {
-    auto class_hierarchies_path = options.class_hierarchies_output_path();
-    LOG(1,
-        "Writing class hierarchies to `{}`",
-        class_hierarchies_path.native());
-    JsonValidation::write_json_file(class_hierarchies_path, to_json());
+  class_hierarchies->dump(options);
+  return class_hierarchies;
+}
+
+GraphSnapshot::Edges ClassHierarchies::to_snapshot() const {
+  GraphSnapshot::Edges edges;
+  for (const auto& [klass, _children] : children_) {
+    const auto& extends = this->extends(klass);
+    std::vector<std::string> extends_names;
+    extends_names.reserve(extends.size());
+    for (const auto* extend : extends) {
+      extends_names.push_back(show(extend));
+    }
+    edges.emplace_back(show(klass), std::move(extends_names));
   }
+  return edges;
 }
 
 const std::unordered_set<const DexType*>& ClassHierarchies::extends(
     const DexType* klass) const {
   mt_assert(klass != type::java_lang_Object());
 
-  const auto* extends = extends_.get(klass, /* default */ nullptr);
-  if (extends != nullptr) {
+  if (const auto* extends = extends_.get(klass, /* default */ nullptr)) {
     return *extends;
-  } else {
+  }
+  if (!has_extends(klass)) {
     return empty_type_set_;
   }
+
+  auto extends = std::make_unique<std::unordered_set<const DexType*>>();
+  visit_extends(klass, [&extends](const DexType* extend) {
+    extends->insert(extend);
+  });
+  // Another thread might have computed the same set concurrently.
+  extends_.emplace(klass, std::move(extends));
+  return *extends_.at(klass);
+}
+
+void ClassHierarchies::visit_extends(
+    const DexType* klass,
+    const std::function<void(const DexType*)>& visitor) const {
+  std::unordered_set<const DexType*> visited;
+  std::vector<const DexType*> worklist;
+  worklist.push_back(klass);
+
+  while (!worklist.empty()) {
+    const DexType* parent = worklist.back();
+    worklist.pop_back();
+
+    auto children = children_.find(parent);
+    if (children == children_.end()) {
+      continue;
+    }
+    for (const auto* child : children->second) {
+      if (visited.insert(child).second) {
+        visitor(child);
+        worklist.push_back(child);
+      }
+    }
+  }
+}
+
+bool ClassHierarchies::has_extends(const DexType* klass) const {
+  return children_.find(klass) != children_.end();
+}
+
+std::size_t ClassHierarchies::memory_usage() const {
+  using Entry = std::pair<const DexType*, std::unordered_set<const DexType*>>;
+  std::size_t bytes = memory_usage::nodes<Entry>(children_.size()) +
+      memory_usage::nodes<Entry>(extends_.size());
+  for (const auto& [klass, children] : children_) {
+    bytes += memory_usage::nodes<const DexType*>(children.size());
+  }
+  for (const auto& [klass, extends] : extends_) {
+    bytes += memory_usage::nodes<const DexType*>(extends->size());
+  }
+  return bytes;
+}
+
+void ClassHierarchies::add_edge(const DexType* child, const DexType* parent) {
+  children_.update(
+      parent,
+      [=](const DexType* /* parent */,
+          std::unordered_set<const DexType*>& children,
+          bool /* exists */) { children.insert(child); });
+}
+
+void ClassHierarchies::dump(const Options& options) const {
+  if (options.dump_class_hierarchies()) {
+    auto class_hierarchies_path = options.class_hierarchies_output_path();
+    LOG(1,
+        "Writing class hierarchies to `{}`",
+        class_hierarchies_path.native());
+    JsonValidation::write_json_file(class_hierarchies_path, to_json());
+  }
 }
 
 Json::Value ClassHierarchies::to_json() const {
   auto extends_value = Json::Value(Json::objectValue);
-  for (auto [klass, extends] : extends_) {
+  for (const auto& [klass, _children] : children_) {
     auto ClassHierarchies_value = Json::Value(Json::arrayValue);
-    for (const auto* extend : *extends) {
+    for (const auto* extend : extends(klass)) {
       ClassHierarchies_value.append(Json::Value(show(extend)));
     }
     extends_value[show(klass)] = ClassHierarchies_value;
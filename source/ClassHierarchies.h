@@ -7,18 +7,27 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <unordered_set>
 
 #include <json/json.h>
 
+#include <ConcurrentContainers.h>
 #include <DexStore.h>
 
+#include <mariana-trench/GraphSnapshot.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/UniquePointerConcurrentMap.h>
 
 namespace marianatrench {
 
+/**
+ * Only the classes that directly extend each class are stored. The transitive
+ * sets returned by `extends` are computed and memoized on demand, since they
+ * are quadratic in the depth of the hierarchy and most are never queried.
+ */
 class ClassHierarchies final {
  public:
   explicit ClassHierarchies(
@@ -27,13 +36,51 @@ class ClassHierarchies final {
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ClassHierarchies)
 
-  /* Return the set of classes that extend the given class. */
+  /**
+   * Create the class hierarchies from a snapshot. Return nullptr if the
+   * snapshot refers to unknown classes.
+   */
+  static std::unique_ptr<ClassHierarchies> from_snapshot(
+      const Options& options,
+      const GraphSnapshot::Edges& edges);
+
+  GraphSnapshot::Edges to_snapshot() const;
+
+  /**
+   * Return the set of classes that extend the given class. This is
+   * thread-safe.
+   */
   const std::unordered_set<const DexType*>& extends(const DexType* klass) const;
 
+  /**
+   * Visit the classes that extend the given class, once each, without
+   * memoizing them. This is thread-safe.
+   */
+  void visit_extends(
+      const DexType* klass,
+      const std::function<void(const DexType*)>& visitor) const;
+
+  /* Whether any class extends the given class. */
+  bool has_extends(const DexType* klass) const;
+
+  /* Approximate memory used, in bytes. This is not thread-safe. */
+  std::size_t memory_usage() const;
+
   Json::Value to_json() const;
 
  private:
-  UniquePointerConcurrentMap<const DexType*, std::unordered_set<const DexType*>>
+  ClassHierarchies() = default;
+
+  void add_edge(const DexType* child, const DexType* parent);
+
+  void dump(const Options& options) const;
+
+ private:
+  // Map a class to all classes that *directly* extend it.
+  ConcurrentMap<const DexType*, std::unordered_set<const DexType*>> children_;
+  mutable UniquePointerConcurrentMap<
+      const DexType*,
+      std::unordered_set<const DexType*>>
       extends_;
   std::unordered_set<const DexType*> empty_type_set_;
 };
@@ -5,6 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <Show.h>
 #include <TypeUtil.h>
 
@@ -13,17 +19,26 @@
 #include <mariana-trench/ClassIntervals.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
 namespace {
 
+struct SubtreeInterval {
+  const DexType* type;
+  std::uint32_t lower_bound;
+  std::uint32_t upper_bound;
+};
+
 // Sets the class interval for `current_node` while performing a DFS on it.
+// Bounds are relative to the lower bound of the subtree being traversed.
 void dfs_on_hierarchy(
     const ClassHierarchy& class_hierarchy,
     const DexType* current_node,
     std::uint32_t& dfs_order,
-    std::unordered_map<const DexType*, ClassIntervals::Interval>& result) {
+    std::vector<SubtreeInterval>& result) {
   auto lower_bound = dfs_order;
 
   auto children = class_hierarchy.find(current_node);
@@ -37,20 +52,22 @@ void dfs_on_hierarchy(
 
   ++dfs_order;
   mt_assert(dfs_order > 0); // Ensure no overflows.
-
-  // Each node should only be visited once since multiple inheritance is not
-  // supported by Java/Kotlin.
-  mt_assert(result.find(current_node) == result.end());
-  auto interval = ClassIntervals::Interval::finite(lower_bound, dfs_order);
-  result.emplace(current_node, interval);
+  result.push_back(SubtreeInterval{current_node, lower_bound, dfs_order});
 }
 
 } // namespace
 
+ClassIntervals::ClassIntervals(bool enabled)
+    : top_(Interval::top()), enabled_(enabled) {}
+
 ClassIntervals::ClassIntervals(
     const Options& options,
     const DexStoresVector& stores)
-    : top_(Interval::top()) {
+    : top_(Interval::top()), enabled_(!options.disable_class_intervals()) {
+  if (!enabled_) {
+    return;
+  }
+
   ClassHierarchy class_hierarchy;
   for (const auto& scope : DexStoreClassesIterator(stores)) {
     auto store_hierarchy = build_type_hierarchy(scope);
@@ -60,18 +77,67 @@ ClassIntervals::ClassIntervals(
   }
 
   // Assuming the code is known, all classes will be rooted in java.lang.Object.
-  // Optimization: Divide the single hierarchy into multiple, with roots at
-  // direct children of Object, then compute in parallel. Need to make sure
-  // dfs_order does not intersect between different trees.
   const auto* root = type::java_lang_Object();
 
-  std::uint32_t dfs_order = MIN_INTERVAL;
-  dfs_on_hierarchy(class_hierarchy, root, dfs_order, class_intervals_);
+  // The hierarchy can be empty, e.g when there is no class to analyze.
+  auto root_children = class_hierarchy.find(root);
+  if (root_children != class_hierarchy.end()) {
+    // Traverse each subtree rooted at a direct child of Object in parallel.
+    // Since multiple inheritance is not supported by Java/Kotlin, subtrees are
+    // disjoint.
+    std::vector<const DexType*> subtrees(
+        root_children->second.begin(), root_children->second.end());
+    std::vector<std::vector<SubtreeInterval>> subtree_intervals(
+        subtrees.size());
+    auto queue = work_queue<std::size_t>(
+        [&class_hierarchy, &subtrees, &subtree_intervals](std::size_t index) {
+          std::uint32_t dfs_order = 0;
+          dfs_on_hierarchy(
+              class_hierarchy,
+              subtrees[index],
+              dfs_order,
+              subtree_intervals[index]);
+        },
+        sparta::parallel::default_num_threads());
+    for (std::size_t index = 0; index < subtrees.size(); index++) {
+      queue.add_item(index);
+    }
+    queue.run_all();
+
+    std::size_t size = 1;
+    for (const auto& intervals : subtree_intervals) {
+      size += intervals.size();
+    }
+    class_intervals_.reserve(size);
+
+    // Lay out the subtrees consecutively, as a single DFS from Object would.
+    std::uint64_t dfs_order = MIN_INTERVAL;
+    for (const auto& intervals : subtree_intervals) {
+      auto offset = ++dfs_order;
+      for (const auto& interval : intervals) {
+        mt_assert( // Ensure no overflows.
+            offset + interval.upper_bound <=
+            std::numeric_limits<std::uint32_t>::max());
+        // Each node should only be visited once.
+        auto inserted = class_intervals_.emplace(
+            interval.type,
+            Interval::finite(
+                static_cast<std::uint32_t>(offset + interval.lower_bound),
+                static_cast<std::uint32_t>(offset + interval.upper_bound)));
+        mt_assert(inserted.second);
+      }
+      // The root of the subtree is visited last.
+      dfs_order = offset + intervals.back().upper_bound;
+    }
+    ++dfs_order;
+    mt_assert(dfs_order <= std::numeric_limits<std::uint32_t>::max());
+    class_intervals_.emplace(
+        root,
+        Interval::finite(MIN_INTERVAL, static_cast<std::uint32_t>(dfs_order)));
+  }
 
   if (options.dump_class_intervals()) {
-    auto class_intervals_path = options.class_intervals_output_path();
-    LOG(1, "Writing class intervals to `{}`", class_intervals_path.native());
-    JsonValidation::write_json_file(class_intervals_path, to_json());
+    dump(options);
 
     // Dumping class intervals is test-only, perform additional, otherwise
     // unnecessary/expensive validation here.
@@ -88,6 +154,49 @@ ClassIntervals::ClassIntervals(
   }
 }
 
+std::unique_ptr<ClassIntervals> ClassIntervals::from_snapshot(
+    const Options& options,
+    const GraphSnapshot::Edges& edges) {
+  // Cannot use `std::make_unique` with a private constructor.
+  mt_assert(!options.disable_class_intervals());
+  auto class_intervals =
+      std::unique_ptr<ClassIntervals>(new ClassIntervals(/* enabled */ true));
+  class_intervals->class_intervals_.reserve(edges.size());
+  for (const auto& [klass_name, bounds] : edges) {
+    const auto* klass = redex::get_type(klass_name);
+    if (klass == nullptr || bounds.size() != 2) {
+      return nullptr;
+    }
+    try {
+      class_intervals->class_intervals_.emplace(
+          klass,
+          Interval::finite(
+              static_cast<std::uint32_t>(std::stoul(bounds[0])),
+              static_cast<std::uint32_t>(std::stoul(bounds[1]))));
+    } catch (const std::logic_error&) {
+      return nullptr;
+    }
+  }
+
+  if (options.dump_class_intervals()) {
+    class_intervals->dump(options);
+  }
+  return class_intervals;
+}
+
+GraphSnapshot::Edges ClassIntervals::to_snapshot() const {
+  GraphSnapshot::Edges edges;
+  edges.reserve(class_intervals_.size());
+  for (const auto& [klass, interval] : class_intervals_) {
+    edges.emplace_back(
+        show(klass),
+        std::vector<std::string>{
+            std::to_string(interval.lower_bound()),
+            std::to_string(interval.upper_bound())});
+  }
+  return edges;
+}
+
 const ClassIntervals::Interval& ClassIntervals::get_interval(
     const DexType* type) const {
   auto interval = class_intervals_.find(type);
@@ -99,6 +208,12 @@ const ClassIntervals::Interval& ClassIntervals::get_interval(
   return interval->second;
 }
 
+void ClassIntervals::dump(const Options& options) const {
+  auto class_intervals_path = options.class_intervals_output_path();
+  LOG(1, "Writing class intervals to `{}`", class_intervals_path.native());
+  JsonValidation::write_json_file(class_intervals_path, to_json());
+}
+
 Json::Value ClassIntervals::interval_to_json(const Interval& interval) {
   auto interval_json = Json::Value(Json::arrayValue);
   if (interval.is_bottom()) {
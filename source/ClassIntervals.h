@@ -8,6 +8,7 @@
 #pragma once
 
 #include <limits>
+#include <memory>
 #include <unordered_map>
 
 #include <json/json.h>
@@ -17,6 +18,7 @@
 #include <ClassHierarchy.h>
 #include <DexStore.h>
 
+#include <mariana-trench/GraphSnapshot.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Options.h>
 
@@ -39,6 +41,9 @@ namespace marianatrench {
  * Derived1[1,4]   Derived2 [5,6]
  *  |
  * Derived2[2,3]
+ *
+ * The subtrees rooted at the direct children of `java.lang.Object` are
+ * traversed in parallel, then laid out consecutively in the DFS order.
  */
 class ClassIntervals final {
  private:
@@ -56,6 +61,17 @@ class ClassIntervals final {
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ClassIntervals)
 
+  /**
+   * Create the class intervals from a snapshot, where each class is mapped to
+   * its lower and upper bounds. Class intervals must be enabled. Return
+   * nullptr if the snapshot refers to unknown classes or is invalid.
+   */
+  static std::unique_ptr<ClassIntervals> from_snapshot(
+      const Options& options,
+      const GraphSnapshot::Edges& edges);
+
+  GraphSnapshot::Edges to_snapshot() const;
+
   /**
    * Returns the most precisely known interval of the given type.
    * This is generally the computed type, but can be the open interval, such as
@@ -63,13 +79,29 @@ class ClassIntervals final {
    */
   const Interval& get_interval(const DexType* type) const;
 
+  /**
+   * Returns false when class interval computation is disabled, in which case
+   * all intervals are open and propagated frames only use the default
+   * `CallClassIntervalContext`.
+   */
+  bool enabled() const {
+    return enabled_;
+  }
+
   static Json::Value interval_to_json(const Interval& interval);
 
   Json::Value to_json() const;
 
+ private:
+  explicit ClassIntervals(bool enabled);
+
+  void dump(const Options& options) const;
+
  private:
   const Interval top_;
 
+  bool enabled_;
+
   std::unordered_map<const DexType*, Interval> class_intervals_;
 };
 
@@ -6,11 +6,9 @@
  */
 
 #include <exception>
-#include <mutex>
 
 #include <InstructionAnalyzer.h>
 #include <RedexResources.h>
-#include <Walkers.h>
 #include <re2/re2.h>
 
 #include <mariana-trench/Assert.h>
@@ -128,6 +126,15 @@ bool has_privacy_decision_in_class(const DexClass* clazz) {
       clazz->get_anno_set()->get_annotations());
 }
 
+bool has_permission_check(const std::string& code) {
+  return boost::contains(code, "TrustedCaller") ||
+      boost::contains(code, "AbilityIPCPermissionManager") ||
+      boost::contains(code, "CallerInfoHelper") ||
+      boost::contains(code, "AppUpdateRequestIntentVerifier") ||
+      boost::contains(code, "TrustManager") ||
+      boost::contains(code, "CallingIpcPermissionManager");
+}
+
 bool has_permission_check(const DexClass* clazz) {
   auto methods = clazz->get_all_methods();
   for (DexMethod* method : methods) {
@@ -135,15 +142,16 @@ bool has_permission_check(const DexClass* clazz) {
     if (!code) {
       continue;
     }
+    // Control flow graphs may have been released once the method is stable.
+    if (!code->cfg_built()) {
+      if (has_permission_check(show(code))) {
+        return true;
+      }
+      continue;
+    }
     const cfg::ControlFlowGraph& cfg = code->cfg();
     for (const auto* block : cfg.blocks()) {
-      auto show_block = show(block);
-      if (boost::contains(show_block, "TrustedCaller") ||
-          boost::contains(show_block, "AbilityIPCPermissionManager") ||
-          boost::contains(show_block, "CallerInfoHelper") ||
-          boost::contains(show_block, "AppUpdateRequestIntentVerifier") ||
-          boost::contains(show_block, "TrustManager") ||
-          boost::contains(show_block, "CallingIpcPermissionManager")) {
+      if (has_permission_check(show(block))) {
         return true;
       }
     }
@@ -157,7 +165,7 @@ namespace marianatrench {
 
 ClassProperties::ClassProperties(
     const Options& options,
-    const DexStoresVector& stores,
+    const DexStoresVector& /* stores */,
     const FeatureFactory& feature_factory,
     const Dependencies& dependencies,
     std::unique_ptr<AndroidResources> android_resources)
@@ -193,25 +201,6 @@ ClassProperties::ClassProperties(
     EventLogger::log_event("manifest_error", error, 1);
   }
 
-  std::mutex mutex;
-  for (auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::classes(scope, [&mutex, this](DexClass* clazz) {
-      if (is_class_exported_via_uri(clazz)) {
-        std::lock_guard<std::mutex> lock(mutex);
-        dfa_public_scheme_classes_.emplace(clazz->str());
-      }
-
-      if (has_permission_check(clazz)) {
-        std::lock_guard<std::mutex> lock(mutex);
-        inline_permission_classes_.emplace(clazz->str());
-      }
-
-      if (has_privacy_decision_in_class(clazz)) {
-        std::lock_guard<std::mutex> lock(mutex);
-        privacy_decision_classes_.emplace(clazz->str());
-      }
-    });
-  }
 }
 
 void ClassProperties::emplace_classes(
@@ -269,24 +258,54 @@ FeatureSet ClassProperties::get_manifest_features(
   return features;
 }
 
+std::uint8_t ClassProperties::class_flags(std::string_view class_name) const {
+  if (auto flags = class_flags_.get(class_name, /* default */ 0)) {
+    return flags;
+  }
+
+  std::uint8_t flags = ClassFlag::Computed;
+  const auto* clazz = redex::get_class(class_name);
+  if (clazz != nullptr && !clazz->is_external()) {
+    if (is_class_exported_via_uri(clazz)) {
+      flags |= ClassFlag::DfaPublicScheme;
+    }
+    if (has_permission_check(clazz)) {
+      flags |= ClassFlag::InlinePermission;
+    }
+    if (has_privacy_decision_in_class(clazz)) {
+      flags |= ClassFlag::PrivacyDecision;
+    }
+  }
+
+  // Another thread may compute the same flags concurrently.
+  class_flags_.emplace(class_name, flags);
+  return flags;
+}
+
 bool ClassProperties::has_inline_permissions(
     std::string_view class_name) const {
+  if (class_flags(class_name) & ClassFlag::InlinePermission) {
+    return true;
+  }
   auto outer_class = strip_inner_class(class_name);
-  return inline_permission_classes_.count(class_name) > 0 ||
-      inline_permission_classes_.count(outer_class) > 0;
+  return outer_class != class_name &&
+      (class_flags(outer_class) & ClassFlag::InlinePermission);
 }
 
 bool ClassProperties::is_dfa_public(std::string_view class_name) const {
+  if (class_flags(class_name) & ClassFlag::DfaPublicScheme) {
+    return true;
+  }
   auto outer_class = strip_inner_class(class_name);
-  return dfa_public_scheme_classes_.count(class_name) > 0 ||
-      dfa_public_scheme_classes_.count(outer_class) > 0;
+  return outer_class != class_name &&
+      (class_flags(outer_class) & ClassFlag::DfaPublicScheme);
 }
 
 bool ClassProperties::has_privacy_decision(const Method* method) const {
   return (method->dex_method()->get_anno_set() &&
           has_privacy_decision_annotation(
               method->dex_method()->get_anno_set()->get_annotations())) ||
-      privacy_decision_classes_.count(method->get_class()->str()) > 0;
+      (class_flags(method->get_class()->str()) & ClassFlag::PrivacyDecision);
 }
 
 FeatureMayAlwaysSet ClassProperties::propagate_features(
@@ -402,6 +421,13 @@ struct QueueItem {
 
 } // namespace
 
+bool ClassProperties::is_android_component(
+    std::string_view class_name) const {
+  return activities_.count(class_name) > 0 ||
+      services_.count(class_name) > 0 || receivers_.count(class_name) > 0 ||
+      providers_.count(class_name) > 0;
+}
+
 DexClass* MT_NULLABLE
 ClassProperties::get_service_from_stub(const DexClass* clazz) {
   auto constructors = clazz->get_ctors();
@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string_view>
+
+#include <ConcurrentContainers.h>
 #include <DexStore.h>
 #include <RedexResources.h>
 
@@ -29,7 +33,7 @@ class ClassProperties final {
  public:
   explicit ClassProperties(
       const Options& options,
-      const DexStoresVector& stores,
+      const DexStoresVector& /* stores */,
       const FeatureFactory& feature_factory,
       const Dependencies& dependencies,
       std::unique_ptr<AndroidResources> android_resources = nullptr);
@@ -48,6 +52,21 @@ class ClassProperties final {
   bool has_inline_permissions(std::string_view class_name) const;
   bool has_privacy_decision(const Method* method) const;
 
+  enum ClassFlag : std::uint8_t {
+    DfaPublicScheme = 1 << 0,
+    InlinePermission = 1 << 1,
+    PrivacyDecision = 1 << 2,
+    // Set on all flags stored in `class_flags_`.
+    Computed = 1 << 7,
+  };
+
+  /**
+   * Flags of the class with the given name, computed on first use since they
+   * require walking the annotations and code of the class. Classes that are
+   * not part of the stores have no flags.
+   */
+  std::uint8_t class_flags(std::string_view class_name) const;
+
   FeatureSet get_class_features(
       std::string_view clazz,
       const NamedKind* kind,
@@ -69,6 +88,12 @@ class ClassProperties final {
       const Method* method,
       std::unordered_set<const Kind*> kinds) const;
 
+  /**
+   * Whether the class is an activity, service, broadcast receiver or content
+   * provider declared in the manifest.
+   */
+  bool is_android_component(std::string_view class_name) const;
+
   static DexClass* MT_NULLABLE get_service_from_stub(const DexClass* clazz);
 
  private:
@@ -77,9 +102,6 @@ class ClassProperties final {
   std::unordered_map<std::string_view, ExportedKind> receivers_;
   std::unordered_map<std::string_view, ExportedKind> providers_;
 
-  std::unordered_set<std::string_view> dfa_public_scheme_classes_;
-  std::unordered_set<std::string_view> inline_permission_classes_;
-  std::unordered_set<std::string_view> privacy_decision_classes_;
 
   // Note: This is not thread-safe.
   StringStorage strings_;
@@ -89,6 +111,8 @@ class ClassProperties final {
   // This is a cache and updating it does not change the internal state of the
   // object and hence is safe to mark as mutable.
   mutable ConcurrentMap<const Method*, const Method*> via_dependencies_;
+  // Same as above, class names are backed by `DexString`s.
+  mutable ConcurrentMap<std::string_view, std::uint8_t> class_flags_;
 };
 
 } // namespace marianatrench
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/ConcurrentMethodSet.h>
+
+namespace marianatrench {
+
+namespace {
+
+constexpr std::size_t k_bits_per_word = 64;
+
+} // namespace
+
+ConcurrentMethodSet::ConcurrentMethodSet(const Methods& methods)
+    : methods_(methods),
+      number_of_ids_(methods.number_of_ids()),
+      words_(std::make_unique<std::atomic<std::uint64_t>[]>(
+          (number_of_ids_ + k_bits_per_word - 1) / k_bits_per_word)),
+      size_(0) {}
+
+bool ConcurrentMethodSet::insert(const Method* method) {
+  auto id = method->id();
+  mt_assert(id < number_of_ids_);
+  auto mask = std::uint64_t(1) << (id % k_bits_per_word);
+  auto previous = words_[id / k_bits_per_word].fetch_or(mask);
+  if ((previous & mask) != 0) {
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+bool ConcurrentMethodSet::contains(const Method* method) const {
+  auto id = method->id();
+  if (id >= number_of_ids_) {
+    return false;
+  }
+  auto mask = std::uint64_t(1) << (id % k_bits_per_word);
+  return (words_[id / k_bits_per_word].load() & mask) != 0;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Methods.h>
+
+namespace marianatrench {
+
+/**
+ * Thread-safe set of methods, represented as a bitset indexed by `MethodId`.
+ *
+ * The set can only hold methods that exist when it is created.
+ */
+class ConcurrentMethodSet final {
+ public:
+  explicit ConcurrentMethodSet(const Methods& methods);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ConcurrentMethodSet)
+
+  /* Return true if the method was not in the set. This is thread-safe. */
+  bool insert(const Method* method);
+
+  /* This is thread-safe. */
+  bool contains(const Method* method) const;
+
+  std::size_t size() const {
+    return size_.load();
+  }
+
+  /* Call the given function on all methods in the set. */
+  template <typename Function>
+  void visit(Function&& function) const {
+    for (const auto* method : methods_) {
+      if (contains(method)) {
+        function(method);
+      }
+    }
+  }
+
+ private:
+  const Methods& methods_;
+  std::size_t number_of_ids_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+  std::atomic<std::size_t> size_;
+};
+
+} // namespace marianatrench
@@ -6,25 +6,37 @@
  */
 
 #include <mariana-trench/AccessPathFactory.h>
+#include <mariana-trench/AnalysisCache.h>
 #include <mariana-trench/ArtificialMethods.h>
 #include <mariana-trench/CallGraph.h>
+#include <mariana-trench/CallsiteModelCache.h>
 #include <mariana-trench/ClassHierarchies.h>
 #include <mariana-trench/ClassIntervals.h>
 #include <mariana-trench/ClassProperties.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/ControlFlowGraphs.h>
+#include <mariana-trench/ConvergenceReport.h>
+#include <mariana-trench/Daemon.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/FeatureFactory.h>
 #include <mariana-trench/FieldCache.h>
 #include <mariana-trench/Fields.h>
 #include <mariana-trench/KindFactory.h>
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/MethodProfiles.h>
+#include <mariana-trench/MethodSampler.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/ModelSizes.h>
+#include <mariana-trench/ModelStreamer.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/OriginFactory.h>
 #include <mariana-trench/Overrides.h>
 #include <mariana-trench/Positions.h>
+#include <mariana-trench/Progress.h>
+#include <mariana-trench/RelevancePrescan.h>
 #include <mariana-trench/Rules.h>
 #include <mariana-trench/Scheduler.h>
+#include <mariana-trench/Shard.h>
 #include <mariana-trench/Statistics.h>
 #include <mariana-trench/TransformsFactory.h>
 #include <mariana-trench/Types.h>
@@ -33,6 +33,18 @@ class CallGraph;
 class Rules;
 class Dependencies;
 class Scheduler;
+class AnalysisCache;
+class CallsiteModelCache;
+class ModelStreamer;
+class MethodProfiles;
+class ModelSizes;
+class ConvergenceReport;
+class Daemon;
+class Shard;
+class RelevancePrescan;
+class MethodSampler;
+class Progress;
+class MemoryAccounting;
 class OriginFactory;
 class TransformsFactory;
 class UsedKinds;
@@ -76,6 +88,18 @@ class Context final {
   std::unique_ptr<Rules> rules;
   std::unique_ptr<Dependencies> dependencies;
   std::unique_ptr<Scheduler> scheduler;
+  std::unique_ptr<AnalysisCache> analysis_cache;
+  std::unique_ptr<CallsiteModelCache> callsite_model_cache;
+  std::unique_ptr<ModelStreamer> model_streamer;
+  std::unique_ptr<MethodProfiles> method_profiles;
+  std::unique_ptr<ModelSizes> model_sizes;
+  std::unique_ptr<ConvergenceReport> convergence_report;
+  std::unique_ptr<Daemon> daemon;
+  std::unique_ptr<Shard> shard;
+  std::unique_ptr<RelevancePrescan> relevance_prescan;
+  std::unique_ptr<Progress> progress;
+  std::unique_ptr<MethodSampler> method_sampler;
+  std::unique_ptr<MemoryAccounting> memory_accounting;
   std::unique_ptr<UsedKinds> used_kinds;
 };
 
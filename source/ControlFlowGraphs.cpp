@@ -5,9 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <ControlFlow.h>
+#include <IRCode.h>
 #include <Walkers.h>
 
 #include <mariana-trench/ControlFlowGraphs.h>
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/Methods.h>
 
 namespace marianatrench {
 
@@ -26,4 +30,40 @@ ControlFlowGraphs::ControlFlowGraphs(const DexStoresVector& stores) {
   });
 }
 
+void ControlFlowGraphs::release(const Method* method) {
+  auto* code = const_cast<DexMethod*>(method->dex_method())->get_code();
+  if (code != nullptr && code->cfg_built()) {
+    code->clear_cfg();
+  }
+}
+
+std::size_t ControlFlowGraphs::memory_usage(
+    const Methods& methods,
+    std::size_t sampling_rate) {
+  // Instructions are stored in linked lists of `MethodItemEntry`, either in
+  // the blocks of the control flow graph or in the linearized code.
+  constexpr std::size_t k_instruction_size = sizeof(IRInstruction) +
+      sizeof(MethodItemEntry) + memory_usage::k_node_overhead;
+
+  std::size_t index = 0;
+  std::size_t sampled_bytes = 0;
+  for (const auto* method : methods) {
+    if (index++ % sampling_rate != 0) {
+      continue;
+    }
+    const auto* code = method->get_code();
+    if (code == nullptr) {
+      continue;
+    }
+    if (code->cfg_built()) {
+      const auto& cfg = code->cfg();
+      sampled_bytes += cfg.num_blocks() * sizeof(cfg::Block) +
+          cfg.num_opcodes() * k_instruction_size;
+    } else {
+      sampled_bytes += code->count_opcodes() * k_instruction_size;
+    }
+  }
+  return sampled_bytes * sampling_rate;
+}
+
 } // namespace marianatrench
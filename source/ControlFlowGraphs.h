@@ -10,9 +10,13 @@
 #include <DexClass.h>
 
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Method.h>
 
 namespace marianatrench {
 
+class Methods;
+
 class ControlFlowGraphs final {
  public:
   explicit ControlFlowGraphs(const DexStoresVector& stores);
@@ -23,6 +27,20 @@ class ControlFlowGraphs final {
    * Control flow graphs are stored by Redex and can be retrieved with
    * `Method::get_code()` and then `IRCode::cfg()`.
    */
+
+  /*
+   * Free the control flow graph of a method that will not be analyzed again.
+   * The code is linearized back, instructions are preserved.
+   */
+  static void release(const Method* method);
+
+  /*
+   * Approximate memory used by the code of the given methods, in bytes,
+   * measured on one method out of `sampling_rate`.
+   */
+  static std::size_t memory_usage(
+      const Methods& methods,
+      std::size_t sampling_rate);
 };
 
 } // namespace marianatrench
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <mariana-trench/ConvergenceReport.h>
+
+namespace marianatrench {
+
+namespace {
+
+const char* component_name(ConvergenceReport::Component component) {
+  switch (component) {
+    case ConvergenceReport::Component::Generations:
+      return "generations";
+    case ConvergenceReport::Component::Sinks:
+      return "sinks";
+    case ConvergenceReport::Component::Propagations:
+      return "propagations";
+    case ConvergenceReport::Component::Issues:
+      return "issues";
+    case ConvergenceReport::Component::Other:
+      return "other";
+  }
+  return "unknown";
+}
+
+/* Sort by decreasing count, then by signature for a deterministic output. */
+template <typename Count>
+void sort_and_truncate(
+    std::vector<std::pair<const Method*, Count>>& methods,
+    std::size_t size) {
+  std::sort(
+      methods.begin(),
+      methods.end(),
+      [](const auto& left, const auto& right) {
+        if (left.second != right.second) {
+          return left.second > right.second;
+        }
+        return left.first->signature() < right.first->signature();
+      });
+  if (methods.size() > size) {
+    methods.resize(size);
+  }
+}
+
+} // namespace
+
+void ConvergenceReport::analyzed(std::size_t iteration, const Method* method) {
+  methods_.update(
+      method,
+      [](const Method* /* method */,
+         MethodRecord& record,
+         bool /* exists */) { record.analyses++; });
+  iterations_.update(
+      iteration,
+      [](std::size_t /* iteration */,
+         IterationRecord& record,
+         bool /* exists */) { record.methods_analyzed++; });
+}
+
+void ConvergenceReport::changed(
+    std::size_t iteration,
+    const Method* method,
+    const Model& previous_model,
+    const Model& new_model,
+    Callers invalidated_callers) {
+  ComponentCounts changes = {};
+  auto add = [&changes](Component component) {
+    changes[static_cast<std::size_t>(component)] = 1;
+  };
+  if (!new_model.generations().leq(previous_model.generations()) ||
+      !new_model.parameter_sources().leq(previous_model.parameter_sources())) {
+    add(Component::Generations);
+  }
+  if (!new_model.sinks().leq(previous_model.sinks())) {
+    add(Component::Sinks);
+  }
+  if (!new_model.propagations().leq(previous_model.propagations())) {
+    add(Component::Propagations);
+  }
+  if (!new_model.issues().leq(previous_model.issues())) {
+    add(Component::Issues);
+  }
+  if (std::all_of(changes.begin(), changes.end(), [](auto count) {
+        return count == 0;
+      })) {
+    add(Component::Other);
+  }
+
+  methods_.update(
+      method,
+      [&](const Method* /* method */,
+          MethodRecord& record,
+          bool /* exists */) {
+        record.changes++;
+        for (std::size_t component = 0; component < k_components;
+             component++) {
+          record.component_changes[component] += changes[component];
+        }
+        record.invalidations += invalidated_callers.size();
+      });
+  iterations_.update(
+      iteration,
+      [&](std::size_t /* iteration */,
+          IterationRecord& record,
+          bool /* exists */) {
+        record.models_changed++;
+        for (std::size_t component = 0; component < k_components;
+             component++) {
+          record.component_changes[component] += changes[component];
+        }
+      });
+  for (const auto* caller : invalidated_callers) {
+    methods_.update(
+        caller,
+        [method](
+            const Method* /* caller */,
+            MethodRecord& record,
+            bool /* exists */) { record.triggers[method]++; });
+  }
+}
+
+std::size_t ConvergenceReport::analyses(const Method* method) const {
+  return methods_.get(method, MethodRecord{}).analyses;
+}
+
+Json::Value ConvergenceReport::to_json(const ComponentCounts& counts) {
+  auto value = Json::Value(Json::objectValue);
+  for (std::size_t component = 0; component < k_components; component++) {
+    value[component_name(static_cast<Component>(component))] =
+        Json::Value(counts[component]);
+  }
+  return value;
+}
+
+Json::Value ConvergenceReport::to_json() const {
+  auto value = Json::Value(Json::objectValue);
+
+  std::map<std::size_t, const IterationRecord*> iterations;
+  for (const auto& [iteration, record] : iterations_) {
+    iterations.emplace(iteration, &record);
+  }
+  auto iterations_value = Json::Value(Json::arrayValue);
+  for (const auto& [iteration, record] : iterations) {
+    auto iteration_value = Json::Value(Json::objectValue);
+    iteration_value["iteration"] =
+        Json::Value(static_cast<Json::UInt64>(iteration));
+    iteration_value["methods_analyzed"] =
+        Json::Value(record->methods_analyzed);
+    iteration_value["models_changed"] = Json::Value(record->models_changed);
+    iteration_value["changed_components"] =
+        to_json(record->component_changes);
+    iterations_value.append(iteration_value);
+  }
+  value["iterations"] = iterations_value;
+
+  std::vector<std::pair<const Method*, std::uint32_t>> most_analyses;
+  std::vector<std::pair<const Method*, std::uint64_t>> most_invalidations;
+  std::unordered_map<const Method*, const MethodRecord*> records;
+  for (const auto& [method, record] : methods_) {
+    records.emplace(method, &record);
+    if (record.analyses > 1) {
+      most_analyses.emplace_back(method, record.analyses);
+    }
+    if (record.invalidations > 0) {
+      most_invalidations.emplace_back(method, record.invalidations);
+    }
+  }
+  sort_and_truncate(most_analyses, kRecordMethods);
+  sort_and_truncate(most_invalidations, kRecordMethods);
+
+  auto most_analyses_value = Json::Value(Json::arrayValue);
+  for (const auto& [method, analyses] : most_analyses) {
+    const auto& record = *records.at(method);
+    std::vector<std::pair<const Method*, std::uint32_t>> triggers(
+        record.triggers.begin(), record.triggers.end());
+    sort_and_truncate(triggers, kRecordTriggers);
+
+    auto method_value = Json::Value(Json::objectValue);
+    method_value["method"] = Json::Value(method->show());
+    method_value["analyses"] = Json::Value(analyses);
+    method_value["changes"] = Json::Value(record.changes);
+    method_value["changed_components"] = to_json(record.component_changes);
+    auto triggers_value = Json::Value(Json::arrayValue);
+    for (const auto& [callee, invalidations] : triggers) {
+      auto trigger_value = Json::Value(Json::objectValue);
+      trigger_value["callee"] = Json::Value(callee->show());
+      trigger_value["invalidations"] = Json::Value(invalidations);
+      triggers_value.append(trigger_value);
+    }
+    method_value["triggers"] = triggers_value;
+    most_analyses_value.append(method_value);
+  }
+  value["methods_with_most_analyses"] = most_analyses_value;
+
+  auto most_invalidations_value = Json::Value(Json::arrayValue);
+  for (const auto& [method, invalidations] : most_invalidations) {
+    const auto& record = *records.at(method);
+    auto method_value = Json::Value(Json::objectValue);
+    method_value["method"] = Json::Value(method->show());
+    method_value["invalidations"] =
+        Json::Value(static_cast<Json::UInt64>(invalidations));
+    method_value["changes"] = Json::Value(record.changes);
+    method_value["changed_components"] = to_json(record.component_changes);
+    most_invalidations_value.append(method_value);
+  }
+  value["callees_causing_most_invalidations"] = most_invalidations_value;
+
+  return value;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <boost/range/iterator_range.hpp>
+#include <json/json.h>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+
+namespace marianatrench {
+
+/**
+ * Records why the fixpoint keeps iterating, enabled with
+ * `--convergence-report`.
+ *
+ * For each iteration, this counts the analyzed methods and the changed models,
+ * by component. For each method, this counts its analyses and the callees
+ * whose changes invalidated it. The methods with most analyses and the callees
+ * causing most invalidations are reported in the metadata: those are the best
+ * candidates for user models or widening heuristics.
+ *
+ * In the worklist fixpoint, the iteration of a method is its number of
+ * analyses.
+ */
+class ConvergenceReport final {
+ public:
+  enum class Component : unsigned {
+    Generations,
+    Sinks,
+    Propagations,
+    Issues,
+    // Any other change, e.g call effects or modes.
+    Other,
+  };
+
+  constexpr static std::size_t k_components =
+      static_cast<std::size_t>(Component::Other) + 1;
+
+  using Callers = boost::iterator_range<const Method* const*>;
+
+ public:
+  ConvergenceReport() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ConvergenceReport)
+
+  /* Record an analysis of the given method. This is thread-safe. */
+  void analyzed(std::size_t iteration, const Method* method);
+
+  /**
+   * Record that the model of the given method changed from `previous_model`
+   * to `new_model`, which invalidated the given callers. This is thread-safe.
+   */
+  void changed(
+      std::size_t iteration,
+      const Method* method,
+      const Model& previous_model,
+      const Model& new_model,
+      Callers invalidated_callers);
+
+  /* Number of analyses of the given method. */
+  std::size_t analyses(const Method* method) const;
+
+  Json::Value to_json() const;
+
+  /* Maximum number of methods and callees to report. */
+  constexpr static std::size_t kRecordMethods = 20;
+  /* Maximum number of triggering callees to report per method. */
+  constexpr static std::size_t kRecordTriggers = 5;
+
+ private:
+  using ComponentCounts = std::array<std::uint32_t, k_components>;
+
+  struct MethodRecord {
+    std::uint32_t analyses = 0;
+    std::uint32_t changes = 0;
+    ComponentCounts component_changes = {};
+    // Number of callers invalidated by changes of this method.
+    std::uint64_t invalidations = 0;
+    // Number of invalidations of this method, by callee.
+    std::unordered_map<const Method*, std::uint32_t> triggers;
+  };
+
+  struct IterationRecord {
+    std::uint32_t methods_analyzed = 0;
+    std::uint32_t models_changed = 0;
+    ComponentCounts component_changes = {};
+  };
+
+  static Json::Value to_json(const ComponentCounts& counts);
+
+ private:
+  ConcurrentMap<const Method*, MethodRecord> methods_;
+  ConcurrentMap<std::size_t, IterationRecord> iterations_;
+};
+
+} // namespace marianatrench
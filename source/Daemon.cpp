@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+#include <mariana-trench/ConcurrentMethodSet.h>
+#include <mariana-trench/Daemon.h>
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/Interprocedural.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Options.h>
+#include <mariana-trench/Rule.h>
+#include <mariana-trench/Timer.h>
+
+namespace marianatrench {
+
+namespace {
+
+/**
+ * Issues of the given methods, keyed by their method, rule, callee, sink
+ * index and line. Start and end columns are not part of the key, since
+ * positions of the initial run are augmented with highlights.
+ */
+std::unordered_map<std::string, Json::Value> issues_of(
+    const std::unordered_set<const Method*>& methods,
+    const Registry& registry,
+    const Options& options) {
+  std::unordered_map<std::string, Json::Value> issues;
+  for (const auto* method : methods) {
+    for (const auto& issue : registry.get_snapshot(method)->issues()) {
+      auto key = Json::Value(Json::objectValue);
+      key["method"] = method->show();
+      key["rule"] = issue.rule()->code();
+      key["callee"] = std::string(issue.callee());
+      key["sink_index"] =
+          Json::Value(static_cast<Json::UInt>(issue.sink_index()));
+      if (const auto* position = issue.position()) {
+        key["line"] = position->line();
+        if (const auto* path = position->path()) {
+          key["path"] = *path;
+        }
+      }
+      auto key_string = JsonValidation::to_styled_string(key);
+      key["issue"] = issue.to_json(options.export_origins_mode());
+      issues.emplace(std::move(key_string), std::move(key));
+    }
+  }
+  return issues;
+}
+
+const Method* method_from_json(const Json::Value& value, Context& context) {
+  const auto* method = context.methods->get(JsonValidation::string(value));
+  if (method == nullptr) {
+    throw JsonValidationError(
+        value, /* field */ std::nullopt, /* expected */ "existing method name");
+  }
+  return method;
+}
+
+} // namespace
+
+Daemon::Daemon(const Context& context, const Registry& registry) {
+  for (const auto* method : *context.methods) {
+    initial_models_.emplace(method, registry.get_snapshot(method));
+  }
+}
+
+void Daemon::serve(
+    Context& context,
+    Registry& registry,
+    std::istream& input,
+    std::ostream& output) {
+  auto writer = JsonValidation::compact_writer();
+  LOG(1, "Waiting for requests on the standard input...");
+  std::string line;
+  while (std::getline(input, line)) {
+    boost::trim(line);
+    if (line.empty()) {
+      continue;
+    }
+
+    Json::Value response;
+    try {
+      response = handle(context, registry, JsonValidation::parse_json(line));
+    } catch (const std::exception& exception) {
+      ERROR(1, "Unable to handle request: {}", exception.what());
+      response = Json::Value(Json::objectValue);
+      response["error"] = exception.what();
+    }
+    writer->write(response, &output);
+    output << std::endl;
+  }
+  LOG(1, "Standard input closed, exiting.");
+}
+
+Json::Value Daemon::handle(
+    Context& context,
+    Registry& registry,
+    const Json::Value& request) {
+  Timer timer;
+  JsonValidation::validate_object(request);
+  JsonValidation::check_unexpected_members(
+      request, {"classes", "methods", "models"});
+
+  std::vector<const Method*> changed_methods;
+  for (const auto& method_value :
+       JsonValidation::null_or_array(request, /* field */ "methods")) {
+    changed_methods.push_back(method_from_json(method_value, context));
+  }
+
+  std::unordered_set<std::string> classes;
+  for (const auto& class_value :
+       JsonValidation::null_or_array(request, /* field */ "classes")) {
+    classes.insert(JsonValidation::string(class_value));
+  }
+  if (!classes.empty()) {
+    for (const auto* method : *context.methods) {
+      if (classes.count(method->get_class()->str_copy()) > 0) {
+        changed_methods.push_back(method);
+      }
+    }
+  }
+
+  for (const auto& model_value :
+       JsonValidation::null_or_array(request, /* field */ "models")) {
+    const auto* method = method_from_json(model_value["method"], context);
+    auto initial_model = *initial_models_.at(method);
+    initial_model.join_with(Model::from_json(method, model_value, context));
+    initial_models_.insert_or_assign(
+        method, std::make_shared<const Model>(std::move(initial_model)));
+    changed_methods.push_back(method);
+  }
+
+  // Models of transitive dependencies may hold taint of the changed methods.
+  std::unordered_set<const Method*> invalidated_methods(
+      changed_methods.begin(), changed_methods.end());
+  auto changed_methods_size = invalidated_methods.size();
+  std::vector<const Method*> worklist(
+      invalidated_methods.begin(), invalidated_methods.end());
+  while (!worklist.empty()) {
+    const auto* method = worklist.back();
+    worklist.pop_back();
+    for (const auto* dependency : context.dependencies->dependencies(method)) {
+      if (invalidated_methods.insert(dependency).second) {
+        worklist.push_back(dependency);
+      }
+    }
+  }
+  LOG(1,
+      "Resetting the models of {} changed methods and {} dependencies.",
+      changed_methods_size,
+      invalidated_methods.size() - changed_methods_size);
+
+  auto previous_issues =
+      issues_of(invalidated_methods, registry, *context.options);
+
+  ConcurrentMethodSet methods_to_analyze(*context.methods);
+  for (const auto* method : invalidated_methods) {
+    registry.set(*initial_models_.at(method));
+    methods_to_analyze.insert(method);
+  }
+  Interprocedural::run_analysis(context, registry, methods_to_analyze);
+
+  auto issues = issues_of(invalidated_methods, registry, *context.options);
+
+  auto new_issues = Json::Value(Json::arrayValue);
+  for (const auto& [key, issue] : issues) {
+    if (previous_issues.count(key) == 0) {
+      new_issues.append(issue);
+    }
+  }
+  auto removed_issues = Json::Value(Json::arrayValue);
+  for (const auto& [key, issue] : previous_issues) {
+    if (issues.count(key) == 0) {
+      removed_issues.append(issue);
+    }
+  }
+
+  LOG(1,
+      "Re-analyzed {} methods in {:.2f}s: {} new issues, {} removed issues.",
+      invalidated_methods.size(),
+      timer.duration_in_seconds(),
+      new_issues.size(),
+      removed_issues.size());
+
+  auto response = Json::Value(Json::objectValue);
+  response["invalidated_methods"] =
+      Json::Value(static_cast<Json::UInt64>(invalidated_methods.size()));
+  response["new_issues"] = new_issues;
+  response["removed_issues"] = removed_issues;
+  response["issues"] =
+      Json::Value(static_cast<Json::UInt64>(registry.issues_size()));
+  response["time"] = timer.duration_in_seconds();
+  return response;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <unordered_map>
+
+#include <json/json.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Keeps the state of the analysis resident once the global fixpoint is
+ * reached, to answer re-analysis requests in seconds.
+ *
+ * With `--daemon`, requests are read as json lines on the standard input
+ * after the results are written, e.g:
+ *   {"classes": ["LFoo;"], "methods": ["LBar;.baz:()V"], "models": [...]}
+ * The models of the given methods and of the methods of the given classes are
+ * reset to their initial models, as well as the models of their transitive
+ * dependencies. Models in the `models` field, in the input format of
+ * `Model::from_json` with a `method` field, are joined into the initial models
+ * of their method. The fixpoint is then computed again from the reset
+ * methods, and the issues found or lost are written as a json line on the
+ * standard output.
+ *
+ * The code of the program is not reloaded: Redex stores, control flow graphs,
+ * types and the call graph are left unchanged.
+ */
+class Daemon final {
+ public:
+  /* Keep the models of the registry before the fixpoint. */
+  explicit Daemon(const Context& context, const Registry& registry);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Daemon)
+
+  /* Answer the requests read from `input` until it is closed. */
+  void serve(
+      Context& context,
+      Registry& registry,
+      std::istream& input,
+      std::ostream& output);
+
+  Json::Value
+  handle(Context& context, Registry& registry, const Json::Value& request);
+
+ private:
+  std::unordered_map<const Method*, std::shared_ptr<const Model>>
+      initial_models_;
+};
+
+} // namespace marianatrench
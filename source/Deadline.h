@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/* Thrown by cooperative computations that exceeded their deadline. */
+class DeadlineExceededError : public std::runtime_error {
+ public:
+  explicit DeadlineExceededError(const std::string& message)
+      : std::runtime_error(message) {}
+};
+
+/**
+ * A point in time after which a cooperative computation should stop.
+ *
+ * A default constructed deadline never expires.
+ */
+class Deadline final {
+ private:
+  using Clock = std::chrono::steady_clock;
+
+ public:
+  Deadline() = default;
+
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Deadline)
+
+  /* Return a deadline expiring after the given number of seconds, if any. */
+  static Deadline after_seconds(std::optional<int> seconds) {
+    Deadline deadline;
+    if (seconds) {
+      deadline.time_ = Clock::now() + std::chrono::seconds(*seconds);
+    }
+    return deadline;
+  }
+
+  /* Return the deadline expiring first. */
+  static Deadline earliest(const Deadline& left, const Deadline& right) {
+    if (!left.time_) {
+      return right;
+    } else if (!right.time_) {
+      return left;
+    }
+
+    Deadline deadline;
+    deadline.time_ = std::min(*left.time_, *right.time_);
+    return deadline;
+  }
+
+  bool expired() const {
+    return time_ && Clock::now() >= *time_;
+  }
+
+ private:
+  std::optional<Clock::time_point> time_;
+};
+
+} // namespace marianatrench
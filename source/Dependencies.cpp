@@ -5,12 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include <fmt/format.h>
 
-#include <sparta/WorkQueue.h>
-
+#include <ConcurrentContainers.h>
 #include <IRInstruction.h>
 #include <Show.h>
 
@@ -19,10 +20,19 @@
 #include <mariana-trench/Heuristics.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
+namespace {
+
+/* Edges `(callee, caller)` found by a single worker thread. */
+using WorkerEdges = std::vector<std::pair<const Method*, const Method*>>;
+
+} // namespace
+
 Dependencies::Dependencies(
     const Options& options,
     const Methods& methods,
@@ -31,41 +41,37 @@ Dependencies::Dependencies(
     const Registry& registry) {
   ConcurrentSet<const Method*> warn_many_overrides;
 
-  auto queue = sparta::work_queue<const Method*>(
-      [&](const Method* caller) {
-        auto add_caller_as_dependency =
-            [&](const Method* /* method */,
-                std::unordered_set<const Method*>& dependencies,
-                bool /* is_new */) {
-              auto* code = caller->get_code();
-              if (!code) {
-                return;
-              }
-
-              auto model = registry.get(caller);
-              if (model.skip_analysis()) {
-                return;
-              }
-
-              dependencies.insert(caller);
-            };
+  auto number_of_threads = sparta::parallel::default_num_threads();
+  std::vector<WorkerEdges> worker_edges(number_of_threads);
+
+  auto queue = work_queue<const Method*>(
+      [&](WorkerState<const Method*>* worker_state, const Method* caller) {
+        if (!caller->get_code()) {
+          return;
+        }
+
+        if (registry.get_snapshot(caller)->skip_analysis()) {
+          return;
+        }
+
+        auto& edges = worker_edges[worker_state->worker_id()];
 
         auto add_dependency = [&](const CallTarget& call_target) {
           if (!call_target.resolved()) {
             return;
           }
 
-          dependencies_.update(
-              call_target.resolved_base_callee(), add_caller_as_dependency);
+          edges.emplace_back(call_target.resolved_base_callee(), caller);
 
           if (!call_target.is_virtual()) {
             // We don't add a dependency for overrides of direct invocations.
             return;
           }
 
-          auto model = registry.get(call_target.resolved_base_callee());
+          auto model =
+              registry.get_snapshot(call_target.resolved_base_callee());
 
-          if (model.no_join_virtual_overrides()) {
+          if (model->no_join_virtual_overrides()) {
             return;
           }
 
@@ -76,30 +82,62 @@ Dependencies::Dependencies(
           }
 
           for (const auto* override : call_target.overrides()) {
-            dependencies_.update(override, add_caller_as_dependency);
+            edges.emplace_back(override, caller);
           }
         };
 
-        auto callees = call_graph.callees(caller);
-
-        for (const auto& call_target : callees) {
-          add_dependency(call_target);
-        }
-
-        const auto& artificial_callees = call_graph.artificial_callees(caller);
-
-        for (const auto& [instruction, callees] : artificial_callees) {
-          for (const auto& artificial_callee : callees) {
-            add_dependency(artificial_callee.call_target);
-          }
-        }
+        call_graph.visit_call_targets(caller, add_dependency);
       },
-      sparta::parallel::default_num_threads());
+      number_of_threads);
   for (const auto* method : methods) {
     queue.add_item(method);
   }
   queue.run_all();
 
+  methods_.resize(methods.number_of_ids(), nullptr);
+  for (const auto* method : methods) {
+    methods_[method->id()] = method;
+  }
+
+  std::size_t number_edges = 0;
+  std::vector<std::uint32_t> number_callers(methods_.size(), 0);
+  for (const auto& edges : worker_edges) {
+    for (const auto& [callee, _caller] : edges) {
+      mt_assert(callee->id() < methods_.size());
+      number_callers[callee->id()]++;
+    }
+    number_edges += edges.size();
+  }
+
+  offsets_.resize(methods_.size() + 1, 0);
+  for (std::size_t index = 0; index < methods_.size(); index++) {
+    offsets_[index + 1] = offsets_[index] + number_callers[index];
+  }
+
+  callers_.resize(number_edges);
+  for (auto& edges : worker_edges) {
+    for (const auto& [callee, caller] : edges) {
+      auto index = callee->id();
+      callers_[offsets_[index + 1] - number_callers[index]] = caller;
+      number_callers[index]--;
+    }
+    edges = WorkerEdges();
+  }
+
+  // Remove duplicate callers and compact the callers in place.
+  std::uint32_t size = 0;
+  for (std::size_t index = 0; index < methods_.size(); index++) {
+    auto begin = callers_.begin() + offsets_[index];
+    auto end = callers_.begin() + offsets_[index + 1];
+    std::sort(begin, end);
+    end = std::unique(begin, end);
+    offsets_[index] = size;
+    size = std::move(begin, end, callers_.begin() + size) - callers_.begin();
+  }
+  offsets_[methods_.size()] = size;
+  callers_.resize(size);
+  callers_.shrink_to_fit();
+
   for (const auto* method : warn_many_overrides) {
     WARNING(
         1,
@@ -113,24 +151,23 @@ Dependencies::Dependencies(
   }
 }
 
-const std::unordered_set<const Method*>& Dependencies::dependencies(
-    const Method* method) const {
-  // Note that `find` is not thread-safe, but this is fine because
-  // `dependencies_` is read-only after the constructor completed.
-  auto found = dependencies_.find(method);
-  if (found != dependencies_.end()) {
-    return found->second;
-  } else {
-    return empty_method_set_;
+Dependencies::Callers Dependencies::dependencies(const Method* method) const {
+  auto index = method->id();
+  if (index >= methods_.size()) {
+    return Callers(nullptr, nullptr);
   }
+  const auto* callers = callers_.data();
+  return Callers(callers + offsets_[index], callers + offsets_[index + 1]);
 }
 
-Json::Value Dependencies::to_json(const Method* method) const {
-  auto dependencies = dependencies_.find(method);
-  mt_assert(dependencies != dependencies_.end());
+std::size_t Dependencies::memory_usage() const {
+  return memory_usage::contiguous(methods_) +
+      memory_usage::contiguous(offsets_) + memory_usage::contiguous(callers_);
+}
 
+Json::Value Dependencies::to_json(const Method* method) const {
   auto dependencies_value = Json::Value(Json::arrayValue);
-  for (const auto* dependency : dependencies->second) {
+  for (const auto* dependency : dependencies(method)) {
     dependencies_value.append(Json::Value(dependency->show()));
   }
 
@@ -141,8 +178,10 @@ Json::Value Dependencies::to_json(const Method* method) const {
 
 Json::Value Dependencies::to_json() const {
   auto value = Json::Value(Json::objectValue);
-  for (const auto& [method, _dependencies] : dependencies_) {
-    value[method->show()] = to_json(method);
+  for (const auto* method : methods_) {
+    if (method != nullptr && !dependencies(method).empty()) {
+      value[method->show()] = to_json(method);
+    }
   }
   return value;
 }
@@ -153,25 +192,36 @@ void Dependencies::dump_dependencies(
   LOG(1, "Writing dependencies to `{}`", output_directory.native());
 
   std::vector<const Method*> methods;
-  methods.reserve(dependencies_.size());
-  for (const auto& [method, _dependencies] : dependencies_) {
-    methods.push_back(method);
+  for (const auto* method : methods_) {
+    if (method != nullptr && !dependencies(method).empty()) {
+      methods.push_back(method);
+    }
   }
 
-  std::size_t total_elements = methods.size();
-  auto get_json_line = [&](std::size_t i) -> Json::Value {
-    auto value = Json::Value(Json::objectValue);
+  // Lines are written directly, in the same format as `to_json`, to avoid
+  // building a `Json::Value` for each method.
+  auto write_json_line = [&](std::size_t i, std::ostream& output) {
     const auto* method = methods.at(i);
-    value[method->show()] = to_json(method);
-    return value;
+    output << "{";
+    JsonValidation::write_json_string(output, method->show());
+    output << ":[";
+    bool first = true;
+    for (const auto* dependency : dependencies(method)) {
+      if (!first) {
+        output << ",";
+      }
+      first = false;
+      JsonValidation::write_json_string(output, dependency->show());
+    }
+    output << "]}";
   };
 
-  JsonValidation::write_sharded_json_files(
+  JsonValidation::write_sharded_json_lines(
       output_directory,
       batch_size,
-      total_elements,
+      methods.size(),
       "dependencies@",
-      get_json_line);
+      write_json_line);
 }
 
 } // namespace marianatrench
@@ -7,12 +7,12 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <cstdint>
+#include <vector>
 
+#include <boost/range/iterator_range.hpp>
 #include <json/json.h>
 
-#include <ConcurrentContainers.h>
-
 #include <mariana-trench/CallGraph.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
@@ -22,7 +22,18 @@
 
 namespace marianatrench {
 
+/**
+ * The reverse call graph used by the fixpoint, i.e the set of callers to
+ * re-analyze when the model of a method changes.
+ *
+ * The graph is frozen after construction and stored in compressed sparse row
+ * format: the callers of all methods are stored contiguously in a single
+ * vector, indexed by `MethodId`.
+ */
 class Dependencies final {
+ public:
+  using Callers = boost::iterator_range<const Method* const*>;
+
  public:
   explicit Dependencies(
       const Options& options,
@@ -37,8 +48,10 @@ class Dependencies final {
    * Return the set of dependencies for the given method, i.e the set of
    * possible callers.
    */
-  const std::unordered_set<const Method*>& dependencies(
-      const Method* method) const;
+  Callers dependencies(const Method* method) const;
+
+  /* Approximate memory used, in bytes. */
+  std::size_t memory_usage() const;
 
   Json::Value to_json(const Method* method) const;
   Json::Value to_json() const;
@@ -49,8 +62,11 @@ class Dependencies final {
           JsonValidation::k_default_shard_limit) const;
 
  private:
-  ConcurrentMap<const Method*, std::unordered_set<const Method*>> dependencies_;
-  std::unordered_set<const Method*> empty_method_set_;
+  /* Methods indexed by identifier, or nullptr for unused identifiers. */
+  std::vector<const Method*> methods_;
+  /* The callers of `methods_[i]` are `callers_[offsets_[i]..offsets_[i+1]]`. */
+  std::vector<std::uint32_t> offsets_;
+  std::vector<const Method*> callers_;
 };
 
 } // namespace marianatrench
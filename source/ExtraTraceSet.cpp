@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/ExtraTraceSet.h>
+#include <mariana-trench/UniquePointerFactory.h>
+
+namespace marianatrench {
+
+namespace {
+
+const UniquePointerFactory<ExtraTrace, ExtraTrace>& extra_trace_factory() {
+  // Thread-safe global variable, initialized on first call.
+  static UniquePointerFactory<ExtraTrace, ExtraTrace> factory(
+      CacheStatistics::Cache::ExtraTraces);
+  return factory;
+}
+
+} // namespace
+
+void ExtraTraceSet::add(const ExtraTrace& extra_trace) {
+  set_.add(extra_trace_factory().create(extra_trace));
+}
+
+std::ostream& operator<<(
+    std::ostream& out,
+    const ExtraTraceSet& extra_traces) {
+  out << "{";
+  for (auto iterator = extra_traces.begin(), end = extra_traces.end();
+       iterator != end;) {
+    out << **iterator;
+    ++iterator;
+    if (iterator != end) {
+      out << ", ";
+    }
+  }
+  return out << "}";
+}
+
+} // namespace marianatrench
@@ -7,12 +7,52 @@
 
 #pragma once
 
-#include <sparta/HashedSetAbstractDomain.h>
+#include <ostream>
+
+#include <sparta/AbstractDomain.h>
 
 #include <mariana-trench/ExtraTrace.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/PatriciaTreeSetAbstractDomain.h>
 
 namespace marianatrench {
 
-using ExtraTraceSet = sparta::HashedSetAbstractDomain<ExtraTrace>;
+/**
+ * A set of extra traces.
+ *
+ * Extra traces are interned, so that frames propagated through the same
+ * transforms share the same immutable set instead of copying it.
+ */
+class ExtraTraceSet final : public sparta::AbstractDomain<ExtraTraceSet> {
+ private:
+  using Set = PatriciaTreeSetAbstractDomain<
+      const ExtraTrace*,
+      /* bottom_is_empty */ true,
+      /* with_top */ false>;
+
+ public:
+  INCLUDE_SET_MEMBER_TYPES(Set, const ExtraTrace*)
+
+ private:
+  explicit ExtraTraceSet(Set set) : set_(std::move(set)) {}
+
+ public:
+  /* Create the bottom (i.e, empty) extra trace set. */
+  ExtraTraceSet() = default;
+
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ExtraTraceSet)
+  INCLUDE_ABSTRACT_DOMAIN_METHODS(ExtraTraceSet, Set, set_)
+  INCLUDE_SET_METHODS(ExtraTraceSet, Set, set_, const ExtraTrace*, iterator)
+
+  /* Add the unique instance of the given extra trace. */
+  void add(const ExtraTrace& extra_trace);
+
+  friend std::ostream& operator<<(
+      std::ostream& out,
+      const ExtraTraceSet& extra_traces);
+
+ private:
+  Set set_;
+};
 
-}
+} // namespace marianatrench
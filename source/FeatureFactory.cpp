@@ -6,23 +6,55 @@
  */
 
 #include <mariana-trench/FeatureFactory.h>
+#include <mariana-trench/MemoryAccounting.h>
 
 namespace marianatrench {
 
+namespace {
+
+template <typename Key, typename MakeFeature> // const Feature*()
+const Feature* get_memoized(
+    ConcurrentMap<Key, const Feature*>& features,
+    Key key,
+    MakeFeature&& make_feature) {
+  if (const auto* feature = features.get(key, nullptr)) {
+    CacheStatistics::lookup(CacheStatistics::Cache::Features, /* hit */ true);
+    return feature;
+  }
+  const auto* feature = make_feature();
+  features.emplace(key, feature);
+  return feature;
+}
+
+} // namespace
+
+FeatureFactory::FeatureFactory()
+    : intent_routing_feature_(factory_.create("via-intent-routing")),
+      issue_broadening_feature_(factory_.create("via-issue-broadening")),
+      propagation_broadening_feature_(
+          factory_.create("via-propagation-broadening")),
+      widen_broadening_feature_(factory_.create("via-widen-broadening")),
+      invalid_path_broadening_feature_(
+          factory_.create("via-invalid-path-broadening")) {}
+
 const Feature* FeatureFactory::get(const std::string& data) const {
   return factory_.create(data);
 }
 
 const Feature* FeatureFactory::get_via_type_of_feature(
     const DexType* MT_NULLABLE type) const {
-  const auto& type_string = type ? type->str() : "unknown";
-  return factory_.create("via-type:" + type_string);
+  return get_memoized(via_type_of_features_, type, [this, type]() {
+    const auto& type_string = type ? type->str() : "unknown";
+    return factory_.create("via-type:" + type_string);
+  });
 }
 
 const Feature* FeatureFactory::get_via_cast_feature(
     const DexType* MT_NULLABLE type) const {
-  const auto& type_string = type ? type->str() : "unknown";
-  return factory_.create("via-cast:" + type_string);
+  return get_memoized(via_cast_features_, type, [this, type]() {
+    const auto& type_string = type ? type->str() : "unknown";
+    return factory_.create("via-cast:" + type_string);
+  });
 }
 
 const Feature* FeatureFactory::get_via_value_of_feature(
@@ -33,28 +65,38 @@ const Feature* FeatureFactory::get_via_value_of_feature(
 
 const Feature* FeatureFactory::get_via_shim_feature(
     const Method* MT_NULLABLE method) const {
-  const auto& method_string = method ? method->signature() : "unknown";
-  return factory_.create("via-shim:" + method_string);
+  return get_memoized(via_shim_features_, method, [this, method]() {
+    const auto& method_string = method ? method->signature() : "unknown";
+    return factory_.create("via-shim:" + method_string);
+  });
 }
 
 const Feature* FeatureFactory::get_intent_routing_feature() const {
-  return factory_.create("via-intent-routing");
+  return intent_routing_feature_;
 }
 
 const Feature* FeatureFactory::get_issue_broadening_feature() const {
-  return factory_.create("via-issue-broadening");
+  return issue_broadening_feature_;
 }
 
 const Feature* FeatureFactory::get_propagation_broadening_feature() const {
-  return factory_.create("via-propagation-broadening");
+  return propagation_broadening_feature_;
 }
 
 const Feature* FeatureFactory::get_widen_broadening_feature() const {
-  return factory_.create("via-widen-broadening");
+  return widen_broadening_feature_;
 }
 
 const Feature* FeatureFactory::get_invalid_path_broadening() const {
-  return factory_.create("via-invalid-path-broadening");
+  return invalid_path_broadening_feature_;
+}
+
+std::size_t FeatureFactory::memory_usage() const {
+  auto memoized_features = via_type_of_features_.size() +
+      via_cast_features_.size() + via_shim_features_.size();
+  return factory_.memory_usage() +
+      memory_usage::nodes<std::pair<const void*, const Feature*>>(
+             memoized_features);
 }
 
 const FeatureFactory& FeatureFactory::singleton() {
@@ -9,6 +9,8 @@
 
 #include <string>
 
+#include <ConcurrentContainers.h>
+
 #include <mariana-trench/Feature.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
@@ -18,12 +20,16 @@ namespace marianatrench {
 
 class FeatureFactory final {
  public:
-  FeatureFactory() = default;
+  FeatureFactory();
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FeatureFactory)
 
   const Feature* get(const std::string& data) const;
 
+  /**
+   * Features for types and methods are memoized by pointer, and broadening
+   * features are created upfront, so that hits do not build strings.
+   */
   const Feature* get_via_type_of_feature(const DexType* MT_NULLABLE type) const;
   const Feature* get_via_cast_feature(const DexType* MT_NULLABLE type) const;
   const Feature* get_via_value_of_feature(
@@ -57,10 +63,22 @@ class FeatureFactory final {
    */
   const Feature* get_invalid_path_broadening() const;
 
+  /* Approximate memory used, in bytes. */
+  std::size_t memory_usage() const;
+
   static const FeatureFactory& singleton();
 
  private:
-  UniquePointerFactory<std::string, Feature> factory_;
+  UniquePointerFactory<std::string, Feature> factory_{
+      CacheStatistics::Cache::Features};
+  mutable ConcurrentMap<const DexType*, const Feature*> via_type_of_features_;
+  mutable ConcurrentMap<const DexType*, const Feature*> via_cast_features_;
+  mutable ConcurrentMap<const Method*, const Feature*> via_shim_features_;
+  const Feature* intent_routing_feature_;
+  const Feature* issue_broadening_feature_;
+  const Feature* propagation_broadening_feature_;
+  const Feature* widen_broadening_feature_;
+  const Feature* invalid_path_broadening_feature_;
 };
 
 } // namespace marianatrench
@@ -58,6 +58,10 @@ void FeatureMayAlwaysSet::add_may(const Feature* feature) {
 }
 
 void FeatureMayAlwaysSet::add_may(const FeatureSet& features) {
+  if (features.empty() && set_.is_value()) {
+    return;
+  }
+
   set_.add_over(features.elements());
 }
 
@@ -66,10 +70,20 @@ void FeatureMayAlwaysSet::add_always(const Feature* feature) {
 }
 
 void FeatureMayAlwaysSet::add_always(const FeatureSet& features) {
+  if (features.empty() && set_.is_value()) {
+    return;
+  }
+
   set_.add_under(features.elements());
 }
 
 void FeatureMayAlwaysSet::add(const FeatureMayAlwaysSet& other) {
+  // Adding the empty set to a value is a no-op, which is the common case for
+  // frames without locally inferred features.
+  if (set_.is_value() && other.is_value() && other.empty()) {
+    return;
+  }
+
   set_.add(other.set_);
 }
 
@@ -124,6 +138,21 @@ Json::Value FeatureMayAlwaysSet::to_json() const {
   return value;
 }
 
+void FeatureMayAlwaysSet::write_json_members(JsonWriter& writer) const {
+  mt_assert(set_.is_value());
+
+  auto always_features = always();
+  if (!always_features.empty()) {
+    writer.key("always_features");
+    always_features.write_json(writer);
+  }
+  auto may_features = may();
+  if (!may_features.empty()) {
+    writer.key("may_features");
+    may_features.write_json(writer);
+  }
+}
+
 std::ostream& operator<<(
     std::ostream& out,
     const FeatureMayAlwaysSet& features) {
@@ -19,6 +19,7 @@
 #include <mariana-trench/Feature.h>
 #include <mariana-trench/FeatureSet.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 
 namespace marianatrench {
 
@@ -88,6 +89,8 @@ class FeatureMayAlwaysSet final
       Context& context,
       bool check_unexpected_members = true);
   Json::Value to_json() const;
+  /* Write the members of `to_json()` in the current object. */
+  void write_json_members(JsonWriter& writer) const;
 
   friend std::ostream& operator<<(
       std::ostream& out,
@@ -28,6 +28,14 @@ Json::Value FeatureSet::to_json() const {
   return features;
 }
 
+void FeatureSet::write_json(JsonWriter& writer) const {
+  writer.begin_array();
+  for (const auto* feature : set_) {
+    writer.value(feature->name());
+  }
+  writer.end_array();
+}
+
 std::ostream& operator<<(std::ostream& out, const FeatureSet& features) {
   out << "{";
   for (auto iterator = features.begin(), end = features.end();
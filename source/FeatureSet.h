@@ -17,6 +17,7 @@
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/Feature.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/PatriciaTreeSetAbstractDomain.h>
 
 namespace marianatrench {
@@ -44,6 +45,7 @@ class FeatureSet final : public sparta::AbstractDomain<FeatureSet> {
 
   static FeatureSet from_json(const Json::Value& value, Context& context);
   Json::Value to_json() const;
+  void write_json(JsonWriter& writer) const;
 
   friend std::ostream& operator<<(
       std::ostream& out,
@@ -5,119 +5,117 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <Walkers.h>
+#include <algorithm>
+
+#include <DexClass.h>
 
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/FieldCache.h>
 
-namespace {
-
-/**
- * Returns all known DexTypes in the hierarchy of `type` (ancestors and
- * descendents).
- */
-std::unordered_set<const DexType*> types_in_class_hierarchy(
-    const DexType* type,
-    const marianatrench::ClassHierarchies& class_hierarchies) {
-  mt_assert(type != type::java_lang_Object());
-
-  const auto* klass = type_class(type);
-  if (klass == nullptr) {
-    // Not an object type, or class does not exist in the APK (might be in
-    // the system jars). No class hierarchy.
-    return std::unordered_set<const DexType*>{};
-  }
-
-  // Include self + descendants.
-  auto types = class_hierarchies.extends(type);
-  types.insert(type);
+namespace marianatrench {
 
-  // Include inherited types.
-  const auto* super_class_type = klass->get_super_class();
-  while (super_class_type) {
-    klass = type_class(super_class_type);
-    if (klass == nullptr) {
-      // This can happen if the class does not exist in the APK (e.g. exists in
-      // jar). Stop here. We do not have enough information about `klass`.
-      break;
-    }
-    types.insert(super_class_type);
-    super_class_type = klass->get_super_class();
-  }
+namespace {
 
-  return types;
+bool has_finite_interval(const ClassIntervals::Interval& interval) {
+  return !interval.is_top() && !interval.is_bottom();
 }
 
 } // namespace
 
-namespace marianatrench {
-
 FieldCache::FieldCache(
     const ClassHierarchies& class_hierarchies,
-    const DexStoresVector& stores) {
-  using FieldNameToTypeMap =
-      std::unordered_map<const DexString*, const DexType*>;
-
-  // Compute map class_type -> field -> type.
-  // Class hierarchy is ignored at this stage.
-  ConcurrentMap<const DexType*, FieldNameToTypeMap> fields_in_class;
+    const ClassIntervals& class_intervals,
+    const DexStoresVector& stores)
+    : class_hierarchies_(class_hierarchies), class_intervals_(class_intervals) {
   for (const auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::classes(scope, [&fields_in_class](const DexClass* klass) {
-      FieldNameToTypeMap field_to_type;
-      for (const auto* field : klass->get_all_fields()) {
-        field_to_type.emplace(field->get_name(), field->get_type());
+    for (const auto* klass : scope) {
+      const auto* type = klass->get_type();
+      if (type == type::java_lang_Object()) {
+        continue;
       }
+      classes_.insert(type);
 
-      if (!field_to_type.empty()) {
-        fields_in_class.emplace(klass->get_type(), std::move(field_to_type));
+      const auto& interval = class_intervals.get_interval(type);
+      bool indexed = !is_interface(klass) && has_finite_interval(interval);
+      for (const auto* field : klass->get_all_fields()) {
+        declared_types_.emplace(
+            ClassField(type, field->get_name()), field->get_type());
+        if (indexed) {
+          interval_indices_[field->get_name()].emplace_back(
+              interval.lower_bound(), field->get_type());
+        }
       }
-    });
+    }
   }
 
-  // Use class hierarchy to compute
-  // class_type -> derived/inherited fields -> type
-  for (const auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::classes(
-        scope,
-        [&class_hierarchies, &fields_in_class, this](const DexClass* klass) {
-          const auto* type = klass->get_type();
-          if (type == type::java_lang_Object()) {
-            return;
-          }
-          auto class_types = types_in_class_hierarchy(type, class_hierarchies);
-          FieldTypeMap all_field_types;
-          for (const auto* class_type : class_types) {
-            auto field_types = fields_in_class.find(class_type);
-            if (field_types == fields_in_class.end()) {
-              // No fields in this class.
-              continue;
-            }
-            for (const auto& [field, field_type] : field_types->second) {
-              all_field_types[field].insert(field_type);
-            }
-          }
-
-          field_cache_.emplace(
-              klass->get_type(),
-              std::make_unique<FieldTypeMap>(std::move(all_field_types)));
-        });
+  for (auto& [_, index] : interval_indices_) {
+    std::sort(index.begin(), index.end());
+    index.shrink_to_fit();
   }
 }
 
-const FieldCache::Types& FieldCache::field_types(
+FieldCache::Types FieldCache::field_types(
     const DexType* klass,
     const DexString* field) const {
-  const auto* field_name_to_type =
-      field_cache_.get(klass, /* default */ nullptr);
+  Types types;
+  if (classes_.count(klass) == 0) {
+    return types;
+  }
 
-  if (field_name_to_type != nullptr) {
-    auto result = field_name_to_type->find(field);
-    if (result != field_name_to_type->end()) {
-      return result->second;
+  // Self and inherited fields.
+  const auto* type = klass;
+  while (type != nullptr) {
+    const auto* dex_class = type_class(type);
+    if (dex_class == nullptr) {
+      // This can happen if the class does not exist in the APK (e.g. exists in
+      // jar). Stop here. We do not have enough information about the class.
+      break;
+    }
+    if (const auto* field_type = declared_type(type, field)) {
+      types.insert(field_type);
     }
+    type = dex_class->get_super_class();
   }
 
-  return empty_types_;
+  // Fields of descendants.
+  const auto& interval = class_intervals_.get_interval(klass);
+  if (!is_interface(type_class(klass)) && has_finite_interval(interval)) {
+    auto index = interval_indices_.find(field);
+    if (index == interval_indices_.end()) {
+      return types;
+    }
+    // The class itself has the lower bound of its interval.
+    auto begin = std::upper_bound(
+        index->second.begin(),
+        index->second.end(),
+        interval.lower_bound(),
+        [](std::uint32_t lower_bound, const auto& entry) {
+          return lower_bound < entry.first;
+        });
+    for (auto entry = begin;
+         entry != index->second.end() && entry->first <= interval.upper_bound();
+         ++entry) {
+      types.insert(entry->second);
+    }
+  } else {
+    class_hierarchies_.visit_extends(
+        klass, [this, field, &types](const DexType* extend) {
+          if (const auto* field_type = declared_type(extend, field)) {
+            types.insert(field_type);
+          }
+        });
+  }
+
+  return types;
+}
+
+const DexType* MT_NULLABLE
+FieldCache::declared_type(const DexType* klass, const DexString* field) const {
+  auto declared_type = declared_types_.find(ClassField(klass, field));
+  if (declared_type == declared_types_.end()) {
+    return nullptr;
+  }
+  return declared_type->second;
 }
 
 } // namespace marianatrench
@@ -7,27 +7,47 @@
 
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
 
 #include <DexStore.h>
 
 #include <mariana-trench/ClassHierarchies.h>
+#include <mariana-trench/ClassIntervals.h>
 #include <mariana-trench/Compiler.h>
 #include <mariana-trench/IncludeMacros.h>
-#include <mariana-trench/UniquePointerConcurrentMap.h>
 
 namespace marianatrench {
 
+/**
+ * Types of the fields declared in the hierarchy of each class.
+ *
+ * Only the fields declared by each class are stored, in flat tables frozen
+ * after construction. Fields of ancestors are found by walking the super
+ * classes. Fields of descendants are found using class intervals: strict
+ * subclasses are the classes whose interval lower bound is within the interval
+ * of the class. When a class has no finite interval, e.g for interfaces or
+ * when class intervals are disabled, descendants are visited explicitly.
+ */
 class FieldCache final {
  public:
   using Types = std::unordered_set<const DexType*>;
 
  private:
-  using FieldTypeMap = std::unordered_map<const DexString*, Types>;
+  using ClassField = std::pair<const DexType*, const DexString*>;
+
+  // Field types of the classes with a finite interval, by lower bound.
+  using IntervalIndex = std::vector<std::pair<std::uint32_t, const DexType*>>;
 
  public:
   explicit FieldCache(
       const ClassHierarchies& class_hierarchies,
+      const ClassIntervals& class_intervals,
       const DexStoresVector& stores);
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FieldCache)
@@ -35,13 +55,21 @@ class FieldCache final {
   /**
    * Returns the possible types of `field` in `klass`.
    * This includes fields that may be present in any class in the hierarchy of
-   * `klass` (ancestors and descendents).
+   * `klass` (ancestors and descendents). This is thread-safe.
    */
-  const Types& field_types(const DexType* klass, const DexString* field) const;
+  Types field_types(const DexType* klass, const DexString* field) const;
+
+ private:
+  const DexType* MT_NULLABLE
+  declared_type(const DexType* klass, const DexString* field) const;
 
  private:
-  UniquePointerConcurrentMap<const DexType*, FieldTypeMap> field_cache_;
-  Types empty_types_;
+  const ClassHierarchies& class_hierarchies_;
+  const ClassIntervals& class_intervals_;
+  std::unordered_set<const DexType*> classes_;
+  std::unordered_map<ClassField, const DexType*, boost::hash<ClassField>>
+      declared_types_;
+  std::unordered_map<const DexString*, IntervalIndex> interval_indices_;
 };
 
 } // namespace marianatrench
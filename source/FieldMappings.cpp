@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/FieldMappings.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Timer.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+template <typename Key>
+void add_field(
+    const Key& key,
+    const Field* field,
+    ConcurrentMap<Key, FieldHashedSet>& field_mapping) {
+  field_mapping.update(
+      key,
+      [field](const Key& /* key */, FieldHashedSet& fields, bool /* exists */) {
+        fields.add(field);
+      });
+}
+
+} // namespace
+
+FieldMappings::FieldMappings(const Fields& fields) {
+  Timer timer;
+  auto queue = work_queue<const Field*>([this](const Field* field) {
+    const auto* dex_field = field->dex_field();
+    add_field(field->get_name(), field, name_to_fields_);
+    add_field(field->get_class()->get_name()->str(), field, class_to_fields_);
+    add_field(
+        (dex_field->get_access() & DexAccessFlags::ACC_STATIC) > 0,
+        field,
+        is_static_to_fields_);
+
+    const auto* annotations_set = dex_field->get_anno_set();
+    if (annotations_set == nullptr) {
+      return;
+    }
+    for (const auto& annotation : annotations_set->get_annotations()) {
+      const auto* annotation_type = annotation->type();
+      if (annotation_type != nullptr) {
+        add_field(
+            annotation_type->str(), field, annotation_type_to_fields_);
+      }
+    }
+  });
+  for (const auto* field : fields) {
+    queue.add_item(field);
+    all_fields_.add(field);
+  }
+  queue.run_all();
+  LOG(2,
+      "Built field mappings for {} fields in {:.2f}s.",
+      fields.size(),
+      timer.duration_in_seconds());
+}
+
+} // namespace marianatrench
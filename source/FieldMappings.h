@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <sparta/HashedSetAbstractDomain.h>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Fields.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+using FieldHashedSet = sparta::HashedSetAbstractDomain<const Field*>;
+
+/**
+ * Indices from a field property to the fields with that property, used to
+ * find the candidates of field constraints.
+ *
+ * Fields are all created upfront, so the indices are built in parallel on
+ * construction.
+ */
+class FieldMappings final {
+ public:
+  explicit FieldMappings(const Fields& fields);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FieldMappings)
+
+ public:
+  const ConcurrentMap<std::string_view, FieldHashedSet>& name_to_fields()
+      const {
+    return name_to_fields_;
+  }
+
+  /* Maps a class to the fields it declares. */
+  const ConcurrentMap<std::string_view, FieldHashedSet>& class_to_fields()
+      const {
+    return class_to_fields_;
+  }
+
+  const ConcurrentMap<std::string_view, FieldHashedSet>&
+  annotation_type_to_fields() const {
+    return annotation_type_to_fields_;
+  }
+
+  const ConcurrentMap<bool, FieldHashedSet>& is_static_to_fields() const {
+    return is_static_to_fields_;
+  }
+
+  const FieldHashedSet& all_fields() const {
+    return all_fields_;
+  }
+
+ private:
+  // Keys are views on interned `DexString`s, which outlive the mappings.
+  ConcurrentMap<std::string_view, FieldHashedSet> name_to_fields_;
+  ConcurrentMap<std::string_view, FieldHashedSet> class_to_fields_;
+  ConcurrentMap<std::string_view, FieldHashedSet> annotation_type_to_fields_;
+  ConcurrentMap<bool, FieldHashedSet> is_static_to_fields_;
+  FieldHashedSet all_fields_;
+};
+
+} // namespace marianatrench
@@ -7,6 +7,8 @@
 
 #include <fstream>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <mariana-trench/Filesystem.h>
 
 namespace marianatrench {
@@ -30,5 +32,17 @@ void load_string_file(const std::filesystem::path& path, std::string& str) {
   file.read(&str[0], size);
 }
 
+void remove_files_with_prefix(
+    const std::filesystem::path& directory,
+    const std::string& prefix) {
+  for (auto& file : std::filesystem::directory_iterator(directory)) {
+    const auto& file_path = file.path();
+    if (std::filesystem::is_regular_file(file_path) &&
+        boost::starts_with(file_path.filename().string(), prefix)) {
+      std::filesystem::remove(file_path);
+    }
+  }
+}
+
 } // namespace filesystem
 } // namespace marianatrench
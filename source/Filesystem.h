@@ -21,5 +21,10 @@ void save_string_file(
 /* Load contents of file at path to str */
 void load_string_file(const std::filesystem::path& path, std::string& str);
 
+/* Remove the regular files directly under directory whose name has prefix */
+void remove_files_with_prefix(
+    const std::filesystem::path& directory,
+    const std::string& prefix);
+
 } // namespace filesystem
 } // namespace marianatrench
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+
+#include <sparta/AbstractDomain.h>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/GroupHashedSetAbstractDomain.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * A powerset abstract domain with grouping implemented using a flat open
+ * addressing hash table with linear probing.
+ *
+ * This has the same interface and semantics as `GroupHashedSetAbstractDomain`,
+ * but elements are stored contiguously along with their group hash. This
+ * avoids an allocation per element and recomputing group hashes on joins,
+ * which matters for sets with thousands of elements.
+ *
+ * `GroupHash` and `GroupEqual` describe how elements are grouped together.
+ */
+template <
+    typename Element,
+    typename GroupHash,
+    typename GroupEqual,
+    typename GroupDifference = detail::GroupDifference<Element>>
+class FlatGroupHashedSetAbstractDomain final
+    : public sparta::AbstractDomain<FlatGroupHashedSetAbstractDomain<
+          Element,
+          GroupHash,
+          GroupEqual,
+          GroupDifference>> {
+ public:
+  // Check requirements.
+  static_assert(std::is_same_v<
+                decltype(GroupHash()(std::declval<const Element>())),
+                std::size_t>);
+  static_assert(std::is_same_v<
+                decltype(GroupEqual()(
+                    std::declval<const Element>(),
+                    std::declval<const Element>())),
+                bool>);
+  static_assert(std::is_same_v<
+                decltype(GroupDifference()(
+                    std::declval<Element&>(),
+                    std::declval<const Element>())),
+                void>);
+
+ private:
+  struct Slot {
+    std::size_t hash = 0;
+    std::optional<Element> element;
+  };
+
+  using Slots = std::vector<Slot>;
+
+  struct IsOccupied {
+    bool operator()(const Slot& slot) const {
+      return slot.element.has_value();
+    }
+  };
+
+  struct ExposeElement {
+    const Element& operator()(const Slot& slot) const {
+      return *slot.element;
+    }
+  };
+
+  using ConstIterator = boost::transform_iterator<
+      ExposeElement,
+      boost::filter_iterator<IsOccupied, typename Slots::const_iterator>>;
+
+  static constexpr std::size_t k_minimum_capacity = 8;
+
+ public:
+  // C++ container concept member types
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+  using value_type = Element;
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using const_reference = const Element&;
+  using const_pointer = const Element*;
+
+ public:
+  /* Create the bottom (i.e, empty) abstract set. */
+  FlatGroupHashedSetAbstractDomain() = default;
+
+  explicit FlatGroupHashedSetAbstractDomain(const Element& element) {
+    add(element);
+  }
+
+  explicit FlatGroupHashedSetAbstractDomain(
+      std::initializer_list<Element> elements) {
+    for (const auto& element : elements) {
+      add(element);
+    }
+  }
+
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(
+      FlatGroupHashedSetAbstractDomain)
+
+  static FlatGroupHashedSetAbstractDomain bottom() {
+    return FlatGroupHashedSetAbstractDomain();
+  }
+
+  static FlatGroupHashedSetAbstractDomain top() {
+    mt_unreachable(); // Not implemented.
+  }
+
+  bool is_bottom() const {
+    return size_ == 0;
+  }
+
+  bool is_top() const {
+    return false;
+  }
+
+  void set_to_bottom() {
+    clear();
+  }
+
+  void set_to_top() {
+    mt_unreachable(); // Not implemented.
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  ConstIterator begin() const {
+    return ConstIterator(
+        boost::make_filter_iterator<IsOccupied>(slots_.cbegin(), slots_.cend()),
+        ExposeElement());
+  }
+
+  ConstIterator end() const {
+    return ConstIterator(
+        boost::make_filter_iterator<IsOccupied>(slots_.cend(), slots_.cend()),
+        ExposeElement());
+  }
+
+  bool contains(const Element& element) const {
+    if (element.is_bottom()) {
+      return true;
+    }
+
+    const auto* found = find(GroupHash()(element), element);
+    return found != nullptr && element.leq(*found);
+  }
+
+  void add(const Element& element) {
+    if (element.is_bottom()) {
+      return;
+    }
+
+    insert(GroupHash()(element), element);
+  }
+
+  void remove(const Element& element) {
+    if (element.is_bottom() || size_ == 0) {
+      return;
+    }
+
+    auto index = probe(GroupHash()(element), element);
+    if (slots_[index].element && slots_[index].element->leq(element)) {
+      erase(index);
+    }
+  }
+
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+  }
+
+  bool leq(const FlatGroupHashedSetAbstractDomain& other) const {
+    if (size_ > other.size_) {
+      return false;
+    }
+    for (const auto& slot : slots_) {
+      if (!slot.element) {
+        continue;
+      }
+      const auto* found = other.find(slot.hash, *slot.element);
+      if (found == nullptr || !slot.element->leq(*found)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equals(const FlatGroupHashedSetAbstractDomain& other) const {
+    if (size_ != other.size_) {
+      return false;
+    }
+    for (const auto& slot : slots_) {
+      if (!slot.element) {
+        continue;
+      }
+      const auto* found = other.find(slot.hash, *slot.element);
+      if (found == nullptr || !(*slot.element == *found)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void join_with(const FlatGroupHashedSetAbstractDomain& other) {
+    if (other.size_ == 0) {
+      return;
+    } else if (size_ == 0) {
+      *this = other;
+      return;
+    }
+
+    reserve(size_ + other.size_);
+    for (const auto& slot : other.slots_) {
+      if (slot.element) {
+        insert(slot.hash, *slot.element);
+      }
+    }
+  }
+
+  void widen_with(const FlatGroupHashedSetAbstractDomain& other) {
+    join_with(other);
+  }
+
+  void meet_with(const FlatGroupHashedSetAbstractDomain& /*other*/) {
+    mt_unreachable(); // Not implemented.
+  }
+
+  void narrow_with(const FlatGroupHashedSetAbstractDomain& other) {
+    meet_with(other);
+  }
+
+  void difference_with(const FlatGroupHashedSetAbstractDomain& other) {
+    if (size_ == 0 || other.size_ == 0) {
+      return;
+    }
+
+    // For performance, we iterate on the smallest set.
+    if (size_ <= other.size_) {
+      bool erased = false;
+      for (auto& slot : slots_) {
+        if (!slot.element) {
+          continue;
+        }
+        const auto* found = other.find(slot.hash, *slot.element);
+        if (found != nullptr) {
+          GroupDifference()(*slot.element, *found);
+          if (slot.element->is_bottom()) {
+            slot.element.reset();
+            size_--;
+            erased = true;
+          }
+        }
+      }
+      if (erased) {
+        rehash(slots_.size());
+      }
+    } else {
+      for (const auto& slot : other.slots_) {
+        if (!slot.element || size_ == 0) {
+          continue;
+        }
+        auto index = probe(slot.hash, *slot.element);
+        auto& element = slots_[index].element;
+        if (element) {
+          GroupDifference()(*element, *slot.element);
+          if (element->is_bottom()) {
+            erase(index);
+          }
+        }
+      }
+    }
+  }
+
+  /* Update all elements without affecting the grouping. */
+  template <typename Function> // Element(Element)
+  void transform(Function&& f) {
+    static_assert(
+        std::is_same_v<decltype(f(std::declval<Element&&>())), Element>);
+
+    bool erased = false;
+    for (auto& slot : slots_) {
+      if (!slot.element) {
+        continue;
+      }
+      // This is safe as long as `f` does not change the grouping.
+      *slot.element = f(std::move(*slot.element));
+      if (slot.element->is_bottom()) {
+        slot.element.reset();
+        size_--;
+        erased = true;
+      } else {
+        mt_assert_log(
+            GroupHash()(*slot.element) == slot.hash, "group hash has changed");
+      }
+    }
+    if (erased) {
+      rehash(slots_.size());
+    }
+  }
+
+  /* Remove all elements that do not match the given predicate. */
+  template <typename Predicate> // bool(const Element&)
+  void filter(Predicate&& predicate) {
+    static_assert(std::is_same_v<
+                  decltype(predicate(std::declval<const Element>())),
+                  bool>);
+
+    bool erased = false;
+    for (auto& slot : slots_) {
+      if (slot.element && !predicate(*slot.element)) {
+        slot.element.reset();
+        size_--;
+        erased = true;
+      }
+    }
+    if (erased) {
+      rehash(slots_.size());
+    }
+  }
+
+  friend std::ostream& operator<<(
+      std::ostream& out,
+      const FlatGroupHashedSetAbstractDomain& value) {
+    out << "{";
+    for (auto it = value.begin(); it != value.end();) {
+      out << *it++;
+      if (it != value.end()) {
+        out << ", ";
+      }
+    }
+    return out << "}";
+  }
+
+ private:
+  std::size_t mask() const {
+    return slots_.size() - 1;
+  }
+
+  /**
+   * Return the index of the slot holding the element of the same group, or
+   * the empty slot where it would be inserted. The table must not be empty.
+   */
+  std::size_t probe(std::size_t hash, const Element& element) const {
+    mt_assert(!slots_.empty());
+    for (auto index = hash & mask();; index = (index + 1) & mask()) {
+      const auto& slot = slots_[index];
+      if (!slot.element ||
+          (slot.hash == hash && GroupEqual()(*slot.element, element))) {
+        return index;
+      }
+    }
+  }
+
+  const Element* MT_NULLABLE
+  find(std::size_t hash, const Element& element) const {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    const auto& slot = slots_[probe(hash, element)];
+    return slot.element ? &*slot.element : nullptr;
+  }
+
+  void insert(std::size_t hash, const Element& element) {
+    reserve(size_ + 1);
+    auto& slot = slots_[probe(hash, element)];
+    if (slot.element) {
+      // This is safe as long as `join_with` does not change the grouping.
+      slot.element->join_with(element);
+    } else {
+      slot.hash = hash;
+      slot.element = element;
+      size_++;
+    }
+  }
+
+  /* Remove the element at the given index, using backward shift deletion. */
+  void erase(std::size_t index) {
+    slots_[index].element.reset();
+    size_--;
+
+    auto hole = index;
+    for (auto next = (hole + 1) & mask(); slots_[next].element;
+         next = (next + 1) & mask()) {
+      auto ideal = slots_[next].hash & mask();
+      // Move the element into the hole unless its ideal position lies
+      // cyclically within (hole, next].
+      bool in_place = (hole < next) ? (hole < ideal && ideal <= next)
+                                    : (hole < ideal || ideal <= next);
+      if (!in_place) {
+        slots_[hole] = std::move(slots_[next]);
+        slots_[next].element.reset();
+        hole = next;
+      }
+    }
+  }
+
+  /* Ensure the table can hold `size` elements under the maximum load. */
+  void reserve(std::size_t size) {
+    if (size * 4 <= slots_.size() * 3) {
+      return;
+    }
+
+    auto capacity = std::max(slots_.size(), k_minimum_capacity);
+    while (size * 4 > capacity * 3) {
+      capacity *= 2;
+    }
+    rehash(capacity);
+  }
+
+  void rehash(std::size_t capacity) {
+    Slots slots(capacity);
+    std::swap(slots, slots_);
+    for (auto& slot : slots) {
+      if (!slot.element) {
+        continue;
+      }
+      for (auto index = slot.hash & mask();; index = (index + 1) & mask()) {
+        if (!slots_[index].element) {
+          slots_[index] = std::move(slot);
+          break;
+        }
+      }
+    }
+  }
+
+ private:
+  Slots slots_;
+  std::size_t size_ = 0;
+};
+
+} // namespace marianatrench
@@ -175,7 +175,9 @@ void store_alias_results(
           post_alias_environment.last_position()});
 }
 
-void analyze_instruction(
+} // namespace
+
+void ForwardAliasFixpoint::analyze_instruction(
     MethodContext& context,
     const InstructionAnalyzer<ForwardAliasEnvironment>& instruction_analyzer,
     const IRInstruction* instruction,
@@ -195,11 +197,10 @@ void analyze_instruction(
   }
 }
 
-} // namespace
-
 void ForwardAliasFixpoint::analyze_node(
     const NodeId& block,
     ForwardAliasEnvironment* environment) const {
+  context_.visit_block();
   LOG(4, "Analyzing block {}\n{}", block->id(), *environment);
   for (const auto& instruction : *block) {
     switch (instruction.type) {
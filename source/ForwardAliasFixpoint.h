@@ -35,6 +35,16 @@ class ForwardAliasFixpoint final : public sparta::MonotonicFixpointIterator<
       const EdgeId& edge,
       const ForwardAliasEnvironment& environment) const override;
 
+  /**
+   * Analyze the instruction and store its alias results into
+   * `context.aliasing`, for the taint analyses.
+   */
+  static void analyze_instruction(
+      MethodContext& context,
+      const InstructionAnalyzer<ForwardAliasEnvironment>& instruction_analyzer,
+      const IRInstruction* instruction,
+      ForwardAliasEnvironment* alias_environment);
+
  private:
   MethodContext& context_;
   InstructionAnalyzer<ForwardAliasEnvironment> instruction_analyzer_;
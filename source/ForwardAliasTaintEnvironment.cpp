@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/ForwardAliasTaintEnvironment.h>
+
+namespace marianatrench {
+
+ForwardAliasTaintEnvironment::ForwardAliasTaintEnvironment(
+    ForwardAliasEnvironment alias,
+    ForwardTaintEnvironment taint)
+    : alias_(std::move(alias)), taint_(std::move(taint)) {}
+
+ForwardAliasTaintEnvironment ForwardAliasTaintEnvironment::initial() {
+  return ForwardAliasTaintEnvironment(
+      ForwardAliasEnvironment::initial(), ForwardTaintEnvironment::initial());
+}
+
+bool ForwardAliasTaintEnvironment::is_bottom() const {
+  return alias_.is_bottom() && taint_.is_bottom();
+}
+
+bool ForwardAliasTaintEnvironment::is_top() const {
+  return alias_.is_top() && taint_.is_top();
+}
+
+bool ForwardAliasTaintEnvironment::leq(
+    const ForwardAliasTaintEnvironment& other) const {
+  return alias_.leq(other.alias_) && taint_.leq(other.taint_);
+}
+
+bool ForwardAliasTaintEnvironment::equals(
+    const ForwardAliasTaintEnvironment& other) const {
+  return alias_.equals(other.alias_) && taint_.equals(other.taint_);
+}
+
+void ForwardAliasTaintEnvironment::set_to_bottom() {
+  alias_.set_to_bottom();
+  taint_.set_to_bottom();
+}
+
+void ForwardAliasTaintEnvironment::set_to_top() {
+  alias_.set_to_top();
+  taint_.set_to_top();
+}
+
+void ForwardAliasTaintEnvironment::join_with(
+    const ForwardAliasTaintEnvironment& other) {
+  alias_.join_with(other.alias_);
+  taint_.join_with(other.taint_);
+}
+
+void ForwardAliasTaintEnvironment::widen_with(
+    const ForwardAliasTaintEnvironment& other) {
+  alias_.widen_with(other.alias_);
+  taint_.widen_with(other.taint_);
+}
+
+void ForwardAliasTaintEnvironment::meet_with(
+    const ForwardAliasTaintEnvironment& other) {
+  alias_.meet_with(other.alias_);
+  taint_.meet_with(other.taint_);
+}
+
+void ForwardAliasTaintEnvironment::narrow_with(
+    const ForwardAliasTaintEnvironment& other) {
+  alias_.narrow_with(other.alias_);
+  taint_.narrow_with(other.taint_);
+}
+
+std::ostream& operator<<(
+    std::ostream& out,
+    const ForwardAliasTaintEnvironment& environment) {
+  return out << "(alias=" << environment.alias_
+             << ", taint=" << environment.taint_ << ")";
+}
+
+} // namespace marianatrench
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <ostream>
+
+#include <sparta/AbstractDomain.h>
+
+#include <mariana-trench/ForwardAliasEnvironment.h>
+#include <mariana-trench/ForwardTaintEnvironment.h>
+
+namespace marianatrench {
+
+/**
+ * Product of the forward alias and forward taint environments, used to run
+ * both forward analyses in a single fixpoint.
+ *
+ * Like `ForwardAliasEnvironment`, this is not a
+ * `sparta::ReducedProductAbstractDomain`, since the initial taint environment
+ * is bottom.
+ */
+class ForwardAliasTaintEnvironment final
+    : public sparta::AbstractDomain<ForwardAliasTaintEnvironment> {
+ public:
+  /* Create the bottom environment. */
+  ForwardAliasTaintEnvironment() = default;
+
+  ForwardAliasTaintEnvironment(
+      ForwardAliasEnvironment alias,
+      ForwardTaintEnvironment taint);
+
+  /* Return the initial environment. */
+  static ForwardAliasTaintEnvironment initial();
+
+  bool is_bottom() const;
+
+  bool is_top() const;
+
+  bool leq(const ForwardAliasTaintEnvironment& other) const;
+
+  bool equals(const ForwardAliasTaintEnvironment& other) const;
+
+  void set_to_bottom();
+
+  void set_to_top();
+
+  void join_with(const ForwardAliasTaintEnvironment& other);
+
+  void widen_with(const ForwardAliasTaintEnvironment& other);
+
+  void meet_with(const ForwardAliasTaintEnvironment& other);
+
+  void narrow_with(const ForwardAliasTaintEnvironment& other);
+
+  const ForwardAliasEnvironment& alias() const {
+    return alias_;
+  }
+
+  ForwardAliasEnvironment& alias() {
+    return alias_;
+  }
+
+  const ForwardTaintEnvironment& taint() const {
+    return taint_;
+  }
+
+  ForwardTaintEnvironment& taint() {
+    return taint_;
+  }
+
+  friend std::ostream& operator<<(
+      std::ostream& out,
+      const ForwardAliasTaintEnvironment& environment);
+
+ private:
+  ForwardAliasEnvironment alias_;
+  ForwardTaintEnvironment taint_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/ForwardAliasFixpoint.h>
+#include <mariana-trench/ForwardAliasTaintFixpoint.h>
+#include <mariana-trench/Log.h>
+
+namespace marianatrench {
+
+ForwardAliasTaintFixpoint::ForwardAliasTaintFixpoint(
+    MethodContext& context,
+    const cfg::ControlFlowGraph& cfg,
+    InstructionAnalyzer<ForwardAliasEnvironment> alias_instruction_analyzer,
+    InstructionAnalyzer<ForwardTaintEnvironment> taint_instruction_analyzer)
+    : MonotonicFixpointIterator(cfg, cfg.num_blocks()),
+      context_(context),
+      alias_instruction_analyzer_(std::move(alias_instruction_analyzer)),
+      taint_instruction_analyzer_(std::move(taint_instruction_analyzer)) {}
+
+ForwardAliasTaintFixpoint::~ForwardAliasTaintFixpoint() {}
+
+void ForwardAliasTaintFixpoint::analyze_node(
+    const NodeId& block,
+    ForwardAliasTaintEnvironment* environment) const {
+  context_.visit_block();
+  LOG(4, "Analyzing block {}\n{}", block->id(), *environment);
+  for (const auto& instruction : *block) {
+    switch (instruction.type) {
+      case MFLOW_OPCODE:
+        ForwardAliasFixpoint::analyze_instruction(
+            context_,
+            alias_instruction_analyzer_,
+            instruction.insn,
+            &environment->alias());
+        taint_instruction_analyzer_(instruction.insn, &environment->taint());
+        break;
+      case MFLOW_POSITION:
+        environment->alias().set_last_position(instruction.pos.get());
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+ForwardAliasTaintEnvironment ForwardAliasTaintFixpoint::analyze_edge(
+    const EdgeId& /*edge*/,
+    const ForwardAliasTaintEnvironment& environment) const {
+  return environment;
+}
+
+} // namespace marianatrench
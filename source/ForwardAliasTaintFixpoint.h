@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <sparta/MonotonicFixpointIterator.h>
+
+#include <ControlFlow.h>
+#include <InstructionAnalyzer.h>
+
+#include <mariana-trench/ForwardAliasEnvironment.h>
+#include <mariana-trench/ForwardAliasTaintEnvironment.h>
+#include <mariana-trench/ForwardTaintEnvironment.h>
+#include <mariana-trench/MethodContext.h>
+
+namespace marianatrench {
+
+/**
+ * Runs the forward alias and forward taint analyses in a single fixpoint over
+ * their product, instead of walking the control flow graph once per analysis.
+ *
+ * At each instruction, the alias transfer function stores the alias results
+ * of the instruction into `context.aliasing` before the taint transfer
+ * function reads them. The alias environment before a block only depends on
+ * alias environments, hence the alias results are the same as with
+ * `ForwardAliasFixpoint` once the fixpoint is reached.
+ */
+class ForwardAliasTaintFixpoint final
+    : public sparta::MonotonicFixpointIterator<
+          cfg::GraphInterface,
+          ForwardAliasTaintEnvironment> {
+ public:
+  ForwardAliasTaintFixpoint(
+      MethodContext& context,
+      const cfg::ControlFlowGraph& cfg,
+      InstructionAnalyzer<ForwardAliasEnvironment> alias_instruction_analyzer,
+      InstructionAnalyzer<ForwardTaintEnvironment> taint_instruction_analyzer);
+
+  ~ForwardAliasTaintFixpoint();
+
+  void analyze_node(
+      const NodeId& block,
+      ForwardAliasTaintEnvironment* environment) const override;
+
+  ForwardAliasTaintEnvironment analyze_edge(
+      const EdgeId& edge,
+      const ForwardAliasTaintEnvironment& environment) const override;
+
+ private:
+  MethodContext& context_;
+  InstructionAnalyzer<ForwardAliasEnvironment> alias_instruction_analyzer_;
+  InstructionAnalyzer<ForwardTaintEnvironment> taint_instruction_analyzer_;
+};
+
+} // namespace marianatrench
@@ -137,6 +137,9 @@ MemoryLocationsDomain invoke_result_memory_location(
       get_source_constant_arguments(register_memory_locations_map, instruction),
       get_is_this_call(register_memory_locations_map, instruction));
 
+  context->forward_alias_results->callees.insert_or_assign(
+      instruction, alias_callee_summary(context, callee));
+
   if (callee.resolved_base_method &&
       callee.resolved_base_method->returns_void()) {
     return MemoryLocationsDomain::bottom();
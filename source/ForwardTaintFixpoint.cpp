@@ -11,9 +11,11 @@
 namespace marianatrench {
 
 ForwardTaintFixpoint::ForwardTaintFixpoint(
+    const MethodContext& context,
     const cfg::ControlFlowGraph& cfg,
     InstructionAnalyzer<ForwardTaintEnvironment> instruction_analyzer)
     : MonotonicFixpointIterator(cfg, cfg.num_blocks()),
+      context_(context),
       instruction_analyzer_(std::move(instruction_analyzer)) {}
 
 ForwardTaintFixpoint::~ForwardTaintFixpoint() {}
@@ -21,6 +23,7 @@ ForwardTaintFixpoint::~ForwardTaintFixpoint() {}
 void ForwardTaintFixpoint::analyze_node(
     const NodeId& block,
     ForwardTaintEnvironment* taint) const {
+  context_.visit_block();
   LOG(4, "Analyzing block {}\n{}", block->id(), *taint);
   for (const auto& instruction : *block) {
     switch (instruction.type) {
@@ -13,6 +13,7 @@
 #include <InstructionAnalyzer.h>
 
 #include <mariana-trench/ForwardTaintEnvironment.h>
+#include <mariana-trench/MethodContext.h>
 
 namespace marianatrench {
 
@@ -21,6 +22,7 @@ class ForwardTaintFixpoint final : public sparta::MonotonicFixpointIterator<
                                        ForwardTaintEnvironment> {
  public:
   ForwardTaintFixpoint(
+      const MethodContext& context,
       const cfg::ControlFlowGraph& cfg,
       InstructionAnalyzer<ForwardTaintEnvironment> instruction_analyzer);
 
@@ -34,6 +36,7 @@ class ForwardTaintFixpoint final : public sparta::MonotonicFixpointIterator<
       const ForwardTaintEnvironment& taint) const override;
 
  private:
+  const MethodContext& context_;
   InstructionAnalyzer<ForwardTaintEnvironment> instruction_analyzer_;
 };
 
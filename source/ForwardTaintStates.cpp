@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <set>
+#include <unordered_set>
+
+#include <IRCode.h>
+
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/ForwardTaintStates.h>
+#include <mariana-trench/Log.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Visits of a block after which its entry state is widened.
+constexpr std::size_t k_widening_visits = 5;
+
+/* Snapshots of the callee models read when analyzing the instruction. */
+std::vector<std::shared_ptr<const Model>> callee_models(
+    const MethodContext& context,
+    const IRInstruction* instruction) {
+  std::vector<std::shared_ptr<const Model>> models;
+  auto add_call_target = [&context, &models](const CallTarget& call_target) {
+    if (!call_target.resolved()) {
+      return;
+    }
+    models.push_back(
+        context.registry.get_snapshot(call_target.resolved_base_callee()));
+    if (call_target.is_virtual()) {
+      for (const auto* override : call_target.overrides()) {
+        models.push_back(context.registry.get_snapshot(override));
+      }
+    }
+  };
+
+  const auto* method = context.method();
+  if (opcode::is_an_invoke(instruction->opcode())) {
+    add_call_target(context.call_graph.callee(method, instruction));
+  }
+  for (const auto& artificial_callee :
+       context.call_graph.artificial_callees(method, instruction)) {
+    add_call_target(artificial_callee.call_target);
+  }
+  return models;
+}
+
+bool is_returning(const cfg::Block* block) {
+  for (const auto& entry : InstructionIterable(block)) {
+    if (opcode::is_a_return(entry.insn->opcode())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+bool ForwardTaintStates::run(
+    MethodContext& context,
+    const cfg::ControlFlowGraph& cfg,
+    ForwardTaintFixpoint& fixpoint) {
+  // Models are snapshotted before the fixpoint reads them, so that a callee
+  // model changing during the analysis is seen as changed by the next one.
+  std::unordered_map<
+      const IRInstruction*,
+      std::vector<std::shared_ptr<const Model>>>
+      models;
+  for (const auto* block : cfg.blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      auto instruction_models = callee_models(context, entry.insn);
+      if (!instruction_models.empty()) {
+        models.emplace(entry.insn, std::move(instruction_models));
+      }
+    }
+  }
+
+  // Calls read the call effect sources of the method, hence any call may be
+  // affected when they change.
+  bool incremental = !entry_states_.empty() &&
+      context.previous_model.call_effect_sources().equals(call_effect_sources_);
+  if (incremental) {
+    run_incremental(context, cfg, fixpoint, models);
+  } else {
+    fixpoint.run(ForwardTaintEnvironment::initial());
+    entry_states_.clear();
+    exit_states_.clear();
+    for (auto* block : cfg.blocks()) {
+      entry_states_.emplace(block, fixpoint.get_entry_state_at(block));
+      exit_states_.emplace(block, fixpoint.get_exit_state_at(block));
+    }
+  }
+
+  callee_models_ = std::move(models);
+  call_effect_sources_ = context.previous_model.call_effect_sources();
+  fulfilled_partial_sinks_ = context.fulfilled_partial_sinks;
+  return incremental;
+}
+
+void ForwardTaintStates::run_incremental(
+    MethodContext& context,
+    const cfg::ControlFlowGraph& cfg,
+    const ForwardTaintFixpoint& fixpoint,
+    const std::unordered_map<
+        const IRInstruction*,
+        std::vector<std::shared_ptr<const Model>>>& callee_models) {
+  // Blocks are identified by their id, so that they are visited in order.
+  std::set<cfg::BlockId> worklist;
+  std::unordered_map<cfg::BlockId, cfg::Block*> blocks;
+  for (auto* block : cfg.blocks()) {
+    blocks.emplace(block->id(), block);
+    bool affected = block == cfg.entry_block() || is_returning(block);
+    for (const auto& entry : InstructionIterable(block)) {
+      auto previous_models = callee_models_.find(entry.insn);
+      auto models = callee_models.find(entry.insn);
+      if (models != callee_models.end() &&
+          (previous_models == callee_models_.end() ||
+           previous_models->second != models->second)) {
+        affected = true;
+      }
+    }
+    if (affected) {
+      worklist.insert(block->id());
+    }
+  }
+  LOG(5,
+      "Re-analyzing {} out of {} blocks of `{}`",
+      worklist.size(),
+      cfg.num_blocks(),
+      context.method()->show());
+
+  context.fulfilled_partial_sinks = fulfilled_partial_sinks_;
+  std::unordered_map<cfg::BlockId, std::size_t> visits;
+  while (!worklist.empty()) {
+    auto* block = blocks.at(*worklist.begin());
+    worklist.erase(worklist.begin());
+
+    auto entry_state = block == cfg.entry_block()
+        ? ForwardTaintEnvironment::initial()
+        : ForwardTaintEnvironment::bottom();
+    for (const auto* edge : block->preds()) {
+      entry_state.join_with(
+          fixpoint.analyze_edge(edge, exit_states_.at(edge->src())));
+    }
+    auto& block_entry_state = entry_states_.at(block);
+    if (++visits[block->id()] > k_widening_visits) {
+      block_entry_state.widen_with(entry_state);
+    } else {
+      block_entry_state = std::move(entry_state);
+    }
+
+    auto exit_state = block_entry_state;
+    fixpoint.analyze_node(block, &exit_state);
+    auto& block_exit_state = exit_states_.at(block);
+    if (exit_state.equals(block_exit_state)) {
+      continue;
+    }
+    block_exit_state = std::move(exit_state);
+    for (const auto* edge : block->succs()) {
+      worklist.insert(edge->target()->id());
+    }
+  }
+}
+
+} // namespace marianatrench
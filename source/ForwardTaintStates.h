@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ControlFlow.h>
+#include <IRInstruction.h>
+
+#include <mariana-trench/ForwardTaintEnvironment.h>
+#include <mariana-trench/ForwardTaintFixpoint.h>
+#include <mariana-trench/FulfilledPartialKindResults.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/MethodContext.h>
+#include <mariana-trench/Model.h>
+
+namespace marianatrench {
+
+/**
+ * States of the forward taint fixpoint of a method, kept across its analyses
+ * with `--incremental-reanalysis`, along with the callee models it read.
+ *
+ * Since the states refer to memory locations of the forward alias analysis,
+ * they are only valid along with the forward alias results they were computed
+ * with. When the method is analyzed again, the fixpoint restarts from the
+ * blocks reading a callee model that changed, and from the entry block and
+ * the returning blocks, which read the previous model of the method. States
+ * of other blocks are reused until the states before them change.
+ *
+ * Taint found in the blocks that are not analyzed again is already part of
+ * the previous model, which the new model is joined with.
+ */
+class ForwardTaintStates final {
+ public:
+  /* Keep the states of methods with at least this many blocks. */
+  static constexpr std::size_t k_minimum_blocks = 16;
+
+  ForwardTaintStates() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ForwardTaintStates)
+
+  /**
+   * Run the fixpoint and keep its states. When states of a previous run are
+   * kept, only the affected blocks are analyzed. Return whether the run was
+   * incremental.
+   */
+  bool run(
+      MethodContext& context,
+      const cfg::ControlFlowGraph& cfg,
+      ForwardTaintFixpoint& fixpoint);
+
+ private:
+  void run_incremental(
+      MethodContext& context,
+      const cfg::ControlFlowGraph& cfg,
+      const ForwardTaintFixpoint& fixpoint,
+      const std::unordered_map<
+          const IRInstruction*,
+          std::vector<std::shared_ptr<const Model>>>& callee_models);
+
+ private:
+  std::unordered_map<cfg::Block*, ForwardTaintEnvironment> entry_states_;
+  std::unordered_map<cfg::Block*, ForwardTaintEnvironment> exit_states_;
+  std::unordered_map<
+      const IRInstruction*,
+      std::vector<std::shared_ptr<const Model>>>
+      callee_models_;
+  TaintAccessPathTree call_effect_sources_;
+  FulfilledPartialKindResults fulfilled_partial_sinks_;
+};
+
+} // namespace marianatrench
@@ -77,6 +77,10 @@ bool ForwardTaintTransfer::analyze_iget(
     ForwardTaintEnvironment* environment) {
   log_instruction(context, instruction);
 
+  if (!context->registry.may_have_field_model(instruction->get_field())) {
+    return false;
+  }
+
   const auto field_target =
       context->call_graph.resolved_field_access(context->method(), instruction);
   if (!field_target) {
@@ -514,58 +518,110 @@ void check_sources_sinks_flows(
     return;
   }
 
-  auto sources_by_kind = sources.partition_by_kind();
-  auto sinks_by_kind = sinks.partition_by_kind();
-  for (auto& [source_kind, source_taint] : sources_by_kind) {
-    for (auto& [sink_kind, sink_taint] : sinks_by_kind) {
-      source_taint.intersect_intervals_with(sink_taint);
-      sink_taint.intersect_intervals_with(source_taint);
-      if (source_taint.is_bottom() || sink_taint.is_bottom()) {
-        // Intervals do not intersect, flow is not possible.
+  const auto& rules = context->rules;
+  // Kinds without rules are discarded before copying their frames, and pairs
+  // of kinds without rules before intersecting intervals.
+  auto has_rules = [&rules](const Kind* kind) {
+    return rules.kind_index(kind).has_value();
+  };
+  auto sinks_by_kind = sinks.partition_by_kind_if(has_rules);
+  if (sinks_by_kind.empty()) {
+    return;
+  }
+  auto sources_by_kind = sources.partition_by_kind_if(has_rules);
+
+  struct SinkKindTaint {
+    const Kind* kind;
+    const Taint* taint;
+    std::size_t index;
+  };
+  std::vector<SinkKindTaint> indexed_sinks;
+  indexed_sinks.reserve(sinks_by_kind.size());
+  for (const auto& [sink_kind, sink_taint] : sinks_by_kind) {
+    indexed_sinks.push_back(
+        SinkKindTaint{sink_kind, &sink_taint, *rules.kind_index(sink_kind)});
+  }
+
+  for (const auto& [source_kind, source_taint] : sources_by_kind) {
+    auto source_index = rules.kind_index(source_kind);
+    for (const auto& indexed_sink : indexed_sinks) {
+      const auto* sink_kind = indexed_sink.kind;
+      const auto* MT_NULLABLE partial_sink = fulfilled_partial_sinks != nullptr
+          ? sink_kind->as<PartialKind>()
+          : nullptr;
+      bool may_have_rules =
+          rules.may_have_rules(*source_index, indexed_sink.index);
+      bool may_have_partial_rules = partial_sink != nullptr &&
+          rules.may_have_partial_rules(*source_index, indexed_sink.index);
+      if (!may_have_rules && !may_have_partial_rules) {
         continue;
       }
+
+      auto flow_source_taint = source_taint;
+      auto flow_sink_taint = *indexed_sink.taint;
+      if (context->class_intervals.enabled()) {
+        flow_source_taint.intersect_intervals_with(*indexed_sink.taint);
+        flow_sink_taint.intersect_intervals_with(flow_source_taint);
+        if (flow_source_taint.is_bottom() || flow_sink_taint.is_bottom()) {
+          // Intervals do not intersect, flow is not possible.
+          continue;
+        }
+      }
       // Check if this satisfies any rule. If so, create the issue.
-      const auto& rules = context->rules.rules(source_kind, sink_kind);
-      for (const auto* rule : rules) {
-        create_issue(
-            context,
-            source_taint,
-            sink_taint,
-            rule,
-            position,
-            sink_index,
-            callee,
-            extra_features);
+      if (may_have_rules) {
+        for (const auto* rule : rules.rules(source_kind, sink_kind)) {
+          create_issue(
+              context,
+              flow_source_taint,
+              flow_sink_taint,
+              rule,
+              position,
+              sink_index,
+              callee,
+              extra_features);
+        }
       }
 
       // Check if this satisfies any partial (multi-source/sink) rule.
-      if (fulfilled_partial_sinks != nullptr) {
-        const auto* MT_NULLABLE partial_sink = sink_kind->as<PartialKind>();
-        if (partial_sink != nullptr) {
-          const auto& partial_rules =
-              context->rules.partial_rules(source_kind, partial_sink);
-          for (const auto* partial_rule : partial_rules) {
-            check_multi_source_multi_sink_rules(
-                context,
-                source_kind,
-                source_taint,
-                partial_sink,
-                sink_taint,
-                *fulfilled_partial_sinks,
-                partial_rule,
-                position,
-                // TODO(T120190935) Add the ability to hold multiple callee
-                // ports per issue handle for multi-source multi-sink rules.
-                sink_index,
-                callee,
-                extra_features);
-          }
+      if (may_have_partial_rules) {
+        const auto& partial_rules =
+            rules.partial_rules(source_kind, partial_sink);
+        for (const auto* partial_rule : partial_rules) {
+          check_multi_source_multi_sink_rules(
+              context,
+              source_kind,
+              flow_source_taint,
+              partial_sink,
+              flow_sink_taint,
+              *fulfilled_partial_sinks,
+              partial_rule,
+              position,
+              // TODO(T120190935) Add the ability to hold multiple callee
+              // ports per issue handle for multi-source multi-sink rules.
+              sink_index,
+              callee,
+              extra_features);
         }
       }
     }
   }
 }
 
+/* Return whether each argument of the call may hold taint. */
+std::vector<bool> get_tainted_arguments(
+    const InstructionAliasResults& aliasing,
+    const ForwardTaintEnvironment* environment,
+    const IRInstruction* instruction) {
+  std::vector<bool> tainted_arguments;
+  tainted_arguments.reserve(instruction->srcs_size());
+  for (auto register_id : instruction->srcs()) {
+    tainted_arguments.push_back(
+        !environment->read(aliasing.register_memory_locations(register_id))
+             .is_bottom());
+  }
+  return tainted_arguments;
+}
+
 void check_call_flows(
     MethodContext* context,
     const InstructionAliasResults& aliasing,
@@ -602,8 +658,8 @@ void check_call_flows(
         callee.position,
         /* sink_index */ callee.call_index,
         /* callee */ callee.resolved_base_method
-            ? callee.resolved_base_method->show()
-            : std::string(k_unresolved_callee),
+            ? std::string_view(callee.resolved_base_method->show())
+            : k_unresolved_callee,
         extra_features,
         fulfilled_partial_sinks);
   }
@@ -786,8 +842,8 @@ void check_call_effect_flows(
           callee.position,
           callee.call_index,
           /* sink_index */ callee.resolved_base_method
-              ? callee.resolved_base_method->show()
-              : std::string(k_unresolved_callee),
+              ? std::string_view(callee.resolved_base_method->show())
+              : k_unresolved_callee,
           /* extra features */ {},
           /* fulfilled partial sinks */ nullptr);
     }
@@ -834,7 +890,8 @@ bool ForwardTaintTransfer::analyze_invoke(
       aliasing.position(),
       get_source_register_types(context, instruction),
       source_constant_arguments,
-      get_is_this_call(aliasing.register_memory_locations_map(), instruction));
+      get_is_this_call(aliasing.register_memory_locations_map(), instruction),
+      get_tainted_arguments(aliasing, environment, instruction));
 
   const ForwardTaintEnvironment previous_environment = *environment;
 
@@ -921,7 +978,8 @@ void check_flows_to_field_sink(
       opcode::is_an_sput(instruction->opcode()) ||
       opcode::is_an_iput(instruction->opcode()));
 
-  if (source_taint.is_bottom()) {
+  if (source_taint.is_bottom() ||
+      !context->registry.may_have_field_model(instruction->get_field())) {
     return;
   }
 
@@ -1224,10 +1282,10 @@ bool ForwardTaintTransfer::analyze_const_string(
     ForwardTaintEnvironment* environment) {
   log_instruction(context, instruction);
 
-  const std::string_view literal{instruction->get_string()->str()};
   const auto& aliasing = context->aliasing.get(instruction);
 
-  auto sources = context->literal_sources_at_callsite(literal, aliasing);
+  auto sources = context->literal_sources_at_callsite(
+      instruction->get_string(), aliasing);
   if (sources.empty()) {
     return false;
   }
@@ -1278,7 +1336,7 @@ bool ForwardTaintTransfer::analyze_return(
           sinks,
           position,
           /* sink_index */ return_index,
-          /* callee */ std::string(k_return_callee),
+          /* callee */ k_return_callee,
           /* extra_features */ {},
           /* fulfilled_partial_sinks */ nullptr);
     }
@@ -33,40 +33,78 @@ Frame::Frame(const TaintConfig& config)
           config.output_paths(),
           config.extra_traces()) {}
 
+Frame::Data& Frame::mutable_data() {
+  if (data_ == nullptr) {
+    data_ = std::make_shared<Data>();
+  } else if (data_.use_count() > 1) {
+    data_ = std::make_shared<Data>(*data_);
+  }
+  return *data_;
+}
+
+bool Frame::Data::operator==(const Data& other) const {
+  return class_interval_context == other.class_interval_context &&
+      distance == other.distance && origins == other.origins &&
+      inferred_features == other.inferred_features &&
+      user_features == other.user_features &&
+      via_type_of_ports == other.via_type_of_ports &&
+      via_value_of_ports == other.via_value_of_ports &&
+      canonical_names == other.canonical_names &&
+      output_paths == other.output_paths && extra_traces == other.extra_traces;
+}
+
+const Frame::Data& Frame::empty_data() {
+  static const Data empty;
+  return empty;
+}
+
 void Frame::add_origin(const Method* method, const AccessPath* port) {
-  origins_.add(OriginFactory::singleton().method_origin(method, port));
+  mutable_data().origins.add(
+      OriginFactory::singleton().method_origin(method, port));
 }
 
 void Frame::add_origin(const Field* field) {
-  origins_.add(OriginFactory::singleton().field_origin(field));
+  mutable_data().origins.add(OriginFactory::singleton().field_origin(field));
 }
 
 void Frame::add_origin(std::string_view literal) {
-  origins_.add(OriginFactory::singleton().string_origin(literal));
+  mutable_data().origins.add(OriginFactory::singleton().string_origin(literal));
 }
 
 void Frame::add_inferred_features(const FeatureMayAlwaysSet& features) {
-  inferred_features_.add(features);
+  mutable_data().inferred_features.add(features);
 }
 
 void Frame::add_user_features(const FeatureSet& features) {
-  user_features_.join_with(features);
+  mutable_data().user_features.join_with(features);
+}
+
+void Frame::drop_inferred_features() {
+  if (data().inferred_features.is_bottom()) {
+    return;
+  }
+  mutable_data().inferred_features = FeatureMayAlwaysSet::bottom();
 }
 
 FeatureMayAlwaysSet Frame::features() const {
-  auto features = inferred_features_;
+  const auto& data = this->data();
+  auto features = data.inferred_features;
 
   if (features.is_bottom()) {
-    return FeatureMayAlwaysSet::make_always(user_features_);
+    return FeatureMayAlwaysSet::make_always(data.user_features);
   }
 
-  features.add_always(user_features_);
+  if (data.user_features.empty()) {
+    return features;
+  }
+
+  features.add_always(data.user_features);
   mt_assert(!features.is_bottom());
   return features;
 }
 
 void Frame::add_extra_trace(ExtraTrace&& extra_trace) {
-  extra_traces_.add(std::move(extra_trace));
+  mutable_data().extra_traces.add(extra_trace);
 }
 
 bool Frame::leq(const Frame& other) const {
@@ -74,36 +112,35 @@ bool Frame::leq(const Frame& other) const {
     return true;
   } else if (other.is_bottom()) {
     return false;
+  } else if (kind_ != other.kind_) {
+    return false;
+  } else if (data_ == other.data_) {
+    return true;
   } else {
-    return kind_ == other.kind_ && distance_ >= other.distance_ &&
-        class_interval_context_ == other.class_interval_context_ &&
-        origins_.leq(other.origins_) &&
-        inferred_features_.leq(other.inferred_features_) &&
-        user_features_.leq(other.user_features_) &&
-        via_type_of_ports_.leq(other.via_type_of_ports_) &&
-        via_value_of_ports_.leq(other.via_value_of_ports_) &&
-        canonical_names_.leq(other.canonical_names_) &&
-        output_paths_.leq(other.output_paths_) &&
-        extra_traces_.leq(other.extra_traces_);
+    const auto& data = this->data();
+    const auto& other_data = other.data();
+    return data.distance >= other_data.distance &&
+        data.class_interval_context == other_data.class_interval_context &&
+        data.origins.leq(other_data.origins) &&
+        data.inferred_features.leq(other_data.inferred_features) &&
+        data.user_features.leq(other_data.user_features) &&
+        data.via_type_of_ports.leq(other_data.via_type_of_ports) &&
+        data.via_value_of_ports.leq(other_data.via_value_of_ports) &&
+        data.canonical_names.leq(other_data.canonical_names) &&
+        data.output_paths.leq(other_data.output_paths) &&
+        data.extra_traces.leq(other_data.extra_traces);
   }
 }
 
 bool Frame::equals(const Frame& other) const {
   if (is_bottom()) {
     return other.is_bottom();
-  } else if (other.is_bottom()) {
+  } else if (kind_ != other.kind_) {
     return false;
+  } else if (data_ == other.data_) {
+    return true;
   } else {
-    return kind_ == other.kind_ &&
-        class_interval_context_ == other.class_interval_context_ &&
-        distance_ == other.distance_ && origins_ == other.origins_ &&
-        inferred_features_ == other.inferred_features_ &&
-        user_features_ == other.user_features_ &&
-        via_type_of_ports_ == other.via_type_of_ports_ &&
-        via_value_of_ports_ == other.via_value_of_ports_ &&
-        canonical_names_ == other.canonical_names_ &&
-        output_paths_ == other.output_paths_ &&
-        extra_traces_ == other.extra_traces_;
+    return data() == other.data();
   }
 }
 
@@ -114,26 +151,31 @@ void Frame::join_with(const Frame& other) {
     *this = other;
   } else if (other.is_bottom()) {
     return;
+  } else if (data_ == other.data_) {
+    mt_assert(kind_ == other.kind_);
   } else {
     mt_assert(kind_ == other.kind_);
-    mt_assert(class_interval_context_ == other.class_interval_context_);
-
-    distance_ = std::min(distance_, other.distance_);
-    origins_.join_with(other.origins_);
-    inferred_features_.join_with(other.inferred_features_);
-    user_features_.join_with(other.user_features_);
-    via_type_of_ports_.join_with(other.via_type_of_ports_);
-    via_value_of_ports_.join_with(other.via_value_of_ports_);
-    canonical_names_.join_with(other.canonical_names_);
-
-    output_paths_.join_with(other.output_paths_);
+    mt_assert(class_interval_context() == other.class_interval_context());
+
+    const auto& other_data = other.data();
+    auto& data = mutable_data();
+    data.distance = std::min(data.distance, other_data.distance);
+    data.origins.join_with(other_data.origins);
+    data.inferred_features.join_with(other_data.inferred_features);
+    data.user_features.join_with(other_data.user_features);
+    data.via_type_of_ports.join_with(other_data.via_type_of_ports);
+    data.via_value_of_ports.join_with(other_data.via_value_of_ports);
+    data.canonical_names.join_with(other_data.canonical_names);
+
+    data.output_paths.join_with(other_data.output_paths);
     // Approximate the output paths here to avoid storing very large trees
     // during the analysis of a method.
-    output_paths_.collapse_deeper_than(
+    data.output_paths.collapse_deeper_than(
         Heuristics::kPropagationMaxOutputPathSize);
-    output_paths_.limit_leaves(Heuristics::kPropagationMaxOutputPathLeaves);
+    data.output_paths.limit_leaves(
+        Heuristics::kPropagationMaxOutputPathLeaves);
 
-    extra_traces_.join_with(other.extra_traces_);
+    data.extra_traces.join_with(other_data.extra_traces);
   }
 
   mt_expensive_assert(previous.leq(*this) && other.leq(*this));
@@ -169,46 +211,25 @@ Frame Frame::update_with_propagation_trace(
     const Frame& propagation_frame) const {
   return Frame(
       kind_,
-      class_interval_context_,
-      propagation_frame.distance_,
-      propagation_frame.origins_,
-      inferred_features_,
+      class_interval_context(),
+      propagation_frame.distance(),
+      propagation_frame.origins(),
+      inferred_features(),
       /* user_features */ FeatureSet::bottom(),
       /* via_type_of_ports */ {},
       /* via_value_of_ports */ {},
       /* canonical_names */ {},
-      output_paths_,
-      extra_traces_);
+      output_paths(),
+      extra_traces());
 }
 
 Frame Frame::apply_transform(
     const KindFactory& kind_factory,
-    const TransformsFactory& transforms_factory,
     const UsedKinds& used_kinds,
     const TransformList* local_transforms) const {
-  const Kind* base_kind = kind_;
-  const TransformList* global_transforms = nullptr;
-
-  if (const auto* transform_kind = kind_->as<TransformKind>()) {
-    // If the current kind is already a TransformKind, append existing
-    // local_transforms.
-    local_transforms = transforms_factory.concat(
-        local_transforms, transform_kind->local_transforms());
-    global_transforms = transform_kind->global_transforms();
-    base_kind = transform_kind->base_kind();
-  } else if (kind_->is<PropagationKind>()) {
-    // If the current kind is PropagationKind, set the transform as a global
-    // transform. This is done to track the next hops for propagation with
-    // trace.
-    global_transforms = local_transforms;
-    local_transforms = nullptr;
-  }
-
-  mt_assert(base_kind != nullptr);
-  const auto* new_kind = kind_factory.transform_kind(
-      base_kind, local_transforms, global_transforms);
-
-  if (!used_kinds.should_keep(new_kind)) {
+  const auto* new_kind =
+      used_kinds.transform_kind(kind_factory, kind_, local_transforms);
+  if (new_kind == nullptr) {
     return Frame::bottom();
   }
 
@@ -218,10 +239,7 @@ Frame Frame::apply_transform(
 }
 
 std::vector<const Feature*> Frame::materialize_via_type_of_ports(
-    const Method* callee,
-    const FeatureFactory* feature_factory,
-    const std::vector<const DexType * MT_NULLABLE>& source_register_types)
-    const {
+    const CallSitePropagation& call_site) const {
   std::vector<const Feature*> features_added;
   if (via_type_of_ports().is_bottom()) {
     return features_added;
@@ -233,27 +251,24 @@ std::vector<const Feature*> Frame::materialize_via_type_of_ports(
   // Materialize via_type_of_ports into features and add them to the inferred
   // features
   for (const auto& port : via_type_of_ports()) {
-    if (!port.is_argument() ||
-        port.parameter_position() >= source_register_types.size()) {
+    const auto* feature = port.is_argument()
+        ? call_site.via_type_of_feature(port.parameter_position())
+        : nullptr;
+    if (feature == nullptr) {
       ERROR(
           1,
           "Invalid port {} provided for via_type_of ports of method {}",
           port,
-          callee->show());
+          call_site.callee()->show());
       continue;
     }
-    const auto* feature = feature_factory->get_via_type_of_feature(
-        source_register_types[port.parameter_position()]);
     features_added.push_back(feature);
   }
   return features_added;
 }
 
 std::vector<const Feature*> Frame::materialize_via_value_of_ports(
-    const Method* callee,
-    const FeatureFactory* feature_factory,
-    const std::vector<std::optional<std::string>>& source_constant_arguments)
-    const {
+    const CallSitePropagation& call_site) const {
   std::vector<const Feature*> features_added;
   if (via_value_of_ports().is_bottom()) {
     return features_added;
@@ -265,17 +280,17 @@ std::vector<const Feature*> Frame::materialize_via_value_of_ports(
   // Materialize via_value_of_ports into features and add them to the inferred
   // features
   for (const auto& port : via_value_of_ports().elements()) {
-    if (!port.is_argument() ||
-        port.parameter_position() >= source_constant_arguments.size()) {
+    const auto* feature = port.is_argument()
+        ? call_site.via_value_of_feature(port.parameter_position())
+        : nullptr;
+    if (feature == nullptr) {
       ERROR(
           1,
           "Invalid port {} provided for via_value_of ports of method {}",
           port,
-          callee->show());
+          call_site.callee()->show());
       continue;
     }
-    const auto* feature = feature_factory->get_via_value_of_feature(
-        source_constant_arguments[port.parameter_position()]);
     features_added.push_back(feature);
   }
   return features_added;
@@ -283,7 +298,7 @@ std::vector<const Feature*> Frame::materialize_via_value_of_ports(
 
 void Frame::append_to_propagation_output_paths(Path::Element path_element) {
   PathTreeDomain new_output_paths;
-  for (const auto& [path, collapse_depth] : output_paths_.elements()) {
+  for (const auto& [path, collapse_depth] : output_paths().elements()) {
     if (collapse_depth.is_zero()) {
       new_output_paths.write(path, collapse_depth, UpdateKind::Weak);
     } else {
@@ -293,14 +308,15 @@ void Frame::append_to_propagation_output_paths(Path::Element path_element) {
       new_output_paths.write(new_path, new_collapse_depth, UpdateKind::Weak);
     }
   }
-  output_paths_ = std::move(new_output_paths);
-  output_paths_.collapse_deeper_than(Heuristics::kPropagationMaxOutputPathSize);
-  output_paths_.limit_leaves(Heuristics::kPropagationMaxOutputPathLeaves);
+  auto& output_paths = mutable_data().output_paths;
+  output_paths = std::move(new_output_paths);
+  output_paths.collapse_deeper_than(Heuristics::kPropagationMaxOutputPathSize);
+  output_paths.limit_leaves(Heuristics::kPropagationMaxOutputPathLeaves);
 }
 
 void Frame::update_maximum_collapse_depth(
     CollapseDepth maximum_collapse_depth) {
-  output_paths_.transform(
+  mutable_data().output_paths.transform(
       [maximum_collapse_depth](CollapseDepth collapse_depth) {
         return CollapseDepth(
             std::min(collapse_depth.value(), maximum_collapse_depth.value()));
@@ -309,13 +325,14 @@ void Frame::update_maximum_collapse_depth(
 
 Frame Frame::with_origins(OriginSet origins) const {
   auto copy = *this;
-  copy.origins_ = std::move(origins);
+  copy.mutable_data().origins = std::move(origins);
   return copy;
 }
 
 Json::Value Frame::to_json(
     const CallInfo& call_info,
     ExportOriginsMode export_origins_mode) const {
+  const auto& data = this->data();
   auto value = Json::Value(Json::objectValue);
 
   mt_assert(kind_ != nullptr);
@@ -325,14 +342,14 @@ Json::Value Frame::to_json(
     value[member] = kind_json[member];
   }
 
-  if (distance_ != 0) {
-    value["distance"] = Json::Value(distance_);
+  if (data.distance != 0) {
+    value["distance"] = Json::Value(data.distance);
   }
 
-  if (!origins_.empty()) {
+  if (!data.origins.empty()) {
     if (call_info.call_kind().is_origin() ||
         export_origins_mode == ExportOriginsMode::Always) {
-      value["origins"] = origins_.to_json();
+      value["origins"] = data.origins.to_json();
     }
   }
 
@@ -341,33 +358,35 @@ Json::Value Frame::to_json(
   auto all_features = features();
   JsonValidation::update_object(value, all_features.to_json());
 
-  if (!via_type_of_ports_.is_bottom()) {
+  if (!data.via_type_of_ports.is_bottom()) {
     auto ports = Json::Value(Json::arrayValue);
-    for (const auto& root : via_type_of_ports_) {
+    for (const auto& root : data.via_type_of_ports) {
       ports.append(root.to_json());
     }
     value["via_type_of"] = ports;
   }
 
-  if (!via_value_of_ports_.is_bottom()) {
+  if (!data.via_value_of_ports.is_bottom()) {
     auto ports = Json::Value(Json::arrayValue);
-    for (const auto& root : via_value_of_ports_) {
+    for (const auto& root : data.via_value_of_ports) {
       ports.append(root.to_json());
     }
     value["via_value_of"] = ports;
   }
 
-  if (canonical_names_.is_value() && !canonical_names_.elements().empty()) {
+  if (data.canonical_names.is_value() &&
+      !data.canonical_names.elements().empty()) {
     auto canonical_names = Json::Value(Json::arrayValue);
-    for (const auto& canonical_name : canonical_names_.elements()) {
+    for (const auto& canonical_name : data.canonical_names.elements()) {
       canonical_names.append(canonical_name.to_json());
     }
     value["canonical_names"] = canonical_names;
   }
 
-  if (!output_paths_.is_bottom()) {
+  if (!data.output_paths.is_bottom()) {
     auto output_paths_value = Json::Value(Json::objectValue);
-    for (const auto& [output_path, collapse_depth] : output_paths_.elements()) {
+    for (const auto& [output_path, collapse_depth] :
+         data.output_paths.elements()) {
       // Convert to int64_t because `Json::Value` represents signed and
       // unsigned integers differently.
       output_paths_value[output_path.to_string()] =
@@ -376,17 +395,17 @@ Json::Value Frame::to_json(
     value["output_paths"] = output_paths_value;
   }
 
-  if (!class_interval_context_.is_default()) {
-    auto interval_json = class_interval_context_.to_json();
+  if (!data.class_interval_context.is_default()) {
+    auto interval_json = data.class_interval_context.to_json();
     for (const auto& member : interval_json.getMemberNames()) {
       value[member] = interval_json[member];
     }
   }
 
-  if (extra_traces_.is_value() && !extra_traces_.elements().empty()) {
+  if (!data.extra_traces.empty()) {
     auto extra_traces = Json::Value(Json::arrayValue);
-    for (const auto& extra_trace : extra_traces_.elements()) {
-      extra_traces.append(extra_trace.to_json());
+    for (const auto* extra_trace : data.extra_traces) {
+      extra_traces.append(extra_trace->to_json());
     }
     value["extra_traces"] = extra_traces;
   }
@@ -394,37 +413,116 @@ Json::Value Frame::to_json(
   return value;
 }
 
+void Frame::write_json(
+    JsonWriter& writer,
+    const CallInfo& call_info,
+    ExportOriginsMode export_origins_mode) const {
+  const auto& data = this->data();
+  writer.begin_object();
+
+  mt_assert(kind_ != nullptr);
+  writer.members(kind_->to_json());
+
+  if (data.distance != 0) {
+    writer.key("distance").value(data.distance);
+  }
+
+  if (!data.origins.empty()) {
+    if (call_info.call_kind().is_origin() ||
+        export_origins_mode == ExportOriginsMode::Always) {
+      writer.key("origins").value(data.origins.to_json());
+    }
+  }
+
+  // For output purposes, user features and inferred features are not
+  // differentiated.
+  features().write_json_members(writer);
+
+  if (!data.via_type_of_ports.is_bottom()) {
+    writer.key("via_type_of");
+    writer.begin_array();
+    for (const auto& root : data.via_type_of_ports) {
+      writer.value(root.to_json());
+    }
+    writer.end_array();
+  }
+
+  if (!data.via_value_of_ports.is_bottom()) {
+    writer.key("via_value_of");
+    writer.begin_array();
+    for (const auto& root : data.via_value_of_ports) {
+      writer.value(root.to_json());
+    }
+    writer.end_array();
+  }
+
+  if (data.canonical_names.is_value() &&
+      !data.canonical_names.elements().empty()) {
+    writer.key("canonical_names");
+    writer.begin_array();
+    for (const auto& canonical_name : data.canonical_names.elements()) {
+      writer.value(canonical_name.to_json());
+    }
+    writer.end_array();
+  }
+
+  if (!data.output_paths.is_bottom()) {
+    writer.key("output_paths");
+    writer.begin_object();
+    for (const auto& [output_path, collapse_depth] :
+         data.output_paths.elements()) {
+      writer.key(output_path.to_string())
+          .value(static_cast<std::int64_t>(collapse_depth.value()));
+    }
+    writer.end_object();
+  }
+
+  if (!data.class_interval_context.is_default()) {
+    writer.members(data.class_interval_context.to_json());
+  }
+
+  if (!data.extra_traces.empty()) {
+    writer.key("extra_traces");
+    writer.begin_array();
+    for (const auto* extra_trace : data.extra_traces) {
+      writer.value(extra_trace->to_json());
+    }
+    writer.end_array();
+  }
+
+  writer.end_object();
+}
+
 std::ostream& operator<<(std::ostream& out, const Frame& frame) {
   out << "Frame(kind=`" << show(frame.kind_);
-  out << ", class_interval_context=" << show(frame.class_interval_context_);
-  if (frame.distance_ != 0) {
-    out << ", distance=" << frame.distance_;
+  out << ", class_interval_context=" << show(frame.class_interval_context());
+  if (frame.distance() != 0) {
+    out << ", distance=" << frame.distance();
   }
-  if (!frame.origins_.empty()) {
-    out << ", origins=" << frame.origins_;
+  if (!frame.origins().empty()) {
+    out << ", origins=" << frame.origins();
   }
-  if (!frame.inferred_features_.empty()) {
-    out << ", inferred_features=" << frame.inferred_features_;
+  if (!frame.inferred_features().empty()) {
+    out << ", inferred_features=" << frame.inferred_features();
   }
-  if (!frame.user_features_.empty()) {
-    out << ", user_features=" << frame.user_features_;
+  if (!frame.user_features().empty()) {
+    out << ", user_features=" << frame.user_features();
   }
-  if (!frame.via_type_of_ports_.is_bottom()) {
-    out << ", via_type_of_ports=" << frame.via_type_of_ports_.elements();
+  if (!frame.via_type_of_ports().is_bottom()) {
+    out << ", via_type_of_ports=" << frame.via_type_of_ports().elements();
   }
-  if (!frame.via_value_of_ports_.is_bottom()) {
-    out << ", via_value_of_ports=" << frame.via_value_of_ports_.elements();
+  if (!frame.via_value_of_ports().is_bottom()) {
+    out << ", via_value_of_ports=" << frame.via_value_of_ports().elements();
   }
-  if (frame.canonical_names_.is_value() &&
-      !frame.canonical_names_.elements().empty()) {
-    out << ", canonical_names=" << frame.canonical_names_;
+  if (frame.canonical_names().is_value() &&
+      !frame.canonical_names().elements().empty()) {
+    out << ", canonical_names=" << frame.canonical_names();
   }
-  if (!frame.output_paths_.is_bottom()) {
-    out << ", output_paths=" << frame.output_paths_;
+  if (!frame.output_paths().is_bottom()) {
+    out << ", output_paths=" << frame.output_paths();
   }
-  if (frame.extra_traces_.is_value() &&
-      !frame.extra_traces_.elements().empty()) {
-    out << ", extra_traces=" << frame.extra_traces_;
+  if (!frame.extra_traces().empty()) {
+    out << ", extra_traces=" << frame.extra_traces();
   }
   return out << ")";
 }
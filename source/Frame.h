@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <ostream>
 
@@ -21,6 +22,7 @@
 #include <mariana-trench/CallClassIntervalContext.h>
 #include <mariana-trench/CallInfo.h>
 #include <mariana-trench/CallKind.h>
+#include <mariana-trench/CallSitePropagation.h>
 #include <mariana-trench/CanonicalName.h>
 #include <mariana-trench/ClassIntervals.h>
 #include <mariana-trench/Compiler.h>
@@ -30,6 +32,7 @@
 #include <mariana-trench/FeatureMayAlwaysSet.h>
 #include <mariana-trench/FeatureSet.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/Kind.h>
 #include <mariana-trench/KindFactory.h>
 #include <mariana-trench/Method.h>
@@ -88,10 +91,7 @@ using CanonicalNameSetAbstractDomain =
 class Frame final : public sparta::AbstractDomain<Frame> {
  public:
   /* Create the bottom frame. */
-  explicit Frame()
-      : kind_(nullptr),
-        class_interval_context_(CallClassIntervalContext()),
-        distance_(0) {}
+  explicit Frame() : kind_(nullptr) {}
 
   explicit Frame(
       const Kind* kind,
@@ -106,18 +106,19 @@ class Frame final : public sparta::AbstractDomain<Frame> {
       PathTreeDomain output_paths,
       ExtraTraceSet extra_traces)
       : kind_(kind),
-        class_interval_context_(std::move(class_interval_context)),
-        distance_(distance),
-        origins_(std::move(origins)),
-        inferred_features_(std::move(inferred_features)),
-        user_features_(std::move(user_features)),
-        via_type_of_ports_(std::move(via_type_of_ports)),
-        via_value_of_ports_(std::move(via_value_of_ports)),
-        canonical_names_(std::move(canonical_names)),
-        output_paths_(std::move(output_paths)),
-        extra_traces_(std::move(extra_traces)) {
+        data_(std::make_shared<Data>(Data{
+            std::move(class_interval_context),
+            distance,
+            std::move(origins),
+            std::move(inferred_features),
+            std::move(user_features),
+            std::move(via_type_of_ports),
+            std::move(via_value_of_ports),
+            std::move(canonical_names),
+            std::move(output_paths),
+            std::move(extra_traces)})) {
     mt_assert(kind_ != nullptr);
-    mt_assert(distance_ >= 0);
+    mt_assert(data_->distance >= 0);
   }
 
   explicit Frame(const TaintConfig& config);
@@ -134,23 +135,30 @@ class Frame final : public sparta::AbstractDomain<Frame> {
   const PropagationKind* propagation_kind() const;
 
   const CallClassIntervalContext& class_interval_context() const {
-    return class_interval_context_;
+    return data().class_interval_context;
   }
 
   int distance() const {
-    return distance_;
+    return data().distance;
   }
 
   const RootSetAbstractDomain& via_type_of_ports() const {
-    return via_type_of_ports_;
+    return data().via_type_of_ports;
   }
 
   const RootSetAbstractDomain& via_value_of_ports() const {
-    return via_value_of_ports_;
+    return data().via_value_of_ports;
+  }
+
+  /* Whether there are via-type-of or via-value-of ports to materialize. */
+  bool has_via_ports() const {
+    const auto& data = this->data();
+    return !data.via_type_of_ports.is_bottom() ||
+        !data.via_value_of_ports.is_bottom();
   }
 
   const CanonicalNameSetAbstractDomain& canonical_names() const {
-    return canonical_names_;
+    return data().canonical_names;
   }
 
   void add_origin(const Method* method, const AccessPath* port);
@@ -160,7 +168,7 @@ class Frame final : public sparta::AbstractDomain<Frame> {
   void add_origin(std::string_view literal);
 
   const OriginSet& origins() const {
-    return origins_;
+    return data().origins;
   }
 
   void append_to_propagation_output_paths(Path::Element path_element);
@@ -168,19 +176,22 @@ class Frame final : public sparta::AbstractDomain<Frame> {
   void update_maximum_collapse_depth(CollapseDepth collapse_depth);
 
   const PathTreeDomain& output_paths() const {
-    return output_paths_;
+    return data().output_paths;
   }
 
   void add_inferred_features(const FeatureMayAlwaysSet& features);
 
   void add_user_features(const FeatureSet& features);
 
+  /* Remove the inferred features, keeping the user features. */
+  void drop_inferred_features();
+
   const FeatureMayAlwaysSet& inferred_features() const {
-    return inferred_features_;
+    return data().inferred_features;
   }
 
   const FeatureSet& user_features() const {
-    return user_features_;
+    return data().user_features;
   }
 
   FeatureMayAlwaysSet features() const;
@@ -188,7 +199,7 @@ class Frame final : public sparta::AbstractDomain<Frame> {
   void add_extra_trace(ExtraTrace&& extra_trace);
 
   const ExtraTraceSet& extra_traces() const {
-    return extra_traces_;
+    return data().extra_traces;
   }
 
   static Frame bottom() {
@@ -209,6 +220,7 @@ class Frame final : public sparta::AbstractDomain<Frame> {
 
   void set_to_bottom() {
     kind_ = nullptr;
+    data_ = nullptr;
   }
 
   void set_to_top() {
@@ -234,42 +246,64 @@ class Frame final : public sparta::AbstractDomain<Frame> {
 
   Frame apply_transform(
       const KindFactory& kind_factory,
-      const TransformsFactory& transforms_factory,
       const UsedKinds& used_kinds,
       const TransformList* local_transforms) const;
 
   std::vector<const Feature*> materialize_via_type_of_ports(
-      const Method* callee,
-      const FeatureFactory* feature_factory,
-      const std::vector<const DexType * MT_NULLABLE>& source_register_types)
-      const;
+      const CallSitePropagation& call_site) const;
 
   std::vector<const Feature*> materialize_via_value_of_ports(
-      const Method* callee,
-      const FeatureFactory* feature_factory,
-      const std::vector<std::optional<std::string>>& source_constant_arguments)
-      const;
+      const CallSitePropagation& call_site) const;
 
   Frame with_origins(OriginSet origins) const;
 
   Json::Value to_json(
       const CallInfo& call_info,
       ExportOriginsMode export_origins_mode) const;
+  void write_json(
+      JsonWriter& writer,
+      const CallInfo& call_info,
+      ExportOriginsMode export_origins_mode) const;
 
   friend std::ostream& operator<<(std::ostream& out, const Frame& frame);
 
+  friend class FrameInterner;
+
+ private:
+  /*
+   * Fields of a frame other than its kind.
+   *
+   * Frames are copied by value throughout the analysis, so copies share the
+   * same immutable data until one of them is modified. This also lets
+   * operations between copies of the same frame short-circuit.
+   */
+  struct Data {
+    CallClassIntervalContext class_interval_context;
+    int distance = 0;
+    OriginSet origins;
+    FeatureMayAlwaysSet inferred_features;
+    FeatureSet user_features;
+    RootSetAbstractDomain via_type_of_ports;
+    RootSetAbstractDomain via_value_of_ports;
+    CanonicalNameSetAbstractDomain canonical_names;
+    PathTreeDomain output_paths;
+    ExtraTraceSet extra_traces;
+
+    bool operator==(const Data& other) const;
+  };
+
+  const Data& data() const {
+    return data_ != nullptr ? *data_ : empty_data();
+  }
+
+  /* Return the data of this frame, copying it first if it is shared. */
+  Data& mutable_data();
+
+  static const Data& empty_data();
+
  private:
   const Kind* MT_NULLABLE kind_;
-  CallClassIntervalContext class_interval_context_;
-  int distance_;
-  OriginSet origins_;
-  FeatureMayAlwaysSet inferred_features_;
-  FeatureSet user_features_;
-  RootSetAbstractDomain via_type_of_ports_;
-  RootSetAbstractDomain via_value_of_ports_;
-  CanonicalNameSetAbstractDomain canonical_names_;
-  PathTreeDomain output_paths_;
-  ExtraTraceSet extra_traces_;
+  std::shared_ptr<Data> data_;
 };
 
 } // namespace marianatrench
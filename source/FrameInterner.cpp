@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <boost/functional/hash.hpp>
+
+#include <mariana-trench/FrameInterner.h>
+
+namespace marianatrench {
+
+std::size_t FrameInterner::DataHash::operator()(
+    const Frame::Data* data) const {
+  // Only hash the fields that usually differ between frames of the same kind.
+  std::size_t seed = 0;
+  boost::hash_combine(seed, data->distance);
+  boost::hash_combine(
+      seed,
+      std::hash<CallClassIntervalContext>()(data->class_interval_context));
+  for (const auto* origin : data->origins) {
+    boost::hash_combine(seed, origin);
+  }
+  if (data->inferred_features.is_value()) {
+    for (const auto* feature : data->inferred_features.always()) {
+      boost::hash_combine(seed, feature);
+    }
+  }
+  for (const auto* feature : data->user_features) {
+    boost::hash_combine(seed, feature);
+  }
+  return seed;
+}
+
+bool FrameInterner::DataEqual::operator()(
+    const Frame::Data* left,
+    const Frame::Data* right) const {
+  return left == right || *left == *right;
+}
+
+Frame FrameInterner::intern(Frame frame) {
+  if (frame.data_ == nullptr) {
+    return frame;
+  }
+
+  data_.update(
+      frame.data_.get(),
+      [&frame](
+          const Frame::Data* /* key */,
+          std::shared_ptr<Frame::Data>& data,
+          bool exists) {
+        if (!exists) {
+          data = frame.data_;
+        } else {
+          frame.data_ = data;
+        }
+      });
+  return frame;
+}
+
+std::size_t FrameInterner::size() const {
+  return data_.size();
+}
+
+} // namespace marianatrench
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Frame.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Table of the data of frames, shared by equal frames of different models.
+ *
+ * Once the models of a strongly connected component are stable, they are only
+ * read, and most of their frames are copies of frames of their callees with
+ * the same data, except that each copy was made separately. Interning these
+ * frames makes them point to the same data.
+ *
+ * Frames are copy-on-write, and the table holds a reference on the data it
+ * interned, hence interned data is never modified: a frame modified later on
+ * gets its own copy. The data stays shared after the table is destroyed.
+ */
+class FrameInterner final {
+ private:
+  struct DataHash {
+    std::size_t operator()(const Frame::Data* data) const;
+  };
+
+  struct DataEqual {
+    bool operator()(const Frame::Data* left, const Frame::Data* right) const;
+  };
+
+ public:
+  FrameInterner() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FrameInterner)
+
+  /* Return the frame with the data of the first equal frame interned. */
+  Frame intern(Frame frame);
+
+  /* Number of distinct data. */
+  std::size_t size() const;
+
+ private:
+  // Keys point to the data of their value.
+  ConcurrentMap<
+      const Frame::Data*,
+      std::shared_ptr<Frame::Data>,
+      DataHash,
+      DataEqual>
+      data_;
+};
+
+} // namespace marianatrench
@@ -22,7 +22,7 @@ class FulfilledPartialKindResults final {
  public:
   FulfilledPartialKindResults() = default;
 
-  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FulfilledPartialKindResults)
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(FulfilledPartialKindResults)
 
   void store_call(const IRInstruction* invoke, FulfilledPartialKindState state);
   void store_artificial_call(
@@ -5,13 +5,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <mariana-trench/FulfilledPartialKindState.h>
+#include <algorithm>
 #include <optional>
+#include <stdexcept>
+
+#include <mariana-trench/FulfilledPartialKindState.h>
 
 namespace marianatrench {
 
 bool FulfilledPartialKindState::empty() const {
-  return map_.empty();
+  return fulfilled_kinds_.empty();
 }
 
 std::optional<Taint> FulfilledPartialKindState::fulfill_kind(
@@ -53,10 +56,10 @@ const PartialKind* MT_NULLABLE
 FulfilledPartialKindState::get_fulfilled_counterpart(
     const PartialKind* unfulfilled_kind,
     const MultiSourceMultiSinkRule* rule) const {
-  for (const auto& [kind, rules_map] : map_) {
-    if (unfulfilled_kind->is_counterpart(kind) &&
-        rules_map.find(rule) != rules_map.end()) {
-      return kind;
+  for (const auto& fulfilled_kind : fulfilled_kinds_) {
+    if (fulfilled_kind.rule == rule &&
+        unfulfilled_kind->is_counterpart(fulfilled_kind.kind)) {
+      return fulfilled_kind.kind;
     }
   }
 
@@ -66,18 +69,23 @@ FulfilledPartialKindState::get_fulfilled_counterpart(
 FeatureMayAlwaysSet FulfilledPartialKindState::get_features(
     const PartialKind* kind,
     const MultiSourceMultiSinkRule* rule) const {
-  return map_.at(kind).at(rule);
+  for (const auto& fulfilled_kind : fulfilled_kinds_) {
+    if (fulfilled_kind.kind == kind && fulfilled_kind.rule == rule) {
+      return fulfilled_kind.features;
+    }
+  }
+
+  throw std::out_of_range("Partial kind is not fulfilled under the rule.");
 }
 
 std::vector<const Kind*> FulfilledPartialKindState::make_triggered_counterparts(
     const PartialKind* unfulfilled_kind,
     const KindFactory& kind_factory) const {
   std::vector<const Kind*> result;
-  for (const auto& [kind, rules_map] : map_) {
-    if (unfulfilled_kind->is_counterpart(kind)) {
-      for (const auto& [rule, _features] : rules_map) {
-        result.emplace_back(kind_factory.get_triggered(unfulfilled_kind, rule));
-      }
+  for (const auto& fulfilled_kind : fulfilled_kinds_) {
+    if (unfulfilled_kind->is_counterpart(fulfilled_kind.kind)) {
+      result.emplace_back(
+          kind_factory.get_triggered(unfulfilled_kind, fulfilled_kind.rule));
     }
   }
 
@@ -90,26 +98,26 @@ void FulfilledPartialKindState::add_fulfilled_kind(
     const PartialKind* kind,
     const MultiSourceMultiSinkRule* rule,
     const FeatureMayAlwaysSet& features) {
-  auto rules_map = map_.find(kind);
-  if (rules_map == map_.end()) {
-    map_.emplace(kind, RuleMap{{rule, features}});
-    return;
+  for (const auto& fulfilled_kind : fulfilled_kinds_) {
+    if (fulfilled_kind.kind == kind && fulfilled_kind.rule == rule) {
+      // Keep the features of the first flow fulfilling the kind.
+      return;
+    }
   }
-  rules_map->second.emplace(rule, features);
+  fulfilled_kinds_.push_back(FulfilledKind{kind, rule, features});
 }
 
 void FulfilledPartialKindState::erase(
     const PartialKind* kind,
     const MultiSourceMultiSinkRule* rule) {
-  auto rules_map = map_.find(kind);
-  if (rules_map == map_.end()) {
-    return;
-  }
-
-  rules_map->second.erase(rule);
-  if (rules_map->second.empty()) {
-    map_.erase(kind);
-  }
+  fulfilled_kinds_.erase(
+      std::remove_if(
+          fulfilled_kinds_.begin(),
+          fulfilled_kinds_.end(),
+          [kind, rule](const FulfilledKind& fulfilled_kind) {
+            return fulfilled_kind.kind == kind && fulfilled_kind.rule == rule;
+          }),
+      fulfilled_kinds_.end());
 }
 
 } // namespace marianatrench
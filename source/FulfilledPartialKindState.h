@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 
 #include <mariana-trench/FeatureMayAlwaysSet.h>
 #include <mariana-trench/IncludeMacros.h>
@@ -25,8 +25,16 @@ namespace marianatrench {
  */
 class FulfilledPartialKindState final {
  private:
-  using Value = FeatureMayAlwaysSet;
-  using RuleMap = std::unordered_map<const MultiSourceMultiSinkRule*, Value>;
+  /**
+   * A partial kind fulfilled under a rule. A call site only fulfills a handful
+   * of partial kinds, hence these are stored in a flat vector which is cheap
+   * to copy into `FulfilledPartialKindResults`.
+   */
+  struct FulfilledKind {
+    const PartialKind* kind;
+    const MultiSourceMultiSinkRule* rule;
+    FeatureMayAlwaysSet features;
+  };
 
  public:
   FulfilledPartialKindState() = default;
@@ -87,7 +95,7 @@ class FulfilledPartialKindState final {
       const FeatureMayAlwaysSet& features);
   void erase(const PartialKind* kind, const MultiSourceMultiSinkRule* rule);
 
-  std::unordered_map<const PartialKind*, RuleMap> map_;
+  std::vector<FulfilledKind> fulfilled_kinds_;
 };
 
 } // namespace marianatrench
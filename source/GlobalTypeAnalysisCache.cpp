@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <Show.h>
+
+#include <mariana-trench/GlobalTypeAnalysisCache.h>
+#include <mariana-trench/GraphSnapshot.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Redex.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the global type analysis or the format changes.
+constexpr int k_version = 1;
+
+} // namespace
+
+GlobalTypeAnalysisCache::GlobalTypeAnalysisCache(
+    const std::filesystem::path& cache_directory,
+    const DexStoresVector& stores)
+    : path_(cache_directory / "global_type_analysis.json"),
+      fingerprint_(GraphSnapshot::code_fingerprint(stores)) {}
+
+bool GlobalTypeAnalysisCache::load() {
+  if (!std::filesystem::exists(path_)) {
+    LOG(1, "No global type analysis cache found at `{}`.", path_.native());
+    return false;
+  }
+
+  auto value = JsonValidation::parse_json_file(path_);
+  JsonValidation::validate_object(value);
+  if (JsonValidation::integer(value, /* field */ "version") != k_version ||
+      JsonValidation::string(value, /* field */ "fingerprint") !=
+          fingerprint_) {
+    WARNING(
+        1,
+        "Global type analysis cache `{}` is outdated, ignoring it.",
+        path_.native());
+    return false;
+  }
+
+  const auto& methods_value =
+      JsonValidation::object(value, /* field */ "methods");
+  for (const auto& method_name : methods_value.getMemberNames()) {
+    const auto* method = redex::get_method(method_name);
+    if (method == nullptr) {
+      WARNING(
+          1,
+          "Global type analysis cache `{}` refers to unknown method `{}`, ignoring it.",
+          path_.native(),
+          method_name);
+      return false;
+    }
+
+    MethodTypes method_types;
+    for (const auto& instruction_value :
+         JsonValidation::nonempty_array(methods_value[method_name])) {
+      // Each instruction is stored as `[index, register, type, ...]`.
+      RegisterTypes register_types;
+      for (Json::ArrayIndex i = 1; i + 1 < instruction_value.size(); i += 2) {
+        const DexType* type = nullptr;
+        if (!instruction_value[i + 1].isNull()) {
+          auto type_name = JsonValidation::string(instruction_value[i + 1]);
+          type = redex::get_type(type_name);
+          if (type == nullptr) {
+            WARNING(
+                1,
+                "Global type analysis cache `{}` refers to unknown type `{}`, ignoring it.",
+                path_.native(),
+                type_name);
+            return false;
+          }
+        }
+        register_types.emplace_back(
+            static_cast<Register>(
+                JsonValidation::integer(instruction_value[i])),
+            type);
+      }
+      method_types.emplace_back(
+          JsonValidation::integer(instruction_value[0]),
+          std::move(register_types));
+    }
+    set(method, std::move(method_types));
+  }
+
+  LOG(1, "Loaded global type analysis cache from `{}`.", path_.native());
+  return true;
+}
+
+void GlobalTypeAnalysisCache::store() const {
+  auto methods_value = Json::Value(Json::objectValue);
+  for (const auto& [method, method_types] : types_) {
+    auto method_value = Json::Value(Json::arrayValue);
+    for (const auto& [index, register_types] : *method_types) {
+      auto instruction_value = Json::Value(Json::arrayValue);
+      instruction_value.append(Json::Value(static_cast<int>(index)));
+      for (const auto& [register_id, type] : register_types) {
+        instruction_value.append(Json::Value(static_cast<int>(register_id)));
+        instruction_value.append(
+            type == nullptr ? Json::Value::null : Json::Value(show(type)));
+      }
+      method_value.append(instruction_value);
+    }
+    methods_value[show(method)] = method_value;
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["version"] = k_version;
+  value["fingerprint"] = fingerprint_;
+  value["methods"] = methods_value;
+
+  LOG(1, "Writing global type analysis cache to `{}`.", path_.native());
+  JsonValidation::write_json_file(path_, value);
+}
+
+const GlobalTypeAnalysisCache::MethodTypes* MT_NULLABLE
+GlobalTypeAnalysisCache::get(const DexMethod* method) const {
+  return types_.get(method, /* default */ nullptr);
+}
+
+void GlobalTypeAnalysisCache::set(
+    const DexMethod* method,
+    MethodTypes method_types) {
+  if (method_types.empty()) {
+    return;
+  }
+
+  types_.emplace(
+      method, std::make_unique<MethodTypes>(std::move(method_types)));
+}
+
+} // namespace marianatrench
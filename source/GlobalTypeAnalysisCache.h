@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <DexClass.h>
+#include <DexStore.h>
+
+#include <mariana-trench/Access.h>
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/UniquePointerConcurrentMap.h>
+
+namespace marianatrench {
+
+/**
+ * Cache of the results of Redex's global type analysis across runs.
+ *
+ * For each method, this stores the types inferred by the global analysis for
+ * the source registers of invoke and iput instructions, which is all that
+ * `Types` uses from it. Instructions are identified by their index in the
+ * iteration order of the blocks of the control flow graph.
+ *
+ * The global analysis propagates types across the whole program, hence the
+ * cache is only valid for the exact same code and is invalidated entirely
+ * whenever any class or method changes.
+ */
+class GlobalTypeAnalysisCache final {
+ public:
+  /* Types of the source registers of an instruction, or nullptr if unknown. */
+  using RegisterTypes = std::vector<std::pair<Register, const DexType*>>;
+
+  /* Register types for each instruction index, sorted by index. */
+  using MethodTypes = std::vector<std::pair<std::size_t, RegisterTypes>>;
+
+ public:
+  explicit GlobalTypeAnalysisCache(
+      const std::filesystem::path& cache_directory,
+      const DexStoresVector& stores);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(GlobalTypeAnalysisCache)
+
+  /**
+   * Read the cache. Return false if it does not exist or was computed for
+   * different code.
+   */
+  bool load();
+
+  void store() const;
+
+  const MethodTypes* MT_NULLABLE get(const DexMethod* method) const;
+
+  /* This is thread-safe. */
+  void set(const DexMethod* method, MethodTypes types);
+
+ private:
+  std::filesystem::path path_;
+  std::string fingerprint_;
+  UniquePointerConcurrentMap<const DexMethod*, MethodTypes> types_;
+};
+
+} // namespace marianatrench
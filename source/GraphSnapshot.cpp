@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+
+#include <boost/functional/hash.hpp>
+
+#include <ConcurrentContainers.h>
+#include <DexClass.h>
+#include <IRCode.h>
+#include <Show.h>
+#include <Walkers.h>
+
+#include <mariana-trench/GraphSnapshot.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Method.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the format or the contents of snapshots change.
+constexpr std::uint32_t k_version = 1;
+
+constexpr std::string_view k_magic = "mariana-trench-graph-snapshot";
+
+void write_size(std::ostream& output, std::uint64_t size) {
+  output.write(reinterpret_cast<const char*>(&size), sizeof(size));
+}
+
+std::uint64_t read_size(std::istream& input) {
+  std::uint64_t size = 0;
+  input.read(reinterpret_cast<char*>(&size), sizeof(size));
+  return size;
+}
+
+void write_string(std::ostream& output, std::string_view string) {
+  write_size(output, string.size());
+  output.write(string.data(), string.size());
+}
+
+std::string read_string(std::istream& input) {
+  std::string string(read_size(input), '\0');
+  input.read(string.data(), string.size());
+  return string;
+}
+
+} // namespace
+
+std::string GraphSnapshot::fingerprint(const DexStoresVector& stores) {
+  std::vector<std::size_t> class_hashes;
+  for (const auto& scope : DexStoreClassesIterator(stores)) {
+    for (const auto* klass : scope) {
+      std::size_t seed = 0;
+      boost::hash_combine(seed, show(klass->get_type()));
+      boost::hash_combine(seed, klass->get_access());
+      if (const auto* super = klass->get_super_class()) {
+        boost::hash_combine(seed, show(super));
+      }
+      for (const auto* interface : *klass->get_interfaces()) {
+        boost::hash_combine(seed, show(interface));
+      }
+      for (const auto* method : klass->get_all_methods()) {
+        boost::hash_combine(seed, show(method));
+        boost::hash_combine(seed, method->get_access());
+      }
+      class_hashes.push_back(seed);
+    }
+  }
+
+  // The order of classes in the stores does not matter.
+  std::sort(class_hashes.begin(), class_hashes.end());
+  std::size_t seed = 0;
+  for (auto hash : class_hashes) {
+    boost::hash_combine(seed, hash);
+  }
+  return std::to_string(seed);
+}
+
+std::string GraphSnapshot::code_fingerprint(
+    const DexStoresVector& stores) {
+  ConcurrentMap<const DexMethod*, std::size_t> code_hashes;
+  for (const auto& scope : DexStoreClassesIterator(stores)) {
+    walk::parallel::code(scope, [&](const DexMethod* method, IRCode& code) {
+      std::size_t seed = 0;
+      boost::hash_combine(seed, show(method));
+      if (code.cfg_built()) {
+        boost::hash_combine(seed, Method::show_control_flow_graph(code.cfg()));
+      }
+      code_hashes.emplace(method, seed);
+    });
+  }
+
+  // The order of methods in the stores does not matter.
+  std::vector<std::size_t> sorted_code_hashes;
+  sorted_code_hashes.reserve(code_hashes.size());
+  for (const auto& [method, hash] : code_hashes) {
+    sorted_code_hashes.push_back(hash);
+  }
+  std::sort(sorted_code_hashes.begin(), sorted_code_hashes.end());
+
+  std::size_t seed = 0;
+  boost::hash_combine(seed, fingerprint(stores));
+  for (auto hash : sorted_code_hashes) {
+    boost::hash_combine(seed, hash);
+  }
+  return std::to_string(seed);
+}
+
+std::optional<GraphSnapshot::Edges> GraphSnapshot::read(
+    const std::filesystem::path& path,
+    const std::string& fingerprint) {
+  if (!std::filesystem::exists(path)) {
+    LOG(1, "No graph snapshot found at `{}`.", path.native());
+    return std::nullopt;
+  }
+
+  try {
+    std::ifstream input;
+    input.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    input.open(path, std::ios::binary);
+    if (read_string(input) != k_magic ||
+        read_size(input) != k_version ||
+        read_string(input) != fingerprint) {
+      WARNING(
+          1, "Graph snapshot `{}` is outdated, ignoring it.", path.native());
+      return std::nullopt;
+    }
+
+    Edges edges(read_size(input));
+    for (auto& [node, successors] : edges) {
+      node = read_string(input);
+      successors.resize(read_size(input));
+      for (auto& successor : successors) {
+        successor = read_string(input);
+      }
+    }
+    return edges;
+  } catch (const std::ios_base::failure& error) {
+    WARNING(
+        1,
+        "Unable to read graph snapshot `{}`: {}",
+        path.native(),
+        error.what());
+    return std::nullopt;
+  }
+}
+
+void GraphSnapshot::write(
+    const std::filesystem::path& path,
+    const std::string& fingerprint,
+    const Edges& edges) {
+  LOG(1, "Writing graph snapshot to `{}`.", path.native());
+
+  std::ofstream output;
+  output.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  output.open(path, std::ios::binary | std::ios::trunc);
+  write_string(output, k_magic);
+  write_size(output, k_version);
+  write_string(output, fingerprint);
+  write_size(output, edges.size());
+  for (const auto& [node, successors] : edges) {
+    write_string(output, node);
+    write_size(output, successors.size());
+    for (const auto& successor : successors) {
+      write_string(output, successor);
+    }
+  }
+}
+
+} // namespace marianatrench
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <DexStore.h>
+
+namespace marianatrench {
+
+/**
+ * Binary snapshot of a graph mapping each node to a set of nodes, where nodes
+ * are identified by their name (e.g, the class hierarchies or the override
+ * graph).
+ *
+ * This is used to skip building these graphs when the code under analysis did
+ * not change since the previous run. A snapshot is only valid for the dex
+ * code it was computed from, which is identified by a fingerprint of all
+ * classes and methods.
+ */
+class GraphSnapshot final {
+ public:
+  using Edges = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+  /* Compute the fingerprint of all classes and methods in the given stores. */
+  static std::string fingerprint(const DexStoresVector& stores);
+
+  /**
+   * Same as above, but also covers the code of all methods. This is more
+   * expensive to compute.
+   */
+  static std::string code_fingerprint(const DexStoresVector& stores);
+
+  /**
+   * Read the edges stored in the given file. Return `std::nullopt` if the file
+   * does not exist, is invalid or was computed for a different fingerprint.
+   */
+  static std::optional<Edges> read(
+      const std::filesystem::path& path,
+      const std::string& fingerprint);
+
+  static void write(
+      const std::filesystem::path& path,
+      const std::string& fingerprint,
+      const Edges& edges);
+};
+
+} // namespace marianatrench
@@ -107,6 +107,15 @@ class Heuristics {
    */
   constexpr static std::size_t kMaxNumberIterations = 150;
 
+  /**
+   * Maximum number of analyses of a method in the worklist fixpoint before we
+   * abort.
+   *
+   * A method is analyzed again whenever one of its callees changes, which
+   * happens more often than once per global iteration.
+   */
+  constexpr static std::size_t kMaxNumberMethodAnalyses = 1000;
+
   /**
    * Maximum number of local positions per frame.
    */
@@ -155,6 +164,19 @@ class Heuristics {
    * This is also the maximum collapse depth for inferred propagations.
    */
   constexpr static std::uint32_t kPropagationMaxCollapseDepth = 4;
+
+  /**
+   * Maximum number of leaves in the trees of the models of methods of
+   * `--reduced-precision-classes`.
+   */
+  constexpr static std::size_t kReducedPrecisionMaxLeaves = 1;
+
+  /**
+   * Number of changes of the model of a method after which its new models are
+   * widened as for `--reduced-precision-classes`, with
+   * `--widen-changing-models`.
+   */
+  constexpr static std::size_t kMaxModelChangesBeforeWidening = 50;
 };
 
 } // namespace marianatrench
@@ -5,9 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 
-#include <sparta/WorkQueue.h>
+#include <boost/functional/hash.hpp>
 
 #include <DexUtil.h>
 
@@ -17,6 +21,7 @@
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Positions.h>
 #include <mariana-trench/Registry.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -36,7 +41,7 @@ std::optional<Bounds> get_next_non_whitespace_position(
     std::size_t current_column) {
   current_column++;
   while (lines.has_line_number(current_line_number)) {
-    const auto& line = lines.line(current_line_number);
+    auto line = lines.line(current_line_number);
     while (current_column < line.length()) {
       if (!std::isspace(line[current_column])) {
         return Bounds(
@@ -52,7 +57,7 @@ std::optional<Bounds> get_next_non_whitespace_position(
   return std::nullopt;
 }
 
-Bounds remove_surrounding_whitespace(Bounds bounds, const std::string& line) {
+Bounds remove_surrounding_whitespace(Bounds bounds, std::string_view line) {
   auto new_start = bounds.start;
   auto new_end = bounds.end;
   while (new_start < bounds.end && std::isspace(line[new_start])) {
@@ -135,7 +140,7 @@ Bounds get_argument_bounds(
 }
 
 Bounds get_callee_this_parameter_bounds(
-    const std::string& line,
+    std::string_view line,
     const Bounds& callee_name_bounds) {
   auto callee_start = callee_name_bounds.start;
   if (callee_start - 1 < 0 || line[callee_start - 1] != '.') {
@@ -201,49 +206,158 @@ Bounds get_iput_local_position_bounds(
   return remove_surrounding_whitespace(highlight_bounds, line);
 }
 
+/**
+ * Whether the given position still needs to be highlighted with the lines of
+ * the given file. Positions with bounds were already highlighted.
+ */
+bool needs_highlight(
+    const Position* MT_NULLABLE position,
+    const std::string* filepath) {
+  return position != nullptr && position->path() == filepath &&
+      position->start() == k_unknown_start;
+}
+
+bool needs_local_highlight(
+    const Position* local_position,
+    const std::string* filepath) {
+  return needs_highlight(local_position, filepath) &&
+      local_position->instruction() != nullptr &&
+      local_position->port() != std::nullopt;
+}
+
+/* Whether augmenting the positions of the taint reads the given file. */
+bool needs_source_text(const Taint& taint, const std::string* filepath) {
+  bool result = false;
+  taint.visit_local_taint([&result, filepath](const LocalTaint& local_taint) {
+    if (result || local_taint.is_bottom() ||
+        local_taint.call_kind().is_declaration()) {
+      return;
+    }
+    if (local_taint.callee_port() != nullptr &&
+        needs_highlight(local_taint.call_position(), filepath)) {
+      result = true;
+      return;
+    }
+    const auto& local_positions = local_taint.local_positions();
+    if (!local_positions.is_value()) {
+      return;
+    }
+    for (const auto* local_position : local_positions.elements()) {
+      if (needs_local_highlight(local_position, filepath)) {
+        result = true;
+        return;
+      }
+    }
+  });
+  return result;
+}
+
+bool needs_source_text(
+    const TaintAccessPathTree& taint_tree,
+    const std::string* filepath) {
+  bool result = false;
+  taint_tree.visit([&result, filepath](const AccessPath&, const Taint& taint) {
+    result = result || needs_source_text(taint, filepath);
+  });
+  return result;
+}
+
+bool needs_source_text(const Model& model, const std::string* filepath) {
+  for (const auto& issue : model.issues()) {
+    if (needs_source_text(issue.sources(), filepath) ||
+        needs_source_text(issue.sinks(), filepath)) {
+      return true;
+    }
+  }
+  return needs_source_text(model.sinks(), filepath) ||
+      needs_source_text(model.generations(), filepath) ||
+      needs_source_text(model.parameter_sources(), filepath);
+}
+
+/**
+ * A file with issues, along with the highlighted positions computed so far.
+ * Positions are shared by many frames, local positions and issues of a file,
+ * hence their highlights are memoized. Each file is processed by a single
+ * thread, this is not thread-safe.
+ */
+class SourceFile final {
+ public:
+  SourceFile(
+      const std::string* path,
+      const FileLines& lines,
+      const Context& context)
+      : path_(path), lines_(lines), context_(context) {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(SourceFile)
+
+  const std::string* path() const {
+    return path_;
+  }
+
+  const Position* augment_local_position(const Position* local_position) {
+    auto [iterator, inserted] =
+        local_positions_.emplace(local_position, nullptr);
+    if (inserted) {
+      auto bounds =
+          Highlights::get_local_position_bounds(*local_position, lines_);
+      iterator->second = context_.positions->get(
+          local_position, bounds.line, bounds.start, bounds.end);
+    }
+    return iterator->second;
+  }
+
+  const Position* augment_frame_position(
+      const Method* callee,
+      const AccessPath* callee_port,
+      const Position* position) {
+    mt_assert(position != nullptr);
+    mt_assert(callee != nullptr);
+    mt_assert(callee_port != nullptr);
+
+    auto [iterator, inserted] = frame_positions_.emplace(
+        std::make_tuple(callee, callee_port, position), nullptr);
+    if (inserted) {
+      auto bounds = Highlights::get_callee_highlight_bounds(
+          callee->dex_method(), lines_, position->line(), callee_port->root());
+      iterator->second = context_.positions->get(
+          position, bounds.line, bounds.start, bounds.end);
+    }
+    return iterator->second;
+  }
+
+ private:
+  const std::string* path_;
+  const FileLines& lines_;
+  const Context& context_;
+  std::unordered_map<const Position*, const Position*> local_positions_;
+  std::unordered_map<
+      std::tuple<const Method*, const AccessPath*, const Position*>,
+      const Position*,
+      boost::hash<
+          std::tuple<const Method*, const AccessPath*, const Position*>>>
+      frame_positions_;
+};
+
 LocalPositionSet augment_local_positions(
     const LocalPositionSet& local_positions,
-    const FileLines& lines,
-    const Context& context) {
+    SourceFile& file) {
   if (local_positions.is_bottom() || local_positions.is_top()) {
     return local_positions;
   }
   auto new_local_positions = LocalPositionSet();
   for (const auto* local_position : local_positions.elements()) {
-    if (!local_position->path() || !local_position->instruction() ||
-        local_position->port() == std::nullopt) {
+    if (!needs_local_highlight(local_position, file.path())) {
       new_local_positions.add(local_position);
       continue;
     }
-    auto bounds = Highlights::get_local_position_bounds(*local_position, lines);
-    new_local_positions.add(context.positions->get(
-        local_position, bounds.line, bounds.start, bounds.end));
+    new_local_positions.add(file.augment_local_position(local_position));
   }
   return Highlights::filter_overlapping_highlights(new_local_positions);
 }
 
-const Position* augment_frame_position(
-    const Method* callee,
-    const AccessPath* callee_port,
-    const Position* position,
-    const FileLines& lines,
-    const Context& context) {
-  mt_assert(position != nullptr);
-  mt_assert(callee != nullptr);
-  mt_assert(callee_port != nullptr);
-
-  auto bounds = Highlights::get_callee_highlight_bounds(
-      callee->dex_method(), lines, position->line(), callee_port->root());
-  return context.positions->get(
-      position, bounds.line, bounds.start, bounds.end);
-}
-
-Taint augment_taint_positions(
-    Taint taint,
-    const FileLines& lines,
-    const Context& context) {
+Taint augment_taint_positions(Taint taint, SourceFile& file) {
   return taint.update_non_declaration_positions(
-      [&lines, &context](
+      [&file](
           const Method* callee,
           const AccessPath* MT_NULLABLE callee_port,
           const Position* MT_NULLABLE position) {
@@ -252,32 +366,30 @@ Taint augment_taint_positions(
           // are unknown. Return the original position.
           return position;
         }
-        return augment_frame_position(
-            callee, callee_port, position, lines, context);
+        if (!needs_highlight(position, file.path())) {
+          // The position is in another file or is already highlighted.
+          return position;
+        }
+        return file.augment_frame_position(callee, callee_port, position);
       },
-      [&lines, &context](const LocalPositionSet& local_positions) {
-        return augment_local_positions(local_positions, lines, context);
+      [&file](const LocalPositionSet& local_positions) {
+        return augment_local_positions(local_positions, file);
       });
 }
 
 TaintAccessPathTree augment_taint_tree_positions(
     TaintAccessPathTree taint_tree,
-    const FileLines& lines,
-    const Context& context) {
-  taint_tree.transform([&lines, &context](Taint taint) {
-    return augment_taint_positions(taint, lines, context);
-  });
+    SourceFile& file) {
+  taint_tree.transform(
+      [&file](Taint taint) { return augment_taint_positions(taint, file); });
   return taint_tree;
 }
 
-IssueSet augment_issue_positions(
-    IssueSet issues,
-    const FileLines& lines,
-    const Context& context) {
-  issues.transform([&lines, &context](Issue issue) {
+IssueSet augment_issue_positions(IssueSet issues, SourceFile& file) {
+  issues.transform([&file](Issue issue) {
     return Issue(
-        augment_taint_positions(issue.sources(), lines, context),
-        augment_taint_positions(issue.sinks(), lines, context),
+        augment_taint_positions(issue.sources(), file),
+        augment_taint_positions(issue.sinks(), file),
         issue.rule(),
         issue.callee(),
         issue.sink_index(),
@@ -306,12 +418,12 @@ void get_frames_files_to_methods(
     auto new_frames_to_check =
         std::make_unique<ConcurrentSet<const LocalTaint*>>();
     auto queue =
-        sparta::work_queue<const LocalTaint*>([&](const LocalTaint* frame) {
+        work_queue<const LocalTaint*>([&](const LocalTaint* frame) {
           const auto* callee = frame->callee();
           if (!callee) {
             return;
           }
-          auto callee_model = registry.get(callee);
+          auto callee_model = registry.get_snapshot(callee);
           const auto* callee_port = frame->callee_port();
           const auto* method_position = context.positions->get(callee);
           if (method_position && method_position->path()) {
@@ -325,9 +437,9 @@ void get_frames_files_to_methods(
 
           Taint taint;
           if (frame_type == FrameType::Source) {
-            taint = callee_model.generations().raw_read(*callee_port).root();
+            taint = callee_model->generations().raw_read(*callee_port).root();
           } else if (frame_type == FrameType::Sink) {
-            taint = callee_model.sinks().raw_read(*callee_port).root();
+            taint = callee_model->sinks().raw_read(*callee_port).root();
           }
           taint.visit_local_taint([&seen_frames, &new_frames_to_check](
                                       const LocalTaint& local_taint) {
@@ -359,12 +471,12 @@ get_issue_files_to_methods(const Context& context, const Registry& registry) {
   ConcurrentSet<const LocalTaint*> sources;
   ConcurrentSet<const LocalTaint*> sinks;
 
-  auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
-    auto model = registry.get(method);
-    if (model.issues().size() == 0) {
+  auto queue = work_queue<const Method*>([&](const Method* method) {
+    auto model = registry.get_snapshot(method);
+    if (model->issues().size() == 0) {
       return;
     }
-    for (const auto& issue : model.issues()) {
+    for (const auto& issue : model->issues()) {
       const auto& issue_sinks = issue.sinks();
       issue_sinks.visit_local_taint([&sinks](const LocalTaint& local_taint) {
         if (!local_taint.call_info().is_leaf()) {
@@ -405,24 +517,60 @@ get_issue_files_to_methods(const Context& context, const Registry& registry) {
 
 } // namespace
 
-FileLines::FileLines(std::ifstream& stream) {
-  std::string line;
-  while (std::getline(stream, line)) {
-    lines_.push_back(line);
+FileLines::FileLines(const std::vector<std::string>& lines)
+    : line_offsets_({0}) {
+  for (const auto& line : lines) {
+    buffer_.append(line);
+    buffer_.push_back('\n');
+  }
+}
+
+FileLines::FileLines(const std::filesystem::path& path) : line_offsets_({0}) {
+  // Empty files cannot be mapped.
+  if (std::filesystem::file_size(path) > 0) {
+    file_.open(path.native());
+  }
+}
+
+std::string_view FileLines::content() const {
+  if (file_.is_open()) {
+    return std::string_view(file_.data(), file_.size());
+  }
+  return buffer_;
+}
+
+void FileLines::index_lines(std::size_t index) const {
+  auto content = this->content();
+  while (line_offsets_.size() <= index &&
+         line_offsets_.back() < content.size()) {
+    auto end = content.find('\n', line_offsets_.back());
+    line_offsets_.push_back(
+        end == std::string_view::npos ? content.size() : end + 1);
   }
 }
 
 bool FileLines::has_line_number(std::size_t index) const {
-  return index >= 1 && index <= lines_.size();
+  if (index < 1) {
+    return false;
+  }
+  index_lines(index);
+  return index < line_offsets_.size();
 }
 
-const std::string& FileLines::line(std::size_t index) const {
+std::string_view FileLines::line(std::size_t index) const {
   mt_assert(has_line_number(index));
-  return lines_[index - 1];
+  auto content = this->content();
+  auto begin = line_offsets_[index - 1];
+  auto end = line_offsets_[index];
+  if (end > begin && content[end - 1] == '\n') {
+    end--;
+  }
+  return content.substr(begin, end - begin);
 }
 
 std::size_t FileLines::size() const {
-  return lines_.size();
+  index_lines(std::numeric_limits<std::size_t>::max() - 1);
+  return line_offsets_.size() - 1;
 }
 
 Bounds Highlights::get_local_position_bounds(
@@ -512,25 +660,43 @@ void Highlights::augment_positions(Registry& registry, const Context& context) {
 
   auto issue_files_to_methods = get_issue_files_to_methods(context, registry);
   auto file_queue =
-      sparta::work_queue<const std::string*>([&](const std::string* filepath) {
-        std::ifstream stream(*filepath);
-        if (stream.bad()) {
-          WARNING(1, "File {} was not found.", *filepath);
-          return;
+      work_queue<const std::string*>([&](const std::string* filepath) {
+        auto methods = issue_files_to_methods.get(filepath, {});
+        bool needs_lines = std::any_of(
+            methods.begin(), methods.end(), [&](const Method* method) {
+              return needs_source_text(
+                  *registry.get_snapshot(method), filepath);
+            });
+
+        // Only open files that have positions to highlight, opening a file
+        // can be slow on network file systems.
+        std::optional<FileLines> lines;
+        if (needs_lines) {
+          std::error_code error;
+          if (!std::filesystem::is_regular_file(*filepath, error)) {
+            WARNING(1, "File {} was not found.", *filepath);
+            return;
+          }
+          try {
+            lines.emplace(std::filesystem::path(*filepath));
+          } catch (const std::exception& exception) {
+            WARNING(
+                1, "Unable to read file {}: {}", *filepath, exception.what());
+            return;
+          }
+        } else {
+          lines.emplace(std::vector<std::string>{});
         }
-        auto lines = FileLines(stream);
-        for (const auto* method : issue_files_to_methods.get(filepath, {})) {
-          const auto old_model = registry.get(method);
-          auto new_model = old_model;
-          new_model.set_issues(
-              augment_issue_positions(old_model.issues(), lines, context));
-          new_model.set_sinks(
-              augment_taint_tree_positions(old_model.sinks(), lines, context));
-          new_model.set_generations(augment_taint_tree_positions(
-              old_model.generations(), lines, context));
-          new_model.set_parameter_sources(augment_taint_tree_positions(
-              old_model.parameter_sources(), lines, context));
-          registry.set(new_model);
+        auto file = SourceFile(filepath, *lines, context);
+        for (const auto* method : methods) {
+          registry.update(method, [&file](Model& model) {
+            model.set_issues(augment_issue_positions(model.issues(), file));
+            model.set_sinks(augment_taint_tree_positions(model.sinks(), file));
+            model.set_generations(
+                augment_taint_tree_positions(model.generations(), file));
+            model.set_parameter_sources(
+                augment_taint_tree_positions(model.parameter_sources(), file));
+          });
         }
       });
 
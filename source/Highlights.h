@@ -7,6 +7,13 @@
 
 #pragma once
 
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
 #include <mariana-trench/Registry.h>
 
 namespace marianatrench {
@@ -36,20 +43,36 @@ class Highlights {
   /*
    * Representation of the lines in a file. Used to prevent off-by-1 errors as
    * lines in files are 1-indexed while cpp vectors are 0-indexed
+   *
+   * Files are memory-mapped and the offsets of lines are only computed up to
+   * the last line accessed. This is not thread-safe.
    */
   class FileLines {
    public:
-    explicit FileLines(const std::vector<std::string>& lines) : lines_(lines) {}
-    explicit FileLines(std::ifstream& stream);
+    explicit FileLines(const std::vector<std::string>& lines);
+
+    /* Throws `std::ios_base::failure` if the file cannot be mapped. */
+    explicit FileLines(const std::filesystem::path& path);
 
     bool has_line_number(std::size_t index) const;
 
-    const std::string& line(std::size_t index) const;
+    /* The result is valid as long as this object is. */
+    std::string_view line(std::size_t index) const;
 
     std::size_t size() const;
 
    private:
-    std::vector<std::string> lines_;
+    std::string_view content() const;
+
+    /* Index lines until `index` lines are known or the end of the file. */
+    void index_lines(std::size_t index) const;
+
+   private:
+    boost::iostreams::mapped_file_source file_;
+    std::string buffer_;
+    // Offsets of the start of each known line, followed by the offset where
+    // the next line would start.
+    mutable std::vector<std::size_t> line_offsets_;
   };
 
   static Bounds get_callee_highlight_bounds(
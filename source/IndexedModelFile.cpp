@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <mariana-trench/IndexedModelFile.h>
+#include <mariana-trench/JsonReader.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the index format changes.
+constexpr std::size_t k_index_version = 1;
+
+Json::Value parse_element(
+    std::string_view element,
+    const std::filesystem::path& path) {
+  if (auto value = JsonReader::parse(element)) {
+    return std::move(*value);
+  }
+
+  static const auto reader_builder = Json::CharReaderBuilder();
+  auto reader =
+      std::unique_ptr<Json::CharReader>(reader_builder.newCharReader());
+  std::string errors;
+  Json::Value value;
+  if (!reader->parse(
+          element.data(), element.data() + element.size(), &value, &errors)) {
+    throw std::invalid_argument(fmt::format(
+        "File `{}` is not valid json: {}", path.string(), errors));
+  }
+  return value;
+}
+
+std::string method_signature(const Json::Value& model) {
+  JsonValidation::validate_object(model);
+  const auto& method = model["method"];
+  if (method.isString()) {
+    return method.asString();
+  }
+  return JsonValidation::string(method, "name");
+}
+
+template <typename Integer>
+bool parse_integer(std::string_view string, Integer& value) {
+  auto result =
+      std::from_chars(string.data(), string.data() + string.size(), value);
+  return result.ec == std::errc() &&
+      result.ptr == string.data() + string.size();
+}
+
+} // namespace
+
+IndexedModelFile::IndexedModelFile(const std::filesystem::path& path)
+    : path_(path),
+      file_size_(std::filesystem::file_size(path)),
+      file_time_(static_cast<std::int64_t>(
+          std::filesystem::last_write_time(path).time_since_epoch().count())) {
+  // Empty files cannot be mapped.
+  if (file_size_ > 0) {
+    file_.open(path.native());
+  }
+
+  auto index = index_path(path);
+  if (load_index(index)) {
+    LOG(2, "Loaded model index `{}`.", index.native());
+    return;
+  }
+
+  LOG(1, "Indexing model file `{}`...", path.native());
+  build_index();
+  store_index(index);
+}
+
+std::size_t IndexedModelFile::visit(
+    const std::function<bool(std::string_view)>& filter,
+    const std::function<void(const Json::Value&)>& visit) const {
+  std::atomic<std::size_t> visited(0);
+  auto queue = work_queue<const Entry*>(
+      [&](const Entry* entry) {
+        visit(parse_element(
+            content().substr(entry->offset, entry->length), path_));
+        visited++;
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto& entry : entries_) {
+    if (filter(entry.method)) {
+      queue.add_item(&entry);
+    }
+  }
+  queue.run_all();
+  return visited.load();
+}
+
+std::filesystem::path IndexedModelFile::index_path(
+    const std::filesystem::path& path) {
+  auto index_path = path;
+  index_path += ".index";
+  return index_path;
+}
+
+std::string_view IndexedModelFile::content() const {
+  if (!file_.is_open()) {
+    return std::string_view();
+  }
+  return std::string_view(file_.data(), file_.size());
+}
+
+bool IndexedModelFile::load_index(const std::filesystem::path& index_path) {
+  std::ifstream index(index_path, std::ios_base::binary);
+  if (!index.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(index, line) ||
+      line !=
+          fmt::format("{} {} {}", k_index_version, file_size_, file_time_)) {
+    LOG(1, "Model index `{}` is outdated.", index_path.native());
+    return false;
+  }
+
+  std::vector<Entry> entries;
+  while (std::getline(index, line)) {
+    auto view = std::string_view(line);
+    auto offset_end = view.find(' ');
+    auto length_end = offset_end == std::string_view::npos
+        ? std::string_view::npos
+        : view.find(' ', offset_end + 1);
+    Entry entry;
+    if (length_end == std::string_view::npos ||
+        !parse_integer(view.substr(0, offset_end), entry.offset) ||
+        !parse_integer(
+            view.substr(offset_end + 1, length_end - offset_end - 1),
+            entry.length) ||
+        entry.offset + entry.length > file_size_) {
+      WARNING(1, "Ignoring invalid model index `{}`.", index_path.native());
+      return false;
+    }
+    entry.method = std::string(view.substr(length_end + 1));
+    entries.push_back(std::move(entry));
+  }
+
+  entries_ = std::move(entries);
+  return true;
+}
+
+void IndexedModelFile::build_index() {
+  auto content = this->content();
+  if (content.empty()) {
+    entries_.clear();
+    return;
+  }
+
+  auto elements = JsonValidation::split_json_array(content);
+  if (!elements) {
+    throw std::invalid_argument(fmt::format(
+        "Model file `{}` must be a json array without comments to be indexed.",
+        path_.string()));
+  }
+
+  entries_.resize(elements->size());
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        auto element = (*elements)[index];
+        auto& entry = entries_[index];
+        entry.offset =
+            static_cast<std::size_t>(element.data() - content.data());
+        entry.length = element.size();
+        entry.method = method_signature(parse_element(element, path_));
+      },
+      sparta::parallel::default_num_threads());
+  for (std::size_t index = 0; index < elements->size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+}
+
+void IndexedModelFile::store_index(
+    const std::filesystem::path& index_path) const {
+  // Write to a temporary file first, so that an interrupted run does not leave
+  // a truncated index behind.
+  auto temporary_path = index_path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream index(temporary_path, std::ios_base::binary);
+    if (!index.is_open()) {
+      WARNING(1, "Unable to write model index to `{}`.", index_path.native());
+      return;
+    }
+
+    index << k_index_version << ' ' << file_size_ << ' ' << file_time_ << '\n';
+    for (const auto& entry : entries_) {
+      index << entry.offset << ' ' << entry.length << ' ' << entry.method
+            << '\n';
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, index_path, error);
+  if (error) {
+    WARNING(
+        1,
+        "Unable to write model index to `{}`: {}",
+        index_path.native(),
+        error.message());
+    std::filesystem::remove(temporary_path, error);
+  }
+}
+
+} // namespace marianatrench
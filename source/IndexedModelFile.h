@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <json/json.h>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * A json model file (a json array of models), memory-mapped and indexed by
+ * method signature so that only the models of relevant methods are parsed.
+ * This is used for `--library-models-paths`, where most models are about
+ * methods that do not exist in the analyzed program.
+ *
+ * The index is stored next to the model file in `<path>.index` and is rebuilt
+ * when the model file changes. Its first line holds the format version, the
+ * size and the modification time of the model file. Each following line is
+ * `<offset> <length> <method signature>`, where offset and length are the
+ * byte range of the model in the file.
+ */
+class IndexedModelFile final {
+ private:
+  struct Entry {
+    std::size_t offset;
+    std::size_t length;
+    std::string method;
+  };
+
+ public:
+  /* Map the file and load or build its index. Throws on invalid input. */
+  explicit IndexedModelFile(const std::filesystem::path& path);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(IndexedModelFile)
+
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+  /**
+   * Parse and visit the models of methods for which `filter` returns true, in
+   * parallel. Hence `visit` must be thread-safe. Return the number of visited
+   * models.
+   */
+  std::size_t visit(
+      const std::function<bool(std::string_view)>& filter,
+      const std::function<void(const Json::Value&)>& visit) const;
+
+  static std::filesystem::path index_path(const std::filesystem::path& path);
+
+ private:
+  std::string_view content() const;
+  bool load_index(const std::filesystem::path& index_path);
+  void build_index();
+  void store_index(const std::filesystem::path& index_path) const;
+
+ private:
+  std::filesystem::path path_;
+  std::uintmax_t file_size_;
+  std::int64_t file_time_;
+  boost::iostreams::mapped_file_source file_;
+  std::vector<Entry> entries_;
+};
+
+} // namespace marianatrench
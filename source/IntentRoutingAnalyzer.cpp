@@ -5,16 +5,28 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+#include <string_view>
+#include <unordered_set>
+
+#include <boost/functional/hash.hpp>
+
 #include <sparta/MonotonicFixpointIterator.h>
 
 #include <ControlFlow.h>
+#include <IRInstruction.h>
 #include <InstructionAnalyzer.h>
 #include <Show.h>
 
 #include <mariana-trench/CallGraph.h>
+#include <mariana-trench/Compiler.h>
 #include <mariana-trench/Constants.h>
 #include <mariana-trench/IntentRoutingAnalyzer.h>
+#include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/Options.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -230,10 +242,192 @@ get_position_from_callee(const Method* original_callee) {
   return std::pair(std::nullopt, std::nullopt);
 }
 
+/*
+ * Cheap scan of the method references of invokes, to skip the fixpoint for
+ * methods that can neither route an intent nor call `getIntent()`.
+ * Constructors are not inherited, hence they must match the class exactly.
+ */
+bool may_route_intents(const IRCode& code) {
+  static const auto k_intent_methods = []() {
+    // Names of the methods, and classes of the constructors.
+    std::pair<
+        std::unordered_set<std::string_view>,
+        std::unordered_set<std::string_view>>
+        methods;
+    methods.first.insert("getIntent");
+    for (const auto& [signature, _] : constants::get_intent_class_setters()) {
+      auto view = std::string_view(signature);
+      auto class_end = view.find('.');
+      auto name =
+          view.substr(class_end + 1, view.find(':', class_end) - class_end - 1);
+      if (name == "<init>") {
+        methods.second.insert(view.substr(0, class_end));
+      } else {
+        methods.first.insert(name);
+      }
+    }
+    return methods;
+  }();
+  const auto& [names, constructor_classes] = k_intent_methods;
+
+  for (const auto* block : code.cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      if (!opcode::is_an_invoke(instruction->opcode())) {
+        continue;
+      }
+      const auto* method_reference = instruction->get_method();
+      auto name = method_reference->get_name()->str();
+      if (names.count(name) > 0 ||
+          (name == "<init>" &&
+           constructor_classes.count(method_reference->get_class()->str()) >
+               0)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Results of the analysis of each method across runs. They only depend on the
+ * code of the method, which is identified by a hash of its control flow graph.
+ * Methods rejected by `may_route_intents` are not cached.
+ */
+class IntentRoutingCache final {
+ public:
+  explicit IntentRoutingCache(const std::filesystem::path& cache_directory)
+      : path_(cache_directory / "intent_routing.json") {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(IntentRoutingCache)
+
+  void load() {
+    if (!std::filesystem::exists(path_)) {
+      LOG(1, "No intent routing cache found at `{}`.", path_.native());
+      return;
+    }
+
+    auto value = JsonValidation::parse_json_file(path_);
+    JsonValidation::validate_object(value);
+    if (JsonValidation::integer(value, /* field */ "version") != k_version) {
+      WARNING(
+          1, "Intent routing cache `{}` is outdated, ignoring it.", path_.native());
+      return;
+    }
+
+    const auto& methods_value =
+        JsonValidation::object(value, /* field */ "methods");
+    for (const auto& method_name : methods_value.getMemberNames()) {
+      const auto& method_value = methods_value[method_name];
+      Entry entry{JsonValidation::string(method_value, "hash"), {}, {}};
+      bool valid = true;
+      for (const auto& type_value :
+           JsonValidation::null_or_array(method_value, "routed_intents")) {
+        const auto* type = redex::get_type(JsonValidation::string(type_value));
+        if (type == nullptr) {
+          valid = false;
+          break;
+        }
+        entry.routed_intents.push_back(type);
+      }
+      if (method_value.isMember("root")) {
+        entry.receiving_root = std::make_pair(
+            Root::from_json(method_value["root"]),
+            static_cast<Component>(
+                JsonValidation::integer(method_value, "component")));
+      }
+      // Entries referring to types that no longer exist are recomputed.
+      if (valid) {
+        loaded_.emplace(method_name, std::move(entry));
+      }
+    }
+    LOG(1,
+        "Loaded {} methods from intent routing cache `{}`.",
+        loaded_.size(),
+        path_.native());
+  }
+
+  void store() const {
+    auto methods_value = Json::Value(Json::objectValue);
+    for (const auto& [method, entry] : computed_) {
+      auto method_value = Json::Value(Json::objectValue);
+      method_value["hash"] = entry.hash;
+      auto routed_intents_value = Json::Value(Json::arrayValue);
+      for (const auto* type : entry.routed_intents) {
+        routed_intents_value.append(Json::Value(show(type)));
+      }
+      method_value["routed_intents"] = routed_intents_value;
+      if (entry.receiving_root) {
+        method_value["root"] = entry.receiving_root->first.to_json();
+        method_value["component"] =
+            static_cast<int>(entry.receiving_root->second);
+      }
+      methods_value[method->show()] = method_value;
+    }
+
+    auto value = Json::Value(Json::objectValue);
+    value["version"] = k_version;
+    value["methods"] = methods_value;
+
+    LOG(1, "Writing intent routing cache to `{}`.", path_.native());
+    JsonValidation::write_json_file(path_, value);
+  }
+
+  static std::string hash(const IRCode& code) {
+    return std::to_string(boost::hash_value(
+        Method::show_control_flow_graph(code.cfg())));
+  }
+
+  /* Returns the cached data if the method did not change. */
+  std::optional<IntentRoutingData> get(
+      const Method* method,
+      const std::string& hash) const {
+    auto found = loaded_.find(method->show());
+    if (found == loaded_.end() || found->second.hash != hash) {
+      return std::nullopt;
+    }
+    ReceivingMethod receiving_method = {.method = method};
+    if (const auto& receiving_root = found->second.receiving_root) {
+      receiving_method.root = receiving_root->first;
+      receiving_method.component = receiving_root->second;
+    }
+    return IntentRoutingData{receiving_method, found->second.routed_intents};
+  }
+
+  /* This is thread-safe. */
+  void set(
+      const Method* method,
+      std::string hash,
+      const IntentRoutingData& data) {
+    Entry entry{std::move(hash), data.routed_intents, std::nullopt};
+    if (data.receiving_intent_root.root) {
+      entry.receiving_root = std::make_pair(
+          *data.receiving_intent_root.root,
+          *data.receiving_intent_root.component);
+    }
+    computed_.emplace(method, std::move(entry));
+  }
+
+ private:
+  // Bump this whenever the analysis or the format changes.
+  static constexpr int k_version = 1;
+
+  struct Entry {
+    std::string hash;
+    std::vector<const DexType*> routed_intents;
+    std::optional<std::pair<Root, Component>> receiving_root;
+  };
+
+  std::filesystem::path path_;
+  std::unordered_map<std::string, Entry> loaded_;
+  ConcurrentMap<const Method*, Entry> computed_;
+};
+
 IntentRoutingData method_routes_intents_to(
     const Method* method,
     const Types& types,
-    const Options& options) {
+    const Options& options,
+    IntentRoutingCache* MT_NULLABLE cache) {
   ReceivingMethod receiving_method = {
       .method = method,
   };
@@ -269,6 +463,21 @@ IntentRoutingData method_routes_intents_to(
     }
   }
 
+  if (!may_route_intents(*code)) {
+    return {
+        /* receiving_intent_root */ context->method_gets_routed_intent(),
+        /* routed_intents */ {}};
+  }
+
+  std::string hash;
+  if (cache != nullptr) {
+    hash = IntentRoutingCache::hash(*code);
+    if (auto data = cache->get(method, hash)) {
+      cache->set(method, std::move(hash), *data);
+      return *data;
+    }
+  }
+
   auto fixpoint = IntentRoutingFixpointIterator(
       code->cfg(), InstructionAnalyzerCombiner<Transfer>(context.get()));
   InstructionsToRoutedIntents instructions_to_routed_intents{};
@@ -280,9 +489,13 @@ IntentRoutingData method_routes_intents_to(
       routed_intents.push_back(intent);
     }
   }
-  return {
+  IntentRoutingData data{
       /* receiving_intent_root */ context->method_gets_routed_intent(),
       routed_intents};
+  if (cache != nullptr) {
+    cache->set(method, std::move(hash), data);
+  }
+  return data;
 }
 
 } // namespace
@@ -292,10 +505,17 @@ IntentRoutingAnalyzer IntentRoutingAnalyzer::run(const Context& context) {
     return IntentRoutingAnalyzer();
   }
 
+  std::unique_ptr<IntentRoutingCache> cache;
+  if (const auto& cache_directory =
+          context.options->analysis_cache_directory()) {
+    cache = std::make_unique<IntentRoutingCache>(*cache_directory);
+    cache->load();
+  }
+
   IntentRoutingAnalyzer analyzer;
-  auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
-    auto intent_routing_data =
-        method_routes_intents_to(method, *context.types, *context.options);
+  auto queue = work_queue<const Method*>([&](const Method* method) {
+    auto intent_routing_data = method_routes_intents_to(
+        method, *context.types, *context.options, cache.get());
     if (intent_routing_data.receiving_intent_root.root != std::nullopt) {
       LOG(5,
           "Shimming {} as a method that receivings an Intent.",
@@ -328,6 +548,10 @@ IntentRoutingAnalyzer IntentRoutingAnalyzer::run(const Context& context) {
   }
   queue.run_all();
 
+  if (cache != nullptr) {
+    cache->store();
+  }
+
   return analyzer;
 }
 
@@ -5,56 +5,170 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <fmt/format.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+#include <vector>
 
-#include <sparta/WorkQueue.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <fmt/format.h>
 
 #include <ControlFlow.h>
 #include <Show.h>
 #include <Walkers.h>
 
+#include <mariana-trench/AnalysisCache.h>
+#include <mariana-trench/Assert.h>
 #include <mariana-trench/BackwardTaintEnvironment.h>
 #include <mariana-trench/BackwardTaintFixpoint.h>
 #include <mariana-trench/BackwardTaintTransfer.h>
+#include <mariana-trench/Checkpoint.h>
 #include <mariana-trench/ClassProperties.h>
+#include <mariana-trench/ConcurrentMethodSet.h>
 #include <mariana-trench/Context.h>
+#include <mariana-trench/ControlFlowGraphs.h>
+#include <mariana-trench/ConvergenceReport.h>
+#include <mariana-trench/Deadline.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/EventLogger.h>
 #include <mariana-trench/FeatureFactory.h>
 #include <mariana-trench/ForwardAliasEnvironment.h>
 #include <mariana-trench/ForwardAliasFixpoint.h>
+#include <mariana-trench/ForwardAliasTaintEnvironment.h>
+#include <mariana-trench/ForwardAliasTaintFixpoint.h>
 #include <mariana-trench/ForwardAliasTransfer.h>
 #include <mariana-trench/ForwardTaintEnvironment.h>
 #include <mariana-trench/ForwardTaintFixpoint.h>
+#include <mariana-trench/ForwardTaintStates.h>
 #include <mariana-trench/ForwardTaintTransfer.h>
+#include <mariana-trench/FrameInterner.h>
+#include <mariana-trench/Heuristics.h>
 #include <mariana-trench/Interprocedural.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/MethodProfiles.h>
+#include <mariana-trench/MethodSampler.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/ModelChanges.h>
+#include <mariana-trench/ModelSizes.h>
+#include <mariana-trench/ModelStreamer.h>
 #include <mariana-trench/OperatingSystem.h>
 #include <mariana-trench/Overrides.h>
+#include <mariana-trench/Partitions.h>
+#include <mariana-trench/PostprocessTraces.h>
+#include <mariana-trench/Progress.h>
+#include <mariana-trench/RelevancePrescan.h>
 #include <mariana-trench/Scheduler.h>
+#include <mariana-trench/Shard.h>
 #include <mariana-trench/Statistics.h>
 #include <mariana-trench/Timer.h>
+#include <mariana-trench/TransferCall.h>
+#include <mariana-trench/WorkerPlacement.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
 namespace {
 
+using ForwardAliasCache =
+    ConcurrentMap<const Method*, std::shared_ptr<ForwardAliasResults>>;
+
+// Number of processed components between two checks of the resident set size
+// against `--resident-set-size-target`.
+constexpr std::size_t k_resident_set_size_check_interval = 100;
+
+/*
+ * Return true if the cached forward alias analysis results are still valid,
+ * i.e the summaries of all callee models are unchanged.
+ */
+bool is_valid(
+    MethodContext& method_context,
+    const ForwardAliasResults& forward_alias_results) {
+  for (const auto& [instruction, summary] : forward_alias_results.callees) {
+    const auto& aliasing = forward_alias_results.aliasing.get(instruction);
+    const auto& register_memory_locations_map =
+        aliasing.register_memory_locations_map();
+    auto callee = get_callee(
+        &method_context,
+        instruction,
+        aliasing.position(),
+        get_source_register_types(&method_context, instruction),
+        get_source_constant_arguments(
+            register_memory_locations_map, instruction),
+        get_is_this_call(register_memory_locations_map, instruction));
+    if (!(alias_callee_summary(&method_context, callee) == summary)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Return true if the method belongs to `--reduced-precision-classes`. */
+bool has_reduced_precision(const Options& options, const Method* method) {
+  for (const auto& class_prefix : options.reduced_precision_classes()) {
+    if (boost::starts_with(method->signature(), class_prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Model analyze(
     Context& global_context,
     const Registry& registry,
-    const Model& previous_model) {
+    ForwardAliasCache& forward_alias_cache,
+    const Deadline& analysis_deadline,
+    const Model& previous_model,
+    bool widen) {
   Timer timer;
 
   auto* method = previous_model.method();
   if (!method) {
     return previous_model;
   }
+  Progress::MethodScope progress_scope(global_context.progress.get(), method);
+  MethodSampler::MethodScope sampler_scope(
+      global_context.method_sampler.get(), method);
 
   auto new_model = previous_model.initial_model_for_iteration();
 
+  auto use_forward_alias_cache =
+      global_context.options->enable_alias_analysis_cache();
+  std::shared_ptr<ForwardAliasResults> cached_forward_alias_results =
+      use_forward_alias_cache ? forward_alias_cache.get(method, nullptr)
+                              : nullptr;
+  auto forward_alias_results = cached_forward_alias_results
+      ? cached_forward_alias_results
+      : std::make_shared<ForwardAliasResults>(method);
+
+  auto method_deadline = Deadline::earliest(
+      Deadline::after_seconds(
+          global_context.options->maximum_method_analysis_time()),
+      analysis_deadline);
   MethodContext method_context(
-      global_context, registry, previous_model, new_model);
+      global_context,
+      registry,
+      previous_model,
+      new_model,
+      forward_alias_results,
+      method_deadline);
+
+  std::optional<MethodAnalysisProfile> profile;
+  if (global_context.method_profiles != nullptr) {
+    profile.emplace();
+    method_context.profile = &*profile;
+  }
+  // Record the time and block visits of a fixpoint phase in the profile.
+  auto profile_phase = [](MethodAnalysisProfile& phase_profile,
+                          const Timer& phase_timer,
+                          double& time,
+                          std::size_t& block_visits) {
+    time = phase_timer.duration_in_seconds();
+    block_visits = phase_profile.block_visits;
+    phase_profile.block_visits = 0;
+  };
 
   LOG_OR_DUMP(
       &method_context, 3, "Analyzing `\033[33m{}\033[0m`...", method->show());
@@ -81,64 +195,274 @@ Model analyze(
       "Code:\n{}",
       Method::show_control_flow_graph(code->cfg()));
 
-  {
-    // TODO(T144485000): This could potentially be done once as a pre-analysis
-    // step and cached. The handling of inlining (`inline_as_getter`) might make
-    // this impossible unfortunately.
-    LOG_OR_DUMP(
-        &method_context, 4, "Forward alias analysis of `{}`", method->show());
-    Timer forward_alias_timer;
-    auto forward_alias_fixpoint = ForwardAliasFixpoint(
-        method_context,
-        code->cfg(),
-        InstructionAnalyzerCombiner<ForwardAliasTransfer>(&method_context));
-    forward_alias_fixpoint.run(ForwardAliasEnvironment::initial());
+  if (global_context.relevance_prescan != nullptr &&
+      !global_context.relevance_prescan->may_change_model(
+          global_context, registry, previous_model)) {
     LOG_OR_DUMP(
         &method_context,
         4,
-        "Forward alias analysis of `{}` took {:.2f}s",
-        method->show(),
-        forward_alias_timer.duration_in_seconds());
+        "Skipping analysis of `{}`, its model cannot change",
+        method->show());
+    return new_model;
   }
 
-  {
-    LOG_OR_DUMP(
-        &method_context, 4, "Forward taint analysis of `{}`", method->show());
-    Timer forward_taint_timer;
-    auto forward_taint_fixpoint = ForwardTaintFixpoint(
-        code->cfg(),
-        InstructionAnalyzerCombiner<ForwardTaintTransfer>(&method_context));
-    forward_taint_fixpoint.run(ForwardTaintEnvironment::initial());
-    LOG_OR_DUMP(
-        &method_context,
-        4,
-        "Forward taint analysis of `{}` took {:.2f}s",
-        method->show(),
-        forward_taint_timer.duration_in_seconds());
-  }
+  // The fixpoints check the deadline before analyzing each block. When it
+  // expires, the method falls back to a default taint-in-taint-out model.
+  bool deadline_exceeded = false;
+  try {
+    // The forward alias analysis only depends on callee models through their
+    // `AliasCalleeSummary`, hence its results can be reused across iterations.
+    bool reuse_forward_alias_results =
+        cached_forward_alias_results != nullptr &&
+        is_valid(method_context, *cached_forward_alias_results);
+    bool skip_forward_taint =
+        global_context.options->sparse_taint_analysis() &&
+        !RelevancePrescan::may_introduce_forward_taint(
+            global_context, registry, previous_model);
+    bool fuse_forward_analyses =
+        global_context.options->fuse_forward_analyses() &&
+        !reuse_forward_alias_results && !skip_forward_taint;
 
-  {
-    Timer backward_taint_timer;
-    LOG_OR_DUMP(
-        &method_context, 4, "Backward taint analysis of `{}`", method->show());
-    auto backward_taint_fixpoint = BackwardTaintFixpoint(
-        code->cfg(),
-        InstructionAnalyzerCombiner<BackwardTaintTransfer>(&method_context));
-    backward_taint_fixpoint.run(
-        BackwardTaintEnvironment::initial(method_context));
-    LOG_OR_DUMP(
-        &method_context,
-        4,
-        "Backward taint analysis of `{}` took {:.2f}s",
-        method->show(),
-        backward_taint_timer.duration_in_seconds());
+    if (reuse_forward_alias_results) {
+      LOG_OR_DUMP(
+          &method_context,
+          4,
+          "Reusing forward alias analysis results of `{}`",
+          method->show());
+      new_model.set_inline_as_getter(forward_alias_results->inline_as_getter);
+      new_model.set_inline_as_setter(forward_alias_results->inline_as_setter);
+    } else {
+      Timer forward_alias_timer;
+      if (cached_forward_alias_results != nullptr) {
+        // The results are updated in place, they are invalid until the forward
+        // alias analysis completes.
+        forward_alias_cache.erase(method);
+      }
+      forward_alias_results->callees.clear();
+      forward_alias_results->forward_taint_states.reset();
+      if (fuse_forward_analyses) {
+        LOG_OR_DUMP(
+            &method_context,
+            4,
+            "Forward alias and taint analysis of `{}`",
+            method->show());
+        auto forward_alias_taint_fixpoint = ForwardAliasTaintFixpoint(
+            method_context,
+            code->cfg(),
+            InstructionAnalyzerCombiner<ForwardAliasTransfer>(&method_context),
+            InstructionAnalyzerCombiner<ForwardTaintTransfer>(&method_context));
+        forward_alias_taint_fixpoint.run(
+            ForwardAliasTaintEnvironment::initial());
+      } else {
+        LOG_OR_DUMP(
+            &method_context,
+            4,
+            "Forward alias analysis of `{}`",
+            method->show());
+        auto forward_alias_fixpoint = ForwardAliasFixpoint(
+            method_context,
+            code->cfg(),
+            InstructionAnalyzerCombiner<ForwardAliasTransfer>(&method_context));
+        forward_alias_fixpoint.run(ForwardAliasEnvironment::initial());
+      }
+      forward_alias_results->inline_as_getter = new_model.inline_as_getter();
+      forward_alias_results->inline_as_setter = new_model.inline_as_setter();
+      if (use_forward_alias_cache) {
+        forward_alias_cache.insert_or_assign(
+            std::make_pair(method, forward_alias_results));
+      }
+      if (profile) {
+        // The fused fixpoint is accounted as a forward alias phase.
+        profile_phase(
+            *profile,
+            forward_alias_timer,
+            profile->forward_alias_time,
+            profile->forward_alias_block_visits);
+      }
+      LOG_OR_DUMP(
+          &method_context,
+          4,
+          "Forward alias analysis of `{}` took {:.2f}s",
+          method->show(),
+          forward_alias_timer.duration_in_seconds());
+    }
+
+    auto run_forward_taint = [&]() {
+      LOG_OR_DUMP(
+          &method_context, 4, "Forward taint analysis of `{}`", method->show());
+      Timer forward_taint_timer;
+      auto forward_taint_fixpoint = ForwardTaintFixpoint(
+          method_context,
+          code->cfg(),
+          InstructionAnalyzerCombiner<ForwardTaintTransfer>(&method_context));
+      auto& forward_taint_states = forward_alias_results->forward_taint_states;
+      if (global_context.options->incremental_reanalysis() &&
+          code->cfg().num_blocks() >= ForwardTaintStates::k_minimum_blocks) {
+        if (forward_taint_states == nullptr) {
+          forward_taint_states = std::make_shared<ForwardTaintStates>();
+        }
+        if (forward_taint_states->run(
+                method_context, code->cfg(), forward_taint_fixpoint)) {
+          LOG_OR_DUMP(
+              &method_context,
+              4,
+              "Reused forward taint states of `{}`",
+              method->show());
+        }
+      } else {
+        forward_taint_fixpoint.run(ForwardTaintEnvironment::initial());
+      }
+      if (profile) {
+        profile_phase(
+            *profile,
+            forward_taint_timer,
+            profile->forward_taint_time,
+            profile->forward_taint_block_visits);
+      }
+      LOG_OR_DUMP(
+          &method_context,
+          4,
+          "Forward taint analysis of `{}` took {:.2f}s",
+          method->show(),
+          forward_taint_timer.duration_in_seconds());
+    };
+
+    auto run_backward_taint = [&](MethodContext& context,
+                                  BackwardTaintEnvironment environment) {
+      Timer backward_taint_timer;
+      LOG_OR_DUMP(
+          &context, 4, "Backward taint analysis of `{}`", method->show());
+      auto backward_taint_fixpoint = BackwardTaintFixpoint(
+          context,
+          code->cfg(),
+          InstructionAnalyzerCombiner<BackwardTaintTransfer>(&context));
+      backward_taint_fixpoint.run(std::move(environment));
+      if (context.profile != nullptr) {
+        profile_phase(
+            *context.profile,
+            backward_taint_timer,
+            context.profile->backward_taint_time,
+            context.profile->backward_taint_block_visits);
+      }
+      LOG_OR_DUMP(
+          &context,
+          4,
+          "Backward taint analysis of `{}` took {:.2f}s",
+          method->show(),
+          backward_taint_timer.duration_in_seconds());
+    };
+
+    auto backward_taint_environment =
+        BackwardTaintEnvironment::initial(method_context);
+    bool skip_backward_taint =
+        global_context.options->sparse_taint_analysis() &&
+        backward_taint_environment.is_bottom() &&
+        !RelevancePrescan::may_introduce_backward_taint(
+            global_context, registry, previous_model);
+    // Both taint analyses only read the forward alias results, except for the
+    // partial sinks of multi-source/sink rules that the forward taint analysis
+    // fulfills for the backward taint analysis.
+    auto parallel_minimum_blocks =
+        global_context.options->parallel_taint_analysis_minimum_blocks();
+    bool parallel_taint_analyses = parallel_minimum_blocks &&
+        code->cfg().num_blocks() >=
+            static_cast<std::size_t>(*parallel_minimum_blocks) &&
+        !skip_forward_taint && !fuse_forward_analyses && !skip_backward_taint &&
+        !global_context.rules->has_partial_rules();
+
+    if (parallel_taint_analyses) {
+      LOG_OR_DUMP(
+          &method_context,
+          4,
+          "Concurrent forward and backward taint analyses of `{}`",
+          method->show());
+      forward_alias_results->memory_factory.prepare_concurrent_fields(
+          code->cfg());
+
+      // The backward taint analysis infers into its own copy of the model,
+      // with its own call site model cache and profile.
+      auto backward_model = new_model;
+      MethodContext backward_context(
+          global_context,
+          registry,
+          previous_model,
+          backward_model,
+          forward_alias_results,
+          method_deadline);
+      std::optional<MethodAnalysisProfile> backward_profile;
+      if (profile) {
+        backward_profile.emplace();
+        backward_context.profile = &*backward_profile;
+      }
+
+      // Both analyses run on the worker pool, which reuses its threads rather
+      // than starting one per method. The forward taint analysis is given to
+      // worker 0, i.e. this thread. The queue waits for both analyses before
+      // rethrowing the first exception.
+      auto queue = work_queue<std::size_t>(
+          [&run_forward_taint,
+           &run_backward_taint,
+           &backward_context,
+           &backward_taint_environment](std::size_t analysis) {
+            if (analysis == 0) {
+              run_forward_taint();
+            } else {
+              run_backward_taint(
+                  backward_context, std::move(backward_taint_environment));
+            }
+          },
+          /* num_threads */ 2);
+      queue.add_item(0, /* worker_id */ 0);
+      queue.add_item(1, /* worker_id */ 1);
+      queue.run_all();
+
+      new_model.join_with(backward_model);
+      if (profile) {
+        profile->backward_taint_time = backward_profile->backward_taint_time;
+        profile->backward_taint_block_visits =
+            backward_profile->backward_taint_block_visits;
+        profile->callee_model_time += backward_profile->callee_model_time;
+        profile->callee_model_lookups +=
+            backward_profile->callee_model_lookups;
+      }
+    } else {
+      if (skip_forward_taint) {
+        LOG_OR_DUMP(
+            &method_context,
+            4,
+            "Skipping forward taint analysis of `{}`, no taint is introduced",
+            method->show());
+        forward_alias_results->forward_taint_states.reset();
+      } else if (!fuse_forward_analyses) {
+        run_forward_taint();
+      }
+
+      if (skip_backward_taint) {
+        LOG_OR_DUMP(
+            &method_context,
+            4,
+            "Skipping backward taint analysis of `{}`, no taint is introduced",
+            method->show());
+      } else {
+        run_backward_taint(
+            method_context, std::move(backward_taint_environment));
+      }
+    }
+  } catch (const DeadlineExceededError& error) {
+    LOG(1, "{}.", error.what());
+    new_model = previous_model.initial_model_for_iteration();
+    // The states may have been partially updated.
+    forward_alias_results->forward_taint_states.reset();
+    deadline_exceeded = true;
   }
 
   new_model.collapse_invalid_paths(global_context);
-  new_model.approximate(/* widening_features */
-                        FeatureMayAlwaysSet{
-                            global_context.feature_factory
-                                ->get_widen_broadening_feature()});
+  auto widening_features = FeatureMayAlwaysSet{
+      global_context.feature_factory->get_widen_broadening_feature()};
+  new_model.approximate(widening_features);
+  if (widen || has_reduced_precision(*global_context.options, method)) {
+    new_model.reduce_precision(widening_features);
+  }
 
   LOG_OR_DUMP(
       &method_context,
@@ -149,6 +473,17 @@ Model analyze(
 
   global_context.statistics->log_time(method, timer);
   auto duration = timer.duration_in_seconds();
+  if (profile) {
+    profile->analyses = 1;
+    profile->time = duration;
+    profile->model_size = MethodProfiles::model_size(new_model);
+    MethodProfiles::measure_code(*code, *profile);
+    global_context.method_profiles->add(method, *profile);
+  }
+  if (global_context.model_sizes != nullptr) {
+    global_context.model_sizes->add(method, new_model);
+  }
+  global_context.scheduler->log_analysis_time(method, duration);
   if (duration > 10.0) {
     WARNING(1, "Analyzing `{}` took {:.2f}s!", method->show(), duration);
     EventLogger::log_event(
@@ -158,7 +493,8 @@ Model analyze(
   }
   auto slow_method_bound =
       global_context.options->maximum_method_analysis_time();
-  if (slow_method_bound && *slow_method_bound <= duration) {
+  if (deadline_exceeded ||
+      (slow_method_bound && *slow_method_bound <= duration)) {
     LOG(1,
         "Analyzing `{}` took {:.2f}s, setting default taint-in-taint-out.",
         method->show(),
@@ -175,14 +511,86 @@ Model analyze(
 
 } // namespace
 
-void Interprocedural::run_analysis(Context& context, Registry& registry) {
-  LOG(1, "Computing global fixpoint...");
-  auto methods_to_analyze = std::make_unique<ConcurrentSet<const Method*>>();
+namespace {
+
+/*
+ * Whether the method is analyzed in the first iteration: either it is in the
+ * given initial methods, or it is not skipped by the analysis cache.
+ */
+bool analyzed_initially(
+    const Context& context,
+    const ConcurrentMethodSet* MT_NULLABLE initial_methods,
+    const Method* method) {
+  if (initial_methods != nullptr) {
+    return initial_methods->contains(method);
+  }
+  return !context.analysis_cache || !context.analysis_cache->skip(method);
+}
+
+/* Whether the method is skipped, or analyzed by another shard. */
+bool skips_analysis(const Context& context, const Model& model) {
+  return model.skip_analysis() ||
+      (context.shard != nullptr && !context.shard->analyzes(model.method()));
+}
+
+/**
+ * Join the previous model of a method into its `new_model` from an analysis,
+ * and return whether this changed the previous model.
+ *
+ * The new model is compared before joining: in late iterations, most analyses
+ * do not change the model, and the join is then skipped. In that case,
+ * `new_model` is left as is and must not be published.
+ */
+bool join_if_changed(Model& new_model, const Model& previous_model) {
+  if (new_model.leq(previous_model)) {
+    return false;
+  }
+  new_model.join_with(previous_model);
+  return true;
+}
+
+std::optional<WorkerPlacement> make_worker_placement(
+    const Context& context,
+    unsigned int threads) {
+  if (!context.options->pin_worker_threads()) {
+    return std::nullopt;
+  }
+  return WorkerPlacement::from_host(threads);
+}
+
+/*
+ * Compute the global fixpoint by global iterations: each iteration analyzes
+ * the set of methods invalidated by the previous one, with a barrier in
+ * between.
+ */
+void run_global_iterations(
+    Context& context,
+    Registry& registry,
+    const Deadline& deadline,
+    const ConcurrentMethodSet* MT_NULLABLE initial_methods) {
+  ForwardAliasCache forward_alias_cache;
+  ModelChanges model_changes(context.options->widen_changing_models());
+
+  auto methods_to_analyze =
+      std::make_unique<ConcurrentMethodSet>(*context.methods);
   for (const auto* method : *context.methods) {
-    methods_to_analyze->insert(method);
+    if (analyzed_initially(context, initial_methods, method)) {
+      methods_to_analyze->insert(method);
+    }
   }
 
   std::size_t iteration = 0;
+  const auto& resume_from = context.options->resume_from();
+  if (resume_from && initial_methods == nullptr) {
+    auto state = Checkpoint::load(*resume_from, context, registry);
+    methods_to_analyze =
+        std::make_unique<ConcurrentMethodSet>(*context.methods);
+    for (const auto* method : state.methods_to_analyze) {
+      methods_to_analyze->insert(method);
+    }
+    iteration = state.iteration;
+  }
+
   while (methods_to_analyze->size() > 0) {
     Timer iteration_timer;
     iteration++;
@@ -194,19 +602,35 @@ void Interprocedural::run_analysis(Context& context, Registry& registry) {
         iteration,
         methods_to_analyze->size(),
         resident_set_size);
+    if (context.progress) {
+      context.progress->start_iteration(iteration, methods_to_analyze->size());
+    }
+    if (context.memory_accounting) {
+      context.memory_accounting->record(
+          fmt::format("global_iteration_{}", iteration), context, &registry);
+    }
 
     if (iteration > Heuristics::kMaxNumberIterations) {
       ERROR(1, "Too many iterations");
       std::string message = "Unstable methods are:";
-      for (const auto* method : *methods_to_analyze) {
+      methods_to_analyze->visit([&](const Method* method) {
         message.append(fmt::format("\n`{}`", method->show()));
-      }
+      });
       LOG(1, message);
       throw std::runtime_error("Too many iterations, exiting.");
     }
 
     auto new_methods_to_analyze =
-        std::make_unique<ConcurrentSet<const Method*>>();
+        std::make_unique<ConcurrentMethodSet>(*context.methods);
+
+    // With `--deterministic`, changed models are only published at the end of
+    // the iteration: every method reads the models of the previous iteration,
+    // regardless of the number of threads and of the analysis order. These are
+    // frozen in the registry, which makes reads lock-free.
+    bool deterministic = context.options->deterministic();
+    if (deterministic) {
+      registry.freeze();
+    }
 
     unsigned int threads = sparta::parallel::default_num_threads();
     if (context.options->sequential()) {
@@ -214,9 +638,15 @@ void Interprocedural::run_analysis(Context& context, Registry& registry) {
       threads = 1u;
     }
 
+    auto worker_placement = make_worker_placement(context, threads);
+
     std::atomic<std::size_t> method_iteration(0);
-    auto queue = sparta::work_queue<const Method*>(
-        [&](const Method* method) {
+    auto queue = work_queue<const Method*>(
+        [&](WorkerState<const Method*>* worker_state, const Method* method) {
+          if (worker_placement) {
+            worker_placement->pin(worker_state->worker_id());
+          }
+
           method_iteration++;
           if (method_iteration % 10000 == 0) {
             LOG_IF_INTERACTIVE(
@@ -232,27 +662,52 @@ void Interprocedural::run_analysis(Context& context, Registry& registry) {
                 methods_to_analyze->size());
           }
 
-          const auto previous_model = registry.get(method);
-          if (previous_model.skip_analysis()) {
+          const auto previous_model = registry.get_snapshot(method);
+          if (skips_analysis(context, *previous_model)) {
             LOG(3, "Skipping `{}`...", method->show());
             return;
           }
 
-          auto new_model = analyze(context, registry, previous_model);
+          auto new_model = analyze(
+              context,
+              registry,
+              forward_alias_cache,
+              deadline,
+              *previous_model,
+              model_changes.widens(method));
 
-          new_model.join_with(previous_model);
+          bool changed = join_if_changed(new_model, *previous_model);
+          if (context.convergence_report) {
+            context.convergence_report->analyzed(iteration, method);
+          }
 
-          if (!new_model.leq(previous_model)) {
+          if (changed) {
+            model_changes.record(method);
+            context.statistics->log_model_changed();
             if (context.call_graph->has_callees(method)) {
               new_methods_to_analyze->insert(method);
             }
-            for (const auto* dependency :
-                 context.dependencies->dependencies(method)) {
-              new_methods_to_analyze->insert(dependency);
+            auto dependencies = Dependencies::Callers(nullptr, nullptr);
+            // Changes confined to issues do not affect callers.
+            if (!new_model.leq_caller_visible(*previous_model)) {
+              dependencies = context.dependencies->dependencies(method);
+              for (const auto* dependency : dependencies) {
+                new_methods_to_analyze->insert(dependency);
+              }
+              context.statistics->log_dependents_enqueued(dependencies.size());
+            }
+            if (context.convergence_report) {
+              context.convergence_report->changed(
+                  iteration, method, *previous_model, new_model, dependencies);
             }
-          }
 
-          registry.set(new_model);
+            // Unchanged models keep their snapshot, which lets callers reuse
+            // cached results computed from it.
+            registry.set(std::move(new_model));
+          }
+          if (context.progress) {
+            context.progress->complete_work_item();
+          }
         },
         threads);
     context.scheduler->schedule(
@@ -262,17 +717,650 @@ void Interprocedural::run_analysis(Context& context, Registry& registry) {
         },
         threads);
     queue.run_all();
+    if (deterministic) {
+      registry.unfreeze();
+    }
+    context.statistics->end_iteration();
 
+    context.statistics->log_trace_span(
+        fmt::format("global_iteration_{}", iteration), iteration_timer);
     LOG(1,
         "Global iteration {} completed in {:.2f}s.",
         iteration,
         iteration_timer.duration_in_seconds());
 
     methods_to_analyze = std::move(new_methods_to_analyze);
+
+    auto checkpoint_interval = context.options->checkpoint_interval();
+    if (checkpoint_interval &&
+        iteration % static_cast<std::size_t>(*checkpoint_interval) == 0 &&
+        methods_to_analyze->size() > 0) {
+      Checkpoint::store(
+          context.options->checkpoint_output_path(),
+          iteration,
+          *methods_to_analyze,
+          context,
+          registry);
+    }
   }
 
   context.statistics->log_number_iterations(iteration);
+}
+
+/*
+ * Scheduling state of a method in the worklist fixpoint.
+ *
+ * A method is never analyzed by two threads at the same time: if one of its
+ * callees changes while it is being analyzed, it is marked as `RunningDirty`
+ * and re-enqueued once the current analysis completes.
+ */
+struct WorklistState {
+  enum class Status { Idle, Queued, Running, RunningDirty };
+
+  Status status = Status::Idle;
+  // Number of times the method was analyzed.
+  std::size_t analyses = 0;
+};
+
+/*
+ * Compute the global fixpoint without global iterations: whenever the model
+ * of a method changes, its dependencies are immediately pushed back on the
+ * work queue. Instead of a global iteration limit, each method has a budget
+ * of `Heuristics::kMaxNumberMethodAnalyses` analyses.
+ */
+void run_worklist(
+    Context& context,
+    Registry& registry,
+    const Deadline& deadline,
+    const ConcurrentMethodSet* MT_NULLABLE initial_methods) {
+  unsigned int threads = sparta::parallel::default_num_threads();
+  if (context.options->sequential()) {
+    WARNING(1, "Running sequentially!");
+    threads = 1u;
+  }
+
+  auto resident_set_size = resident_set_size_in_gb();
+  context.statistics->log_resident_set_size(resident_set_size);
+  LOG(1,
+      "Worklist fixpoint. Analyzing {} methods... (Memory used, RSS: {:.2f}GB)",
+      context.methods->size(),
+      resident_set_size);
+
+  ForwardAliasCache forward_alias_cache;
+  ModelChanges model_changes(context.options->widen_changing_models());
+  ConcurrentMap<const Method*, WorklistState> states;
+  ConcurrentSet<const Method*> unstable_methods;
+  std::atomic<std::size_t> method_iteration(0);
+  std::atomic<std::size_t> max_analyses(0);
+
+  using Status = WorklistState::Status;
+
+  // Mark the method as needing a re-analysis. Returns true if the method needs
+  // to be pushed on the work queue.
+  auto invalidate = [&](const Method* method) {
+    if (unstable_methods.count(method) > 0) {
+      return false;
+    }
+    bool push = false;
+    states.update(
+        method,
+        [&](const Method* /* method */,
+            WorklistState& state,
+            bool /* exists */) {
+          switch (state.status) {
+            case Status::Idle:
+              state.status = Status::Queued;
+              push = true;
+              break;
+            case Status::Running:
+              state.status = Status::RunningDirty;
+              break;
+            case Status::Queued:
+            case Status::RunningDirty:
+              break;
+          }
+        });
+    return push;
+  };
+
+  auto worker_placement = make_worker_placement(context, threads);
+
+  auto queue = work_queue<const Method*>(
+      [&](WorkerState<const Method*>* worker_state, const Method* method) {
+        if (worker_placement) {
+          worker_placement->pin(worker_state->worker_id());
+        }
+
+        auto push_task = [&](const Method* method_to_push) {
+          if (context.progress) {
+            context.progress->add_work_items(1);
+          }
+          worker_state->push_task(method_to_push);
+        };
+
+        std::size_t analyses = 0;
+        states.update(
+            method,
+            [&](const Method* /* method */,
+                WorklistState& state,
+                bool /* exists */) {
+              mt_assert(state.status == Status::Queued);
+              state.status = Status::Running;
+              analyses = ++state.analyses;
+            });
+
+        auto processed = ++method_iteration;
+        if (processed % 10000 == 0) {
+          LOG_IF_INTERACTIVE(1, "Processed {} methods.", processed);
+        }
+
+        const auto previous_model = registry.get_snapshot(method);
+        bool changed = false;
+        bool caller_visible_change = false;
+        if (analyses > Heuristics::kMaxNumberMethodAnalyses) {
+          unstable_methods.insert(method);
+        } else if (skips_analysis(context, *previous_model)) {
+          LOG(3, "Skipping `{}`...", method->show());
+        } else {
+          auto new_model = analyze(
+              context,
+              registry,
+              forward_alias_cache,
+              deadline,
+              *previous_model,
+              model_changes.widens(method));
+          changed = join_if_changed(new_model, *previous_model);
+          caller_visible_change =
+              changed && !new_model.leq_caller_visible(*previous_model);
+          if (context.convergence_report) {
+            context.convergence_report->analyzed(analyses, method);
+            if (changed) {
+              // Callers are invalidated below, unless they are already queued.
+              auto dependencies = caller_visible_change
+                  ? context.dependencies->dependencies(method)
+                  : Dependencies::Callers(nullptr, nullptr);
+              context.convergence_report->changed(
+                  analyses, method, *previous_model, new_model, dependencies);
+            }
+          }
+          if (changed) {
+            model_changes.record(method);
+            context.statistics->log_model_changed();
+            registry.set(std::move(new_model));
+          }
+        }
+
+        auto previous_max_analyses = max_analyses.load();
+        while (previous_max_analyses < analyses &&
+               !max_analyses.compare_exchange_weak(
+                   previous_max_analyses, analyses)) {
+        }
+
+        if (changed) {
+          if (context.call_graph->has_callees(method) && invalidate(method)) {
+            push_task(method);
+          }
+        }
+        if (caller_visible_change) {
+          std::vector<const Method*> dependencies_to_push;
+          for (const auto* dependency :
+               context.dependencies->dependencies(method)) {
+            if (invalidate(dependency)) {
+              dependencies_to_push.push_back(dependency);
+            }
+          }
+          context.statistics->log_dependents_enqueued(
+              dependencies_to_push.size());
+          // Push callees before callers, and widely called methods first.
+          context.scheduler->sort_by_priority(dependencies_to_push);
+          for (const auto* dependency : dependencies_to_push) {
+            push_task(dependency);
+          }
+        }
+
+        bool push = false;
+        states.update(
+            method,
+            [&](const Method* /* method */,
+                WorklistState& state,
+                bool /* exists */) {
+              if (state.status == Status::RunningDirty &&
+                  unstable_methods.count(method) == 0) {
+                state.status = Status::Queued;
+                push = true;
+              } else {
+                state.status = Status::Idle;
+              }
+            });
+        if (push) {
+          push_task(method);
+        }
+        if (context.progress) {
+          context.progress->complete_work_item();
+        }
+      },
+      threads,
+      /* push_tasks_while_running */ true);
+
+  ConcurrentMethodSet methods_to_analyze(*context.methods);
+  for (const auto* method : *context.methods) {
+    if (!analyzed_initially(context, initial_methods, method)) {
+      states.emplace(method, WorklistState{Status::Idle, 0});
+      continue;
+    }
+    methods_to_analyze.insert(method);
+    states.emplace(method, WorklistState{Status::Queued, 0});
+  }
+  // Methods pushed again on the queue are added to the work items.
+  if (context.progress) {
+    context.progress->start_iteration(
+        /* iteration */ 1, methods_to_analyze.size());
+  }
+  context.scheduler->schedule(
+      methods_to_analyze,
+      [&](const Method* method, std::size_t worker_id) {
+        queue.add_item(method, worker_id);
+      },
+      threads);
+  queue.run_all();
+  context.statistics->end_iteration();
+
+  context.statistics->log_resident_set_size(resident_set_size_in_gb());
+  LOG(1,
+      "Worklist fixpoint completed after {} method analyses.",
+      method_iteration.load());
+
+  if (unstable_methods.size() > 0) {
+    ERROR(1, "Too many iterations");
+    std::string message = "Unstable methods are:";
+    for (const auto* method : unstable_methods) {
+      message.append(fmt::format("\n`{}`", method->show()));
+    }
+    LOG(1, message);
+    throw std::runtime_error("Too many iterations, exiting.");
+  }
+
+  context.statistics->log_number_iterations(max_analyses.load());
+}
+
+/*
+ * Compute the global fixpoint bottom-up on the graph of strongly connected
+ * components: each component is iterated to its local fixpoint, and a
+ * component is only analyzed once all the components containing its callees
+ * are stable. Each component has a budget of `Heuristics::kMaxNumberIterations`
+ * local iterations.
+ */
+void run_strongly_connected_components(
+    Context& context,
+    Registry& registry,
+    const Deadline& deadline) {
+  unsigned int threads = sparta::parallel::default_num_threads();
+  if (context.options->sequential()) {
+    WARNING(1, "Running sequentially!");
+    threads = 1u;
+  }
+
+  if (context.analysis_cache) {
+    WARNING(
+        1,
+        "The analysis cache is not used by the strongly connected components fixpoint.");
+  }
+
+  const auto& scheduler = *context.scheduler;
+  auto components_size = scheduler.components_size();
+  ForwardAliasCache forward_alias_cache;
+  ModelChanges model_changes(context.options->widen_changing_models());
+
+  auto resident_set_size = resident_set_size_in_gb();
+  context.statistics->log_resident_set_size(resident_set_size);
+  LOG(1,
+      "Strongly connected components fixpoint. Analyzing {} components... (Memory used, RSS: {:.2f}GB)",
+      components_size,
+      resident_set_size);
+  if (context.progress) {
+    context.progress->start_iteration(/* iteration */ 1, components_size);
+  }
+
+  // Number of components containing callees that are not yet stable.
+  std::vector<std::atomic<std::size_t>> pending_callee_components(
+      components_size);
+  for (std::size_t component = 0; component < components_size; component++) {
+    pending_callee_components[component] =
+        scheduler.callee_components_size(component);
+  }
+
+  bool remove_collapsed_traces =
+      Interprocedural::removes_collapsed_traces(context);
+  // The analysis cache hashes control flow graphs when it is stored.
+  bool release_control_flow_graphs =
+      context.options->release_control_flow_graphs() &&
+      context.analysis_cache == nullptr;
+  // Stable models are only read, hence can share the data of equal frames.
+  std::unique_ptr<FrameInterner> frame_interner =
+      context.options->intern_stable_frames()
+      ? std::make_unique<FrameInterner>()
+      : nullptr;
+  std::atomic<std::size_t> interned_models(0);
+  ConcurrentSet<const Method*> unstable_methods;
+  std::atomic<std::size_t> components_processed(0);
+  std::atomic<std::size_t> max_iterations(0);
+  std::atomic<std::size_t> large_components(0);
+
+  // The models of a stable component are only read by its dependent
+  // components. Once these are stable too, the models are cold and can be
+  // evicted, since the model streamer already wrote them.
+  auto resident_set_size_target = context.options->resident_set_size_target();
+  std::vector<std::vector<std::size_t>> callee_components;
+  std::vector<std::atomic<std::size_t>> pending_dependent_components;
+  std::mutex cold_components_mutex;
+  std::vector<std::size_t> cold_components;
+  std::atomic<std::size_t> evicted_models(0);
+  if (resident_set_size_target) {
+    callee_components.resize(components_size);
+    pending_dependent_components =
+        std::vector<std::atomic<std::size_t>>(components_size);
+    for (std::size_t component = 0; component < components_size; component++) {
+      const auto& dependents = scheduler.dependent_components(component);
+      pending_dependent_components[component] = dependents.size();
+      for (auto dependent : dependents) {
+        callee_components[dependent].push_back(component);
+      }
+    }
+  }
+  auto evict_cold_models = [&](std::size_t component, std::size_t processed) {
+    {
+      std::lock_guard<std::mutex> lock(cold_components_mutex);
+      if (scheduler.dependent_components(component).empty()) {
+        cold_components.push_back(component);
+      }
+      for (auto callee_component : callee_components[component]) {
+        if (--pending_dependent_components[callee_component] == 0) {
+          cold_components.push_back(callee_component);
+        }
+      }
+    }
+    if (processed % k_resident_set_size_check_interval != 0 ||
+        resident_set_size_in_gb() <= *resident_set_size_target) {
+      return;
+    }
+    std::vector<std::size_t> components_to_evict;
+    {
+      std::lock_guard<std::mutex> lock(cold_components_mutex);
+      components_to_evict.swap(cold_components);
+    }
+    for (auto cold_component : components_to_evict) {
+      for (const auto* method : scheduler.component(cold_component)) {
+        registry.evict(method);
+        evicted_models++;
+      }
+    }
+  };
+
+  auto worker_placement = make_worker_placement(context, threads);
+
+  auto queue = work_queue<std::size_t>(
+      [&](WorkerState<std::size_t>* worker_state, std::size_t component) {
+        if (worker_placement) {
+          worker_placement->pin(worker_state->worker_id());
+        }
+
+        const auto& methods = scheduler.component(component);
+
+        // Iterating on the reverse order here seems to give callees before
+        // callers more often, even though this is not guaranteed by Tarjan's
+        // algorithm.
+        std::vector<const Method*> methods_to_analyze(
+            methods.rbegin(), methods.rend());
+        // Methods of large components are analyzed in parallel within each
+        // local iteration. They only read the models of the previous local
+        // iteration or of concurrently analyzed methods, which is sound since
+        // the component is iterated to its fixpoint. Which models are read
+        // then depends on the timing of the threads, hence large components
+        // are analyzed sequentially with `--deterministic`.
+        bool parallel = !context.options->deterministic() &&
+            scheduler.is_large_component(component, threads);
+        if (parallel) {
+          large_components++;
+        }
+        std::size_t iteration = 0;
+        while (!methods_to_analyze.empty()) {
+          iteration++;
+          if (iteration > Heuristics::kMaxNumberIterations) {
+            for (const auto* method : methods_to_analyze) {
+              unstable_methods.insert(method);
+            }
+            break;
+          }
+
+          ConcurrentSet<const Method*> new_methods_to_analyze;
+          auto analyze_method = [&](const Method* method) {
+            const auto previous_model = registry.get_snapshot(method);
+            if (skips_analysis(context, *previous_model)) {
+              LOG(3, "Skipping `{}`...", method->show());
+              return;
+            }
+
+            auto new_model = analyze(
+                context,
+                registry,
+                forward_alias_cache,
+                deadline,
+                *previous_model,
+                model_changes.widens(method));
+
+            if (join_if_changed(new_model, *previous_model)) {
+              model_changes.record(method);
+              context.statistics->log_model_changed();
+              if (context.call_graph->has_callees(method)) {
+                new_methods_to_analyze.insert(method);
+              }
+              // Dependencies in other components are not analyzed yet, they
+              // will see the stable model of this component. Changes confined
+              // to issues do not affect callers.
+              if (!new_model.leq_caller_visible(*previous_model)) {
+                std::size_t dependents = 0;
+                for (const auto* dependency :
+                     context.dependencies->dependencies(method)) {
+                  if (scheduler.component_of(dependency) == component) {
+                    new_methods_to_analyze.insert(dependency);
+                    dependents++;
+                  }
+                }
+                context.statistics->log_dependents_enqueued(dependents);
+              }
+
+              registry.set(std::move(new_model));
+            }
+          };
+          if (parallel && methods_to_analyze.size() > 1) {
+            auto component_queue =
+                work_queue<const Method*>(analyze_method, threads);
+            for (const auto* method : methods_to_analyze) {
+              component_queue.add_item(method);
+            }
+            component_queue.run_all();
+          } else {
+            for (const auto* method : methods_to_analyze) {
+              analyze_method(method);
+            }
+          }
+
+          // Preserve the scheduling order within the component.
+          std::vector<const Method*> next_methods_to_analyze;
+          for (auto iterator = methods.rbegin(), end = methods.rend();
+               iterator != end;
+               ++iterator) {
+            if (new_methods_to_analyze.count(*iterator) > 0) {
+              next_methods_to_analyze.push_back(*iterator);
+            }
+          }
+          methods_to_analyze = std::move(next_methods_to_analyze);
+        }
+
+        auto previous_max_iterations = max_iterations.load();
+        while (previous_max_iterations < iteration &&
+               !max_iterations.compare_exchange_weak(
+                   previous_max_iterations, iteration)) {
+        }
+
+        // The component and its callees are stable, hence its models are
+        // final. They must be postprocessed before the dependent components
+        // read them. This overlaps with the analysis of other components.
+        if (context.model_streamer) {
+          context.model_streamer->stream_component(registry, methods);
+        } else if (remove_collapsed_traces) {
+          PostprocessTraces::remove_collapsed_traces(
+              registry, context, methods);
+        }
+
+        // Components are never analyzed again once they are stable.
+        if (release_control_flow_graphs) {
+          for (const auto* method : methods) {
+            forward_alias_cache.erase(method);
+            ControlFlowGraphs::release(method);
+          }
+        }
+
+        if (frame_interner) {
+          for (const auto* method : methods) {
+            registry.update(method, [&frame_interner](Model& model) {
+              model.intern_frames(*frame_interner);
+            });
+          }
+          interned_models += methods.size();
+        }
+
+        auto processed = ++components_processed;
+        if (resident_set_size_target) {
+          evict_cold_models(component, processed);
+        }
+        if (context.progress) {
+          context.progress->complete_work_item();
+        }
+        if (processed % 10000 == 0) {
+          LOG_IF_INTERACTIVE(
+              1, "Processed {}/{} components.", processed, components_size);
+        }
+
+        for (auto dependent_component :
+             scheduler.dependent_components(component)) {
+          if (--pending_callee_components[dependent_component] == 0) {
+            worker_state->push_task(dependent_component);
+          }
+        }
+      },
+      threads,
+      /* push_tasks_while_running */ true);
+
+  // Dependent components are pushed on the worker completing their last
+  // callee component. With several NUMA nodes, components are partitioned
+  // across nodes with their callee components, so that the models they read
+  // are mostly allocated on their node.
+  std::unique_ptr<Partitions> node_partitions;
+  if (worker_placement && worker_placement->nodes() > 1) {
+    node_partitions =
+        std::make_unique<Partitions>(scheduler, worker_placement->nodes());
+  }
+
+  std::size_t current_thread = 0;
+  for (std::size_t component = 0; component < components_size; component++) {
+    if (scheduler.callee_components_size(component) == 0) {
+      if (node_partitions) {
+        queue.add_item(
+            component,
+            worker_placement->next_worker(
+                node_partitions->partition_of_component(component)));
+      } else {
+        queue.add_item(component, current_thread);
+        current_thread = (current_thread + 1) % threads;
+      }
+    }
+  }
+  queue.run_all();
+  context.statistics->end_iteration();
+
+  context.statistics->log_resident_set_size(resident_set_size_in_gb());
+  LOG(1,
+      "Strongly connected components fixpoint completed, processed {} components.",
+      components_processed.load());
+  if (large_components > 0) {
+    LOG(1,
+        "Analyzed the methods of {} large components in parallel.",
+        large_components.load());
+  }
+  if (frame_interner) {
+    LOG(1,
+        "Interned the frames of {} models into {} distinct frame data.",
+        interned_models.load(),
+        frame_interner->size());
+  }
+  if (resident_set_size_target) {
+    LOG(1,
+        "Evicted {} models above the resident set size target of {:.2f}GB.",
+        evicted_models.load(),
+        *resident_set_size_target);
+  }
+
+  if (unstable_methods.size() > 0) {
+    ERROR(1, "Too many iterations");
+    std::string message = "Unstable methods are:";
+    for (const auto* method : unstable_methods) {
+      message.append(fmt::format("\n`{}`", method->show()));
+    }
+    LOG(1, message);
+    throw std::runtime_error("Too many iterations, exiting.");
+  }
+
+  context.statistics->log_number_iterations(max_iterations.load());
+}
+
+} // namespace
+
+void Interprocedural::run_analysis(Context& context, Registry& registry) {
+  LOG(1, "Computing global fixpoint...");
+
+  auto deadline =
+      Deadline::after_seconds(context.options->maximum_analysis_time());
+
+  if (context.options->enable_worklist_fixpoint()) {
+    run_worklist(context, registry, deadline, /* initial_methods */ nullptr);
+  } else if (context.options->enable_scc_fixpoint()) {
+    run_strongly_connected_components(context, registry, deadline);
+  } else {
+    run_global_iterations(
+        context, registry, deadline, /* initial_methods */ nullptr);
+  }
+
+  LOG(2, "Global fixpoint reached.");
+}
+
+void Interprocedural::run_analysis(
+    Context& context,
+    Registry& registry,
+    const ConcurrentMethodSet& methods_to_analyze) {
+  mt_assert(!context.options->enable_scc_fixpoint());
+  LOG(1,
+      "Computing global fixpoint from {} methods...",
+      methods_to_analyze.size());
+
+  auto deadline =
+      Deadline::after_seconds(context.options->maximum_analysis_time());
+
+  if (context.options->enable_worklist_fixpoint()) {
+    run_worklist(context, registry, deadline, &methods_to_analyze);
+  } else {
+    run_global_iterations(context, registry, deadline, &methods_to_analyze);
+  }
+
   LOG(2, "Global fixpoint reached.");
 }
 
+bool Interprocedural::removes_collapsed_traces(const Context& context) {
+  if (!context.options->enable_scc_fixpoint()) {
+    return false;
+  }
+  // Streamed components are always postprocessed, see `ModelStreamer`.
+  return context.model_streamer != nullptr || context.analysis_cache == nullptr;
+}
+
 } // namespace marianatrench
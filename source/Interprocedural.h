@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <mariana-trench/ConcurrentMethodSet.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/Registry.h>
 
@@ -15,6 +16,26 @@ namespace marianatrench {
 class Interprocedural final {
  public:
   static void run_analysis(Context& context, Registry& registry);
+
+  /**
+   * Compute the global fixpoint from the current models of the registry,
+   * initially analyzing only the given methods. This is not supported by the
+   * strongly connected components fixpoint.
+   */
+  static void run_analysis(
+      Context& context,
+      Registry& registry,
+      const ConcurrentMethodSet& methods_to_analyze);
+
+  /**
+   * Whether `run_analysis` removes the collapsed traces of each strongly
+   * connected component as soon as its models are final, in which case
+   * `PostprocessTraces::remove_collapsed_traces` must not run afterwards.
+   *
+   * This is not done when the models are stored in the analysis cache, since
+   * the cache must hold the models of the fixpoint.
+   */
+  static bool removes_collapsed_traces(const Context& context);
 };
 
 } // namespace marianatrench
@@ -157,13 +157,32 @@ Json::Value Issue::to_json(ExportOriginsMode export_origins_mode) const {
   value["rule"] = Json::Value(rule_->code());
   value["position"] = position_->to_json();
   value["sink_index"] = std::to_string(sink_index_);
-  value["callee"] = callee_;
+  value["callee"] = callee_->str_copy();
 
   JsonValidation::update_object(value, features().to_json());
 
   return value;
 }
 
+void Issue::write_json(
+    JsonWriter& writer,
+    ExportOriginsMode export_origins_mode) const {
+  mt_assert(!is_bottom());
+
+  writer.begin_object();
+  writer.key("callee").value(callee_->str());
+  writer.key("position");
+  position_->write_json(writer);
+  writer.key("rule").value(rule_->code());
+  writer.key("sink_index").value(std::to_string(sink_index_));
+  writer.key("sinks");
+  sinks_.write_json(writer, export_origins_mode);
+  writer.key("sources");
+  sources_.write_json(writer, export_origins_mode);
+  features().write_json_members(writer);
+  writer.end_object();
+}
+
 std::ostream& operator<<(std::ostream& out, const Issue& issue) {
   out << "Issue(sources=" << issue.sources_ << ", sinks=" << issue.sinks_
       << ", rule=";
@@ -172,7 +191,7 @@ std::ostream& operator<<(std::ostream& out, const Issue& issue) {
   } else {
     out << "null";
   }
-  return out << ", callee=" << show(issue.callee_)
+  return out << ", callee=" << issue.callee()
              << ", sink_index=" << issue.sink_index_
              << ", position=" << show(issue.position_) << ")";
 }
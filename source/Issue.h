@@ -12,9 +12,12 @@
 
 #include <sparta/AbstractDomain.h>
 
+#include <DexClass.h>
+
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/Compiler.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/Rule.h>
 #include <mariana-trench/Taint.h>
 
@@ -31,7 +34,7 @@ class Issue final : public sparta::AbstractDomain<Issue> {
       : sources_(Taint::bottom()),
         sinks_(Taint::bottom()),
         rule_(nullptr),
-        callee_(std::string(k_return_callee)),
+        callee_(nullptr),
         sink_index_(0),
         position_(nullptr) {}
 
@@ -45,7 +48,7 @@ class Issue final : public sparta::AbstractDomain<Issue> {
       : sources_(std::move(sources)),
         sinks_(std::move(sinks)),
         rule_(rule),
-        callee_(std::string(callee)),
+        callee_(DexString::make_string(callee)),
         sink_index_(sink_index),
         position_(position) {}
 
@@ -63,8 +66,8 @@ class Issue final : public sparta::AbstractDomain<Issue> {
     return rule_;
   }
 
-  const std::string& callee() const {
-    return callee_;
+  std::string_view callee() const {
+    return callee_ != nullptr ? callee_->str() : std::string_view();
   }
 
   TextualOrderIndex sink_index() const {
@@ -128,6 +131,8 @@ class Issue final : public sparta::AbstractDomain<Issue> {
   FeatureMayAlwaysSet features() const;
 
   Json::Value to_json(ExportOriginsMode export_origins_mode) const;
+  void write_json(JsonWriter& writer, ExportOriginsMode export_origins_mode)
+      const;
 
   // Describe how to join issues together in `IssueSet`.
   struct GroupEqual {
@@ -145,7 +150,9 @@ class Issue final : public sparta::AbstractDomain<Issue> {
   Taint sources_;
   Taint sinks_;
   const Rule* MT_NULLABLE rule_;
-  std::string callee_;
+  // Callees are interned, since issues are re-created at every iteration. This
+  // is null for the bottom issue.
+  const DexString* MT_NULLABLE callee_;
   TextualOrderIndex sink_index_;
   const Position* MT_NULLABLE position_;
 };
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+
+#include <mariana-trench/IssueIndex.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+/* Issues with their compact json string, sorted by that string. */
+std::vector<std::pair<std::string, Json::Value>> sorted_issues(
+    std::vector<Json::Value> issues) {
+  auto writer = JsonValidation::compact_writer();
+  std::vector<std::pair<std::string, Json::Value>> result;
+  result.reserve(issues.size());
+  for (auto& issue : issues) {
+    std::ostringstream string;
+    writer->write(issue, &string);
+    result.emplace_back(string.str(), std::move(issue));
+  }
+  std::sort(
+      result.begin(), result.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+      });
+  return result;
+}
+
+} // namespace
+
+bool IssueIndex::Key::operator==(const Key& other) const {
+  return rule == other.rule && callee == other.callee &&
+      sink_index == other.sink_index && position == other.position;
+}
+
+std::size_t IssueIndex::KeyHash::operator()(const Key& key) const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, key.rule);
+  boost::hash_combine(seed, key.position);
+  boost::hash_combine(seed, key.sink_index);
+  boost::hash_combine(seed, key.callee);
+  return seed;
+}
+
+IssueIndex::IssueIndex(const Registry& registry, const Context& context) {
+  auto queue = work_queue<const Method*>(
+      [this, &registry](const Method* method) {
+        add(method, registry.get_snapshot(method)->issues());
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+}
+
+void IssueIndex::add(const Method* method, const IssueSet& issues) {
+  for (const auto& issue : issues) {
+    entries_.update(
+        Key{issue.rule(),
+            std::string(issue.callee()),
+            issue.sink_index(),
+            issue.position()},
+        [method, &issue](const Key& /* key */, Entry& entry, bool exists) {
+          if (exists) {
+            entry.issue.join_with(issue);
+          } else {
+            entry.issue = issue;
+          }
+          entry.methods.push_back(method);
+        });
+  }
+}
+
+std::vector<Json::Value> IssueIndex::to_json(
+    ExportOriginsMode export_origins_mode) const {
+  std::vector<Json::Value> issues;
+  issues.reserve(entries_.size());
+  for (const auto& [_, entry] : entries_) {
+    std::vector<std::string> methods;
+    methods.reserve(entry.methods.size());
+    for (const auto* method : entry.methods) {
+      methods.push_back(method->show());
+    }
+    std::sort(methods.begin(), methods.end());
+    methods.erase(std::unique(methods.begin(), methods.end()), methods.end());
+
+    auto value = entry.issue.to_json(export_origins_mode);
+    auto methods_value = Json::Value(Json::arrayValue);
+    for (const auto& method : methods) {
+      methods_value.append(method);
+    }
+    value["methods"] = methods_value;
+    issues.push_back(std::move(value));
+  }
+
+  std::vector<Json::Value> result;
+  result.reserve(issues.size());
+  for (auto& [_, issue] : sorted_issues(std::move(issues))) {
+    result.push_back(std::move(issue));
+  }
+  return result;
+}
+
+void IssueIndex::dump(
+    const std::filesystem::path& path,
+    ExportOriginsMode export_origins_mode) const {
+  std::ofstream file;
+  file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  file.open(path, std::ios_base::binary);
+  file << "// @";
+  file << "generated\n";
+  auto writer = JsonValidation::compact_writer();
+  for (const auto& issue : to_json(export_origins_mode)) {
+    writer->write(issue, &file);
+    file << "\n";
+  }
+  file.close();
+}
+
+} // namespace marianatrench
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include <json/json.h>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/ExportOriginsMode.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Issue.h>
+#include <mariana-trench/IssueSet.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Index of the issues of all methods, written in `issues.json` with
+ * `--dump-issues`.
+ *
+ * Issues with the same rule, callee, sink index and position are merged into a
+ * single issue, which lists the methods reporting it. `IssueSet` already merges
+ * these within a method, but methods sharing positions, such as bridges and
+ * synthetic accessors, report the same logical issue. Consumers can read the
+ * merged issues without reading back every model.
+ */
+class IssueIndex final {
+ private:
+  struct Key {
+    const Rule* rule;
+    std::string callee;
+    TextualOrderIndex sink_index;
+    const Position* position;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Issue issue;
+    std::vector<const Method*> methods;
+  };
+
+ public:
+  IssueIndex() = default;
+
+  /* Index the issues of the models of all methods, in parallel. */
+  explicit IssueIndex(const Registry& registry, const Context& context);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(IssueIndex)
+
+  /* Add the issues of the given method. This is thread-safe. */
+  void add(const Method* method, const IssueSet& issues);
+
+  /* Number of merged issues. */
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+  /* Merged issues, sorted for a deterministic output. */
+  std::vector<Json::Value> to_json(ExportOriginsMode export_origins_mode) const;
+
+  /* Write the merged issues as json lines. */
+  void dump(
+      const std::filesystem::path& path,
+      ExportOriginsMode export_origins_mode) const;
+
+ private:
+  ConcurrentMap<Key, Entry, KeyHash> entries_;
+};
+
+} // namespace marianatrench
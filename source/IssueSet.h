@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include <mariana-trench/GroupHashedSetAbstractDomain.h>
+#include <mariana-trench/FlatGroupHashedSetAbstractDomain.h>
 #include <mariana-trench/Issue.h>
 
 namespace marianatrench {
@@ -15,7 +15,9 @@ namespace marianatrench {
 /**
  * Represents an abstract set of issues.
  */
-using IssueSet =
-    GroupHashedSetAbstractDomain<Issue, Issue::GroupHash, Issue::GroupEqual>;
+using IssueSet = FlatGroupHashedSetAbstractDomain<
+    Issue,
+    Issue::GroupHash,
+    Issue::GroupEqual>;
 
 } // namespace marianatrench
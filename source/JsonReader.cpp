@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <mariana-trench/JsonReader.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Same as the default `stackLimit` of `Json::CharReaderBuilder`.
+constexpr std::size_t k_maximum_depth = 1000;
+
+class Parser final {
+ public:
+  explicit Parser(std::string_view input)
+      : current_(input.data()), end_(input.data() + input.size()) {}
+
+  bool parse(Json::Value& value) {
+    if (!parse_value(value, /* depth */ 0)) {
+      return false;
+    }
+    skip_spaces();
+    return current_ == end_;
+  }
+
+ private:
+  void skip_spaces() {
+    while (current_ != end_ &&
+           (*current_ == ' ' || *current_ == '\n' || *current_ == '\t' ||
+            *current_ == '\r')) {
+      current_++;
+    }
+  }
+
+  bool consume(std::string_view literal) {
+    if (static_cast<std::size_t>(end_ - current_) < literal.size() ||
+        std::memcmp(current_, literal.data(), literal.size()) != 0) {
+      return false;
+    }
+    current_ += literal.size();
+    return true;
+  }
+
+  bool parse_value(Json::Value& value, std::size_t depth) {
+    skip_spaces();
+    if (current_ == end_) {
+      return false;
+    }
+
+    switch (*current_) {
+      case '{':
+        return parse_object(value, depth + 1);
+      case '[':
+        return parse_array(value, depth + 1);
+      case '"': {
+        std::string_view string;
+        if (!parse_string(string)) {
+          return false;
+        }
+        value = Json::Value(string.data(), string.data() + string.size());
+        return true;
+      }
+      case 't':
+        value = Json::Value(true);
+        return consume("true");
+      case 'f':
+        value = Json::Value(false);
+        return consume("false");
+      case 'n':
+        value = Json::Value(Json::nullValue);
+        return consume("null");
+      default:
+        return parse_number(value);
+    }
+  }
+
+  bool parse_object(Json::Value& value, std::size_t depth) {
+    if (depth > k_maximum_depth) {
+      return false;
+    }
+    current_++; // '{'
+    value = Json::Value(Json::objectValue);
+
+    skip_spaces();
+    if (current_ != end_ && *current_ == '}') {
+      current_++;
+      return true;
+    }
+
+    std::string_view key;
+    while (true) {
+      skip_spaces();
+      if (current_ == end_ || *current_ != '"' || !parse_string(key)) {
+        return false;
+      }
+      skip_spaces();
+      if (current_ == end_ || *current_ != ':') {
+        return false;
+      }
+      current_++;
+
+      // As jsoncpp, the last duplicate member wins.
+      auto* member = value.demand(key.data(), key.data() + key.size());
+      if (!parse_value(*member, depth)) {
+        return false;
+      }
+
+      skip_spaces();
+      if (current_ == end_) {
+        return false;
+      }
+      if (*current_ == ',') {
+        current_++;
+      } else if (*current_ == '}') {
+        current_++;
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  bool parse_array(Json::Value& value, std::size_t depth) {
+    if (depth > k_maximum_depth) {
+      return false;
+    }
+    current_++; // '['
+    value = Json::Value(Json::arrayValue);
+
+    skip_spaces();
+    if (current_ != end_ && *current_ == ']') {
+      current_++;
+      return true;
+    }
+
+    while (true) {
+      auto& element = value.append(Json::Value());
+      if (!parse_value(element, depth)) {
+        return false;
+      }
+
+      skip_spaces();
+      if (current_ == end_) {
+        return false;
+      }
+      if (*current_ == ',') {
+        current_++;
+      } else if (*current_ == ']') {
+        current_++;
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  bool parse_hex(unsigned int& code_point) {
+    if (end_ - current_ < 4) {
+      return false;
+    }
+    code_point = 0;
+    for (int i = 0; i < 4; i++) {
+      char c = *current_++;
+      code_point <<= 4;
+      if (c >= '0' && c <= '9') {
+        code_point |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        code_point |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        code_point |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void append_utf8(std::string& string, unsigned int code_point) {
+    if (code_point < 0x80) {
+      string.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+      string.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+      string.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else if (code_point < 0x10000) {
+      string.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+      string.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+      string.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else {
+      string.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+      string.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+      string.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+      string.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    }
+  }
+
+  /**
+   * The result points into the input when the string has no escape sequence,
+   * or into `buffer_` otherwise. It is only valid until the next string.
+   */
+  bool parse_string(std::string_view& result) {
+    current_++; // '"'
+    const char* begin = current_;
+    bool escaped = false;
+
+    while (true) {
+      const char* run = current_;
+      while (current_ != end_ && *current_ != '"' && *current_ != '\\' &&
+             static_cast<unsigned char>(*current_) >= 0x20) {
+        current_++;
+      }
+      if (escaped) {
+        buffer_.append(run, current_);
+      }
+
+      if (current_ == end_ || static_cast<unsigned char>(*current_) < 0x20) {
+        return false;
+      }
+      if (*current_ == '"') {
+        result = escaped ? std::string_view(buffer_)
+                         : std::string_view(begin, current_ - begin);
+        current_++;
+        return true;
+      }
+
+      if (!escaped) {
+        escaped = true;
+        buffer_.assign(begin, current_);
+      }
+      current_++; // '\\'
+      if (current_ == end_) {
+        return false;
+      }
+      switch (*current_++) {
+        case '"':
+          buffer_.push_back('"');
+          break;
+        case '\\':
+          buffer_.push_back('\\');
+          break;
+        case '/':
+          buffer_.push_back('/');
+          break;
+        case 'b':
+          buffer_.push_back('\b');
+          break;
+        case 'f':
+          buffer_.push_back('\f');
+          break;
+        case 'n':
+          buffer_.push_back('\n');
+          break;
+        case 'r':
+          buffer_.push_back('\r');
+          break;
+        case 't':
+          buffer_.push_back('\t');
+          break;
+        case 'u': {
+          unsigned int code_point;
+          if (!parse_hex(code_point)) {
+            return false;
+          }
+          if (code_point >= 0xd800 && code_point <= 0xdbff) {
+            unsigned int low_surrogate;
+            if (!consume("\\u") || !parse_hex(low_surrogate) ||
+                low_surrogate < 0xdc00 || low_surrogate > 0xdfff) {
+              return false;
+            }
+            code_point = 0x10000 + ((code_point & 0x3ff) << 10) +
+                (low_surrogate & 0x3ff);
+          } else if (code_point >= 0xdc00 && code_point <= 0xdfff) {
+            return false;
+          }
+          append_utf8(buffer_, code_point);
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  }
+
+  bool parse_number(Json::Value& value) {
+    const char* begin = current_;
+    bool is_negative = false;
+    if (current_ != end_ && *current_ == '-') {
+      is_negative = true;
+      current_++;
+    }
+
+    auto is_digit = [this]() {
+      return current_ != end_ && *current_ >= '0' && *current_ <= '9';
+    };
+    if (!is_digit()) {
+      return false;
+    }
+    if (*current_ == '0') {
+      current_++;
+      // Leading zeros are not json, leave them to jsoncpp.
+      if (is_digit()) {
+        return false;
+      }
+    } else {
+      while (is_digit()) {
+        current_++;
+      }
+    }
+
+    bool is_integer = true;
+    if (current_ != end_ && *current_ == '.') {
+      is_integer = false;
+      current_++;
+      if (!is_digit()) {
+        return false;
+      }
+      while (is_digit()) {
+        current_++;
+      }
+    }
+    if (current_ != end_ && (*current_ == 'e' || *current_ == 'E')) {
+      is_integer = false;
+      current_++;
+      if (current_ != end_ && (*current_ == '+' || *current_ == '-')) {
+        current_++;
+      }
+      if (!is_digit()) {
+        return false;
+      }
+      while (is_digit()) {
+        current_++;
+      }
+    }
+
+    // As jsoncpp: integers are signed when they fit, then unsigned, and fall
+    // back to doubles when they overflow.
+    if (is_integer) {
+      if (is_negative) {
+        std::int64_t integer;
+        auto result = std::from_chars(begin, current_, integer);
+        if (result.ec == std::errc() && result.ptr == current_) {
+          value = Json::Value(static_cast<Json::Int64>(integer));
+          return true;
+        }
+      } else {
+        std::uint64_t integer;
+        auto result = std::from_chars(begin, current_, integer);
+        if (result.ec == std::errc() && result.ptr == current_) {
+          if (integer <= static_cast<std::uint64_t>(Json::Value::maxInt64)) {
+            value = Json::Value(static_cast<Json::Int64>(integer));
+          } else {
+            value = Json::Value(static_cast<Json::UInt64>(integer));
+          }
+          return true;
+        }
+      }
+    }
+
+    double real;
+    auto result = std::from_chars(begin, current_, real);
+    if (result.ec != std::errc() || result.ptr != current_) {
+      return false;
+    }
+    value = Json::Value(real);
+    return true;
+  }
+
+ private:
+  const char* current_;
+  const char* end_;
+  std::string buffer_;
+};
+
+} // namespace
+
+std::optional<Json::Value> JsonReader::parse(std::string_view input) {
+  Json::Value value;
+  if (!Parser(input).parse(value)) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+} // namespace marianatrench
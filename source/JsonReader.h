@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include <json/json.h>
+
+namespace marianatrench {
+
+/**
+ * Fast json parser building a `Json::Value`, used by `JsonValidation` for all
+ * json inputs.
+ *
+ * It only accepts strict json and produces the same values as jsoncpp's
+ * default `Json::CharReaderBuilder`. Anything else (comments, trailing
+ * content, invalid input) returns `std::nullopt`, in which case callers parse
+ * the input again with jsoncpp, which handles extensions and reports errors.
+ */
+class JsonReader final {
+ public:
+  static std::optional<Json::Value> parse(std::string_view input);
+};
+
+} // namespace marianatrench
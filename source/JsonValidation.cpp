@@ -5,20 +5,27 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <string_view>
 
-#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <fmt/format.h>
 
-#include <sparta/WorkQueue.h>
-
 #include <mariana-trench/Assert.h>
+#include <mariana-trench/Filesystem.h>
+#include <mariana-trench/JsonReader.h>
 #include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -260,34 +267,51 @@ DexFieldRef* JsonValidation::dex_field(
   return dex_field;
 }
 
+namespace {
+
+/* Parse with jsoncpp, which handles comments and reports errors. */
+bool parse_json_with_jsoncpp(
+    std::string_view input,
+    Json::Value& value,
+    std::string& errors) {
+  static const auto reader_builder = Json::CharReaderBuilder();
+  auto reader =
+      std::unique_ptr<Json::CharReader>(reader_builder.newCharReader());
+  return reader->parse(
+      input.data(), input.data() + input.size(), &value, &errors);
+}
+
+} // namespace
+
 Json::Value JsonValidation::parse_json(std::string string) {
-  std::istringstream stream(std::move(string));
+  if (auto value = JsonReader::parse(string)) {
+    return std::move(*value);
+  }
 
-  static const auto reader = Json::CharReaderBuilder();
   std::string errors;
   Json::Value json;
-
-  if (!Json::parseFromStream(reader, stream, &json, &errors)) {
+  if (!parse_json_with_jsoncpp(string, json, errors)) {
     throw std::invalid_argument(fmt::format("Invalid json: {}", errors));
   }
   return json;
 }
 
 Json::Value JsonValidation::parse_json_file(const std::filesystem::path& path) {
-  std::ifstream file;
-  file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+  std::string content;
   try {
-    file.open(path, std::ios_base::binary);
-  } catch (const std::ifstream::failure&) {
+    filesystem::load_string_file(path, content);
+  } catch (const std::exception&) {
     ERROR(1, "Could not open json file: `{}`.", path.string());
     throw;
   }
 
-  static const auto reader = Json::CharReaderBuilder();
+  if (auto value = JsonReader::parse(content)) {
+    return std::move(*value);
+  }
+
   std::string errors;
   Json::Value json;
-
-  if (!Json::parseFromStream(reader, file, &json, &errors)) {
+  if (!parse_json_with_jsoncpp(content, json, errors)) {
     throw std::invalid_argument(
         fmt::format("File `{}` is not valid json: {}", path.string(), errors));
   }
@@ -298,6 +322,130 @@ Json::Value JsonValidation::parse_json_file(const std::string& path) {
   return parse_json_file(std::filesystem::path(path));
 }
 
+std::optional<std::vector<std::string_view>>
+JsonValidation::split_json_array(std::string_view content) {
+  auto is_space = [](char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  };
+
+  std::size_t position = 0;
+  while (position < content.size() && is_space(content[position])) {
+    position++;
+  }
+  if (position == content.size() || content[position] != '[') {
+    return std::nullopt;
+  }
+  position++;
+
+  std::vector<std::string_view> elements;
+  std::size_t depth = 0;
+  std::size_t start = position;
+  bool in_string = false;
+  for (; position < content.size(); position++) {
+    char c = content[position];
+    if (in_string) {
+      if (c == '\\') {
+        position++;
+      } else if (c == '"') {
+        in_string = false;
+      }
+      continue;
+    }
+
+    switch (c) {
+      case '"':
+        in_string = true;
+        break;
+      case '/':
+        return std::nullopt;
+      case '[':
+      case '{':
+        depth++;
+        break;
+      case '}':
+        if (depth == 0) {
+          return std::nullopt;
+        }
+        depth--;
+        break;
+      case ']':
+      case ',': {
+        if (depth > 0) {
+          if (c == ']') {
+            depth--;
+          }
+          break;
+        }
+        auto element = content.substr(start, position - start);
+        if (!std::all_of(element.begin(), element.end(), is_space)) {
+          elements.push_back(element);
+        } else if (c == ',' || !elements.empty()) {
+          // Let the regular parser report empty elements.
+          return std::nullopt;
+        }
+        if (c == ']') {
+          // Only whitespace may follow the array.
+          for (position++; position < content.size(); position++) {
+            if (!is_space(content[position])) {
+              return std::nullopt;
+            }
+          }
+          return elements;
+        }
+        start = position + 1;
+        break;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+void JsonValidation::visit_json_array_file(
+    const std::filesystem::path& path,
+    const std::function<void(const Json::Value&)>& visit) {
+  std::string content;
+  try {
+    filesystem::load_string_file(path, content);
+  } catch (const std::exception&) {
+    ERROR(1, "Could not open json file: `{}`.", path.string());
+    throw;
+  }
+
+  auto elements = split_json_array(content);
+  if (!elements) {
+    auto value = parse_json(std::move(content));
+    for (const auto& element : JsonValidation::null_or_array(value)) {
+      visit(element);
+    }
+    return;
+  }
+
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        auto element = (*elements)[index];
+        if (auto value = JsonReader::parse(element)) {
+          visit(*value);
+          return;
+        }
+
+        std::string errors;
+        Json::Value value;
+        if (!parse_json_with_jsoncpp(element, value, errors)) {
+          throw std::invalid_argument(fmt::format(
+              "File `{}` is not valid json: element {}: {}",
+              path.string(),
+              index,
+              errors));
+        }
+        visit(value);
+      },
+      sparta::parallel::default_num_threads());
+  for (std::size_t index = 0; index < elements->size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+}
+
 namespace {
 
 Json::StreamWriterBuilder compact_writer_builder() {
@@ -346,45 +494,38 @@ void JsonValidation::write_sharded_json_files(
     const std::size_t batch_size,
     const std::size_t total_elements,
     const std::string& filename_prefix,
-    const std::function<Json::Value(std::size_t)>& get_json_line) {
-  // Remove existing files with filename_prefix under output_directory.
-  for (auto& file : std::filesystem::directory_iterator(output_directory)) {
-    const auto& file_path = file.path();
-    if (std::filesystem::is_regular_file(file_path) &&
-        boost::starts_with(file_path.filename().string(), filename_prefix)) {
-      std::filesystem::remove(file_path);
-    }
-  }
+    const std::function<Json::Value(std::size_t)>& get_json_line,
+    int compression_level) {
+  write_sharded_json_lines(
+      output_directory,
+      batch_size,
+      total_elements,
+      filename_prefix,
+      [&](std::size_t i, std::ostream& output) {
+        thread_local auto writer = JsonValidation::compact_writer();
+        writer->write(get_json_line(i), &output);
+      },
+      compression_level);
+}
 
+namespace {
+
+/**
+ * Call `write_shard(batch, shard_name)` for each shard in parallel, where the
+ * shard name is the file name without its prefix.
+ */
+void write_shards(
+    const std::size_t batch_size,
+    const std::size_t total_elements,
+    const std::function<void(std::size_t, const std::string&)>& write_shard) {
   const auto total_batch = total_elements / batch_size + 1;
-  const auto padded_total_batch = fmt::format("{:0>5}", total_batch);
 
-  auto queue = sparta::work_queue<std::size_t>(
+  auto queue = work_queue<std::size_t>(
       [&](std::size_t batch) {
-        const auto padded_batch = fmt::format("{:0>5}", batch);
-        const auto batch_path = output_directory /
-            (filename_prefix + padded_batch + "-of-" + padded_total_batch +
-             ".json");
-
-        std::ofstream batch_stream;
-        batch_stream.open(batch_path, std::ios_base::out);
-        if (!batch_stream.is_open()) {
-          ERROR(1, "Unable to write json lines to `{}`.", batch_path.native());
-          return;
-        }
-
-        batch_stream << "// @"
-                     << "generated\n";
-
-        // Write the current batch of models to file.
-        auto writer = JsonValidation::compact_writer();
-        for (std::size_t i = batch_size * batch;
-             i < batch_size * (batch + 1) && i < total_elements;
-             i++) {
-          writer->write(get_json_line(i), &batch_stream);
-          batch_stream << "\n";
-        }
-        batch_stream.close();
+        write_shard(
+            batch,
+            JsonValidation::json_lines_shard_name(
+                batch, batch_size, total_elements));
       },
       sparta::parallel::default_num_threads());
 
@@ -396,6 +537,131 @@ void JsonValidation::write_sharded_json_files(
   LOG(1, "Wrote json lines to {} shards.", total_batch);
 }
 
+} // namespace
+
+void JsonValidation::write_sharded_json_lines(
+    const std::filesystem::path& output_directory,
+    const std::size_t batch_size,
+    const std::size_t total_elements,
+    const std::string& filename_prefix,
+    const std::function<void(std::size_t, std::ostream&)>& write_json_line,
+    int compression_level) {
+  filesystem::remove_files_with_prefix(output_directory, filename_prefix);
+
+  write_shards(
+      batch_size,
+      total_elements,
+      [&](std::size_t batch, const std::string& shard_name) {
+        write_json_lines_file(
+            output_directory /
+                (filename_prefix + shard_name +
+                 json_lines_extension(compression_level)),
+            [&](std::ostream& batch_stream) {
+              // Write the current batch of models to file.
+              for (std::size_t i = batch_size * batch;
+                   i < batch_size * (batch + 1) && i < total_elements;
+                   i++) {
+                write_json_line(i, batch_stream);
+                batch_stream << "\n";
+              }
+            },
+            compression_level);
+      });
+}
+
+void JsonValidation::write_sharded_json_lines_with_string_tables(
+    const std::filesystem::path& output_directory,
+    const std::size_t batch_size,
+    const std::size_t total_elements,
+    const std::string& filename_prefix,
+    const std::string& string_table_prefix,
+    const std::function<void(std::size_t, JsonStringTable&, std::ostream&)>&
+        write_json_line,
+    int compression_level) {
+  filesystem::remove_files_with_prefix(output_directory, filename_prefix);
+  filesystem::remove_files_with_prefix(output_directory, string_table_prefix);
+
+  write_shards(
+      batch_size,
+      total_elements,
+      [&](std::size_t batch, const std::string& shard_name) {
+        JsonStringTable string_table;
+        write_json_lines_file(
+            output_directory /
+                (filename_prefix + shard_name +
+                 json_lines_extension(compression_level)),
+            [&](std::ostream& batch_stream) {
+              for (std::size_t i = batch_size * batch;
+                   i < batch_size * (batch + 1) && i < total_elements;
+                   i++) {
+                write_json_line(i, string_table, batch_stream);
+                batch_stream << "\n";
+              }
+            },
+            compression_level);
+        write_json_lines_file(
+            output_directory /
+                (string_table_prefix + shard_name +
+                 json_lines_extension(compression_level)),
+            [&](std::ostream& table_stream) {
+              for (const auto* string : string_table.strings()) {
+                write_json_string(table_stream, *string);
+                table_stream << "\n";
+              }
+            },
+            compression_level);
+      });
+}
+
+void JsonValidation::write_json_lines_file(
+    const std::filesystem::path& path,
+    const std::function<void(std::ostream&)>& write_json_lines,
+    int compression_level) {
+  std::ofstream file_stream;
+  file_stream.open(path, std::ios_base::out | std::ios_base::binary);
+  if (!file_stream.is_open()) {
+    ERROR(1, "Unable to write json lines to `{}`.", path.native());
+    return;
+  }
+
+  // Each shard is a complete gzip stream, so it can be decoded alone.
+  boost::iostreams::filtering_ostream stream;
+  if (compression_level > 0) {
+    stream.push(boost::iostreams::gzip_compressor(
+        boost::iostreams::gzip_params(compression_level)));
+  }
+  stream.push(file_stream);
+
+  // Keep in sync with `json_lines_header_size`.
+  stream << "// @"
+         << "generated\n";
+  write_json_lines(stream);
+  stream.reset();
+  file_stream.close();
+}
+
+const char* JsonValidation::json_lines_extension(int compression_level) {
+  return compression_level > 0 ? ".json.gz" : ".json";
+}
+
+std::string JsonValidation::json_lines_shard_name(
+    std::size_t batch,
+    std::size_t batch_size,
+    std::size_t total_elements) {
+  return fmt::format(
+      "{:0>5}-of-{:0>5}", batch, total_elements / batch_size + 1);
+}
+
+std::size_t JsonValidation::json_lines_header_size() {
+  return std::strlen("// @") + std::strlen("generated\n");
+}
+
+void JsonValidation::write_json_string(
+    std::ostream& output,
+    const std::string& string) {
+  output << Json::valueToQuotedString(string.c_str());
+}
+
 void JsonValidation::update_object(
     Json::Value& left,
     const Json::Value& right) {
@@ -10,8 +10,11 @@
 #include <filesystem>
 #include <functional>
 #include <optional>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
 #include <json/json.h>
 
@@ -19,6 +22,8 @@
 
 namespace marianatrench {
 
+class JsonStringTable;
+
 class JsonValidationError : public std::invalid_argument {
  public:
   JsonValidationError(
@@ -82,18 +87,99 @@ class JsonValidation final {
   static Json::Value parse_json_file(const std::filesystem::path& path);
   static Json::Value parse_json_file(const std::string& path);
 
+  /**
+   * Return the text of each element of the json array held in `content`, or
+   * `std::nullopt` if `content` is not a plain array (e.g, it uses comments).
+   * Elements are only split here, they are validated when parsed.
+   */
+  static std::optional<std::vector<std::string_view>> split_json_array(
+      std::string_view content);
+
+  /**
+   * Call `visit` on each element of the top-level json array stored in the
+   * given file. Elements are split without building the document of the whole
+   * file, then parsed and visited in parallel, hence `visit` must be
+   * thread-safe. A `null` document has no elements.
+   */
+  static void visit_json_array_file(
+      const std::filesystem::path& path,
+      const std::function<void(const Json::Value&)>& visit);
+
   static std::unique_ptr<Json::StreamWriter> compact_writer();
   static std::unique_ptr<Json::StreamWriter> styled_writer();
   static void write_json_file(
       const std::filesystem::path& path,
       const Json::Value& value);
 
+  /**
+   * Write `total_elements` json lines in shards of `batch_size` lines. When
+   * `compression_level` is between 1 and 9, each shard is compressed
+   * independently with gzip and gets the `.json.gz` extension.
+   */
   static void write_sharded_json_files(
       const std::filesystem::path& output_directory,
       const std::size_t batch_size,
       const std::size_t total_elements,
       const std::string& filename_prefix,
-      const std::function<Json::Value(std::size_t)>& get_json_line);
+      const std::function<Json::Value(std::size_t)>& get_json_line,
+      int compression_level = 0);
+
+  /**
+   * Same as `write_sharded_json_files`, but each element is written directly
+   * into its shard by `write_json_line`, which avoids building a `Json::Value`
+   * for large dumps. The written line must be valid compact json.
+   */
+  static void write_sharded_json_lines(
+      const std::filesystem::path& output_directory,
+      const std::size_t batch_size,
+      const std::size_t total_elements,
+      const std::string& filename_prefix,
+      const std::function<void(std::size_t, std::ostream&)>& write_json_line,
+      int compression_level = 0);
+
+  /**
+   * Same as `write_sharded_json_lines`, with one string table per shard (see
+   * `JsonStringTable`). The strings interned by `write_json_line` are written
+   * one json string per line, in order of index, in a file named as the shard
+   * with `string_table_prefix` instead of `filename_prefix`.
+   */
+  static void write_sharded_json_lines_with_string_tables(
+      const std::filesystem::path& output_directory,
+      const std::size_t batch_size,
+      const std::size_t total_elements,
+      const std::string& filename_prefix,
+      const std::string& string_table_prefix,
+      const std::function<void(std::size_t, JsonStringTable&, std::ostream&)>&
+          write_json_line,
+      int compression_level = 0);
+
+  /**
+   * Write a single shard of json lines to `path`, starting with the
+   * `@generated` header. The shard is compressed with gzip when
+   * `compression_level` is between 1 and 9.
+   */
+  static void write_json_lines_file(
+      const std::filesystem::path& path,
+      const std::function<void(std::ostream&)>& write_json_lines,
+      int compression_level = 0);
+
+  /* Extension of json lines shards for the given compression level. */
+  static const char* json_lines_extension(int compression_level);
+
+  /**
+   * Name of the shard containing the element at `batch * batch_size` in
+   * `write_sharded_json_lines`, without prefix and extension.
+   */
+  static std::string json_lines_shard_name(
+      std::size_t batch,
+      std::size_t batch_size,
+      std::size_t total_elements);
+
+  /* Size of the header written by `write_json_lines_file`. */
+  static std::size_t json_lines_header_size();
+
+  /* Write the given string as a quoted and escaped json string. */
+  static void write_json_string(std::ostream& output, const std::string& string);
 
   static std::string to_styled_string(const Json::Value& value);
 
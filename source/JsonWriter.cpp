@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
+
+namespace marianatrench {
+
+bool JsonStringTable::is_interned_key(std::string_view key) {
+  return key == "field" || key == "kind" || key == "method" || key == "path" ||
+      key == "resolves_to";
+}
+
+std::size_t JsonStringTable::index(std::string_view string) {
+  auto [iterator, inserted] =
+      indices_.emplace(std::string(string), indices_.size());
+  if (inserted) {
+    strings_.push_back(&iterator->first);
+  }
+  return iterator->second;
+}
+
+void JsonStringTable::clear() {
+  indices_.clear();
+  strings_.clear();
+}
+
+void JsonWriter::begin_object() {
+  before_value();
+  buffer_.push_back('{');
+  if (depth_ == scopes_.size()) {
+    scopes_.emplace_back();
+  }
+  auto& scope = scopes_[depth_++];
+  scope.is_object = true;
+  scope.empty = true;
+  scope.begin = buffer_.size();
+  scope.sorted = true;
+  scope.members.clear();
+}
+
+void JsonWriter::end_object() {
+  mt_assert(depth_ > 0);
+  auto& scope = scopes_[--depth_];
+  mt_assert(scope.is_object);
+
+  if (!scope.empty && !scope.sorted) {
+    scope.members.back().end = buffer_.size();
+    std::stable_sort(
+        scope.members.begin(),
+        scope.members.end(),
+        [](const Member& left, const Member& right) {
+          return left.key < right.key;
+        });
+
+    // As for `Json::Value`, the last value of a duplicate member wins.
+    reorder_buffer_.clear();
+    for (auto member = scope.members.begin(); member != scope.members.end();
+         ++member) {
+      auto next = std::next(member);
+      if (next != scope.members.end() && next->key == member->key) {
+        continue;
+      }
+      if (!reorder_buffer_.empty()) {
+        reorder_buffer_.push_back(',');
+      }
+      reorder_buffer_.append(
+          buffer_, member->begin, member->end - member->begin);
+    }
+    buffer_.replace(
+        scope.begin, buffer_.size() - scope.begin, reorder_buffer_);
+  }
+
+  buffer_.push_back('}');
+}
+
+void JsonWriter::begin_array() {
+  before_value();
+  buffer_.push_back('[');
+  if (depth_ == scopes_.size()) {
+    scopes_.emplace_back();
+  }
+  auto& scope = scopes_[depth_++];
+  scope.is_object = false;
+  scope.empty = true;
+}
+
+void JsonWriter::end_array() {
+  mt_assert(depth_ > 0);
+  mt_assert(!scopes_[depth_ - 1].is_object);
+  --depth_;
+  buffer_.push_back(']');
+}
+
+JsonWriter& JsonWriter::key(std::string_view key) {
+  mt_assert(depth_ > 0);
+  auto& scope = scopes_[depth_ - 1];
+  mt_assert(scope.is_object);
+
+  if (!scope.empty) {
+    auto& previous = scope.members.back();
+    previous.end = buffer_.size();
+    if (!(previous.key < key)) {
+      scope.sorted = false;
+    }
+    buffer_.push_back(',');
+  }
+  scope.empty = false;
+  scope.members.push_back(
+      Member{std::string(key), /* begin */ buffer_.size(), /* end */ 0});
+
+  write_quoted(key);
+  buffer_.push_back(':');
+  intern_next_value_ =
+      string_table_ != nullptr && JsonStringTable::is_interned_key(key);
+  return *this;
+}
+
+void JsonWriter::value(std::nullptr_t) {
+  before_value();
+  buffer_.append("null");
+}
+
+void JsonWriter::value(bool value) {
+  before_value();
+  buffer_.append(value ? "true" : "false");
+}
+
+void JsonWriter::value(int value) {
+  before_value();
+  buffer_.append(std::to_string(value));
+}
+
+void JsonWriter::value(unsigned int value) {
+  before_value();
+  buffer_.append(std::to_string(value));
+}
+
+void JsonWriter::value(std::int64_t value) {
+  before_value();
+  buffer_.append(std::to_string(value));
+}
+
+void JsonWriter::value(std::uint64_t value) {
+  before_value();
+  buffer_.append(std::to_string(value));
+}
+
+void JsonWriter::value(std::string_view value) {
+  bool intern = intern_next_value_;
+  before_value();
+  if (intern) {
+    buffer_.append(std::to_string(string_table_->index(value)));
+  } else {
+    write_quoted(value);
+  }
+}
+
+void JsonWriter::value(const Json::Value& value) {
+  bool intern = intern_next_value_;
+  before_value();
+  if (string_table_ != nullptr) {
+    write_interned_json_value(value, intern);
+  } else {
+    write_json_value(value);
+  }
+}
+
+void JsonWriter::write_json_value(const Json::Value& value) {
+  if (fallback_writer_ == nullptr) {
+    fallback_writer_ = JsonValidation::compact_writer();
+  }
+  fallback_stream_.str("");
+  fallback_writer_->write(value, &fallback_stream_);
+  buffer_.append(fallback_stream_.str());
+}
+
+void JsonWriter::write_interned_json_value(
+    const Json::Value& value,
+    bool intern) {
+  switch (value.type()) {
+    case Json::stringValue: {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      value.getString(&begin, &end);
+      auto string = std::string_view(begin, end - begin);
+      if (intern) {
+        buffer_.append(std::to_string(string_table_->index(string)));
+      } else {
+        write_quoted(string);
+      }
+      break;
+    }
+    case Json::arrayValue: {
+      buffer_.push_back('[');
+      bool first = true;
+      for (const auto& element : value) {
+        if (!first) {
+          buffer_.push_back(',');
+        }
+        first = false;
+        write_interned_json_value(element, /* intern */ false);
+      }
+      buffer_.push_back(']');
+      break;
+    }
+    case Json::objectValue: {
+      // Members of a `Json::Value` are sorted.
+      buffer_.push_back('{');
+      for (auto iterator = value.begin(); iterator != value.end(); ++iterator) {
+        if (iterator != value.begin()) {
+          buffer_.push_back(',');
+        }
+        auto name = iterator.name();
+        write_quoted(name);
+        buffer_.push_back(':');
+        write_interned_json_value(
+            *iterator, JsonStringTable::is_interned_key(name));
+      }
+      buffer_.push_back('}');
+      break;
+    }
+    default:
+      write_json_value(value);
+      break;
+  }
+}
+
+void JsonWriter::members(const Json::Value& object) {
+  mt_assert(object.isObject());
+  for (auto iterator = object.begin(); iterator != object.end(); ++iterator) {
+    key(iterator.name()).value(*iterator);
+  }
+}
+
+void JsonWriter::clear() {
+  mt_assert(depth_ == 0);
+  buffer_.clear();
+}
+
+void JsonWriter::before_value() {
+  intern_next_value_ = false;
+  if (depth_ == 0) {
+    return;
+  }
+
+  // Object members are separated in `key`.
+  auto& scope = scopes_[depth_ - 1];
+  if (!scope.is_object) {
+    if (!scope.empty) {
+      buffer_.push_back(',');
+    }
+    scope.empty = false;
+  }
+}
+
+void JsonWriter::write_quoted(std::string_view string) {
+  bool plain = std::all_of(string.begin(), string.end(), [](char c) {
+    return c >= 0x20 && c < 0x7f && c != '"' && c != '\\';
+  });
+  if (plain) {
+    buffer_.push_back('"');
+    buffer_.append(string);
+    buffer_.push_back('"');
+    return;
+  }
+
+  if (string.find('\0') != std::string_view::npos) {
+    // `Json::valueToQuotedString` stops at the first null character.
+    write_json_value(Json::Value(std::string(string)));
+    return;
+  }
+
+  // Let jsoncpp escape control and non-ascii characters, so that the output
+  // stays identical to `Json::Value`.
+  buffer_.append(Json::valueToQuotedString(std::string(string).c_str()));
+}
+
+} // namespace marianatrench
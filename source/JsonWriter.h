@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Strings of a shard written with `--output-string-tables`.
+ *
+ * In that mode, the string values of file paths, method and field signatures
+ * and kinds (see `is_interned_key`) are replaced by their index in the table of
+ * their shard, since they are repeated in most frames.
+ */
+class JsonStringTable final {
+ public:
+  JsonStringTable() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(JsonStringTable)
+
+  /* Whether string values of members with the given key are interned. */
+  static bool is_interned_key(std::string_view key);
+
+  std::size_t index(std::string_view string);
+
+  const std::vector<const std::string*>& strings() const {
+    return strings_;
+  }
+
+  void clear();
+
+ private:
+  std::unordered_map<std::string, std::size_t> indices_;
+  std::vector<const std::string*> strings_;
+};
+
+/**
+ * Streaming json writer, producing the same output as
+ * `JsonValidation::compact_writer()` without building a `Json::Value`.
+ *
+ * Members of an object can be written in any order: as `Json::Value` sorts
+ * its members, the members of an object are sorted when it is closed. This is
+ * free when they are already written in order.
+ *
+ * The buffer is reused across `clear()` calls, so a writer is meant to be
+ * kept around (e.g, `thread_local`) when writing many values.
+ */
+class JsonWriter final {
+ public:
+  JsonWriter() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(JsonWriter)
+
+  void begin_object();
+  void end_object();
+  void begin_array();
+  void end_array();
+
+  /* Start a member of the current object. It must be followed by a value. */
+  JsonWriter& key(std::string_view key);
+
+  void value(std::nullptr_t);
+  void value(bool value);
+  void value(int value);
+  void value(unsigned int value);
+  void value(std::int64_t value);
+  void value(std::uint64_t value);
+  void value(std::string_view value);
+  void value(const char* value) {
+    this->value(std::string_view(value));
+  }
+  void value(const std::string& value) {
+    this->value(std::string_view(value));
+  }
+
+  /* Write a `Json::Value`, for parts without a streaming writer. */
+  void value(const Json::Value& value);
+
+  /* Write all members of the given json object in the current object. */
+  void members(const Json::Value& object);
+
+  /**
+   * Intern the strings of following values in the given table, or stop
+   * interning when it is null.
+   */
+  void set_string_table(JsonStringTable* MT_NULLABLE string_table) {
+    string_table_ = string_table;
+  }
+
+  const std::string& str() const {
+    return buffer_;
+  }
+
+  void clear();
+
+ private:
+  void before_value();
+  void write_quoted(std::string_view string);
+  void write_json_value(const Json::Value& value);
+  void write_interned_json_value(const Json::Value& value, bool intern);
+
+  struct Member {
+    std::string key;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  struct Scope {
+    bool is_object;
+    bool empty;
+    /* Offset of the first member, for objects. */
+    std::size_t begin;
+    bool sorted;
+    std::vector<Member> members;
+  };
+
+ private:
+  std::string buffer_;
+  /* Scopes are reused across values to avoid allocations. */
+  std::vector<Scope> scopes_;
+  std::size_t depth_ = 0;
+  std::string reorder_buffer_;
+  std::unique_ptr<Json::StreamWriter> fallback_writer_;
+  std::ostringstream fallback_stream_;
+  JsonStringTable* MT_NULLABLE string_table_ = nullptr;
+  /* Whether the next value is the value of an interned member. */
+  bool intern_next_value_ = false;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/KindCounters.h>
+
+namespace marianatrench {
+
+namespace {
+
+template <typename Element>
+void increment(
+    ConcurrentMap<const Element*, std::size_t>& counters,
+    const std::unordered_set<const Element*>& elements) {
+  for (const auto* element : elements) {
+    counters.update(
+        element,
+        [](const Element* /* element */, std::size_t& count, bool exists) {
+          count = exists ? count + 1 : 1;
+        });
+  }
+}
+
+template <typename Element>
+void decrement(
+    ConcurrentMap<const Element*, std::size_t>& counters,
+    const std::unordered_set<const Element*>& elements) {
+  for (const auto* element : elements) {
+    counters.update(
+        element,
+        [](const Element* /* element */, std::size_t& count, bool exists) {
+          mt_assert(exists && count > 0);
+          count--;
+        });
+  }
+}
+
+template <typename Element>
+std::unordered_set<const Element*> used(
+    const ConcurrentMap<const Element*, std::size_t>& counters) {
+  std::unordered_set<const Element*> result;
+  for (const auto& [element, count] : counters) {
+    if (count > 0) {
+      result.insert(element);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+KindCounters::ModelKinds KindCounters::ModelKinds::from_model(
+    const Model& model) {
+  return ModelKinds{
+      model.source_kinds(), model.sink_kinds(), model.local_transform_kinds()};
+}
+
+void KindCounters::add(const ModelKinds& kinds) {
+  increment(sources_, kinds.source_kinds);
+  increment(sinks_, kinds.sink_kinds);
+  increment(transforms_, kinds.local_transform_kinds);
+}
+
+void KindCounters::remove(const ModelKinds& kinds) {
+  decrement(sources_, kinds.source_kinds);
+  decrement(sinks_, kinds.sink_kinds);
+  decrement(transforms_, kinds.local_transform_kinds);
+}
+
+std::unordered_set<const Kind*> KindCounters::used_sources() const {
+  return used(sources_);
+}
+
+std::unordered_set<const Kind*> KindCounters::used_sinks() const {
+  return used(sinks_);
+}
+
+std::unordered_set<const Transform*> KindCounters::used_transforms() const {
+  return used(transforms_);
+}
+
+} // namespace marianatrench
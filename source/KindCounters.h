@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_set>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Kind.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/TransformList.h>
+
+namespace marianatrench {
+
+/**
+ * Number of method models in which each source kind, sink kind and local
+ * transform occurs.
+ *
+ * The registry maintains these counters as models are set, once enabled with
+ * `Registry::count_kinds`, so that the rule coverage is computed in the number
+ * of kinds instead of a traversal of all models. This is thread-safe.
+ */
+class KindCounters final {
+ public:
+  /* Kinds occurring in a single model. */
+  struct ModelKinds {
+    std::unordered_set<const Kind*> source_kinds;
+    std::unordered_set<const Kind*> sink_kinds;
+    std::unordered_set<const Transform*> local_transform_kinds;
+
+    static ModelKinds from_model(const Model& model);
+  };
+
+ public:
+  KindCounters() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(KindCounters)
+
+  void add(const ModelKinds& kinds);
+
+  void remove(const ModelKinds& kinds);
+
+  /* Kinds occurring in at least one model. */
+  std::unordered_set<const Kind*> used_sources() const;
+  std::unordered_set<const Kind*> used_sinks() const;
+  std::unordered_set<const Transform*> used_transforms() const;
+
+ private:
+  ConcurrentMap<const Kind*, std::size_t> sources_;
+  ConcurrentMap<const Kind*, std::size_t> sinks_;
+  ConcurrentMap<const Transform*, std::size_t> transforms_;
+};
+
+} // namespace marianatrench
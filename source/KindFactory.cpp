@@ -82,6 +82,12 @@ std::vector<const Kind*> KindFactory::kinds() const {
   return result;
 }
 
+std::size_t KindFactory::memory_usage() const {
+  return sizeof(LocalReturnKind) + named_.memory_usage() +
+      local_argument_.memory_usage() + partial_.memory_usage() +
+      triggered_partial_.memory_usage() + transforms_.memory_usage();
+}
+
 const KindFactory& KindFactory::singleton() {
   // Thread-safe global variable, initialized on first call.
   static KindFactory instance;
@@ -58,23 +58,28 @@ class KindFactory final {
 
   std::vector<const Kind*> kinds() const;
 
+  /* Approximate memory used, in bytes. */
+  std::size_t memory_usage() const;
+
   static const KindFactory& singleton();
 
  private:
-  UniquePointerFactory<std::string, NamedKind> named_;
+  UniquePointerFactory<std::string, NamedKind> named_{
+      CacheStatistics::Cache::Kinds};
   std::unique_ptr<LocalReturnKind> local_return_;
-  UniquePointerFactory<ParameterPosition, LocalArgumentKind> local_argument_;
+  UniquePointerFactory<ParameterPosition, LocalArgumentKind> local_argument_{
+      CacheStatistics::Cache::Kinds};
   const LocalArgumentKind* local_receiver_;
   UniquePointerFactory<
       std::tuple<std::string, std::string>,
       PartialKind,
       TupleHash<std::string, std::string>>
-      partial_;
+      partial_{CacheStatistics::Cache::Kinds};
   UniquePointerFactory<
       std::tuple<const PartialKind*, const MultiSourceMultiSinkRule*>,
       TriggeredPartialKind,
       TupleHash<const PartialKind*, const MultiSourceMultiSinkRule*>>
-      triggered_partial_;
+      triggered_partial_{CacheStatistics::Cache::Kinds};
   UniquePointerFactory<
       std::tuple<
           const Kind*,
@@ -85,7 +90,7 @@ class KindFactory final {
           const Kind*,
           const TransformList * MT_NULLABLE,
           const TransformList * MT_NULLABLE>>
-      transforms_;
+      transforms_{CacheStatistics::Cache::Kinds};
 };
 
 } // namespace marianatrench
@@ -13,6 +13,7 @@
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/KindFrames.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/Options.h>
 #include <mariana-trench/OriginFactory.h>
 #include <mariana-trench/PathTreeDomain.h>
 
@@ -235,10 +236,7 @@ FeatureMayAlwaysSet propagate_features(
     const Frame& frame,
     const CallInfo& propagated_call_info,
     const FeatureMayAlwaysSet& locally_inferred_features,
-    const Method* MT_NULLABLE callee,
-    Context& context,
-    const std::vector<const DexType * MT_NULLABLE>& source_register_types,
-    const std::vector<std::optional<std::string>>& source_constant_arguments,
+    const CallSitePropagation& call_site,
     FeatureSet& propagated_user_features,
     std::vector<const Feature*>& via_type_of_features_added) {
   auto propagated_local_features = locally_inferred_features;
@@ -258,22 +256,20 @@ FeatureMayAlwaysSet propagate_features(
   }
 
   // If the callee is nullptr (e.g. "call" to a field), there are no via-*
-  // ports to materialize
-  if (callee == nullptr) {
+  // ports to materialize. Only declaration frames hold via-* ports.
+  if (call_site.callee() == nullptr || !frame.has_via_ports()) {
     return propagated_local_features;
   }
 
   // The via-type/value-of features are also treated as user features.
   // They need to show up on the frame in which they are materialized.
-  auto via_type_of_features = frame.materialize_via_type_of_ports(
-      callee, context.feature_factory, source_register_types);
+  auto via_type_of_features = frame.materialize_via_type_of_ports(call_site);
   for (const auto* feature : via_type_of_features) {
     via_type_of_features_added.push_back(feature);
     propagated_user_features.add(feature);
   }
 
-  auto via_value_features = frame.materialize_via_value_of_ports(
-      callee, context.feature_factory, source_constant_arguments);
+  auto via_value_features = frame.materialize_via_value_of_ports(call_site);
   for (const auto* feature : via_value_features) {
     propagated_user_features.add(feature);
   }
@@ -285,7 +281,7 @@ CanonicalNameSetAbstractDomain propagate_canonical_names(
     const Frame& frame,
     const Method* MT_NULLABLE callee,
     const std::vector<const Feature*>& via_type_of_features_added) {
-  auto canonical_names = frame.canonical_names();
+  const auto& canonical_names = frame.canonical_names();
   if (!canonical_names.is_value() || canonical_names.elements().empty()) {
     // Non-crtex frame
     return CanonicalNameSetAbstractDomain{};
@@ -296,7 +292,7 @@ CanonicalNameSetAbstractDomain propagate_canonical_names(
   mt_assert(callee != nullptr);
 
   auto first_name = canonical_names.elements().begin();
-  if (first_name->instantiated_value().has_value()) {
+  if (first_name->is_instantiated()) {
     // The canonical names are either all instantiated values, or all
     // templated values that need to be instantiated. Instantiated values do
     // not need to be propagated.
@@ -328,27 +324,61 @@ KindFrames KindFrames::propagate(
     const std::vector<std::optional<std::string>>& source_constant_arguments,
     const CallClassIntervalContext& class_interval_context,
     const ClassIntervals::Interval& caller_class_interval) const {
+  return propagate(
+      propagated_call_info,
+      locally_inferred_features,
+      CallSitePropagation(
+          callee,
+          propagated_call_info.call_position(),
+          maximum_source_sink_distance,
+          /* extra_features */ {},
+          context,
+          source_register_types,
+          source_constant_arguments,
+          class_interval_context,
+          caller_class_interval));
+}
+
+KindFrames KindFrames::propagate(
+    const CallInfo& propagated_call_info,
+    const FeatureMayAlwaysSet& locally_inferred_features,
+    const CallSitePropagation& call_site) const {
   if (is_bottom()) {
     return KindFrames::bottom();
   }
 
-  const auto* kind = propagate_kind(kind_, context);
+  const auto* callee = call_site.callee();
+  auto maximum_source_sink_distance = call_site.maximum_source_sink_distance();
+  const auto* kind = propagate_kind(kind_, call_site.context());
   mt_assert(kind != nullptr);
+  const auto* class_intervals = call_site.context().class_intervals.get();
+  bool class_intervals_enabled =
+      class_intervals == nullptr || class_intervals->enabled();
+  auto propagated_call_kind = propagated_call_info.call_kind();
+  // Origins of frames of call sites are not exported with
+  // `--skip-call-site-origins`, hence they are not propagated.
+  const auto* options = call_site.context().options.get();
+  bool propagates_origins = propagated_call_kind.is_origin() ||
+      options == nullptr || !options->skip_call_site_origins();
 
   FramesByInterval propagated_frames;
-  for (const auto& [_interval, frame] : frames_.bindings()) {
+  frames_.visit([&](const CallClassIntervalContext& /* interval */,
+                    const Frame& frame) {
     if (frame.distance() >= maximum_source_sink_distance) {
-      continue;
+      return;
     }
 
-    auto propagated_interval = propagate_interval(
-        frame,
-        propagated_call_info,
-        class_interval_context,
-        caller_class_interval);
+    // Without class intervals, all frames share the default interval.
+    auto propagated_interval = class_intervals_enabled
+        ? propagate_interval(
+              frame,
+              propagated_call_info,
+              call_site.class_interval_context(),
+              call_site.caller_class_interval())
+        : CallClassIntervalContext();
     if (propagated_interval.callee_interval().is_bottom()) {
       // Intervals do not intersect. Do not propagate this frame.
-      continue;
+      return;
     }
 
     std::vector<const Feature*> via_type_of_features_added;
@@ -357,10 +387,7 @@ KindFrames KindFrames::propagate(
         frame,
         propagated_call_info,
         locally_inferred_features,
-        callee,
-        context,
-        source_register_types,
-        source_constant_arguments,
+        call_site,
         propagated_user_features,
         via_type_of_features_added);
 
@@ -373,12 +400,16 @@ KindFrames KindFrames::propagate(
     mt_assert(propagated_canonical_names.is_value());
 
     // Propagate instantiated canonical names into origins.
-    auto propagated_origins = frame.origins();
-    propagated_origins.join_with(CanonicalName::propagate(
-        propagated_canonical_names, *propagated_call_info.callee_port()));
+    auto propagated_origins = OriginSet{};
+    if (propagates_origins) {
+      propagated_origins = frame.origins();
+      if (!propagated_canonical_names.elements().empty()) {
+        propagated_origins.join_with(CanonicalName::propagate(
+            propagated_canonical_names, *propagated_call_info.callee_port()));
+      }
+    }
 
     int propagated_distance = frame.distance() + 1;
-    auto propagated_call_kind = propagated_call_info.call_kind();
     if (propagated_call_kind.is_origin()) {
       // Origins are the "leaf" of a trace and start at distance 0.
       propagated_distance = 0;
@@ -408,15 +439,15 @@ KindFrames KindFrames::propagate(
         propagated_user_features,
         /* via_type_of_ports */ {},
         /* via_value_of_ports */ {},
-        propagated_canonical_names,
-        propagated_output_paths,
+        std::move(propagated_canonical_names),
+        std::move(propagated_output_paths),
         /* extra_traces */ {});
 
     propagated_frames.update(
         propagated_interval, [&propagated_frame](Frame* frame) {
           frame->join_with(propagated_frame);
         });
-  }
+  });
 
   if (propagated_frames.is_bottom()) {
     return KindFrames::bottom();
@@ -458,10 +489,12 @@ void KindFrames::add_inferred_features(const FeatureMayAlwaysSet& features) {
 std::ostream& operator<<(std::ostream& out, const KindFrames& frames) {
   mt_assert(!frames.frames_.is_top());
   out << "KindFrames(frames=[";
-  for (const auto& [interval, frame] : frames.frames_.bindings()) {
+  frames.frames_.visit([&out](
+                           const CallClassIntervalContext& interval,
+                           const Frame& frame) {
     out << "FramesByInterval(interval=" << show(interval) << ", frame=" << frame
         << "),";
-  }
+  });
   return out << "])";
 }
 
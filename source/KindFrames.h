@@ -13,13 +13,14 @@
 #include <json/json.h>
 
 #include <sparta/AbstractDomain.h>
-#include <sparta/HashedAbstractPartition.h>
 
 #include <mariana-trench/Access.h>
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/CallClassIntervalContext.h>
+#include <mariana-trench/CallSitePropagation.h>
 #include <mariana-trench/Frame.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/SmallHashedAbstractPartition.h>
 #include <mariana-trench/TaintConfig.h>
 
 namespace marianatrench {
@@ -30,7 +31,7 @@ namespace marianatrench {
 class KindFrames final : public sparta::AbstractDomain<KindFrames> {
  private:
   using FramesByInterval =
-      sparta::HashedAbstractPartition<CallClassIntervalContext, Frame>;
+      SmallHashedAbstractPartition<CallClassIntervalContext, Frame>;
 
  private:
   explicit KindFrames(const Kind* MT_NULLABLE kind, FramesByInterval frames)
@@ -102,11 +103,9 @@ class KindFrames final : public sparta::AbstractDomain<KindFrames> {
     static_assert(
         std::is_void_v<decltype(visitor(std::declval<const Frame&>()))>);
 
-    frames_.visit(
-        [visitor = std::forward<Visitor>(visitor)](
-            const std::pair<const CallClassIntervalContext, Frame>& binding) {
-          visitor(binding.second);
-        });
+    frames_.visit([visitor = std::forward<Visitor>(visitor)](
+                      const CallClassIntervalContext& /* interval */,
+                      const Frame& frame) { visitor(frame); });
   }
 
   template <typename Predicate> // bool(const Frame&)
@@ -152,6 +151,12 @@ class KindFrames final : public sparta::AbstractDomain<KindFrames> {
       const CallClassIntervalContext& class_interval_context,
       const ClassIntervals::Interval& caller_class_interval) const;
 
+  /* Propagate the taint, sharing computations across the ports of a call. */
+  KindFrames propagate(
+      const CallInfo& propagated_call_info,
+      const FeatureMayAlwaysSet& locally_inferred_features,
+      const CallSitePropagation& call_site) const;
+
   void filter_invalid_frames(const std::function<bool(const Kind*)>& is_valid);
 
   bool contains_kind(const Kind*) const;
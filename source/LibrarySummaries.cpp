@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
+#include <fmt/format.h>
+
+#include <IRCode.h>
+
+#include <mariana-trench/AnalysisCache.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/LibrarySummaries.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/NamedKind.h>
+#include <mariana-trench/PartialKind.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the format of summaries changes.
+constexpr int k_version = 1;
+
+bool add_kind(Json::Value& value, const Kind* kind) {
+  if (const auto* named_kind = kind->as<NamedKind>()) {
+    value["kind"] = named_kind->name();
+    return true;
+  } else if (const auto* partial_kind = kind->as<PartialKind>()) {
+    value["kind"] = partial_kind->name();
+    value["partial_label"] = partial_kind->label();
+    return true;
+  }
+  return false;
+}
+
+/* Features of the frame, along with the features inferred for its callee. */
+void add_features(
+    Json::Value& value,
+    const LocalTaint& local_taint,
+    const Frame& frame) {
+  auto features = frame.features();
+  features.add(local_taint.locally_inferred_features());
+  if (features.is_value()) {
+    JsonValidation::update_object(value, features.to_json());
+  }
+}
+
+/**
+ * Replace the taint of `tree` in `value[field]` by declarations, in the
+ * format of `TaintConfig::from_json`. Return false if the taint cannot be
+ * expressed in that format.
+ */
+bool set_taint_configs(
+    Json::Value& value,
+    const std::string& field,
+    const TaintAccessPathTree& tree) {
+  value.removeMember(field);
+  if (tree.is_bottom()) {
+    return true;
+  }
+
+  auto configs_value = Json::Value(Json::arrayValue);
+  bool valid = true;
+  for (const auto& [port, taint] : tree.elements()) {
+    taint.visit_local_taint([&](const LocalTaint& local_taint) {
+      local_taint.visit_frames([&](const CallInfo&, const Frame& frame) {
+        if (frame.canonical_names().is_value() &&
+            !frame.canonical_names().elements().empty()) {
+          valid = false;
+          return;
+        }
+        auto config_value = Json::Value(Json::objectValue);
+        if (!add_kind(config_value, frame.kind())) {
+          valid = false;
+          return;
+        }
+        config_value["port"] = port.to_json();
+        add_features(config_value, local_taint, frame);
+        if (!frame.via_type_of_ports().is_bottom()) {
+          auto ports = Json::Value(Json::arrayValue);
+          for (const auto& root : frame.via_type_of_ports()) {
+            ports.append(root.to_json());
+          }
+          config_value["via_type_of"] = ports;
+        }
+        if (!frame.via_value_of_ports().is_bottom()) {
+          auto ports = Json::Value(Json::arrayValue);
+          for (const auto& root : frame.via_value_of_ports()) {
+            ports.append(root.to_json());
+          }
+          config_value["via_value_of"] = ports;
+        }
+        configs_value.append(config_value);
+      });
+    });
+  }
+  if (!configs_value.empty()) {
+    value[field] = configs_value;
+  }
+  return valid;
+}
+
+/* Same as above, in the format of `PropagationConfig::from_json`. */
+bool set_propagation_configs(
+    Json::Value& value,
+    const TaintAccessPathTree& propagations) {
+  value.removeMember("propagation");
+  if (propagations.is_bottom()) {
+    return true;
+  }
+
+  auto configs_value = Json::Value(Json::arrayValue);
+  bool valid = true;
+  for (const auto& [input_path, taint] : propagations.elements()) {
+    taint.visit_local_taint([&](const LocalTaint& local_taint) {
+      local_taint.visit_frames([&](const CallInfo&, const Frame& frame) {
+        if (frame.kind()->discard_transforms() != frame.kind()) {
+          valid = false;
+          return;
+        }
+        auto output_root = frame.propagation_kind()->root();
+        for (const auto& [output_path, collapse_depth] :
+             frame.output_paths().elements()) {
+          auto config_value = Json::Value(Json::objectValue);
+          config_value["input"] = input_path.to_json();
+          config_value["output"] =
+              AccessPath(output_root, output_path).to_json();
+          if (collapse_depth.is(CollapseDepth::Enum::NoCollapse)) {
+            config_value["collapse"] = false;
+          } else {
+            config_value["collapse-depth"] =
+                Json::Value(static_cast<std::int64_t>(collapse_depth.value()));
+          }
+          add_features(config_value, local_taint, frame);
+          configs_value.append(config_value);
+        }
+      });
+    });
+  }
+  if (!configs_value.empty()) {
+    value["propagation"] = configs_value;
+  }
+  return valid;
+}
+
+/* Summarized methods that the summary of the method depends on. */
+std::vector<const Method*> summarized_callees(
+    const Method* method,
+    const CallGraph& call_graph,
+    const std::unordered_set<const Method*>& summarized_methods) {
+  std::unordered_set<const Method*> callees;
+  auto add_call_target = [&](const CallTarget& call_target) {
+    if (!call_target.resolved()) {
+      return;
+    }
+    callees.insert(call_target.resolved_base_callee());
+    if (call_target.is_virtual()) {
+      for (const auto* override : call_target.overrides()) {
+        callees.insert(override);
+      }
+    }
+  };
+  call_graph.visit_call_targets(method, add_call_target);
+
+  std::vector<const Method*> result;
+  for (const auto* callee : callees) {
+    if (callee != method && summarized_methods.count(callee) > 0) {
+      result.push_back(callee);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+void LibrarySummaries::store(
+    const std::filesystem::path& path,
+    const std::vector<std::string>& class_prefixes,
+    const Context& context,
+    const Registry& registry) {
+  mt_assert(context.call_graph != nullptr);
+  const auto& call_graph = *context.call_graph;
+
+  std::vector<const Method*> methods;
+  for (const auto* method : *context.methods) {
+    if (!method->parameter_type_overrides().empty()) {
+      continue;
+    }
+    for (const auto& class_prefix : class_prefixes) {
+      if (boost::starts_with(method->signature(), class_prefix)) {
+        methods.push_back(method);
+        break;
+      }
+    }
+  }
+
+  std::vector<std::optional<Json::Value>> summaries(methods.size());
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        summaries[index] = summary(*registry.get_snapshot(methods[index]));
+      },
+      sparta::parallel::default_num_threads());
+  for (std::size_t index = 0; index < methods.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+
+  std::unordered_set<const Method*> summarized_methods;
+  for (std::size_t index = 0; index < methods.size(); index++) {
+    if (summaries[index]) {
+      summarized_methods.insert(methods[index]);
+    }
+  }
+
+  auto summaries_value = Json::Value(Json::arrayValue);
+  for (std::size_t index = 0; index < methods.size(); index++) {
+    if (!summaries[index]) {
+      continue;
+    }
+    const auto* method = methods[index];
+    auto dependencies = Json::Value(Json::arrayValue);
+    for (const auto* callee :
+         summarized_callees(method, call_graph, summarized_methods)) {
+      dependencies.append(Json::Value(callee->show()));
+    }
+
+    auto summary_value = Json::Value(Json::objectValue);
+    summary_value["method"] = method->to_json();
+    summary_value["fingerprint"] = fingerprint(method, call_graph);
+    summary_value["dependencies"] = dependencies;
+    summary_value["model"] = *summaries[index];
+    summaries_value.append(summary_value);
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["version"] = k_version;
+  value["configuration"] =
+      AnalysisCache::configuration_fingerprint(*context.options);
+  value["summaries"] = summaries_value;
+
+  LOG(1,
+      "Writing {} library summaries to `{}` ({} methods not summarized).",
+      summarized_methods.size(),
+      path.native(),
+      methods.size() - summarized_methods.size());
+  JsonValidation::write_json_file(path, value);
+}
+
+std::size_t LibrarySummaries::load(
+    const std::filesystem::path& path,
+    Context& context,
+    Registry& registry) {
+  mt_assert(context.call_graph != nullptr);
+  const auto& call_graph = *context.call_graph;
+
+  auto value = JsonValidation::parse_json_file(path);
+  JsonValidation::validate_object(value);
+  if (JsonValidation::integer(value, /* field */ "version") != k_version ||
+      JsonValidation::string(value, /* field */ "configuration") !=
+          AnalysisCache::configuration_fingerprint(*context.options)) {
+    WARNING(
+        1,
+        "Library summaries `{}` were computed with a different configuration, ignoring them.",
+        path.native());
+    return 0;
+  }
+  const auto& summaries_value =
+      JsonValidation::null_or_array(value, /* field */ "summaries");
+
+  // Summaries of methods of the program whose fingerprint is unchanged.
+  std::vector<const Method*> methods(summaries_value.size(), nullptr);
+  auto queue = work_queue<Json::ArrayIndex>(
+      [&](Json::ArrayIndex index) {
+        const auto& summary_value = summaries_value[index];
+        const auto& method_value = summary_value["method"];
+        if (!method_value.isString()) {
+          return;
+        }
+        const auto* method = context.methods->get(method_value.asString());
+        if (method != nullptr &&
+            JsonValidation::string(summary_value, /* field */ "fingerprint") ==
+                fingerprint(method, call_graph)) {
+          methods[index] = method;
+        }
+      },
+      sparta::parallel::default_num_threads());
+  for (Json::ArrayIndex index = 0; index < summaries_value.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+
+  // Invalidate the summaries depending on invalid summaries.
+  std::unordered_map<std::string, Json::ArrayIndex> valid_summaries;
+  std::unordered_map<std::string, std::vector<std::string>> dependents;
+  std::vector<std::string> worklist;
+  for (Json::ArrayIndex index = 0; index < summaries_value.size(); index++) {
+    const auto& summary_value = summaries_value[index];
+    auto method = JsonValidation::string(summary_value, /* field */ "method");
+    for (const auto& dependency : JsonValidation::null_or_array(
+             summary_value, /* field */ "dependencies")) {
+      dependents[JsonValidation::string(dependency)].push_back(method);
+    }
+    if (methods[index] != nullptr) {
+      valid_summaries.emplace(method, index);
+    } else {
+      worklist.push_back(method);
+    }
+  }
+  while (!worklist.empty()) {
+    auto method = std::move(worklist.back());
+    worklist.pop_back();
+    auto found = dependents.find(method);
+    if (found == dependents.end()) {
+      continue;
+    }
+    for (const auto& dependent : found->second) {
+      if (valid_summaries.erase(dependent) > 0) {
+        worklist.push_back(dependent);
+      }
+    }
+  }
+
+  auto join_queue = work_queue<Json::ArrayIndex>(
+      [&](Json::ArrayIndex index) {
+        // Summaries are written by `store` and the file is validated above.
+        registry.join_with(Model::from_trusted_json(
+            methods[index],
+            JsonValidation::object(summaries_value[index], /* field */ "model"),
+            context));
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto& [method, index] : valid_summaries) {
+    join_queue.add_item(index);
+  }
+  join_queue.run_all();
+
+  LOG(1,
+      "Loaded {} out of {} library summaries from `{}`.",
+      valid_summaries.size(),
+      summaries_value.size(),
+      path.native());
+  return valid_summaries.size();
+}
+
+std::optional<Json::Value> LibrarySummaries::summary(const Model& model) {
+  auto value = model.to_json(ExportOriginsMode::Always);
+  value.removeMember("method");
+  // Issues are found when analyzing the library.
+  value.removeMember("issues");
+  value.removeMember("model_generators");
+
+  if (!set_taint_configs(value, "generations", model.generations()) ||
+      !set_taint_configs(
+          value, "parameter_sources", model.parameter_sources()) ||
+      !set_taint_configs(
+          value, "effect_sources", model.call_effect_sources()) ||
+      !set_taint_configs(value, "sinks", model.sinks()) ||
+      !set_taint_configs(value, "effect_sinks", model.call_effect_sinks()) ||
+      !set_propagation_configs(value, model.propagations())) {
+    return std::nullopt;
+  }
+
+  if (!model.skip_analysis()) {
+    if (!value.isMember("modes")) {
+      value["modes"] = Json::Value(Json::arrayValue);
+    }
+    value["modes"].append(
+        Json::Value(model_mode_to_string(Model::Mode::SkipAnalysis)));
+  }
+  return value;
+}
+
+std::string LibrarySummaries::fingerprint(
+    const Method* method,
+    const CallGraph& call_graph) {
+  std::size_t seed = 0;
+
+  const auto* code = method->get_code();
+  if (code != nullptr && code->cfg_built()) {
+    boost::hash_combine(seed, Method::show_control_flow_graph(code->cfg()));
+  }
+
+  // Call targets are sorted, since instructions are not ordered across runs.
+  std::vector<std::string> call_targets;
+  auto add_call_target = [&call_targets](const CallTarget& call_target) {
+    if (!call_target.resolved()) {
+      return;
+    }
+    std::vector<std::string> callees;
+    if (call_target.is_virtual()) {
+      for (const auto* override : call_target.overrides()) {
+        callees.push_back(override->show());
+      }
+      std::sort(callees.begin(), callees.end());
+    }
+    call_targets.push_back(fmt::format(
+        "{} {}",
+        call_target.resolved_base_callee()->show(),
+        boost::algorithm::join(callees, " ")));
+  };
+  call_graph.visit_call_targets(method, add_call_target);
+  std::sort(call_targets.begin(), call_targets.end());
+  for (const auto& call_target : call_targets) {
+    boost::hash_combine(seed, call_target);
+  }
+
+  return std::to_string(seed);
+}
+
+} // namespace marianatrench
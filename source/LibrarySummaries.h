@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/Context.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Models of library methods precomputed by the analysis of a library, reused
+ * when analyzing programs bundling that library.
+ *
+ * With `--summarize-library`, the inferred models of the methods of the given
+ * classes are written in the model input format, along with:
+ * - a fingerprint of the method code and of its call targets, including the
+ *   overrides of its virtual callees and its artificial callees;
+ * - the summarized methods it calls, which its summary depends on.
+ *
+ * With `--library-summaries-paths`, a summary is joined into the registry, in
+ * `skip-analysis` mode, only if the fingerprint of the method is unchanged in
+ * the analyzed program and the summaries of the methods it calls are valid.
+ * Hence overrides of library methods by the program (open world) invalidate
+ * the summaries of their library callers, which are then analyzed.
+ *
+ * Like user models, summaries only hold declarations: traces stop at the
+ * summarized method. Models that cannot be expressed in the input format
+ * (e.g with transforms or triggered partial kinds) are not summarized.
+ */
+class LibrarySummaries final {
+ public:
+  /* Write the summaries of the methods of classes with the given prefixes. */
+  static void store(
+      const std::filesystem::path& path,
+      const std::vector<std::string>& class_prefixes,
+      const Context& context,
+      const Registry& registry);
+
+  /* Join the valid summaries into the registry. Return their number. */
+  static std::size_t
+  load(const std::filesystem::path& path, Context& context, Registry& registry);
+
+  /**
+   * Return the model in the input format of `Model::from_json`, or
+   * `std::nullopt` if it cannot be expressed in that format.
+   */
+  static std::optional<Json::Value> summary(const Model& model);
+
+  static std::string fingerprint(
+      const Method* method,
+      const CallGraph& call_graph);
+};
+
+} // namespace marianatrench
@@ -5,8 +5,6 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <sparta/WorkQueue.h>
-
 #include <Creators.h>
 #include <Resolver.h>
 
@@ -84,9 +82,7 @@ LifecycleMethod LifecycleMethod::from_json(const Json::Value& value) {
   return LifecycleMethod(base_class_name, method_name, callees);
 }
 
-void LifecycleMethod::create_methods(
-    const ClassHierarchies& class_hierarchies,
-    Methods& methods) {
+const DexType* MT_NULLABLE LifecycleMethod::resolve_types() {
   // All DexMethods created by `LifecycleMethod` have the same signature:
   //   void <method_name_>(<arguments>)
   // The arguments are determined by the callees' arguments. This creates the
@@ -94,7 +90,7 @@ void LifecycleMethod::create_methods(
   // The position corresponds to the register location containing the argument
   // in the DexMethod's code. The register location will be used to create the
   // invoke operation for methods that take a given DexType* as its argument.
-  TypeIndexMap type_index_map;
+  type_index_map_.clear();
   for (const auto& callee : callees_) {
     const auto* type_list = callee.get_argument_types();
     if (type_list == nullptr) {
@@ -102,51 +98,46 @@ void LifecycleMethod::create_methods(
       continue;
     }
     for (auto* type : *type_list) {
-      type_index_map.emplace(type, type_index_map.size() + 1);
+      type_index_map_.emplace(type, type_index_map_.size() + 1);
     }
   }
 
-  auto* MT_NULLABLE base_class_type = DexType::get_type(base_class_name_);
+  const auto* MT_NULLABLE base_class_type = DexType::get_type(base_class_name_);
   if (!base_class_type) {
     WARNING(
         1,
         "Could not find type for base class name `{}`. Will skip creating life-cycle methods.",
         base_class_name_);
-    return;
   }
+  return base_class_type;
+}
 
-  std::atomic<int> methods_created_count = 0;
-
+std::vector<DexType*> LifecycleMethod::final_children(
+    const ClassHierarchies& class_hierarchies,
+    const DexType* base_class_type) {
   const auto& children = class_hierarchies.extends(base_class_type);
-  std::unordered_set<const DexType*> final_children;
+  std::vector<DexType*> final_children;
   for (const auto* child : children) {
-    const auto& grandchildren = class_hierarchies.extends(child);
-    if (grandchildren.empty()) {
-      final_children.insert(child);
+    if (!class_hierarchies.has_extends(child)) {
+      final_children.push_back(const_cast<DexType*>(child));
     }
   }
   LOG(3,
       "Found {} child(ren) for type `{}`. Creating life-cycle methods for {} leaf children",
       children.size(),
-      base_class_name_,
+      base_class_type->str(),
       final_children.size());
+  return final_children;
+}
 
-  auto queue = sparta::work_queue<DexType*>([&](DexType* child) {
-    if (const auto* dex_method = create_dex_method(child, type_index_map)) {
-      ++methods_created_count;
-      const auto* method = methods.create(dex_method);
-      class_to_lifecycle_method_.emplace(child, method);
-    }
-  });
-  for (const auto* final_child : final_children) {
-    queue.add_item(const_cast<DexType*>(final_child));
+bool LifecycleMethod::create_method(DexType* klass, Methods& methods) {
+  const auto* dex_method = create_dex_method(klass);
+  if (dex_method == nullptr) {
+    return false;
   }
-  queue.run_all();
-
-  LOG(1,
-      "Created {} life-cycle methods for classes inheriting from `{}`",
-      methods_created_count,
-      base_class_name_);
+  const auto* method = methods.create(dex_method);
+  class_to_lifecycle_method_.emplace(klass, method);
+  return true;
 }
 
 std::vector<const Method*> LifecycleMethod::get_methods_for_type(
@@ -181,14 +172,13 @@ bool LifecycleMethod::operator==(const LifecycleMethod& other) const {
       method_name_ == other.method_name_ && callees_ == other.callees_;
 }
 
-const DexMethod* MT_NULLABLE LifecycleMethod::create_dex_method(
-    DexType* klass,
-    const TypeIndexMap& type_index_map) {
+const DexMethod* MT_NULLABLE
+LifecycleMethod::create_dex_method(DexType* klass) {
   auto method = MethodCreator(
       /* class */ klass,
       /* name */ DexString::make_string(method_name_),
       /* proto */
-      DexProto::make_proto(type::_void(), get_argument_types(type_index_map)),
+      DexProto::make_proto(type::_void(), get_argument_types()),
       /* access */ DexAccessFlags::ACC_PRIVATE);
 
   auto this_location = method.get_local(0);
@@ -211,10 +201,10 @@ const DexMethod* MT_NULLABLE LifecycleMethod::create_dex_method(
 
     std::vector<Location> invoke_with_registers{this_location};
     auto* type_list = callee.get_argument_types();
-    // This should have been verified at the start of `create_methods`
+    // This should have been verified in `resolve_types`
     mt_assert(type_list != nullptr);
     for (auto* type : *type_list) {
-      auto argument_register = method.get_local(type_index_map.at(type));
+      auto argument_register = method.get_local(type_index_map_.at(type));
       invoke_with_registers.push_back(argument_register);
     }
     main_block->invoke(
@@ -244,13 +234,12 @@ const DexMethod* MT_NULLABLE LifecycleMethod::create_dex_method(
   return new_method;
 }
 
-const DexTypeList* LifecycleMethod::get_argument_types(
-    const TypeIndexMap& type_index_map) {
+const DexTypeList* LifecycleMethod::get_argument_types() {
   // While the register locations for the arguments start at 1, the actual
   // argument index for the method's prototype start at index 0.
-  int num_args = type_index_map.size();
+  int num_args = type_index_map_.size();
   DexTypeList::ContainerType argument_types(num_args, nullptr);
-  for (const auto& [type, pos] : type_index_map) {
+  for (const auto& [type, pos] : type_index_map_) {
     mt_assert(pos > 0); // 0 is for "this", should not be in the map.
     mt_assert(static_cast<size_t>(pos) - 1 < argument_types.max_size());
     argument_types[pos - 1] = type;
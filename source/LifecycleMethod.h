@@ -107,11 +107,26 @@ class LifecycleMethod {
   static LifecycleMethod from_json(const Json::Value& value);
 
   /**
-   * Creates the relevant dex methods. These methods are added to `methods`.
+   * Resolves the base class and the argument types of the callees. Returns
+   * `nullptr` if the base class does not exist, in which case no life-cycle
+   * method can be created.
    */
-  void create_methods(
+  const DexType* MT_NULLABLE resolve_types();
+
+  /**
+   * Returns the classes inheriting from `base_class_type` that do not have
+   * children, which are the classes getting a life-cycle method.
+   */
+  static std::vector<DexType*> final_children(
       const ClassHierarchies& class_hierarchies,
-      Methods& methods);
+      const DexType* base_class_type);
+
+  /**
+   * Creates the dex method for the given final child class and adds it to
+   * `methods`. Returns false if the method was not created. Requires
+   * `resolve_types` and is thread-safe.
+   */
+  bool create_method(DexType* klass, Methods& methods);
 
   /**
    * Returns the created life-cycle methods for the given type. Since life-cycle
@@ -126,14 +141,14 @@ class LifecycleMethod {
   bool operator==(const LifecycleMethod& other) const;
 
  private:
-  const DexMethod* MT_NULLABLE
-  create_dex_method(DexType* klass, const TypeIndexMap& type_index_map);
+  const DexMethod* MT_NULLABLE create_dex_method(DexType* klass);
 
-  const DexTypeList* get_argument_types(const TypeIndexMap&);
+  const DexTypeList* get_argument_types();
 
   std::string base_class_name_;
   std::string method_name_;
   std::vector<LifecycleMethodCall> callees_;
+  TypeIndexMap type_index_map_;
   ConcurrentMap<const DexType*, const Method*> class_to_lifecycle_method_;
 };
 
@@ -5,8 +5,15 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <mariana-trench/LifecycleMethods.h>
+#include <mariana-trench/Log.h>
 #include <mariana-trench/Options.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -26,8 +33,57 @@ LifecycleMethods LifecycleMethods::run(
         JsonValidation::parse_json_file(path));
   }
 
+  // Leaf children are computed once per base class, since many definitions
+  // share the same base class.
+  std::unordered_map<const DexType*, std::vector<DexType*>> final_children;
+  std::vector<std::pair<LifecycleMethod*, const DexType*>> definitions;
   for (auto& [_, lifecycle_method] : lifecycle_methods.lifecycle_methods_) {
-    lifecycle_method.create_methods(class_hierarchies, methods);
+    if (const auto* base_class_type = lifecycle_method.resolve_types()) {
+      final_children.emplace(base_class_type, std::vector<DexType*>{});
+      definitions.emplace_back(&lifecycle_method, base_class_type);
+    }
+  }
+
+  auto base_class_queue = work_queue<const DexType*>(
+      [&](const DexType* base_class_type) {
+        // Each thread only writes to its own entry.
+        final_children.at(base_class_type) =
+            LifecycleMethod::final_children(class_hierarchies, base_class_type);
+      });
+  for (const auto& [base_class_type, _] : final_children) {
+    base_class_queue.add_item(base_class_type);
+  }
+  base_class_queue.run_all();
+
+  // Create the methods of all definitions concurrently. Methods are added to
+  // their class, hence all definitions of a class are handled by one thread.
+  std::unordered_map<DexType*, std::vector<std::size_t>> definitions_per_child;
+  for (std::size_t index = 0; index < definitions.size(); index++) {
+    for (auto* child : final_children.at(definitions[index].second)) {
+      definitions_per_child[child].push_back(index);
+    }
+  }
+
+  std::vector<std::atomic<std::size_t>> methods_created_count(
+      definitions.size());
+  auto queue = work_queue<DexType*>([&](DexType* child) {
+    for (auto index : definitions_per_child.at(child)) {
+      if (definitions[index].first->create_method(child, methods)) {
+        ++methods_created_count[index];
+      }
+    }
+  });
+  for (const auto& [child, _] : definitions_per_child) {
+    queue.add_item(child);
+  }
+  queue.run_all();
+
+  for (std::size_t index = 0; index < definitions.size(); index++) {
+    LOG(1,
+        "Created {} `{}` life-cycle methods for classes inheriting from `{}`",
+        methods_created_count[index].load(),
+        definitions[index].first->method_name(),
+        definitions[index].second->str());
   }
 
   return lifecycle_methods;
@@ -5,6 +5,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <functional>
+
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/LocalPositionSet.h>
@@ -12,6 +15,106 @@
 
 namespace marianatrench {
 
+namespace {
+
+using PositionLess = std::less<const Position*>;
+
+} // namespace
+
+bool LocalPositionSet::leq(const LocalPositionSet& other) const {
+  if (is_bottom()) {
+    return true;
+  } else if (other.is_bottom()) {
+    return false;
+  } else if (other.is_top()) {
+    return true;
+  } else if (is_top()) {
+    return false;
+  } else {
+    return size_ <= other.size_ &&
+        std::includes(
+            other.begin(), other.end(), begin(), end(), PositionLess());
+  }
+}
+
+bool LocalPositionSet::equals(const LocalPositionSet& other) const {
+  return kind_ == other.kind_ &&
+      std::equal(begin(), end(), other.begin(), other.end());
+}
+
+void LocalPositionSet::join_with(const LocalPositionSet& other) {
+  if (other.is_bottom() || is_top()) {
+    return;
+  } else if (is_bottom() || other.is_top()) {
+    *this = other;
+    return;
+  }
+
+  Positions result;
+  std::size_t size = 0;
+  auto left = begin();
+  auto right = other.begin();
+  while (left != end() || right != other.end()) {
+    if (size == k_capacity) {
+      set_to_top();
+      return;
+    }
+    if (right == other.end() ||
+        (left != end() && PositionLess()(*left, *right))) {
+      result[size++] = *left++;
+    } else if (left == end() || PositionLess()(*right, *left)) {
+      result[size++] = *right++;
+    } else {
+      result[size++] = *left++;
+      ++right;
+    }
+  }
+
+  positions_ = result;
+  size_ = static_cast<std::uint8_t>(size);
+}
+
+void LocalPositionSet::meet_with(const LocalPositionSet& other) {
+  if (is_bottom() || other.is_top()) {
+    return;
+  } else if (other.is_bottom() || is_top()) {
+    *this = other;
+    return;
+  }
+
+  Positions result;
+  auto last = std::set_intersection(
+      begin(),
+      end(),
+      other.begin(),
+      other.end(),
+      result.begin(),
+      PositionLess());
+  size_ = static_cast<std::uint8_t>(last - result.begin());
+  std::copy(result.begin(), last, positions_.begin());
+}
+
+void LocalPositionSet::add(const Position* position) {
+  if (!is_value()) {
+    return;
+  }
+
+  auto* first = positions_.data();
+  auto* last = first + size_;
+  auto* found = std::lower_bound(first, last, position, PositionLess());
+  if (found != last && *found == position) {
+    return;
+  }
+  if (size_ == k_capacity) {
+    set_to_top();
+    return;
+  }
+
+  std::move_backward(found, last, last + 1);
+  *found = position;
+  size_++;
+}
+
 LocalPositionSet LocalPositionSet::from_json(
     const Json::Value& value,
     Context& context) {
@@ -25,16 +128,27 @@ LocalPositionSet LocalPositionSet::from_json(
 Json::Value LocalPositionSet::to_json() const {
   mt_assert(!is_bottom());
   auto lines = Json::Value(Json::arrayValue);
-  if (set_.is_value()) {
-    for (const auto* position : set_.elements()) {
-      lines.append(position->to_json(/* with_path */ false));
-    }
+  for (const auto* position : *this) {
+    lines.append(position->to_json(/* with_path */ false));
   }
   return lines;
 }
 
 std::ostream& operator<<(std::ostream& out, const LocalPositionSet& positions) {
-  return out << positions.set_;
+  if (positions.is_bottom()) {
+    return out << "_|_";
+  } else if (positions.is_top()) {
+    return out << "T";
+  }
+
+  out << "{";
+  for (auto iterator = positions.begin(); iterator != positions.end();) {
+    out << **iterator;
+    if (++iterator != positions.end()) {
+      out << ", ";
+    }
+  }
+  return out << "}";
 }
 
 } // namespace marianatrench
@@ -7,13 +7,14 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <initializer_list>
 #include <ostream>
 
 #include <json/json.h>
 
 #include <sparta/AbstractDomain.h>
-#include <sparta/SmallSortedSetAbstractDomain.h>
 
 #include <mariana-trench/Context.h>
 #include <mariana-trench/Heuristics.h>
@@ -25,44 +26,107 @@ namespace marianatrench {
 /**
  * Represents the source code positions that taint flows through for a given
  * method.
+ *
+ * Positions are stored inline in a sorted fixed-capacity array, to avoid any
+ * heap allocation. The set becomes top when it exceeds
+ * `Heuristics::kMaxNumberLocalPositions` elements.
  */
 class LocalPositionSet final : public sparta::AbstractDomain<LocalPositionSet> {
  private:
-  using Set = sparta::SmallSortedSetAbstractDomain<
-      const Position*,
-      Heuristics::kMaxNumberLocalPositions>;
+  static constexpr std::size_t k_capacity =
+      Heuristics::kMaxNumberLocalPositions;
+  static_assert(k_capacity <= UINT8_MAX);
+
+  using Positions = std::array<const Position*, k_capacity>;
+
+ public:
+  using const_iterator = const Position* const*;
 
  private:
-  explicit LocalPositionSet(Set set) : set_(std::move(set)) {}
+  explicit LocalPositionSet(sparta::AbstractValueKind kind) : kind_(kind) {}
 
  public:
   /* Create the empty position set. */
   LocalPositionSet() = default;
 
-  explicit LocalPositionSet(std::initializer_list<const Position*> positions)
-      : set_(positions) {}
+  explicit LocalPositionSet(std::initializer_list<const Position*> positions) {
+    for (const auto* position : positions) {
+      add(position);
+    }
+  }
 
   INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(LocalPositionSet)
 
-  INCLUDE_ABSTRACT_DOMAIN_METHODS(LocalPositionSet, Set, set_)
+  static LocalPositionSet bottom() {
+    return LocalPositionSet(sparta::AbstractValueKind::Bottom);
+  }
+
+  static LocalPositionSet top() {
+    return LocalPositionSet(sparta::AbstractValueKind::Top);
+  }
+
+  bool is_bottom() const {
+    return kind_ == sparta::AbstractValueKind::Bottom;
+  }
+
+  bool is_top() const {
+    return kind_ == sparta::AbstractValueKind::Top;
+  }
 
   /* Return true if this is neither top nor bottom. */
   bool is_value() const {
-    return set_.is_value();
+    return kind_ == sparta::AbstractValueKind::Value;
+  }
+
+  void set_to_bottom() {
+    kind_ = sparta::AbstractValueKind::Bottom;
+    size_ = 0;
+  }
+
+  void set_to_top() {
+    kind_ = sparta::AbstractValueKind::Top;
+    size_ = 0;
   }
 
   bool empty() const {
-    return set_.empty();
+    return is_value() && size_ == 0;
+  }
+
+  /* Return the positions, sorted by address. Empty for top and bottom. */
+  const LocalPositionSet& elements() const {
+    return *this;
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+
+  const_iterator begin() const {
+    return positions_.data();
   }
 
-  const sparta::FlatSet<const Position*>& elements() const {
-    return set_.elements();
+  const_iterator end() const {
+    return positions_.data() + size_;
   }
 
-  void add(const Position* position) {
-    set_.add(position);
+  bool leq(const LocalPositionSet& other) const;
+
+  bool equals(const LocalPositionSet& other) const;
+
+  void join_with(const LocalPositionSet& other);
+
+  void widen_with(const LocalPositionSet& other) {
+    join_with(other);
   }
 
+  void meet_with(const LocalPositionSet& other);
+
+  void narrow_with(const LocalPositionSet& other) {
+    meet_with(other);
+  }
+
+  void add(const Position* position);
+
   static LocalPositionSet from_json(const Json::Value& value, Context& context);
   Json::Value to_json() const;
 
@@ -71,7 +135,9 @@ class LocalPositionSet final : public sparta::AbstractDomain<LocalPositionSet> {
       const LocalPositionSet& positions);
 
  private:
-  Set set_;
+  Positions positions_{};
+  std::uint8_t size_ = 0;
+  sparta::AbstractValueKind kind_ = sparta::AbstractValueKind::Value;
 };
 
 } // namespace marianatrench
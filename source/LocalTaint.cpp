@@ -215,6 +215,15 @@ void LocalTaint::set_local_positions(LocalPositionSet positions) {
   local_positions_ = std::move(positions);
 }
 
+void LocalTaint::drop_inferred_features_and_local_positions() {
+  local_positions_ = {};
+  locally_inferred_features_ = FeatureMayAlwaysSet::bottom();
+  transform_frames([](Frame frame) {
+    frame.drop_inferred_features();
+    return frame;
+  });
+}
+
 void LocalTaint::append_to_propagation_output_paths(
     Path::Element path_element) {
   if (!call_kind().is_propagation()) {
@@ -244,35 +253,23 @@ map_frames_by_kind(
 } // namespace
 
 LocalTaint LocalTaint::propagate(
-    const Method* MT_NULLABLE callee,
     const AccessPath& callee_port,
-    const Position* call_position,
-    int maximum_source_sink_distance,
-    Context& context,
-    const std::vector<const DexType * MT_NULLABLE>& source_register_types,
-    const std::vector<std::optional<std::string>>& source_constant_arguments,
-    const CallClassIntervalContext& class_interval_context,
-    const ClassIntervals::Interval& caller_class_interval) const {
+    const CallSitePropagation& call_site) const {
   if (is_bottom()) {
     return LocalTaint::bottom();
   }
 
   mt_assert(!call_kind().is_propagation_without_trace());
-  auto propagated_call_info =
-      call_info_.propagate(callee, callee_port, call_position, context);
+  auto propagated_call_info = call_info_.propagate(
+      call_site.callee(),
+      callee_port,
+      call_site.call_position(),
+      call_site.context());
 
   FramesByKind propagated_frames_by_kind;
   for (const auto& [kind, frames] : frames_.bindings()) {
     auto propagated = frames.propagate(
-        callee,
-        propagated_call_info,
-        locally_inferred_features_,
-        maximum_source_sink_distance,
-        context,
-        source_register_types,
-        source_constant_arguments,
-        class_interval_context,
-        caller_class_interval);
+        propagated_call_info, locally_inferred_features_, call_site);
 
     if (!propagated.is_bottom()) {
       propagated_frames_by_kind.update(
@@ -396,15 +393,14 @@ LocalTaint LocalTaint::attach_position(const Position* call_position) const {
 
 LocalTaint LocalTaint::apply_transform(
     const KindFactory& kind_factory,
-    const TransformsFactory& transforms,
     const UsedKinds& used_kinds,
     const TransformList* local_transforms) const {
   FramesByKind new_frames;
   this->visit_frames(
-      [&new_frames, &kind_factory, &transforms, &used_kinds, local_transforms](
+      [&new_frames, &kind_factory, &used_kinds, local_transforms](
           const CallInfo&, const Frame& frame) {
-        auto new_frame = frame.apply_transform(
-            kind_factory, transforms, used_kinds, local_transforms);
+        auto new_frame =
+            frame.apply_transform(kind_factory, used_kinds, local_transforms);
         if (!new_frame.is_bottom()) {
           new_frames.update(
               new_frame.kind(), [&new_frame](const KindFrames& old_frames) {
@@ -561,6 +557,24 @@ bool LocalTaint::contains_kind(const Kind* kind) const {
   return !frames_.get(kind).is_bottom();
 }
 
+std::unordered_map<const Kind*, LocalTaint> LocalTaint::partition_by_kind_if(
+    const std::function<bool(const Kind*)>& keep) const {
+  std::unordered_map<const Kind*, LocalTaint> result;
+  for (const auto& [kind, frame] : frames_.bindings()) {
+    if (!keep(kind)) {
+      continue;
+    }
+    result.emplace(
+        kind,
+        LocalTaint(
+            call_info_,
+            FramesByKind{std::pair(kind, frame)},
+            local_positions_,
+            locally_inferred_features_));
+  }
+  return result;
+}
+
 FeatureMayAlwaysSet LocalTaint::features_joined() const {
   auto features = FeatureMayAlwaysSet::bottom();
   this->visit_frames([&features, this](const CallInfo&, const Frame& frame) {
@@ -644,4 +658,48 @@ Json::Value LocalTaint::to_json(ExportOriginsMode export_origins_mode) const {
   return taint;
 }
 
+void LocalTaint::write_json(
+    JsonWriter& writer,
+    ExportOriginsMode export_origins_mode) const {
+  writer.begin_object();
+  call_info_.write_json_members(writer);
+
+  writer.key("kinds");
+  writer.begin_array();
+  this->visit_frames([&writer, export_origins_mode](
+                         const CallInfo& call_info, const Frame& frame) {
+    frame.write_json(writer, call_info, export_origins_mode);
+  });
+  writer.end_array();
+
+  if (!locally_inferred_features_.is_bottom() &&
+      !locally_inferred_features_.empty()) {
+    writer.key("local_features");
+    writer.begin_object();
+    locally_inferred_features_.write_json_members(writer);
+    writer.end_object();
+  }
+
+  if (call_kind().is_origin()) {
+    // See `to_json`.
+    FeatureMayAlwaysSet local_user_features;
+    this->visit_frames(
+        [&local_user_features](const CallInfo&, const Frame& frame) {
+          local_user_features.add_always(frame.user_features());
+        });
+    if (!local_user_features.is_bottom() && !local_user_features.empty()) {
+      writer.key("local_user_features");
+      writer.begin_object();
+      local_user_features.write_json_members(writer);
+      writer.end_object();
+    }
+  }
+
+  if (local_positions_.is_value() && !local_positions_.empty()) {
+    writer.key("local_positions").value(local_positions_.to_json());
+  }
+
+  writer.end_object();
+}
+
 } // namespace marianatrench
@@ -18,8 +18,10 @@
 #include <mariana-trench/Access.h>
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/CallInfo.h>
+#include <mariana-trench/CallSitePropagation.h>
 #include <mariana-trench/Frame.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/KindFrames.h>
 #include <mariana-trench/TaintConfig.h>
 
@@ -221,6 +223,12 @@ class LocalTaint final : public sparta::AbstractDomain<LocalTaint> {
 
   void set_local_positions(LocalPositionSet positions);
 
+  /**
+   * Remove the locally inferred features, the inferred features of all frames
+   * and the local positions. User features are kept.
+   */
+  void drop_inferred_features_and_local_positions();
+
   /**
    * Appends `path_element` to the output paths of all propagation frames.
    */
@@ -232,15 +240,8 @@ class LocalTaint final : public sparta::AbstractDomain<LocalTaint> {
    * Return bottom if the taint should not be propagated.
    */
   LocalTaint propagate(
-      const Method* MT_NULLABLE callee,
       const AccessPath& callee_port,
-      const Position* call_position,
-      int maximum_source_sink_distance,
-      Context& context,
-      const std::vector<const DexType * MT_NULLABLE>& source_register_types,
-      const std::vector<std::optional<std::string>>& source_constant_arguments,
-      const CallClassIntervalContext& class_interval_context,
-      const ClassIntervals::Interval& caller_class_interval) const;
+      const CallSitePropagation& call_site) const;
 
   /**
    * Propagate the taint from the callee to the caller to track the next hops
@@ -288,7 +289,6 @@ class LocalTaint final : public sparta::AbstractDomain<LocalTaint> {
 
   LocalTaint apply_transform(
       const KindFactory& kind_factory,
-      const TransformsFactory& transforms,
       const UsedKinds& used_kinds,
       const TransformList* local_transforms) const;
 
@@ -332,9 +332,18 @@ class LocalTaint final : public sparta::AbstractDomain<LocalTaint> {
     return result;
   }
 
+  /**
+   * Same as `partition_by_kind`, for the kinds satisfying `keep` only. Frames
+   * of other kinds are not copied.
+   */
+  std::unordered_map<const Kind*, LocalTaint> partition_by_kind_if(
+      const std::function<bool(const Kind*)>& keep) const;
+
   FeatureMayAlwaysSet features_joined() const;
 
   Json::Value to_json(ExportOriginsMode export_origins_mode) const;
+  void write_json(JsonWriter& writer, ExportOriginsMode export_origins_mode)
+      const;
 
   friend std::ostream& operator<<(std::ostream& out, const LocalTaint& frames);
 
@@ -19,7 +19,7 @@ namespace {
 
 struct LoggerImplementation {
  public:
-  LoggerImplementation() : level_(0), file_(stderr) {
+  LoggerImplementation() : file_(stderr) {
     const char* env = std::getenv("TRACE");
     if (env) {
       parse_environment(env);
@@ -29,24 +29,12 @@ struct LoggerImplementation {
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(LoggerImplementation)
 
-  void set_level(int level) {
-    level_ = level;
-  }
-
-  int get_level() {
-    return level_;
-  }
-
-  bool enabled(int level) const {
-    return level <= level_;
-  }
-
   bool is_interactive() const {
     return is_interactive_;
   }
 
   void log(std::string_view section, int level, std::string_view message) {
-    if (!enabled(level)) {
+    if (!marianatrench::Logger::enabled(level)) {
       return;
     }
 
@@ -82,13 +70,12 @@ struct LoggerImplementation {
       if (!level) {
         module = token;
       } else if (module == "MARIANA_TRENCH") {
-        level_ = level;
+        marianatrench::Logger::set_level(level);
       }
     }
   }
 
  private:
-  int level_;
   FILE* file_;
   std::mutex mutex_;
   bool is_interactive_;
@@ -100,16 +87,15 @@ static LoggerImplementation logger;
 
 namespace marianatrench {
 
+// Constant initialized, hence set before the logger parses `TRACE`.
+std::atomic<int> Logger::level_ = 0;
+
 void Logger::set_level(int level) {
-  logger.set_level(level);
+  level_.store(level, std::memory_order_relaxed);
 }
 
 int Logger::get_level() {
-  return logger.get_level();
-}
-
-bool Logger::enabled(int level) {
-  return logger.enabled(level);
+  return level_.load(std::memory_order_relaxed);
 }
 
 void Logger::log(
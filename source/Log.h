@@ -7,19 +7,34 @@
 
 #pragma once
 
+#include <atomic>
+#include <climits>
 #include <string>
 #include <string_view>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+/*
+ * Log levels above this value are compiled out: their arguments are never
+ * evaluated, even for methods of `--log-method`. This is set with the
+ * `MARIANA_TRENCH_MAX_LOG_LEVEL` cmake variable.
+ */
+#ifndef MT_MAX_LOG_LEVEL
+#define MT_MAX_LOG_LEVEL INT_MAX
+#endif
+
 namespace marianatrench {
 
 class Logger {
  public:
   static void set_level(int level);
   static int get_level();
-  static bool enabled(int level);
+
+  /* This is inlined since it is checked before formatting any log line. */
+  static bool enabled(int level) {
+    return level <= level_.load(std::memory_order_relaxed);
+  }
 
   template <typename... Args>
   static void log(
@@ -35,13 +50,21 @@ class Logger {
 
   static void
   log(std::string_view section, int level, std::string_view message);
+
+ private:
+  static std::atomic<int> level_;
 };
 
 } // namespace marianatrench
 
+/*
+ * Arguments are only evaluated if the level is enabled, hence expensive
+ * arguments such as `show()` of models or control flow graphs are fine.
+ */
 #define SECTION(section, level, format, ...)                             \
   do {                                                                   \
-    if (marianatrench::Logger::enabled(level)) {                         \
+    if ((level) <= MT_MAX_LOG_LEVEL &&                                   \
+        marianatrench::Logger::enabled(level)) {                         \
       marianatrench::Logger::log(section, level, format, ##__VA_ARGS__); \
     }                                                                    \
   } while (0)
@@ -59,11 +82,14 @@ class Logger {
   } while (0)
 
 #define CONTEXT_LEVEL(context, level) \
-  ((context) != nullptr && (context)->dump()) ? 1 : level
-
-#define LOG_OR_DUMP(context, level, format, ...)               \
-  do {                                                         \
-    LOG(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+  (((context) != nullptr && (context)->dump()) ? 1 : (level))
+
+/* Dumps of levels above `MT_MAX_LOG_LEVEL` are compiled out as well. */
+#define LOG_OR_DUMP(context, level, format, ...)                 \
+  do {                                                           \
+    if ((level) <= MT_MAX_LOG_LEVEL) {                           \
+      LOG(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+    }                                                            \
   } while (0)
 
 #define WARNING(level, format, ...)                   \
@@ -71,9 +97,11 @@ class Logger {
     SECTION("WARNING", level, format, ##__VA_ARGS__); \
   } while (0)
 
-#define WARNING_OR_DUMP(context, level, format, ...)               \
-  do {                                                             \
-    WARNING(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+#define WARNING_OR_DUMP(context, level, format, ...)                 \
+  do {                                                               \
+    if ((level) <= MT_MAX_LOG_LEVEL) {                               \
+      WARNING(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+    }                                                                \
   } while (0)
 
 #define ERROR(level, format, ...)                   \
@@ -81,7 +109,9 @@ class Logger {
     SECTION("ERROR", level, format, ##__VA_ARGS__); \
   } while (0)
 
-#define ERROR_OR_DUMP(context, level, format, ...)                 \
-  do {                                                             \
-    WARNING(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+#define ERROR_OR_DUMP(context, level, format, ...)                   \
+  do {                                                               \
+    if ((level) <= MT_MAX_LOG_LEVEL) {                               \
+      WARNING(CONTEXT_LEVEL(context, level), format, ##__VA_ARGS__); \
+    }                                                                \
   } while (0)
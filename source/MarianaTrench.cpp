@@ -5,8 +5,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -14,35 +23,55 @@
 
 #include <RedexContext.h>
 
+#include <mariana-trench/AnalysisCache.h>
 #include <mariana-trench/ArtificialMethods.h>
+#include <mariana-trench/CacheStatistics.h>
+#include <mariana-trench/CallsiteModelCache.h>
 #include <mariana-trench/ClassHierarchies.h>
 #include <mariana-trench/ClassIntervals.h>
 #include <mariana-trench/ClassProperties.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/ControlFlowGraphs.h>
+#include <mariana-trench/ConvergenceReport.h>
+#include <mariana-trench/Daemon.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/EventLogger.h>
 #include <mariana-trench/FieldCache.h>
 #include <mariana-trench/Fields.h>
+#include <mariana-trench/GraphSnapshot.h>
 #include <mariana-trench/Highlights.h>
 #include <mariana-trench/Interprocedural.h>
+#include <mariana-trench/IssueIndex.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Kind.h>
+#include <mariana-trench/LibrarySummaries.h>
 #include <mariana-trench/LifecycleMethods.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/MarianaTrench.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/MethodMappings.h>
+#include <mariana-trench/MethodProfiles.h>
+#include <mariana-trench/MethodSampler.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/ModelFingerprints.h>
 #include <mariana-trench/ModelGeneration.h>
+#include <mariana-trench/ModelSizes.h>
+#include <mariana-trench/ModelStreamer.h>
 #include <mariana-trench/OperatingSystem.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Overrides.h>
+#include <mariana-trench/Partitions.h>
 #include <mariana-trench/Positions.h>
 #include <mariana-trench/PostprocessTraces.h>
+#include <mariana-trench/Progress.h>
+#include <mariana-trench/Reachability.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/RelevancePrescan.h>
 #include <mariana-trench/Rules.h>
 #include <mariana-trench/Scheduler.h>
+#include <mariana-trench/Shard.h>
 #include <mariana-trench/Statistics.h>
+#include <mariana-trench/TieredAnalysis.h>
 #include <mariana-trench/Timer.h>
 #include <mariana-trench/Types.h>
 #include <mariana-trench/UsedKinds.h>
@@ -64,9 +93,129 @@ void MarianaTrench::add_options(
   Options::add_options(options);
 }
 
+namespace {
+
+/**
+ * Load a graph from the snapshot at the given path if it is valid, otherwise
+ * build it and store a new snapshot. Snapshots are not used if no path is
+ * given.
+ */
+template <typename Graph>
+std::unique_ptr<Graph> load_or_build_graph(
+    const std::optional<std::filesystem::path>& snapshot_path,
+    const std::string& fingerprint,
+    const std::function<std::unique_ptr<Graph>(const GraphSnapshot::Edges&)>&
+        load,
+    const std::function<std::unique_ptr<Graph>()>& build) {
+  if (!snapshot_path) {
+    return build();
+  }
+
+  if (auto edges = GraphSnapshot::read(*snapshot_path, fingerprint)) {
+    if (auto graph = load(*edges)) {
+      LOG(1, "Loaded graph snapshot from `{}`.", snapshot_path->native());
+      return graph;
+    }
+    WARNING(
+        1,
+        "Graph snapshot `{}` refers to unknown symbols, ignoring it.",
+        snapshot_path->native());
+  }
+
+  auto graph = build();
+  GraphSnapshot::write(*snapshot_path, fingerprint, graph->to_snapshot());
+  return graph;
+}
+
+std::optional<std::filesystem::path> graph_snapshot_path(
+    const Options& options,
+    std::string_view name) {
+  const auto& directory = options.precomputed_graphs_directory();
+  if (!directory) {
+    return std::nullopt;
+  }
+  return std::filesystem::path(*directory) / name;
+}
+
+void set_phase(
+    const Context& context,
+    std::string phase,
+    const Registry* MT_NULLABLE registry = nullptr) {
+  if (context.memory_accounting) {
+    context.memory_accounting->record(phase, context, registry);
+  }
+  if (context.progress) {
+    context.progress->set_phase(std::move(phase));
+  }
+}
+
+/*
+ * With `--trim-allocator-memory`, return the memory freed by the given phase
+ * to the operating system. Freed memory otherwise stays in the allocator, and
+ * the resident set size never shrinks after transient peaks.
+ */
+void trim_allocator_memory(const Context& context, const std::string& phase) {
+  if (!context.options->trim_allocator_memory()) {
+    return;
+  }
+  Timer timer;
+  auto resident_set_size = resident_set_size_in_gb();
+  if (!marianatrench::trim_allocator_memory()) {
+    WARNING(1, "Trimming allocator memory is not supported.");
+    return;
+  }
+  LOG(1,
+      "Trimmed allocator memory after {} in {:.2f}s. Memory used, RSS: {:.2f}GB -> {:.2f}GB",
+      phase,
+      timer.duration_in_seconds(),
+      resident_set_size,
+      resident_set_size_in_gb());
+}
+
+/*
+ * Seed the schedule with the analysis times of a previous run, and make the
+ * methods exceeding `--maximum-method-analysis-time` obscure upfront, as the
+ * fixpoint would after analyzing them. Returns the number of such methods.
+ */
+std::size_t seed_previous_method_profiles(
+    Context& context,
+    Registry& registry,
+    const std::filesystem::path& profiles_directory) {
+  auto profiles = MethodProfiles::read(profiles_directory, *context.methods);
+  auto slow_method_bound = context.options->maximum_method_analysis_time();
+
+  std::unordered_map<const Method*, double> analysis_times;
+  std::size_t obscure_methods = 0;
+  for (const auto& [method, profile] : profiles) {
+    if (profile.analyses == 0) {
+      continue;
+    }
+    auto duration = profile.time / static_cast<double>(profile.analyses);
+    analysis_times.emplace(method, duration);
+    if (!slow_method_bound || duration < *slow_method_bound ||
+        method->get_code() == nullptr ||
+        registry.get_snapshot(method)->skip_analysis()) {
+      continue;
+    }
+    registry.update(method, [&context](Model& model) {
+      model.add_mode(Model::Mode::AddViaObscureFeature, context);
+      model.add_mode(Model::Mode::SkipAnalysis, context);
+      model.add_mode(Model::Mode::NoJoinVirtualOverrides, context);
+      model.add_mode(Model::Mode::TaintInTaintOut, context);
+      model.add_mode(Model::Mode::TaintInTaintThis, context);
+    });
+    obscure_methods++;
+  }
+  context.scheduler->seed_analysis_times(analysis_times);
+  return obscure_methods;
+}
+
+} // namespace
+
 Registry MarianaTrench::analyze(Context& context) {
   context.artificial_methods = std::make_unique<ArtificialMethods>(
       *context.kind_factory, context.stores);
+  set_phase(context, "preprocessing");
   Timer methods_timer;
   LOG(1, "Storing methods...");
   context.methods = std::make_unique<Methods>(context.stores);
@@ -92,50 +241,81 @@ Registry MarianaTrench::analyze(Context& context) {
       fields_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
-  Timer index_timer;
-  LOG(1, "Building source index...");
-  context.positions =
-      std::make_unique<Positions>(*context.options, context.stores);
-  context.statistics->log_time("source_index", index_timer);
-  LOG(1,
-      "Built source index in {:.2f}s. Memory used, RSS: {:.2f}GB",
-      index_timer.duration_in_seconds(),
-      resident_set_size_in_gb());
-
-  Timer control_flow_graphs_timer;
-  LOG(1, "Building control flow graphs...");
-  context.control_flow_graphs =
-      std::make_unique<ControlFlowGraphs>(context.stores);
-  context.statistics->log_time(
-      "control_flow_graphs", control_flow_graphs_timer);
-  LOG(1,
-      "Built control flow graphs in {:.2f}s. Memory used, RSS: {:.2f}GB",
-      control_flow_graphs_timer.duration_in_seconds(),
-      resident_set_size_in_gb());
-
-  Timer types_timer;
-  LOG(1, "Inferring types...");
-  context.types = std::make_unique<Types>(*context.options, context.stores);
-  context.statistics->log_time("types", types_timer);
-  LOG(1,
-      "Inferred types in {:.2f}s. Memory used, RSS: {:.2f}GB",
-      types_timer.duration_in_seconds(),
-      resident_set_size_in_gb());
+  // The source index only reads the stores and the source files, while the
+  // class hierarchies, fields cache, class intervals and override graph only
+  // read the class and method declarations. Hence they are built concurrently.
+  // Building control flow graphs changes the code of methods, which the source
+  // index reads, so it waits for the source index.
+  auto positions = std::async(std::launch::async, [&context]() {
+    Timer index_timer;
+    LOG(1, "Building source index...");
+    auto positions =
+        std::make_unique<Positions>(*context.options, context.stores);
+    context.statistics->log_time("source_index", index_timer);
+    LOG(1,
+        "Built source index in {:.2f}s. Memory used, RSS: {:.2f}GB",
+        index_timer.duration_in_seconds(),
+        resident_set_size_in_gb());
+    return positions;
+  });
+
+  std::string graphs_fingerprint;
+  if (context.options->precomputed_graphs_directory()) {
+    Timer graphs_fingerprint_timer;
+    LOG(1, "Computing fingerprint for graph snapshots...");
+    graphs_fingerprint = GraphSnapshot::fingerprint(context.stores);
+    LOG(1,
+        "Computed fingerprint for graph snapshots in {:.2f}s.",
+        graphs_fingerprint_timer.duration_in_seconds());
+  }
 
   Timer class_hierarchies_timer;
   LOG(1, "Building class hierarchies...");
-  context.class_hierarchies =
-      std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_hierarchies = load_or_build_graph<ClassHierarchies>(
+      graph_snapshot_path(*context.options, "class_hierarchies.bin"),
+      graphs_fingerprint,
+      /* load */
+      [&context](const GraphSnapshot::Edges& edges) {
+        return ClassHierarchies::from_snapshot(*context.options, edges);
+      },
+      /* build */
+      [&context]() {
+        return std::make_unique<ClassHierarchies>(
+            *context.options, context.stores);
+      });
   context.statistics->log_time("class_hierarchies", class_hierarchies_timer);
   LOG(1,
       "Built class hierarchies in {:.2f}s. Memory used, RSS: {:.2f}GB",
       class_hierarchies_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
+  Timer class_intervals_timer;
+  LOG(1, "Computing class intervals...");
+  // Snapshots of disabled class intervals would be empty.
+  context.class_intervals = load_or_build_graph<ClassIntervals>(
+      context.options->disable_class_intervals()
+          ? std::nullopt
+          : graph_snapshot_path(*context.options, "class_intervals.bin"),
+      graphs_fingerprint,
+      /* load */
+      [&context](const GraphSnapshot::Edges& edges) {
+        return ClassIntervals::from_snapshot(*context.options, edges);
+      },
+      /* build */
+      [&context]() {
+        return std::make_unique<ClassIntervals>(
+            *context.options, context.stores);
+      });
+  context.statistics->log_time("class_intervals", class_intervals_timer);
+  LOG(1,
+      "Computed class intervals in {:.2f}s. Memory used, RSS: {:.2f}GB",
+      class_intervals_timer.duration_in_seconds(),
+      resident_set_size_in_gb());
+
   Timer field_cache_timer;
   LOG(1, "Building fields cache...");
-  context.field_cache =
-      std::make_unique<FieldCache>(*context.class_hierarchies, context.stores);
+  context.field_cache = std::make_unique<FieldCache>(
+      *context.class_hierarchies, *context.class_intervals, context.stores);
   context.statistics->log_time("fields", field_cache_timer);
   LOG(1,
       "Built fields cache in {:.2f}s. Memory used, RSS: {:.2f}GB",
@@ -144,26 +324,63 @@ Registry MarianaTrench::analyze(Context& context) {
 
   Timer overrides_timer;
   LOG(1, "Building override graph...");
-  context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+  context.overrides = load_or_build_graph<Overrides>(
+      graph_snapshot_path(*context.options, "overrides.bin"),
+      graphs_fingerprint,
+      /* load */
+      [&context](const GraphSnapshot::Edges& edges) {
+        return Overrides::from_snapshot(
+            *context.options,
+            *context.methods,
+            *context.class_intervals,
+            edges);
+      },
+      /* build */
+      [&context]() {
+        return std::make_unique<Overrides>(
+            *context.options,
+            *context.methods,
+            *context.class_intervals,
+            context.stores);
+      });
   context.statistics->log_time("overrides", overrides_timer);
   LOG(1,
       "Built override graph in {:.2f}s. Memory used, RSS: {:.2f}GB",
       overrides_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
-  Timer class_intervals_timer;
-  LOG(1, "Computing class intervals...");
-  context.class_intervals =
-      std::make_unique<ClassIntervals>(*context.options, context.stores);
-  context.statistics->log_time("class_intervals", class_intervals_timer);
+  // This rethrows the exceptions of the source index.
+  context.positions = positions.get();
+
+  Timer control_flow_graphs_timer;
+  LOG(1, "Building control flow graphs...");
+  context.control_flow_graphs =
+      std::make_unique<ControlFlowGraphs>(context.stores);
+  context.statistics->log_time(
+      "control_flow_graphs", control_flow_graphs_timer);
   LOG(1,
-      "Computed class intervals in {:.2f}s. Memory used, RSS: {:.2f}GB",
-      class_intervals_timer.duration_in_seconds(),
+      "Built control flow graphs in {:.2f}s. Memory used, RSS: {:.2f}GB",
+      control_flow_graphs_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
+  // Model generators do not need types, shims nor the call graph.
+  bool dry_run_model_generation = context.options->dry_run_model_generation();
+
+  if (!dry_run_model_generation) {
+    Timer types_timer;
+    LOG(1, "Inferring types...");
+    context.types = std::make_unique<Types>(*context.options, context.stores);
+    context.statistics->log_time("types", types_timer);
+    LOG(1,
+        "Inferred types in {:.2f}s. Memory used, RSS: {:.2f}GB",
+        types_timer.duration_in_seconds(),
+        resident_set_size_in_gb());
+  }
+
   std::vector<Model> generated_models;
   std::vector<FieldModel> generated_field_models;
+  // Names of the life-cycle wrappers, which are entry points of the program.
+  std::unordered_set<std::string> lifecycle_method_names;
 
   // Scope for LifecycleMethods, MethodMappings, Shims and IntentRoutingAnalyzer
   // as they are only used for callgraph construction, shim and model generation
@@ -174,65 +391,79 @@ Registry MarianaTrench::analyze(Context& context) {
     auto lifecycle_methods = LifecycleMethods::run(
         *context.options, *context.class_hierarchies, *context.methods);
     context.statistics->log_time("lifecycle_methods", lifecycle_methods_timer);
+    if (context.options->prune_unreachable_methods()) {
+      for (const auto& [method_name, _lifecycle_method] :
+           lifecycle_methods.methods()) {
+        lifecycle_method_names.insert(method_name);
+      }
+    }
 
     LOG(1,
         "Created lifecycle methods in {:.2f}s. Memory used, RSS: {:.2f}GB",
         lifecycle_methods_timer.duration_in_seconds(),
         resident_set_size_in_gb());
 
-    Timer method_mapping_timer;
-    LOG(1,
-        "Building method mappings for shim/model generation over {} methods",
-        context.methods->size());
+    // Method mappings are built on demand by shim and model generators.
     MethodMappings method_mappings{*context.methods};
 
-    LOG(1,
-        "Generated method mappings in {:.2f}s. Memory used, RSS: {:.2f}GB",
-        method_mapping_timer.duration_in_seconds(),
-        resident_set_size_in_gb());
-
-    Timer intent_routing_analyzer_timer;
-    LOG(1, "Running intent routing analyzer...");
-    auto intent_routing_analyzer = IntentRoutingAnalyzer::run(context);
-    LOG(1,
-        "Created intent routing analyzer in {:.2f}s. Memory used, RSS: {:.2f}MB",
-        intent_routing_analyzer_timer.duration_in_seconds(),
-        resident_set_size_in_gb());
-
-    Timer shims_timer;
-    LOG(1, "Creating Shims...");
-    Shims shims =
-        ShimGeneration::run(context, intent_routing_analyzer, method_mappings);
-    LOG(1,
-        "Created Shims in {:.2f}s. Memory used, RSS: {:.2f}GB",
-        shims_timer.duration_in_seconds(),
-        resident_set_size_in_gb());
-
-    Timer call_graph_timer;
-    LOG(1, "Building call graph...");
-    context.call_graph = std::make_unique<CallGraph>(
-        *context.options,
-        *context.types,
-        *context.class_hierarchies,
-        lifecycle_methods,
-        shims,
-        *context.feature_factory,
-        *context.methods,
-        *context.fields,
-        *context.overrides,
-        method_mappings);
-    context.statistics->log_time("call_graph", call_graph_timer);
-    LOG(1,
-        "Built call graph in {:.2f}s. Memory used, RSS: {:.2f}GB",
-        call_graph_timer.duration_in_seconds(),
-        resident_set_size_in_gb());
+    if (!dry_run_model_generation) {
+      Timer intent_routing_analyzer_timer;
+      LOG(1, "Running intent routing analyzer...");
+      auto intent_routing_analyzer = IntentRoutingAnalyzer::run(context);
+      LOG(1,
+          "Created intent routing analyzer in {:.2f}s. Memory used, RSS: {:.2f}MB",
+          intent_routing_analyzer_timer.duration_in_seconds(),
+          resident_set_size_in_gb());
+
+      Timer shims_timer;
+      LOG(1, "Creating Shims...");
+      Shims shims = ShimGeneration::run(
+          context, intent_routing_analyzer, method_mappings);
+      LOG(1,
+          "Created Shims in {:.2f}s. Memory used, RSS: {:.2f}GB",
+          shims_timer.duration_in_seconds(),
+          resident_set_size_in_gb());
+
+      Timer call_graph_timer;
+      LOG(1, "Building call graph...");
+      context.call_graph = std::make_unique<CallGraph>(
+          *context.options,
+          *context.types,
+          *context.class_hierarchies,
+          lifecycle_methods,
+          shims,
+          *context.feature_factory,
+          *context.methods,
+          *context.fields,
+          *context.overrides,
+          method_mappings);
+      context.statistics->log_time("call_graph", call_graph_timer);
+      LOG(1,
+          "Built call graph in {:.2f}s. Memory used, RSS: {:.2f}GB",
+          call_graph_timer.duration_in_seconds(),
+          resident_set_size_in_gb());
+      LOG(1,
+          "Created {} methods with parameter type overrides, {} calls fell back to methods without overrides.",
+          context.methods->number_of_variants(),
+          context.methods->number_of_bounded_variants());
+
+      if (auto maximum_methods =
+              context.options->maximum_cached_type_environments()) {
+        context.types->limit_cached_environments(*maximum_methods);
+        LOG(1,
+            "Limited cached type environments to {} methods. Memory used, RSS: {:.2f}GB",
+            *maximum_methods,
+            resident_set_size_in_gb());
+      }
+    }
 
+    set_phase(context, "model_generation");
     Timer generation_timer;
     LOG(1, "Generating models...");
     auto model_generator_result =
         ModelGeneration::run(context, method_mappings);
-    generated_models = model_generator_result.method_models;
-    generated_field_models = model_generator_result.field_models;
+    generated_models = std::move(model_generator_result.method_models);
+    generated_field_models = std::move(model_generator_result.field_models);
     context.statistics->log_time("models_generation", generation_timer);
     LOG(1,
         "Generated {} models and {} field models in {:.2f}s. Memory used, RSS: {:.2f}GB",
@@ -245,26 +476,17 @@ Registry MarianaTrench::analyze(Context& context) {
   LOG(1,
       "Reset MethodToShims and Method Mappings. Memory used, RSS: {:.2f}GB",
       resident_set_size_in_gb());
+  trim_allocator_memory(context, "model generation");
 
   // Add models for artificial methods.
   {
     auto models = context.artificial_methods->models(context);
     generated_models.insert(
-        generated_models.end(), models.begin(), models.end());
+        generated_models.end(),
+        std::make_move_iterator(models.begin()),
+        std::make_move_iterator(models.end()));
   }
 
-  Timer registry_timer;
-  LOG(1, "Initializing models...");
-  auto registry = Registry::load(
-      context, *context.options, generated_models, generated_field_models);
-  context.statistics->log_time("registry_init", registry_timer);
-  LOG(1,
-      "Initialized {} models and {} field models in {:.2f}s. Memory used, RSS: {:.2f}GB",
-      registry.models_size(),
-      registry.field_models_size(),
-      registry_timer.duration_in_seconds(),
-      resident_set_size_in_gb());
-
   Timer rules_timer;
   LOG(1, "Initializing rules...");
   context.rules =
@@ -276,6 +498,12 @@ Registry MarianaTrench::analyze(Context& context) {
       rules_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
+  // In a dry run of model generation, rules are only needed by the metadata.
+  if (dry_run_model_generation) {
+    LOG(1, "Stopping after model generation.");
+    return Registry(context, generated_models, generated_field_models);
+  }
+
   Timer transforms_timer;
   LOG(1, "Initializing used transform kinds...");
   context.used_kinds = std::make_unique<UsedKinds>(
@@ -288,18 +516,31 @@ Registry MarianaTrench::analyze(Context& context) {
       transforms_timer.duration_in_seconds(),
       resident_set_size_in_gb());
 
+  set_phase(context, "registry_init");
+  Timer registry_timer;
+  LOG(1, "Initializing models...");
+  auto registry = Registry::load(
+      context, *context.options, generated_models, generated_field_models);
+  // Generated models are now joined into the registry.
+  std::vector<Model>().swap(generated_models);
+  std::vector<FieldModel>().swap(generated_field_models);
+  context.statistics->log_time("registry_init", registry_timer);
+  LOG(1,
+      "Initialized {} models and {} field models in {:.2f}s. Memory used, RSS: {:.2f}GB",
+      registry.models_size(),
+      registry.field_models_size(),
+      registry_timer.duration_in_seconds(),
+      resident_set_size_in_gb());
+
   Timer kind_pruning_timer;
-  LOG(1, "Removing unused Kinds...");
-  auto num_removed = context.used_kinds->remove_unused_kinds(
-      *context.rules,
-      *context.kind_factory,
-      *context.methods,
-      *context.artificial_methods,
-      registry);
-  context.statistics->log_time("prune_kinds", rules_timer);
+  LOG(1, "Collecting unused Kinds...");
+  auto unused_kinds =
+      context.rules->collect_unused_kinds(*context.kind_factory);
+  context.artificial_methods->set_unused_kinds(unused_kinds);
+  context.statistics->log_time("prune_kinds", kind_pruning_timer);
   LOG(1,
       "Removed {} kinds in {:.2f}s.",
-      num_removed,
+      unused_kinds.size(),
       kind_pruning_timer.duration_in_seconds());
 
   Timer dependencies_timer;
@@ -317,6 +558,28 @@ Registry MarianaTrench::analyze(Context& context) {
       resident_set_size_in_gb());
 
   if (!context.options->skip_analysis()) {
+    // The slice is contained in the methods that may hold taint.
+    if (context.options->source_sink_slicing()) {
+      Timer slicing_timer;
+      LOG(1, "Finding the methods through which sources may reach sinks...");
+      TieredAnalysis::skip_methods_outside_slice(context, registry);
+      context.statistics->log_time("source_sink_slicing", slicing_timer);
+      LOG(1,
+          "Found the methods through which sources may reach sinks in {:.2f}s.",
+          slicing_timer.duration_in_seconds());
+    } else if (context.options->tiered_analysis()) {
+      Timer tiered_analysis_timer;
+      LOG(1, "Finding the methods that may hold taint...");
+      TieredAnalysis::skip_irrelevant_methods(context, registry);
+      context.statistics->log_time("tiered_analysis", tiered_analysis_timer);
+      LOG(1,
+          "Found the methods that may hold taint in {:.2f}s.",
+          tiered_analysis_timer.duration_in_seconds());
+    }
+    if (context.options->relevance_prescan()) {
+      context.relevance_prescan = std::make_unique<RelevancePrescan>();
+    }
+
     Timer class_properties_timer;
     context.class_properties = std::make_unique<ClassProperties>(
         *context.options,
@@ -329,6 +592,19 @@ Registry MarianaTrench::analyze(Context& context) {
         class_properties_timer.duration_in_seconds(),
         resident_set_size_in_gb());
 
+    // Components of the manifest are entry points, hence this needs the
+    // class properties.
+    if (context.options->prune_unreachable_methods()) {
+      Timer reachability_timer;
+      LOG(1, "Finding the methods reachable from entry points...");
+      Reachability::skip_unreachable_methods(
+          context, registry, lifecycle_method_names);
+      context.statistics->log_time("reachability", reachability_timer);
+      LOG(1,
+          "Found the reachable methods in {:.2f}s.",
+          reachability_timer.duration_in_seconds());
+    }
+
     Timer scheduler_timer;
     LOG(1, "Building the analysis schedule...");
     context.scheduler =
@@ -339,24 +615,147 @@ Registry MarianaTrench::analyze(Context& context) {
         scheduler_timer.duration_in_seconds(),
         resident_set_size_in_gb());
 
+    if (const auto& profiles_directory =
+            context.options->previous_method_profiles_directory()) {
+      Timer previous_profiles_timer;
+      LOG(1, "Reading the method profiles of the previous run...");
+      auto obscure_methods =
+          seed_previous_method_profiles(context, registry, *profiles_directory);
+      context.statistics->log_time(
+          "previous_method_profiles", previous_profiles_timer);
+      LOG(1,
+          "Read the method profiles of the previous run in {:.2f}s, {} methods are made obscure.",
+          previous_profiles_timer.duration_in_seconds(),
+          obscure_methods);
+    }
+
+    if (auto partitions = context.options->partitions()) {
+      Timer partitions_timer;
+      LOG(1, "Partitioning the analysis in {} partitions...", *partitions);
+      Partitions(*context.scheduler, *partitions)
+          .dump(context.options->partitions_output_path());
+      context.statistics->log_time("partitions", partitions_timer);
+      LOG(1,
+          "Partitioned the analysis in {:.2f}s.",
+          partitions_timer.duration_in_seconds());
+    }
+
+    if (auto shards = context.options->shards()) {
+      auto shard_index = context.options->shard_index();
+      context.shard = std::make_unique<Shard>(
+          *context.scheduler,
+          *shards,
+          shard_index ? std::make_optional<std::size_t>(*shard_index)
+                      : std::nullopt,
+          *context.options->shard_directory());
+      if (!context.shard->merging()) {
+        LOG(1, "Analyzing shard {} out of {}.", *shard_index, *shards);
+        context.shard->load_boundaries(context, registry);
+      }
+    }
+
+    if (auto cache_directory = context.options->analysis_cache_directory()) {
+      Timer analysis_cache_timer;
+      LOG(1, "Loading the analysis cache...");
+      context.analysis_cache = std::make_unique<AnalysisCache>(
+          *cache_directory,
+          *context.options,
+          *context.methods,
+          *context.dependencies,
+          registry);
+      context.statistics->log_time("analysis_cache", analysis_cache_timer);
+      LOG(1,
+          "Loaded the analysis cache in {:.2f}s, skipping {} methods.",
+          analysis_cache_timer.duration_in_seconds(),
+          context.analysis_cache->skipped_methods_size());
+    }
+
+    if (context.options->enable_callsite_model_cache()) {
+      auto maximum_entries =
+          context.options->maximum_callsite_model_cache_entries();
+      context.callsite_model_cache = std::make_unique<CallsiteModelCache>(
+          maximum_entries ? std::make_optional<std::size_t>(*maximum_entries)
+                          : std::nullopt);
+    }
+
+    if (context.options->stream_models()) {
+      context.model_streamer = std::make_unique<ModelStreamer>(
+          context,
+          context.options->models_output_path(),
+          JsonValidation::k_default_shard_limit,
+          context.options->output_compression_level());
+    }
+
+    if (context.options->dump_method_profiles()) {
+      context.method_profiles = std::make_unique<MethodProfiles>();
+    }
+
+    if (context.options->track_model_sizes()) {
+      auto threshold = context.options->model_size_warning_threshold();
+      context.model_sizes = std::make_unique<ModelSizes>(
+          threshold ? std::make_optional<std::size_t>(*threshold)
+                    : std::nullopt);
+    }
+    if (context.options->convergence_report()) {
+      context.convergence_report = std::make_unique<ConvergenceReport>();
+    }
+
+    if (context.options->daemon()) {
+      context.daemon = std::make_unique<Daemon>(context, registry);
+    }
+
+    if (context.options->dump_coverage_info()) {
+      // Rule coverage is then computed without a traversal of all models.
+      registry.count_kinds();
+    }
+
+    set_phase(context, "fixpoint", &registry);
     Timer analysis_timer;
-    LOG(1, "Analyzing...");
-    Interprocedural::run_analysis(context, registry);
+    if (context.shard && context.shard->merging()) {
+      LOG(1, "Merging the models of the shards...");
+      context.shard->merge(context, registry);
+    } else {
+      LOG(1, "Analyzing...");
+      Interprocedural::run_analysis(context, registry);
+    }
+    context.callsite_model_cache = nullptr;
     context.statistics->log_time("fixpoint", analysis_timer);
     LOG(1,
         "Analyzed {} models in {:.2f}s. Found {} issues!",
         registry.models_size(),
         analysis_timer.duration_in_seconds(),
         registry.issues_size());
+    trim_allocator_memory(context, "the fixpoint");
+    // Models are stored before postprocessing, which the merge applies.
+    if (context.shard && !context.shard->merging()) {
+      context.shard->store(context, registry);
+    }
 
-    Timer remove_collapsed_traces_timer;
-    LOG(2, "Removing invalid traces due to collapsing...");
-    PostprocessTraces::remove_collapsed_traces(registry, context);
-    context.statistics->log_time(
-        "remove_collapsed_traces", remove_collapsed_traces_timer);
-    LOG(2,
-        "Removed invalid traces in {:.2f}s.",
-        remove_collapsed_traces_timer.duration_in_seconds());
+    set_phase(context, "postprocessing", &registry);
+    if (context.analysis_cache) {
+      context.analysis_cache->store(registry);
+    }
+    if (!context.options->summarize_library().empty()) {
+      Timer library_summaries_timer;
+      LibrarySummaries::store(
+          context.options->library_summaries_output_path(),
+          context.options->summarize_library(),
+          context,
+          registry);
+      context.statistics->log_time(
+          "library_summaries", library_summaries_timer);
+    }
+
+    if (!Interprocedural::removes_collapsed_traces(context)) {
+      Timer remove_collapsed_traces_timer;
+      LOG(2, "Removing invalid traces due to collapsing...");
+      PostprocessTraces::remove_collapsed_traces(registry, context);
+      context.statistics->log_time(
+          "remove_collapsed_traces", remove_collapsed_traces_timer);
+      LOG(2,
+          "Removed invalid traces in {:.2f}s.",
+          remove_collapsed_traces_timer.duration_in_seconds());
+    }
   } else {
     LOG(2, "Skipped taint analysis.");
   }
@@ -402,6 +801,27 @@ void MarianaTrench::run(const program_options::variables_map& variables) {
   const auto& options = *context.options;
 
   EventLogger::init_event_logger(context.options.get());
+  if (options.dump_trace()) {
+    context.statistics->enable_trace();
+  }
+  if (options.collect_cache_statistics()) {
+    CacheStatistics::enable();
+  }
+  if (options.write_status()) {
+    context.progress = std::make_unique<Progress>(
+        options.status_output_path(),
+        std::chrono::seconds(options.status_interval()));
+  }
+  if (options.sample_analyzed_methods()) {
+    context.method_sampler =
+        std::make_unique<MethodSampler>(options.sampling_frequency());
+  }
+  if (options.memory_accounting()) {
+    context.memory_accounting = std::make_unique<MemoryAccounting>(
+        options.memory_accounting_sampling_rate());
+  }
+
+  set_phase(context, "redex_init");
 
   auto system_jar_paths = filter_existing_jars(options.system_jar_paths());
 
@@ -415,9 +835,20 @@ void MarianaTrench::run(const program_options::variables_map& variables) {
       /* throw_on_balloon_error */ true,
       /* support_dex_version */ 39);
 
+  context.statistics->log_time("redex_load", initialization_timer);
+  LOG(2,
+      "Loaded dex files and system jars in {:.2f}s.",
+      initialization_timer.duration_in_seconds());
+
+  Timer proguard_timer;
   redex::process_proguard_configurations(options, context.stores);
+  context.statistics->log_time("proguard_configurations", proguard_timer);
+
   if (context.options->remove_unreachable_code()) {
+    Timer remove_unreachable_timer;
     redex::remove_unreachable(options, context.stores);
+    context.statistics->log_time(
+        "remove_unreachable", remove_unreachable_timer);
   }
 
   DexStore external_store("external classes");
@@ -431,38 +862,97 @@ void MarianaTrench::run(const program_options::variables_map& variables) {
 
   auto registry = analyze(context);
 
+  if (context.method_sampler) {
+    context.method_sampler->dump(options.method_samples_output_path());
+    context.method_sampler = nullptr;
+  }
+
+  set_phase(context, "dump_models", &registry);
   Timer output_timer;
   auto models_path = options.models_output_path();
   LOG(1, "Writing models to `{}`.", models_path.native());
-  registry.dump_models(models_path);
+  if (context.model_streamer) {
+    context.model_streamer->finish(registry);
+    context.model_streamer = nullptr;
+  } else if (options.binary_model_output()) {
+    registry.dump_binary_models(models_path);
+  } else if (options.dump_model_fingerprints()) {
+    auto previous_fingerprints = options.previous_model_fingerprints_path()
+        ? ModelFingerprints::read(*options.previous_model_fingerprints_path())
+        : ModelFingerprints();
+    auto fingerprints = registry.dump_changed_models(
+        models_path,
+        previous_fingerprints,
+        options.model_tombstones_output_path(),
+        JsonValidation::k_default_shard_limit,
+        options.output_compression_level(),
+        options.output_string_tables());
+    fingerprints.write(options.model_fingerprints_output_path());
+  } else {
+    registry.dump_models(
+        models_path,
+        JsonValidation::k_default_shard_limit,
+        options.output_compression_level(),
+        options.output_string_tables(),
+        options.dump_model_index()
+            ? std::optional(options.model_index_output_path())
+            : std::nullopt);
+  }
   context.statistics->log_time("dump_models", output_timer);
   LOG(1, "Wrote models in {:.2f}s.", output_timer.duration_in_seconds());
 
-  if (options.dump_coverage_info()) {
-    Timer file_coverage_timer;
-    auto file_coverage_output_path = options.file_coverage_output_path();
-    LOG(1, "Writing file coverage info to `{}`.", file_coverage_output_path);
-    registry.dump_file_coverage_info(file_coverage_output_path);
-    context.statistics->log_time(
-        "dump_file_coverage_info", file_coverage_timer);
+  if (options.dump_issues()) {
+    Timer issues_timer;
+    auto issues_path = options.issues_output_path();
+    LOG(1, "Writing issues to `{}`.", issues_path.native());
+    IssueIndex issues(registry, context);
+    issues.dump(issues_path, options.export_origins_mode());
+    context.statistics->log_time("dump_issues", issues_timer);
     LOG(1,
-        "Wrote file coverage info in {:.2f}s.",
-        file_coverage_timer.duration_in_seconds());
+        "Wrote {} issues in {:.2f}s.",
+        issues.size(),
+        issues_timer.duration_in_seconds());
+  }
 
-    Timer rule_coverage_timer;
-    auto rule_coverage_output_path = options.rule_coverage_output_path();
-    LOG(1, "Writing rule coverage info to `{}`.", rule_coverage_output_path);
-    registry.dump_rule_coverage_info(rule_coverage_output_path);
-    context.statistics->log_time(
-        "dump_rule_coverage_info", rule_coverage_timer);
-    LOG(1,
-        "Wrote rule coverage info in {:.2f}s.",
-        rule_coverage_timer.duration_in_seconds());
+  if (context.method_profiles) {
+    LOG(1, "Writing method profiles to `{}`.", models_path.native());
+    context.method_profiles->dump(
+        models_path, JsonValidation::k_default_shard_limit);
   }
 
+  set_phase(context, "dump_metadata", &registry);
+  Timer metadata_timer;
   auto metadata_path = options.metadata_output_path();
   LOG(1, "Writing metadata to `{}`.", metadata_path.native());
-  registry.dump_metadata(/* path */ metadata_path);
+  std::optional<std::filesystem::path> file_coverage_output_path;
+  std::optional<std::filesystem::path> rule_coverage_output_path;
+  if (options.dump_coverage_info()) {
+    file_coverage_output_path = options.file_coverage_output_path();
+    rule_coverage_output_path = options.rule_coverage_output_path();
+    LOG(1,
+        "Writing file coverage info to `{}` and rule coverage info to `{}`.",
+        file_coverage_output_path->native(),
+        rule_coverage_output_path->native());
+  }
+  registry.dump_metadata_and_coverage_info(
+      metadata_path, file_coverage_output_path, rule_coverage_output_path);
+  LOG(1, "Wrote metadata in {:.2f}s.", metadata_timer.duration_in_seconds());
+
+  if (options.dump_trace()) {
+    auto trace_path = options.trace_output_path();
+    LOG(1, "Writing trace to `{}`.", trace_path.native());
+    context.statistics->dump_trace(trace_path);
+  }
+
+  trim_allocator_memory(context, "the output");
+
+  // Write the final status.
+  set_phase(context, "done");
+  context.progress = nullptr;
+
+  if (context.daemon) {
+    context.daemon->serve(context, registry, std::cin, std::cout);
+  }
 }
 
 } // namespace marianatrench
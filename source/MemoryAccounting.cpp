@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/ClassHierarchies.h>
+#include <mariana-trench/Context.h>
+#include <mariana-trench/ControlFlowGraphs.h>
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/FeatureFactory.h>
+#include <mariana-trench/KindFactory.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/OperatingSystem.h>
+#include <mariana-trench/OriginFactory.h>
+#include <mariana-trench/Overrides.h>
+#include <mariana-trench/Positions.h>
+#include <mariana-trench/Registry.h>
+#include <mariana-trench/Types.h>
+
+namespace marianatrench {
+
+namespace {
+
+constexpr double k_bytes_per_gb = 1024.0 * 1024.0 * 1024.0;
+
+} // namespace
+
+MemoryAccounting::MemoryAccounting(std::size_t sampling_rate)
+    : sampling_rate_(std::max<std::size_t>(sampling_rate, 1)) {}
+
+void MemoryAccounting::record(
+    const std::string& label,
+    const Context& context,
+    const Registry* MT_NULLABLE registry) {
+  Record record{label, resident_set_size_in_gb(), {}};
+  auto& bytes = record.bytes;
+
+  if (registry != nullptr) {
+    for (const auto& [component, component_bytes] :
+         registry->memory_usage(sampling_rate_)) {
+      bytes["models." + component] = component_bytes;
+    }
+  }
+  if (context.call_graph != nullptr) {
+    bytes["call_graph"] = context.call_graph->memory_usage();
+  }
+  if (context.dependencies != nullptr) {
+    bytes["dependencies"] = context.dependencies->memory_usage();
+  }
+  if (context.overrides != nullptr) {
+    bytes["overrides"] = context.overrides->memory_usage();
+  }
+  if (context.class_hierarchies != nullptr) {
+    bytes["class_hierarchies"] = context.class_hierarchies->memory_usage();
+  }
+  if (context.types != nullptr) {
+    bytes["types"] = context.types->memory_usage(sampling_rate_);
+  }
+  if (context.methods != nullptr && context.control_flow_graphs != nullptr) {
+    bytes["control_flow_graphs"] =
+        ControlFlowGraphs::memory_usage(*context.methods, sampling_rate_);
+  }
+  if (context.positions != nullptr) {
+    bytes["positions"] = context.positions->memory_usage();
+  }
+  bytes["factories.kinds"] = KindFactory::singleton().memory_usage();
+  bytes["factories.features"] = FeatureFactory::singleton().memory_usage();
+  bytes["factories.origins"] = OriginFactory::singleton().memory_usage();
+
+  std::size_t total = 0;
+  for (const auto& [category, category_bytes] : bytes) {
+    total += category_bytes;
+  }
+  LOG(1,
+      "Memory accounting at `{}`: {:.2f}GB estimated, {:.2f}GB resident.",
+      label,
+      static_cast<double>(total) / k_bytes_per_gb,
+      record.resident_set_size);
+
+  records_.push_back(std::move(record));
+}
+
+Json::Value MemoryAccounting::to_json() const {
+  auto value = Json::Value(Json::arrayValue);
+  for (const auto& record : records_) {
+    auto record_value = Json::Value(Json::objectValue);
+    record_value["label"] = Json::Value(record.label);
+    record_value["rss"] = Json::Value(record.resident_set_size);
+    auto bytes_value = Json::Value(Json::objectValue);
+    std::size_t total = 0;
+    for (const auto& [category, bytes] : record.bytes) {
+      bytes_value[category] = Json::Value(static_cast<Json::UInt64>(bytes));
+      total += bytes;
+    }
+    record_value["bytes"] = bytes_value;
+    record_value["total"] = Json::Value(static_cast<Json::UInt64>(total));
+    value.append(record_value);
+  }
+  return value;
+}
+
+} // namespace marianatrench
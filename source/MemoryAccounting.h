@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+class Context;
+class Registry;
+
+/**
+ * Approximate memory used by data structures, in bytes.
+ *
+ * These only account for the elements and the per-element overhead of the
+ * containers, not for allocator fragmentation or shared data.
+ */
+namespace memory_usage {
+
+/* Overhead of a node of a node-based container (links, hash, bucket). */
+constexpr std::size_t k_node_overhead = 3 * sizeof(void*);
+
+template <typename Element>
+constexpr std::size_t nodes(std::size_t size) {
+  return size * (sizeof(Element) + k_node_overhead);
+}
+
+template <typename Container>
+constexpr std::size_t contiguous(const Container& container) {
+  return container.capacity() * sizeof(typename Container::value_type);
+}
+
+} // namespace memory_usage
+
+/**
+ * Approximate memory accounting of the major data structures of the analysis,
+ * enabled with `--memory-accounting`.
+ *
+ * Estimates are recorded at the beginning of each phase and of each global
+ * iteration, along with the resident set size, and reported in the metadata.
+ * Structures with an entry per method (models, types, control flow graphs)
+ * are only measured for one method out of `sampling_rate`, and extrapolated.
+ */
+class MemoryAccounting final {
+ public:
+  explicit MemoryAccounting(std::size_t sampling_rate);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(MemoryAccounting)
+
+  /**
+   * Estimate the memory used by the structures of the context and the
+   * registry, if any. This must be called while no other thread modifies them.
+   */
+  void record(
+      const std::string& label,
+      const Context& context,
+      const Registry* MT_NULLABLE registry);
+
+  Json::Value to_json() const;
+
+ private:
+  struct Record {
+    std::string label;
+    double resident_set_size;
+    // Bytes by category, e.g `call_graph` or `models.sinks`.
+    std::map<std::string, std::size_t> bytes;
+  };
+
+  std::size_t sampling_rate_;
+  std::vector<Record> records_;
+};
+
+} // namespace marianatrench
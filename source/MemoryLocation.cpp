@@ -5,8 +5,15 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
 #include <fmt/format.h>
 
+#include <ControlFlow.h>
+#include <IRCode.h>
+#include <IRInstruction.h>
 #include <Show.h>
 
 #include <mariana-trench/Assert.h>
@@ -14,12 +21,36 @@
 
 namespace marianatrench {
 
+struct MemoryLocation::FieldLocations {
+  std::mutex mutex;
+  std::deque<FieldMemoryLocation> locations;
+};
+
+// Defined here since field locations are incomplete in the header.
+MemoryLocation::~MemoryLocation() = default;
+
+MemoryLocation::FieldLocations& MemoryLocation::field_locations() {
+  if (field_locations_ == nullptr) {
+    field_locations_ = std::make_unique<FieldLocations>();
+  }
+  return *field_locations_;
+}
+
 FieldMemoryLocation* MemoryLocation::make_field(const DexString* field) {
   mt_assert(field != nullptr);
 
-  auto found = fields_.find(field);
-  if (found != fields_.end()) {
-    return found->second.get();
+  auto& field_locations = this->root()->field_locations();
+  std::lock_guard<std::mutex> lock(field_locations.mutex);
+
+  auto found = std::lower_bound(
+      fields_.begin(),
+      fields_.end(),
+      field,
+      [](const auto& entry, const DexString* field) {
+        return entry.first < field;
+      });
+  if (found != fields_.end() && found->first == field) {
+    return found->second;
   }
 
   // To avoid non-convergence, we need to break infinite chains.
@@ -36,10 +67,9 @@ FieldMemoryLocation* MemoryLocation::make_field(const DexString* field) {
     }
   }
 
-  auto result = fields_.emplace(
-      field, std::make_unique<FieldMemoryLocation>(this, field));
-  mt_assert(result.second);
-  return result.first->second.get();
+  auto* location = &field_locations.locations.emplace_back(this, field);
+  fields_.emplace(found, field, location);
+  return location;
 }
 
 MemoryLocation* MemoryLocation::make_field(const Path& path) {
@@ -140,6 +170,12 @@ std::optional<std::string> InstructionMemoryLocation::get_constant() const {
 MemoryFactory::MemoryFactory(const Method* method) {
   mt_assert(method != nullptr);
 
+  // Avoid rehashing while the forward alias analysis creates locations.
+  const auto* code = method->get_code();
+  if (code != nullptr && code->cfg_built()) {
+    instructions_.reserve(code->cfg().num_opcodes());
+  }
+
   // Create parameter locations
   for (ParameterPosition i = 0; i < method->number_of_parameters(); i++) {
     if (i == 0 && !method->is_static()) {
@@ -167,13 +203,32 @@ InstructionMemoryLocation* MemoryFactory::make_location(
 
   auto found = instructions_.find(instruction);
   if (found != instructions_.end()) {
-    return found->second.get();
+    return found->second;
   }
 
-  auto result = instructions_.emplace(
-      instruction, std::make_unique<InstructionMemoryLocation>(instruction));
+  auto* location = &instruction_locations_.emplace_back(instruction);
+  auto result = instructions_.emplace(instruction, location);
   mt_assert(result.second);
-  return result.first->second.get();
+  return location;
+}
+
+void MemoryFactory::prepare_concurrent_fields(
+    const cfg::ControlFlowGraph& cfg) {
+  for (const auto* block : cfg.blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      if (instruction->has_dest() || instruction->has_move_result_any()) {
+        make_location(instruction);
+      }
+    }
+  }
+
+  for (auto& parameter : parameters_) {
+    parameter->field_locations();
+  }
+  for (auto& location : instruction_locations_) {
+    location.field_locations();
+  }
 }
 
 } // namespace marianatrench
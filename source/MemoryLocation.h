@@ -7,13 +7,17 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <ControlFlow.h>
 #include <DexClass.h>
 
 #include <mariana-trench/Access.h>
@@ -23,6 +27,7 @@
 namespace marianatrench {
 
 class FieldMemoryLocation;
+class MemoryFactory;
 
 class MemoryLocation {
  protected:
@@ -33,7 +38,7 @@ class MemoryLocation {
   MemoryLocation(MemoryLocation&&) = delete;
   MemoryLocation& operator=(const MemoryLocation&) = delete;
   MemoryLocation& operator=(MemoryLocation&&) = delete;
-  virtual ~MemoryLocation() = default;
+  virtual ~MemoryLocation();
 
   /* Check wether the memory location has the given type. */
   template <typename T>
@@ -49,7 +54,12 @@ class MemoryLocation {
     return dynamic_cast<T*>(this);
   }
 
-  /* Return the memory location for the given field of this memory location. */
+  /**
+   * Return the memory location for the given field of this memory location.
+   *
+   * Fields of a root are created under the lock of the root, hence this is
+   * thread-safe once the factory is prepared with `prepare_concurrent_fields`.
+   */
   FieldMemoryLocation* make_field(const DexString* field);
 
   MemoryLocation* make_field(const Path& path);
@@ -81,9 +91,24 @@ class MemoryLocation {
       std::ostream& out,
       const MemoryLocation& memory_location);
 
+  friend class MemoryFactory;
+
+  /* Defined in the translation unit, since field locations are incomplete. */
+  struct FieldLocations;
+
+  /* Allocate the field storage of this root memory location, if needed. */
+  FieldLocations& field_locations();
+
  private:
-  std::unordered_map<const DexString*, std::unique_ptr<FieldMemoryLocation>>
-      fields_;
+  /* Fields of this memory location, sorted by field. */
+  std::vector<std::pair<const DexString*, FieldMemoryLocation*>> fields_;
+
+  /**
+   * Storage of the field memory locations of a root memory location, created
+   * on the first field. Fields are allocated in blocks and released together
+   * with their root, instead of one by one.
+   */
+  std::unique_ptr<FieldLocations> field_locations_;
 };
 
 class ParameterMemoryLocation : public MemoryLocation {
@@ -154,7 +179,11 @@ class InstructionMemoryLocation final : public MemoryLocation {
 /**
  * A memory factory to create unique memory location pointers.
  *
- * Note that this is NOT thread-safe.
+ * Instruction memory locations are allocated in blocks and released together
+ * with the factory, at the end of the analysis of the method.
+ *
+ * Note that this is NOT thread-safe, except for the creation of field memory
+ * locations after `prepare_concurrent_fields`.
  */
 class MemoryFactory final {
  public:
@@ -173,11 +202,17 @@ class MemoryFactory final {
    */
   InstructionMemoryLocation* make_location(const IRInstruction* instruction);
 
+  /**
+   * Create the locations of all instruction results of the given control flow
+   * graph and the field storage of all root memory locations. Afterwards, the
+   * factory can be used concurrently by analyses of the same method.
+   */
+  void prepare_concurrent_fields(const cfg::ControlFlowGraph& cfg);
+
  private:
   std::vector<std::unique_ptr<ParameterMemoryLocation>> parameters_;
-  std::unordered_map<
-      const IRInstruction*,
-      std::unique_ptr<InstructionMemoryLocation>>
+  std::deque<InstructionMemoryLocation> instruction_locations_;
+  std::unordered_map<const IRInstruction*, InstructionMemoryLocation*>
       instructions_;
 };
 
@@ -23,9 +23,11 @@ namespace marianatrench {
 
 Method::Method(
     const DexMethod* method,
-    ParameterTypeOverrides parameter_type_overrides)
+    ParameterTypeOverrides parameter_type_overrides,
+    MethodId id)
     : method_(method),
       parameter_type_overrides_(std::move(parameter_type_overrides)),
+      id_(id),
       signature_(::show(method)),
       show_cached_(::show(this)) {
   mt_assert(method != nullptr);
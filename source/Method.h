@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 #include <boost/container/flat_map.hpp>
 #include <boost/functional/hash.hpp>
 #include <json/json.h>
@@ -29,14 +32,25 @@ namespace marianatrench {
 using ParameterTypeOverrides =
     boost::container::flat_map<ParameterPosition, const DexType*>;
 
+/**
+ * Dense identifier of a method, assigned by the `Methods` factory in creation
+ * order. This allows to index methods in vectors and bitsets.
+ */
+using MethodId = std::uint32_t;
+
 /**
  * Represents a dex method with parameter type overrides.
  */
 class Method final {
+ public:
+  /* Identifier of methods that were not created by the `Methods` factory. */
+  static constexpr MethodId k_unknown_id = std::numeric_limits<MethodId>::max();
+
  public:
   explicit Method(
       const DexMethod* method,
-      ParameterTypeOverrides parameter_type_overrides);
+      ParameterTypeOverrides parameter_type_overrides,
+      MethodId id = k_unknown_id);
 
   INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Method)
 
@@ -50,6 +64,14 @@ class Method final {
     return parameter_type_overrides_;
   }
 
+  /**
+   * Return the dense identifier of this method. This is not part of the
+   * identity of the method, i.e it is ignored by `==` and `std::hash`.
+   */
+  MethodId id() const {
+    return id_;
+  }
+
   const IRCode* MT_NULLABLE get_code() const;
   DexType* get_class() const;
   DexProto* get_proto() const;
@@ -106,6 +128,7 @@ class Method final {
 
   const DexMethod* method_;
   ParameterTypeOverrides parameter_type_overrides_;
+  MethodId id_;
   std::string signature_;
   std::string show_cached_;
 };
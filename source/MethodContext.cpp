@@ -7,12 +7,17 @@
 
 #include <mariana-trench/MethodContext.h>
 
+#include <fmt/format.h>
+
 #include <Show.h>
 
+#include <mariana-trench/CacheStatistics.h>
+#include <mariana-trench/CallsiteModelCache.h>
 #include <mariana-trench/FeatureFactory.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Overrides.h>
 #include <mariana-trench/Positions.h>
+#include <mariana-trench/Timer.h>
 
 namespace marianatrench {
 
@@ -20,7 +25,9 @@ MethodContext::MethodContext(
     Context& context,
     const Registry& registry,
     const Model& previous_model,
-    Model& new_model)
+    Model& new_model,
+    std::shared_ptr<ForwardAliasResults> forward_alias_results,
+    Deadline deadline)
     : options(*context.options),
       artificial_methods(*context.artificial_methods),
       methods(*context.methods),
@@ -41,19 +48,65 @@ MethodContext::MethodContext(
       used_kinds(*context.used_kinds),
       access_path_factory(*context.access_path_factory),
       origin_factory(*context.origin_factory),
-      memory_factory(previous_model.method()),
+      forward_alias_results(std::move(forward_alias_results)),
+      memory_factory(this->forward_alias_results->memory_factory),
+      aliasing(this->forward_alias_results->aliasing),
       previous_model(previous_model),
       new_model(new_model),
       context_(context),
-      dump_(previous_model.method()->should_be_logged(options)) {}
+      dump_(previous_model.method()->should_be_logged(options)),
+      deadline_(deadline) {}
+
+void MethodContext::check_deadline() const {
+  if (deadline_.expired()) {
+    throw DeadlineExceededError(fmt::format(
+        "Analysis of `{}` exceeded its deadline", method()->show()));
+  }
+}
+
+void MethodContext::visit_block() const {
+  check_deadline();
+  if (profile != nullptr) {
+    profile->block_visits++;
+  }
+}
+
+namespace {
+
+/* Add the duration of its scope to the callee model time of the profile. */
+class CalleeModelTimer final {
+ public:
+  explicit CalleeModelTimer(MethodAnalysisProfile* MT_NULLABLE profile)
+      : profile_(profile) {
+    if (profile_ != nullptr) {
+      timer_.emplace();
+    }
+  }
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(CalleeModelTimer)
+
+  ~CalleeModelTimer() {
+    if (profile_ != nullptr) {
+      profile_->callee_model_time += timer_->duration_in_seconds();
+      profile_->callee_model_lookups++;
+    }
+  }
+
+ private:
+  MethodAnalysisProfile* MT_NULLABLE profile_;
+  std::optional<Timer> timer_;
+};
+
+} // namespace
 
 Model MethodContext::model_at_callsite(
     const CallTarget& call_target,
     const Position* position,
     const std::vector<const DexType * MT_NULLABLE>& source_register_types,
     const std::vector<std::optional<std::string>>& source_constant_arguments,
-    const CallClassIntervalContext& class_interval_context) const {
-  auto* caller = method();
+    const CallClassIntervalContext& class_interval_context,
+    const std::optional<std::vector<bool>>& tainted_arguments) const {
+  CalleeModelTimer callee_model_timer(profile);
 
   LOG_OR_DUMP(
       this,
@@ -71,20 +124,51 @@ Model MethodContext::model_at_callsite(
   }
 
   if (call_target.is_virtual()) {
-    auto cached = callsite_model_cache_.find(CacheKey{call_target, position});
+    auto cached = callsite_model_cache_.find(
+        CacheKey{call_target, position, tainted_arguments});
+    CacheStatistics::lookup(
+        CacheStatistics::Cache::MethodCallsiteModels,
+        /* hit */ cached != callsite_model_cache_.end());
     if (cached != callsite_model_cache_.end()) {
       return cached->second;
     }
   }
 
-  auto model = registry.get(call_target.resolved_base_callee())
-                   .at_callsite(
-                       caller,
-                       position,
-                       context_,
-                       source_register_types,
-                       source_constant_arguments,
-                       class_interval_context);
+  // Joined models of virtual calls are also cached across analyses of the
+  // caller, as long as the base callee and override models did not change.
+  auto* cache =
+      call_target.is_virtual() ? context_.callsite_model_cache.get() : nullptr;
+  std::vector<std::shared_ptr<const Model>> callee_models;
+  std::optional<CallsiteModelCache::Key> joined_key;
+  if (cache != nullptr) {
+    callee_models.push_back(
+        registry.get_snapshot(call_target.resolved_base_callee()));
+    for (const auto* override : call_target.overrides()) {
+      callee_models.push_back(registry.get_snapshot(override));
+    }
+    joined_key = CallsiteModelCache::Key{
+        method(),
+        call_target.resolved_base_callee(),
+        position,
+        source_register_types,
+        source_constant_arguments,
+        class_interval_context,
+        tainted_arguments};
+    if (auto cached = cache->get_joined(*joined_key, callee_models)) {
+      callsite_model_cache_.emplace(
+          CacheKey{call_target, position, tainted_arguments}, *cached);
+      CacheStatistics::insert(CacheStatistics::Cache::MethodCallsiteModels);
+      return std::move(*cached);
+    }
+  }
+
+  auto model = callee_model_at_callsite(
+      call_target.resolved_base_callee(),
+      position,
+      source_register_types,
+      source_constant_arguments,
+      class_interval_context,
+      tainted_arguments);
 
   if (!call_target.is_virtual()) {
     return model;
@@ -96,6 +180,9 @@ Model MethodContext::model_at_callsite(
         5,
         "Not joining at call-site for method `{}`",
         show(call_target.resolved_base_callee()));
+    if (joined_key) {
+      cache->set_joined(*joined_key, callee_models, model);
+    }
     return model;
   }
 
@@ -107,13 +194,13 @@ Model MethodContext::model_at_callsite(
       model);
 
   for (const auto* override : call_target.overrides()) {
-    auto override_model = registry.get(override).at_callsite(
-        caller,
+    auto override_model = callee_model_at_callsite(
+        override,
         position,
-        context_,
         source_register_types,
         source_constant_arguments,
-        class_interval_context);
+        class_interval_context,
+        tainted_arguments);
     LOG_OR_DUMP(
         this,
         5,
@@ -126,7 +213,56 @@ Model MethodContext::model_at_callsite(
   model.approximate(
       FeatureMayAlwaysSet{feature_factory.get_widen_broadening_feature()});
 
-  callsite_model_cache_.emplace(CacheKey{call_target, position}, model);
+  callsite_model_cache_.emplace(
+      CacheKey{call_target, position, tainted_arguments}, model);
+  CacheStatistics::insert(CacheStatistics::Cache::MethodCallsiteModels);
+  if (joined_key) {
+    cache->set_joined(*joined_key, callee_models, model);
+  }
+  return model;
+}
+
+Model MethodContext::callee_model_at_callsite(
+    const Method* callee,
+    const Position* position,
+    const std::vector<const DexType * MT_NULLABLE>& source_register_types,
+    const std::vector<std::optional<std::string>>& source_constant_arguments,
+    const CallClassIntervalContext& class_interval_context,
+    const std::optional<std::vector<bool>>& tainted_arguments) const {
+  auto callee_model = registry.get_snapshot(callee);
+  auto* cache = context_.callsite_model_cache.get();
+  if (cache == nullptr) {
+    return callee_model->at_callsite(
+        method(),
+        position,
+        context_,
+        source_register_types,
+        source_constant_arguments,
+        class_interval_context,
+        tainted_arguments);
+  }
+
+  auto key = CallsiteModelCache::Key{
+      method(),
+      callee,
+      position,
+      source_register_types,
+      source_constant_arguments,
+      class_interval_context,
+      tainted_arguments};
+  if (auto cached = cache->get(key, callee_model)) {
+    return std::move(*cached);
+  }
+
+  auto model = callee_model->at_callsite(
+      method(),
+      position,
+      context_,
+      source_register_types,
+      source_constant_arguments,
+      class_interval_context,
+      tainted_arguments);
+  cache->set(key, callee_model, model);
   return model;
 }
 
@@ -179,7 +315,7 @@ Taint MethodContext::field_sinks_at_callsite(
 }
 
 Taint MethodContext::literal_sources_at_callsite(
-    std::string_view literal,
+    const DexString* literal,
     const InstructionAliasResults& aliasing) const {
   const LiteralModel model{registry.match_literal(literal)};
   auto* call_position = positions.get(method(), aliasing.position());
@@ -7,16 +7,21 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include <mariana-trench/AliasAnalysisResults.h>
 #include <mariana-trench/CallGraph.h>
 #include <mariana-trench/Compiler.h>
 #include <mariana-trench/Context.h>
+#include <mariana-trench/Deadline.h>
 #include <mariana-trench/FulfilledPartialKindResults.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/MemoryLocation.h>
 #include <mariana-trench/Method.h>
+#include <mariana-trench/MethodProfiles.h>
 #include <mariana-trench/Model.h>
 #include <mariana-trench/Position.h>
 #include <mariana-trench/Registry.h>
@@ -32,7 +37,9 @@ class MethodContext final {
       Context& context,
       const Registry& registry,
       const Model& previous_model,
-      Model& new_model);
+      Model& new_model,
+      std::shared_ptr<ForwardAliasResults> forward_alias_results,
+      Deadline deadline);
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(MethodContext)
 
@@ -44,12 +51,25 @@ class MethodContext final {
     return dump_;
   }
 
+  /**
+   * Throw a `DeadlineExceededError` if the analysis of the method exceeded its
+   * deadline.
+   */
+  void check_deadline() const;
+
+  /**
+   * Called by the fixpoints before analyzing each block: check the deadline
+   * and count the block visit in the profile, if any.
+   */
+  void visit_block() const;
+
   Model model_at_callsite(
       const CallTarget& call_target,
       const Position* position,
       const std::vector<const DexType * MT_NULLABLE>& source_register_types,
       const std::vector<std::optional<std::string>>& source_constant_arguments,
-      const CallClassIntervalContext& class_interval_context) const;
+      const CallClassIntervalContext& class_interval_context,
+      const std::optional<std::vector<bool>>& tainted_arguments) const;
 
   Taint field_sources_at_callsite(
       const FieldTarget& field_target,
@@ -60,7 +80,7 @@ class MethodContext final {
       const InstructionAliasResults& aliasing) const;
 
   Taint literal_sources_at_callsite(
-      std::string_view literal,
+      const DexString* literal,
       const InstructionAliasResults& aliasing) const;
 
   const Options& options;
@@ -83,19 +103,34 @@ class MethodContext final {
   const UsedKinds& used_kinds;
   const AccessPathFactory& access_path_factory;
   const OriginFactory& origin_factory;
-  MemoryFactory memory_factory;
-  AliasAnalysisResults aliasing;
+  std::shared_ptr<ForwardAliasResults> forward_alias_results;
+  MemoryFactory& memory_factory;
+  AliasAnalysisResults& aliasing;
   FulfilledPartialKindResults fulfilled_partial_sinks;
   const Model& previous_model;
   Model& new_model;
+  // Profile of the analysis, only set with `--dump-method-profiles`.
+  MethodAnalysisProfile* MT_NULLABLE profile = nullptr;
+
+ private:
+  /* Return the model of the given callee at the call site. */
+  Model callee_model_at_callsite(
+      const Method* callee,
+      const Position* position,
+      const std::vector<const DexType * MT_NULLABLE>& source_register_types,
+      const std::vector<std::optional<std::string>>& source_constant_arguments,
+      const CallClassIntervalContext& class_interval_context,
+      const std::optional<std::vector<bool>>& tainted_arguments) const;
 
  private:
   struct CacheKey {
     CallTarget call_target;
     const Position* position;
+    std::optional<std::vector<bool>> tainted_arguments;
 
     bool operator==(const CacheKey& other) const {
-      return call_target == other.call_target && position == other.position;
+      return call_target == other.call_target && position == other.position &&
+          tainted_arguments == other.tainted_arguments;
     }
   };
 
@@ -104,6 +139,10 @@ class MethodContext final {
       std::size_t seed = 0;
       boost::hash_combine(seed, std::hash<CallTarget>()(key.call_target));
       boost::hash_combine(seed, key.position);
+      boost::hash_combine(
+          seed,
+          std::hash<std::optional<std::vector<bool>>>()(
+              key.tainted_arguments));
       return seed;
     }
   };
@@ -111,6 +150,7 @@ class MethodContext final {
  private:
   Context& context_;
   bool dump_;
+  Deadline deadline_;
   mutable std::unordered_map<CacheKey, Model, CacheKeyHash>
       callsite_model_cache_;
 };
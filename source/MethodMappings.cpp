@@ -5,10 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <sparta/WorkQueue.h>
-
+#include <mariana-trench/Log.h>
 #include <mariana-trench/MethodMappings.h>
+#include <mariana-trench/OperatingSystem.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/Timer.h>
+#include <mariana-trench/WorkerPool.h>
 #include <mariana-trench/model-generator/ModelGenerator.h>
 
 namespace marianatrench {
@@ -60,14 +62,13 @@ void create_class_to_override_method(
   }
 }
 
-void create_signature_to_method(
+void create_signature_hash_to_method(
     const Method* method,
-    ConcurrentMap<std::string, MethodHashedSet>& method_mapping) {
-  std::string signature = method->signature();
+    ConcurrentMap<std::size_t, MethodHashedSet>& method_mapping) {
   method_mapping.update(
-      signature,
+      std::hash<std::string_view>()(method->signature()),
       [method](
-          const std::string& /* parent_name */,
+          std::size_t /* signature_hash */,
           MethodHashedSet& methods,
           bool /* exists */) { methods.add(method); });
 }
@@ -75,7 +76,6 @@ void create_signature_to_method(
 void create_annotation_type_to_method(
     const Method* method,
     ConcurrentMap<std::string_view, MethodHashedSet>& method_mapping) {
-  std::string signature = method->signature();
   const DexAnnotationSet* annotations_set =
       method->dex_method()->get_anno_set();
   if (!annotations_set) {
@@ -95,24 +95,218 @@ void create_annotation_type_to_method(
   }
 }
 
+template <typename Key>
+void add_method(
+    const Key& key,
+    const Method* method,
+    ConcurrentMap<Key, MethodHashedSet>& method_mapping) {
+  method_mapping.update(
+      key,
+      [method](
+          const Key& /* key */, MethodHashedSet& methods, bool /* exists */) {
+        methods.add(method);
+      });
+}
+
+void create_return_type_to_method(
+    const Method* method,
+    ConcurrentMap<std::string_view, MethodHashedSet>& method_mapping) {
+  add_method(
+      method->get_proto()->get_rtype()->str(), method, method_mapping);
+}
+
+void create_parameter_type_to_method(
+    const Method* method,
+    ConcurrentMap<std::string_view, MethodHashedSet>& method_mapping) {
+  for (ParameterPosition position = 0;
+       position < method->number_of_parameters();
+       position++) {
+    const auto* type = method->parameter_type(position);
+    if (type != nullptr) {
+      add_method(type->str(), method, method_mapping);
+    }
+  }
+}
+
+void create_number_of_parameters_to_method(
+    const Method* method,
+    ConcurrentMap<ParameterPosition, MethodHashedSet>& method_mapping) {
+  add_method(method->number_of_parameters(), method, method_mapping);
+}
+
+void create_visibility_to_method(
+    const Method* method,
+    ConcurrentMap<DexAccessFlags, MethodHashedSet>& method_mapping) {
+  add_method(
+      static_cast<DexAccessFlags>(method->get_access() & VISIBILITY_MASK),
+      method,
+      method_mapping);
+}
+
+void create_is_static_to_method(
+    const Method* method,
+    ConcurrentMap<bool, MethodHashedSet>& method_mapping) {
+  add_method(method->is_static(), method, method_mapping);
+}
+
+void create_is_constructor_to_method(
+    const Method* method,
+    ConcurrentMap<bool, MethodHashedSet>& method_mapping) {
+  add_method(method->is_constructor(), method, method_mapping);
+}
+
 } // namespace
 
-void MethodMappings::create_mappings_for_method(const Method* method) {
-  create_name_to_method(method, name_to_methods_);
-  create_class_to_method(method, class_to_methods_);
-  create_class_to_override_method(method, class_to_override_methods_);
-  create_signature_to_method(method, signature_to_methods_);
-  create_annotation_type_to_method(method, annotation_type_to_methods_);
-}
-
-MethodMappings::MethodMappings(const Methods& methods) {
-  auto queue = sparta::work_queue<const Method*>(
-      [&](const Method* method) { create_mappings_for_method(method); });
-  for (const auto* method : methods) {
-    all_methods_.add(method);
-    queue.add_item(method);
+template <typename Key>
+const typename LazyMethodMapping<Key>::Map& LazyMethodMapping<Key>::get(
+    const Methods& methods) const {
+  if (built_.load(std::memory_order_acquire)) {
+    return map_;
+  }
+
+  std::unique_lock lock(mutex_);
+  if (!built_.load(std::memory_order_relaxed)) {
+    Timer timer;
+    auto queue = work_queue<const Method*>(
+        [this](const Method* method) { create_(method, map_); });
+    for (const auto* method : methods) {
+      queue.add_item(method);
+    }
+    queue.run_all();
+    built_.store(true, std::memory_order_release);
+    LOG(2,
+        "Built method mapping `{}` in {:.2f}s. Memory used, RSS: {:.2f}GB",
+        name_,
+        timer.duration_in_seconds(),
+        resident_set_size_in_gb());
+  }
+  return map_;
+}
+
+template <typename Key>
+void LazyMethodMapping<Key>::add(const Method* method) {
+  // Methods created before the index is built are found when building it.
+  std::shared_lock lock(mutex_);
+  if (built_.load(std::memory_order_relaxed)) {
+    create_(method, map_);
   }
-  queue.run_all();
+}
+
+MethodMappings::MethodMappings(const Methods& methods)
+    : methods_(methods),
+      name_to_methods_("name_to_methods", create_name_to_method),
+      class_to_methods_("class_to_methods", create_class_to_method),
+      class_to_override_methods_(
+          "class_to_override_methods",
+          create_class_to_override_method),
+      signature_hash_to_methods_(
+          "signature_to_methods",
+          create_signature_hash_to_method),
+      annotation_type_to_methods_(
+          "annotation_type_to_methods",
+          create_annotation_type_to_method),
+      return_type_to_methods_(
+          "return_type_to_methods",
+          create_return_type_to_method),
+      parameter_type_to_methods_(
+          "parameter_type_to_methods",
+          create_parameter_type_to_method),
+      number_of_parameters_to_methods_(
+          "number_of_parameters_to_methods",
+          create_number_of_parameters_to_method),
+      visibility_to_methods_(
+          "visibility_to_methods",
+          create_visibility_to_method),
+      is_static_to_methods_("is_static_to_methods", create_is_static_to_method),
+      is_constructor_to_methods_(
+          "is_constructor_to_methods",
+          create_is_constructor_to_method) {}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::name_to_methods() const {
+  return name_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::class_to_methods() const {
+  return class_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::class_to_override_methods() const {
+  return class_to_override_methods_.get(methods_);
+}
+
+MethodHashedSet MethodMappings::signature_to_methods(
+    std::string_view signature) const {
+  auto candidates = signature_hash_to_methods_.get(methods_).get(
+      std::hash<std::string_view>()(signature), MethodHashedSet::bottom());
+  // Filter out hash collisions.
+  auto methods = MethodHashedSet::bottom();
+  for (const auto* method : candidates.elements()) {
+    if (method->signature() == signature) {
+      methods.add(method);
+    }
+  }
+  return methods;
+}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::annotation_type_to_methods() const {
+  return annotation_type_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::return_type_to_methods() const {
+  return return_type_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<std::string_view, MethodHashedSet>&
+MethodMappings::parameter_type_to_methods() const {
+  return parameter_type_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<ParameterPosition, MethodHashedSet>&
+MethodMappings::number_of_parameters_to_methods() const {
+  return number_of_parameters_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<DexAccessFlags, MethodHashedSet>&
+MethodMappings::visibility_to_methods() const {
+  return visibility_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<bool, MethodHashedSet>&
+MethodMappings::is_static_to_methods() const {
+  return is_static_to_methods_.get(methods_);
+}
+
+const ConcurrentMap<bool, MethodHashedSet>&
+MethodMappings::is_constructor_to_methods() const {
+  return is_constructor_to_methods_.get(methods_);
+}
+
+const MethodHashedSet& MethodMappings::all_methods() const {
+  std::call_once(all_methods_once_, [this]() {
+    for (const auto* method : methods_) {
+      all_methods_.add(method);
+    }
+  });
+  return all_methods_;
+}
+
+void MethodMappings::create_mappings_for_method(const Method* method) {
+  name_to_methods_.add(method);
+  class_to_methods_.add(method);
+  class_to_override_methods_.add(method);
+  signature_hash_to_methods_.add(method);
+  annotation_type_to_methods_.add(method);
+  return_type_to_methods_.add(method);
+  parameter_type_to_methods_.add(method);
+  number_of_parameters_to_methods_.add(method);
+  visibility_to_methods_.add(method);
+  is_static_to_methods_.add(method);
+  is_constructor_to_methods_.add(method);
 }
 
 } // namespace marianatrench
@@ -7,8 +7,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+
 #include <sparta/HashedSetAbstractDomain.h>
 
+#include <mariana-trench/Access.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Methods.h>
 
@@ -16,6 +22,38 @@ namespace marianatrench {
 
 using MethodHashedSet = sparta::HashedSetAbstractDomain<const Method*>;
 
+/**
+ * Index from a method property to the methods with that property.
+ *
+ * The index is built in parallel on first use, from all methods known at that
+ * point. Methods created afterwards must be added explicitly.
+ */
+template <typename Key>
+class LazyMethodMapping final {
+ public:
+  using Map = ConcurrentMap<Key, MethodHashedSet>;
+  using Create = void (*)(const Method*, Map&);
+
+ public:
+  explicit LazyMethodMapping(std::string_view name, Create create)
+      : name_(name), create_(create) {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(LazyMethodMapping)
+
+  /* This is thread-safe. Methods must not be created while building. */
+  const Map& get(const Methods& methods) const;
+
+  /* Add the given method if the index is already built. This is thread-safe. */
+  void add(const Method* method);
+
+ private:
+  std::string_view name_;
+  Create create_;
+  mutable std::shared_mutex mutex_;
+  mutable std::atomic<bool> built_ = false;
+  mutable Map map_;
+};
+
 class MethodMappings {
  public:
   explicit MethodMappings(const Methods& methods);
@@ -24,43 +62,72 @@ class MethodMappings {
 
  public:
   const ConcurrentMap<std::string_view, MethodHashedSet>& name_to_methods()
-      const {
-    return name_to_methods_;
-  }
+      const;
 
   const ConcurrentMap<std::string_view, MethodHashedSet>& class_to_methods()
-      const {
-    return class_to_methods_;
-  }
+      const;
+
+  const ConcurrentMap<std::string_view, MethodHashedSet>&
+  class_to_override_methods() const;
+
+  /* Methods with exactly the given signature. */
+  MethodHashedSet signature_to_methods(std::string_view signature) const;
 
   const ConcurrentMap<std::string_view, MethodHashedSet>&
-  class_to_override_methods() const {
-    return class_to_override_methods_;
-  }
+  annotation_type_to_methods() const;
 
-  const ConcurrentMap<std::string, MethodHashedSet>& signature_to_methods()
-      const {
-    return signature_to_methods_;
-  }
+  /* Maps a return type to the methods returning exactly that type. */
+  const ConcurrentMap<std::string_view, MethodHashedSet>&
+  return_type_to_methods() const;
 
+  /**
+   * Maps a type to the methods having a parameter of exactly that type, at
+   * any position (including `this`).
+   */
   const ConcurrentMap<std::string_view, MethodHashedSet>&
-  annotation_type_to_methods() const {
-    return annotation_type_to_methods_;
-  }
+  parameter_type_to_methods() const;
+
+  const ConcurrentMap<ParameterPosition, MethodHashedSet>&
+  number_of_parameters_to_methods() const;
+
+  /**
+   * Maps the visibility bits (`ACC_PUBLIC`, `ACC_PRIVATE` or `ACC_PROTECTED`)
+   * of a method to the methods with those bits. Package-private methods are
+   * found under the empty flags.
+   */
+  const ConcurrentMap<DexAccessFlags, MethodHashedSet>& visibility_to_methods()
+      const;
+
+  const ConcurrentMap<bool, MethodHashedSet>& is_static_to_methods() const;
+
+  const ConcurrentMap<bool, MethodHashedSet>& is_constructor_to_methods()
+      const;
 
-  const MethodHashedSet& all_methods() const {
-    return all_methods_;
-  }
+  /* All methods known when this is first called. */
+  const MethodHashedSet& all_methods() const;
 
+  /* Add a method created after construction. This is thread-safe. */
   void create_mappings_for_method(const Method* method);
 
  private:
-  ConcurrentMap<std::string_view, MethodHashedSet> name_to_methods_;
-  ConcurrentMap<std::string_view, MethodHashedSet> class_to_methods_;
-  ConcurrentMap<std::string_view, MethodHashedSet> class_to_override_methods_;
-  ConcurrentMap<std::string, MethodHashedSet> signature_to_methods_;
-  ConcurrentMap<std::string_view, MethodHashedSet> annotation_type_to_methods_;
-  MethodHashedSet all_methods_;
+  const Methods& methods_;
+
+  // Keys are views on interned `DexString`s, which outlive the mappings.
+  LazyMethodMapping<std::string_view> name_to_methods_;
+  LazyMethodMapping<std::string_view> class_to_methods_;
+  LazyMethodMapping<std::string_view> class_to_override_methods_;
+  // Signatures are not interned, so this is keyed by their hash.
+  LazyMethodMapping<std::size_t> signature_hash_to_methods_;
+  LazyMethodMapping<std::string_view> annotation_type_to_methods_;
+  LazyMethodMapping<std::string_view> return_type_to_methods_;
+  LazyMethodMapping<std::string_view> parameter_type_to_methods_;
+  LazyMethodMapping<ParameterPosition> number_of_parameters_to_methods_;
+  LazyMethodMapping<DexAccessFlags> visibility_to_methods_;
+  LazyMethodMapping<bool> is_static_to_methods_;
+  LazyMethodMapping<bool> is_constructor_to_methods_;
+
+  mutable std::once_flag all_methods_once_;
+  mutable MethodHashedSet all_methods_;
 };
 
 } // namespace marianatrench
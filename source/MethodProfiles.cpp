@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <fmt/format.h>
+
+#include <ControlFlow.h>
+#include <IRInstruction.h>
+#include <IROpcode.h>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/MethodProfiles.h>
+#include <mariana-trench/ModelSizes.h>
+
+namespace marianatrench {
+
+void MethodAnalysisProfile::join_with(const MethodAnalysisProfile& other) {
+  analyses += other.analyses;
+  time += other.time;
+  forward_alias_time += other.forward_alias_time;
+  forward_taint_time += other.forward_taint_time;
+  backward_taint_time += other.backward_taint_time;
+  forward_alias_block_visits += other.forward_alias_block_visits;
+  forward_taint_block_visits += other.forward_taint_block_visits;
+  backward_taint_block_visits += other.backward_taint_block_visits;
+  callee_model_time += other.callee_model_time;
+  callee_model_lookups += other.callee_model_lookups;
+  instructions = other.instructions;
+  call_sites = other.call_sites;
+  model_size = other.model_size;
+}
+
+Json::Value MethodAnalysisProfile::to_json() const {
+  auto value = Json::Value(Json::objectValue);
+  value["analyses"] = Json::Value(static_cast<Json::UInt64>(analyses));
+  value["time"] = Json::Value(time);
+  value["forward_alias_time"] = Json::Value(forward_alias_time);
+  value["forward_taint_time"] = Json::Value(forward_taint_time);
+  value["backward_taint_time"] = Json::Value(backward_taint_time);
+  value["forward_alias_block_visits"] =
+      Json::Value(static_cast<Json::UInt64>(forward_alias_block_visits));
+  value["forward_taint_block_visits"] =
+      Json::Value(static_cast<Json::UInt64>(forward_taint_block_visits));
+  value["backward_taint_block_visits"] =
+      Json::Value(static_cast<Json::UInt64>(backward_taint_block_visits));
+  value["callee_model_time"] = Json::Value(callee_model_time);
+  value["callee_model_lookups"] =
+      Json::Value(static_cast<Json::UInt64>(callee_model_lookups));
+  value["instructions"] = Json::Value(static_cast<Json::UInt64>(instructions));
+  value["call_sites"] = Json::Value(static_cast<Json::UInt64>(call_sites));
+  value["model_size"] = Json::Value(static_cast<Json::UInt64>(model_size));
+  return value;
+}
+
+MethodAnalysisProfile MethodAnalysisProfile::from_json(
+    const Json::Value& value) {
+  JsonValidation::validate_object(value);
+  if (!value["time"].isNumeric()) {
+    throw JsonValidationError(value, /* field */ "time", "number");
+  }
+  MethodAnalysisProfile profile;
+  profile.analyses = JsonValidation::integer(value, "analyses");
+  profile.time = value["time"].asDouble();
+  profile.instructions = JsonValidation::integer(value, "instructions");
+  return profile;
+}
+
+void MethodProfiles::measure_code(
+    const IRCode& code,
+    MethodAnalysisProfile& profile) {
+  profile.instructions = 0;
+  profile.call_sites = 0;
+  for (const auto* block : code.cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      profile.instructions++;
+      if (opcode::is_an_invoke(entry.insn->opcode())) {
+        profile.call_sites++;
+      }
+    }
+  }
+}
+
+std::size_t MethodProfiles::model_size(const Model& model) {
+  return ModelSize::number_of_frames(model) + model.issues().size();
+}
+
+void MethodProfiles::add(
+    const Method* method,
+    const MethodAnalysisProfile& profile) {
+  profiles_.update(
+      method,
+      [&profile](
+          const Method* /* method */,
+          MethodAnalysisProfile& existing,
+          bool /* exists */) { existing.join_with(profile); });
+}
+
+void MethodProfiles::dump(
+    const std::filesystem::path& output_directory,
+    std::size_t batch_size) const {
+  std::vector<std::pair<const Method*, const MethodAnalysisProfile*>> profiles;
+  profiles.reserve(profiles_.size());
+  for (const auto& [method, profile] : profiles_) {
+    profiles.emplace_back(method, &profile);
+  }
+  // Most expensive methods first, then by signature for a deterministic output.
+  std::sort(
+      profiles.begin(),
+      profiles.end(),
+      [](const auto& left, const auto& right) {
+        if (left.second->time != right.second->time) {
+          return left.second->time > right.second->time;
+        }
+        return left.first->signature() < right.first->signature();
+      });
+
+  JsonValidation::write_sharded_json_files(
+      output_directory,
+      batch_size,
+      profiles.size(),
+      "method_profile@",
+      [&profiles](std::size_t index) {
+        const auto& [method, profile] = profiles[index];
+        auto value = profile->to_json();
+        value["method"] = Json::Value(method->show());
+        return value;
+      });
+}
+
+std::unordered_map<const Method*, MethodAnalysisProfile> MethodProfiles::read(
+    const std::filesystem::path& output_directory,
+    const Methods& methods) {
+  std::unordered_map<const Method*, MethodAnalysisProfile> profiles;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(output_directory)) {
+    if (!boost::starts_with(
+            entry.path().filename().string(), "method_profile@")) {
+      continue;
+    }
+    std::ifstream file(entry.path(), std::ios_base::binary);
+    if (!file.is_open()) {
+      throw std::invalid_argument(fmt::format(
+          "Unable to read method profiles `{}`.", entry.path().string()));
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.empty() || boost::starts_with(line, "//")) {
+        continue; // Generated header.
+      }
+      auto value = JsonValidation::parse_json(line);
+      auto name = JsonValidation::string(value, "method");
+      if (boost::ends_with(name, "]")) {
+        continue; // Parameter type overrides, see `Method::show`.
+      }
+      const auto* method = methods.get(name);
+      if (method == nullptr) {
+        continue;
+      }
+      profiles[method].join_with(MethodAnalysisProfile::from_json(value));
+    }
+  }
+  return profiles;
+}
+
+} // namespace marianatrench
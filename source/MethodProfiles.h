@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <unordered_map>
+
+#include <json/json.h>
+
+#include <ConcurrentContainers.h>
+#include <IRCode.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Model.h>
+
+namespace marianatrench {
+
+/* Profile of the analyses of a single method. */
+struct MethodAnalysisProfile {
+  std::size_t analyses = 0;
+  double time = 0.0;
+  double forward_alias_time = 0.0;
+  double forward_taint_time = 0.0;
+  double backward_taint_time = 0.0;
+  std::size_t forward_alias_block_visits = 0;
+  std::size_t forward_taint_block_visits = 0;
+  std::size_t backward_taint_block_visits = 0;
+  /* Time spent getting callee models at call sites. */
+  double callee_model_time = 0.0;
+  std::size_t callee_model_lookups = 0;
+  std::size_t instructions = 0;
+  std::size_t call_sites = 0;
+  /* Number of frames and issues of the last computed model. */
+  std::size_t model_size = 0;
+
+  /* Incremented by the fixpoints before analyzing a block. */
+  std::size_t block_visits = 0;
+
+  /* Add the profile of another analysis of the same method. */
+  void join_with(const MethodAnalysisProfile& other);
+
+  Json::Value to_json() const;
+
+  /* Read the totals (analyses, time, instructions) of a profile. */
+  static MethodAnalysisProfile from_json(const Json::Value& value);
+};
+
+/**
+ * Profiles of all method analyses, enabled with `--dump-method-profiles`.
+ *
+ * Profiles are accumulated over all the analyses of a method and written
+ * next to the models, from the most to the least expensive method.
+ */
+class MethodProfiles final {
+ public:
+  MethodProfiles() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(MethodProfiles)
+
+  /* Set the code measures (instructions, call sites) of the profile. */
+  static void measure_code(const IRCode& code, MethodAnalysisProfile& profile);
+
+  static std::size_t model_size(const Model& model);
+
+  /* Record an analysis of the given method. This is thread-safe. */
+  void add(const Method* method, const MethodAnalysisProfile& profile);
+
+  /**
+   * Write the profiles in shards of `batch_size` json lines named
+   * `method_profile@XXXXX-of-YYYYY.json`.
+   */
+  void dump(
+      const std::filesystem::path& output_directory,
+      std::size_t batch_size) const;
+
+  /**
+   * Read the profiles dumped in the given output directory of a previous run,
+   * for `--previous-method-profiles-directory`. Profiles of methods that no
+   * longer exist or that have parameter type overrides are ignored.
+   */
+  static std::unordered_map<const Method*, MethodAnalysisProfile> read(
+      const std::filesystem::path& output_directory,
+      const Methods& methods);
+
+ private:
+  ConcurrentMap<const Method*, MethodAnalysisProfile> profiles_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#include <fmt/format.h>
+
+#include <mariana-trench/Log.h>
+#include <mariana-trench/MethodSampler.h>
+
+// The initial-exec model avoids a lazy allocation of the variable when it is
+// first read by the signal handler on a thread.
+extern "C" {
+thread_local const char* mariana_trench_analyzed_method
+    __attribute__((tls_model("initial-exec"))) = nullptr;
+}
+
+namespace marianatrench {
+
+namespace {
+
+std::atomic<MethodSampler*> active_sampler = nullptr;
+std::atomic<int> running_handlers = 0;
+struct sigaction previous_action;
+
+// Frames of the signal handler and of the signal trampoline.
+constexpr int k_skipped_frames = 2;
+
+constexpr auto k_collect_interval = std::chrono::milliseconds(10);
+
+std::string symbolize(void* address) {
+  Dl_info info;
+  if (dladdr(address, &info) == 0) {
+    return fmt::format("{}", address);
+  }
+  if (info.dli_sname == nullptr) {
+    // Merge unknown functions of a library, as native profilers do.
+    return fmt::format(
+        "[{}]", std::filesystem::path(info.dli_fname).filename().native());
+  }
+  int status = 0;
+  std::unique_ptr<char, decltype(&std::free)> demangled(
+      abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status),
+      &std::free);
+  return status == 0 ? std::string(demangled.get())
+                     : std::string(info.dli_sname);
+}
+
+/* Semicolons separate frames in the folded stacks format. */
+std::string escape_frame(std::string frame) {
+  std::replace(frame.begin(), frame.end(), ';', ',');
+  return frame;
+}
+
+} // namespace
+
+MethodSampler::MethodSampler(int frequency) : buffer_(kBufferSize) {
+  if (frequency <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Sampling frequency must be positive, got {}.", frequency));
+  }
+
+  // The first call to `backtrace` loads the unwinder, which allocates memory.
+  // This must not happen within the signal handler.
+  std::array<void*, 1> frames;
+  backtrace(frames.data(), frames.size());
+
+  MethodSampler* expected = nullptr;
+  if (!active_sampler.compare_exchange_strong(expected, this)) {
+    throw std::logic_error("Only one method sampler may exist at a time.");
+  }
+
+  struct sigaction action = {};
+  action.sa_handler = &MethodSampler::handle_signal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+    active_sampler = nullptr;
+    throw std::runtime_error("Unable to install the `SIGPROF` handler.");
+  }
+
+  thread_ = std::thread([this]() { run(); });
+
+  auto interval = std::chrono::microseconds(1000000 / frequency);
+  struct itimerval timer = {};
+  timer.it_interval.tv_sec = interval.count() / 1000000;
+  timer.it_interval.tv_usec = std::max<long>(interval.count() % 1000000, 1);
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+MethodSampler::~MethodSampler() {
+  struct itimerval timer = {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+
+  // Wait for pending signal handlers, which may still write in the buffer.
+  active_sampler = nullptr;
+  while (running_handlers.load() > 0) {
+    std::this_thread::yield();
+  }
+  sigaction(SIGPROF, &previous_action, nullptr);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_condition_.notify_all();
+  thread_.join();
+  collect();
+}
+
+MethodSampler::MethodScope::MethodScope(
+    MethodSampler* MT_NULLABLE sampler,
+    const Method* method)
+    : sampler_(sampler), previous_method_(nullptr) {
+  if (sampler_ == nullptr) {
+    return;
+  }
+  previous_method_ = mariana_trench_analyzed_method;
+  mariana_trench_analyzed_method = method->signature().c_str();
+}
+
+MethodSampler::MethodScope::~MethodScope() {
+  if (sampler_ == nullptr) {
+    return;
+  }
+  mariana_trench_analyzed_method = previous_method_;
+}
+
+std::size_t MethodSampler::samples() const {
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  return number_of_samples_;
+}
+
+std::size_t MethodSampler::dropped_samples() const {
+  return dropped_samples_.load();
+}
+
+void MethodSampler::handle_signal(int /* signal */) {
+  // Only async-signal-safe operations are allowed here.
+  int saved_errno = errno;
+  running_handlers++;
+
+  const char* method = mariana_trench_analyzed_method;
+  auto* sampler = active_sampler.load();
+  if (method != nullptr && sampler != nullptr) {
+    auto index = sampler->next_sample_++ % kBufferSize;
+    auto& sample = sampler->buffer_[index];
+    int empty = 0;
+    if (sample.state.compare_exchange_strong(empty, 1)) {
+      sample.method = method;
+      sample.depth = backtrace(sample.frames.data(), kMaximumDepth);
+      sample.state.store(2, std::memory_order_release);
+    } else {
+      sampler->dropped_samples_++;
+    }
+  }
+
+  running_handlers--;
+  errno = saved_errno;
+}
+
+void MethodSampler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_condition_.wait_for(
+      lock, k_collect_interval, [this]() { return stop_; })) {
+    lock.unlock();
+    collect();
+    lock.lock();
+  }
+}
+
+void MethodSampler::collect() {
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  for (auto& sample : buffer_) {
+    if (sample.state.load(std::memory_order_acquire) != 2) {
+      continue;
+    }
+    auto begin = sample.frames.begin() +
+        std::min(k_skipped_frames, std::max(sample.depth, 0));
+    auto end = sample.frames.begin() + std::max(sample.depth, 0);
+    samples_[{sample.method, std::vector<void*>(begin, end)}]++;
+    number_of_samples_++;
+    sample.state.store(0, std::memory_order_release);
+  }
+}
+
+void MethodSampler::dump(const std::filesystem::path& path) {
+  collect();
+
+  std::unordered_map<void*, std::string> symbols;
+  auto symbol = [&symbols](void* address) -> const std::string& {
+    auto found = symbols.find(address);
+    if (found == symbols.end()) {
+      found =
+          symbols.emplace(address, escape_frame(symbolize(address))).first;
+    }
+    return found->second;
+  };
+
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  // Stacks differing only by return addresses within the same functions
+  // are merged once symbolized.
+  std::map<std::string, std::size_t> folded_stacks;
+  for (const auto& [key, count] : samples_) {
+    const auto& [method, frames] = key;
+    auto stack = escape_frame(method);
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+      stack.append(";");
+      stack.append(symbol(*frame));
+    }
+    folded_stacks[stack] += count;
+  }
+
+  std::ofstream output(path, std::ios::out | std::ios::trunc);
+  if (!output) {
+    WARNING(1, "Unable to write method samples to `{}`.", path.native());
+    return;
+  }
+  for (const auto& [stack, count] : folded_stacks) {
+    output << stack << " " << count << "\n";
+  }
+  LOG(1,
+      "Wrote {} method samples to `{}` ({} dropped).",
+      number_of_samples_,
+      path.native(),
+      dropped_samples_.load());
+}
+
+} // namespace marianatrench
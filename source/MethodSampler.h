@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/Method.h>
+
+/**
+ * Signature of the method analyzed by the current thread, or null. This is
+ * only set while a `MethodSampler` exists and is meant to be read by native
+ * profilers (e.g perf or BPF) to attribute samples to analyzed methods.
+ */
+extern "C" thread_local const char* mariana_trench_analyzed_method;
+
+namespace marianatrench {
+
+/**
+ * Sampling profiler of the analysis, enabled with `--sample-analyzed-methods`.
+ *
+ * Worker threads are tagged with the method they are analyzing. Native stacks
+ * of the threads are sampled on CPU time with `SIGPROF` and aggregated by
+ * analyzed method, so that flame graphs can be split by analyzed method
+ * rather than only by analyzer function. Samples are written in the folded
+ * stacks format, with the analyzed method as the root frame.
+ *
+ * At most one sampler may exist at a time, since it owns the `SIGPROF`
+ * handler of the process.
+ */
+class MethodSampler final {
+ public:
+  explicit MethodSampler(int frequency);
+
+  MethodSampler(const MethodSampler&) = delete;
+  MethodSampler(MethodSampler&&) = delete;
+  MethodSampler& operator=(const MethodSampler&) = delete;
+  MethodSampler& operator=(MethodSampler&&) = delete;
+  /* Stops sampling and restores the previous `SIGPROF` handler. */
+  ~MethodSampler();
+
+  /* Tag the current thread with the analyzed method. */
+  class MethodScope final {
+   public:
+    MethodScope(MethodSampler* MT_NULLABLE sampler, const Method* method);
+    MethodScope(const MethodScope&) = delete;
+    MethodScope(MethodScope&&) = delete;
+    MethodScope& operator=(const MethodScope&) = delete;
+    MethodScope& operator=(MethodScope&&) = delete;
+    ~MethodScope();
+
+   private:
+    MethodSampler* MT_NULLABLE sampler_;
+    const char* MT_NULLABLE previous_method_;
+  };
+
+  /* Number of samples taken while analyzing a method. */
+  std::size_t samples() const;
+
+  /* Number of samples dropped because the sample buffer was full. */
+  std::size_t dropped_samples() const;
+
+  /**
+   * Write the samples in the folded stacks format, one line per distinct
+   * stack: `method;outermost frame;...;innermost frame count`.
+   */
+  void dump(const std::filesystem::path& path);
+
+  /* Maximum number of native frames recorded per sample. */
+  constexpr static std::size_t kMaximumDepth = 64;
+
+ private:
+  /* A sample written by the signal handler, read by the collector thread. */
+  struct Sample {
+    // 0: empty, 1: being written, 2: ready.
+    std::atomic<int> state = 0;
+    const char* method = nullptr;
+    int depth = 0;
+    std::array<void*, kMaximumDepth> frames;
+  };
+
+  constexpr static std::size_t kBufferSize = 4096;
+
+  static void handle_signal(int signal);
+
+  void run();
+  void collect();
+
+ private:
+  std::vector<Sample> buffer_;
+  std::atomic<std::size_t> next_sample_ = 0;
+  std::atomic<std::size_t> dropped_samples_ = 0;
+
+  // Collected samples: number of samples by method and stack, innermost frame
+  // first.
+  mutable std::mutex samples_mutex_;
+  std::map<std::pair<const char*, std::vector<void*>>, std::size_t> samples_;
+  std::size_t number_of_samples_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+} // namespace marianatrench
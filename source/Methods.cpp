@@ -22,7 +22,8 @@ Methods::Methods(const DexStoresVector& stores) {
   // Create all methods with no type overrides.
   for (auto& scope : DexStoreClassesIterator(stores)) {
     walk::parallel::methods(scope, [this](DexMethod* method) {
-      set_.insert(Method(method, /* parameter_type_overrides */ {}));
+      set_.insert(
+          Method(method, /* parameter_type_overrides */ {}, next_id_++));
     });
   }
 }
@@ -31,7 +32,51 @@ const Method* Methods::create(
     const DexMethod* method,
     ParameterTypeOverrides parameter_type_overrides) {
   mt_assert(method != nullptr);
-  return set_.insert(Method(method, parameter_type_overrides)).first;
+  // Look up the method first, to avoid consuming an identifier for methods
+  // that already exist.
+  if (const auto* existing =
+          set_.get(Method(method, parameter_type_overrides))) {
+    return existing;
+  }
+  bool has_overrides = !parameter_type_overrides.empty();
+  auto [pointer, inserted] = set_.insert(
+      Method(method, std::move(parameter_type_overrides), next_id_++));
+  if (inserted && has_overrides) {
+    variants_++;
+  }
+  return pointer;
+}
+
+const Method* MT_NULLABLE Methods::create_bounded(
+    const DexMethod* method,
+    ParameterTypeOverrides parameter_type_overrides,
+    std::size_t maximum_variants) {
+  mt_assert(method != nullptr);
+  mt_assert(!parameter_type_overrides.empty());
+  if (const auto* existing =
+          set_.get(Method(method, parameter_type_overrides))) {
+    return existing;
+  }
+
+  // Concurrent creations of the same variant may both be counted, which only
+  // makes the bound slightly tighter.
+  bool allowed = false;
+  variants_per_method_.update(
+      method,
+      [maximum_variants, &allowed](
+          const DexMethod* /* method */,
+          std::size_t& variants,
+          bool /* exists */) {
+        if (variants < maximum_variants) {
+          variants++;
+          allowed = true;
+        }
+      });
+  if (!allowed) {
+    bounded_variants_++;
+    return nullptr;
+  }
+  return create(method, std::move(parameter_type_overrides));
 }
 
 const Method* Methods::get(
@@ -67,4 +112,16 @@ std::size_t Methods::size() const {
   return set_.size();
 }
 
+std::size_t Methods::number_of_ids() const {
+  return next_id_.load();
+}
+
+std::size_t Methods::number_of_variants() const {
+  return variants_.load();
+}
+
+std::size_t Methods::number_of_bounded_variants() const {
+  return bounded_variants_.load();
+}
+
 } // namespace marianatrench
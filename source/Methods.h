@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <ConcurrentContainers.h>
@@ -42,11 +44,25 @@ class Methods final {
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Methods)
 
-  /* Get or create a method with the given parameter type overrides */
+  /**
+   * Get or create a method with the given parameter type overrides.
+   *
+   * New methods are assigned the next available `MethodId`.
+   */
   const Method* create(
       const DexMethod* method,
       ParameterTypeOverrides parameter_type_overrides = {});
 
+  /**
+   * Get or create a method with the given non-empty parameter type overrides,
+   * unless `maximum_variants` methods with overrides were already created for
+   * the given dex method. Returns `nullptr` in that case.
+   */
+  const Method* MT_NULLABLE create_bounded(
+      const DexMethod* method,
+      ParameterTypeOverrides parameter_type_overrides,
+      std::size_t maximum_variants);
+
   /**
    * Get the method with the given parameter type overrides.
    *
@@ -72,8 +88,27 @@ class Methods final {
 
   std::size_t size() const;
 
+  /**
+   * Return an upper bound of the identifiers of all methods created so far,
+   * which can be used to size containers indexed by `MethodId`.
+   *
+   * Identifiers are almost dense: an identifier is only skipped when two
+   * threads concurrently create the same method.
+   */
+  std::size_t number_of_ids() const;
+
+  /* Number of methods created with non-empty parameter type overrides. */
+  std::size_t number_of_variants() const;
+
+  /* Number of calls to `create_bounded` that returned `nullptr`. */
+  std::size_t number_of_bounded_variants() const;
+
  private:
   Set set_;
+  std::atomic<MethodId> next_id_ = 0;
+  ConcurrentMap<const DexMethod*, std::size_t> variants_per_method_;
+  std::atomic<std::size_t> variants_ = 0;
+  std::atomic<std::size_t> bounded_variants_ = 0;
 };
 
 } // namespace marianatrench
@@ -5,12 +5,15 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+
 #include <fmt/format.h>
 
 #include <Show.h>
 #include <TypeUtil.h>
 
 #include <mariana-trench/Assert.h>
+#include <mariana-trench/CallSitePropagation.h>
 #include <mariana-trench/ClassHierarchies.h>
 #include <mariana-trench/ClassProperties.h>
 #include <mariana-trench/Compiler.h>
@@ -142,6 +145,38 @@ std::optional<Model::FreezeKind> string_to_freeze_kind(
   }
 }
 
+bool Model::Cold::operator==(const Cold& other) const {
+  return port_sanitizers == other.port_sanitizers &&
+      attach_to_sources == other.attach_to_sources &&
+      attach_to_sinks == other.attach_to_sinks &&
+      attach_to_propagations == other.attach_to_propagations &&
+      add_features_to_arguments == other.add_features_to_arguments &&
+      model_generators == other.model_generators && issues == other.issues;
+}
+
+bool Model::Cold::empty() const {
+  return port_sanitizers.is_bottom() && attach_to_sources.is_bottom() &&
+      attach_to_sinks.is_bottom() && attach_to_propagations.is_bottom() &&
+      add_features_to_arguments.is_bottom() && model_generators.is_bottom() &&
+      issues.is_bottom();
+}
+
+const Model::Cold& Model::cold() const {
+  static const Cold empty;
+  return cold_ == nullptr ? empty : *cold_;
+}
+
+Model::Cold& Model::mutable_cold() {
+  if (cold_ == nullptr) {
+    cold_ = std::make_shared<Cold>();
+  } else if (cold_.use_count() > 1) {
+    // A model is never copied while it is modified, hence the use count
+    // cannot increase concurrently.
+    cold_ = std::make_shared<Cold>(*cold_);
+  }
+  return *cold_;
+}
+
 Model::Model() : method_(nullptr) {}
 
 Model::Model(
@@ -241,14 +276,9 @@ bool Model::operator==(const Model& other) const {
       call_effect_sinks_ == other.call_effect_sinks_ &&
       sinks_ == other.sinks_ && propagations_ == other.propagations_ &&
       global_sanitizers_ == other.global_sanitizers_ &&
-      port_sanitizers_ == other.port_sanitizers_ &&
-      attach_to_sources_ == other.attach_to_sources_ &&
-      attach_to_sinks_ == other.attach_to_sinks_ &&
-      attach_to_propagations_ == other.attach_to_propagations_ &&
-      add_features_to_arguments_ == other.add_features_to_arguments_ &&
       inline_as_getter_ == other.inline_as_getter_ &&
       inline_as_setter_ == other.inline_as_setter_ &&
-      model_generators_ == other.model_generators_ && issues_ == other.issues_;
+      (cold_ == other.cold_ || cold() == other.cold());
 }
 
 bool Model::operator!=(const Model& other) const {
@@ -287,30 +317,30 @@ Model Model::instantiate(const Method* method, Context& context) const {
     model.add_global_sanitizer(sanitizer);
   }
 
-  for (const auto& [root, sanitizers] : port_sanitizers_) {
+  for (const auto& [root, sanitizers] : cold().port_sanitizers) {
     model.add_port_sanitizers(sanitizers, root);
   }
 
-  for (const auto& [root, features] : attach_to_sources_) {
+  for (const auto& [root, features] : cold().attach_to_sources) {
     model.add_attach_to_sources(root, features);
   }
 
-  for (const auto& [root, features] : attach_to_sinks_) {
+  for (const auto& [root, features] : cold().attach_to_sinks) {
     model.add_attach_to_sinks(root, features);
   }
 
-  for (const auto& [root, features] : attach_to_propagations_) {
+  for (const auto& [root, features] : cold().attach_to_propagations) {
     model.add_attach_to_propagations(root, features);
   }
 
-  for (const auto& [root, features] : add_features_to_arguments_) {
+  for (const auto& [root, features] : cold().add_features_to_arguments) {
     model.add_add_features_to_arguments(root, features);
   }
 
   model.set_inline_as_getter(inline_as_getter_);
   model.set_inline_as_setter(inline_as_setter_);
 
-  for (const auto* model_generator : model_generators_) {
+  for (const auto* model_generator : cold().model_generators) {
     model.add_model_generator(model_generator);
   }
 
@@ -323,7 +353,8 @@ Model Model::at_callsite(
     Context& context,
     const std::vector<const DexType * MT_NULLABLE>& source_register_types,
     const std::vector<std::optional<std::string>>& source_constant_arguments,
-    const CallClassIntervalContext& class_interval_context) const {
+    const CallClassIntervalContext& class_interval_context,
+    const std::optional<std::vector<bool>>& tainted_arguments) const {
   const auto* callee = method_;
   // at_callsite() does not make sense if there is no callee
   mt_assert(callee != nullptr);
@@ -364,121 +395,91 @@ Model Model::at_callsite(
   auto caller_class_interval =
       context.class_intervals->get_interval(caller->get_class());
 
-  generations_.visit(
-      [&model,
-       callee,
-       call_position,
-       maximum_source_sink_distance,
-       &extra_features,
-       &context,
-       &source_register_types,
-       &source_constant_arguments,
-       &narrowed_class_interval_context,
-       &caller_class_interval](
-          const AccessPath& callee_port, const Taint& generations) {
-        model.generations_.write(
-            callee_port,
-            generations.propagate(
-                callee,
-                callee_port,
-                call_position,
-                maximum_source_sink_distance,
-                extra_features,
-                context,
-                source_register_types,
-                source_constant_arguments,
-                narrowed_class_interval_context,
-                caller_class_interval),
-            UpdateKind::Weak);
-      });
+  // Per call site computations are shared by the ports of all taint trees.
+  auto call_site = CallSitePropagation(
+      callee,
+      call_position,
+      maximum_source_sink_distance,
+      extra_features,
+      context,
+      source_register_types,
+      source_constant_arguments,
+      narrowed_class_interval_context,
+      caller_class_interval);
+
+  generations_.visit([&model, &call_site](
+                         const AccessPath& callee_port,
+                         const Taint& generations) {
+    model.generations_.write(
+        callee_port,
+        generations.propagate(callee_port, call_site),
+        UpdateKind::Weak);
+  });
+
+  // Inlining as a getter or setter requires the absence of sinks, so the
+  // sinks of such models must be kept regardless of the arguments' taint.
+  bool skip_untainted_arguments = tainted_arguments.has_value() &&
+      !inline_as_getter_.is_value() && !inline_as_setter_.is_value();
 
   sinks_.visit([&model,
-                callee,
-                call_position,
-                maximum_source_sink_distance,
-                &extra_features,
-                &context,
-                &source_register_types,
-                &source_constant_arguments,
-                &narrowed_class_interval_context,
-                &caller_class_interval](
+                &call_site,
+                &tainted_arguments,
+                skip_untainted_arguments](
                    const AccessPath& callee_port, const Taint& sinks) {
+    if (skip_untainted_arguments && callee_port.root().is_argument()) {
+      auto position = callee_port.root().parameter_position();
+      if (position >= tainted_arguments->size() ||
+          !(*tainted_arguments)[position]) {
+        return;
+      }
+    }
+
     model.sinks_.write(
-        callee_port,
-        sinks.propagate(
-            callee,
-            callee_port,
-            call_position,
-            maximum_source_sink_distance,
-            extra_features,
-            context,
-            source_register_types,
-            source_constant_arguments,
-            narrowed_class_interval_context,
-            caller_class_interval),
-        UpdateKind::Weak);
+        callee_port, sinks.propagate(callee_port, call_site), UpdateKind::Weak);
   });
 
-  call_effect_sinks_.visit(
-      [&model,
-       callee,
-       call_position,
-       &context,
-       &narrowed_class_interval_context,
-       &caller_class_interval](
-          const AccessPath& callee_port, const Taint& call_effect) {
-        switch (callee_port.root().kind()) {
-          case Root::Kind::CallEffectCallChain:
-          case Root::Kind::CallEffectIntent: {
-            model.call_effect_sinks_.write(
-                callee_port,
-                call_effect.propagate(
-                    callee,
-                    callee_port,
-                    call_position,
-                    Heuristics::kMaxCallChainSourceSinkDistance,
-                    /* extra features */ {},
-                    context,
-                    /* source register types */ {},
-                    /* source constant arguments */ {},
-                    narrowed_class_interval_context,
-                    caller_class_interval),
-                UpdateKind::Weak);
-          } break;
-          default:
-            mt_unreachable();
-        }
-      });
-
-  propagations_.visit(
-      [&model,
-       callee,
-       call_position,
-       maximum_source_sink_distance,
-       &extra_features,
-       &context,
-       &source_register_types,
-       &source_constant_arguments,
-       &narrowed_class_interval_context,
-       &caller_class_interval](
-          const AccessPath& callee_port, const Taint& propagations) {
-        model.propagations_.write(
+  const FeatureMayAlwaysSet no_extra_features;
+  const std::vector<const DexType * MT_NULLABLE> no_source_register_types;
+  const std::vector<std::optional<std::string>> no_source_constant_arguments;
+  auto call_effect_call_site = CallSitePropagation(
+      callee,
+      call_position,
+      Heuristics::kMaxCallChainSourceSinkDistance,
+      no_extra_features,
+      context,
+      no_source_register_types,
+      no_source_constant_arguments,
+      narrowed_class_interval_context,
+      caller_class_interval);
+  call_effect_sinks_.visit([&model, &call_effect_call_site](
+                               const AccessPath& callee_port,
+                               const Taint& call_effect) {
+    switch (callee_port.root().kind()) {
+      case Root::Kind::CallEffectCallChain:
+      case Root::Kind::CallEffectIntent: {
+        model.call_effect_sinks_.write(
             callee_port,
-            propagations.propagate(
-                callee,
-                callee_port,
-                call_position,
-                maximum_source_sink_distance,
-                extra_features,
-                context,
-                source_register_types,
-                source_constant_arguments,
-                narrowed_class_interval_context,
-                caller_class_interval),
+            call_effect.propagate(callee_port, call_effect_call_site),
             UpdateKind::Weak);
-      });
+      } break;
+      default:
+        mt_unreachable();
+    }
+  });
 
-  model.add_features_to_arguments_ = add_features_to_arguments_;
+  propagations_.visit([&model, &call_site](
+                          const AccessPath& callee_port,
+                          const Taint& propagations) {
+    model.propagations_.write(
+        callee_port,
+        propagations.propagate(callee_port, call_site),
+        UpdateKind::Weak);
+  });
+
+  if (has_add_features_to_arguments()) {
+    model.mutable_cold().add_features_to_arguments =
+        cold().add_features_to_arguments;
+  }
 
   model.inline_as_getter_ = inline_as_getter_;
   model.inline_as_setter_ = inline_as_setter_;
@@ -500,8 +501,11 @@ Model Model::initial_model_for_iteration() const {
   model.method_ = method_;
   model.modes_ = modes_;
   model.global_sanitizers_ = global_sanitizers_;
-  model.port_sanitizers_ = port_sanitizers_;
-  model.model_generators_ = model_generators_;
+  if (cold_ != nullptr) {
+    auto& model_cold = model.mutable_cold();
+    model_cold.port_sanitizers = cold_->port_sanitizers;
+    model_cold.model_generators = cold_->model_generators;
+  }
   return model;
 }
 
@@ -607,16 +611,48 @@ void Model::approximate(const FeatureMayAlwaysSet& widening_features) {
       Heuristics::kPropagationMaxInputPathLeaves, widening_features);
 }
 
+void Model::reduce_precision(const FeatureMayAlwaysSet& widening_features) {
+  const auto drop = [](Taint taint) {
+    taint.drop_inferred_features_and_local_positions();
+    return taint;
+  };
+
+  for (auto* tree :
+       {&generations_,
+        &parameter_sources_,
+        &sinks_,
+        &call_effect_sources_,
+        &call_effect_sinks_,
+        &propagations_}) {
+    tree->limit_leaves(
+        Heuristics::kReducedPrecisionMaxLeaves, widening_features);
+    tree->transform(drop);
+  }
+}
+
+void Model::intern_frames(FrameInterner& interner) {
+  const auto intern = [&interner](Taint taint) {
+    taint.transform_frames([&interner](Frame frame) {
+      return interner.intern(std::move(frame));
+    });
+    return taint;
+  };
+
+  generations_.transform(intern);
+  parameter_sources_.transform(intern);
+  sinks_.transform(intern);
+  call_effect_sources_.transform(intern);
+  call_effect_sinks_.transform(intern);
+  propagations_.transform(intern);
+}
+
 bool Model::empty() const {
   return modes_.empty() && frozen_.empty() && generations_.is_bottom() &&
       parameter_sources_.is_bottom() && sinks_.is_bottom() &&
       call_effect_sources_.is_bottom() && call_effect_sinks_.is_bottom() &&
       propagations_.is_bottom() && global_sanitizers_.is_bottom() &&
-      port_sanitizers_.is_bottom() && attach_to_sources_.is_bottom() &&
-      attach_to_sinks_.is_bottom() && attach_to_propagations_.is_bottom() &&
-      add_features_to_arguments_.is_bottom() && inline_as_getter_.is_bottom() &&
-      inline_as_setter_.is_bottom() && model_generators_.is_bottom() &&
-      issues_.is_bottom();
+      inline_as_getter_.is_bottom() && inline_as_setter_.is_bottom() &&
+      cold().empty();
 }
 
 void Model::add_mode(Model::Mode mode, Context& context) {
@@ -795,7 +831,7 @@ void Model::add_inferred_propagations(
     Taint local_taint,
     const FeatureMayAlwaysSet& widening_features) {
   if (has_global_propagation_sanitizer() ||
-      !port_sanitizers_.get(input_path.root()).is_bottom()) {
+      !cold().port_sanitizers.get(input_path.root()).is_bottom()) {
     return;
   }
 
@@ -816,9 +852,9 @@ void Model::add_port_sanitizers(SanitizerSet sanitizers, Root root) {
     return;
   }
 
-  port_sanitizers_.update(root, [&sanitizers](const SanitizerSet& set) {
-    return set.join(sanitizers);
-  });
+  mutable_cold().port_sanitizers.update(
+      root,
+      [&sanitizers](const SanitizerSet& set) { return set.join(sanitizers); });
 }
 
 Taint Model::apply_source_sink_sanitizers(
@@ -827,24 +863,29 @@ Taint Model::apply_source_sink_sanitizers(
     Root root) {
   mt_assert(kind != SanitizerKind::Propagations);
 
-  std::unordered_set<const Kind*> sanitized_kinds;
-  for (const auto& sanitizer_set :
-       {global_sanitizers_, port_sanitizers_.get(root)}) {
-    for (const auto& sanitizer : sanitizer_set) {
+  const auto& port_sanitizers = cold().port_sanitizers.get(root);
+  if (global_sanitizers_.is_bottom() && port_sanitizers.is_bottom()) {
+    // Most models have no sanitizers.
+    return taint;
+  }
+
+  // Kinds sets are patricia trees, hence joining them shares their nodes.
+  auto sanitized_kinds = KindSetAbstractDomain::bottom();
+  for (const auto* sanitizer_set : {&global_sanitizers_, &port_sanitizers}) {
+    for (const auto& sanitizer : *sanitizer_set) {
       if (sanitizer.sanitizer_kind() == kind) {
         const auto& kinds = sanitizer.kinds();
         if (kinds.is_top()) {
           return Taint::bottom();
         }
-        sanitized_kinds.insert(
-            kinds.elements().begin(), kinds.elements().end());
+        sanitized_kinds.join_with(kinds);
       }
     }
   }
 
-  if (!sanitized_kinds.empty()) {
+  if (!sanitized_kinds.is_bottom()) {
     taint.filter_frames([&sanitized_kinds](const Frame& frame) {
-      return sanitized_kinds.find(frame.kind()) == sanitized_kinds.end();
+      return !sanitized_kinds.contains(frame.kind());
     });
   }
 
@@ -861,12 +902,12 @@ void Model::add_attach_to_sources(Root root, FeatureSet features) {
     return;
   }
 
-  attach_to_sources_.update(
+  mutable_cold().attach_to_sources.update(
       root, [&features](const FeatureSet& set) { return set.join(features); });
 }
 
 FeatureSet Model::attach_to_sources(Root root) const {
-  return attach_to_sources_.get(root);
+  return cold().attach_to_sources.get(root);
 }
 
 void Model::add_attach_to_sinks(Root root, FeatureSet features) {
@@ -874,12 +915,12 @@ void Model::add_attach_to_sinks(Root root, FeatureSet features) {
     return;
   }
 
-  attach_to_sinks_.update(
+  mutable_cold().attach_to_sinks.update(
       root, [&features](const FeatureSet& set) { return set.join(features); });
 }
 
 FeatureSet Model::attach_to_sinks(Root root) const {
-  return attach_to_sinks_.get(root);
+  return cold().attach_to_sinks.get(root);
 }
 
 void Model::add_attach_to_propagations(Root root, FeatureSet features) {
@@ -887,12 +928,12 @@ void Model::add_attach_to_propagations(Root root, FeatureSet features) {
     return;
   }
 
-  attach_to_propagations_.update(
+  mutable_cold().attach_to_propagations.update(
       root, [&features](const FeatureSet& set) { return set.join(features); });
 }
 
 FeatureSet Model::attach_to_propagations(Root root) const {
-  return attach_to_propagations_.get(root);
+  return cold().attach_to_propagations.get(root);
 }
 
 void Model::add_add_features_to_arguments(Root root, FeatureSet features) {
@@ -900,16 +941,16 @@ void Model::add_add_features_to_arguments(Root root, FeatureSet features) {
     return;
   }
 
-  add_features_to_arguments_.update(
+  mutable_cold().add_features_to_arguments.update(
       root, [&features](const FeatureSet& set) { return set.join(features); });
 }
 
 bool Model::has_add_features_to_arguments() const {
-  return !add_features_to_arguments_.is_bottom();
+  return !cold().add_features_to_arguments.is_bottom();
 }
 
 FeatureSet Model::add_features_to_arguments(Root root) const {
-  return add_features_to_arguments_.get(root);
+  return cold().add_features_to_arguments.get(root);
 }
 
 const AccessPathConstantDomain& Model::inline_as_getter() const {
@@ -925,16 +966,16 @@ void Model::set_inline_as_getter(AccessPathConstantDomain inline_as_getter) {
 }
 
 void Model::add_model_generator(const ModelGeneratorName* model_generator) {
-  model_generators_.add(model_generator);
+  mutable_cold().model_generators.add(model_generator);
 }
 
 void Model::add_model_generator_if_empty(
     const ModelGeneratorName* model_generator) {
-  if (!model_generators_.is_bottom()) {
+  if (!cold().model_generators.is_bottom()) {
     return;
   }
 
-  model_generators_.add(model_generator);
+  mutable_cold().model_generators.add(model_generator);
 }
 
 const SetterAccessPathConstantDomain& Model::inline_as_setter() const {
@@ -951,7 +992,15 @@ void Model::set_inline_as_setter(
 }
 
 void Model::add_issue(Issue trace) {
-  issues_.add(std::move(trace));
+  mutable_cold().issues.add(std::move(trace));
+}
+
+void Model::set_issues(IssueSet issues) {
+  if (cold_ == nullptr && issues.is_bottom()) {
+    return;
+  }
+
+  mutable_cold().issues = std::move(issues);
 }
 
 bool Model::skip_analysis() const {
@@ -991,6 +1040,21 @@ bool Model::is_frozen(Model::FreezeKind freeze_kind) const {
 }
 
 bool Model::leq(const Model& other) const {
+  if (!leq_caller_visible(other)) {
+    return false;
+  }
+  if (cold_ == nullptr || cold_ == other.cold_) {
+    return true;
+  }
+
+  const auto& other_cold = other.cold();
+  return cold_->model_generators.leq(other_cold.model_generators) &&
+      cold_->issues.leq(other_cold.issues);
+}
+
+bool Model::leq_caller_visible(const Model& other) const {
+  const auto& parts = cold();
+  const auto& other_parts = other.cold();
   return modes_.is_subset_of(other.modes_) &&
       frozen_.is_subset_of(other.frozen_) &&
       leq_frozen(
@@ -1016,15 +1080,15 @@ bool Model::leq(const Model& other) const {
       call_effect_sources_.leq(other.call_effect_sources_) &&
       call_effect_sinks_.leq(other.call_effect_sinks_) &&
       global_sanitizers_.leq(other.global_sanitizers_) &&
-      port_sanitizers_.leq(other.port_sanitizers_) &&
-      attach_to_sources_.leq(other.attach_to_sources_) &&
-      attach_to_sinks_.leq(other.attach_to_sinks_) &&
-      attach_to_propagations_.leq(other.attach_to_propagations_) &&
-      add_features_to_arguments_.leq(other.add_features_to_arguments_) &&
       inline_as_getter_.leq(other.inline_as_getter_) &&
       inline_as_setter_.leq(other.inline_as_setter_) &&
-      model_generators_.leq(other.model_generators_) &&
-      issues_.leq(other.issues_);
+      (cold_ == other.cold_ ||
+       (parts.port_sanitizers.leq(other_parts.port_sanitizers) &&
+        parts.attach_to_sources.leq(other_parts.attach_to_sources) &&
+        parts.attach_to_sinks.leq(other_parts.attach_to_sinks) &&
+        parts.attach_to_propagations.leq(other_parts.attach_to_propagations) &&
+        parts.add_features_to_arguments.leq(
+            other_parts.add_features_to_arguments)));
 }
 
 void Model::join_with(const Model& other) {
@@ -1060,15 +1124,23 @@ void Model::join_with(const Model& other) {
   call_effect_sources_.join_with(other.call_effect_sources_);
   call_effect_sinks_.join_with(other.call_effect_sinks_);
   global_sanitizers_.join_with(other.global_sanitizers_);
-  port_sanitizers_.join_with(other.port_sanitizers_);
-  attach_to_sources_.join_with(other.attach_to_sources_);
-  attach_to_sinks_.join_with(other.attach_to_sinks_);
-  attach_to_propagations_.join_with(other.attach_to_propagations_);
-  add_features_to_arguments_.join_with(other.add_features_to_arguments_);
   inline_as_getter_.join_with(other.inline_as_getter_);
   inline_as_setter_.join_with(other.inline_as_setter_);
-  model_generators_.join_with(other.model_generators_);
-  issues_.join_with(other.issues_);
+
+  if (cold_ == nullptr) {
+    // Share the cold parts until one of the models modifies them.
+    cold_ = other.cold_;
+  } else if (other.cold_ != nullptr && other.cold_ != cold_) {
+    auto& parts = mutable_cold();
+    parts.port_sanitizers.join_with(other.cold_->port_sanitizers);
+    parts.attach_to_sources.join_with(other.cold_->attach_to_sources);
+    parts.attach_to_sinks.join_with(other.cold_->attach_to_sinks);
+    parts.attach_to_propagations.join_with(other.cold_->attach_to_propagations);
+    parts.add_features_to_arguments.join_with(
+        other.cold_->add_features_to_arguments);
+    parts.model_generators.join_with(other.cold_->model_generators);
+    parts.issues.join_with(other.cold_->issues);
+  }
 
   mt_expensive_assert(previous.leq(*this) && other.leq(*this));
 }
@@ -1134,6 +1206,32 @@ Model Model::from_json(
     const Json::Value& value,
     Context& context,
     bool check_unexpected_members) {
+  return from_json(
+      method,
+      value,
+      context,
+      check_unexpected_members,
+      /* check_nested_members */ true);
+}
+
+Model Model::from_trusted_json(
+    const Method* method,
+    const Json::Value& value,
+    Context& context) {
+  return from_json(
+      method,
+      value,
+      context,
+      /* check_unexpected_members */ false,
+      /* check_nested_members */ false);
+}
+
+Model Model::from_json(
+    const Method* method,
+    const Json::Value& value,
+    Context& context,
+    bool check_unexpected_members,
+    bool check_nested_members) {
   JsonValidation::validate_object(value);
   if (check_unexpected_members) {
     JsonValidation::check_unexpected_members(
@@ -1192,7 +1290,9 @@ Model Model::from_json(
       port = AccessPath::from_json(generation_value["caller_port"]);
     }
     model.add_generation(
-        port, TaintConfig::from_json(generation_value, context));
+        port,
+        TaintConfig::from_json(
+            generation_value, context, check_nested_members));
   }
 
   for (auto parameter_source_value :
@@ -1202,7 +1302,9 @@ Model Model::from_json(
     JsonValidation::string(parameter_source_value, /* field */ port_field);
     auto port = AccessPath::from_json(parameter_source_value[port_field]);
     model.add_parameter_source(
-        port, TaintConfig::from_json(parameter_source_value, context));
+        port,
+        TaintConfig::from_json(
+            parameter_source_value, context, check_nested_members));
   }
 
   for (auto source_value :
@@ -1215,7 +1317,8 @@ Model Model::from_json(
       JsonValidation::string(source_value, /* field */ "caller_port");
       port = AccessPath::from_json(source_value["caller_port"]);
     }
-    auto source = TaintConfig::from_json(source_value, context);
+    auto source =
+        TaintConfig::from_json(source_value, context, check_nested_members);
     if (port.root().is_argument()) {
       model.add_parameter_source(port, source);
     } else {
@@ -1229,7 +1332,9 @@ Model Model::from_json(
         sink_value.isMember("port") ? "port" : "caller_port";
     JsonValidation::string(sink_value, /* field */ port_field);
     auto port = AccessPath::from_json(sink_value[port_field]);
-    model.add_sink(port, TaintConfig::from_json(sink_value, context));
+    model.add_sink(
+        port,
+        TaintConfig::from_json(sink_value, context, check_nested_members));
   }
 
   for (auto effect_source_value :
@@ -1239,7 +1344,9 @@ Model Model::from_json(
     JsonValidation::string(effect_source_value, /* field */ effect_type_port);
     auto port = AccessPath::from_json(effect_source_value[effect_type_port]);
     model.add_call_effect_source(
-        port, TaintConfig::from_json(effect_source_value, context));
+        port,
+        TaintConfig::from_json(
+            effect_source_value, context, check_nested_members));
   }
 
   for (auto effect_sink_value :
@@ -1249,13 +1356,16 @@ Model Model::from_json(
     JsonValidation::string(effect_sink_value, /* field */ effect_type_port);
     auto port = AccessPath::from_json(effect_sink_value[effect_type_port]);
     model.add_call_effect_sink(
-        port, TaintConfig::from_json(effect_sink_value, context));
+        port,
+        TaintConfig::from_json(
+            effect_sink_value, context, check_nested_members));
   }
 
   for (auto propagation_value :
        JsonValidation::null_or_array(value, /* field */ "propagation")) {
     model.add_propagation(
-        PropagationConfig::from_json(propagation_value, context));
+        PropagationConfig::from_json(
+            propagation_value, context, check_nested_members));
   }
 
   for (auto sanitizer_value :
@@ -1271,8 +1381,10 @@ Model Model::from_json(
 
   for (auto attach_to_sources_value :
        JsonValidation::null_or_array(value, /* field */ "attach_to_sources")) {
-    JsonValidation::check_unexpected_members(
-        attach_to_sources_value, {"port", "features"});
+    if (check_nested_members) {
+      JsonValidation::check_unexpected_members(
+          attach_to_sources_value, {"port", "features"});
+    }
     JsonValidation::string(attach_to_sources_value, /* field */ "port");
     auto root = Root::from_json(attach_to_sources_value["port"]);
     JsonValidation::null_or_array(
@@ -1284,8 +1396,10 @@ Model Model::from_json(
 
   for (auto attach_to_sinks_value :
        JsonValidation::null_or_array(value, /* field */ "attach_to_sinks")) {
-    JsonValidation::check_unexpected_members(
-        attach_to_sinks_value, {"port", "features"});
+    if (check_nested_members) {
+      JsonValidation::check_unexpected_members(
+          attach_to_sinks_value, {"port", "features"});
+    }
     JsonValidation::string(attach_to_sinks_value, /* field */ "port");
     auto root = Root::from_json(attach_to_sinks_value["port"]);
     JsonValidation::null_or_array(
@@ -1297,8 +1411,10 @@ Model Model::from_json(
 
   for (auto attach_to_propagations_value : JsonValidation::null_or_array(
            value, /* field */ "attach_to_propagations")) {
-    JsonValidation::check_unexpected_members(
-        attach_to_propagations_value, {"port", "features"});
+    if (check_nested_members) {
+      JsonValidation::check_unexpected_members(
+          attach_to_propagations_value, {"port", "features"});
+    }
     JsonValidation::string(attach_to_propagations_value, /* field */ "port");
     auto root = Root::from_json(attach_to_propagations_value["port"]);
     JsonValidation::null_or_array(
@@ -1310,8 +1426,10 @@ Model Model::from_json(
 
   for (auto add_features_to_arguments_value : JsonValidation::null_or_array(
            value, /* field */ "add_features_to_arguments")) {
-    JsonValidation::check_unexpected_members(
-        add_features_to_arguments_value, {"port", "features"});
+    if (check_nested_members) {
+      JsonValidation::check_unexpected_members(
+          add_features_to_arguments_value, {"port", "features"});
+    }
     JsonValidation::string(add_features_to_arguments_value, /* field */ "port");
     auto root = Root::from_json(add_features_to_arguments_value["port"]);
     JsonValidation::null_or_array(
@@ -1445,7 +1563,7 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
       sanitizers_value.append(sanitizer.to_json());
     }
   }
-  for (const auto& [root, sanitizers] : port_sanitizers_) {
+  for (const auto& [root, sanitizers] : cold().port_sanitizers) {
     auto root_value = root.to_json();
     for (const auto& sanitizer : sanitizers) {
       if (!sanitizer.is_bottom()) {
@@ -1459,9 +1577,9 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
     value["sanitizers"] = sanitizers_value;
   }
 
-  if (!attach_to_sources_.is_bottom()) {
+  if (!cold().attach_to_sources.is_bottom()) {
     auto attach_to_sources_value = Json::Value(Json::arrayValue);
-    for (const auto& [root, features] : attach_to_sources_) {
+    for (const auto& [root, features] : cold().attach_to_sources) {
       auto attach_to_sources_root_value = Json::Value(Json::objectValue);
       attach_to_sources_root_value["port"] = root.to_json();
       attach_to_sources_root_value["features"] = features.to_json();
@@ -1470,9 +1588,9 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
     value["attach_to_sources"] = attach_to_sources_value;
   }
 
-  if (!attach_to_sinks_.is_bottom()) {
+  if (!cold().attach_to_sinks.is_bottom()) {
     auto attach_to_sinks_value = Json::Value(Json::arrayValue);
-    for (const auto& [root, features] : attach_to_sinks_) {
+    for (const auto& [root, features] : cold().attach_to_sinks) {
       auto attach_to_sinks_root_value = Json::Value(Json::objectValue);
       attach_to_sinks_root_value["port"] = root.to_json();
       attach_to_sinks_root_value["features"] = features.to_json();
@@ -1481,9 +1599,9 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
     value["attach_to_sinks"] = attach_to_sinks_value;
   }
 
-  if (!attach_to_propagations_.is_bottom()) {
+  if (!cold().attach_to_propagations.is_bottom()) {
     auto attach_to_propagations_value = Json::Value(Json::arrayValue);
-    for (const auto& [root, features] : attach_to_propagations_) {
+    for (const auto& [root, features] : cold().attach_to_propagations) {
       auto attach_to_propagations_root_value = Json::Value(Json::objectValue);
       attach_to_propagations_root_value["port"] = root.to_json();
       attach_to_propagations_root_value["features"] = features.to_json();
@@ -1492,9 +1610,9 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
     value["attach_to_propagations"] = attach_to_propagations_value;
   }
 
-  if (!add_features_to_arguments_.is_bottom()) {
+  if (!cold().add_features_to_arguments.is_bottom()) {
     auto add_features_to_arguments_value = Json::Value(Json::arrayValue);
-    for (const auto& [root, features] : add_features_to_arguments_) {
+    for (const auto& [root, features] : cold().add_features_to_arguments) {
       auto add_features_to_arguments_root_value =
           Json::Value(Json::objectValue);
       add_features_to_arguments_root_value["port"] = root.to_json();
@@ -1513,17 +1631,17 @@ Json::Value Model::to_json(ExportOriginsMode export_origins_mode) const {
     value["inline_as_setter"] = setter_access_path->to_json();
   }
 
-  if (!model_generators_.is_bottom()) {
+  if (!cold().model_generators.is_bottom()) {
     auto model_generators_value = Json::Value(Json::arrayValue);
-    for (const auto* model_generator : model_generators_) {
+    for (const auto* model_generator : cold().model_generators) {
       model_generators_value.append(model_generator->to_json());
     }
     value["model_generators"] = model_generators_value;
   }
 
-  if (!issues_.is_bottom()) {
+  if (!cold().issues.is_bottom()) {
     auto issues_value = Json::Value(Json::arrayValue);
-    for (const auto& issue : issues_) {
+    for (const auto& issue : cold().issues) {
       mt_assert(!issue.is_bottom());
       issues_value.append(issue.to_json(ExportOriginsMode::Always));
     }
@@ -1544,6 +1662,207 @@ Json::Value Model::to_json(Context& context) const {
   return value;
 }
 
+namespace {
+
+template <typename Tree>
+void write_port_taint_tree(
+    JsonWriter& writer,
+    std::string_view key,
+    std::string_view port_key,
+    std::string_view taint_key,
+    const Tree& tree,
+    ExportOriginsMode export_origins_mode) {
+  if (tree.is_bottom()) {
+    return;
+  }
+  writer.key(key);
+  writer.begin_array();
+  for (const auto& [port, taint] : tree.elements()) {
+    writer.begin_object();
+    writer.key(port_key).value(port.to_json());
+    writer.key(taint_key);
+    taint.write_json(writer, export_origins_mode);
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
+template <typename Map>
+void write_port_features(
+    JsonWriter& writer,
+    std::string_view key,
+    const Map& map) {
+  if (map.is_bottom()) {
+    return;
+  }
+  writer.key(key);
+  writer.begin_array();
+  for (const auto& [root, features] : map) {
+    writer.begin_object();
+    writer.key("features");
+    features.write_json(writer);
+    writer.key("port").value(root.to_json());
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
+} // namespace
+
+void Model::write_json(
+    JsonWriter& writer,
+    ExportOriginsMode export_origins_mode) const {
+  writer.begin_object();
+  write_json_members(writer, export_origins_mode);
+  writer.end_object();
+}
+
+void Model::write_json(JsonWriter& writer, Context& context) const {
+  writer.begin_object();
+  write_json_members(writer, context.options->export_origins_mode());
+  if (method_) {
+    writer.key("position");
+    context.positions->get(method_)->write_json(writer);
+  }
+  writer.end_object();
+}
+
+void Model::write_json_members(
+    JsonWriter& writer,
+    ExportOriginsMode export_origins_mode) const {
+  if (method_) {
+    writer.key("method").value(method_->to_json());
+  }
+
+  if (modes_) {
+    writer.key("modes");
+    writer.begin_array();
+    for (auto mode : k_all_modes) {
+      if (modes_.test(mode)) {
+        writer.value(model_mode_to_string(mode));
+      }
+    }
+    writer.end_array();
+  }
+
+  if (frozen_) {
+    writer.key("freeze");
+    writer.begin_array();
+    for (auto freeze_kind : k_all_freeze_kinds) {
+      if (frozen_.test(freeze_kind)) {
+        writer.value(model_freeze_kind_to_string(freeze_kind));
+      }
+    }
+    writer.end_array();
+  }
+
+  write_port_taint_tree(
+      writer,
+      "generations",
+      "port",
+      "taint",
+      generations_,
+      export_origins_mode);
+  write_port_taint_tree(
+      writer,
+      "parameter_sources",
+      "port",
+      "taint",
+      parameter_sources_,
+      export_origins_mode);
+  write_port_taint_tree(
+      writer,
+      "effect_sources",
+      "port",
+      "taint",
+      call_effect_sources_,
+      export_origins_mode);
+  write_port_taint_tree(
+      writer, "sinks", "port", "taint", sinks_, export_origins_mode);
+  write_port_taint_tree(
+      writer,
+      "effect_sinks",
+      "port",
+      "taint",
+      call_effect_sinks_,
+      export_origins_mode);
+  write_port_taint_tree(
+      writer,
+      "propagation",
+      "input",
+      "output",
+      propagations_,
+      export_origins_mode);
+
+  bool has_sanitizers = std::any_of(
+      global_sanitizers_.begin(),
+      global_sanitizers_.end(),
+      [](const auto& sanitizer) { return !sanitizer.is_bottom(); });
+  for (const auto& [_root, sanitizers] : cold().port_sanitizers) {
+    has_sanitizers = has_sanitizers ||
+        std::any_of(sanitizers.begin(),
+                    sanitizers.end(),
+                    [](const auto& sanitizer) {
+                      return !sanitizer.is_bottom();
+                    });
+  }
+  if (has_sanitizers) {
+    writer.key("sanitizers");
+    writer.begin_array();
+    for (const auto& sanitizer : global_sanitizers_) {
+      if (!sanitizer.is_bottom()) {
+        writer.value(sanitizer.to_json());
+      }
+    }
+    for (const auto& [root, sanitizers] : cold().port_sanitizers) {
+      auto root_value = root.to_json();
+      for (const auto& sanitizer : sanitizers) {
+        if (!sanitizer.is_bottom()) {
+          writer.begin_object();
+          writer.members(sanitizer.to_json());
+          writer.key("port").value(root_value);
+          writer.end_object();
+        }
+      }
+    }
+    writer.end_array();
+  }
+
+  write_port_features(writer, "attach_to_sources", cold().attach_to_sources);
+  write_port_features(writer, "attach_to_sinks", cold().attach_to_sinks);
+  write_port_features(
+      writer, "attach_to_propagations", cold().attach_to_propagations);
+  write_port_features(
+      writer, "add_features_to_arguments", cold().add_features_to_arguments);
+
+  if (auto getter_access_path = inline_as_getter_.get_constant()) {
+    writer.key("inline_as_getter").value(getter_access_path->to_json());
+  }
+
+  if (auto setter_access_path = inline_as_setter_.get_constant()) {
+    writer.key("inline_as_setter").value(setter_access_path->to_json());
+  }
+
+  if (!cold().model_generators.is_bottom()) {
+    writer.key("model_generators");
+    writer.begin_array();
+    for (const auto* model_generator : cold().model_generators) {
+      writer.value(model_generator->to_json());
+    }
+    writer.end_array();
+  }
+
+  if (!cold().issues.is_bottom()) {
+    writer.key("issues");
+    writer.begin_array();
+    for (const auto& issue : cold().issues) {
+      mt_assert(!issue.is_bottom());
+      issue.write_json(writer, ExportOriginsMode::Always);
+    }
+    writer.end_array();
+  }
+}
+
 std::ostream& operator<<(std::ostream& out, const Model& model) {
   out << "\nModel(method=`" << show(model.method_) << "`";
   if (model.modes_) {
@@ -1622,37 +1941,38 @@ std::ostream& operator<<(std::ostream& out, const Model& model) {
   if (!model.global_sanitizers_.is_bottom()) {
     out << ",\n  global_sanitizers=" << model.global_sanitizers_;
   }
-  if (!model.port_sanitizers_.is_bottom()) {
+  if (!model.cold().port_sanitizers.is_bottom()) {
     out << ",\n  port_sanitizers={\n";
-    for (const auto& [root, sanitizers] : model.port_sanitizers_) {
+    for (const auto& [root, sanitizers] : model.cold().port_sanitizers) {
       out << "   " << root << " -> " << sanitizers << ",\n";
     }
     out << "  }";
   }
-  if (!model.attach_to_sources_.is_bottom()) {
+  if (!model.cold().attach_to_sources.is_bottom()) {
     out << ",\n attach_to_sources={\n";
-    for (const auto& [root, features] : model.attach_to_sources_) {
+    for (const auto& [root, features] : model.cold().attach_to_sources) {
       out << "    " << root << " -> " << features << ",\n";
     }
     out << "  }";
   }
-  if (!model.attach_to_sinks_.is_bottom()) {
+  if (!model.cold().attach_to_sinks.is_bottom()) {
     out << ",\n attach_to_sinks={\n";
-    for (const auto& [root, features] : model.attach_to_sinks_) {
+    for (const auto& [root, features] : model.cold().attach_to_sinks) {
       out << "    " << root << " -> " << features << ",\n";
     }
     out << "  }";
   }
-  if (!model.attach_to_propagations_.is_bottom()) {
+  if (!model.cold().attach_to_propagations.is_bottom()) {
     out << ",\n attach_to_propagations={\n";
-    for (const auto& [root, features] : model.attach_to_propagations_) {
+    for (const auto& [root, features] : model.cold().attach_to_propagations) {
       out << "    " << root << " -> " << features << ",\n";
     }
     out << "  }";
   }
-  if (!model.add_features_to_arguments_.is_bottom()) {
+  if (!model.cold().add_features_to_arguments.is_bottom()) {
     out << ",\n add_features_to_arguments={\n";
-    for (const auto& [root, features] : model.add_features_to_arguments_) {
+    for (const auto& [root, features] :
+         model.cold().add_features_to_arguments) {
       out << "    " << root << " -> " << features << ",\n";
     }
     out << "  }";
@@ -1663,16 +1983,16 @@ std::ostream& operator<<(std::ostream& out, const Model& model) {
   if (auto setter_access_path = model.inline_as_setter_.get_constant()) {
     out << ",\n  inline_as_setter=" << *setter_access_path;
   }
-  if (!model.model_generators_.is_bottom()) {
+  if (!model.cold().model_generators.is_bottom()) {
     out << ",\n  model_generators={";
-    for (const auto* model_generator : model.model_generators_) {
+    for (const auto* model_generator : model.cold().model_generators) {
       out << *model_generator << ", ";
     }
     out << "}";
   }
-  if (!model.issues_.is_bottom()) {
+  if (!model.cold().issues.is_bottom()) {
     out << ",\n  issues={\n";
-    for (const auto& issue : model.issues_) {
+    for (const auto& issue : model.cold().issues) {
       out << "    " << issue << ",\n";
     }
     out << "  }";
@@ -1681,9 +2001,16 @@ std::ostream& operator<<(std::ostream& out, const Model& model) {
 }
 
 void Model::remove_kinds(const std::unordered_set<const Kind*>& to_remove) {
+  remove_kinds([&to_remove](const Kind* kind) {
+    return to_remove.find(kind) != to_remove.end();
+  });
+}
+
+void Model::remove_kinds(
+    const std::function<bool(const Kind*)>& should_remove) {
   auto drop_special_kinds =
-      [&to_remove](const Kind* kind) -> std::vector<const Kind*> {
-    if (to_remove.find(kind) != to_remove.end()) {
+      [&should_remove](const Kind* kind) -> std::vector<const Kind*> {
+    if (should_remove(kind)) {
       return std::vector<const Kind*>();
     }
     return std::vector<const Kind*>{kind};
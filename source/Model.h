@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -19,9 +21,11 @@
 #include <mariana-trench/Access.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/FeatureSet.h>
+#include <mariana-trench/FrameInterner.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Issue.h>
 #include <mariana-trench/IssueSet.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/Position.h>
 #include <mariana-trench/PropagationConfig.h>
@@ -180,14 +184,22 @@ class Model final {
   /* Copy the model and attach it to the given method. */
   Model instantiate(const Method* method, Context& context) const;
 
-  /* Return the callee model for the given callsite. */
+  /**
+   * Return the callee model for the given callsite.
+   *
+   * If `tainted_arguments` is provided, sinks on arguments that are not marked
+   * as tainted are not instantiated, since they cannot lead to issues. This is
+   * ignored for models that can be inlined as getters or setters, since
+   * inlining depends on the absence of sinks.
+   */
   Model at_callsite(
       const Method* caller,
       const Position* position,
       Context& context,
       const std::vector<const DexType * MT_NULLABLE>& source_register_types,
       const std::vector<std::optional<std::string>>& source_constant_arguments,
-      const CallClassIntervalContext& class_interval_context) const;
+      const CallClassIntervalContext& class_interval_context,
+      const std::optional<std::vector<bool>>& tainted_arguments) const;
 
   /* Create a new fresh model without sources/sinks/propagations based on the
    * structure of the current model. */
@@ -197,6 +209,17 @@ class Model final {
 
   void approximate(const FeatureMayAlwaysSet& widening_features);
 
+  /**
+   * Approximate the model further than `approximate`, for methods of
+   * `--reduced-precision-classes`: trees are limited to
+   * `Heuristics::kReducedPrecisionMaxLeaves` leaves, and inferred features and
+   * local positions are dropped. Kinds, ports and user features are kept.
+   */
+  void reduce_precision(const FeatureMayAlwaysSet& widening_features);
+
+  /* Share the data of frames equal to frames of other models. */
+  void intern_frames(FrameInterner& interner);
+
   bool empty() const;
 
   void add_mode(Model::Mode mode, Context& context);
@@ -242,11 +265,17 @@ class Model final {
   const TaintAccessPathTree& call_effect_sources() const {
     return call_effect_sources_;
   }
+  void set_call_effect_sources(TaintAccessPathTree call_effect_sources) {
+    call_effect_sources_ = std::move(call_effect_sources);
+  }
   void add_call_effect_source(AccessPath port, TaintConfig source);
 
   const TaintAccessPathTree& call_effect_sinks() const {
     return call_effect_sinks_;
   }
+  void set_call_effect_sinks(TaintAccessPathTree call_effect_sinks) {
+    call_effect_sinks_ = std::move(call_effect_sinks);
+  }
   void add_call_effect_sink(AccessPath port, TaintConfig sink);
   void add_inferred_call_effect_sinks(AccessPath port, Taint sink);
   void add_inferred_call_effect_sinks(
@@ -263,6 +292,9 @@ class Model final {
   const TaintAccessPathTree& propagations() const {
     return propagations_;
   }
+  void set_propagations(TaintAccessPathTree propagations) {
+    propagations_ = std::move(propagations);
+  }
 
   void add_global_sanitizer(Sanitizer sanitizer);
   const SanitizerSet& global_sanitizers() const {
@@ -295,16 +327,18 @@ class Model final {
 
   void add_model_generator(const ModelGeneratorName* model_generator);
   void add_model_generator_if_empty(const ModelGeneratorName* model_generator);
+  const ModelGeneratorNameSet& model_generators() const {
+    return cold().model_generators;
+  }
 
   void add_issue(Issue issue);
   const IssueSet& issues() const {
-    return issues_;
-  }
-  void set_issues(IssueSet issues) {
-    issues_ = std::move(issues);
+    return cold().issues;
   }
+  void set_issues(IssueSet issues);
 
   void remove_kinds(const std::unordered_set<const Kind*>& to_remove);
+  void remove_kinds(const std::function<bool(const Kind*)>& should_remove);
 
   bool skip_analysis() const;
   bool add_via_obscure_feature() const;
@@ -321,6 +355,13 @@ class Model final {
   bool is_frozen(FreezeKind freeze_kind) const;
 
   bool leq(const Model& other) const;
+
+  /**
+   * Same as `leq`, but only compares the parts of the model that can affect
+   * the analysis of callers, i.e excluding issues and model generators.
+   */
+  bool leq_caller_visible(const Model& other) const;
+
   void join_with(const Model& other);
 
   std::unordered_set<const Kind*> source_kinds() const;
@@ -339,14 +380,67 @@ class Model final {
       const Json::Value& value,
       Context& context,
       bool check_unexpected_members = true);
+
+  /**
+   * Parse a model written by this analysis, in a file that was already
+   * validated as a whole (e.g. from its version and fingerprint). Members are
+   * not checked, since unexpected members cannot appear in such files.
+   */
+  static Model from_trusted_json(
+      const Method* MT_NULLABLE method,
+      const Json::Value& value,
+      Context& context);
   Json::Value to_json(ExportOriginsMode export_origins_mode) const;
 
   /* Export the model to json and include the method position. */
   Json::Value to_json(Context& context) const;
 
+  /**
+   * Same as `to_json`, but written directly into the given writer. The output
+   * is identical to the compact serialization of `to_json`.
+   */
+  void write_json(JsonWriter& writer, ExportOriginsMode export_origins_mode)
+      const;
+  void write_json(JsonWriter& writer, Context& context) const;
+
   friend std::ostream& operator<<(std::ostream& out, const Model& model);
 
  private:
+  /**
+   * Parts of the model that are empty for most methods. They are allocated on
+   * the first write and shared between copies of the model until one of them
+   * is modified, which keeps copies of the model cheap.
+   */
+  struct Cold {
+    RootPatriciaTreeAbstractPartition<SanitizerSet> port_sanitizers;
+    RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_sources;
+    RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_sinks;
+    RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_propagations;
+    RootPatriciaTreeAbstractPartition<FeatureSet> add_features_to_arguments;
+    ModelGeneratorNameSet model_generators;
+    IssueSet issues;
+
+    bool operator==(const Cold& other) const;
+    bool empty() const;
+  };
+
+  /* Return the cold parts, or empty parts if they were never written. */
+  const Cold& cold() const;
+
+  /* Return the cold parts for a write, unsharing them if necessary. */
+  Cold& mutable_cold();
+
+  static Model from_json(
+      const Method* MT_NULLABLE method,
+      const Json::Value& value,
+      Context& context,
+      bool check_unexpected_members,
+      bool check_nested_members);
+
+  void write_json_members(
+      JsonWriter& writer,
+      ExportOriginsMode export_origins_mode) const;
+
   void update_taint_tree(
       TaintAccessPathTree& tree,
       AccessPath port,
@@ -392,15 +486,9 @@ class Model final {
   TaintAccessPathTree call_effect_sinks_;
   TaintAccessPathTree propagations_;
   SanitizerSet global_sanitizers_;
-  RootPatriciaTreeAbstractPartition<SanitizerSet> port_sanitizers_;
-  RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_sources_;
-  RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_sinks_;
-  RootPatriciaTreeAbstractPartition<FeatureSet> attach_to_propagations_;
-  RootPatriciaTreeAbstractPartition<FeatureSet> add_features_to_arguments_;
   AccessPathConstantDomain inline_as_getter_;
   SetterAccessPathConstantDomain inline_as_setter_;
-  ModelGeneratorNameSet model_generators_;
-  IssueSet issues_;
+  std::shared_ptr<Cold> MT_NULLABLE cold_;
 };
 
 inline Model::Modes operator|(Model::Mode left, Model::Mode right) {
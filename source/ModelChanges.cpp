@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/Heuristics.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/ModelChanges.h>
+
+namespace marianatrench {
+
+ModelChanges::ModelChanges(bool widen_changing_models)
+    : widen_changing_models_(widen_changing_models) {}
+
+bool ModelChanges::widens(const Method* method) const {
+  return widen_changing_models_ &&
+      changes_.get(method, 0) >= Heuristics::kMaxModelChangesBeforeWidening;
+}
+
+void ModelChanges::record(const Method* method) {
+  if (!widen_changing_models_) {
+    return;
+  }
+
+  std::size_t changes = 0;
+  changes_.update(
+      method,
+      [&changes](
+          const Method* /* method */, std::size_t& count, bool /* exists */) {
+        changes = ++count;
+      });
+  if (changes == Heuristics::kMaxModelChangesBeforeWidening) {
+    LOG(2,
+        "Model of `{}` changed {} times, widening its next models.",
+        method->show(),
+        changes);
+  }
+}
+
+} // namespace marianatrench
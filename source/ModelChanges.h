@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+
+namespace marianatrench {
+
+/**
+ * Number of changes of the model of each method during the fixpoint, with
+ * `--widen-changing-models`.
+ *
+ * Some models keep growing slightly at every analysis, e.g. through features,
+ * origins or deeper paths. After `Heuristics::kMaxModelChangesBeforeWidening`
+ * changes, the new models of the method are widened, which bounds the number of
+ * iterations instead of reaching `Heuristics::kMaxNumberIterations`.
+ */
+class ModelChanges final {
+ public:
+  explicit ModelChanges(bool widen_changing_models);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ModelChanges)
+
+  /* Whether the new models of the given method are widened. */
+  bool widens(const Method* method) const;
+
+  /* Record a change of the model of the given method. This is thread-safe. */
+  void record(const Method* method);
+
+ private:
+  bool widen_changing_models_;
+  ConcurrentMap<const Method*, std::size_t> changes_;
+};
+
+} // namespace marianatrench
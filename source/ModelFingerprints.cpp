@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <boost/functional/hash.hpp>
+#include <fmt/format.h>
+
+#include <mariana-trench/ModelFingerprints.h>
+
+namespace marianatrench {
+
+ModelFingerprints ModelFingerprints::read(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios_base::binary);
+  if (!file.is_open()) {
+    throw std::invalid_argument(
+        fmt::format("Unable to read model fingerprints `{}`.", path.string()));
+  }
+
+  ModelFingerprints fingerprints;
+  std::string line;
+  std::size_t line_number = 0;
+  while (std::getline(file, line)) {
+    line_number++;
+    auto view = std::string_view(line);
+    auto separator = view.find(' ');
+    std::uint64_t hash = 0;
+    auto result = std::from_chars(
+        view.data(),
+        view.data() + std::min(separator, view.size()),
+        hash);
+    if (separator == std::string_view::npos || result.ec != std::errc() ||
+        result.ptr != view.data() + separator) {
+      throw std::invalid_argument(fmt::format(
+          "Invalid model fingerprint in `{}` at line {}.",
+          path.string(),
+          line_number));
+    }
+    fingerprints.set(std::string(view.substr(separator + 1)), hash);
+  }
+  return fingerprints;
+}
+
+void ModelFingerprints::write(const std::filesystem::path& path) const {
+  // Sort the keys, to get a deterministic output.
+  std::vector<const std::pair<const std::string, std::uint64_t>*> entries;
+  entries.reserve(hashes_.size());
+  for (const auto& entry : hashes_) {
+    entries.push_back(&entry);
+  }
+  std::sort(
+      entries.begin(), entries.end(), [](const auto* left, const auto* right) {
+        return left->first < right->first;
+      });
+
+  std::ofstream file(path, std::ios_base::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error(fmt::format(
+        "Unable to write model fingerprints to `{}`.", path.string()));
+  }
+  for (const auto* entry : entries) {
+    file << entry->second << ' ' << entry->first << '\n';
+  }
+}
+
+std::uint64_t ModelFingerprints::hash(const Json::Value& value) {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, static_cast<int>(value.type()));
+  switch (value.type()) {
+    case Json::nullValue:
+      break;
+    case Json::booleanValue:
+      boost::hash_combine(seed, value.asBool());
+      break;
+    case Json::intValue:
+      boost::hash_combine(seed, value.asInt64());
+      break;
+    case Json::uintValue:
+      boost::hash_combine(seed, value.asUInt64());
+      break;
+    case Json::realValue:
+      boost::hash_combine(seed, value.asDouble());
+      break;
+    case Json::stringValue: {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      value.getString(&begin, &end);
+      boost::hash_combine(seed, boost::hash_range(begin, end));
+      break;
+    }
+    case Json::arrayValue: {
+      std::vector<std::uint64_t> element_hashes;
+      element_hashes.reserve(value.size());
+      for (const auto& element : value) {
+        element_hashes.push_back(hash(element));
+      }
+      std::sort(element_hashes.begin(), element_hashes.end());
+      boost::hash_range(seed, element_hashes.begin(), element_hashes.end());
+      break;
+    }
+    case Json::objectValue:
+      // Members are sorted by key.
+      for (auto iterator = value.begin(); iterator != value.end(); ++iterator) {
+        boost::hash_combine(seed, iterator.name());
+        boost::hash_combine(seed, hash(*iterator));
+      }
+      break;
+  }
+  return seed;
+}
+
+void ModelFingerprints::set(std::string key, std::uint64_t hash) {
+  hashes_.insert_or_assign(std::move(key), hash);
+}
+
+std::optional<std::uint64_t> ModelFingerprints::get(
+    const std::string& key) const {
+  auto found = hashes_.find(key);
+  if (found == hashes_.end()) {
+    return std::nullopt;
+  }
+  return found->second;
+}
+
+std::vector<std::string> ModelFingerprints::removed_keys(
+    const ModelFingerprints& previous) const {
+  std::vector<std::string> keys;
+  for (const auto& [key, _hash] : previous.hashes_) {
+    if (hashes_.count(key) == 0) {
+      keys.push_back(key);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Content hashes of the output models of a run, used to only write the models
+ * that changed since a previous run (see `Registry::dump_changed_models`).
+ *
+ * Models are identified by a key made of their kind and name, e.g
+ * `method LClass;.method:()V`, `field LClass;.field:I` or `literal <pattern>`.
+ * The file has one `<hash> <key>` line per model.
+ *
+ * The hash of a model does not depend on the order of array elements in its
+ * json, since the order of frames and features is not deterministic across
+ * runs. This matches `scripts/compare_models.py`.
+ */
+class ModelFingerprints final {
+ public:
+  ModelFingerprints() = default;
+
+  MOVE_CONSTRUCTOR_ONLY(ModelFingerprints)
+
+  /* Throws `std::invalid_argument` on invalid input. */
+  static ModelFingerprints read(const std::filesystem::path& path);
+  void write(const std::filesystem::path& path) const;
+
+  static std::uint64_t hash(const Json::Value& value);
+
+  void set(std::string key, std::uint64_t hash);
+  std::optional<std::uint64_t> get(const std::string& key) const;
+
+  /* Keys of `previous` that are not in this set, in sorted order. */
+  std::vector<std::string> removed_keys(
+      const ModelFingerprints& previous) const;
+
+  std::size_t size() const {
+    return hashes_.size();
+  }
+
+ private:
+  std::unordered_map<std::string, std::uint64_t> hashes_;
+};
+
+} // namespace marianatrench
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -15,11 +16,17 @@
 #include <mariana-trench/Context.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/EventLogger.h>
+#include <mariana-trench/FieldMappings.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/ModelGeneration.h>
+#include <mariana-trench/ModelGeneratorCache.h>
+#include <mariana-trench/OperatingSystem.h>
 #include <mariana-trench/Options.h>
+#include <mariana-trench/Statistics.h>
 #include <mariana-trench/Timer.h>
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/constraints/MethodConstraintMatcher.h>
 #include <mariana-trench/model-generator/BuilderPatternGenerator.h>
 #include <mariana-trench/model-generator/ContentProviderGenerator.h>
 #include <mariana-trench/model-generator/JoinOverrideGenerator.h>
@@ -184,66 +191,132 @@ ModelGeneratorResult ModelGeneration::run(
         boost::algorithm::join(nonexistent_model_generators, ", ")));
   }
 
-  std::vector<Model> generated_models;
-  std::vector<FieldModel> generated_field_models;
-  std::size_t iteration = 0;
+  // Generators reuse the results of the previous run when the code and their
+  // configuration did not change.
+  std::unique_ptr<ModelGeneratorCache> cache;
+  if (const auto& cache_directory = options.analysis_cache_directory()) {
+    cache =
+        std::make_unique<ModelGeneratorCache>(*cache_directory, context.stores);
+    for (const auto& model_generator : model_generators) {
+      model_generator->load_cache(*cache);
+    }
+  }
 
+  // Constraints of generators that visit all methods are evaluated in a
+  // single pass, so that equal constraints are only evaluated once per method.
+  Timer matcher_timer;
+  MethodConstraintMatcher matcher;
   for (const auto& model_generator : model_generators) {
-    Timer generator_timer;
-    LOG(1,
-        "Running model generator `{}` ({}/{})",
-        show(model_generator->name()),
-        ++iteration,
-        model_generators.size());
-
-    auto [models, field_models] = model_generator->run_optimized(
-        *context.methods, method_mappings, *context.fields);
-
-    // Remove models for the `null` method
-    models.erase(
-        std::remove_if(
-            models.begin(),
-            models.end(),
-            [](const Model& model) { return !model.method(); }),
-        models.end());
-    field_models.erase(
-        std::remove_if(
-            field_models.begin(),
-            field_models.end(),
-            [](const FieldModel& field_model) { return !field_model.field(); }),
-        field_models.end());
+    model_generator->share_constraints(matcher, method_mappings);
+  }
+  matcher.run(*context.methods);
+  LOG(1,
+      "Matched shared model generator constraints in {:.2f}s.",
+      matcher_timer.duration_in_seconds());
+
+  // Field constraints are evaluated on their candidates only.
+  FieldMappings field_mappings(*context.fields);
+
+  // Model generators are independent, so they run concurrently. Results are
+  // merged in the order of the configuration to keep the output deterministic.
+  std::vector<ModelGeneratorResult> results(model_generators.size());
+  std::atomic<std::size_t> iteration(0);
+
+  unsigned int threads = sparta::parallel::default_num_threads();
+  if (options.sequential()) {
+    threads = 1u;
+  }
+
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        const auto& model_generator = model_generators[index];
+        Timer generator_timer;
+        double cpu_time_start = thread_cpu_time_in_seconds();
+        LOG(1,
+            "Running model generator `{}` ({}/{})",
+            show(model_generator->name()),
+            ++iteration,
+            model_generators.size());
+
+        auto [models, field_models] = model_generator->run_optimized(
+            *context.methods, method_mappings, *context.fields, field_mappings);
+        if (cache != nullptr) {
+          model_generator->store_cache(*cache);
+        }
 
+        // Remove models for the `null` method
+        models.erase(
+            std::remove_if(
+                models.begin(),
+                models.end(),
+                [](const Model& model) { return !model.method(); }),
+            models.end());
+        field_models.erase(
+            std::remove_if(
+                field_models.begin(),
+                field_models.end(),
+                [](const FieldModel& field_model) {
+                  return !field_model.field();
+                }),
+            field_models.end());
+
+        LOG(1,
+            "  Model generator `{}` generated {} models in {:.2f}s.",
+            show(model_generator->name()),
+            models.size(),
+            generator_timer.duration_in_seconds());
+
+        // Work of nested parallel visits is not included in the CPU time.
+        context.statistics->log_model_generator(ModelGeneratorProfile{
+            /* name */ show(model_generator->name()),
+            /* wall_time */ generator_timer.duration_in_seconds(),
+            /* cpu_time */ thread_cpu_time_in_seconds() - cpu_time_start,
+            /* models */ models.size(),
+            /* field_models */ field_models.size(),
+            /* items */ model_generator->item_profiles()});
+
+        if (generated_models_directory) {
+          // Persist models to file.
+          Timer generator_output_timer;
+          LOG(2,
+              "Writing generated models to `{}`...",
+              *generated_models_directory);
+
+          // Merge models
+          auto registry = Registry(context, models, field_models);
+          JsonValidation::write_json_file(
+              *generated_models_directory + "/" +
+                  model_generator->name()->identifier() + ".json",
+              registry.models_to_json());
+
+          LOG(2,
+              "Wrote {} generated models to `{}` in {:.2f}s.",
+              registry.models_size(),
+              *generated_models_directory,
+              generator_output_timer.duration_in_seconds());
+        }
+
+        results[index] = {
+            /* method_models */ std::move(models),
+            /* field_models */ std::move(field_models)};
+      },
+      threads);
+  for (std::size_t index = 0; index < model_generators.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+
+  std::vector<Model> generated_models;
+  std::vector<FieldModel> generated_field_models;
+  for (auto& [models, field_models] : results) {
     generated_models.insert(
-        generated_models.end(), models.begin(), models.end());
+        generated_models.end(),
+        std::make_move_iterator(models.begin()),
+        std::make_move_iterator(models.end()));
     generated_field_models.insert(
-        generated_field_models.end(), field_models.begin(), field_models.end());
-
-    LOG(1,
-        "  Model generator `{}` generated {} models in {:.2f}s.",
-        show(model_generator->name()),
-        models.size(),
-        generator_timer.duration_in_seconds());
-
-    if (generated_models_directory) {
-      // Persist models to file.
-      Timer generator_output_timer;
-      LOG(2,
-          "Writing generated models to `{}`...",
-          *generated_models_directory);
-
-      // Merge models
-      auto registry = Registry(context, models, field_models);
-      JsonValidation::write_json_file(
-          *generated_models_directory + "/" +
-              model_generator->name()->identifier() + ".json",
-          registry.models_to_json());
-
-      LOG(2,
-          "Wrote {} generated models to `{}` in {:.2f}s.",
-          registry.models_size(),
-          *generated_models_directory,
-          generator_output_timer.duration_in_seconds());
-    }
+        generated_field_models.end(),
+        std::make_move_iterator(field_models.begin()),
+        std::make_move_iterator(field_models.end()));
   }
 
   return {
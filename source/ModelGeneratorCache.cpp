@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/GraphSnapshot.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/ModelGeneratorCache.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the model generators or the format changes.
+constexpr int k_version = 1;
+
+} // namespace
+
+ModelGeneratorCache::ModelGeneratorCache(
+    const std::filesystem::path& cache_directory,
+    const DexStoresVector& stores)
+    : directory_(cache_directory / "model_generators"),
+      fingerprint_(GraphSnapshot::code_fingerprint(stores)) {}
+
+std::optional<ModelGeneratorCache::Matches> ModelGeneratorCache::load(
+    const ModelGeneratorName* name,
+    std::size_t configuration_hash,
+    Context& context) const {
+  auto path = this->path(name);
+  if (!std::filesystem::exists(path)) {
+    LOG(3, "No cached matches for model generator `{}`.", show(name));
+    return std::nullopt;
+  }
+
+  try {
+    auto value = JsonValidation::parse_json_file(path);
+    JsonValidation::validate_object(value);
+    if (JsonValidation::integer(value, /* field */ "version") != k_version ||
+        JsonValidation::string(value, /* field */ "fingerprint") !=
+            fingerprint_ ||
+        JsonValidation::string(value, /* field */ "configuration") !=
+            std::to_string(configuration_hash)) {
+      LOG(2,
+          "Cached matches for model generator `{}` are outdated, ignoring them.",
+          show(name));
+      return std::nullopt;
+    }
+
+    Matches matches;
+    for (const auto& item_value :
+         JsonValidation::null_or_array(value, /* field */ "methods")) {
+      auto& methods = matches.methods.emplace_back();
+      for (const auto& method_value : JsonValidation::null_or_array(item_value)) {
+        methods.push_back(Method::from_json(method_value, context));
+      }
+    }
+    for (const auto& item_value :
+         JsonValidation::null_or_array(value, /* field */ "fields")) {
+      auto& fields = matches.fields.emplace_back();
+      for (const auto& field_value : JsonValidation::null_or_array(item_value)) {
+        fields.push_back(Field::from_json(field_value, context));
+      }
+    }
+
+    LOG(2, "Loaded cached matches for model generator `{}`.", show(name));
+    return matches;
+  } catch (const JsonValidationError& error) {
+    WARNING(
+        1,
+        "Unable to read cached matches for model generator `{}`: {}",
+        show(name),
+        error.what());
+    return std::nullopt;
+  }
+}
+
+void ModelGeneratorCache::store(
+    const ModelGeneratorName* name,
+    std::size_t configuration_hash,
+    const Matches& matches) const {
+  auto methods_value = Json::Value(Json::arrayValue);
+  for (const auto& methods : matches.methods) {
+    auto item_value = Json::Value(Json::arrayValue);
+    for (const auto* method : methods) {
+      item_value.append(method->to_json());
+    }
+    methods_value.append(item_value);
+  }
+
+  auto fields_value = Json::Value(Json::arrayValue);
+  for (const auto& fields : matches.fields) {
+    auto item_value = Json::Value(Json::arrayValue);
+    for (const auto* field : fields) {
+      item_value.append(field->to_json());
+    }
+    fields_value.append(item_value);
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["version"] = k_version;
+  value["fingerprint"] = fingerprint_;
+  value["configuration"] = std::to_string(configuration_hash);
+  value["methods"] = methods_value;
+  value["fields"] = fields_value;
+
+  std::filesystem::create_directories(directory_);
+  JsonValidation::write_json_file(path(name), value);
+}
+
+std::filesystem::path ModelGeneratorCache::path(
+    const ModelGeneratorName* name) const {
+  return directory_ / (name->identifier() + ".json");
+}
+
+} // namespace marianatrench
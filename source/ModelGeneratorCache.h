@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <DexStore.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/Field.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/model-generator/ModelGeneratorName.h>
+
+namespace marianatrench {
+
+/**
+ * Cache of the methods and fields matched by model generators across runs.
+ *
+ * Matching the constraints of a generator against all methods dominates the
+ * cost of model generation, while instantiating the model templates for the
+ * matched methods is cheap. Hence this stores the matches of each item of a
+ * generator, rather than the models themselves.
+ *
+ * Constraints may depend on the class hierarchy and on the code of methods, so
+ * entries are only valid for the exact same code and generator configuration.
+ */
+class ModelGeneratorCache final {
+ public:
+  /* Methods and fields matched by each item of a generator, in order. */
+  struct Matches {
+    std::vector<std::vector<const Method*>> methods;
+    std::vector<std::vector<const Field*>> fields;
+  };
+
+ public:
+  explicit ModelGeneratorCache(
+      const std::filesystem::path& cache_directory,
+      const DexStoresVector& stores);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ModelGeneratorCache)
+
+  /**
+   * Read the matches of the given generator. Return `std::nullopt` if they do
+   * not exist or were computed for different code or configuration.
+   */
+  std::optional<Matches> load(
+      const ModelGeneratorName* name,
+      std::size_t configuration_hash,
+      Context& context) const;
+
+  /* This is thread-safe for different generators. */
+  void store(
+      const ModelGeneratorName* name,
+      std::size_t configuration_hash,
+      const Matches& matches) const;
+
+ private:
+  std::filesystem::path path(const ModelGeneratorName* name) const;
+
+ private:
+  std::filesystem::path directory_;
+  std::string fingerprint_;
+};
+
+} // namespace marianatrench
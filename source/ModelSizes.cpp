@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <mariana-trench/EventLogger.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/ModelSizes.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+namespace {
+
+template <typename Visitor>
+void visit_taint_trees(const Model& model, Visitor&& visitor) {
+  for (const auto* tree :
+       {&model.generations(),
+        &model.parameter_sources(),
+        &model.sinks(),
+        &model.call_effect_sources(),
+        &model.call_effect_sinks(),
+        &model.propagations()}) {
+    tree->visit(visitor);
+  }
+}
+
+} // namespace
+
+ModelSize ModelSize::from_model(const Model& model) {
+  ModelSize size;
+  visit_taint_trees(
+      model, [&size](const AccessPath& access_path, const Taint& taint) {
+        if (taint.is_bottom()) {
+          return;
+        }
+        auto frames = taint.num_frames();
+        size.frames += frames;
+        size.frames_per_port[access_path.root().to_string()] += frames;
+        size.leaves++;
+        size.maximum_depth =
+            std::max(size.maximum_depth, access_path.path().size());
+        taint.visit_frames(
+            [&size](const CallInfo& /* call_info */, const Frame& frame) {
+              size.features += frame.inferred_features().may().size() +
+                  frame.user_features().size();
+              size.origins += frame.origins().size();
+            });
+      });
+  size.issues = model.issues().size();
+  return size;
+}
+
+std::size_t ModelSize::number_of_frames(const Model& model) {
+  std::size_t frames = 0;
+  visit_taint_trees(
+      model,
+      [&frames](const AccessPath& /* access_path */, const Taint& taint) {
+        frames += taint.num_frames();
+      });
+  return frames;
+}
+
+Json::Value ModelSize::to_json() const {
+  auto value = Json::Value(Json::objectValue);
+  value["frames"] = Json::Value(static_cast<Json::UInt64>(frames));
+  auto ports = Json::Value(Json::objectValue);
+  for (const auto& [port, port_frames] : frames_per_port) {
+    ports[port] = Json::Value(static_cast<Json::UInt64>(port_frames));
+  }
+  value["frames_per_port"] = ports;
+  value["leaves"] = Json::Value(static_cast<Json::UInt64>(leaves));
+  value["maximum_depth"] =
+      Json::Value(static_cast<Json::UInt64>(maximum_depth));
+  value["features"] = Json::Value(static_cast<Json::UInt64>(features));
+  value["origins"] = Json::Value(static_cast<Json::UInt64>(origins));
+  value["issues"] = Json::Value(static_cast<Json::UInt64>(issues));
+  return value;
+}
+
+ModelSizes::ModelSizes(std::optional<std::size_t> warning_threshold)
+    : warning_threshold_(warning_threshold) {}
+
+void ModelSizes::add(const Method* method, const Model& model) {
+  auto frames = ModelSize::number_of_frames(model);
+  auto recorded_frames = static_cast<std::uint32_t>(std::min<std::size_t>(
+      frames, std::numeric_limits<std::uint32_t>::max()));
+
+  bool warn = false;
+  records_.update(
+      method,
+      [&](const Method* /* method */, Record& record, bool /* exists */) {
+        record.frames_per_analysis.push_back(recorded_frames);
+        if (warning_threshold_ && frames > *warning_threshold_ &&
+            !record.warned) {
+          record.warned = true;
+          warn = true;
+        }
+      });
+
+  if (warn) {
+    WARNING(
+        1,
+        "Model of `{}` has {} frames, above the threshold of {}.",
+        method->show(),
+        frames,
+        *warning_threshold_);
+    EventLogger::log_event(
+        "large_model",
+        /* message */ method->show(),
+        /* value */
+        static_cast<int>(std::min<std::size_t>(
+            frames, std::numeric_limits<int>::max())));
+  }
+}
+
+std::vector<std::uint32_t> ModelSizes::growth(const Method* method) const {
+  return records_.get(method, Record{}).frames_per_analysis;
+}
+
+Json::Value ModelSizes::to_json(const Registry& registry) const {
+  std::vector<std::pair<const Method*, const Record*>> largest;
+  largest.reserve(records_.size());
+  for (const auto& [method, record] : records_) {
+    largest.emplace_back(method, &record);
+  }
+  // Largest final models first, then by signature for a deterministic output.
+  auto compare = [](const auto& left, const auto& right) {
+    auto left_frames = left.second->frames_per_analysis.back();
+    auto right_frames = right.second->frames_per_analysis.back();
+    if (left_frames != right_frames) {
+      return left_frames > right_frames;
+    }
+    return left.first->signature() < right.first->signature();
+  };
+  auto size = std::min(largest.size(), kRecordLargestModels);
+  std::partial_sort(
+      largest.begin(), largest.begin() + size, largest.end(), compare);
+  largest.resize(size);
+
+  auto value = Json::Value(Json::arrayValue);
+  for (const auto& [method, record] : largest) {
+    auto model_value = ModelSize::from_model(registry.get(method)).to_json();
+    model_value["method"] = Json::Value(method->show());
+    auto growth = Json::Value(Json::arrayValue);
+    for (auto frames : record->frames_per_analysis) {
+      growth.append(Json::Value(static_cast<Json::UInt64>(frames)));
+    }
+    model_value["frames_per_analysis"] = growth;
+    value.append(model_value);
+  }
+  return value;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+
+namespace marianatrench {
+
+class Registry;
+
+/* Measures of the size of a model. */
+struct ModelSize {
+  std::size_t frames = 0;
+  /* Number of frames per root of the taint trees (e.g, `Argument(1)`). */
+  std::map<std::string, std::size_t> frames_per_port;
+  /* Number of non-empty nodes of the taint trees. */
+  std::size_t leaves = 0;
+  /* Length of the longest path of the taint trees. */
+  std::size_t maximum_depth = 0;
+  /* Number of features and origins, summed over all frames. */
+  std::size_t features = 0;
+  std::size_t origins = 0;
+  std::size_t issues = 0;
+
+  static ModelSize from_model(const Model& model);
+
+  /* Number of frames across all taint trees, without computing other sizes. */
+  static std::size_t number_of_frames(const Model& model);
+
+  Json::Value to_json() const;
+};
+
+/**
+ * Sizes of the models computed during the analysis, enabled with
+ * `--track-model-sizes` or `--model-size-warning-threshold`.
+ *
+ * Only the number of frames after each analysis of a method is recorded, to
+ * track the growth of its model. Detailed sizes are computed on the final
+ * models of the largest ones, when writing the metadata.
+ */
+class ModelSizes final {
+ public:
+  explicit ModelSizes(std::optional<std::size_t> warning_threshold);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ModelSizes)
+
+  /**
+   * Record the size of the model of the given method after an analysis. Warns
+   * the first time the model of a method exceeds the warning threshold. This
+   * is thread-safe.
+   */
+  void add(const Method* method, const Model& model);
+
+  /* Number of frames after each analysis of the given method. */
+  std::vector<std::uint32_t> growth(const Method* method) const;
+
+  /* Sizes and growth of the `kRecordLargestModels` largest models. */
+  Json::Value to_json(const Registry& registry) const;
+
+  /* Maximum number of largest models to record. */
+  constexpr static std::size_t kRecordLargestModels = 20;
+
+ private:
+  struct Record {
+    std::vector<std::uint32_t> frames_per_analysis;
+    bool warned = false;
+  };
+
+  std::optional<std::size_t> warning_threshold_;
+  ConcurrentMap<const Method*, Record> records_;
+};
+
+} // namespace marianatrench
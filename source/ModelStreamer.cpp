@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fmt/format.h>
+
+#include <mariana-trench/Filesystem.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/ModelStreamer.h>
+#include <mariana-trench/PostprocessTraces.h>
+
+namespace marianatrench {
+
+ModelStreamer::ModelStreamer(
+    const Context& context,
+    std::filesystem::path output_directory,
+    std::size_t batch_size,
+    int compression_level)
+    : context_(context),
+      output_directory_(std::move(output_directory)),
+      batch_size_(batch_size),
+      compression_level_(compression_level),
+      number_shards_(0),
+      pending_models_(0) {
+  filesystem::remove_files_with_prefix(output_directory_, "model@");
+}
+
+void ModelStreamer::stream_component(
+    Registry& registry,
+    const std::vector<const Method*>& component) {
+  PostprocessTraces::remove_collapsed_traces(registry, context_, component);
+
+  thread_local JsonWriter writer;
+  std::string lines;
+  for (const auto* method : component) {
+    auto model = registry.get_snapshot(method);
+    writer.clear();
+    model->write_json(writer, context_);
+    lines.append(writer.str());
+    lines.push_back('\n');
+    streamed_methods_.insert(method);
+  }
+
+  std::string shard_lines;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_lines_.append(lines);
+    pending_models_ += component.size();
+    if (pending_models_ < batch_size_) {
+      return;
+    }
+    shard_lines.swap(pending_lines_);
+    pending_models_ = 0;
+  }
+
+  // Write outside of the lock, this overlaps with the analysis of other
+  // components.
+  write_shard(std::move(shard_lines));
+}
+
+void ModelStreamer::finish(const Registry& registry) {
+  if (!pending_lines_.empty()) {
+    write_shard(std::move(pending_lines_));
+    pending_lines_.clear();
+    pending_models_ = 0;
+  }
+  LOG(1,
+      "Streamed {} models to {} shards.",
+      streamed_methods_.size(),
+      number_shards_.load());
+
+  registry.dump_remaining_models(
+      output_directory_,
+      "model@remaining-",
+      streamed_methods_,
+      batch_size_,
+      compression_level_);
+}
+
+void ModelStreamer::write_shard(std::string lines) {
+  auto shard = number_shards_++;
+  auto path = output_directory_ /
+      fmt::format("model@streamed-{:0>5}{}",
+                  shard,
+                  JsonValidation::json_lines_extension(compression_level_));
+  JsonValidation::write_json_lines_file(
+      path,
+      [&lines](std::ostream& output) { output << lines; },
+      compression_level_);
+}
+
+} // namespace marianatrench
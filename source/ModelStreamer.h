@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Writes the models of stable components to the output shards while the
+ * strongly connected components fixpoint is still running, with
+ * `--stream-models`.
+ *
+ * Once a component and all its callees are stable, the models of the
+ * component are final: they are postprocessed with
+ * `PostprocessTraces::remove_collapsed_traces` and written as json lines.
+ * Shards are named `model@streamed-XXXXX.json` in completion order, and
+ * `finish` writes the models that were not streamed (fields, literals and
+ * methods outside of the schedule) in `model@remaining-XXXXX-of-YYYYY.json`.
+ */
+class ModelStreamer final {
+ public:
+  /* Remove the existing model shards under `output_directory`. */
+  ModelStreamer(
+      const Context& context,
+      std::filesystem::path output_directory,
+      std::size_t batch_size,
+      int compression_level);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ModelStreamer)
+
+  /**
+   * Postprocess and write the models of a stable component. This must be
+   * called before the dependent components are analyzed. This is thread-safe.
+   */
+  void stream_component(
+      Registry& registry,
+      const std::vector<const Method*>& component);
+
+  /* Write the pending and remaining models. */
+  void finish(const Registry& registry);
+
+  std::size_t streamed_models_size() const {
+    return streamed_methods_.size();
+  }
+
+ private:
+  void write_shard(std::string lines);
+
+ private:
+  const Context& context_;
+  std::filesystem::path output_directory_;
+  std::size_t batch_size_;
+  int compression_level_;
+
+  ConcurrentSet<const Method*> streamed_methods_;
+  std::atomic<std::size_t> number_shards_;
+
+  std::mutex pending_mutex_;
+  std::string pending_lines_;
+  std::size_t pending_models_;
+};
+
+} // namespace marianatrench
@@ -5,7 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <string>
+#include <utility>
 
 #include <boost/algorithm/string.hpp>
 
@@ -16,6 +22,13 @@
 #include <mach/mach.h>
 #include <mach/mach_init.h>
 #include <mach/mach_types.h>
+#elif __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
 #endif
 
 namespace marianatrench {
@@ -49,4 +62,129 @@ double resident_set_size_in_gb() {
   return -1.0;
 }
 
+double thread_cpu_time_in_seconds() {
+  struct timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+    ERROR(1, "Call to `clock_gettime()` failed");
+    return -1.0;
+  }
+  return static_cast<double>(time.tv_sec) +
+      static_cast<double>(time.tv_nsec) / 1000.0 / 1000.0 / 1000.0;
+}
+
+std::vector<std::vector<int>> numa_node_cpus() {
+  std::vector<std::vector<int>> nodes;
+#if __linux__
+  try {
+    // Node directories are named `node<id>`, identifiers may not be
+    // contiguous.
+    std::vector<std::pair<int, std::filesystem::path>> node_paths;
+    for (const auto& entry :
+         std::filesystem::directory_iterator("/sys/devices/system/node")) {
+      auto name = entry.path().filename().string();
+      if (boost::starts_with(name, "node") && name.size() > 4 &&
+          std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+        node_paths.emplace_back(std::stoi(name.substr(4)), entry.path());
+      }
+    }
+    std::sort(node_paths.begin(), node_paths.end());
+
+    for (const auto& [node, path] : node_paths) {
+      // The list of CPUs is formatted as ranges, e.g `0-15,32-47`.
+      std::ifstream infile(path / "cpulist");
+      std::string line;
+      std::getline(infile, line);
+      boost::trim(line);
+      std::vector<int> cpus;
+      std::vector<std::string> ranges;
+      boost::split(ranges, line, boost::is_any_of(","));
+      for (const auto& range : ranges) {
+        if (range.empty()) {
+          continue;
+        }
+        auto separator = range.find('-');
+        int first = std::stoi(range.substr(0, separator));
+        int last = separator == std::string::npos
+            ? first
+            : std::stoi(range.substr(separator + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+          cpus.push_back(cpu);
+        }
+      }
+      // Memory-only nodes have no CPU.
+      if (!cpus.empty()) {
+        nodes.push_back(std::move(cpus));
+      }
+    }
+  } catch (const std::exception& error) {
+    ERROR(1, "Failed to read `/sys/devices/system/node`: {}", error.what());
+    nodes.clear();
+  }
+#endif
+  return nodes;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+  return pin_thread(current_thread_handle(), cpus);
+}
+
+std::thread::native_handle_type current_thread_handle() {
+#if __linux__
+  return pthread_self();
+#else
+  return std::thread::native_handle_type();
+#endif
+}
+
+std::vector<int> current_thread_cpus() {
+  std::vector<int> cpus;
+#if __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  int error = pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+  if (error != 0) {
+    ERROR(1, "Call to `pthread_getaffinity_np()` failed");
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+#endif
+  return cpus;
+}
+
+bool pin_thread(
+    std::thread::native_handle_type thread,
+    const std::vector<int>& cpus) {
+#if __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  int error = pthread_setaffinity_np(thread, sizeof(set), &set);
+  if (error == 0) {
+    return true;
+  }
+  ERROR(1, "Call to `pthread_setaffinity_np()` failed");
+#else
+  (void)thread;
+  (void)cpus;
+#endif
+  return false;
+}
+
+bool trim_allocator_memory() {
+#if defined(__GLIBC__)
+  malloc_trim(/* pad */ 0);
+  return true;
+#else
+  return false;
+#endif
+}
+
 } // namespace marianatrench
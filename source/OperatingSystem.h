@@ -5,9 +5,44 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <thread>
+#include <vector>
+
 namespace marianatrench {
 
 /* Returns -1 for unsupported operating systems. */
 double resident_set_size_in_gb();
 
+/* CPU time consumed by the calling thread, in seconds. */
+double thread_cpu_time_in_seconds();
+
+/*
+ * Identifiers of the CPUs of each NUMA node, in the order of the nodes.
+ * Returns an empty vector for unsupported operating systems.
+ */
+std::vector<std::vector<int>> numa_node_cpus();
+
+/* Restrict the calling thread to the given CPUs. Returns false on failure. */
+bool pin_current_thread(const std::vector<int>& cpus);
+
+/* Handle of the calling thread, e.g. to pin it from another thread. */
+std::thread::native_handle_type current_thread_handle();
+
+/*
+ * CPUs the calling thread may run on. Returns an empty vector on failure or for
+ * unsupported operating systems.
+ */
+std::vector<int> current_thread_cpus();
+
+/* Restrict the given thread to the given CPUs. Returns false on failure. */
+bool pin_thread(
+    std::thread::native_handle_type thread,
+    const std::vector<int>& cpus);
+
+/*
+ * Return the free memory of the allocator to the operating system.
+ * Returns false for unsupported allocators.
+ */
+bool trim_allocator_memory();
+
 } // namespace marianatrench
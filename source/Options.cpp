@@ -112,7 +112,10 @@ Options::Options(
     const std::string& source_root_directory,
     bool enable_cross_component_analysis,
     ExportOriginsMode export_origins_mode,
-    bool propagate_across_arguments)
+    bool propagate_across_arguments,
+    bool enable_worklist_fixpoint,
+    bool enable_scc_fixpoint,
+    bool deterministic)
     : models_paths_(models_paths),
       field_models_paths_(field_models_paths),
       literal_models_paths_(literal_models_paths),
@@ -130,7 +133,10 @@ Options::Options(
       remove_unreachable_code_(remove_unreachable_code),
       disable_parameter_type_overrides_(false),
       disable_global_type_analysis_(false),
+      disable_class_intervals_(false),
       maximum_method_analysis_time_(std::nullopt),
+      maximum_analysis_time_(std::nullopt),
+      maximum_cached_type_environments_(std::nullopt),
       maximum_source_sink_distance_(10),
       emit_all_via_cast_features_(emit_all_via_cast_features),
       allow_via_cast_features_({}),
@@ -141,9 +147,59 @@ Options::Options(
       dump_dependencies_(false),
       dump_methods_(false),
       dump_coverage_info_(false),
+      dump_trace_(false),
+      dump_method_profiles_(false),
+      track_model_sizes_(false),
+      model_size_warning_threshold_(std::nullopt),
+      convergence_report_(false),
+      partitions_(std::nullopt),
+      shards_(std::nullopt),
+      shard_index_(std::nullopt),
+      merge_shards_(false),
+      shard_directory_(std::nullopt),
+      collect_cache_statistics_(false),
+      write_status_(false),
+      status_interval_(10),
+      memory_accounting_(false),
+      memory_accounting_sampling_rate_(1),
+      sample_analyzed_methods_(false),
+      sampling_frequency_(99),
+      binary_model_output_(false),
+      output_compression_level_(0),
+      stream_models_(false),
+      resident_set_size_target_(std::nullopt),
+      dump_model_fingerprints_(false),
+      output_string_tables_(false),
+      dump_issues_(false),
+      dump_model_index_(false),
       enable_cross_component_analysis_(enable_cross_component_analysis),
       export_origins_mode_(export_origins_mode),
-      propagate_across_arguments_(propagate_across_arguments) {}
+      propagate_across_arguments_(propagate_across_arguments),
+      enable_worklist_fixpoint_(enable_worklist_fixpoint),
+      enable_scc_fixpoint_(enable_scc_fixpoint),
+      enable_alias_analysis_cache_(false),
+      enable_callsite_model_cache_(false),
+      release_control_flow_graphs_(false),
+      intern_stable_frames_(false),
+      checkpoint_interval_(std::nullopt),
+      daemon_(false),
+      pin_worker_threads_(false),
+      deterministic_(deterministic),
+      tiered_analysis_(false),
+      sparse_taint_analysis_(false),
+      relevance_prescan_(false),
+      fuse_forward_analyses_(false),
+      incremental_reanalysis_(false),
+      prune_unreachable_methods_(false),
+      source_sink_slicing_(false),
+      maximum_parameter_type_overrides_(std::nullopt),
+      previous_method_profiles_directory_(std::nullopt),
+      trim_allocator_memory_(false),
+      parallel_taint_analysis_minimum_blocks_(std::nullopt),
+      maximum_callsite_model_cache_entries_(std::nullopt),
+      skip_call_site_origins_(false),
+      dry_run_model_generation_(false),
+      widen_changing_models_(false) {}
 
 Options::Options(const boost::program_options::variables_map& variables) {
   system_jar_paths_ = parse_paths_list(
@@ -170,6 +226,16 @@ Options::Options(const boost::program_options::variables_map& variables) {
         variables["literal-models-paths"].as<std::string>(),
         /* extension */ ".json");
   }
+  if (!variables["library-models-paths"].empty()) {
+    library_models_paths_ = parse_paths_list(
+        variables["library-models-paths"].as<std::string>(),
+        /* extension */ ".json");
+  }
+  if (!variables["library-summaries-paths"].empty()) {
+    library_summaries_paths_ = parse_paths_list(
+        variables["library-summaries-paths"].as<std::string>(),
+        /* extension */ ".json");
+  }
   rules_paths_ = parse_paths_list(
       variables["rules-paths"].as<std::string>(), /* extension */ ".json");
 
@@ -203,6 +269,16 @@ Options::Options(const boost::program_options::variables_map& variables) {
         variables["generated-models-directory"].as<std::string>());
   }
 
+  if (!variables["analysis-cache-directory"].empty()) {
+    analysis_cache_directory_ = check_path_exists(
+        variables["analysis-cache-directory"].as<std::string>());
+  }
+
+  if (!variables["precomputed-graphs-directory"].empty()) {
+    precomputed_graphs_directory_ = check_path_exists(
+        variables["precomputed-graphs-directory"].as<std::string>());
+  }
+
   generator_configuration_paths_ = parse_paths_list(
       variables["model-generator-configuration-paths"].as<std::string>(),
       /* extension */ ".json");
@@ -242,6 +318,7 @@ Options::Options(const boost::program_options::variables_map& variables) {
       variables.count("disable-parameter-type-overrides") > 0;
   disable_global_type_analysis_ =
       variables.count("disable-global-type-analysis") > 0;
+  disable_class_intervals_ = variables.count("disable-class-intervals") > 0;
   remove_unreachable_code_ = variables.count("remove-unreachable-code") > 0;
 
   maximum_method_analysis_time_ =
@@ -249,6 +326,14 @@ Options::Options(const boost::program_options::variables_map& variables) {
       ? std::nullopt
       : std::make_optional<int>(
             variables["maximum-method-analysis-time"].as<int>());
+  maximum_analysis_time_ = variables.count("maximum-analysis-time") == 0
+      ? std::nullopt
+      : std::make_optional<int>(variables["maximum-analysis-time"].as<int>());
+  maximum_cached_type_environments_ =
+      variables.count("maximum-cached-type-environments") == 0
+      ? std::nullopt
+      : std::make_optional<int>(
+            variables["maximum-cached-type-environments"].as<int>());
   maximum_source_sink_distance_ =
       variables["maximum-source-sink-distance"].as<int>();
   emit_all_via_cast_features_ =
@@ -272,6 +357,91 @@ Options::Options(const boost::program_options::variables_map& variables) {
   dump_dependencies_ = variables.count("dump-dependencies") > 0;
   dump_methods_ = variables.count("dump-methods") > 0;
   dump_coverage_info_ = variables.count("dump-coverage-info") > 0;
+  dump_trace_ = variables.count("dump-trace") > 0;
+  dump_method_profiles_ = variables.count("dump-method-profiles") > 0;
+  model_size_warning_threshold_ =
+      variables.count("model-size-warning-threshold") == 0
+      ? std::nullopt
+      : std::make_optional<int>(
+            variables["model-size-warning-threshold"].as<int>());
+  track_model_sizes_ = variables.count("track-model-sizes") > 0 ||
+      model_size_warning_threshold_.has_value();
+  convergence_report_ = variables.count("convergence-report") > 0;
+  partitions_ = variables.count("partitions") == 0
+      ? std::nullopt
+      : std::make_optional<int>(variables["partitions"].as<int>());
+  if (partitions_ && *partitions_ <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Number of partitions must be positive, got {}.", *partitions_));
+  }
+  shards_ = variables.count("shards") == 0
+      ? std::nullopt
+      : std::make_optional<int>(variables["shards"].as<int>());
+  shard_index_ = variables.count("shard-index") == 0
+      ? std::nullopt
+      : std::make_optional<int>(variables["shard-index"].as<int>());
+  merge_shards_ = variables.count("merge-shards") > 0;
+  if (!variables["shard-directory"].empty()) {
+    shard_directory_ =
+        check_directory_exists(variables["shard-directory"].as<std::string>());
+  }
+  if (shards_) {
+    if (*shards_ <= 0) {
+      throw std::invalid_argument(fmt::format(
+          "Number of shards must be positive, got {}.", *shards_));
+    }
+    if (!shard_directory_) {
+      throw std::invalid_argument(
+          "Option `--shards` requires `--shard-directory`.");
+    }
+    if (shard_index_.has_value() == merge_shards_) {
+      throw std::invalid_argument(
+          "Option `--shards` requires either `--shard-index` or `--merge-shards`.");
+    }
+    if (shard_index_ && (*shard_index_ < 0 || *shard_index_ >= *shards_)) {
+      throw std::invalid_argument(fmt::format(
+          "Shard index must be between 0 and {}, got {}.",
+          *shards_ - 1,
+          *shard_index_));
+    }
+  } else if (shard_index_ || merge_shards_) {
+    throw std::invalid_argument(
+        "Options `--shard-index` and `--merge-shards` require `--shards`.");
+  }
+  if (!variables["summarize-library"].empty()) {
+    summarize_library_ =
+        variables["summarize-library"].as<std::vector<std::string>>();
+  }
+  collect_cache_statistics_ = variables.count("collect-cache-statistics") > 0;
+  write_status_ = variables.count("write-status") > 0;
+  status_interval_ = variables["status-interval"].as<int>();
+  if (status_interval_ <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Status interval must be positive, got {}.", status_interval_));
+  }
+  memory_accounting_ = variables.count("memory-accounting") > 0;
+  memory_accounting_sampling_rate_ =
+      variables["memory-accounting-sampling-rate"].as<int>();
+  if (memory_accounting_sampling_rate_ <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Memory accounting sampling rate must be positive, got {}.",
+        memory_accounting_sampling_rate_));
+  }
+  sample_analyzed_methods_ = variables.count("sample-analyzed-methods") > 0;
+  sampling_frequency_ = variables["sampling-frequency"].as<int>();
+  if (sampling_frequency_ <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Sampling frequency must be positive, got {}.", sampling_frequency_));
+  }
+  binary_model_output_ = variables.count("binary-model-output") > 0;
+  output_compression_level_ = variables.count("output-compression-level") > 0
+      ? variables["output-compression-level"].as<int>()
+      : 0;
+  if (output_compression_level_ < 0 || output_compression_level_ > 9) {
+    throw std::invalid_argument(fmt::format(
+        "Output compression level must be between 0 and 9, got {}.",
+        output_compression_level_));
+  }
 
   job_id_ = variables.count("job-id") == 0
       ? std::nullopt
@@ -288,6 +458,195 @@ Options::Options(const boost::program_options::variables_map& variables) {
       : ExportOriginsMode::OnlyOnOrigins;
   propagate_across_arguments_ =
       variables.count("propagate-across-arguments") > 0;
+  enable_worklist_fixpoint_ = variables.count("enable-worklist-fixpoint") > 0;
+  enable_scc_fixpoint_ = variables.count("enable-scc-fixpoint") > 0;
+  if (enable_worklist_fixpoint_ && enable_scc_fixpoint_) {
+    throw std::invalid_argument(
+        "Options `--enable-worklist-fixpoint` and `--enable-scc-fixpoint` are mutually exclusive.");
+  }
+  stream_models_ = variables.count("stream-models") > 0;
+  if (stream_models_ && !enable_scc_fixpoint_) {
+    throw std::invalid_argument(
+        "Option `--stream-models` requires `--enable-scc-fixpoint`.");
+  }
+  if (stream_models_ && binary_model_output_) {
+    throw std::invalid_argument(
+        "Options `--stream-models` and `--binary-model-output` are mutually exclusive.");
+  }
+  // Highlights are added to callee models from the issues of their callers,
+  // hence models are not final when their component is stable.
+  if (stream_models_ && !skip_source_indexing_) {
+    throw std::invalid_argument(
+        "Option `--stream-models` requires `--skip-source-indexing`.");
+  }
+  resident_set_size_target_ = variables.count("resident-set-size-target") == 0
+      ? std::nullopt
+      : std::make_optional<double>(
+            variables["resident-set-size-target"].as<double>());
+  if (resident_set_size_target_) {
+    if (*resident_set_size_target_ <= 0.0) {
+      throw std::invalid_argument(fmt::format(
+          "Resident set size target must be positive, got {}.",
+          *resident_set_size_target_));
+    }
+    // Evicted models are only written by the model streamer, and cannot be
+    // read by later phases.
+    if (!stream_models_) {
+      throw std::invalid_argument(
+          "Option `--resident-set-size-target` requires `--stream-models`.");
+    }
+  }
+  if (!variables["previous-model-fingerprints"].empty()) {
+    previous_model_fingerprints_path_ = check_path_exists(
+        variables["previous-model-fingerprints"].as<std::string>());
+  }
+  dump_model_fingerprints_ = variables.count("dump-model-fingerprints") > 0 ||
+      previous_model_fingerprints_path_.has_value();
+  if (dump_model_fingerprints_ && (stream_models_ || binary_model_output_)) {
+    throw std::invalid_argument(
+        "Model fingerprints are not supported with `--stream-models` or `--binary-model-output`.");
+  }
+  output_string_tables_ = variables.count("output-string-tables") > 0;
+  if (output_string_tables_ && (stream_models_ || binary_model_output_)) {
+    throw std::invalid_argument(
+        "Option `--output-string-tables` is not supported with `--stream-models` or `--binary-model-output`.");
+  }
+  dump_issues_ = variables.count("dump-issues") > 0;
+  dump_model_index_ = variables.count("dump-model-index") > 0;
+  // Only the model streamer, the metadata and the coverage are checked to
+  // handle evicted models, see `Registry::evict`. Other readers of the models
+  // after the fixpoint would throw.
+  if (resident_set_size_target_ &&
+      (analysis_cache_directory_ || track_model_sizes_ ||
+       !summarize_library_.empty() || shards_ || dump_issues_)) {
+    throw std::invalid_argument(
+        "Option `--resident-set-size-target` is not supported with `--analysis-cache-directory`, `--track-model-sizes`, `--summarize-library`, `--shards` or `--dump-issues`.");
+  }
+  if (dump_model_index_ &&
+      (stream_models_ || binary_model_output_ || dump_model_fingerprints_)) {
+    throw std::invalid_argument(
+        "Option `--dump-model-index` is not supported with `--stream-models`, `--binary-model-output` or model fingerprints.");
+  }
+  enable_alias_analysis_cache_ =
+      variables.count("enable-alias-analysis-cache") > 0;
+  enable_callsite_model_cache_ =
+      variables.count("enable-callsite-model-cache") > 0;
+  release_control_flow_graphs_ =
+      variables.count("release-control-flow-graphs") > 0;
+  if (release_control_flow_graphs_ && !enable_scc_fixpoint_) {
+    throw std::invalid_argument(
+        "Option `--release-control-flow-graphs` requires `--enable-scc-fixpoint`.");
+  }
+  intern_stable_frames_ = variables.count("intern-stable-frames") > 0;
+  if (intern_stable_frames_ && !enable_scc_fixpoint_) {
+    throw std::invalid_argument(
+        "Option `--intern-stable-frames` requires `--enable-scc-fixpoint`.");
+  }
+  // Interned frame data outlives evicted models.
+  if (intern_stable_frames_ && resident_set_size_target_) {
+    throw std::invalid_argument(
+        "Option `--intern-stable-frames` is not supported with `--resident-set-size-target`.");
+  }
+  checkpoint_interval_ = variables.count("checkpoint-interval") == 0
+      ? std::nullopt
+      : std::make_optional<int>(variables["checkpoint-interval"].as<int>());
+  if (checkpoint_interval_ && *checkpoint_interval_ <= 0) {
+    throw std::invalid_argument(fmt::format(
+        "Checkpoint interval must be positive, got {}.",
+        *checkpoint_interval_));
+  }
+  if (!variables["resume-from"].empty()) {
+    resume_from_ =
+        check_path_exists(variables["resume-from"].as<std::string>());
+  }
+  if ((checkpoint_interval_ || resume_from_) &&
+      (enable_worklist_fixpoint_ || enable_scc_fixpoint_)) {
+    throw std::invalid_argument(
+        "Options `--checkpoint-interval` and `--resume-from` are only supported with the global iterations fixpoint, not with `--enable-worklist-fixpoint` or `--enable-scc-fixpoint`.");
+  }
+  daemon_ = variables.count("daemon") > 0;
+  // Requests re-run the fixpoint from a subset of the methods.
+  if (daemon_ && enable_scc_fixpoint_) {
+    throw std::invalid_argument(
+        "Option `--daemon` is not supported with `--enable-scc-fixpoint`.");
+  }
+  pin_worker_threads_ = variables.count("pin-worker-threads") > 0;
+  deterministic_ = variables.count("deterministic") > 0;
+  // Methods of the worklist fixpoint are re-analyzed as soon as a callee
+  // changes, hence in an order depending on the threads.
+  if (deterministic_ && enable_worklist_fixpoint_) {
+    throw std::invalid_argument(
+        "Option `--deterministic` is not supported with `--enable-worklist-fixpoint`.");
+  }
+  tiered_analysis_ = variables.count("tiered-analysis") > 0;
+  sparse_taint_analysis_ = variables.count("sparse-taint-analysis") > 0;
+  relevance_prescan_ = variables.count("relevance-prescan") > 0;
+  fuse_forward_analyses_ = variables.count("fuse-forward-analyses") > 0;
+  incremental_reanalysis_ = variables.count("incremental-reanalysis") > 0;
+  // The forward taint states refer to the memory locations of the cached
+  // forward alias results.
+  if (incremental_reanalysis_ && !enable_alias_analysis_cache_) {
+    throw std::invalid_argument(
+        "Option `--incremental-reanalysis` requires `--enable-alias-analysis-cache`.");
+  }
+  if (!variables["rule-codes"].empty()) {
+    rule_codes_ = variables["rule-codes"].as<std::vector<int>>();
+    // Methods that can only hold kinds of the other rules are skipped.
+    tiered_analysis_ = true;
+  }
+  source_sink_slicing_ = variables.count("source-sink-slicing") > 0;
+  prune_unreachable_methods_ =
+      variables.count("prune-unreachable-methods") > 0;
+  if (!variables["entry-point"].empty()) {
+    entry_points_ = variables["entry-point"].as<std::vector<std::string>>();
+    if (!prune_unreachable_methods_) {
+      throw std::invalid_argument(
+          "Option `--entry-point` requires `--prune-unreachable-methods`.");
+    }
+  }
+  if (!variables["reduced-precision-classes"].empty()) {
+    reduced_precision_classes_ =
+        variables["reduced-precision-classes"].as<std::vector<std::string>>();
+  }
+  if (variables.count("maximum-parameter-type-overrides") > 0) {
+    auto maximum = variables["maximum-parameter-type-overrides"].as<int>();
+    if (maximum < 0) {
+      throw std::invalid_argument(
+          "Option `--maximum-parameter-type-overrides` must be non-negative.");
+    }
+    maximum_parameter_type_overrides_ = static_cast<std::size_t>(maximum);
+  }
+  if (!variables["previous-method-profiles-directory"].empty()) {
+    previous_method_profiles_directory_ = check_directory_exists(
+        variables["previous-method-profiles-directory"].as<std::string>());
+  }
+  trim_allocator_memory_ = variables.count("trim-allocator-memory") > 0;
+  parallel_taint_analysis_minimum_blocks_ =
+      variables.count("parallel-taint-analysis-minimum-blocks") == 0
+      ? std::nullopt
+      : std::make_optional<int>(
+            variables["parallel-taint-analysis-minimum-blocks"].as<int>());
+  maximum_callsite_model_cache_entries_ =
+      variables.count("maximum-callsite-model-cache-entries") == 0
+      ? std::nullopt
+      : std::make_optional<int>(
+            variables["maximum-callsite-model-cache-entries"].as<int>());
+  if (maximum_callsite_model_cache_entries_ && !enable_callsite_model_cache_) {
+    throw std::invalid_argument(
+        "Option `--maximum-callsite-model-cache-entries` requires `--enable-callsite-model-cache`.");
+  }
+  skip_call_site_origins_ = variables.count("skip-call-site-origins") > 0;
+  if (skip_call_site_origins_ &&
+      export_origins_mode_ == ExportOriginsMode::Always) {
+    throw std::invalid_argument(
+        "Option `--skip-call-site-origins` is incompatible with `--always-export-origins`.");
+  }
+  dry_run_model_generation_ = variables.count("dry-run-model-generation") > 0;
+  if (dry_run_model_generation_ && daemon_) {
+    throw std::invalid_argument(
+        "Option `--dry-run-model-generation` is incompatible with `--daemon`.");
+  }
+  widen_changing_models_ = variables.count("widen-changing-models") > 0;
 }
 
 void Options::add_options(
@@ -317,6 +676,14 @@ void Options::add_options(
       "literal-models-paths",
       program_options::value<std::string>(),
       "A `;` separated list of literal models files and directories containing literal models files.");
+  options.add_options()(
+      "library-models-paths",
+      program_options::value<std::string>(),
+      "A `;` separated list of models files and directories containing models files, for methods that may not exist in the analyzed program. Files are memory-mapped and indexed by method in `<file>.index`, and only the models of existing methods are parsed.");
+  options.add_options()(
+      "library-summaries-paths",
+      program_options::value<std::string>(),
+      "A `;` separated list of library summaries written by `--summarize-library`. Summaries of methods whose code and overrides of virtual callees are unchanged are joined into the models and these methods are not analyzed.");
   options.add_options()(
       "rules-paths",
       program_options::value<std::string>()->required(),
@@ -341,6 +708,14 @@ void Options::add_options(
       "generated-models-directory",
       program_options::value<std::string>(),
       "Directory where generated models will be stored.");
+  options.add_options()(
+      "analysis-cache-directory",
+      program_options::value<std::string>(),
+      "Directory where the analysis cache is read from and stored. Methods that are unchanged since the previous run and had nothing to infer are not analyzed again. Results of the global type analysis and matches of JSON model generators are also reused when the code did not change, as well as the source index and the intent routing results of unchanged files and methods.");
+  options.add_options()(
+      "precomputed-graphs-directory",
+      program_options::value<std::string>(),
+      "Directory where snapshots of the class hierarchies, class intervals and override graph are read from and stored. They are loaded instead of being built when the classes and methods are unchanged since the previous run.");
   options.add_options()(
       "model-generator-configuration-paths",
       program_options::value<std::string>()->required(),
@@ -375,6 +750,36 @@ void Options::add_options(
       "output-directory",
       program_options::value<std::string>()->required(),
       "Directory to write results in.");
+  options.add_options()(
+      "binary-model-output",
+      "Write models in the compact binary format read by `scripts/binary_models.py` instead of json lines.");
+  options.add_options()(
+      "output-compression-level",
+      program_options::value<int>(),
+      "Compress each model shard with gzip at the given level, from 1 (fastest) to 9 (smallest). 0 disables compression.");
+  options.add_options()(
+      "stream-models",
+      "Postprocess and write the models of each strongly connected component as soon as it is stable, overlapping the output with the analysis. Requires `--enable-scc-fixpoint` and `--skip-source-indexing`.");
+  options.add_options()(
+      "resident-set-size-target",
+      program_options::value<double>(),
+      "Resident set size, in GB, above which the models of stable components are released once all their callers are stable. These are never read again by the analysis. Requires `--stream-models`, and is not supported with options reading models after the fixpoint, e.g `--dump-issues` or `--shards`.");
+  options.add_options()(
+      "dump-model-fingerprints",
+      "Write a content hash of every model in `model_fingerprints.txt`, to be used as `--previous-model-fingerprints` of a later run.");
+  options.add_options()(
+      "previous-model-fingerprints",
+      program_options::value<std::string>(),
+      "The `model_fingerprints.txt` of a previous run. Only the models that changed since that run are written, and the models that no longer exist are listed in `model_tombstones.txt`.");
+  options.add_options()(
+      "output-string-tables",
+      "Replace file paths, method and field signatures and kinds in the models by their index in a string table per shard, written in `string-table-model@*.json`.");
+  options.add_options()(
+      "dump-issues",
+      "Also write the issues of all methods in `issues.json`, merging the issues with the same rule, callee, sink index and position.");
+  options.add_options()(
+      "dump-model-index",
+      "Also write the shard, offset and length of each model in `model_index.json`, so that models can be read without indexing all shards.");
 
   options.add_options()(
       "sequential", "Run the global fixpoint without parallelization.");
@@ -387,13 +792,24 @@ void Options::add_options(
   options.add_options()(
       "disable-global-type-analysis",
       "Disable running Redex's global type analysis to infer types.");
+  options.add_options()(
+      "disable-class-intervals",
+      "Disable class intervals, which filter flows through virtual calls by receiver type.");
   options.add_options()(
       "remove-unreachable-code",
       "Prune unreachable code based on entry points specified in proguard configuration.");
   options.add_options()(
       "maximum-method-analysis-time",
       program_options::value<int>(),
-      "Specify number of seconds as a bound. If the analysis of a method takes longer than this then make the method obscure (default taint-in-taint-out).");
+      "Specify number of seconds as a bound. If the analysis of a method takes longer than this then it is aborted and the method is made obscure (default taint-in-taint-out).");
+  options.add_options()(
+      "maximum-analysis-time",
+      program_options::value<int>(),
+      "Specify number of seconds as a bound for the global fixpoint. Once exceeded, the analysis of remaining methods is aborted and they are made obscure (default taint-in-taint-out).");
+  options.add_options()(
+      "maximum-cached-type-environments",
+      program_options::value<int>(),
+      "Once the call graph is built, only keep the inferred types of this many methods in memory. Types of evicted methods are inferred again when needed.");
 
   options.add_options()(
       "maximum-source-sink-distance",
@@ -432,6 +848,69 @@ void Options::add_options(
   options.add_options()(
       "dump-coverage-info",
       "Dump the file coverage info into `file_coverage.txt` and rule coverage info into `rule_coverage.json`.");
+  options.add_options()(
+      "dump-trace",
+      "Dump a timeline of the analysis phases, global iterations, worker activity, slowest methods and memory usage in `trace.json`, in the Chrome trace event format (see `chrome://tracing` or `ui.perfetto.dev`).");
+  options.add_options()(
+      "dump-method-profiles",
+      "Dump a profile of the analyses of each method (time and block visits of each fixpoint, callee model lookups, instructions, call sites, model size and number of analyses) next to the models, in `method_profile@*.json` shards sorted by decreasing analysis time.");
+  options.add_options()(
+      "track-model-sizes",
+      "Record the number of frames of each model after each analysis, and add the sizes (frames per port, taint tree leaves and depth, features, origins) and growth of the largest models to the metadata.");
+  options.add_options()(
+      "model-size-warning-threshold",
+      program_options::value<int>(),
+      "Warn and log a `large_model` event when the model of a method exceeds this number of frames. Implies `--track-model-sizes`.");
+  options.add_options()(
+      "convergence-report",
+      "Record, for each iteration, the changed model components (generations, sinks, propagations, issues) and, for each method, the callees whose changes triggered its analyses. Add the methods with most analyses and the callees causing most invalidations to the metadata.");
+  options.add_options()(
+      "partitions",
+      program_options::value<int>(),
+      "Partition the graph of strongly connected components in the given number of balanced partitions for a distributed analysis, keeping callers with their callees, and write the partitions and their boundaries in `partitions.json`.");
+  options.add_options()(
+      "shards",
+      program_options::value<int>(),
+      "Analyze the program in the given number of shard processes, partitioning the components as `--partitions` does. Shards exchange the models of their boundary methods through `--shard-directory` between rounds.");
+  options.add_options()(
+      "shard-index",
+      program_options::value<int>(),
+      "Index of the shard analyzed by this process, between 0 and `--shards` - 1. Only the methods of its partition are analyzed, using the boundary models written by the other shards in the previous round.");
+  options.add_options()(
+      "merge-shards",
+      "Instead of analyzing the program, join the models written by each shard in `--shard-directory` and write the results.");
+  options.add_options()(
+      "shard-directory",
+      program_options::value<std::string>(),
+      "Directory shared by the shards of `--shards` to exchange their models.");
+  options.add_options()(
+      "summarize-library",
+      program_options::value<std::vector<std::string>>()->multitoken(),
+      "Write the inferred models of the methods of classes with the given prefixes (e.g `Lokhttp3/`), along with a fingerprint of their code, in `library_summaries.json`. These can be loaded with `--library-summaries-paths` when analyzing other programs bundling the library.");
+  options.add_options()(
+      "collect-cache-statistics",
+      "Count lookups, hits, inserts and concurrent insertions of the caches and factories (call site models, kinds, features, origins, access paths, positions, type environments...) and add them per phase to the metadata.");
+  options.add_options()(
+      "write-status",
+      "Periodically rewrite `status.json` with the current phase and iteration, the remaining work items, the throughput in methods per second, the memory usage and the longest running method analyses.");
+  options.add_options()(
+      "status-interval",
+      program_options::value<int>()->default_value(10),
+      "Number of seconds between two writes of `status.json`.");
+  options.add_options()(
+      "memory-accounting",
+      "Estimate the memory used by models, the call graph, overrides, class hierarchies, types, control flow graphs, positions and factories at each phase and global iteration, and report it in the metadata.");
+  options.add_options()(
+      "memory-accounting-sampling-rate",
+      program_options::value<int>()->default_value(1),
+      "Only measure the models, types and control flow graphs of one method out of the given number when accounting memory.");
+  options.add_options()(
+      "sample-analyzed-methods",
+      "Tag worker threads with the analyzed method in the `mariana_trench_analyzed_method` thread-local variable, sample native stacks on CPU time and write them by analyzed method in `method_samples.folded`, in the folded stacks format of flame graphs.");
+  options.add_options()(
+      "sampling-frequency",
+      program_options::value<int>()->default_value(99),
+      "Number of samples per second of CPU time for `--sample-analyzed-methods`.");
 
   options.add_options()(
       "job-id",
@@ -453,6 +932,102 @@ void Options::add_options(
   options.add_options()(
       "propagate-across-arguments",
       "Enable taint propagation across object type arguments. By default, taint propagation is only tracked for return values and the `this` argument. This enables taint propagation across method invocations for all other object type arguments as well.");
+  options.add_options()(
+      "enable-worklist-fixpoint",
+      "Compute the global fixpoint without global iterations: methods are re-analyzed as soon as one of their callees changes.");
+  options.add_options()(
+      "enable-scc-fixpoint",
+      "Compute the global fixpoint bottom-up on strongly connected components: each component is iterated to its local fixpoint before its callers are analyzed.");
+  options.add_options()(
+      "enable-alias-analysis-cache",
+      "Reuse the forward alias analysis results of a method across iterations when the relevant parts of its callee models are unchanged. This uses more memory.");
+  options.add_options()(
+      "enable-callsite-model-cache",
+      "Reuse callee models instantiated at call sites across iterations when the callee model is unchanged. This uses more memory.");
+  options.add_options()(
+      "release-control-flow-graphs",
+      "Free the control flow graphs of each strongly connected component once it is stable, to reduce memory usage. Requires `--enable-scc-fixpoint`.");
+  options.add_options()(
+      "intern-stable-frames",
+      "Share the data of equal frames across the models of each strongly connected component once it is stable, to reduce memory usage. Requires `--enable-scc-fixpoint`.");
+  options.add_options()(
+      "checkpoint-interval",
+      program_options::value<int>(),
+      "Write the state of the global fixpoint in `checkpoint.json` every given number of global iterations.");
+  options.add_options()(
+      "resume-from",
+      program_options::value<std::string>(),
+      "Resume the global fixpoint from a checkpoint written with `--checkpoint-interval`, instead of starting from the initial models.");
+  options.add_options()(
+      "daemon",
+      "Once the results are written, keep the analysis state resident and re-analyze the methods given in json requests on the standard input, writing the new and removed issues on the standard output.");
+  options.add_options()(
+      "pin-worker-threads",
+      "Pin the fixpoint worker threads to the NUMA nodes of the host, in contiguous blocks. With `--enable-scc-fixpoint`, components are assigned to nodes with their callee components, so that their models are allocated on the node analyzing them.");
+  options.add_options()(
+      "deterministic",
+      "Publish the models changed by a global iteration at the end of the iteration, so that iteration counts and results do not depend on the number of threads nor on the analysis order. With `--enable-scc-fixpoint`, the methods of large components are analyzed sequentially.");
+  options.add_options()(
+      "tiered-analysis",
+      "Only analyze the methods that may hold taint: methods with source or sink kinds, accessing fields or string literals with models, and their transitive callers. Other methods are skipped with taint-in-taint-out and taint-in-taint-this propagations.");
+  options.add_options()(
+      "sparse-taint-analysis",
+      "Skip the forward taint analysis of methods where no taint is introduced: without parameter sources, callees with sources, or fields and string literals with sources. Similarly, skip the backward taint analysis of methods without returned values, callees with sinks, or fields and array allocations with sinks, and only seed the parameters that may be written.");
+  options.add_options()(
+      "relevance-prescan",
+      "Before analyzing a method, scan its code and callee models, and keep its initial model when it cannot change: its parameters are never read, it accesses no field or string literal with a model, and neither its model nor its callee models have source or sink kinds.");
+  options.add_options()(
+      "fuse-forward-analyses",
+      "Run the forward alias and forward taint analyses of a method in a single fixpoint over their product, walking the control flow graph once.");
+  options.add_options()(
+      "incremental-reanalysis",
+      "Keep the forward taint states of large methods, and restart their forward taint analysis from the blocks calling callees whose model changed. Requires `--enable-alias-analysis-cache`.");
+  options.add_options()(
+      "prune-unreachable-methods",
+      "Skip the analysis of methods that are not reachable in the call graph from an entry point: life-cycle wrappers, methods of the components of the manifest, class initializers, overrides of methods of external classes and the methods of `--entry-point`.");
+  options.add_options()(
+      "entry-point",
+      program_options::value<std::vector<std::string>>()->multitoken(),
+      "Also use the methods whose signature starts with the given prefix (e.g `Lcom/example/Api;.`) as entry points of `--prune-unreachable-methods`.");
+  options.add_options()(
+      "rule-codes",
+      program_options::value<std::vector<int>>()->multitoken(),
+      "Only load the rules with the given codes. Kinds and transforms used by other rules only are removed from models, and methods that cannot hold the remaining kinds are not analyzed. Implies `--tiered-analysis`.");
+  options.add_options()(
+      "source-sink-slicing",
+      "Only analyze the methods through which a source may reach a sink: methods calling, directly or not, both a method with sources and a method with sinks, and their callees leading to either. Other methods are skipped with taint-in-taint-out and taint-in-taint-this propagations. With `--rule-codes`, this answers whether the sources of the given rules reach their sinks.");
+  options.add_options()(
+      "reduced-precision-classes",
+      program_options::value<std::vector<std::string>>()->multitoken(),
+      "Analyze the methods of classes with the given prefixes (e.g `Lcom/thirdparty/`) with reduced precision: their models keep a single leaf per port, and drop inferred features and local positions. Meant for third party libraries, which account for much of the analysis time and memory but few actionable issues.");
+  options.add_options()(
+      "maximum-parameter-type-overrides",
+      program_options::value<int>(),
+      "Create at most this many variants of a method with parameter type overrides. Further calls with anonymous class arguments use the method without overrides, and call the methods of the anonymous classes with the `via-parameter-type-overrides-limit` feature instead.");
+  options.add_options()(
+      "previous-method-profiles-directory",
+      program_options::value<std::string>(),
+      "Output directory of a previous run with `--dump-method-profiles`. The analysis times of the previous run seed the costs of the schedule, so that the most expensive components start first, and methods that exceeded `--maximum-method-analysis-time` are made obscure (default taint-in-taint-out) without being analyzed.");
+  options.add_options()(
+      "trim-allocator-memory",
+      "Return the memory freed by the allocator to the operating system after the preprocessing, the fixpoint and the output, so that the resident set size shrinks after transient peaks. This is only supported with the glibc allocator.");
+  options.add_options()(
+      "parallel-taint-analysis-minimum-blocks",
+      program_options::value<int>(),
+      "Run the forward and backward taint analyses of methods with at least this number of basic blocks concurrently, after their forward alias analysis. This is disabled with multi-source/sink rules, since the backward taint analysis depends on the partial sinks fulfilled by the forward taint analysis.");
+  options.add_options()(
+      "maximum-callsite-model-cache-entries",
+      program_options::value<int>(),
+      "Bound the number of call sites in the callsite model cache, to bound its memory usage. Once the cache is full, only call sites that are already cached are updated. Requires `--enable-callsite-model-cache`.");
+  options.add_options()(
+      "skip-call-site-origins",
+      "Do not propagate origins into the frames of call sites during the analysis. Only origin frames, which are the leaves of traces, keep their origins. These are the only frames whose origins are exported without `--always-export-origins`, except for issues, which then lose the origins of frames of call sites.");
+  options.add_options()(
+      "dry-run-model-generation",
+      "Stop after running the model generators, to measure their cost. The call graph is not built and only the generated models are written. The metadata holds the time, number of candidates and number of models of each generator and of its slowest items. Use `--precomputed-graphs-directory` to load the class hierarchies and override graph from snapshots.");
+  options.add_options()(
+      "widen-changing-models",
+      "Widen the new models of methods whose model changed many times during the fixpoint, as for `--reduced-precision-classes`. Models that keep growing slightly, e.g through features or deeper paths, then stabilize instead of reaching the iteration limit, at the cost of precision.");
 }
 
 const std::vector<std::string>& Options::models_paths() const {
@@ -467,6 +1042,14 @@ const std::vector<std::string>& Options::literal_models_paths() const {
   return literal_models_paths_;
 }
 
+const std::vector<std::string>& Options::library_models_paths() const {
+  return library_models_paths_;
+}
+
+const std::vector<std::string>& Options::library_summaries_paths() const {
+  return library_summaries_paths_;
+}
+
 const std::vector<ModelGeneratorConfiguration>&
 Options::model_generators_configuration() const {
   return model_generators_configuration_;
@@ -496,6 +1079,15 @@ const std::optional<std::string>& Options::generated_models_directory() const {
   return generated_models_directory_;
 }
 
+const std::optional<std::string>& Options::analysis_cache_directory() const {
+  return analysis_cache_directory_;
+}
+
+const std::optional<std::string>& Options::precomputed_graphs_directory()
+    const {
+  return precomputed_graphs_directory_;
+}
+
 const std::vector<std::string>& Options::generator_configuration_paths() const {
   return generator_configuration_paths_;
 }
@@ -580,6 +1172,46 @@ const std::filesystem::path Options::rule_coverage_output_path() const {
   return output_directory_ / "rule_coverage.json";
 }
 
+const std::filesystem::path Options::trace_output_path() const {
+  return output_directory_ / "trace.json";
+}
+
+const std::filesystem::path Options::status_output_path() const {
+  return output_directory_ / "status.json";
+}
+
+const std::filesystem::path Options::method_samples_output_path() const {
+  return output_directory_ / "method_samples.folded";
+}
+
+const std::filesystem::path Options::partitions_output_path() const {
+  return output_directory_ / "partitions.json";
+}
+
+const std::filesystem::path Options::library_summaries_output_path() const {
+  return output_directory_ / "library_summaries.json";
+}
+
+const std::filesystem::path Options::model_fingerprints_output_path() const {
+  return output_directory_ / "model_fingerprints.txt";
+}
+
+const std::filesystem::path Options::model_tombstones_output_path() const {
+  return output_directory_ / "model_tombstones.txt";
+}
+
+const std::filesystem::path Options::checkpoint_output_path() const {
+  return output_directory_ / "checkpoint.json";
+}
+
+const std::filesystem::path Options::issues_output_path() const {
+  return output_directory_ / "issues.json";
+}
+
+const std::filesystem::path Options::model_index_output_path() const {
+  return output_directory_ / "model_index.json";
+}
+
 bool Options::sequential() const {
   return sequential_;
 }
@@ -600,6 +1232,10 @@ bool Options::disable_global_type_analysis() const {
   return disable_global_type_analysis_;
 }
 
+bool Options::disable_class_intervals() const {
+  return disable_class_intervals_;
+}
+
 bool Options::remove_unreachable_code() const {
   return remove_unreachable_code_;
 }
@@ -608,6 +1244,14 @@ std::optional<int> Options::maximum_method_analysis_time() const {
   return maximum_method_analysis_time_;
 }
 
+std::optional<int> Options::maximum_analysis_time() const {
+  return maximum_analysis_time_;
+}
+
+std::optional<int> Options::maximum_cached_type_environments() const {
+  return maximum_cached_type_environments_;
+}
+
 int Options::maximum_source_sink_distance() const {
   return maximum_source_sink_distance_;
 }
@@ -656,6 +1300,115 @@ bool Options::dump_coverage_info() const {
   return dump_coverage_info_;
 }
 
+bool Options::dump_trace() const {
+  return dump_trace_;
+}
+
+bool Options::dump_method_profiles() const {
+  return dump_method_profiles_;
+}
+
+bool Options::track_model_sizes() const {
+  return track_model_sizes_;
+}
+
+std::optional<int> Options::model_size_warning_threshold() const {
+  return model_size_warning_threshold_;
+}
+
+bool Options::convergence_report() const {
+  return convergence_report_;
+}
+
+std::optional<int> Options::partitions() const {
+  return partitions_;
+}
+
+std::optional<int> Options::shards() const {
+  return shards_;
+}
+
+std::optional<int> Options::shard_index() const {
+  return shard_index_;
+}
+
+bool Options::merge_shards() const {
+  return merge_shards_;
+}
+
+const std::optional<std::string>& Options::shard_directory() const {
+  return shard_directory_;
+}
+
+const std::vector<std::string>& Options::summarize_library() const {
+  return summarize_library_;
+}
+
+bool Options::collect_cache_statistics() const {
+  return collect_cache_statistics_;
+}
+
+bool Options::write_status() const {
+  return write_status_;
+}
+
+int Options::status_interval() const {
+  return status_interval_;
+}
+
+bool Options::memory_accounting() const {
+  return memory_accounting_;
+}
+
+int Options::memory_accounting_sampling_rate() const {
+  return memory_accounting_sampling_rate_;
+}
+
+bool Options::sample_analyzed_methods() const {
+  return sample_analyzed_methods_;
+}
+
+int Options::sampling_frequency() const {
+  return sampling_frequency_;
+}
+
+bool Options::binary_model_output() const {
+  return binary_model_output_;
+}
+
+int Options::output_compression_level() const {
+  return output_compression_level_;
+}
+
+bool Options::stream_models() const {
+  return stream_models_;
+}
+
+std::optional<double> Options::resident_set_size_target() const {
+  return resident_set_size_target_;
+}
+
+const std::optional<std::string>& Options::previous_model_fingerprints_path()
+    const {
+  return previous_model_fingerprints_path_;
+}
+
+bool Options::dump_model_fingerprints() const {
+  return dump_model_fingerprints_;
+}
+
+bool Options::output_string_tables() const {
+  return output_string_tables_;
+}
+
+bool Options::dump_issues() const {
+  return dump_issues_;
+}
+
+bool Options::dump_model_index() const {
+  return dump_model_index_;
+}
+
 const std::optional<std::string>& Options::job_id() const {
   return job_id_;
 }
@@ -676,4 +1429,121 @@ bool Options::propagate_across_arguments() const {
   return propagate_across_arguments_;
 }
 
+bool Options::enable_worklist_fixpoint() const {
+  return enable_worklist_fixpoint_;
+}
+
+bool Options::enable_scc_fixpoint() const {
+  return enable_scc_fixpoint_;
+}
+
+bool Options::enable_alias_analysis_cache() const {
+  return enable_alias_analysis_cache_;
+}
+
+bool Options::enable_callsite_model_cache() const {
+  return enable_callsite_model_cache_;
+}
+
+bool Options::release_control_flow_graphs() const {
+  return release_control_flow_graphs_;
+}
+
+bool Options::intern_stable_frames() const {
+  return intern_stable_frames_;
+}
+
+std::optional<int> Options::checkpoint_interval() const {
+  return checkpoint_interval_;
+}
+
+const std::optional<std::string>& Options::resume_from() const {
+  return resume_from_;
+}
+
+bool Options::daemon() const {
+  return daemon_;
+}
+
+bool Options::pin_worker_threads() const {
+  return pin_worker_threads_;
+}
+
+bool Options::deterministic() const {
+  return deterministic_;
+}
+
+bool Options::tiered_analysis() const {
+  return tiered_analysis_;
+}
+
+bool Options::sparse_taint_analysis() const {
+  return sparse_taint_analysis_;
+}
+
+bool Options::relevance_prescan() const {
+  return relevance_prescan_;
+}
+
+bool Options::fuse_forward_analyses() const {
+  return fuse_forward_analyses_;
+}
+
+bool Options::incremental_reanalysis() const {
+  return incremental_reanalysis_;
+}
+
+bool Options::prune_unreachable_methods() const {
+  return prune_unreachable_methods_;
+}
+
+const std::vector<std::string>& Options::entry_points() const {
+  return entry_points_;
+}
+
+const std::vector<int>& Options::rule_codes() const {
+  return rule_codes_;
+}
+
+bool Options::source_sink_slicing() const {
+  return source_sink_slicing_;
+}
+
+const std::vector<std::string>& Options::reduced_precision_classes() const {
+  return reduced_precision_classes_;
+}
+
+std::optional<std::size_t> Options::maximum_parameter_type_overrides() const {
+  return maximum_parameter_type_overrides_;
+}
+
+const std::optional<std::string>& Options::previous_method_profiles_directory()
+    const {
+  return previous_method_profiles_directory_;
+}
+
+bool Options::trim_allocator_memory() const {
+  return trim_allocator_memory_;
+}
+
+std::optional<int> Options::parallel_taint_analysis_minimum_blocks() const {
+  return parallel_taint_analysis_minimum_blocks_;
+}
+
+std::optional<int> Options::maximum_callsite_model_cache_entries() const {
+  return maximum_callsite_model_cache_entries_;
+}
+
+bool Options::skip_call_site_origins() const {
+  return skip_call_site_origins_;
+}
+
+bool Options::dry_run_model_generation() const {
+  return dry_run_model_generation_;
+}
+
+bool Options::widen_changing_models() const {
+  return widen_changing_models_;
+}
+
 } // namespace marianatrench
@@ -43,7 +43,10 @@ class Options final {
       const std::string& source_root_directory = ".",
       bool enable_cross_component_analysis = false,
       ExportOriginsMode export_origins_mode = ExportOriginsMode::Always,
-      bool propagate_across_arguments = false);
+      bool propagate_across_arguments = false,
+      bool enable_worklist_fixpoint = false,
+      bool enable_scc_fixpoint = false,
+      bool deterministic = false);
 
   explicit Options(const boost::program_options::variables_map& variables);
 
@@ -54,6 +57,8 @@ class Options final {
   const std::vector<std::string>& models_paths() const;
   const std::vector<std::string>& field_models_paths() const;
   const std::vector<std::string>& literal_models_paths() const;
+  const std::vector<std::string>& library_models_paths() const;
+  const std::vector<std::string>& library_summaries_paths() const;
   const std::vector<ModelGeneratorConfiguration>&
   model_generators_configuration() const;
   const std::vector<std::string>& rules_paths() const;
@@ -62,6 +67,8 @@ class Options final {
   const std::string& graphql_metadata_paths() const;
   const std::vector<std::string>& proguard_configuration_paths() const;
   const std::optional<std::string>& generated_models_directory() const;
+  const std::optional<std::string>& analysis_cache_directory() const;
+  const std::optional<std::string>& precomputed_graphs_directory() const;
 
   const std::vector<std::string>& generator_configuration_paths() const;
   const std::vector<std::string>& model_generator_search_paths() const;
@@ -89,14 +96,27 @@ class Options final {
   const std::filesystem::path dependencies_output_path() const;
   const std::filesystem::path file_coverage_output_path() const;
   const std::filesystem::path rule_coverage_output_path() const;
+  const std::filesystem::path trace_output_path() const;
+  const std::filesystem::path status_output_path() const;
+  const std::filesystem::path method_samples_output_path() const;
+  const std::filesystem::path partitions_output_path() const;
+  const std::filesystem::path library_summaries_output_path() const;
+  const std::filesystem::path model_fingerprints_output_path() const;
+  const std::filesystem::path model_tombstones_output_path() const;
+  const std::filesystem::path checkpoint_output_path() const;
+  const std::filesystem::path issues_output_path() const;
+  const std::filesystem::path model_index_output_path() const;
 
   bool sequential() const;
   bool skip_source_indexing() const;
   bool skip_analysis() const;
   bool disable_parameter_type_overrides() const;
   bool disable_global_type_analysis() const;
+  bool disable_class_intervals() const;
   bool remove_unreachable_code() const;
   std::optional<int> maximum_method_analysis_time() const;
+  std::optional<int> maximum_analysis_time() const;
+  std::optional<int> maximum_cached_type_environments() const;
 
   int maximum_source_sink_distance() const;
   bool emit_all_via_cast_features() const;
@@ -111,6 +131,33 @@ class Options final {
   bool dump_dependencies() const;
   bool dump_methods() const;
   bool dump_coverage_info() const;
+  bool dump_trace() const;
+  bool dump_method_profiles() const;
+  bool track_model_sizes() const;
+  std::optional<int> model_size_warning_threshold() const;
+  bool convergence_report() const;
+  std::optional<int> partitions() const;
+  std::optional<int> shards() const;
+  std::optional<int> shard_index() const;
+  bool merge_shards() const;
+  const std::optional<std::string>& shard_directory() const;
+  const std::vector<std::string>& summarize_library() const;
+  bool collect_cache_statistics() const;
+  bool write_status() const;
+  int status_interval() const;
+  bool memory_accounting() const;
+  int memory_accounting_sampling_rate() const;
+  bool sample_analyzed_methods() const;
+  int sampling_frequency() const;
+  bool binary_model_output() const;
+  int output_compression_level() const;
+  bool stream_models() const;
+  std::optional<double> resident_set_size_target() const;
+  const std::optional<std::string>& previous_model_fingerprints_path() const;
+  bool dump_model_fingerprints() const;
+  bool output_string_tables() const;
+  bool dump_issues() const;
+  bool dump_model_index() const;
 
   const std::optional<std::string>& job_id() const;
   const std::optional<std::string>& metarun_id() const;
@@ -118,11 +165,42 @@ class Options final {
   bool enable_cross_component_analysis() const;
   ExportOriginsMode export_origins_mode() const;
   bool propagate_across_arguments() const;
+  bool enable_worklist_fixpoint() const;
+  bool enable_scc_fixpoint() const;
+  bool enable_alias_analysis_cache() const;
+  bool enable_callsite_model_cache() const;
+  bool release_control_flow_graphs() const;
+  bool intern_stable_frames() const;
+  std::optional<int> checkpoint_interval() const;
+  const std::optional<std::string>& resume_from() const;
+  bool daemon() const;
+  bool pin_worker_threads() const;
+  bool deterministic() const;
+  bool tiered_analysis() const;
+  bool sparse_taint_analysis() const;
+  bool relevance_prescan() const;
+  bool fuse_forward_analyses() const;
+  bool incremental_reanalysis() const;
+  bool prune_unreachable_methods() const;
+  const std::vector<int>& rule_codes() const;
+  bool source_sink_slicing() const;
+  const std::vector<std::string>& entry_points() const;
+  const std::vector<std::string>& reduced_precision_classes() const;
+  std::optional<std::size_t> maximum_parameter_type_overrides() const;
+  const std::optional<std::string>& previous_method_profiles_directory() const;
+  bool trim_allocator_memory() const;
+  std::optional<int> parallel_taint_analysis_minimum_blocks() const;
+  std::optional<int> maximum_callsite_model_cache_entries() const;
+  bool skip_call_site_origins() const;
+  bool dry_run_model_generation() const;
+  bool widen_changing_models() const;
 
  private:
   std::vector<std::string> models_paths_;
   std::vector<std::string> field_models_paths_;
   std::vector<std::string> literal_models_paths_;
+  std::vector<std::string> library_models_paths_;
+  std::vector<std::string> library_summaries_paths_;
   std::vector<std::string> rules_paths_;
   std::vector<std::string> lifecycles_paths_;
   std::vector<std::string> shims_paths_;
@@ -134,6 +212,8 @@ class Options final {
   std::vector<std::string> model_generator_search_paths_;
 
   std::optional<std::string> generated_models_directory_;
+  std::optional<std::string> analysis_cache_directory_;
+  std::optional<std::string> precomputed_graphs_directory_;
 
   std::string repository_root_directory_;
   std::string source_root_directory_;
@@ -153,7 +233,10 @@ class Options final {
   bool remove_unreachable_code_;
   bool disable_parameter_type_overrides_;
   bool disable_global_type_analysis_;
+  bool disable_class_intervals_;
   std::optional<int> maximum_method_analysis_time_;
+  std::optional<int> maximum_analysis_time_;
+  std::optional<int> maximum_cached_type_environments_;
 
   int maximum_source_sink_distance_;
   bool emit_all_via_cast_features_;
@@ -168,6 +251,33 @@ class Options final {
   bool dump_dependencies_;
   bool dump_methods_;
   bool dump_coverage_info_;
+  bool dump_trace_;
+  bool dump_method_profiles_;
+  bool track_model_sizes_;
+  std::optional<int> model_size_warning_threshold_;
+  bool convergence_report_;
+  std::optional<int> partitions_;
+  std::optional<int> shards_;
+  std::optional<int> shard_index_;
+  bool merge_shards_;
+  std::optional<std::string> shard_directory_;
+  std::vector<std::string> summarize_library_;
+  bool collect_cache_statistics_;
+  bool write_status_;
+  int status_interval_;
+  bool memory_accounting_;
+  int memory_accounting_sampling_rate_;
+  bool sample_analyzed_methods_;
+  int sampling_frequency_;
+  bool binary_model_output_;
+  int output_compression_level_;
+  bool stream_models_;
+  std::optional<double> resident_set_size_target_;
+  std::optional<std::string> previous_model_fingerprints_path_;
+  bool dump_model_fingerprints_;
+  bool output_string_tables_;
+  bool dump_issues_;
+  bool dump_model_index_;
 
   std::optional<std::string> job_id_;
   std::optional<std::string> metarun_id_;
@@ -175,6 +285,35 @@ class Options final {
   bool enable_cross_component_analysis_;
   ExportOriginsMode export_origins_mode_;
   bool propagate_across_arguments_;
+  bool enable_worklist_fixpoint_;
+  bool enable_scc_fixpoint_;
+  bool enable_alias_analysis_cache_;
+  bool enable_callsite_model_cache_;
+  bool release_control_flow_graphs_;
+  bool intern_stable_frames_;
+  std::optional<int> checkpoint_interval_;
+  std::optional<std::string> resume_from_;
+  bool daemon_;
+  bool pin_worker_threads_;
+  bool deterministic_;
+  bool tiered_analysis_;
+  bool sparse_taint_analysis_;
+  bool relevance_prescan_;
+  bool fuse_forward_analyses_;
+  bool incremental_reanalysis_;
+  bool prune_unreachable_methods_;
+  std::vector<std::string> entry_points_;
+  std::vector<int> rule_codes_;
+  bool source_sink_slicing_;
+  std::vector<std::string> reduced_precision_classes_;
+  std::optional<std::size_t> maximum_parameter_type_overrides_;
+  std::optional<std::string> previous_method_profiles_directory_;
+  bool trim_allocator_memory_;
+  std::optional<int> parallel_taint_analysis_minimum_blocks_;
+  std::optional<int> maximum_callsite_model_cache_entries_;
+  bool skip_call_site_origins_;
+  bool dry_run_model_generation_;
+  bool widen_changing_models_;
 };
 
 } // namespace marianatrench
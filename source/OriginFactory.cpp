@@ -32,6 +32,11 @@ const StringOrigin* OriginFactory::string_origin(std::string_view name) const {
   return string_origins_.create(origin_name);
 }
 
+std::size_t OriginFactory::memory_usage() const {
+  return method_origins_.memory_usage() + field_origins_.memory_usage() +
+      crtex_origins_.memory_usage() + string_origins_.memory_usage();
+}
+
 const OriginFactory& OriginFactory::singleton() {
   // Thread-safe global variable, initialized on first call.
   static OriginFactory instance;
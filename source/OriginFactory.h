@@ -33,6 +33,9 @@ class OriginFactory final {
 
   const StringOrigin* string_origin(std::string_view name) const;
 
+  /* Approximate memory used, in bytes. */
+  std::size_t memory_usage() const;
+
   static const OriginFactory& singleton();
 
  private:
@@ -40,14 +43,16 @@ class OriginFactory final {
       std::tuple<const Method*, const AccessPath*>,
       MethodOrigin,
       TupleHash<const Method*, const AccessPath*>>
-      method_origins_;
-  UniquePointerFactory<const Field*, FieldOrigin> field_origins_;
+      method_origins_{CacheStatistics::Cache::Origins};
+  UniquePointerFactory<const Field*, FieldOrigin> field_origins_{
+      CacheStatistics::Cache::Origins};
   UniquePointerFactory<
       std::tuple<const DexString*, const AccessPath*>,
       CrtexOrigin,
       TupleHash<const DexString*, const AccessPath*>>
-      crtex_origins_;
-  UniquePointerFactory<const DexString*, StringOrigin> string_origins_;
+      crtex_origins_{CacheStatistics::Cache::Origins};
+  UniquePointerFactory<const DexString*, StringOrigin> string_origins_{
+      CacheStatistics::Cache::Origins};
 };
 
 } // namespace marianatrench
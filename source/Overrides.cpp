@@ -5,65 +5,198 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <MethodOverrideGraph.h>
+#include <DexClass.h>
 #include <Show.h>
-#include <Walkers.h>
 
 #include <mariana-trench/Assert.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/Methods.h>
 #include <mariana-trench/Overrides.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
 Overrides::Overrides(
     const Options& options,
     const Methods& method_factory,
-    const DexStoresVector& stores) {
-  // Compute overrides.
-  std::vector<std::unique_ptr<const method_override_graph::Graph>>
-      method_override_graphs;
+    const ClassIntervals& class_intervals,
+    const DexStoresVector& stores)
+    : class_intervals_(class_intervals) {
+  std::vector<Scope> scopes;
+  std::vector<const DexMethod*> virtual_methods;
   for (const auto& scope : DexStoreClassesIterator(stores)) {
-    method_override_graphs.push_back(method_override_graph::build_graph(scope));
+    scopes.push_back(scope);
+    for (const auto* klass : scope) {
+      for (const auto* dex_method : klass->get_vmethods()) {
+        virtual_methods.push_back(dex_method);
+      }
+    }
   }
 
-  // Record overrides.
-  for (const auto& scope : DexStoreClassesIterator(stores)) {
-    walk::parallel::methods(scope, [&](const DexMethod* dex_method) {
-      std::unordered_set<const Method*> method_overrides;
-      for (const auto& graph : method_override_graphs) {
-        auto overrides_in_scope = method_override_graph::get_overriding_methods(
-            *graph, dex_method, /* include_interfaces */ true);
-        for (const auto* override : overrides_in_scope) {
-          method_overrides.insert(method_factory.get(override));
+  // Compute overrides, building the graphs of scopes in parallel.
+  auto number_of_threads = sparta::parallel::default_num_threads();
+  std::vector<std::unique_ptr<const method_override_graph::Graph>>
+      method_override_graphs(scopes.size());
+  auto graph_queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        method_override_graphs[index] =
+            method_override_graph::build_graph(scopes[index]);
+      },
+      number_of_threads);
+  for (std::size_t index = 0; index < scopes.size(); index++) {
+    graph_queue.add_item(index);
+  }
+  graph_queue.run_all();
+
+  // Record overrides. Only virtual methods can be overridden. Each worker
+  // buffers its entries, which are merged once all methods are processed.
+  std::vector<std::vector<std::pair<const Method*, const OverrideSet*>>>
+      worker_entries(number_of_threads);
+  auto method_queue = work_queue<const DexMethod*>(
+      [&](WorkerState<const DexMethod*>* worker_state,
+          const DexMethod* dex_method) {
+        std::unordered_set<const Method*> method_overrides;
+        for (const auto& graph : method_override_graphs) {
+          auto overrides_in_scope =
+              method_override_graph::get_overriding_methods(
+                  *graph, dex_method, /* include_interfaces */ true);
+          for (const auto* override : overrides_in_scope) {
+            method_overrides.insert(method_factory.get(override));
+          }
+        }
+        if (method_overrides.empty()) {
+          return;
         }
-      }
 
-      set(method_factory.get(dex_method), std::move(method_overrides));
-    });
+        worker_entries[worker_state->worker_id()].emplace_back(
+            method_factory.get(dex_method),
+            create_override_set(std::move(method_overrides)));
+      },
+      number_of_threads);
+  for (const auto* dex_method : virtual_methods) {
+    method_queue.add_item(dex_method);
   }
+  method_queue.run_all();
 
-  if (options.dump_overrides()) {
-    auto overrides_path = options.overrides_output_path();
-    LOG(1, "Writing override graph to `{}`", overrides_path.native());
-    JsonValidation::write_json_file(overrides_path, to_json());
+  auto merge_queue = work_queue<std::size_t>(
+      [&](std::size_t worker_id) {
+        for (const auto& [method, override_set] : worker_entries[worker_id]) {
+          overrides_.emplace(method, override_set);
+        }
+        worker_entries[worker_id] = {};
+      },
+      number_of_threads);
+  for (std::size_t worker_id = 0; worker_id < number_of_threads; worker_id++) {
+    merge_queue.add_item(worker_id);
   }
+  merge_queue.run_all();
+
+  LOG(1, "Found {} distinct override sets.", number_of_distinct_sets());
+  dump(options);
+}
+
+std::unique_ptr<Overrides> Overrides::from_snapshot(
+    const Options& options,
+    const Methods& methods,
+    const ClassIntervals& class_intervals,
+    const GraphSnapshot::Edges& edges) {
+  // Cannot use `std::make_unique` with a private constructor.
+  auto overrides =
+      std::unique_ptr<Overrides>(new Overrides(class_intervals));
+  for (const auto& [method_name, override_names] : edges) {
+    const auto* method = methods.get(method_name);
+    if (method == nullptr) {
+      return nullptr;
+    }
+
+    std::unordered_set<const Method*> method_overrides;
+    for (const auto& override_name : override_names) {
+      const auto* override = methods.get(override_name);
+      if (override == nullptr) {
+        return nullptr;
+      }
+      method_overrides.insert(override);
+    }
+    overrides->set(method, std::move(method_overrides));
+  }
+
+  overrides->dump(options);
+  return overrides;
+}
+
+GraphSnapshot::Edges Overrides::to_snapshot() const {
+  GraphSnapshot::Edges edges;
+  for (auto [method, overrides] : overrides_) {
+    std::vector<std::string> override_names;
+    override_names.reserve(overrides->methods.size());
+    for (const auto* override : overrides->methods) {
+      override_names.push_back(override->show());
+    }
+    edges.emplace_back(method->show(), std::move(override_names));
+  }
+  return edges;
 }
 
 const std::unordered_set<const Method*>& Overrides::get(
     const Method* method) const {
-  auto* overrides = overrides_.get(method, /* default */ nullptr);
+  const auto* overrides = overrides_.get(method, /* default */ nullptr);
   if (overrides != nullptr) {
-    return *overrides;
+    return overrides->methods;
   } else {
     return empty_method_set_;
   }
 }
 
+const Overrides::IntervalIndex& Overrides::get_interval_index(
+    const Method* method) const {
+  const auto* overrides = overrides_.get(method, /* default */ nullptr);
+  if (overrides != nullptr) {
+    return overrides->interval_index;
+  } else {
+    return empty_interval_index_;
+  }
+}
+
+std::optional<std::pair<std::size_t, std::size_t>>
+Overrides::subclasses_range(const IntervalIndex& index, const DexType* type)
+    const {
+  const auto* klass = type_class(type);
+  if (klass == nullptr || is_interface(klass)) {
+    return std::nullopt;
+  }
+
+  const auto& interval = class_intervals_.get_interval(type);
+  if (interval.is_top() || interval.is_bottom()) {
+    return std::nullopt;
+  }
+
+  // Intervals of strict subclasses have a lower bound in
+  // `(interval.lower_bound(), interval.upper_bound()]`.
+  auto begin = std::upper_bound(
+      index.begin(),
+      index.end(),
+      interval.lower_bound(),
+      [](std::uint32_t lower_bound, const auto& entry) {
+        return lower_bound < entry.first;
+      });
+  auto end = std::upper_bound(
+      begin,
+      index.end(),
+      interval.upper_bound(),
+      [](std::uint32_t upper_bound, const auto& entry) {
+        return upper_bound < entry.first;
+      });
+  return std::make_pair(begin - index.begin(), end - index.begin());
+}
+
 void Overrides::set(
     const Method* method,
     std::unordered_set<const Method*> overrides) {
@@ -72,16 +205,44 @@ void Overrides::set(
     return;
   }
 
-  overrides_.emplace(
-      method,
-      std::make_unique<std::unordered_set<const Method*>>(
-          std::move(overrides)));
+  overrides_.emplace(method, create_override_set(std::move(overrides)));
+}
+
+const Overrides::OverrideSet* Overrides::create_override_set(
+    std::unordered_set<const Method*> overrides) {
+  std::vector<const Method*> key(overrides.begin(), overrides.end());
+  std::sort(key.begin(), key.end());
+  return override_sets_.create(key, std::move(overrides), class_intervals_);
+}
+
+std::size_t Overrides::number_of_distinct_sets() const {
+  return std::distance(override_sets_.begin(), override_sets_.end());
+}
+
+Overrides::OverrideSet::OverrideSet(
+    std::unordered_set<const Method*> methods,
+    const ClassIntervals& class_intervals)
+    : methods(std::move(methods)) {
+  interval_index.reserve(this->methods.size());
+  for (const auto* method : this->methods) {
+    const auto& interval = class_intervals.get_interval(method->get_class());
+    std::uint32_t lower_bound = 0;
+    if (!interval.is_top() && !interval.is_bottom()) {
+      lower_bound = interval.lower_bound();
+    }
+    interval_index.emplace_back(lower_bound, method);
+  }
+  std::sort(interval_index.begin(), interval_index.end());
 }
 
 const std::unordered_set<const Method*>& Overrides::empty_method_set() const {
   return empty_method_set_;
 }
 
+const Overrides::IntervalIndex& Overrides::empty_interval_index() const {
+  return empty_interval_index_;
+}
+
 bool Overrides::has_obscure_override_for(const Method* method) const {
   const auto& overrides = get(method);
   for (const auto* override : overrides) {
@@ -92,11 +253,31 @@ bool Overrides::has_obscure_override_for(const Method* method) const {
   return false;
 }
 
+std::size_t Overrides::memory_usage() const {
+  std::size_t bytes = override_sets_.memory_usage() +
+      memory_usage::nodes<std::pair<const Method*, const OverrideSet*>>(
+                          overrides_.size());
+  for (const auto& [methods, override_set] : override_sets_) {
+    bytes += memory_usage::contiguous(methods) +
+        memory_usage::nodes<const Method*>(override_set->methods.size()) +
+        memory_usage::contiguous(override_set->interval_index);
+  }
+  return bytes;
+}
+
+void Overrides::dump(const Options& options) const {
+  if (options.dump_overrides()) {
+    auto overrides_path = options.overrides_output_path();
+    LOG(1, "Writing override graph to `{}`", overrides_path.native());
+    JsonValidation::write_json_file(overrides_path, to_json());
+  }
+}
+
 Json::Value Overrides::to_json() const {
   auto value = Json::Value(Json::objectValue);
   for (auto [method, overrides] : overrides_) {
     auto overrides_value = Json::Value(Json::arrayValue);
-    for (const auto* override : *overrides) {
+    for (const auto* override : overrides->methods) {
       overrides_value.append(Json::Value(show(override)));
     }
     value[method->show()] = overrides_value;
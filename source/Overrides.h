@@ -7,33 +7,79 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <boost/functional/hash.hpp>
 #include <json/json.h>
 
 #include <DexStore.h>
 
+#include <mariana-trench/ClassIntervals.h>
+#include <mariana-trench/GraphSnapshot.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/Options.h>
-#include <mariana-trench/UniquePointerConcurrentMap.h>
+#include <mariana-trench/UniquePointerFactory.h>
 
 namespace marianatrench {
 
 class Overrides final {
+ public:
+  /**
+   * Overrides of a method, sorted by the lower bound of the class interval of
+   * their class. Overrides in classes without a finite interval have a lower
+   * bound of 0 and come first.
+   */
+  using IntervalIndex = std::vector<std::pair<std::uint32_t, const Method*>>;
+
  public:
   explicit Overrides(
       const Options& options,
       const Methods& methods,
+      const ClassIntervals& class_intervals,
       const DexStoresVector& stores);
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Overrides)
 
+  /**
+   * Create the override graph from a snapshot. Return nullptr if the snapshot
+   * refers to unknown methods.
+   */
+  static std::unique_ptr<Overrides> from_snapshot(
+      const Options& options,
+      const Methods& methods,
+      const ClassIntervals& class_intervals,
+      const GraphSnapshot::Edges& edges);
+
+  GraphSnapshot::Edges to_snapshot() const;
+
   /**
    * Return the set of methods overriding the given method.
    */
   const std::unordered_set<const Method*>& get(const Method* method) const;
 
+  /**
+   * Return the overrides of the given method, indexed by class interval.
+   */
+  const IntervalIndex& get_interval_index(const Method* method) const;
+
+  /**
+   * Return the range `[begin, end)` of the entries of the given index that are
+   * defined in a strict subclass of the given type.
+   *
+   * Return `std::nullopt` if this cannot be answered using class intervals,
+   * e.g for interfaces, since class intervals do not take implemented
+   * interfaces into account.
+   */
+  std::optional<std::pair<std::size_t, std::size_t>> subclasses_range(
+      const IntervalIndex& index,
+      const DexType* type) const;
+
   /**
    * Set the override set of the given method.
    *
@@ -42,16 +88,60 @@ class Overrides final {
    */
   void set(const Method* method, std::unordered_set<const Method*> overrides);
 
+  /* Return the number of distinct override sets. */
+  std::size_t number_of_distinct_sets() const;
+
   const std::unordered_set<const Method*>& empty_method_set() const;
 
+  const IntervalIndex& empty_interval_index() const;
+
   bool has_obscure_override_for(const Method* method) const;
 
+  /* Approximate memory used, in bytes. This is not thread-safe. */
+  std::size_t memory_usage() const;
+
   Json::Value to_json() const;
 
  private:
-  UniquePointerConcurrentMap<const Method*, std::unordered_set<const Method*>>
-      overrides_;
+  /**
+   * A set of overrides. Methods with equal override sets share the same
+   * instance, e.g bridge methods and the method they bridge to.
+   */
+  struct OverrideSet {
+    OverrideSet(
+        std::unordered_set<const Method*> methods,
+        const ClassIntervals& class_intervals);
+
+    std::unordered_set<const Method*> methods;
+    IntervalIndex interval_index;
+  };
+
+  struct SortedMethodsHash {
+    std::size_t operator()(const std::vector<const Method*>& methods) const {
+      return boost::hash_range(methods.begin(), methods.end());
+    }
+  };
+
+  explicit Overrides(const ClassIntervals& class_intervals)
+      : class_intervals_(class_intervals) {}
+
+  /* Return the shared override set of the given methods, thread-safe. */
+  const OverrideSet* create_override_set(
+      std::unordered_set<const Method*> overrides);
+
+  void dump(const Options& options) const;
+
+ private:
+  const ClassIntervals& class_intervals_;
+  // Override sets, keyed by their sorted elements.
+  UniquePointerFactory<
+      std::vector<const Method*>,
+      OverrideSet,
+      SortedMethodsHash>
+      override_sets_{CacheStatistics::Cache::OverrideSets};
+  ConcurrentMap<const Method*, const OverrideSet*> overrides_;
   std::unordered_set<const Method*> empty_method_set_;
+  IntervalIndex empty_interval_index_;
 };
 
 } // namespace marianatrench
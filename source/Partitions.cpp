@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Partitions.h>
+
+namespace marianatrench {
+
+Partitions::Partitions(const Scheduler& scheduler, std::size_t partitions)
+    : scheduler_(scheduler) {
+  mt_assert(partitions > 0);
+  auto components_size = scheduler.components_size();
+  partition_of_component_.resize(components_size);
+  exported_.resize(components_size, false);
+  statistics_.resize(partitions);
+
+  std::vector<double> costs(components_size);
+  double total_cost = 0.0;
+  for (std::size_t component = 0; component < components_size; component++) {
+    costs[component] = std::max(scheduler.component_cost(component), 1.0);
+    total_cost += costs[component];
+  }
+  auto capacity = (1.0 + kBalanceTolerance) * total_cost /
+      static_cast<double>(partitions);
+
+  std::vector<std::vector<std::size_t>> callee_components(components_size);
+  for (std::size_t component = 0; component < components_size; component++) {
+    for (auto dependent : scheduler.dependent_components(component)) {
+      callee_components[dependent].push_back(component);
+    }
+  }
+
+  // Callee components have a lower index, hence are assigned first.
+  for (std::size_t component = 0; component < components_size; component++) {
+    std::unordered_map<std::size_t, double> affinities;
+    for (auto callee : callee_components[component]) {
+      affinities[partition_of_component_[callee]] += costs[callee];
+    }
+
+    auto least_loaded = static_cast<std::size_t>(std::distance(
+        statistics_.begin(),
+        std::min_element(
+            statistics_.begin(),
+            statistics_.end(),
+            [](const Statistics& left, const Statistics& right) {
+              return left.cost < right.cost;
+            })));
+    auto partition = least_loaded;
+    double best_affinity = 0.0;
+    for (const auto& [candidate, affinity] : affinities) {
+      if (statistics_[candidate].cost + costs[component] > capacity) {
+        continue;
+      }
+      if (affinity > best_affinity ||
+          (affinity == best_affinity && candidate < partition)) {
+        partition = candidate;
+        best_affinity = affinity;
+      }
+    }
+
+    partition_of_component_[component] = static_cast<std::uint32_t>(partition);
+    auto& statistics = statistics_[partition];
+    statistics.components++;
+    statistics.methods += scheduler.component(component).size();
+    statistics.cost += costs[component];
+  }
+
+  for (std::size_t component = 0; component < components_size; component++) {
+    auto partition = partition_of_component_[component];
+    std::vector<bool> importing_partitions(partitions, false);
+    for (auto dependent : scheduler.dependent_components(component)) {
+      auto dependent_partition = partition_of_component_[dependent];
+      if (dependent_partition != partition) {
+        cut_edges_++;
+        importing_partitions[dependent_partition] = true;
+      }
+    }
+    for (std::size_t other = 0; other < partitions; other++) {
+      if (importing_partitions[other]) {
+        statistics_[other].imported_components++;
+        exported_[component] = true;
+      }
+    }
+    if (exported_[component]) {
+      statistics_[partition].exported_components++;
+      statistics_[partition].exported_methods +=
+          scheduler.component(component).size();
+    }
+  }
+}
+
+std::size_t Partitions::size() const {
+  return statistics_.size();
+}
+
+std::size_t Partitions::partition_of_component(std::size_t component) const {
+  return partition_of_component_.at(component);
+}
+
+std::size_t Partitions::partition_of(const Method* method) const {
+  return partition_of_component(scheduler_.component_of(method));
+}
+
+bool Partitions::is_exported(std::size_t component) const {
+  return exported_.at(component);
+}
+
+Json::Value Partitions::to_json() const {
+  auto partitions_value = Json::Value(Json::arrayValue);
+  for (const auto& statistics : statistics_) {
+    auto partition_value = Json::Value(Json::objectValue);
+    partition_value["components"] =
+        Json::Value(static_cast<Json::UInt64>(statistics.components));
+    partition_value["methods"] =
+        Json::Value(static_cast<Json::UInt64>(statistics.methods));
+    partition_value["cost"] = Json::Value(statistics.cost);
+    partition_value["imported_components"] =
+        Json::Value(static_cast<Json::UInt64>(statistics.imported_components));
+    partition_value["exported_components"] =
+        Json::Value(static_cast<Json::UInt64>(statistics.exported_components));
+    partition_value["exported_methods"] =
+        Json::Value(static_cast<Json::UInt64>(statistics.exported_methods));
+    partition_value["assigned_methods"] = Json::Value(Json::arrayValue);
+    partitions_value.append(partition_value);
+  }
+  for (std::size_t component = 0; component < partition_of_component_.size();
+       component++) {
+    auto& methods_value =
+        partitions_value[partition_of_component_[component]]
+                        ["assigned_methods"];
+    for (const auto* method : scheduler_.component(component)) {
+      methods_value.append(Json::Value(method->show()));
+    }
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["partitions"] = partitions_value;
+  value["cut_edges"] = Json::Value(static_cast<Json::UInt64>(cut_edges_));
+  return value;
+}
+
+void Partitions::dump(const std::filesystem::path& path) const {
+  LOG(1, "Writing partitions to `{}`", path.native());
+  JsonValidation::write_json_file(path, to_json());
+}
+
+} // namespace marianatrench
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <json/json.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Scheduler.h>
+
+namespace marianatrench {
+
+/**
+ * Partition of the graph of strongly connected components across hosts, for
+ * a distributed strongly connected components fixpoint.
+ *
+ * Each host would own the models of the methods of its partition, and only
+ * exchange the caller-visible models of components with callers in other
+ * partitions. Since components are analyzed once their callee components are
+ * stable, each boundary model is exchanged once.
+ *
+ * Components are assigned in topological order (callees first) to the
+ * partition owning most of the cost of their callee components, as long as it
+ * stays within the balance tolerance, or to the least loaded partition. The
+ * assignment is deterministic, so each host can compute it independently.
+ */
+class Partitions final {
+ public:
+  explicit Partitions(const Scheduler& scheduler, std::size_t partitions);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Partitions)
+
+  std::size_t size() const;
+
+  std::size_t partition_of_component(std::size_t component) const;
+
+  std::size_t partition_of(const Method* method) const;
+
+  /* Whether the component has callers in other partitions. */
+  bool is_exported(std::size_t component) const;
+
+  Json::Value to_json() const;
+
+  void dump(const std::filesystem::path& path) const;
+
+  /* Maximum imbalance of the cost of a partition against the average. */
+  constexpr static double kBalanceTolerance = 0.05;
+
+ private:
+  struct Statistics {
+    std::size_t components = 0;
+    std::size_t methods = 0;
+    double cost = 0.0;
+    // Components of other partitions containing callees of this partition.
+    std::size_t imported_components = 0;
+    // Components of this partition containing callees of other partitions.
+    std::size_t exported_components = 0;
+    std::size_t exported_methods = 0;
+  };
+
+ private:
+  const Scheduler& scheduler_;
+  std::vector<std::uint32_t> partition_of_component_;
+  std::vector<bool> exported_;
+  std::vector<Statistics> statistics_;
+  std::size_t cut_edges_ = 0;
+};
+
+} // namespace marianatrench
@@ -13,7 +13,7 @@
 namespace marianatrench {
 
 struct PathTreeConfiguration {
-  static std::size_t max_tree_height_after_widening() {
+  static constexpr std::size_t max_tree_height_after_widening() {
     return Heuristics::kPropagationOutputPathTreeWideningHeight;
   }
 
@@ -21,16 +21,18 @@ Position::Position(
     int start,
     int end)
     : path_(path),
+      instruction_and_has_port_(instruction, port ? 1 : 0),
+      port_(port.value_or(Root(Root::Kind::Return))),
       line_(line),
-      port_(port),
-      instruction_(instruction),
       start_(start),
       end_(end) {}
 
+static_assert(sizeof(Position) <= 32);
+
 bool Position::operator==(const Position& other) const {
   return path_ == other.path_ && line_ == other.line_ && port_ == other.port_ &&
-      instruction_ == other.instruction_ && start_ == other.start_ &&
-      end_ == other.end_;
+      instruction_and_has_port_ == other.instruction_and_has_port_ &&
+      start_ == other.start_ && end_ == other.end_;
 }
 
 bool Position::operator!=(const Position& other) const {
@@ -102,6 +104,23 @@ Json::Value Position::to_json(bool with_path) const {
   return value;
 }
 
+void Position::write_json(JsonWriter& writer, bool with_path) const {
+  writer.begin_object();
+  if (end_ != k_unknown_end) {
+    writer.key("end").value(end_);
+  }
+  if (line_ != k_unknown_line) {
+    writer.key("line").value(line_);
+  }
+  if (with_path && path_) {
+    writer.key("path").value(*path_);
+  }
+  if (start_ != k_unknown_start) {
+    writer.key("start").value(start_);
+  }
+  writer.end_object();
+}
+
 bool Position::overlaps(const Position& other) const {
   mt_assert(path_ != nullptr);
   mt_assert(other.path() != nullptr);
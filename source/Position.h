@@ -18,6 +18,8 @@
 #include <mariana-trench/Compiler.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
+#include <mariana-trench/PointerIntPair.h>
 
 namespace {
 
@@ -53,11 +55,14 @@ class Position final {
   }
 
   std::optional<Root> port() const {
+    if (instruction_and_has_port_.get_int() == 0) {
+      return std::nullopt;
+    }
     return port_;
   }
 
   const IRInstruction* instruction() const {
-    return instruction_;
+    return instruction_and_has_port_.get_pointer();
   }
 
   int start() const {
@@ -72,18 +77,22 @@ class Position final {
 
   static const Position* from_json(const Json::Value& value, Context& context);
   Json::Value to_json(bool with_path = true) const;
+  void write_json(JsonWriter& writer, bool with_path = true) const;
 
   bool overlaps(const Position& other) const;
 
  private:
   friend struct std::hash<Position>;
 
+  // Positions are interned for every instruction with taint, hence the port
+  // is stored without an `std::optional`: whether it is set is stored in the
+  // low bit of the instruction pointer. This keeps positions to 32 bytes.
   const std::string* MT_NULLABLE path_;
-  int line_;
+  PointerIntPair<const IRInstruction*, 1, unsigned> instruction_and_has_port_;
   // The return value or argument through which taint is flowing in the
-  // IRInstruction on the given line
-  std::optional<Root> port_;
-  const IRInstruction* instruction_;
+  // IRInstruction on the given line. This is `Root::Kind::Return` when unset.
+  Root port_;
+  int line_;
   // These describe the portion of the line (i.e, columns) of source code to
   // highlight in the UI
   int start_;
@@ -98,10 +107,8 @@ struct std::hash<marianatrench::Position> {
     std::size_t seed = 0;
     boost::hash_combine(seed, position.path_);
     boost::hash_combine(seed, position.line_);
-    if (position.port_) {
-      boost::hash_combine(seed, position.port_->hash());
-    }
-    boost::hash_combine(seed, position.instruction_);
+    boost::hash_combine(seed, position.port_.hash());
+    boost::hash_combine(seed, position.instruction_and_has_port_.encode());
     boost::hash_combine(seed, position.start_);
     boost::hash_combine(seed, position.end_);
     return seed;
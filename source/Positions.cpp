@@ -5,9 +5,14 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
@@ -16,8 +21,6 @@
 #include <fmt/format.h>
 #include <re2/re2.h>
 
-#include <sparta/WorkQueue.h>
-
 #include <ConcurrentContainers.h>
 #include <DexClass.h>
 #include <IRCode.h>
@@ -25,10 +28,14 @@
 #include <Walkers.h>
 
 #include <mariana-trench/Assert.h>
+#include <mariana-trench/CacheStatistics.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/Positions.h>
+#include <mariana-trench/SourceIndexCache.h>
 #include <mariana-trench/Timer.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -43,11 +50,76 @@ struct GrepoPaths {
 
 // Performance optimization to avoid calling more expensive regex matches on
 // every line.
-bool maybe_class(const std::string& line) {
-  return line.find("class") != std::string::npos ||
-      line.find("interface") != std::string::npos ||
-      line.find("object") != std::string::npos ||
-      line.find("enum") != std::string::npos;
+bool maybe_class(std::string_view line) {
+  return line.find("class") != std::string_view::npos ||
+      line.find("interface") != std::string_view::npos ||
+      line.find("object") != std::string_view::npos ||
+      line.find("enum") != std::string_view::npos;
+}
+
+// A class declaration starts with a comment, a modifier or the keyword, see
+// the class regex in `SourceFileIndexer`.
+constexpr std::array<std::string_view, 12> k_declaration_prefixes = {
+    "/*",
+    "abstract",
+    "class",
+    "data",
+    "enum",
+    "final",
+    "interface",
+    "internal",
+    "object",
+    "open",
+    "private",
+    "public",
+};
+
+bool maybe_declaration(std::string_view line) {
+  std::size_t begin = 0;
+  while (begin < line.size() &&
+         (line[begin] == ' ' || line[begin] == '\t' || line[begin] == '\f' ||
+          line[begin] == '\r')) {
+    begin++;
+  }
+  line.remove_prefix(begin);
+  return std::any_of(
+      k_declaration_prefixes.begin(),
+      k_declaration_prefixes.end(),
+      [line](std::string_view prefix) {
+        return line.substr(0, prefix.size()) == prefix;
+      });
+}
+
+/* Read the whole file into `buffer`, reusing its storage. */
+bool read_file(const std::string& path, std::string& buffer) {
+  std::ifstream stream(path, std::ios_base::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+  stream.seekg(0, std::ios_base::end);
+  auto size = stream.tellg();
+  if (size < 0) {
+    return false;
+  }
+  stream.seekg(0, std::ios_base::beg);
+  buffer.resize(static_cast<std::size_t>(size));
+  stream.read(buffer.data(), size);
+  buffer.resize(static_cast<std::size_t>(stream.gcount()));
+  return true;
+}
+
+/* Quote the given string for `sh`. */
+std::string shell_quote(const std::string& string) {
+  return fmt::format("'{}'", boost::replace_all_copy(string, "'", "'\\''"));
+}
+
+/* The line of `text` starting at `begin`, without its line feed. */
+std::string_view line_at(std::string_view text, std::size_t begin) {
+  auto end = text.find('\n', begin);
+  if (end == std::string_view::npos) {
+    end = text.size();
+  }
+  return text.substr(begin, end - begin);
 }
 
 GrepoPaths get_grepo_paths(
@@ -102,109 +174,170 @@ GrepoPaths get_grepo_paths(
   return GrepoPaths{actual_paths, actual_to_repo_paths};
 }
 
-void add_to_class_to_path_map(
-    std::vector<std::string>& exclude_directories,
-    std::atomic<std::size_t>& iteration,
-    std::vector<std::string>& paths,
-    ConcurrentMap<std::string, std::string>& class_to_path,
-    const std::unordered_map<std::string, std::string>& repo_paths) {
-  Timer index_timer;
-  LOG(2, "Indexing {} files...", paths.size());
+/**
+ * Index the top-level classes declared in java and kotlin source files.
+ * Relative paths are relative to the source root directory, which is not the
+ * current directory: other setup steps run concurrently with the indexing.
+ */
+class SourceFileIndexer final {
+ public:
+  SourceFileIndexer(
+      std::filesystem::path source_root_directory,
+      const std::vector<std::string>& exclude_directories,
+      ConcurrentMap<std::string, std::string>& class_to_path,
+      const std::unordered_map<std::string, std::string>& repo_paths,
+      SourceIndexCache* MT_NULLABLE cache)
+      : source_root_directory_(std::move(source_root_directory)),
+        exclude_directories_(exclude_directories),
+        class_to_path_(class_to_path),
+        repo_paths_(repo_paths),
+        cache_(cache),
+        package_regex_("^package\\s+([^;]+)(?:;|$)"),
+        class_regex_(
+            "^\\s*(?:/\\*.*\\*/)?\\s*(?:public|internal|private)?\\s*(?:abstract|data|final|open)?\\s*(?:class|enum|interface|object)\\s+([A-z0-9]+)"),
+        skipped_package_prefixes_({"android/"}) {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(SourceFileIndexer)
+
+  /* Whether the given path is in an excluded directory. */
+  bool is_excluded(const std::string& path) const {
+    for (const auto& exclude_directory : exclude_directories_) {
+      if (boost::starts_with(path, exclude_directory)) {
+        return true;
+      }
+    }
+    return false;
+  }
 
-  re2::RE2 package_regex("^package\\s+([^;]+)(?:;|$)");
-  re2::RE2 class_regex(
-      "^\\s*(?:/\\*.*\\*/)?\\s*(?:public|internal|private)?\\s*(?:abstract|data|final|open)?\\s*(?:class|enum|interface|object)\\s+([A-z0-9]+)");
-  std::unordered_set<std::string> skipped_package_prefixes = {
-      "android/",
-  };
+  /* This is thread-safe. */
+  void index(std::string path) {
+    auto iteration = ++files_;
+    if (iteration % 10000 == 0) {
+      LOG(2, "Indexed {} files.", iteration);
+    }
 
-  auto queue = sparta::work_queue<std::string*>(
-      [&](std::string* path) {
-        iteration++;
-        if (iteration % 10000 == 0) {
-          LOG(2, "Indexed {} of {} files.", iteration.load(), paths.size());
-        }
+    if (boost::starts_with(path, "./")) {
+      // Remove the `./` prefix added by `find`.
+      path.erase(0, 2);
+    }
+    if (path.empty() || is_excluded(path)) {
+      return;
+    }
 
-        if (boost::starts_with(*path, "./")) {
-          // Remove the `./` prefix added by `find`.
-          path->erase(0, 2);
-        }
-        if (path->empty()) {
-          return;
-        }
-        for (const auto& exclude_directory : exclude_directories) {
-          if (boost::starts_with(*path, exclude_directory)) {
-            return;
-          }
-        }
+    std::string final_path = path;
+    if (auto find = repo_paths_.find(path); find != repo_paths_.end()) {
+      final_path = find->second;
+    }
 
-        std::optional<std::string> package = std::nullopt;
-        std::string final_path = *path;
-        if (auto find = repo_paths.find(*path); find != repo_paths.end()) {
-          final_path = find->second;
-        }
+    std::optional<std::vector<std::string>> classes;
+    if (cache_ != nullptr) {
+      classes = cache_->get(path);
+    }
+    if (!classes) {
+      classes = scan(path);
+      if (cache_ != nullptr) {
+        cache_->set(path, *classes);
+      }
+    }
 
-        std::ifstream stream(*path);
-        std::string line;
-        while (std::getline(stream, line)) {
-          re2::StringPiece package_match;
-          // Using capturing groups with `re2` is very slow, so we only
-          // capture if we know the regex matches. This gives a huge
-          // performance boost.
-          if (!package && re2::RE2::PartialMatch(line, package_regex) &&
-              re2::RE2::PartialMatch(line, package_regex, &package_match)) {
-            package = std::string{package_match};
-            boost::replace_all(*package, ".", "/");
-            if (std::any_of(
-                    skipped_package_prefixes.begin(),
-                    skipped_package_prefixes.end(),
-                    [&package](const auto& skipped_prefix) {
-                      return boost::starts_with(*package, skipped_prefix);
-                    })) {
-              LOG(3, "Skipping module `{}` at `{}`...", *package, *path);
+    for (const auto& classname : *classes) {
+      class_to_path_.update(
+          classname,
+          [&final_path](
+              const std::string& /* classname */,
+              std::string& value,
+              bool exists) mutable {
+            if (exists && value < final_path) {
               return;
             }
-            if (boost::ends_with(*path, ".kt")) {
-              auto pos = path->find_last_of("/");
-              if (pos != std::string::npos) {
-                auto filename = path->substr(pos + 1, path->size() - pos - 4);
-                auto classname = fmt::format("L{}/{}Kt;", *package, filename);
-
-                class_to_path.update(
-                    classname,
-                    [&final_path](
-                        const std::string& /* classname */,
-                        std::string& value,
-                        bool exists) mutable {
-                      if (exists && value < final_path) {
-                        return;
-                      }
-                      value = final_path;
-                    });
-              }
-            }
-          }
+            value = final_path;
+          });
+    }
+  }
 
-          re2::StringPiece class_match;
-          if (package && maybe_class(line) &&
-              re2::RE2::PartialMatch(line, class_regex) &&
-              re2::RE2::PartialMatch(line, class_regex, &class_match)) {
-            auto classname = fmt::format("L{}/{};", *package, class_match);
-
-            class_to_path.update(
-                classname,
-                [&final_path](
-                    const std::string& /* classname */,
-                    std::string& value,
-                    bool exists) mutable {
-                  if (exists && value < final_path) {
-                    return;
-                  }
-                  value = final_path;
-                });
+  std::size_t files() const {
+    return files_;
+  }
+
+  const std::filesystem::path& source_root_directory() const {
+    return source_root_directory_;
+  }
+
+ private:
+  /* Return the top-level classes declared in the given file. */
+  std::vector<std::string> scan(const std::string& path) const {
+    thread_local std::string buffer;
+    if (!read_file((source_root_directory_ / path).string(), buffer)) {
+      return {};
+    }
+    auto text = std::string_view(buffer);
+
+    // Lines are split with `memchr` over the whole file, and cheap prefix
+    // checks filter the lines to match against the regexes.
+    std::vector<std::string> classes;
+    std::optional<std::string> package = std::nullopt;
+    for (std::size_t offset = 0; offset < text.size();) {
+      auto line = line_at(text, offset);
+      offset += line.size() + 1;
+      auto line_piece = re2::StringPiece(line.data(), line.size());
+
+      re2::StringPiece package_match;
+      // Using capturing groups with `re2` is very slow, so we only
+      // capture if we know the regex matches. This gives a huge
+      // performance boost.
+      if (!package && line.substr(0, 7) == "package" &&
+          re2::RE2::PartialMatch(line_piece, package_regex_) &&
+          re2::RE2::PartialMatch(line_piece, package_regex_, &package_match)) {
+        package = std::string{package_match};
+        boost::replace_all(*package, ".", "/");
+        if (std::any_of(
+                skipped_package_prefixes_.begin(),
+                skipped_package_prefixes_.end(),
+                [&package](const auto& skipped_prefix) {
+                  return boost::starts_with(*package, skipped_prefix);
+                })) {
+          LOG(3, "Skipping module `{}` at `{}`...", *package, path);
+          return {};
+        }
+        if (boost::ends_with(path, ".kt")) {
+          auto pos = path.find_last_of("/");
+          if (pos != std::string::npos) {
+            auto filename = path.substr(pos + 1, path.size() - pos - 4);
+            classes.push_back(fmt::format("L{}/{}Kt;", *package, filename));
           }
         }
-      },
+      }
+
+      re2::StringPiece class_match;
+      if (package && maybe_declaration(line) && maybe_class(line) &&
+          re2::RE2::PartialMatch(line_piece, class_regex_) &&
+          re2::RE2::PartialMatch(line_piece, class_regex_, &class_match)) {
+        classes.push_back(fmt::format("L{}/{};", *package, class_match));
+      }
+    }
+    return classes;
+  }
+
+ private:
+  std::filesystem::path source_root_directory_;
+  const std::vector<std::string>& exclude_directories_;
+  ConcurrentMap<std::string, std::string>& class_to_path_;
+  const std::unordered_map<std::string, std::string>& repo_paths_;
+  SourceIndexCache* MT_NULLABLE cache_;
+  re2::RE2 package_regex_;
+  re2::RE2 class_regex_;
+  std::vector<std::string> skipped_package_prefixes_;
+  std::atomic<std::size_t> files_{0};
+};
+
+void add_to_class_to_path_map(
+    SourceFileIndexer& indexer,
+    std::vector<std::string>& paths) {
+  Timer index_timer;
+  LOG(2, "Indexing {} files...", paths.size());
+
+  auto queue = work_queue<std::string*>(
+      [&](std::string* path) { indexer.index(std::move(*path)); },
       sparta::parallel::default_num_threads());
   for (auto& path : paths) {
     queue.add_item(&path);
@@ -212,8 +345,75 @@ void add_to_class_to_path_map(
   queue.run_all();
 
   LOG(2,
-      "Indexed {} top-level classes in {:.2f}s.",
-      class_to_path.size(),
+      "Indexed {} files in {:.2f}s.",
+      paths.size(),
+      index_timer.duration_in_seconds());
+}
+
+bool is_source_file(const std::filesystem::path& path) {
+  auto extension = boost::algorithm::to_lower_copy(path.extension().string());
+  return extension == ".java" || extension == ".kt" ||
+      extension == ".mustache";
+}
+
+/**
+ * Walk the source root directory in parallel and index java, kotlin and
+ * mustache files as they are found, so that scanning overlaps with discovery.
+ * Directories are listed in separate tasks of the same queue, by their path
+ * relative to the source root directory.
+ */
+void walk_and_add_to_class_to_path_map(SourceFileIndexer& indexer) {
+  Timer index_timer;
+  LOG(2, "Walking and indexing files...");
+
+  std::atomic<std::size_t> directories(0);
+  auto queue = work_queue<std::filesystem::path>(
+      [&](WorkerState<std::filesystem::path>* worker_state,
+          const std::filesystem::path& directory) {
+        std::error_code error;
+        auto iterator = std::filesystem::directory_iterator(
+            indexer.source_root_directory() / directory,
+            std::filesystem::directory_options::skip_permission_denied,
+            error);
+        if (error) {
+          WARNING(
+              2,
+              "Unable to list `{}`: {}",
+              directory.native(),
+              error.message());
+          return;
+        }
+        directories++;
+
+        for (const auto& entry : iterator) {
+          // As `find -type f`, symbolic links are not followed.
+          auto status = entry.symlink_status(error);
+          if (error) {
+            continue;
+          }
+          auto path = directory / entry.path().filename();
+          if (std::filesystem::is_directory(status)) {
+            if (path == ".ovrsource-rest" ||
+                indexer.is_excluded(path.string() + "/")) {
+              continue;
+            }
+            worker_state->push_task(path);
+          } else if (
+              std::filesystem::is_regular_file(status) &&
+              is_source_file(path)) {
+            indexer.index(path.string());
+          }
+        }
+      },
+      sparta::parallel::default_num_threads(),
+      /* push_tasks_while_running */ true);
+  queue.add_item(std::filesystem::path());
+  queue.run_all();
+
+  LOG(2,
+      "Walked {} directories and indexed {} files in {:.2f}s.",
+      directories.load(),
+      indexer.files(),
       index_timer.duration_in_seconds());
 }
 
@@ -243,12 +443,20 @@ Positions::Positions(const Options& options, const DexStoresVector& stores) {
         "Finding files to index in `{}`...",
         options.source_root_directory());
 
-    // Save current path
-    auto current_path = std::filesystem::current_path();
-    std::filesystem::path source_root_directory{
-        options.source_root_directory()};
-    // Switch to source root directory.
-    std::filesystem::current_path(source_root_directory);
+    // Classes declared in unchanged files are reused from the previous run.
+    std::unique_ptr<SourceIndexCache> cache;
+    if (const auto& cache_directory = options.analysis_cache_directory()) {
+      cache = std::make_unique<SourceIndexCache>(
+          *cache_directory,
+          std::filesystem::absolute(options.source_root_directory()).string());
+    }
+
+    // Commands run in the source root directory. The current directory is
+    // not changed, since other setup steps run concurrently.
+    auto source_root_directory =
+        std::filesystem::absolute(options.source_root_directory());
+    auto change_directory =
+        fmt::format("cd {} && ", shell_quote(source_root_directory.string()));
 
     auto exclude_directories = options.source_exclude_directories();
     for (auto& exclude_directory : exclude_directories) {
@@ -257,7 +465,6 @@ Positions::Positions(const Options& options, const DexStoresVector& stores) {
       }
     }
 
-    std::atomic<std::size_t> iteration(0);
     ConcurrentMap<std::string, std::string> class_to_path;
 
     if (auto grepo_metadata_path = options.grepo_metadata_path();
@@ -281,7 +488,8 @@ Positions::Positions(const Options& options, const DexStoresVector& stores) {
           "repo forall -c 'git ls-files -- '\''*java'\'' '\''*kt'\'' '\'':!:test/*'\'' | xargs -n1 printf \"$REPO_PATH:$PWD:%s\\n\"'";
 
       int return_code = -1;
-      std::string output = execute_and_catch_output(repo_command, return_code);
+      std::string output = execute_and_catch_output(
+          change_directory + repo_command, return_code);
 
       if (return_code == EXIT_SUCCESS) {
         auto grepo_paths =
@@ -292,54 +500,56 @@ Positions::Positions(const Options& options, const DexStoresVector& stores) {
             grepo_paths.actual_paths.size(),
             paths_timer.duration_in_seconds());
 
-        add_to_class_to_path_map(
+        SourceFileIndexer indexer(
+            source_root_directory,
             exclude_directories,
-            iteration,
-            grepo_paths.actual_paths,
             class_to_path,
-            grepo_paths.actual_to_repo_paths);
+            grepo_paths.actual_to_repo_paths,
+            cache.get());
+        add_to_class_to_path_map(indexer, grepo_paths.actual_paths);
       } else {
         ERROR(1, "`{}` failed, no source file will be indexed.", repo_command);
       }
     } else {
       std::string hg_command =
           "hg files --include=**.java --include=**.kt --include=**.mustache --exclude=.ovrsource-rest";
-      std::string find_command =
-          "find . -type f \\( -iname \\*.java -o -iname \\*.kt -o -iname \\*.mustache \\) -not -path ./.ovrsource-rest/\\*";
 
+      const std::unordered_map<std::string, std::string> repo_paths;
+      SourceFileIndexer indexer(
+          source_root_directory,
+          exclude_directories,
+          class_to_path,
+          repo_paths,
+          cache.get());
       int return_code = -1;
-      std::string output = execute_and_catch_output(hg_command, return_code);
-
-      if (return_code != EXIT_SUCCESS) {
-        WARNING(
-            1,
-            "Source directory is not a mercurial repository. Trying `find` to discover files.");
-        output = execute_and_catch_output(find_command, return_code);
-        if (return_code != EXIT_SUCCESS) {
-          ERROR(1, "`find` failed, no source file will be indexed.");
-        }
-      }
+      std::string output = execute_and_catch_output(
+          change_directory + hg_command, return_code);
 
       if (return_code == EXIT_SUCCESS) {
         std::vector<std::string> paths;
         boost::split(paths, output, boost::is_any_of("\n"));
+        output.clear();
+        output.shrink_to_fit();
 
         LOG(2,
             "Found {} files in {:.2f}s.",
             paths.size(),
             paths_timer.duration_in_seconds());
 
-        add_to_class_to_path_map(
-            exclude_directories,
-            iteration,
-            paths,
-            class_to_path,
-            /* actual_to_repo_paths */ {});
+        add_to_class_to_path_map(indexer, paths);
+      } else {
+        WARNING(
+            1,
+            "Source directory is not a mercurial repository. Walking the directory to discover files.");
+        walk_and_add_to_class_to_path_map(indexer);
       }
     }
 
-    // Switch back to current path.
-    std::filesystem::current_path(current_path);
+    LOG(2, "Indexed {} top-level classes.", class_to_path.size());
+
+    if (cache != nullptr) {
+      cache->store();
+    }
     Timer method_paths_timer;
     LOG(2, "Indexing method paths...");
 
@@ -440,7 +650,7 @@ const Position* Positions::get(
     line = method_to_line_.get(method, /* default */ k_unknown_line);
   }
 
-  return positions_.insert(Position(path, line, port, instruction)).first;
+  return intern(Position(path, line, port, instruction));
 }
 
 const Position* Positions::get(
@@ -462,8 +672,7 @@ const Position* Positions::get(
 
   const std::string* path = method_to_path_.get(method, /* default */ nullptr);
 
-  return positions_.insert(Position(path, line, port, instruction, start, end))
-      .first;
+  return intern(Position(path, line, port, instruction, start, end));
 }
 
 const Position* Positions::get(
@@ -480,7 +689,7 @@ const Position* Positions::get(
       /* instruction */ instruction,
       /* start */ start,
       /* end */ end);
-  return positions_.insert(position).first;
+  return intern(position);
 }
 
 const Position* Positions::get(
@@ -493,7 +702,7 @@ const Position* Positions::get(
       /* line */ position->line(),
       /* port */ port,
       /* instruction */ instruction);
-  return positions_.insert(new_position).first;
+  return intern(new_position);
 }
 
 const Position*
@@ -506,11 +715,11 @@ Positions::get(const Position* position, int line, int start, int end) const {
       /* instruction */ position->instruction(),
       /* start */ start,
       /* end */ end);
-  return positions_.insert(new_position).first;
+  return intern(new_position);
 };
 
 const Position* Positions::unknown() const {
-  return positions_.insert(Position(nullptr, k_unknown_line)).first;
+  return intern(Position(nullptr, k_unknown_line));
 }
 
 const std::string* MT_NULLABLE
@@ -518,4 +727,56 @@ Positions::get_path(const DexMethod* method) const {
   return method_to_path_.get(method, /* default */ nullptr);
 }
 
+std::size_t Positions::memory_usage() const {
+  std::size_t bytes = memory_usage::nodes<std::string>(paths_.size()) +
+      memory_usage::nodes<Position>(positions_.size()) +
+      memory_usage::nodes<std::pair<const DexMethod*, const std::string*>>(
+                          method_to_path_.size()) +
+      memory_usage::nodes<std::pair<const DexMethod*, int>>(
+                          method_to_line_.size());
+  for (const auto& path : paths_) {
+    bytes += path.capacity();
+  }
+  return bytes;
+}
+
+std::uint64_t Positions::next_instance_id() {
+  static std::atomic<std::uint64_t> next_id(0);
+  return next_id++;
+}
+
+namespace {
+
+struct CachedPosition {
+  std::uint64_t instance_id;
+  const Position* MT_NULLABLE position;
+};
+
+// Direct-mapped, so a lookup is a hash and a comparison.
+constexpr std::size_t k_position_cache_size = 1024;
+static_assert((k_position_cache_size & (k_position_cache_size - 1)) == 0);
+
+} // namespace
+
+const Position* Positions::intern(const Position& position) const {
+  thread_local std::array<CachedPosition, k_position_cache_size> cache{};
+
+  auto& entry =
+      cache[std::hash<Position>()(position) & (k_position_cache_size - 1)];
+  if (entry.position != nullptr && entry.instance_id == instance_id_ &&
+      *entry.position == position) {
+    CacheStatistics::lookup(CacheStatistics::Cache::Positions, /* hit */ true);
+    return entry.position;
+  }
+
+  auto [interned, inserted] = positions_.insert(position);
+  CacheStatistics::lookup(
+      CacheStatistics::Cache::Positions, /* hit */ !inserted);
+  if (inserted) {
+    CacheStatistics::insert(CacheStatistics::Cache::Positions);
+  }
+  entry = CachedPosition{instance_id_, interned};
+  return interned;
+}
+
 } // namespace marianatrench
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -75,11 +76,27 @@ class Positions final {
 
   const std::string* MT_NULLABLE get_path(const DexMethod* method) const;
 
+  /* Approximate memory used, in bytes. This is not thread-safe. */
+  std::size_t memory_usage() const;
+
   static std::string execute_and_catch_output(
       const std::string& command,
       int& return_code);
 
  private:
+  /**
+   * Intern the given position. Each thread keeps a small cache of recently
+   * interned positions in front of `positions_`, since the same positions are
+   * requested at every iteration of the fixpoint.
+   */
+  const Position* intern(const Position& position) const;
+
+ private:
+  // Identifies this instance in the thread-local caches, the address is not
+  // enough since it can be reused by a later instance.
+  std::uint64_t instance_id_ = next_instance_id();
+  static std::uint64_t next_instance_id();
+
   mutable InsertOnlyConcurrentSet<std::string> paths_;
   mutable InsertOnlyConcurrentSet<Position> positions_;
   ConcurrentMap<const DexMethod*, const std::string*> method_to_path_;
@@ -5,12 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <sparta/WorkQueue.h>
+#include <unordered_set>
 
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/Methods.h>
 #include <mariana-trench/PostprocessTraces.h>
 #include <mariana-trench/Registry.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -81,10 +82,10 @@ bool is_valid_generation(
     // itself is not a leaf (has a callee).
     return true;
   }
-  auto model = registry.get(callee);
+  auto model = registry.get_snapshot(callee);
 
   return check_callee_kinds(
-      context, kind, model.generations().raw_read(callee_port).root());
+      context, kind, model->generations().raw_read(callee_port).root());
 }
 
 bool is_valid_sink(
@@ -106,8 +107,8 @@ bool is_valid_sink(
     return true;
   }
 
-  auto model = registry.get(callee);
-  auto sinks = model.sinks().raw_read(callee_port).root();
+  auto model = registry.get_snapshot(callee);
+  auto sinks = model->sinks().raw_read(callee_port).root();
 
   if (check_callee_kinds(context, kind, sinks)) {
     return true;
@@ -181,6 +182,88 @@ IssueSet cull_collapsed_issues(
   return issues;
 }
 
+/* Returns true if the taint has an invalid frame, without copying it. */
+template <typename IsValid> // bool(callee, callee_port, kind)
+bool has_invalid_frames(const Taint& taint, const IsValid& is_valid) {
+  // Using an exception to break out of the loop early since `visit_frames`
+  // does not allow us to do that.
+  class invalid_frame_found {};
+  try {
+    taint.visit_frames(
+        [&is_valid](const CallInfo& call_info, const Frame& frame) {
+          if (!is_valid(
+                  call_info.callee(), *call_info.callee_port(), frame.kind())) {
+            throw invalid_frame_found();
+          }
+        });
+  } catch (const invalid_frame_found&) {
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Returns true if `cull_collapsed_traces` would remove frames from the model.
+ * Most models only have valid traces, and checking them does not require
+ * copying the model.
+ */
+bool has_collapsed_traces(
+    const Context& context,
+    const Model& model,
+    const Registry& registry) {
+  auto is_valid_generation_frame = [&context, &registry](
+                                       const Method* MT_NULLABLE callee,
+                                       const AccessPath& callee_port,
+                                       const Kind* kind) {
+    return is_valid_generation(context, callee, callee_port, kind, registry);
+  };
+  auto is_valid_sink_frame = [&context, &registry](
+                                 const Method* MT_NULLABLE callee,
+                                 const AccessPath& callee_port,
+                                 const Kind* kind) {
+    return is_valid_sink(context, callee, callee_port, kind, registry);
+  };
+
+  bool found = false;
+  model.generations().visit(
+      [&found, &is_valid_generation_frame](
+          const AccessPath& /* port */, const Taint& generation_taint) {
+        found = found ||
+            has_invalid_frames(generation_taint, is_valid_generation_frame);
+      });
+  if (found) {
+    return true;
+  }
+
+  model.sinks().visit([&found, &is_valid_sink_frame](
+                          const AccessPath& /* port */,
+                          const Taint& sink_taint) {
+    found = found || has_invalid_frames(sink_taint, is_valid_sink_frame);
+  });
+  if (found) {
+    return true;
+  }
+
+  for (const auto& issue : model.issues()) {
+    if (has_invalid_frames(issue.sources(), is_valid_generation_frame) ||
+        has_invalid_frames(issue.sinks(), is_valid_sink_frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Model cull_collapsed_traces(
+    const Context& context,
+    Model model,
+    const Registry& registry) {
+  model.set_generations(
+      cull_collapsed_generations(context, model.generations(), registry));
+  model.set_sinks(cull_collapsed_sinks(context, model.sinks(), registry));
+  model.set_issues(cull_collapsed_issues(context, model.issues(), registry));
+  return model;
+}
+
 } // namespace
 
 void PostprocessTraces::remove_collapsed_traces(
@@ -197,26 +280,20 @@ void PostprocessTraces::remove_collapsed_traces(
   while (methods->size() > 0) {
     auto new_methods = std::make_unique<ConcurrentSet<const Method*>>();
 
-    auto queue = sparta::work_queue<const Method*>(
+    auto queue = work_queue<const Method*>(
         [&](const Method* method) {
-          const auto old_model = registry.get(method);
-
-          auto model = old_model;
-          model.set_generations(cull_collapsed_generations(
-              context, model.generations(), registry));
-          model.set_sinks(
-              cull_collapsed_sinks(context, model.sinks(), registry));
-          model.set_issues(
-              cull_collapsed_issues(context, model.issues(), registry));
-
-          if (!old_model.leq(model)) {
-            for (const auto* dependency :
-                 context.dependencies->dependencies(method)) {
-              new_methods->insert(dependency);
-            }
+          const auto old_model = registry.get_snapshot(method);
+          if (!has_collapsed_traces(context, *old_model, registry)) {
+            return;
           }
 
-          registry.set(model);
+          // Removing frames makes the model strictly smaller, which might
+          // invalidate the traces of dependencies.
+          for (const auto* dependency :
+               context.dependencies->dependencies(method)) {
+            new_methods->insert(dependency);
+          }
+          registry.set(cull_collapsed_traces(context, *old_model, registry));
         },
         sparta::parallel::default_num_threads());
     for (const auto* method : *methods) {
@@ -227,4 +304,34 @@ void PostprocessTraces::remove_collapsed_traces(
   }
 }
 
+void PostprocessTraces::remove_collapsed_traces(
+    Registry& registry,
+    const Context& context,
+    const std::vector<const Method*>& component) {
+  std::unordered_set<const Method*> component_methods(
+      component.begin(), component.end());
+  std::unordered_set<const Method*> methods = component_methods;
+
+  // Same decreasing fixpoint as above, restricted to the component.
+  while (!methods.empty()) {
+    std::unordered_set<const Method*> new_methods;
+    for (const auto* method : methods) {
+      const auto old_model = registry.get_snapshot(method);
+      if (!has_collapsed_traces(context, *old_model, registry)) {
+        continue;
+      }
+      auto model = cull_collapsed_traces(context, *old_model, registry);
+
+      for (const auto* dependency :
+           context.dependencies->dependencies(method)) {
+        if (component_methods.count(dependency) > 0) {
+          new_methods.insert(dependency);
+        }
+      }
+      registry.set(std::move(model));
+    }
+    methods = std::move(new_methods);
+  }
+}
+
 } // namespace marianatrench
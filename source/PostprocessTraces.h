@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <mariana-trench/Registry.h>
 
 namespace marianatrench {
@@ -42,6 +44,16 @@ class PostprocessTraces {
   static void remove_collapsed_traces(
       Registry& registry,
       const Context& context);
+
+  /*
+   * Same as above, for the methods of a single strongly connected component
+   * whose callees are already postprocessed. This is thread-safe as long as
+   * no other thread updates the models of the component or its callees.
+   */
+  static void remove_collapsed_traces(
+      Registry& registry,
+      const Context& context,
+      const std::vector<const Method*>& component);
 };
 
 } // namespace marianatrench
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/OperatingSystem.h>
+#include <mariana-trench/Progress.h>
+
+namespace marianatrench {
+
+namespace {
+
+std::atomic<std::uint64_t> next_instance = 0;
+
+double seconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+Progress::Progress(
+    std::filesystem::path path,
+    std::chrono::milliseconds interval)
+    : path_(std::move(path)),
+      interval_(interval),
+      instance_(next_instance++),
+      thread_([this]() { run(); }) {}
+
+Progress::~Progress() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_condition_.notify_all();
+  thread_.join();
+  write();
+}
+
+void Progress::set_phase(std::string phase) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phase_ = std::move(phase);
+  phase_start_ = Clock::now();
+  iteration_ = 0;
+  work_items_ = 0;
+  work_items_completed_ = 0;
+}
+
+void Progress::start_iteration(std::size_t iteration, std::size_t work_items) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  iteration_ = iteration;
+  work_items_ = work_items;
+  work_items_completed_ = 0;
+}
+
+void Progress::add_work_items(std::size_t work_items) {
+  work_items_ += work_items;
+}
+
+void Progress::complete_work_item() {
+  work_items_completed_++;
+}
+
+Progress::MethodScope::MethodScope(
+    Progress* MT_NULLABLE progress,
+    const Method* method)
+    : progress_(progress) {
+  if (progress_ == nullptr) {
+    return;
+  }
+  auto& worker = progress_->worker();
+  worker.start.store(progress_->now(), std::memory_order_relaxed);
+  worker.method.store(method, std::memory_order_release);
+}
+
+Progress::MethodScope::~MethodScope() {
+  if (progress_ == nullptr) {
+    return;
+  }
+  progress_->worker().method.store(nullptr, std::memory_order_release);
+  progress_->methods_analyzed_++;
+}
+
+Progress::Worker& Progress::worker() {
+  struct CachedWorker {
+    std::uint64_t instance;
+    Worker* worker;
+  };
+  thread_local CachedWorker cache{static_cast<std::uint64_t>(-1), nullptr};
+  if (cache.instance == instance_) {
+    return *cache.worker;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Thread identifiers of exited threads may be reused by new threads, which
+  // then share a worker. This is fine since workers are idle between methods.
+  auto& worker = workers_[std::this_thread::get_id()];
+  if (worker == nullptr) {
+    worker = std::make_unique<Worker>();
+  }
+  cache = CachedWorker{instance_, worker.get()};
+  return *worker;
+}
+
+std::int64_t Progress::now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now() - start_)
+      .count();
+}
+
+Json::Value Progress::to_json() const {
+  std::vector<std::pair<const Method*, double>> running_methods;
+
+  auto value = Json::Value(Json::objectValue);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    value["phase"] = Json::Value(phase_);
+    value["phase_time"] = Json::Value(seconds(Clock::now() - phase_start_));
+    value["iteration"] = Json::Value(static_cast<Json::UInt64>(iteration_));
+    value["throughput"] = Json::Value(throughput_);
+    for (const auto& [thread, worker] : workers_) {
+      const auto* method = worker->method.load(std::memory_order_acquire);
+      if (method != nullptr) {
+        // The analysis may have started after the method was read.
+        auto duration = std::max<std::int64_t>(
+            now() - worker->start.load(std::memory_order_relaxed), 0);
+        running_methods.emplace_back(
+            method, static_cast<double>(duration) / 1e9);
+      }
+    }
+  }
+
+  value["time"] = Json::Value(seconds(Clock::now() - start_));
+  value["timestamp"] =
+      Json::Value(static_cast<Json::Int64>(std::time(nullptr)));
+  auto work_items = work_items_.load();
+  auto work_items_completed =
+      std::min(work_items_completed_.load(), work_items);
+  value["work_items"] = Json::Value(static_cast<Json::UInt64>(work_items));
+  value["work_items_remaining"] = Json::Value(
+      static_cast<Json::UInt64>(work_items - work_items_completed));
+  value["methods_analyzed"] =
+      Json::Value(static_cast<Json::UInt64>(methods_analyzed_.load()));
+  value["rss"] = Json::Value(resident_set_size_in_gb());
+
+  std::sort(
+      running_methods.begin(),
+      running_methods.end(),
+      [](const auto& left, const auto& right) {
+        return left.second > right.second;
+      });
+  if (running_methods.size() > kRecordRunningMethods) {
+    running_methods.resize(kRecordRunningMethods);
+  }
+  auto running_methods_value = Json::Value(Json::arrayValue);
+  for (const auto& [method, time] : running_methods) {
+    auto running_method_value = Json::Value(Json::objectValue);
+    running_method_value["method"] = Json::Value(method->show());
+    running_method_value["time"] = Json::Value(time);
+    running_methods_value.append(running_method_value);
+  }
+  value["running_methods"] = running_methods_value;
+  return value;
+}
+
+void Progress::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_condition_.wait_for(
+      lock, interval_, [this]() { return stop_; })) {
+    lock.unlock();
+    write();
+    lock.lock();
+  }
+}
+
+void Progress::write() {
+  {
+    auto methods_analyzed = methods_analyzed_.load();
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto elapsed = seconds(now - last_write_);
+    if (elapsed > 0.0) {
+      throughput_ =
+          static_cast<double>(
+              methods_analyzed - methods_analyzed_at_last_write_) /
+          elapsed;
+    }
+    methods_analyzed_at_last_write_ = methods_analyzed;
+    last_write_ = now;
+  }
+
+  // Write to a temporary file first, so readers never see a partial status.
+  auto temporary_path = path_;
+  temporary_path += ".tmp";
+  try {
+    JsonValidation::write_json_file(temporary_path, to_json());
+    std::filesystem::rename(temporary_path, path_);
+  } catch (const std::exception& exception) {
+    WARNING(
+        1,
+        "Unable to write status to `{}`: {}",
+        path_.native(),
+        exception.what());
+  }
+}
+
+} // namespace marianatrench
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <json/json.h>
+
+#include <mariana-trench/Compiler.h>
+#include <mariana-trench/Method.h>
+
+namespace marianatrench {
+
+/**
+ * Live progress of the analysis, enabled with `--write-status`.
+ *
+ * A background thread periodically rewrites a status file with the current
+ * phase and iteration, the number of remaining work items, the throughput in
+ * analyzed methods per second, the resident set size and the methods
+ * currently analyzed by each worker, from the longest running. The file is
+ * replaced atomically, so it can be read at any time.
+ */
+class Progress final {
+ public:
+  Progress(std::filesystem::path path, std::chrono::milliseconds interval);
+
+  Progress(const Progress&) = delete;
+  Progress(Progress&&) = delete;
+  Progress& operator=(const Progress&) = delete;
+  Progress& operator=(Progress&&) = delete;
+  /* Stops the background thread and writes the final status. */
+  ~Progress();
+
+  void set_phase(std::string phase);
+
+  /**
+   * Start an iteration of a fixpoint over the given number of work items
+   * (methods or components).
+   */
+  void start_iteration(std::size_t iteration, std::size_t work_items);
+  /* Add work items to the current iteration, e.g for a worklist. */
+  void add_work_items(std::size_t work_items);
+  void complete_work_item();
+
+  /* Record the analysis of a method by the current thread. */
+  class MethodScope final {
+   public:
+    MethodScope(Progress* MT_NULLABLE progress, const Method* method);
+    MethodScope(const MethodScope&) = delete;
+    MethodScope(MethodScope&&) = delete;
+    MethodScope& operator=(const MethodScope&) = delete;
+    MethodScope& operator=(MethodScope&&) = delete;
+    ~MethodScope();
+
+   private:
+    Progress* MT_NULLABLE progress_;
+  };
+
+  Json::Value to_json() const;
+
+  /* Maximum number of running methods in the status. */
+  constexpr static std::size_t kRecordRunningMethods = 64;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /* Method analyzed by a thread. Only written by that thread. */
+  struct Worker {
+    std::atomic<const Method*> method = nullptr;
+    // Start of the analysis, in nanoseconds since the creation of `Progress`.
+    std::atomic<std::int64_t> start = 0;
+  };
+
+  Worker& worker();
+  std::int64_t now() const;
+
+  void run();
+  void write();
+
+ private:
+  std::filesystem::path path_;
+  std::chrono::milliseconds interval_;
+  Clock::time_point start_ = Clock::now();
+  std::uint64_t instance_;
+
+  mutable std::mutex mutex_;
+  std::string phase_;
+  Clock::time_point phase_start_ = Clock::now();
+  std::size_t iteration_ = 0;
+  std::unordered_map<std::thread::id, std::unique_ptr<Worker>> workers_;
+
+  std::atomic<std::size_t> work_items_ = 0;
+  std::atomic<std::size_t> work_items_completed_ = 0;
+  std::atomic<std::size_t> methods_analyzed_ = 0;
+
+  // State of the background thread.
+  std::size_t methods_analyzed_at_last_write_ = 0;
+  Clock::time_point last_write_ = Clock::now();
+  double throughput_ = 0.0;
+
+  std::condition_variable stop_condition_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+} // namespace marianatrench
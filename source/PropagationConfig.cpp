@@ -22,18 +22,21 @@ AccessPath PropagationConfig::callee_port() const {
 
 PropagationConfig PropagationConfig::from_json(
     const Json::Value& value,
-    Context& context) {
+    Context& context,
+    bool check_unexpected_members) {
   JsonValidation::validate_object(value);
-  JsonValidation::check_unexpected_members(
-      value,
-      {"output",
-       "input",
-       "may_features",
-       "always_features",
-       "features",
-       "collapse",
-       "collapse-depth",
-       "transforms"});
+  if (check_unexpected_members) {
+    JsonValidation::check_unexpected_members(
+        value,
+        {"output",
+         "input",
+         "may_features",
+         "always_features",
+         "features",
+         "collapse",
+         "collapse-depth",
+         "transforms"});
+  }
 
   JsonValidation::string(value, /* field */ "output");
   auto output = AccessPath::from_json(value["output"]);
@@ -114,7 +114,8 @@ class PropagationConfig final {
 
   static PropagationConfig from_json(
       const Json::Value& value,
-      Context& context);
+      Context& context,
+      bool check_unexpected_members = true);
 
   friend std::ostream& operator<<(
       std::ostream& out,
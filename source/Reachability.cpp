@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/ClassProperties.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Options.h>
+#include <mariana-trench/Overrides.h>
+#include <mariana-trench/Reachability.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+bool is_entry_point(
+    const Context& context,
+    const std::unordered_set<std::string>& lifecycle_method_names,
+    const Method* method) {
+  if (method->get_name() == "<clinit>" ||
+      lifecycle_method_names.count(std::string(method->get_name())) > 0) {
+    return true;
+  }
+  if (context.class_properties != nullptr &&
+      context.class_properties->is_android_component(
+          method->get_class()->str())) {
+    return true;
+  }
+  for (const auto& prefix : context.options->entry_points()) {
+    if (boost::starts_with(method->signature(), prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+ConcurrentSet<const Method*> Reachability::reachable_methods(
+    const Context& context,
+    const std::unordered_set<std::string>& lifecycle_method_names) {
+  ConcurrentSet<const Method*> reachable_methods;
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        if (is_entry_point(context, lifecycle_method_names, method)) {
+          reachable_methods.insert(method);
+        }
+        // The framework calls the overrides of its methods, e.g callbacks.
+        if (method->dex_method()->is_external()) {
+          for (const auto* override : context.overrides->get(method)) {
+            reachable_methods.insert(override);
+          }
+        }
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  // Callees of reachable methods are reachable.
+  std::vector<const Method*> worklist(
+      reachable_methods.begin(), reachable_methods.end());
+  auto add_callee = [&](const CallTarget& call_target) {
+    if (!call_target.resolved()) {
+      return;
+    }
+    if (reachable_methods.insert(call_target.resolved_base_callee())) {
+      worklist.push_back(call_target.resolved_base_callee());
+    }
+    if (!call_target.is_virtual()) {
+      return;
+    }
+    for (const auto* override : call_target.overrides()) {
+      if (reachable_methods.insert(override)) {
+        worklist.push_back(override);
+      }
+    }
+  };
+  while (!worklist.empty()) {
+    const auto* method = worklist.back();
+    worklist.pop_back();
+    context.call_graph->visit_call_targets(method, add_callee);
+  }
+  return reachable_methods;
+}
+
+std::size_t Reachability::skip_unreachable_methods(
+    Context& context,
+    Registry& registry,
+    const std::unordered_set<std::string>& lifecycle_method_names) {
+  auto reachable = reachable_methods(context, lifecycle_method_names);
+
+  std::atomic<std::size_t> skipped_methods(0);
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        if (reachable.count(method) > 0 || method->get_code() == nullptr ||
+            registry.get_snapshot(method)->skip_analysis()) {
+          return;
+        }
+        registry.update(method, [&context](Model& model) {
+          model.add_mode(Model::Mode::SkipAnalysis, context);
+        });
+        skipped_methods++;
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  LOG(1,
+      "Found {} methods reachable from entry points, skipping the analysis of {} methods.",
+      reachable.size(),
+      skipped_methods.load());
+  return skipped_methods.load();
+}
+
+} // namespace marianatrench
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Reachability of methods in the call graph from the entry points of the
+ * program, with `--prune-unreachable-methods`.
+ *
+ * Entry points are the methods that may be called by the runtime or the
+ * framework: life-cycle wrappers, methods of the components declared in the
+ * manifest, class initializers and overrides of methods of external classes,
+ * along with the methods of `--entry-point`. Methods are reachable through
+ * calls, overrides of virtual calls and artificial callees.
+ *
+ * Unreachable methods cannot be called by reachable ones, hence they are not
+ * analyzed: their models are in `skip-analysis` mode.
+ */
+class Reachability final {
+ public:
+  /* Methods reachable from the entry points. */
+  static ConcurrentSet<const Method*> reachable_methods(
+      const Context& context,
+      const std::unordered_set<std::string>& lifecycle_method_names);
+
+  /* Skip the analysis of the other methods. Return their number. */
+  static std::size_t skip_unreachable_methods(
+      Context& context,
+      Registry& registry,
+      const std::unordered_set<std::string>& lifecycle_method_names);
+};
+
+} // namespace marianatrench
@@ -8,29 +8,56 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <unordered_map>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <fmt/format.h>
 #include <json/value.h>
 
-#include <sparta/WorkQueue.h>
-
+#include <mariana-trench/BinaryJson.h>
 #include <mariana-trench/Constants.h>
+#include <mariana-trench/ConvergenceReport.h>
 #include <mariana-trench/Filesystem.h>
+#include <mariana-trench/IndexedModelFile.h>
 #include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
+#include <mariana-trench/LibrarySummaries.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/Methods.h>
+#include <mariana-trench/ModelFingerprints.h>
+#include <mariana-trench/ModelSizes.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Positions.h>
+#include <mariana-trench/Redex.h>
 #include <mariana-trench/Registry.h>
 #include <mariana-trench/Rules.h>
 #include <mariana-trench/RulesCoverage.h>
 #include <mariana-trench/Statistics.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
+namespace {
+
+/**
+ * Return the model of an entry of `models_` for an update under the lock of
+ * the entry. Snapshots held by readers are never modified: the model is copied
+ * if it is shared.
+ */
+Model& mutable_model(std::shared_ptr<const Model>& model) {
+  if (model.use_count() > 1) {
+    model = std::make_shared<Model>(*model);
+  }
+  // Models of `models_` are always allocated as mutable `Model`.
+  return const_cast<Model&>(*model);
+}
+
+} // namespace
+
 Registry::Registry(Context& context) : context_(context) {
-  auto queue = sparta::work_queue<const Method*>(
+  auto queue = work_queue<const Method*>(
       [this, &context](const Method* method) { set(Model(method, context)); },
       sparta::parallel::default_num_threads());
   for (const auto* method : *context.methods) {
@@ -43,13 +70,63 @@ Registry::Registry(
     Context& context,
     const std::vector<Model>& models,
     const std::vector<FieldModel>& field_models)
+    : Registry(context, models, field_models, /* rules */ nullptr) {}
+
+Registry::Registry(
+    Context& context,
+    const std::vector<Model>& models,
+    const std::vector<FieldModel>& field_models,
+    const Rules* MT_NULLABLE rules)
     : context_(context) {
+  // Generators often emit many models for the same method. Models are grouped
+  // by method and joined in parallel, so that each group is joined in place
+  // and inserted once.
+  std::unordered_map<const Method*, std::vector<const Model*>> method_models;
   for (const auto& model : models) {
-    join_with(model);
+    mt_assert(model.method());
+    method_models[model.method()].push_back(&model);
   }
+  auto method_queue = work_queue<const std::vector<const Model*>*>(
+      [this, rules](const std::vector<const Model*>* group) {
+        auto joined_model = *group->front();
+        for (auto iterator = std::next(group->begin());
+             iterator != group->end();
+             ++iterator) {
+          joined_model.join_with(**iterator);
+        }
+        if (rules != nullptr) {
+          joined_model.remove_kinds(
+              [rules](const Kind* kind) { return rules->is_unused(kind); });
+        }
+        join_with(std::move(joined_model));
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto& [_method, group] : method_models) {
+    method_queue.add_item(&group);
+  }
+  method_queue.run_all();
+
+  std::unordered_map<const Field*, std::vector<const FieldModel*>>
+      field_models_by_field;
   for (const auto& field_model : field_models) {
-    join_with(field_model);
+    mt_assert(field_model.field());
+    field_models_by_field[field_model.field()].push_back(&field_model);
   }
+  auto field_queue = work_queue<const std::vector<const FieldModel*>*>(
+      [this](const std::vector<const FieldModel*>* group) {
+        auto joined_field_model = *group->front();
+        for (auto iterator = std::next(group->begin());
+             iterator != group->end();
+             ++iterator) {
+          joined_field_model.join_with(**iterator);
+        }
+        join_with(joined_field_model);
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto& [_field, group] : field_models_by_field) {
+    field_queue.add_item(&group);
+  }
+  field_queue.run_all();
 }
 
 Registry::Registry(
@@ -79,28 +156,68 @@ Registry Registry::load(
     const Options& options,
     const std::vector<Model>& generated_models,
     const std::vector<FieldModel>& generated_field_models) {
+  // Kinds unused by rules are dropped as models are joined, instead of
+  // rewriting all models afterwards.
+  mt_assert(context.rules != nullptr);
+  const auto& rules = *context.rules;
+  auto without_unused_kinds = [&rules](Model model) {
+    model.remove_kinds(
+        [&rules](const Kind* kind) { return rules.is_unused(kind); });
+    return model;
+  };
+
   // Create a registry with the generated models
-  Registry registry(context, generated_models, generated_field_models);
+  Registry registry(
+      context, generated_models, generated_field_models, &rules);
 
   // TODO(T157984454): We should unify the loading of models from files and
   // loading model generators, so we can use unique "model generator" names.
 
-  // Load models json input
+  // Load models json input. Models are parsed and joined in parallel.
   for (const auto& models_path : options.models_paths()) {
-    registry.join_with(Registry(
-        context,
-        /* models_value */ JsonValidation::parse_json_file(models_path),
-        /* field_models_value */ Json::Value(Json::arrayValue),
-        /* literal_models_value */ Json::Value(Json::arrayValue)));
+    JsonValidation::visit_json_array_file(
+        models_path, [&](const Json::Value& value) {
+          const auto* method = Method::from_json(value["method"], context);
+          mt_assert(method != nullptr);
+          registry.join_with(
+              without_unused_kinds(Model::from_json(method, value, context)));
+        });
+  }
+  // Library models are indexed by method, and only the models of methods
+  // that exist in the program are parsed.
+  for (const auto& library_models_path : options.library_models_paths()) {
+    IndexedModelFile file(library_models_path);
+    auto loaded = file.visit(
+        [](std::string_view signature) {
+          return redex::get_method(signature) != nullptr;
+        },
+        [&](const Json::Value& value) {
+          const auto* method = Method::from_json(value["method"], context);
+          mt_assert(method != nullptr);
+          registry.join_with(
+              without_unused_kinds(Model::from_json(method, value, context)));
+        });
+    LOG(1,
+        "Loaded {} out of {} library models from `{}`.",
+        loaded,
+        file.size(),
+        library_models_path);
+  }
+  // Summaries are in `skip-analysis` mode, hence these methods are not
+  // analyzed again.
+  for (const auto& library_summaries_path :
+       options.library_summaries_paths()) {
+    LibrarySummaries::load(library_summaries_path, context, registry);
   }
   for (const auto& field_models_path : options.field_models_paths()) {
-    registry.join_with(Registry(
-        context,
-        /* models_value */ Json::Value(Json::arrayValue),
-        /* field_models_value */
-        JsonValidation::parse_json_file(field_models_path),
-        /* literal_models_value */ Json::Value(Json::arrayValue)));
+    JsonValidation::visit_json_array_file(
+        field_models_path, [&](const Json::Value& value) {
+          const auto* field = Field::from_json(value["field"], context);
+          mt_assert(field != nullptr);
+          registry.join_with(FieldModel::from_json(field, value, context));
+        });
   }
+  // Literal models are few and re-index all patterns when joined.
   for (const auto& literal_models_path : options.literal_models_paths()) {
     registry.join_with(Registry(
         context,
@@ -117,9 +234,10 @@ Registry Registry::load(
 }
 
 void Registry::add_default_models() {
-  auto queue = sparta::work_queue<const Method*>(
+  auto queue = work_queue<const Method*>(
       [this](const Method* method) {
-        models_.insert(std::make_pair(method, Model(method, context_)));
+        models_.insert(std::make_pair(
+            method, std::make_shared<Model>(method, context_)));
       },
       sparta::parallel::default_num_threads());
   for (const auto* method : *context_.methods) {
@@ -129,16 +247,30 @@ void Registry::add_default_models() {
 }
 
 Model Registry::get(const Method* method) const {
+  return *get_snapshot(method);
+}
+
+std::shared_ptr<const Model> Registry::get_snapshot(
+    const Method* method) const {
   if (!method) {
     throw std::runtime_error("Trying to get model for the `null` method");
   }
 
-  try {
-    return models_.at(method);
-  } catch (const std::out_of_range&) {
+  if (method->id() < frozen_models_.size()) {
+    if (const auto& model = frozen_models_[method->id()]) {
+      return model;
+    }
+  }
+
+  auto model = models_.get(method, /* default */ nullptr);
+  if (!model && evicted_models_.count(method) > 0) {
+    throw std::logic_error(fmt::format(
+        "Trying to get the evicted model of `{}`.", method->show()));
+  } else if (!model) {
     throw std::runtime_error(fmt::format(
         "Trying to get model for untracked method `{}`.", method->show()));
   }
+  return model;
 }
 
 FieldModel Registry::get(const Field* field) const {
@@ -146,29 +278,131 @@ FieldModel Registry::get(const Field* field) const {
     throw std::runtime_error("Trying to get model for the `null` field");
   }
 
-  try {
-    return field_models_.at(field);
-  } catch (const std::out_of_range&) {
-    return FieldModel(field);
-  }
+  return field_models_.get(field, FieldModel(field));
+}
+
+bool Registry::may_have_field_model(const DexFieldRef* field) const {
+  // Field accesses are resolved to the field definition, which has the same
+  // name as the reference.
+  return field_model_names_.count(field->get_name()) > 0;
 }
 
 void Registry::set(const Model& model) {
-  models_.insert_or_assign(std::make_pair(model.method(), model));
+  set(Model(model));
+}
+
+void Registry::set(Model&& model) {
+  const auto* method = model.method();
+  auto new_model = std::make_shared<Model>(std::move(model));
+  if (kind_counters_ == nullptr) {
+    models_.insert_or_assign(std::make_pair(method, std::move(new_model)));
+    return;
+  }
+  models_.update(
+      method,
+      [this, &new_model](
+          const Method* method,
+          std::shared_ptr<const Model>& existing,
+          bool /* exists */) {
+        update_kind_counters(method, *new_model);
+        existing = std::move(new_model);
+      });
+}
+
+void Registry::freeze() {
+  // Methods created afterwards, or without a model, are read from `models_`.
+  frozen_models_.assign(context_.methods->number_of_ids(), nullptr);
+  for (const auto& [method, model] : models_) {
+    if (method->id() < frozen_models_.size()) {
+      frozen_models_[method->id()] = model;
+    }
+  }
+}
+
+void Registry::unfreeze() {
+  frozen_models_.clear();
+  frozen_models_.shrink_to_fit();
+}
+
+void Registry::evict(const Method* method) {
+  auto model = models_.get(method, /* default */ nullptr);
+  if (!model) {
+    return;
+  }
+  EvictedModel evicted_model;
+  evicted_model.issues = model->issues().size();
+  evicted_model.skip_analysis = model->skip_analysis();
+  if (kind_counters_ == nullptr) {
+    evicted_model.kinds = KindCounters::ModelKinds::from_model(*model);
+  }
+  evicted_models_.insert_or_assign(
+      std::make_pair(method, std::move(evicted_model)));
+  models_.erase(method);
+}
+
+void Registry::update(
+    const Method* method,
+    const std::function<void(Model&)>& update) {
+  models_.update(
+      method,
+      [this, &update](
+          const Method* method,
+          std::shared_ptr<const Model>& model,
+          bool exists) {
+        if (!exists || !model) {
+          throw std::runtime_error(fmt::format(
+              "Trying to update model for untracked method `{}`.",
+              method->show()));
+        }
+        auto& updated_model = mutable_model(model);
+        update(updated_model);
+        update_kind_counters(method, updated_model);
+      });
 }
 
 LiteralModel Registry::match_literal(const std::string_view literal) const {
   LiteralModel result_model;
-  for (const auto& [pattern, model] : literal_models_) {
-    if (model.matches(literal)) {
-      result_model.join_with(model);
+  if (literal_pattern_set_ != nullptr) {
+    std::vector<int> matched_patterns;
+    literal_pattern_set_->Match(literal, &matched_patterns);
+    for (auto index : matched_patterns) {
+      auto iterator = literal_models_.find(literal_set_patterns_[index]);
+      mt_assert(iterator != literal_models_.end());
+      result_model.join_with(iterator->second);
+    }
+  }
+  for (const auto& pattern : literal_unindexed_patterns_) {
+    auto iterator = literal_models_.find(pattern);
+    mt_assert(iterator != literal_models_.end());
+    if (iterator->second.matches(literal)) {
+      result_model.join_with(iterator->second);
     }
   }
   return result_model;
 }
 
+LiteralModel Registry::match_literal(const DexString* literal) const {
+  // Most literals do not match any model, share the empty result.
+  static const auto empty_model = std::make_shared<const LiteralModel>();
+
+  if (auto model = literal_matches_.get(literal, /* default */ nullptr)) {
+    return *model;
+  }
+
+  auto model = match_literal(literal->str());
+  literal_matches_.emplace(
+      literal,
+      model.empty() ? empty_model
+                    : std::make_shared<const LiteralModel>(model));
+  return model;
+}
+
 std::size_t Registry::models_size() const {
-  return models_.size();
+  return models_.size() + evicted_models_.size();
+}
+
+std::size_t Registry::evicted_models_size() const {
+  return evicted_models_.size();
 }
 
 std::size_t Registry::field_models_size() const {
@@ -178,31 +412,167 @@ std::size_t Registry::field_models_size() const {
 std::size_t Registry::issues_size() const {
   std::size_t result = 0;
   for (const auto& entry : models_) {
-    result += entry.second.issues().size();
+    result += entry.second->issues().size();
+  }
+  for (const auto& [_method, evicted_model] : evicted_models_) {
+    result += evicted_model.issues;
   }
   return result;
 }
 
+namespace {
+
+std::size_t taint_tree_memory_usage(const TaintAccessPathTree& tree) {
+  std::size_t bytes = 0;
+  tree.visit([&bytes](const AccessPath& /* access_path */, const Taint& taint) {
+    if (taint.is_bottom()) {
+      return;
+    }
+    bytes += sizeof(Taint) + memory_usage::k_node_overhead +
+        taint.num_frames() * sizeof(Frame);
+  });
+  return bytes;
+}
+
+} // namespace
+
+std::map<std::string, std::size_t> Registry::memory_usage(
+    std::size_t sampling_rate) const {
+  std::map<std::string, std::size_t> sampled_bytes;
+  std::size_t index = 0;
+  for (const auto& [method, model] : models_) {
+    if (index++ % sampling_rate != 0) {
+      continue;
+    }
+    sampled_bytes["generations"] +=
+        taint_tree_memory_usage(model->generations()) +
+        taint_tree_memory_usage(model->parameter_sources());
+    sampled_bytes["sinks"] += taint_tree_memory_usage(model->sinks());
+    sampled_bytes["call_effects"] +=
+        taint_tree_memory_usage(model->call_effect_sources()) +
+        taint_tree_memory_usage(model->call_effect_sinks());
+    sampled_bytes["propagations"] +=
+        taint_tree_memory_usage(model->propagations());
+    sampled_bytes["issues"] += model->issues().size() * sizeof(Issue);
+    sampled_bytes["other"] += sizeof(Model) +
+        memory_usage::nodes<decltype(models_)::value_type>(1);
+  }
+
+  std::map<std::string, std::size_t> bytes;
+  for (const auto& [component, component_bytes] : sampled_bytes) {
+    bytes[component] = component_bytes * sampling_rate;
+  }
+  bytes["field_models"] =
+      memory_usage::nodes<std::pair<const Field*, FieldModel>>(
+          field_models_.size());
+  bytes["literal_models"] =
+      memory_usage::nodes<std::pair<std::string, LiteralModel>>(
+          literal_models_.size() + literal_matches_.size());
+  return bytes;
+}
+
 void Registry::join_with(const Model& model) {
   const auto* method = model.method();
   mt_assert(method);
-  auto iterator = models_.find(method);
-  if (iterator != models_.end()) {
-    iterator->second.join_with(model);
-  } else {
-    models_.insert(std::make_pair(method, model));
+  models_.update(
+      method,
+      [this, &model](
+          const Method* method,
+          std::shared_ptr<const Model>& existing,
+          bool exists) {
+        if (exists) {
+          mutable_model(existing).join_with(model);
+        } else {
+          existing = std::make_shared<Model>(model);
+        }
+        update_kind_counters(method, *existing);
+      });
+}
+
+void Registry::join_with(Model&& model) {
+  const auto* method = model.method();
+  mt_assert(method);
+  models_.update(
+      method,
+      [this, &model](
+          const Method* method,
+          std::shared_ptr<const Model>& existing,
+          bool exists) {
+        if (exists) {
+          mutable_model(existing).join_with(model);
+        } else {
+          existing = std::make_shared<Model>(std::move(model));
+        }
+        update_kind_counters(method, *existing);
+      });
+}
+
+void Registry::count_kinds() {
+  if (kind_counters_ != nullptr) {
+    return;
+  }
+  kind_counters_ = std::make_unique<KindCounters>();
+
+  // The map is not modified while counting, so we only keep pointers to its
+  // entries.
+  std::vector<std::pair<const Method*, const Model*>> models;
+  models.reserve(models_.size());
+  for (const auto& [method, model] : models_) {
+    models.emplace_back(method, model.get());
+  }
+  auto queue = work_queue<std::pair<const Method*, const Model*>>(
+      [this](std::pair<const Method*, const Model*> entry) {
+        auto kinds = KindCounters::ModelKinds::from_model(*entry.second);
+        kind_counters_->add(kinds);
+        model_kinds_.insert_or_assign(
+            std::make_pair(entry.first, std::move(kinds)));
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto& entry : models) {
+    queue.add_item(entry);
+  }
+  queue.run_all();
+
+  // Kinds of evicted models are only kept in the counters.
+  for (auto& [_method, evicted_model] : evicted_models_) {
+    kind_counters_->add(evicted_model.kinds);
+    evicted_model.kinds = KindCounters::ModelKinds{};
   }
 }
 
+void Registry::update_kind_counters(const Method* method, const Model& model) {
+  if (kind_counters_ == nullptr) {
+    return;
+  }
+  auto kinds = KindCounters::ModelKinds::from_model(model);
+  model_kinds_.update(
+      method,
+      [this, &kinds](
+          const Method* /* method */,
+          KindCounters::ModelKinds& previous_kinds,
+          bool exists) {
+        if (exists) {
+          kind_counters_->remove(previous_kinds);
+        }
+        kind_counters_->add(kinds);
+        previous_kinds = std::move(kinds);
+      });
+}
+
 void Registry::join_with(const FieldModel& field_model) {
   const auto* field = field_model.field();
   mt_assert(field);
-  auto iterator = field_models_.find(field);
-  if (iterator != field_models_.end()) {
-    iterator->second.join_with(field_model);
-  } else {
-    field_models_.insert(std::make_pair(field, field_model));
-  }
+  field_model_names_.insert(field->dex_field()->get_name());
+  field_models_.update(
+      field,
+      [&field_model](
+          const Field* /* field */, FieldModel& existing, bool exists) {
+        if (exists) {
+          existing.join_with(field_model);
+        } else {
+          existing = field_model;
+        }
+      });
 }
 
 void Registry::join_with(const LiteralModel& literal_model) {
@@ -213,12 +583,47 @@ void Registry::join_with(const LiteralModel& literal_model) {
     iterator->second.join_with(literal_model);
   } else {
     literal_models_.emplace(*pattern, literal_model);
+    index_literal_models();
   }
+  literal_matches_.clear();
+}
+
+void Registry::index_literal_models() {
+  literal_pattern_set_ = nullptr;
+  literal_set_patterns_.clear();
+  literal_unindexed_patterns_.clear();
+
+  // `LiteralModel::matches` performs a full match.
+  auto pattern_set = std::make_unique<re2::RE2::Set>(
+      re2::RE2::DefaultOptions, re2::RE2::ANCHOR_BOTH);
+  for (const auto& [pattern, _model] : literal_models_) {
+    if (pattern_set->Add(pattern, /* error */ nullptr) < 0) {
+      literal_unindexed_patterns_.push_back(pattern);
+    } else {
+      literal_set_patterns_.push_back(pattern);
+    }
+  }
+  if (literal_set_patterns_.empty()) {
+    return;
+  }
+
+  if (!pattern_set->Compile()) {
+    WARNING(
+        1,
+        "Unable to compile literal model patterns, matching them one by one.");
+    literal_unindexed_patterns_.insert(
+        literal_unindexed_patterns_.end(),
+        literal_set_patterns_.begin(),
+        literal_set_patterns_.end());
+    literal_set_patterns_.clear();
+    return;
+  }
+  literal_pattern_set_ = std::move(pattern_set);
 }
 
 void Registry::join_with(const Registry& other) {
   for (const auto& other_model : other.models_) {
-    join_with(other_model.second);
+    join_with(*other_model.second);
   }
   for (const auto& other_field_model : other.field_models_) {
     join_with(other_field_model.second);
@@ -228,7 +633,143 @@ void Registry::join_with(const Registry& other) {
   }
 }
 
+Registry::Summary Registry::summarize(bool include_coverage) const {
+  // The map is not modified while summarizing, so we only keep pointers to
+  // its entries.
+  std::vector<std::pair<const Method*, const Model*>> models;
+  models.reserve(models_.size());
+  for (const auto& [method, model] : models_) {
+    models.emplace_back(method, model.get());
+  }
+
+  auto number_of_threads = sparta::parallel::default_num_threads();
+  std::vector<Summary> worker_summaries(number_of_threads);
+  auto queue = work_queue<std::size_t>(
+      [&](WorkerState<std::size_t>* worker_state, std::size_t i) {
+        auto& summary = worker_summaries[worker_state->worker_id()];
+        const auto* method = models[i].first;
+        const auto* model = models[i].second;
+
+        summary.issues += model->issues().size();
+        bool has_code = method->get_code() != nullptr;
+        if (!has_code) {
+          summary.methods_without_code++;
+        }
+        if (model->skip_analysis()) {
+          summary.methods_skipped++;
+        }
+        if (!include_coverage) {
+          return;
+        }
+
+        if (has_code && !model->skip_analysis()) {
+          const auto* path = context_.positions->get_path(method->dex_method());
+          if (path) {
+            summary.covered_paths.insert(*path);
+          }
+        }
+        if (kind_counters_ != nullptr) {
+          return;
+        }
+
+        auto source_kinds = model->source_kinds();
+        summary.used_sources.insert(source_kinds.begin(), source_kinds.end());
+
+        auto sink_kinds = model->sink_kinds();
+        summary.used_sinks.insert(sink_kinds.begin(), sink_kinds.end());
+
+        auto transforms = model->local_transform_kinds();
+        summary.used_transforms.insert(transforms.begin(), transforms.end());
+      },
+      number_of_threads);
+  for (std::size_t i = 0; i < models.size(); i++) {
+    queue.add_item(i);
+  }
+  queue.run_all();
+
+  Summary result;
+  for (auto& summary : worker_summaries) {
+    result.issues += summary.issues;
+    result.methods_without_code += summary.methods_without_code;
+    result.methods_skipped += summary.methods_skipped;
+    result.covered_paths.merge(summary.covered_paths);
+    result.used_sources.merge(summary.used_sources);
+    result.used_sinks.merge(summary.used_sinks);
+    result.used_transforms.merge(summary.used_transforms);
+  }
+
+  for (const auto& [method, evicted_model] : evicted_models_) {
+    result.issues += evicted_model.issues;
+    bool has_code = method->get_code() != nullptr;
+    if (!has_code) {
+      result.methods_without_code++;
+    }
+    if (evicted_model.skip_analysis) {
+      result.methods_skipped++;
+    }
+    if (!include_coverage) {
+      continue;
+    }
+    if (has_code && !evicted_model.skip_analysis) {
+      const auto* path = context_.positions->get_path(method->dex_method());
+      if (path) {
+        result.covered_paths.insert(*path);
+      }
+    }
+    const auto& kinds = evicted_model.kinds;
+    result.used_sources.insert(
+        kinds.source_kinds.begin(), kinds.source_kinds.end());
+    result.used_sinks.insert(kinds.sink_kinds.begin(), kinds.sink_kinds.end());
+    result.used_transforms.insert(
+        kinds.local_transform_kinds.begin(), kinds.local_transform_kinds.end());
+  }
+
+  if (include_coverage) {
+    if (kind_counters_ != nullptr) {
+      result.used_sources.merge(kind_counters_->used_sources());
+      result.used_sinks.merge(kind_counters_->used_sinks());
+      result.used_transforms.merge(kind_counters_->used_transforms());
+    }
+
+    for (const auto& [_field, model] : field_models_) {
+      auto source_kinds = model.sources().kinds();
+      result.used_sources.insert(source_kinds.begin(), source_kinds.end());
+
+      auto sink_kinds = model.sinks().kinds();
+      result.used_sinks.insert(sink_kinds.begin(), sink_kinds.end());
+    }
+
+    for (const auto& [_literal, model] : literal_models_) {
+      auto source_kinds = model.sources().kinds();
+      result.used_sources.insert(source_kinds.begin(), source_kinds.end());
+    }
+  }
+
+  return result;
+}
+
 void Registry::dump_metadata(const std::filesystem::path& path) const {
+  write_metadata(path, summarize(/* include_coverage */ false));
+}
+
+void Registry::dump_metadata_and_coverage_info(
+    const std::filesystem::path& metadata_path,
+    const std::optional<std::filesystem::path>& file_coverage_path,
+    const std::optional<std::filesystem::path>& rule_coverage_path) const {
+  auto summary = summarize(
+      /* include_coverage */ file_coverage_path || rule_coverage_path);
+  if (file_coverage_path) {
+    write_file_coverage_info(*file_coverage_path, summary);
+  }
+  if (rule_coverage_path) {
+    write_rule_coverage_info(*rule_coverage_path, summary);
+  }
+  write_metadata(metadata_path, summary);
+}
+
+void Registry::write_metadata(
+    const std::filesystem::path& path,
+    const Summary& summary) const {
   auto value = Json::Value(Json::objectValue);
 
   auto codes = Json::Value(Json::objectValue);
@@ -244,17 +785,22 @@ void Registry::dump_metadata(const std::filesystem::path& path) const {
   value["rules"] = rules;
 
   auto statistics = context_.statistics->to_json();
-  statistics["issues"] = Json::Value(static_cast<Json::UInt64>(issues_size()));
+  statistics["issues"] = Json::Value(static_cast<Json::UInt64>(summary.issues));
   statistics["methods_analyzed"] =
-      Json::Value(static_cast<Json::UInt64>(models_.size()));
-  statistics["methods_without_code"] = Json::Value(static_cast<Json::UInt64>(
-      std::count_if(models_.begin(), models_.end(), [](const auto& model) {
-        return model.first->get_code() == nullptr;
-      })));
-  statistics["methods_skipped"] = Json::Value(static_cast<Json::UInt64>(
-      std::count_if(models_.begin(), models_.end(), [](const auto& model) {
-        return model.second.skip_analysis();
-      })));
+      Json::Value(static_cast<Json::UInt64>(models_size()));
+  statistics["methods_without_code"] =
+      Json::Value(static_cast<Json::UInt64>(summary.methods_without_code));
+  statistics["methods_skipped"] =
+      Json::Value(static_cast<Json::UInt64>(summary.methods_skipped));
+  if (context_.model_sizes != nullptr) {
+    statistics["largest_models"] = context_.model_sizes->to_json(*this);
+  }
+  if (context_.convergence_report != nullptr) {
+    statistics["convergence"] = context_.convergence_report->to_json();
+  }
+  if (context_.memory_accounting != nullptr) {
+    statistics["memory_usage"] = context_.memory_accounting->to_json();
+  }
   value["stats"] = statistics;
 
   value["filename_spec"] = Json::Value("model@*.json");
@@ -273,7 +819,7 @@ std::string Registry::dump_models() const {
   string << "// @";
   string << "generated\n";
   for (const auto& model : models_) {
-    writer->write(model.second.to_json(context_), &string);
+    writer->write(model.second->to_json(context_), &string);
     string << "\n";
   }
   for (const auto& field_model : field_models_) {
@@ -290,8 +836,8 @@ std::string Registry::dump_models() const {
 Json::Value Registry::models_to_json() const {
   auto models_value = Json::Value(Json::objectValue);
   models_value["models"] = Json::Value(Json::arrayValue);
-  for (auto model : models_) {
-    models_value["models"].append(model.second.to_json(context_));
+  for (const auto& model : models_) {
+    models_value["models"].append(model.second->to_json(context_));
   }
   models_value["field_models"] = Json::Value(Json::arrayValue);
   for (auto field_model : field_models_) {
@@ -307,102 +853,352 @@ Json::Value Registry::models_to_json() const {
 
 void Registry::dump_models(
     const std::filesystem::path& path,
-    const std::size_t batch_size) const {
-  std::vector<Model> models;
+    const std::size_t batch_size,
+    int compression_level,
+    bool string_tables,
+    const std::optional<std::filesystem::path>& index_path) const {
+  dump_models(
+      path,
+      "model@",
+      /* written_methods */ nullptr,
+      /* previous_fingerprints */ nullptr,
+      /* fingerprints */ nullptr,
+      batch_size,
+      compression_level,
+      string_tables,
+      index_path ? &*index_path : nullptr);
+}
+
+void Registry::dump_remaining_models(
+    const std::filesystem::path& path,
+    const std::string& filename_prefix,
+    const ConcurrentSet<const Method*>& written_methods,
+    const std::size_t batch_size,
+    int compression_level) const {
+  dump_models(
+      path,
+      filename_prefix,
+      &written_methods,
+      /* previous_fingerprints */ nullptr,
+      /* fingerprints */ nullptr,
+      batch_size,
+      compression_level,
+      /* string_tables */ false,
+      /* index_path */ nullptr);
+}
+
+ModelFingerprints Registry::dump_changed_models(
+    const std::filesystem::path& path,
+    const ModelFingerprints& previous_fingerprints,
+    const std::filesystem::path& tombstones_path,
+    const std::size_t batch_size,
+    int compression_level,
+    bool string_tables) const {
+  ModelFingerprints fingerprints;
+  dump_models(
+      path,
+      "model@",
+      /* written_methods */ nullptr,
+      &previous_fingerprints,
+      &fingerprints,
+      batch_size,
+      compression_level,
+      string_tables,
+      /* index_path */ nullptr);
+
+  auto removed_keys = fingerprints.removed_keys(previous_fingerprints);
+  std::ofstream tombstones(tombstones_path, std::ios_base::binary);
+  if (!tombstones.is_open()) {
+    ERROR(
+        1,
+        "Unable to write model tombstones to `{}`.",
+        tombstones_path.native());
+  } else {
+    for (const auto& key : removed_keys) {
+      tombstones << key << '\n';
+    }
+  }
+  LOG(1, "Removed {} models since the previous run.", removed_keys.size());
+
+  return fingerprints;
+}
+
+void Registry::dump_models(
+    const std::filesystem::path& path,
+    const std::string& filename_prefix,
+    const ConcurrentSet<const Method*>* MT_NULLABLE written_methods,
+    const ModelFingerprints* MT_NULLABLE previous_fingerprints,
+    ModelFingerprints* MT_NULLABLE fingerprints,
+    const std::size_t batch_size,
+    int compression_level,
+    bool string_tables,
+    const std::filesystem::path* MT_NULLABLE index_path) const {
+  // The maps are not modified while dumping, so we only keep pointers to
+  // their values rather than copying models when they are at their largest.
+  std::vector<const Model*> models;
+  models.reserve(models_.size());
   for (const auto& model : models_) {
-    models.push_back(model.second);
+    if (written_methods != nullptr &&
+        written_methods->count(model.first) > 0) {
+      continue;
+    }
+    models.push_back(model.second.get());
   }
 
-  std::vector<FieldModel> field_models;
+  std::vector<std::pair<const Field*, const FieldModel*>> field_models;
+  field_models.reserve(field_models_.size());
   for (const auto& field_model : field_models_) {
-    field_models.push_back(field_model.second);
+    field_models.emplace_back(field_model.first, &field_model.second);
   }
 
-  std::vector<LiteralModel> literal_models;
+  std::vector<std::pair<const std::string*, const LiteralModel*>>
+      literal_models;
+  literal_models.reserve(literal_models_.size());
   for (const auto& literal_model : literal_models_) {
-    literal_models.push_back(literal_model.second);
+    literal_models.emplace_back(&literal_model.first, &literal_model.second);
   }
 
   std::size_t total_elements =
       models.size() + field_models.size() + literal_models.size();
 
-  auto get_json_line = [&](std::size_t i) -> Json::Value {
+  // Method models are the bulk of the output, they are streamed without
+  // building a `Json::Value`.
+  auto write_json = [&](std::size_t i, JsonWriter& writer) {
     mt_assert(i < total_elements);
+    writer.clear();
     if (i < models.size()) {
-      return models[i].to_json(context_);
+      models[i]->write_json(writer, context_);
     } else if (i < models.size() + field_models.size()) {
-      return field_models[i - models.size()].to_json(context_);
+      writer.value(field_models[i - models.size()].second->to_json(context_));
     } else {
-      return literal_models[i - models.size() - field_models.size()].to_json(
-          context_);
+      writer.value(
+          literal_models[i - models.size() - field_models.size()]
+              .second->to_json(context_));
     }
   };
 
-  JsonValidation::write_sharded_json_files(
-      path, batch_size, total_elements, "model@", get_json_line);
-}
+  // Indices of the models to write, when only writing changed models.
+  std::optional<std::vector<std::size_t>> changed_elements;
+  if (fingerprints != nullptr) {
+    auto key = [&](std::size_t i) -> std::string {
+      if (i < models.size()) {
+        return "method " + models[i]->method()->show();
+      } else if (i < models.size() + field_models.size()) {
+        return "field " + field_models[i - models.size()].first->show();
+      } else {
+        return "literal " +
+            *literal_models[i - models.size() - field_models.size()].first;
+      }
+    };
 
-void Registry::dump_file_coverage_info(
-    const std::filesystem::path& output_path) const {
-  std::unordered_set<std::string> covered_paths;
-  for (const auto& [method, model] : models_) {
-    if (method->get_code() == nullptr || model.skip_analysis()) {
-      continue;
+    std::vector<std::uint64_t> hashes(total_elements);
+    auto queue = work_queue<std::size_t>(
+        [&](std::size_t i) {
+          Json::Value value;
+          if (i < models.size()) {
+            value = models[i]->to_json(context_);
+          } else if (i < models.size() + field_models.size()) {
+            value = field_models[i - models.size()].second->to_json(context_);
+          } else {
+            value = literal_models[i - models.size() - field_models.size()]
+                        .second->to_json(context_);
+          }
+          hashes[i] = ModelFingerprints::hash(value);
+        },
+        sparta::parallel::default_num_threads());
+    for (std::size_t i = 0; i < total_elements; i++) {
+      queue.add_item(i);
     }
+    queue.run_all();
 
-    const auto* path = context_.positions->get_path(method->dex_method());
-    if (path) {
-      covered_paths.insert(*path);
+    changed_elements = std::vector<std::size_t>();
+    for (std::size_t i = 0; i < total_elements; i++) {
+      auto model_key = key(i);
+      auto previous_hash = previous_fingerprints != nullptr
+          ? previous_fingerprints->get(model_key)
+          : std::nullopt;
+      if (!previous_hash || *previous_hash != hashes[i]) {
+        changed_elements->push_back(i);
+      }
+      fingerprints->set(std::move(model_key), hashes[i]);
     }
+    LOG(1,
+        "Writing {} changed models out of {}.",
+        changed_elements->size(),
+        total_elements);
   }
 
-  std::ofstream output_file;
-  output_file.open(output_path, std::ios_base::out);
-  if (!output_file.is_open()) {
-    ERROR(
-        1, "Unable to write file coverage info to `{}`.", output_path.native());
+  auto number_of_lines =
+      changed_elements ? changed_elements->size() : total_elements;
+  auto element = [&](std::size_t i) {
+    return changed_elements ? (*changed_elements)[i] : i;
+  };
+
+  // Length of each line, without the newline, to write the index.
+  std::vector<std::size_t> line_lengths(
+      index_path != nullptr ? number_of_lines : 0);
+  auto record_length = [&](std::size_t i, const JsonWriter& writer) {
+    if (index_path != nullptr) {
+      line_lengths[i] = writer.str().size();
+    }
+  };
+
+  if (string_tables) {
+    JsonValidation::write_sharded_json_lines_with_string_tables(
+        path,
+        batch_size,
+        number_of_lines,
+        filename_prefix,
+        k_string_table_prefix + filename_prefix,
+        [&](std::size_t i,
+            JsonStringTable& string_table,
+            std::ostream& output) {
+          thread_local JsonWriter writer;
+          writer.set_string_table(&string_table);
+          write_json(element(i), writer);
+          writer.set_string_table(nullptr);
+          record_length(i, writer);
+          output << writer.str();
+        },
+        compression_level);
+  } else {
+    JsonValidation::write_sharded_json_lines(
+        path,
+        batch_size,
+        number_of_lines,
+        filename_prefix,
+        [&](std::size_t i, std::ostream& output) {
+          thread_local JsonWriter writer;
+          write_json(element(i), writer);
+          record_length(i, writer);
+          output << writer.str();
+        },
+        compression_level);
+  }
+
+  if (index_path == nullptr) {
     return;
   }
 
-  for (const auto& path : covered_paths) {
-    output_file << path << std::endl;
+  // Offsets are in the decompressed shards, after the header of each shard.
+  std::vector<std::size_t> offsets(number_of_lines);
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < number_of_lines; i++) {
+    if (i % batch_size == 0) {
+      offset = JsonValidation::json_lines_header_size();
+    }
+    offsets[i] = offset;
+    offset += line_lengths[i] + 1;
   }
 
-  output_file.close();
+  const auto* extension =
+      JsonValidation::json_lines_extension(compression_level);
+  auto writer = JsonValidation::compact_writer();
+  JsonValidation::write_json_lines_file(
+      *index_path,
+      [&](std::ostream& output) {
+        for (std::size_t i = 0; i < number_of_lines; i++) {
+          auto j = element(i);
+          auto value = Json::Value(Json::objectValue);
+          if (j < models.size()) {
+            value["method"] = models[j]->method()->to_json();
+          } else if (j < models.size() + field_models.size()) {
+            value["field"] = field_models[j - models.size()].first->to_json();
+          } else {
+            value["literal"] =
+                *literal_models[j - models.size() - field_models.size()].first;
+          }
+          value["shard"] = filename_prefix +
+              JsonValidation::json_lines_shard_name(
+                               i / batch_size, batch_size, number_of_lines) +
+              extension;
+          value["offset"] = Json::UInt64(offsets[i]);
+          value["length"] = Json::UInt64(line_lengths[i] + 1);
+          writer->write(value, &output);
+          output << "\n";
+        }
+      },
+      /* compression_level */ 0);
 }
 
-void Registry::dump_rule_coverage_info(
-    const std::filesystem::path& output_path) const {
-  std::unordered_set<const Kind*> used_sources;
-  std::unordered_set<const Kind*> used_sinks;
-  std::unordered_set<const Transform*> used_transforms;
-
-  for (const auto& [_method, model] : models_) {
-    auto source_kinds = model.source_kinds();
-    used_sources.insert(source_kinds.begin(), source_kinds.end());
+void Registry::dump_binary_models(
+    const std::filesystem::path& path,
+    const std::size_t batch_size) const {
+  std::vector<const Model*> models;
+  models.reserve(models_.size());
+  for (const auto& model : models_) {
+    models.push_back(model.second.get());
+  }
 
-    auto sink_kinds = model.sink_kinds();
-    used_sinks.insert(sink_kinds.begin(), sink_kinds.end());
+  std::vector<const FieldModel*> field_models;
+  field_models.reserve(field_models_.size());
+  for (const auto& field_model : field_models_) {
+    field_models.push_back(&field_model.second);
+  }
 
-    auto transforms = model.local_transform_kinds();
-    used_transforms.insert(transforms.begin(), transforms.end());
+  std::vector<const LiteralModel*> literal_models;
+  literal_models.reserve(literal_models_.size());
+  for (const auto& literal_model : literal_models_) {
+    literal_models.push_back(&literal_model.second);
   }
 
-  for (const auto& [_field, model] : field_models_) {
-    auto source_kinds = model.sources().kinds();
-    used_sources.insert(source_kinds.begin(), source_kinds.end());
+  std::size_t total_elements =
+      models.size() + field_models.size() + literal_models.size();
 
-    auto sink_kinds = model.sinks().kinds();
-    used_sinks.insert(sink_kinds.begin(), sink_kinds.end());
+  auto get_value = [&](std::size_t i) -> Json::Value {
+    mt_assert(i < total_elements);
+    if (i < models.size()) {
+      return models[i]->to_json(context_);
+    } else if (i < models.size() + field_models.size()) {
+      return field_models[i - models.size()]->to_json(context_);
+    } else {
+      return literal_models[i - models.size() - field_models.size()]->to_json(
+          context_);
+    }
+  };
+
+  BinaryJsonWriter::write_sharded_files(
+      path, batch_size, total_elements, "model@", get_value);
+}
+
+void Registry::dump_file_coverage_info(
+    const std::filesystem::path& output_path) const {
+  write_file_coverage_info(
+      output_path, summarize(/* include_coverage */ true));
+}
+
+void Registry::dump_rule_coverage_info(
+    const std::filesystem::path& output_path) const {
+  write_rule_coverage_info(
+      output_path, summarize(/* include_coverage */ true));
+}
+
+void Registry::write_file_coverage_info(
+    const std::filesystem::path& output_path,
+    const Summary& summary) const {
+  std::ofstream output_file;
+  output_file.open(output_path, std::ios_base::out);
+  if (!output_file.is_open()) {
+    ERROR(
+        1, "Unable to write file coverage info to `{}`.", output_path.native());
+    return;
   }
 
-  for (const auto& [_literal, model] : literal_models_) {
-    auto source_kinds = model.sources().kinds();
-    used_sources.insert(source_kinds.begin(), source_kinds.end());
+  for (const auto& path : summary.covered_paths) {
+    output_file << path << "\n";
   }
 
+  output_file.close();
+}
+
+void Registry::write_rule_coverage_info(
+    const std::filesystem::path& output_path,
+    const Summary& summary) const {
   auto rule_coverage = RulesCoverage::create(
-      *(context_.rules), used_sources, used_sinks, used_transforms);
+      *(context_.rules),
+      summary.used_sources,
+      summary.used_sinks,
+      summary.used_transforms);
   JsonValidation::write_json_file(output_path, rule_coverage.to_json());
 }
 
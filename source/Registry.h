@@ -7,23 +7,37 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include <boost/filesystem/path.hpp>
 #include <json/json.h>
+#include <re2/set.h>
 
 #include <ConcurrentContainers.h>
 #include <DexClass.h>
 #include <DexStore.h>
 
+#include <mariana-trench/Compiler.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/FieldModel.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/KindCounters.h>
 #include <mariana-trench/LiteralModel.h>
 #include <mariana-trench/Model.h>
+#include <mariana-trench/ModelFingerprints.h>
 
 namespace marianatrench {
 
 class Registry final {
  public:
+  static constexpr const char* k_string_table_prefix = "string-table-";
+
   /* Create a registry with default models for all methods. */
   explicit Registry(Context& context);
 
@@ -45,7 +59,8 @@ class Registry final {
   /**
    * Load the global registry
    *
-   * This joins all generated models and json models.
+   * This joins all generated models and json models, without the kinds that
+   * are not used by `context.rules`, which must be loaded beforehand.
    * Afterwards, it creates a default model for methods that don't have one.
    */
   static Registry load(
@@ -60,8 +75,52 @@ class Registry final {
   Model get(const Method* method) const;
   FieldModel get(const Field* field) const;
 
+  /**
+   * Returns false if no field with the name of the given field reference has a
+   * model, in which case accesses to it do not need to be resolved. This is
+   * thread-safe.
+   */
+  bool may_have_field_model(const DexFieldRef* field) const;
+
+  /**
+   * Return a read-only snapshot of the model of the given method, without
+   * copying it. This is thread-safe.
+   *
+   * Models are immutable once published: a later `set` publishes a new model
+   * and does not affect snapshots held by readers.
+   */
+  std::shared_ptr<const Model> get_snapshot(const Method* method) const;
+
   /* This is thread-safe. */
   void set(const Model& model);
+  void set(Model&& model);
+
+  /**
+   * Freeze the models returned by `get` and `get_snapshot` into an array
+   * indexed by `MethodId`, read without locking. Models published afterwards
+   * are only visible once `unfreeze` is called, e.g at the end of a global
+   * iteration. This is not thread-safe.
+   */
+  void freeze();
+  void unfreeze();
+
+  /**
+   * Release the model of a method that is not read anymore, e.g once the
+   * model was streamed and the dependents of the method are stable. Only the
+   * statistics of the model used by the metadata and the coverage are kept,
+   * reading the model afterwards throws. Options reading models after the
+   * fixpoint are rejected with `--resident-set-size-target`. This is
+   * thread-safe.
+   */
+  void evict(const Method* method);
+
+  /**
+   * Apply `update` to the model of the given method. This is thread-safe: the
+   * update runs under the lock of the entry, hence concurrent updates of a
+   * method are not lost. The model is updated in place unless readers hold a
+   * snapshot of it, in which case a copy is updated and published instead.
+   */
+  void update(const Method* method, const std::function<void(Model&)>& update);
 
   /*
    * Checks the given literal against each configured literal model and returns
@@ -72,17 +131,91 @@ class Registry final {
    */
   LiteralModel match_literal(std::string_view literal) const;
 
+  /**
+   * Same as above, but memoizes the result for the given string. This is
+   * thread-safe.
+   */
+  LiteralModel match_literal(const DexString* literal) const;
+
+  /* This includes evicted models. */
   std::size_t models_size() const;
+  std::size_t evicted_models_size() const;
   std::size_t field_models_size() const;
   std::size_t issues_size() const;
 
+  /**
+   * Approximate memory used by the models, in bytes, by component (e.g
+   * `sinks`). Method models are measured on one method out of
+   * `sampling_rate`. This is not thread-safe.
+   */
+  std::map<std::string, std::size_t> memory_usage(
+      std::size_t sampling_rate) const;
+
+  /**
+   * From now on, maintain the number of models in which each kind occurs, as
+   * models are set, joined or updated. Coverage info is then computed from the
+   * counters instead of the kinds of all models. This is not thread-safe.
+   */
+  void count_kinds();
+
+  /* This is thread-safe. */
   void join_with(const Model& model);
+  void join_with(Model&& model);
+  /* This is thread-safe. */
   void join_with(const FieldModel& field_model);
   void join_with(const LiteralModel& literal_model);
   void join_with(const Registry& other);
 
   void dump_metadata(const std::filesystem::path& path) const;
+  /**
+   * Same as `dump_metadata`, `dump_file_coverage_info` and
+   * `dump_rule_coverage_info`, computed from a single parallel pass over the
+   * models. Coverage info is only written for the given paths.
+   */
+  void dump_metadata_and_coverage_info(
+      const std::filesystem::path& metadata_path,
+      const std::optional<std::filesystem::path>& file_coverage_path,
+      const std::optional<std::filesystem::path>& rule_coverage_path) const;
+  /**
+   * Write the models in json lines shards. With `string_tables`, interned
+   * strings are written in a string table per shard (see `JsonStringTable`),
+   * named after `k_string_table_prefix` followed by the shard name.
+   * With `index_path`, also writes the shard, offset and length of each model
+   * in the decompressed shards, as json lines.
+   */
   void dump_models(
+      const std::filesystem::path& path,
+      const std::size_t shard_limit = JsonValidation::k_default_shard_limit,
+      int compression_level = 0,
+      bool string_tables = false,
+      const std::optional<std::filesystem::path>& index_path =
+          std::nullopt) const;
+  /**
+   * Same as `dump_models`, but skips the models of `written_methods` and
+   * names the shards after `filename_prefix`. This completes the output of a
+   * `ModelStreamer`.
+   */
+  void dump_remaining_models(
+      const std::filesystem::path& path,
+      const std::string& filename_prefix,
+      const ConcurrentSet<const Method*>& written_methods,
+      const std::size_t shard_limit = JsonValidation::k_default_shard_limit,
+      int compression_level = 0) const;
+  /**
+   * Same as `dump_models`, but only writes the models whose content changed
+   * since the run of `previous_fingerprints`, and writes the keys of the
+   * models that no longer exist in `tombstones_path`. Returns the
+   * fingerprints of all models.
+   */
+  ModelFingerprints dump_changed_models(
+      const std::filesystem::path& path,
+      const ModelFingerprints& previous_fingerprints,
+      const std::filesystem::path& tombstones_path,
+      const std::size_t shard_limit = JsonValidation::k_default_shard_limit,
+      int compression_level = 0,
+      bool string_tables = false) const;
+  /* Same as `dump_models`, in the binary format of `BinaryJsonWriter`. */
+  void dump_binary_models(
       const std::filesystem::path& path,
       const std::size_t shard_limit =
           JsonValidation::k_default_shard_limit) const;
@@ -91,12 +224,88 @@ class Registry final {
   std::string dump_models() const;
   Json::Value models_to_json() const;
 
+ private:
+  /* Statistics and coverage of all models. */
+  struct Summary {
+    std::size_t issues = 0;
+    std::size_t methods_without_code = 0;
+    std::size_t methods_skipped = 0;
+    std::unordered_set<std::string> covered_paths;
+    std::unordered_set<const Kind*> used_sources;
+    std::unordered_set<const Kind*> used_sinks;
+    std::unordered_set<const Transform*> used_transforms;
+  };
+
+  Summary summarize(bool include_coverage) const;
+  void write_metadata(
+      const std::filesystem::path& path,
+      const Summary& summary) const;
+  void write_file_coverage_info(
+      const std::filesystem::path& path,
+      const Summary& summary) const;
+  void write_rule_coverage_info(
+      const std::filesystem::path& path,
+      const Summary& summary) const;
+
+  void dump_models(
+      const std::filesystem::path& path,
+      const std::string& filename_prefix,
+      const ConcurrentSet<const Method*>* MT_NULLABLE written_methods,
+      const ModelFingerprints* MT_NULLABLE previous_fingerprints,
+      ModelFingerprints* MT_NULLABLE fingerprints,
+      const std::size_t shard_limit,
+      int compression_level,
+      bool string_tables,
+      const std::filesystem::path* MT_NULLABLE index_path) const;
+
+  /* Same as the public constructor, without the kinds unused by `rules`. */
+  explicit Registry(
+      Context& context,
+      const std::vector<Model>& models,
+      const std::vector<FieldModel>& field_models,
+      const Rules* MT_NULLABLE rules);
+
+  /* Precompile the patterns of all literal models into a single set. */
+  void index_literal_models();
+
+  /**
+   * Update the kind counters with the new model of the given method, if kinds
+   * are counted. This must be called under the lock of the entry of the
+   * method in `models_`.
+   */
+  void update_kind_counters(const Method* method, const Model& model);
+
  private:
   Context& context_;
 
-  mutable ConcurrentMap<const Method*, Model> models_;
+  ConcurrentMap<const Method*, std::shared_ptr<const Model>> models_;
+  /* Models at the last `freeze`, indexed by `MethodId`, or empty. */
+  std::vector<std::shared_ptr<const Model>> frozen_models_;
+
+  /* What `summarize` needs from an evicted model. */
+  struct EvictedModel {
+    std::size_t issues = 0;
+    bool skip_analysis = false;
+    // Empty if kinds are counted, since they remain in the counters.
+    KindCounters::ModelKinds kinds;
+  };
+  ConcurrentMap<const Method*, EvictedModel> evicted_models_;
+  /* Only set with `count_kinds`. */
+  std::unique_ptr<KindCounters> kind_counters_;
+  /* Kinds of the current model of each method, in `kind_counters_`. */
+  ConcurrentMap<const Method*, KindCounters::ModelKinds> model_kinds_;
   ConcurrentMap<const Field*, FieldModel> field_models_;
+  /* Names of the fields in `field_models_`. */
+  ConcurrentSet<const DexString*> field_model_names_;
   ConcurrentMap<std::string, LiteralModel> literal_models_;
+
+  /* Patterns of `literal_models_`, in the order they were added to the set. */
+  std::unique_ptr<re2::RE2::Set> literal_pattern_set_;
+  std::vector<std::string> literal_set_patterns_;
+  /* Patterns that could not be added to the set are matched one by one. */
+  std::vector<std::string> literal_unindexed_patterns_;
+  mutable ConcurrentMap<const DexString*, std::shared_ptr<const LiteralModel>>
+      literal_matches_;
 };
 
 } // namespace marianatrench
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <functional>
+#include <unordered_set>
+
+#include <ControlFlow.h>
+#include <IRCode.h>
+#include <IRInstruction.h>
+
+#include <mariana-trench/ArtificialMethods.h>
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/RelevancePrescan.h>
+
+namespace marianatrench {
+
+namespace {
+
+bool any_callee(
+    const Registry& registry,
+    const CallTarget& call_target,
+    const std::function<bool(const Model&)>& predicate) {
+  if (!call_target.resolved()) {
+    return false;
+  }
+  if (predicate(*registry.get_snapshot(call_target.resolved_base_callee()))) {
+    return true;
+  }
+  if (call_target.is_virtual()) {
+    for (const auto* override : call_target.overrides()) {
+      if (predicate(*registry.get_snapshot(override))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* Whether a callee of the method, including artificial callees, matches. */
+bool any_callee(
+    const Method* method,
+    const CallGraph& call_graph,
+    const Registry& registry,
+    const std::function<bool(const Model&)>& predicate) {
+  for (const auto& call_target : call_graph.call_targets(method)) {
+    if (any_callee(registry, call_target, predicate)) {
+      return true;
+    }
+  }
+  for (const auto& [instruction, artificial_callees] :
+       call_graph.artificial_callees(method)) {
+    for (const auto& artificial_callee : artificial_callees) {
+      if (any_callee(registry, artificial_callee.call_target, predicate)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool has_sources(const Model& model) {
+  return !model.source_kinds().empty();
+}
+
+bool has_sinks(const Model& model) {
+  return !model.sink_kinds().empty();
+}
+
+bool has_kinds(const Model& model) {
+  return !model.source_kinds().empty() || !model.sink_kinds().empty();
+}
+
+} // namespace
+
+bool RelevancePrescan::may_introduce_forward_taint(
+    const Context& context,
+    const Registry& registry,
+    const Model& previous_model) {
+  const auto* method = previous_model.method();
+  const auto& call_graph = *context.call_graph;
+  if (has_sources(previous_model) ||
+      any_callee(method, call_graph, registry, has_sources)) {
+    return true;
+  }
+
+  for (const auto* block : method->get_code()->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      if (instruction->opcode() == OPCODE_CONST_STRING &&
+          !registry.match_literal(instruction->get_string()).empty()) {
+        return true;
+      }
+      auto field_access = call_graph.resolved_field_access(method, instruction);
+      if (field_access &&
+          !registry.get(field_access->field).sources().is_bottom()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool RelevancePrescan::may_introduce_backward_taint(
+    const Context& context,
+    const Registry& registry,
+    const Model& previous_model) {
+  const auto* method = previous_model.method();
+  const auto& call_graph = *context.call_graph;
+  if (has_sinks(previous_model) ||
+      any_callee(method, call_graph, registry, has_sinks)) {
+    return true;
+  }
+
+  bool array_allocation_kind_used =
+      context.artificial_methods->array_allocation_kind_used();
+  for (const auto* block : method->get_code()->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      auto opcode = instruction->opcode();
+      // Returned values are tainted with the local return kind.
+      if (opcode::is_a_return(opcode) && instruction->srcs_size() > 0) {
+        return true;
+      }
+      if (array_allocation_kind_used &&
+          (opcode == OPCODE_NEW_ARRAY || opcode == OPCODE_FILLED_NEW_ARRAY)) {
+        return true;
+      }
+      if (!opcode::is_an_iput(opcode) && !opcode::is_an_sput(opcode)) {
+        continue;
+      }
+      auto field_access = call_graph.resolved_field_access(method, instruction);
+      if (field_access &&
+          !registry.get(field_access->field).sinks().is_bottom()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool RelevancePrescan::may_change_model(
+    const Context& context,
+    const Registry& registry,
+    const Model& previous_model) {
+  const auto* method = previous_model.method();
+  auto facts = code_facts(context, registry, method);
+  return facts.uses_parameters || facts.accesses_models ||
+      has_kinds(previous_model) ||
+      any_callee(method, *context.call_graph, registry, has_kinds);
+}
+
+RelevancePrescan::CodeFacts RelevancePrescan::code_facts(
+    const Context& context,
+    const Registry& registry,
+    const Method* method) {
+  if (auto cached = code_facts_.get(method, /* default */ std::nullopt)) {
+    return *cached;
+  }
+
+  CodeFacts facts;
+  std::unordered_set<reg_t> parameter_registers;
+  const auto& call_graph = *context.call_graph;
+  for (const auto* block : method->get_code()->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      if (opcode::is_a_load_param(instruction->opcode())) {
+        parameter_registers.insert(instruction->dest());
+        continue;
+      }
+      for (auto register_id : instruction->srcs()) {
+        if (parameter_registers.count(register_id) > 0) {
+          facts.uses_parameters = true;
+        }
+      }
+      if (instruction->opcode() == OPCODE_CONST_STRING &&
+          !registry.match_literal(instruction->get_string()).empty()) {
+        facts.accesses_models = true;
+      }
+      auto field_access = call_graph.resolved_field_access(method, instruction);
+      if (field_access && !registry.get(field_access->field).empty()) {
+        facts.accesses_models = true;
+      }
+    }
+  }
+
+  // Concurrent computations for the same method find the same facts.
+  code_facts_.emplace(method, facts);
+  return facts;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * Cheap scans of the code of a method and of its callee models, used to skip
+ * fixpoints that cannot change its model.
+ *
+ * Facts about the code used by `may_change_model` (uses of parameters,
+ * accesses to fields and string literals with models) are computed once per
+ * method, since field and literal models do not change during the fixpoint.
+ * Callee models are read on each query, hence a change of a callee model is
+ * seen by the next analysis of its callers.
+ */
+class RelevancePrescan final {
+ private:
+  struct CodeFacts {
+    // A parameter register is read by an instruction.
+    bool uses_parameters = false;
+    // A field or string literal has a model.
+    bool accesses_models = false;
+  };
+
+ public:
+  RelevancePrescan() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(RelevancePrescan)
+
+  /**
+   * Whether the forward taint analysis of the method may find taint: through
+   * its parameter or call effect sources, the sources of its callees
+   * (including overrides and artificial callees), or fields and string
+   * literals with sources. Otherwise, the forward taint environment is bottom
+   * at every instruction. This is thread-safe.
+   */
+  static bool may_introduce_forward_taint(
+      const Context& context,
+      const Registry& registry,
+      const Model& previous_model);
+
+  /**
+   * Whether the backward taint analysis of the method may find taint besides
+   * its initial environment: through returned values, the sinks of its own
+   * model or of its callees (including overrides and artificial callees), or
+   * fields and array allocations with sinks. Otherwise, and if the initial
+   * environment is bottom, the backward taint environment is bottom at every
+   * instruction. This is thread-safe.
+   */
+  static bool may_introduce_backward_taint(
+      const Context& context,
+      const Registry& registry,
+      const Model& previous_model);
+
+  /**
+   * Whether analyzing the method may infer anything beyond its initial model.
+   * This is false when its parameters are never read, its own model and its
+   * callee models have no source or sink kinds, and it accesses no field or
+   * string literal with a model. Parameters that are never read cannot flow
+   * anywhere, and no taint can appear without kinds. This is thread-safe.
+   */
+  bool may_change_model(
+      const Context& context,
+      const Registry& registry,
+      const Model& previous_model);
+
+ private:
+  CodeFacts code_facts(
+      const Context& context,
+      const Registry& registry,
+      const Method* method);
+
+ private:
+  ConcurrentMap<const Method*, std::optional<CodeFacts>> code_facts_;
+};
+
+} // namespace marianatrench
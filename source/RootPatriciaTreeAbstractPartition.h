@@ -7,34 +7,119 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include <boost/iterator/transform_iterator.hpp>
-
 #include <sparta/AbstractDomain.h>
 #include <sparta/PatriciaTreeMapAbstractPartition.h>
 
 #include <mariana-trench/Access.h>
+#include <mariana-trench/Compiler.h>
 #include <mariana-trench/IncludeMacros.h>
 
 namespace marianatrench {
 
 /**
- * A patricia tree map abstract partition from root to the given domain.
+ * An abstract partition from root to the given domain.
+ *
+ * Ports are nearly always a return or an argument with a small position, hence
+ * these roots are stored in a flat array indexed by root, and other roots in a
+ * patricia tree map. The array is shared on copy and copied on write, so copies
+ * stay cheap and operations on two partitions sharing it skip the array.
  */
 template <typename Domain>
 class RootPatriciaTreeAbstractPartition final
     : public sparta::AbstractDomain<RootPatriciaTreeAbstractPartition<Domain>> {
  private:
   using Map = sparta::PatriciaTreeMapAbstractPartition<Root, Domain>;
+  using MapIterator = typename Map::MapType::iterator;
+  using Binding = std::remove_cv_t<
+      std::remove_reference_t<decltype(*std::declval<MapIterator>())>>;
+
+  // Arguments `0` to `k_flat_arguments - 1` and the return are stored flat.
+  static constexpr std::size_t k_flat_arguments = 8;
+  static constexpr std::size_t k_return_index = k_flat_arguments;
+  static constexpr std::size_t k_flat_size = k_flat_arguments + 1;
+  using Flat = std::array<Binding, k_flat_size>;
 
  public:
+  /* Iterator over the bindings not set to bottom, flat roots first. */
+  class Iterator final {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Binding;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Binding*;
+    using reference = const Binding&;
+
+    Iterator(
+        const Flat* MT_NULLABLE flat,
+        std::size_t index,
+        MapIterator map_iterator)
+        : flat_(flat), index_(index), map_iterator_(std::move(map_iterator)) {
+      skip_bottom();
+    }
+
+    reference operator*() const {
+      return index_ < k_flat_size ? (*flat_)[index_] : *map_iterator_;
+    }
+
+    pointer operator->() const {
+      return &**this;
+    }
+
+    Iterator& operator++() {
+      if (index_ < k_flat_size) {
+        ++index_;
+        skip_bottom();
+      } else {
+        ++map_iterator_;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_ && map_iterator_ == other.map_iterator_;
+    }
+
+    bool operator!=(const Iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    void skip_bottom() {
+      if (flat_ == nullptr) {
+        index_ = k_flat_size;
+        return;
+      }
+      while (index_ < k_flat_size && (*flat_)[index_].second.is_bottom()) {
+        ++index_;
+      }
+    }
+
+   private:
+    const Flat* MT_NULLABLE flat_;
+    std::size_t index_;
+    MapIterator map_iterator_;
+  };
+
   // C++ container concept member types
   using key_type = Root;
   using mapped_type = Domain;
-  using value_type = std::pair<const Root, Domain>;
-  using iterator = typename Map::MapType::iterator;
+  using value_type = Binding;
+  using iterator = Iterator;
   using const_iterator = iterator;
   using difference_type = std::ptrdiff_t;
   using size_type = std::size_t;
@@ -65,22 +150,164 @@ class RootPatriciaTreeAbstractPartition final
   INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(
       RootPatriciaTreeAbstractPartition)
 
-  INCLUDE_ABSTRACT_DOMAIN_METHODS(RootPatriciaTreeAbstractPartition, Map, map_)
+  static RootPatriciaTreeAbstractPartition bottom() {
+    return RootPatriciaTreeAbstractPartition(Map::bottom());
+  }
+
+  static RootPatriciaTreeAbstractPartition top() {
+    return RootPatriciaTreeAbstractPartition(Map::top());
+  }
+
+  bool is_bottom() const {
+    return map_.is_bottom() && flat_is_bottom();
+  }
+
+  bool is_top() const {
+    return map_.is_top();
+  }
+
+  void set_to_bottom() {
+    flat_ = nullptr;
+    map_.set_to_bottom();
+  }
+
+  void set_to_top() {
+    flat_ = nullptr;
+    map_.set_to_top();
+  }
+
+  bool leq(const RootPatriciaTreeAbstractPartition& other) const {
+    if (is_top()) {
+      return other.is_top();
+    }
+    if (other.is_top()) {
+      return true;
+    }
+    if (flat_ != other.flat_) {
+      for (std::size_t index = 0; index < k_flat_size; index++) {
+        if (!flat_value(index).leq(other.flat_value(index))) {
+          return false;
+        }
+      }
+    }
+    return map_.leq(other.map_);
+  }
+
+  bool equals(const RootPatriciaTreeAbstractPartition& other) const {
+    if (is_top() || other.is_top()) {
+      return is_top() && other.is_top();
+    }
+    if (flat_ != other.flat_) {
+      for (std::size_t index = 0; index < k_flat_size; index++) {
+        if (!flat_value(index).equals(other.flat_value(index))) {
+          return false;
+        }
+      }
+    }
+    return map_.equals(other.map_);
+  }
+
+  void join_with(const RootPatriciaTreeAbstractPartition& other) {
+    if (is_top()) {
+      return;
+    }
+    if (other.is_top()) {
+      set_to_top();
+      return;
+    }
+    if (flat_ == nullptr) {
+      flat_ = other.flat_;
+    } else if (other.flat_ != nullptr && flat_ != other.flat_) {
+      combine_flat(other, [](Domain& left, const Domain& right) {
+        left.join_with(right);
+      });
+    }
+    map_.join_with(other.map_);
+  }
+
+  void widen_with(const RootPatriciaTreeAbstractPartition& other) {
+    if (is_top()) {
+      return;
+    }
+    if (other.is_top()) {
+      set_to_top();
+      return;
+    }
+    if (flat_ == nullptr) {
+      flat_ = other.flat_;
+    } else if (other.flat_ != nullptr && flat_ != other.flat_) {
+      combine_flat(other, [](Domain& left, const Domain& right) {
+        left.widen_with(right);
+      });
+    }
+    map_.widen_with(other.map_);
+  }
+
+  void meet_with(const RootPatriciaTreeAbstractPartition& other) {
+    if (other.is_top()) {
+      return;
+    }
+    if (is_top()) {
+      *this = other;
+      return;
+    }
+    if (other.flat_ == nullptr) {
+      flat_ = nullptr;
+    } else if (flat_ != nullptr && flat_ != other.flat_) {
+      combine_flat(other, [](Domain& left, const Domain& right) {
+        left.meet_with(right);
+      });
+    }
+    map_.meet_with(other.map_);
+  }
+
+  void narrow_with(const RootPatriciaTreeAbstractPartition& other) {
+    if (other.is_top()) {
+      return;
+    }
+    if (is_top()) {
+      *this = other;
+      return;
+    }
+    if (other.flat_ == nullptr) {
+      flat_ = nullptr;
+    } else if (flat_ != nullptr && flat_ != other.flat_) {
+      combine_flat(other, [](Domain& left, const Domain& right) {
+        left.narrow_with(right);
+      });
+    }
+    map_.narrow_with(other.map_);
+  }
 
   /* Return the number of bindings not set to bottom. */
   std::size_t size() const {
-    return map_.size();
+    std::size_t size = map_.size();
+    for (std::size_t index = 0; index < k_flat_size; index++) {
+      if (!flat_value(index).is_bottom()) {
+        size++;
+      }
+    }
+    return size;
   }
 
   iterator begin() const {
-    return map_.bindings().begin();
+    return Iterator(flat_.get(), 0, map_.bindings().begin());
   }
 
   iterator end() const {
-    return map_.bindings().end();
+    return Iterator(flat_.get(), k_flat_size, map_.bindings().end());
   }
 
   void difference_with(const RootPatriciaTreeAbstractPartition& other) {
+    if (flat_ == other.flat_) {
+      flat_ = nullptr;
+    } else if (flat_ != nullptr && other.flat_ != nullptr) {
+      combine_flat(other, [](Domain& left, const Domain& right) {
+        if (left.leq(right)) {
+          left.set_to_bottom();
+        }
+      });
+    }
     map_.difference_like_operation(
         other.map_, [](const Domain& left, const Domain& right) {
           if (left.leq(right)) {
@@ -91,21 +318,47 @@ class RootPatriciaTreeAbstractPartition final
   }
 
   const Domain& get(Root root) const {
-    return map_.get(root);
+    auto index = flat_index(root);
+    if (index == k_flat_size) {
+      return map_.get(root);
+    }
+    if (is_top()) {
+      static const Domain top = Domain::top();
+      return top;
+    }
+    return flat_value(index);
   }
 
   void set(Root root, const Domain& value) {
-    map_.set(root, value);
+    auto index = flat_index(root);
+    if (index == k_flat_size) {
+      map_.set(root, value);
+    } else if (!is_top() && (flat_ != nullptr || !value.is_bottom())) {
+      mutable_flat()[index].second = value;
+    }
   }
 
   template <typename Operation> // Domain(const Domain&)
   void update(Root root, Operation&& operation) {
-    map_.update(root, std::forward<Operation>(operation));
+    auto index = flat_index(root);
+    if (index == k_flat_size) {
+      map_.update(root, std::forward<Operation>(operation));
+    } else if (!is_top()) {
+      auto& value = mutable_flat()[index].second;
+      value = operation(value);
+    }
   }
 
   template <typename Function> // Domain(const Domain&)
-  bool transform(Function&& f) {
-    return map_.transform(std::forward<Function>(f));
+  void transform(Function&& f) {
+    if (!is_top() && !flat_is_bottom()) {
+      for (auto& binding : mutable_flat()) {
+        if (!binding.second.is_bottom()) {
+          binding.second = f(binding.second);
+        }
+      }
+    }
+    map_.transform(std::forward<Function>(f));
   }
 
   friend std::ostream& operator<<(
@@ -119,6 +372,73 @@ class RootPatriciaTreeAbstractPartition final
   }
 
  private:
+  /* Index of the root in the flat array, or `k_flat_size` if not stored. */
+  static std::size_t flat_index(Root root) {
+    if (root.is_return()) {
+      return k_return_index;
+    }
+    if (root.is_argument() && root.parameter_position() < k_flat_arguments) {
+      return root.parameter_position();
+    }
+    return k_flat_size;
+  }
+
+  static Root flat_root(std::size_t index) {
+    if (index == k_return_index) {
+      return Root(Root::Kind::Return);
+    }
+    return Root(Root::Kind::Argument, static_cast<ParameterPosition>(index));
+  }
+
+  template <std::size_t... Indices>
+  static Flat make_flat(std::index_sequence<Indices...>) {
+    return Flat{Binding(flat_root(Indices), Domain::bottom())...};
+  }
+
+  const Domain& flat_value(std::size_t index) const {
+    if (flat_ == nullptr) {
+      static const Domain bottom = Domain::bottom();
+      return bottom;
+    }
+    return (*flat_)[index].second;
+  }
+
+  bool flat_is_bottom() const {
+    if (flat_ == nullptr) {
+      return true;
+    }
+    for (const auto& binding : *flat_) {
+      if (!binding.second.is_bottom()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* Return the flat array, copying it first if it is shared. */
+  Flat& mutable_flat() {
+    if (flat_ == nullptr) {
+      flat_ = std::make_shared<Flat>(
+          make_flat(std::make_index_sequence<k_flat_size>{}));
+    } else if (flat_.use_count() > 1) {
+      flat_ = std::make_shared<Flat>(*flat_);
+    }
+    return *flat_;
+  }
+
+  template <typename Combine> // void(Domain&, const Domain&)
+  void combine_flat(
+      const RootPatriciaTreeAbstractPartition& other,
+      Combine&& combine) {
+    auto& flat = mutable_flat();
+    for (std::size_t index = 0; index < k_flat_size; index++) {
+      combine(flat[index].second, other.flat_value(index));
+    }
+  }
+
+ private:
+  // Values of the flat roots, or nullptr if they are all bottom.
+  std::shared_ptr<Flat> flat_;
   Map map_;
 };
 
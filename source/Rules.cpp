@@ -5,6 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <Show.h>
 
 #include <mariana-trench/JsonValidation.h>
@@ -14,6 +19,7 @@
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Rules.h>
 #include <mariana-trench/SourceSinkRule.h>
+#include <mariana-trench/WorkerPool.h>
 
 namespace marianatrench {
 
@@ -36,10 +42,40 @@ Rules::Rules(Context& context, const Json::Value& rules_value)
 Rules Rules::load(Context& context, const Options& options) {
   Rules rules(context);
 
-  for (const auto& rules_path : options.rules_paths()) {
-    auto rules_value = JsonValidation::parse_json_file(rules_path);
-    for (const auto& rule_value : JsonValidation::null_or_array(rules_value)) {
-      rules.add(context, Rule::from_json(rule_value, context));
+  // Rule files are parsed in parallel, but rules are added in order so that
+  // duplicates are reported deterministically.
+  const auto& rules_paths = options.rules_paths();
+  std::vector<std::vector<std::unique_ptr<Rule>>> file_rules(
+      rules_paths.size());
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        auto rules_value = JsonValidation::parse_json_file(rules_paths[index]);
+        for (const auto& rule_value :
+             JsonValidation::null_or_array(rules_value)) {
+          file_rules[index].push_back(Rule::from_json(rule_value, context));
+        }
+      },
+      sparta::parallel::default_num_threads());
+  for (std::size_t index = 0; index < rules_paths.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+
+  // Kinds only used by the other rules become unused, hence they are removed
+  // from models and methods that can only hold them are not analyzed.
+  const auto& rule_codes = options.rule_codes();
+  std::unordered_set<int> selected_codes(rule_codes.begin(), rule_codes.end());
+  for (auto& rules_from_file : file_rules) {
+    for (auto& rule : rules_from_file) {
+      if (!selected_codes.empty() && selected_codes.count(rule->code()) == 0) {
+        continue;
+      }
+      rules.add(context, std::move(rule));
+    }
+  }
+  for (auto code : rule_codes) {
+    if (rules.rules_.count(code) == 0) {
+      WARNING(1, "No rule with code {} in `--rule-codes`.", code);
     }
   }
 
@@ -61,6 +97,7 @@ void Rules::add(Context& context, std::unique_ptr<Rule> rule) {
   auto code = rule->code();
   auto result = rules_.emplace(code, std::move(rule));
   const Rule* rule_pointer = result.first->second.get();
+  unused_kinds_.clear();
 
   if (auto* source_sink_rule = rule_pointer->as<SourceSinkRule>()) {
     for (const auto* source_kind : source_sink_rule->source_kinds()) {
@@ -128,6 +165,50 @@ void Rules::add(Context& context, std::unique_ptr<Rule> rule) {
     // Unreachable code. Did we add a new type of rule?
     mt_unreachable();
   }
+
+  index_kinds();
+}
+
+void Rules::index_kinds() {
+  // Sink kinds of rules with transforms hold these transforms.
+  kind_indices_.clear();
+  auto index_of = [this](const Kind* kind) {
+    auto size = kind_indices_.size();
+    return kind_indices_.emplace(kind->discard_transforms(), size)
+        .first->second;
+  };
+  std::vector<std::pair<std::size_t, std::size_t>> rule_pairs;
+  for (const auto& [source_kind, sink_to_rules] : source_to_sink_to_rules_) {
+    for (const auto& [sink_kind, _rules] : sink_to_rules) {
+      rule_pairs.emplace_back(index_of(source_kind), index_of(sink_kind));
+    }
+  }
+  std::vector<std::pair<std::size_t, std::size_t>> partial_rule_pairs;
+  for (const auto& [source_kind, sink_to_rules] :
+       source_to_partial_sink_to_rules_) {
+    for (const auto& [sink_kind, _rules] : sink_to_rules) {
+      partial_rule_pairs.emplace_back(
+          index_of(source_kind), index_of(sink_kind));
+    }
+  }
+
+  auto size = kind_indices_.size();
+  rules_matrix_.assign(size * size, false);
+  for (auto [source_index, sink_index] : rule_pairs) {
+    rules_matrix_[source_index * size + sink_index] = true;
+  }
+  partial_rules_matrix_.assign(size * size, false);
+  for (auto [source_index, sink_index] : partial_rule_pairs) {
+    partial_rules_matrix_[source_index * size + sink_index] = true;
+  }
+}
+
+std::optional<std::size_t> Rules::kind_index(const Kind* kind) const {
+  auto found = kind_indices_.find(kind->discard_transforms());
+  if (found == kind_indices_.end()) {
+    return std::nullopt;
+  }
+  return found->second;
 }
 
 const std::vector<const Rule*>& Rules::rules(
@@ -199,17 +280,25 @@ const std::vector<const MultiSourceMultiSinkRule*>& Rules::partial_rules(
   return rules->second;
 }
 
+bool Rules::is_unused(const Kind* kind) const {
+  if (kind->is<TriggeredPartialKind>() || kind->is<PropagationKind>()) {
+    // These kinds are never used in rules.
+    return false;
+  }
+  if (auto unused = unused_kinds_.get(kind, std::nullopt)) {
+    return *unused;
+  }
+  bool unused = std::all_of(
+      begin(), end(), [kind](const Rule* rule) { return !rule->uses(kind); });
+  unused_kinds_.emplace(kind, unused);
+  return unused;
+}
+
 std::unordered_set<const Kind*> Rules::collect_unused_kinds(
     const KindFactory& kind_factory) const {
   std::unordered_set<const Kind*> unused_kinds;
   for (const auto* kind : kind_factory.kinds()) {
-    if (kind->is<TriggeredPartialKind>() || kind->is<PropagationKind>()) {
-      // These kinds are never used in rules.
-      continue;
-    }
-    if (std::all_of(begin(), end(), [kind](const Rule* rule) {
-          return !rule->uses(kind);
-        })) {
+    if (is_unused(kind)) {
       unused_kinds.insert(kind);
       WARNING(
           1,
@@ -7,13 +7,17 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 #include <boost/iterator/transform_iterator.hpp>
 #include <json/json.h>
 
+#include <ConcurrentContainers.h>
+
 #include <mariana-trench/Context.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Kind.h>
@@ -99,6 +103,39 @@ class Rules final {
       const Kind* source_kind,
       const PartialKind* sink_kind) const;
 
+  /**
+   * Index of the kind, without transforms, in the matrices of kinds with
+   * rules, or `std::nullopt` if no rule has this kind. This is thread-safe.
+   */
+  std::optional<std::size_t> kind_index(const Kind* kind) const;
+
+  /**
+   * Whether rules or partial rules may match source and sink kinds with the
+   * given indices, ignoring transforms. This is a bit lookup, hence pairs of
+   * kinds can be discarded before calling `rules` or `partial_rules`.
+   */
+  bool may_have_rules(std::size_t source_index, std::size_t sink_index) const {
+    return rules_matrix_[source_index * kind_indices_.size() + sink_index];
+  }
+
+  bool may_have_partial_rules(
+      std::size_t source_index,
+      std::size_t sink_index) const {
+    return partial_rules_matrix_
+        [source_index * kind_indices_.size() + sink_index];
+  }
+
+  /* Whether any multi-source/sink rule exists. */
+  bool has_partial_rules() const {
+    return !source_to_partial_sink_to_rules_.empty();
+  }
+
+  /**
+   * Whether the kind is not used by any rule, in which case it can be removed
+   * from models. This is memoized and thread-safe.
+   */
+  bool is_unused(const Kind* kind) const;
+
   std::unordered_set<const Kind*> collect_unused_kinds(
       const KindFactory& kinds) const;
 
@@ -118,6 +155,9 @@ class Rules final {
     return boost::make_transform_iterator(rules_.cend(), ExposeRulePointer());
   }
 
+ private:
+  void index_kinds();
+
  private:
   const TransformsFactory& transforms_factory;
   const KindFactory& kind_factory;
@@ -127,8 +167,13 @@ class Rules final {
   //   Inner sink kind = Kind with all Transforms
   SourceSinkRulesMap source_to_sink_to_rules_;
   SourcePartialSinkRulesMap source_to_partial_sink_to_rules_;
+  // Dense source kind x sink kind matrices, indexed by `kind_indices_`.
+  std::unordered_map<const Kind*, std::size_t> kind_indices_;
+  std::vector<bool> rules_matrix_;
+  std::vector<bool> partial_rules_matrix_;
   std::vector<const Rule*> empty_rule_set_;
   std::vector<const MultiSourceMultiSinkRule*> empty_multi_source_rule_set_;
+  mutable ConcurrentMap<const Kind*, std::optional<bool>> unused_kinds_;
 };
 
 } // namespace marianatrench
@@ -5,41 +5,304 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <queue>
+#include <unordered_set>
+
+#include <ControlFlow.h>
+#include <IRCode.h>
+
+#include <mariana-trench/Assert.h>
 #include <mariana-trench/Scheduler.h>
 
 namespace marianatrench {
 
+namespace {
+
+// Components costing more than this fraction of the share of one thread would
+// keep that thread busy long after the others, and delay their callers.
+constexpr double k_large_component_share = 0.25;
+
+bool is_large(
+    double cost,
+    std::size_t size,
+    double total_cost,
+    unsigned int threads) {
+  return threads > 1 && size > 1 &&
+      cost > k_large_component_share * total_cost / threads;
+}
+
+} // namespace
+
 // We use the dependency graph as the source of truth since it is more precise
 // than the call graph (for instance, it takes into account
 // `no-join-virtual-overrides`).
 Scheduler::Scheduler(const Methods& methods, const Dependencies& dependencies)
-    : strongly_connected_components_(methods, dependencies) {}
+    : strongly_connected_components_(methods, dependencies),
+      total_cost_(0.0),
+      seconds_per_instruction_(0.0) {
+  const auto& components = strongly_connected_components_.components();
+  for (std::size_t index = 0; index < components.size(); index++) {
+    for (const auto* method : components[index]) {
+      method_to_component_.emplace(method, index);
+      total_cost_ += cost(method, /* use_analysis_times */ false);
+    }
+  }
+
+  dependent_components_.resize(components.size());
+  callee_components_size_.resize(components.size(), 0);
+  for (std::size_t index = 0; index < components.size(); index++) {
+    std::unordered_set<std::size_t> dependent_components;
+    for (const auto* method : components[index]) {
+      for (const auto* caller : dependencies.dependencies(method)) {
+        auto found = method_to_component_.find(caller);
+        if (found != method_to_component_.end() && found->second != index) {
+          dependent_components.insert(found->second);
+        }
+      }
+    }
+    for (auto dependent_component : dependent_components) {
+      mt_assert(dependent_component > index);
+      dependent_components_[index].push_back(dependent_component);
+      callee_components_size_[dependent_component]++;
+    }
+  }
+
+  // Order components topologically, picking the ready component with the most
+  // dependencies first (ties are broken by index to keep this deterministic).
+  using ReadyComponent = std::pair<std::size_t, std::size_t>;
+  auto compare = [](const ReadyComponent& left, const ReadyComponent& right) {
+    return left.first < right.first ||
+        (left.first == right.first && left.second > right.second);
+  };
+  std::priority_queue<
+      ReadyComponent,
+      std::vector<ReadyComponent>,
+      decltype(compare)>
+      ready_components(compare);
+  auto dependencies_size = [&](std::size_t index) {
+    std::size_t size = 0;
+    for (const auto* method : components[index]) {
+      size += dependencies.dependencies(method).size();
+    }
+    return size;
+  };
+
+  std::vector<std::size_t> pending_callee_components = callee_components_size_;
+  for (std::size_t index = 0; index < components.size(); index++) {
+    if (pending_callee_components[index] == 0) {
+      ready_components.emplace(dependencies_size(index), index);
+    }
+  }
+  component_priority_.resize(components.size());
+  while (!ready_components.empty()) {
+    auto index = ready_components.top().second;
+    ready_components.pop();
+    component_priority_[index] = ordered_components_.size();
+    ordered_components_.push_back(index);
+    for (auto dependent_component : dependent_components_[index]) {
+      if (--pending_callee_components[dependent_component] == 0) {
+        ready_components.emplace(
+            dependencies_size(dependent_component), dependent_component);
+      }
+    }
+  }
+  mt_assert(ordered_components_.size() == components.size());
+}
 
 void Scheduler::schedule(
-    const ConcurrentSet<const Method*>& methods,
+    const ConcurrentMethodSet& methods,
     std::function<void(const Method*, std::size_t)> enqueue,
     unsigned int threads) const {
-  // Schedule components by their reverse topological order (leaves to roots) in
-  // the set of strongly connected components.
-  std::size_t current_thread = 0;
-  for (const auto& component : strongly_connected_components_.components()) {
-    bool next_thread = false;
-    // Schedule all methods in this component on the same thread.
+  const auto& components = strongly_connected_components_.components();
+  bool use_analysis_times = analysis_times_.size() > 0;
+
+  // Compute the cost of each component containing methods to analyze.
+  std::vector<std::pair<double, std::size_t>> component_costs;
+  std::vector<std::size_t> component_sizes;
+  double total_cost = 0.0;
+  for (std::size_t index = 0; index < components.size(); index++) {
+    std::size_t scheduled = 0;
+    double component_cost = 0.0;
+    for (const auto* method : components[index]) {
+      if (methods.contains(method)) {
+        scheduled++;
+        component_cost += cost(method, use_analysis_times);
+      }
+    }
+    if (scheduled > 0) {
+      component_costs.emplace_back(component_cost, index);
+      component_sizes.push_back(scheduled);
+      total_cost += component_cost;
+    }
+  }
+
+  // Large components would leave a single thread analyzing them while the
+  // others are idle, hence their methods are assigned individually. Methods
+  // of other components are kept on the same thread.
+  struct Task {
+    double cost;
+    std::size_t index;
+    const Method* MT_NULLABLE method;
+  };
+  std::vector<Task> tasks;
+  tasks.reserve(component_costs.size());
+  for (std::size_t i = 0; i < component_costs.size(); i++) {
+    auto [component_cost, index] = component_costs[i];
+    if (!is_large(component_cost, component_sizes[i], total_cost, threads)) {
+      tasks.push_back(Task{component_cost, index, nullptr});
+      continue;
+    }
+    for (const auto* method : components[index]) {
+      if (methods.contains(method)) {
+        tasks.push_back(Task{cost(method, use_analysis_times), index, method});
+      }
+    }
+  }
+
+  // Assign the most expensive tasks first, each to the least loaded thread
+  // (longest-processing-time-first). Ties are broken by index and by order in
+  // the component to keep the assignment deterministic.
+  std::stable_sort(
+      tasks.begin(), tasks.end(), [](const Task& left, const Task& right) {
+        return left.cost > right.cost ||
+            (left.cost == right.cost && left.index < right.index);
+      });
+  using ThreadLoad = std::pair<double, std::size_t>;
+  std::priority_queue<ThreadLoad, std::vector<ThreadLoad>, std::greater<>>
+      thread_loads;
+  for (std::size_t thread = 0; thread < threads; thread++) {
+    thread_loads.emplace(0.0, thread);
+  }
+  std::unordered_map<std::size_t, std::size_t> component_thread;
+  std::unordered_map<const Method*, std::size_t> method_thread;
+  for (const auto& task : tasks) {
+    auto [load, thread] = thread_loads.top();
+    thread_loads.pop();
+    component_thread.emplace(task.index, thread);
+    if (task.method != nullptr) {
+      method_thread.emplace(task.method, thread);
+    }
+    thread_loads.emplace(load + task.cost, thread);
+  }
+
+  // Schedule components by priority, which follows the reverse topological
+  // order (leaves to roots) in the set of strongly connected components.
+  for (auto index : ordered_components_) {
+    auto found = component_thread.find(index);
+    if (found == component_thread.end()) {
+      continue;
+    }
+    const auto& component = components[index];
+    // Schedule all methods in this component on the same thread, unless they
+    // were assigned individually.
     // Iterating on the reverse order here seems to give callees before callers
     // more often, even though this is not guaranteed by Tarjan's algorithm.
     for (auto iterator = component.rbegin(), end = component.rend();
          iterator != end;
          ++iterator) {
       const auto* method = *iterator;
-      if (methods.count_unsafe(method) > 0) {
-        next_thread = true;
-        enqueue(method, current_thread);
+      if (!methods.contains(method)) {
+        continue;
       }
+      auto assigned = method_thread.find(method);
+      enqueue(
+          method,
+          assigned != method_thread.end() ? assigned->second : found->second);
     }
-    if (next_thread) {
-      current_thread = (current_thread + 1) % threads;
+  }
+}
+
+std::size_t Scheduler::components_size() const {
+  return strongly_connected_components_.components().size();
+}
+
+const std::vector<const Method*>& Scheduler::component(
+    std::size_t component) const {
+  return strongly_connected_components_.components().at(component);
+}
+
+const std::vector<std::size_t>& Scheduler::dependent_components(
+    std::size_t component) const {
+  return dependent_components_.at(component);
+}
+
+std::size_t Scheduler::callee_components_size(std::size_t component) const {
+  return callee_components_size_.at(component);
+}
+
+double Scheduler::component_cost(std::size_t component) const {
+  double result = 0.0;
+  for (const auto* method : this->component(component)) {
+    result += cost(method, /* use_analysis_times */ false);
+  }
+  return result;
+}
+
+bool Scheduler::is_large_component(
+    std::size_t component,
+    unsigned int threads) const {
+  return is_large(
+      component_cost(component),
+      this->component(component).size(),
+      total_cost_,
+      threads);
+}
+
+std::size_t Scheduler::component_of(const Method* method) const {
+  return method_to_component_.at(method);
+}
+
+std::size_t Scheduler::priority(const Method* method) const {
+  return component_priority_.at(component_of(method));
+}
+
+void Scheduler::sort_by_priority(std::vector<const Method*>& methods) const {
+  std::stable_sort(
+      methods.begin(),
+      methods.end(),
+      [this](const Method* left, const Method* right) {
+        return priority(left) < priority(right);
+      });
+}
+
+void Scheduler::log_analysis_time(
+    const Method* method,
+    double duration_in_seconds) {
+  analysis_times_.insert_or_assign(std::make_pair(method, duration_in_seconds));
+}
+
+void Scheduler::seed_analysis_times(
+    const std::unordered_map<const Method*, double>& analysis_times) {
+  double time = 0.0;
+  double instructions = 0.0;
+  for (const auto& [method, duration_in_seconds] : analysis_times) {
+    analysis_times_.insert_or_assign(
+        std::make_pair(method, duration_in_seconds));
+    time += duration_in_seconds;
+    instructions += cost(method, /* use_analysis_times */ false);
+  }
+  if (instructions > 0.0) {
+    seconds_per_instruction_ = time / instructions;
+  }
+}
+
+double Scheduler::cost(const Method* method, bool use_analysis_times) const {
+  if (use_analysis_times) {
+    auto time = analysis_times_.get(method, /* default */ -1.0);
+    if (time >= 0.0) {
+      return time;
     }
+    // Not analyzed yet, which only happens for seeded times.
+    return seconds_per_instruction_ *
+        cost(method, /* use_analysis_times */ false);
+  }
+
+  const auto* code = method->get_code();
+  if (code == nullptr || !code->cfg_built()) {
+    return 1.0;
   }
+  return static_cast<double>(code->cfg().num_opcodes());
 }
 
 } // namespace marianatrench
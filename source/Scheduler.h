@@ -8,9 +8,12 @@
 #pragma once
 
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 #include <ConcurrentContainers.h>
 
+#include <mariana-trench/ConcurrentMethodSet.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
@@ -24,14 +27,88 @@ class Scheduler final {
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Scheduler)
 
-  /* Add methods to analyze in the work queue, in a specific order. */
+  /**
+   * Add methods to analyze in the work queue, in a specific order.
+   *
+   * Components are assigned to threads using the longest-processing-time-first
+   * rule, based on the analysis time of the previous iteration or on the number
+   * of instructions if no analysis time is known. Methods of large components
+   * (see `is_large_component`) are assigned to threads individually.
+   */
   void schedule(
-      const ConcurrentSet<const Method*>& methods,
+      const ConcurrentMethodSet& methods,
       std::function<void(const Method*, std::size_t)> enqueue,
       unsigned int threads) const;
 
+  /**
+   * Graph of strongly connected components, used to iterate each component to
+   * its local fixpoint before its callers.
+   *
+   * Components are identified by their index in reverse topological order,
+   * i.e callee components have a lower index than their caller components.
+   */
+  std::size_t components_size() const;
+  const std::vector<const Method*>& component(std::size_t component) const;
+
+  /* Return the components containing callers of the given component. */
+  const std::vector<std::size_t>& dependent_components(
+      std::size_t component) const;
+
+  /* Return the number of components containing callees of the given one. */
+  std::size_t callee_components_size(std::size_t component) const;
+
+  /* Return the component of the given method. */
+  std::size_t component_of(const Method* method) const;
+
+  /* Return the number of instructions of the given component. */
+  double component_cost(std::size_t component) const;
+
+  /**
+   * Return whether the given component is too large to be analyzed by a single
+   * thread among `threads`, based on its share of the instructions of all
+   * components. The methods of such components are analyzed in parallel.
+   */
+  bool is_large_component(std::size_t component, unsigned int threads) const;
+
+  /**
+   * Return the analysis priority of the given method, lower is analyzed first.
+   *
+   * Components are prioritized in topological order (callees first), and
+   * independent components are ordered by decreasing number of dependencies,
+   * so that widely called methods converge before their callers.
+   */
+  std::size_t priority(const Method* method) const;
+
+  /* Sort the given methods by increasing priority. */
+  void sort_by_priority(std::vector<const Method*>& methods) const;
+
+  /* Record the time it took to analyze the given method. This is thread-safe. */
+  void log_analysis_time(const Method* method, double duration_in_seconds);
+
+  /**
+   * Use the analysis times of a previous run as if they were logged, so that
+   * the first iteration is scheduled by analysis time. Methods without a time
+   * are estimated from their number of instructions, using the average time
+   * per instruction of the given methods.
+   */
+  void seed_analysis_times(
+      const std::unordered_map<const Method*, double>& analysis_times);
+
+ private:
+  double cost(const Method* method, bool use_analysis_times) const;
+
  private:
   StronglyConnectedComponents strongly_connected_components_;
+  std::unordered_map<const Method*, std::size_t> method_to_component_;
+  std::vector<std::vector<std::size_t>> dependent_components_;
+  std::vector<std::size_t> callee_components_size_;
+  // Components in the order they should be analyzed.
+  std::vector<std::size_t> ordered_components_;
+  // Position of each component in `ordered_components_`.
+  std::vector<std::size_t> component_priority_;
+  ConcurrentMap<const Method*, double> analysis_times_;
+  double total_cost_;
+  double seconds_per_instruction_;
 };
 
 } // namespace marianatrench
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/Checkpoint.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Shard.h>
+
+namespace marianatrench {
+
+Shard::Shard(
+    const Scheduler& scheduler,
+    std::size_t shards,
+    std::optional<std::size_t> index,
+    std::filesystem::path directory)
+    : scheduler_(scheduler),
+      partitions_(scheduler, shards),
+      index_(index),
+      directory_(std::move(directory)) {
+  mt_assert(!index_ || *index_ < shards);
+}
+
+bool Shard::merging() const {
+  return !index_.has_value();
+}
+
+bool Shard::analyzes(const Method* method) const {
+  return !index_ || partitions_.partition_of(method) == *index_;
+}
+
+std::size_t Shard::load_boundaries(Context& context, Registry& registry)
+    const {
+  mt_assert(index_);
+  std::size_t loaded = 0;
+  for (std::size_t index = 0; index < partitions_.size(); index++) {
+    auto path = boundary_path(index);
+    if (index == *index_ || !std::filesystem::exists(path)) {
+      continue;
+    }
+    for (const auto& model : Checkpoint::load_models(path, context)) {
+      if (partitions_.partition_of(model.method()) != index) {
+        throw std::invalid_argument(fmt::format(
+            "Boundary `{}` holds the model of `{}` from another shard.",
+            path.native(),
+            model.method()->show()));
+      }
+      registry.join_with(model);
+      loaded++;
+    }
+  }
+  LOG(1, "Loaded {} boundary models of other shards.", loaded);
+  return loaded;
+}
+
+bool Shard::store(Context& context, const Registry& registry) const {
+  mt_assert(index_);
+  std::vector<const Method*> methods;
+  std::vector<const Method*> boundary_methods;
+  for (const auto* method : *context.methods) {
+    if (!analyzes(method)) {
+      continue;
+    }
+    methods.push_back(method);
+    if (partitions_.is_exported(scheduler_.component_of(method))) {
+      boundary_methods.push_back(method);
+    }
+  }
+  Checkpoint::store_models(models_path(*index_), methods, context, registry);
+
+  // Positions are numbered in no particular order, hence models are compared
+  // rather than files.
+  auto path = boundary_path(*index_);
+  bool changed = true;
+  if (std::filesystem::exists(path)) {
+    auto previous_models = Checkpoint::load_models(path, context);
+    changed = previous_models.size() != boundary_methods.size();
+    for (const auto& previous_model : previous_models) {
+      if (changed) {
+        break;
+      }
+      const auto model = registry.get_snapshot(previous_model.method());
+      changed = previous_model != *model;
+    }
+  }
+  if (changed) {
+    Checkpoint::store_models(path, boundary_methods, context, registry);
+  }
+
+  LOG(1,
+      "Wrote {} models of shard {}, the {} boundary models {}.",
+      methods.size(),
+      *index_,
+      boundary_methods.size(),
+      changed ? "changed" : "are unchanged");
+  return changed;
+}
+
+void Shard::merge(Context& context, Registry& registry) const {
+  mt_assert(!index_);
+  for (std::size_t index = 0; index < partitions_.size(); index++) {
+    auto path = models_path(index);
+    if (!std::filesystem::exists(path)) {
+      throw std::invalid_argument(fmt::format(
+          "Models of shard {} not found in `{}`.", index, path.native()));
+    }
+    auto models = Checkpoint::load_models(path, context);
+    for (const auto& model : models) {
+      registry.join_with(model);
+    }
+    LOG(1, "Joined {} models of shard {}.", models.size(), index);
+  }
+}
+
+std::filesystem::path Shard::models_path(std::size_t index) const {
+  return directory_ / fmt::format("models_{}.json", index);
+}
+
+std::filesystem::path Shard::boundary_path(std::size_t index) const {
+  return directory_ / fmt::format("boundary_{}.json", index);
+}
+
+} // namespace marianatrench
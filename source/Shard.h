@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Partitions.h>
+#include <mariana-trench/Registry.h>
+#include <mariana-trench/Scheduler.h>
+
+namespace marianatrench {
+
+/**
+ * Shard of a multi-process analysis, with `--shards`.
+ *
+ * Components are assigned to shards by `Partitions`, which every process
+ * computes independently. A shard process only analyzes the methods of its
+ * partition: the models of other methods are their initial models, joined
+ * with the boundary models written by the other shards in the previous round.
+ *
+ * Shards are run in rounds, on one or several hosts sharing the shard
+ * directory:
+ * - each shard writes the models of its methods in `models_<index>.json`,
+ *   and the models of its methods with callers in other shards in
+ *   `boundary_<index>.json`. The boundary file is only rewritten when these
+ *   models changed since the previous round;
+ * - once no boundary file changed in a round, a process with `--merge-shards`
+ *   joins the models of all shards and writes the results instead of
+ *   analyzing the program.
+ *
+ * Since callers are kept with their callees, most boundary models converge in
+ * a couple of rounds. Files use the lossless format of `Checkpoint`.
+ */
+class Shard final {
+ public:
+  /* `index` is `std::nullopt` when merging the shards. */
+  explicit Shard(
+      const Scheduler& scheduler,
+      std::size_t shards,
+      std::optional<std::size_t> index,
+      std::filesystem::path directory);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Shard)
+
+  bool merging() const;
+
+  /* Whether the method is analyzed by this process. */
+  bool analyzes(const Method* method) const;
+
+  /* Join the boundary models of the other shards. Return their number. */
+  std::size_t load_boundaries(Context& context, Registry& registry) const;
+
+  /* Write the models of this shard. Return whether its boundary changed. */
+  bool store(Context& context, const Registry& registry) const;
+
+  /* Join the models of all shards. */
+  void merge(Context& context, Registry& registry) const;
+
+  std::filesystem::path models_path(std::size_t index) const;
+  std::filesystem::path boundary_path(std::size_t index) const;
+
+ private:
+  const Scheduler& scheduler_;
+  Partitions partitions_;
+  std::optional<std::size_t> index_;
+  std::filesystem::path directory_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include <sparta/HashedAbstractPartition.h>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * A hashed abstract partition that stores a single binding inline.
+ *
+ * Most partitions hold exactly one binding, e.g the frames of a kind are
+ * usually all in the default class interval context. This avoids the
+ * allocation of a hash table until a second label is bound.
+ *
+ * Invariant: the inline binding is used if and only if the partition has at
+ * most one binding, in which case `partition_` is bottom. The inline binding
+ * is absent when `domain_` is bottom.
+ *
+ * The top element is not supported.
+ */
+template <typename Label, typename Domain>
+class SmallHashedAbstractPartition final {
+ private:
+  using Partition = sparta::HashedAbstractPartition<Label, Domain>;
+
+ public:
+  /* Create the bottom (i.e, empty) partition. */
+  SmallHashedAbstractPartition()
+      : label_(), domain_(Domain::bottom()), partition_(Partition::bottom()) {}
+
+  INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(
+      SmallHashedAbstractPartition)
+
+  static SmallHashedAbstractPartition bottom() {
+    return SmallHashedAbstractPartition();
+  }
+
+  bool is_bottom() const {
+    return is_small() && domain_.is_bottom();
+  }
+
+  bool is_top() const {
+    return false;
+  }
+
+  void set_to_bottom() {
+    domain_.set_to_bottom();
+    partition_.set_to_bottom();
+  }
+
+  std::size_t size() const {
+    if (is_small()) {
+      return domain_.is_bottom() ? 0 : 1;
+    } else {
+      return partition_.size();
+    }
+  }
+
+  /* Return the binding of the given label, or bottom. */
+  const Domain& get(const Label& label) const {
+    if (is_small()) {
+      if (!domain_.is_bottom() && label_ == label) {
+        return domain_;
+      }
+      static const Domain bottom = Domain::bottom();
+      return bottom;
+    } else {
+      return partition_.get(label);
+    }
+  }
+
+  bool leq(const SmallHashedAbstractPartition& other) const {
+    if (is_small()) {
+      return domain_.is_bottom() || domain_.leq(other.get(label_));
+    } else if (other.is_small()) {
+      // This partition has at least two non-bottom bindings.
+      return false;
+    } else {
+      return partition_.leq(other.partition_);
+    }
+  }
+
+  bool equals(const SmallHashedAbstractPartition& other) const {
+    if (is_small() != other.is_small()) {
+      return false;
+    } else if (is_small()) {
+      if (domain_.is_bottom() || other.domain_.is_bottom()) {
+        return domain_.is_bottom() && other.domain_.is_bottom();
+      }
+      return label_ == other.label_ && domain_.equals(other.domain_);
+    } else {
+      return partition_.equals(other.partition_);
+    }
+  }
+
+  void join_with(const SmallHashedAbstractPartition& other) {
+    if (other.is_bottom()) {
+      return;
+    } else if (is_bottom()) {
+      *this = other;
+    } else if (is_small() && other.is_small() && label_ == other.label_) {
+      domain_.join_with(other.domain_);
+    } else {
+      promote();
+      if (other.is_small()) {
+        partition_.update(other.label_, [&other](Domain* domain) {
+          domain->join_with(other.domain_);
+        });
+      } else {
+        partition_.join_with(other.partition_);
+      }
+    }
+  }
+
+  void widen_with(const SmallHashedAbstractPartition& other) {
+    if (other.is_bottom()) {
+      return;
+    } else if (is_bottom()) {
+      *this = other;
+    } else if (is_small() && other.is_small() && label_ == other.label_) {
+      domain_.widen_with(other.domain_);
+    } else {
+      promote();
+      if (other.is_small()) {
+        partition_.update(other.label_, [&other](Domain* domain) {
+          domain->widen_with(other.domain_);
+        });
+      } else {
+        partition_.widen_with(other.partition_);
+      }
+    }
+  }
+
+  void meet_with(const SmallHashedAbstractPartition& other) {
+    if (is_small()) {
+      if (!domain_.is_bottom()) {
+        domain_.meet_with(other.get(label_));
+      }
+    } else {
+      partition_.meet_with(other.to_partition());
+      demote();
+    }
+  }
+
+  void narrow_with(const SmallHashedAbstractPartition& other) {
+    if (is_small()) {
+      if (!domain_.is_bottom()) {
+        domain_.narrow_with(other.get(label_));
+      }
+    } else {
+      partition_.narrow_with(other.to_partition());
+      demote();
+    }
+  }
+
+  template <typename Operation> // void(Domain*)
+  void update(const Label& label, Operation&& operation) {
+    if (is_small()) {
+      if (domain_.is_bottom()) {
+        label_ = label;
+        operation(&domain_);
+        return;
+      } else if (label_ == label) {
+        operation(&domain_);
+        return;
+      }
+      promote();
+    }
+
+    partition_.update(label, std::forward<Operation>(operation));
+    demote();
+  }
+
+  template <typename Function> // void(Domain*)
+  void transform(Function&& function) {
+    if (is_small()) {
+      if (!domain_.is_bottom()) {
+        function(&domain_);
+      }
+    } else {
+      partition_.transform(std::forward<Function>(function));
+      demote();
+    }
+  }
+
+  template <typename Visitor> // void(const Label&, const Domain&)
+  void visit(Visitor&& visitor) const {
+    static_assert(std::is_void_v<decltype(visitor(
+                      std::declval<const Label&>(),
+                      std::declval<const Domain&>()))>);
+
+    if (is_small()) {
+      if (!domain_.is_bottom()) {
+        visitor(label_, domain_);
+      }
+    } else {
+      for (const auto& [label, domain] : partition_.bindings()) {
+        visitor(label, domain);
+      }
+    }
+  }
+
+  /* Apply `operation` on bindings that also exist in `other`. */
+  template <typename Operation> // void(Domain*, const Domain&)
+  void difference_like_operation(
+      const SmallHashedAbstractPartition& other,
+      Operation&& operation) {
+    if (is_small()) {
+      if (!domain_.is_bottom()) {
+        const auto& other_domain = other.get(label_);
+        if (!other_domain.is_bottom()) {
+          operation(&domain_, other_domain);
+        }
+      }
+    } else if (other.is_small()) {
+      if (!other.domain_.is_bottom()) {
+        partition_.update(
+            other.label_, [&operation, &other](Domain* domain) -> void {
+              if (!domain->is_bottom()) {
+                operation(domain, other.domain_);
+              }
+            });
+        demote();
+      }
+    } else {
+      partition_.difference_like_operation(
+          other.partition_, std::forward<Operation>(operation));
+      demote();
+    }
+  }
+
+ private:
+  bool is_small() const {
+    return partition_.is_bottom();
+  }
+
+  /* Move the inline binding, if any, into the hash table. */
+  void promote() {
+    if (is_small() && !domain_.is_bottom()) {
+      partition_.set(label_, std::move(domain_));
+      domain_.set_to_bottom();
+    }
+  }
+
+  /* Move the binding back inline if there is at most one left. */
+  void demote() {
+    if (is_small() || partition_.size() > 1) {
+      return;
+    }
+
+    const auto& [label, domain] = *partition_.bindings().begin();
+    label_ = label;
+    domain_ = domain;
+    partition_.set_to_bottom();
+  }
+
+  Partition to_partition() const {
+    if (!is_small()) {
+      return partition_;
+    }
+
+    auto partition = Partition::bottom();
+    if (!domain_.is_bottom()) {
+      partition.set(label_, domain_);
+    }
+    return partition;
+  }
+
+ private:
+  Label label_;
+  Domain domain_;
+  Partition partition_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+#include <mariana-trench/Log.h>
+#include <mariana-trench/SourceIndexCache.h>
+
+namespace marianatrench {
+
+namespace {
+
+// Bump this whenever the class declarations scan or the format changes.
+constexpr int k_version = 1;
+
+bool parse_integer(std::string_view& line, std::int64_t& value) {
+  auto result = std::from_chars(line.data(), line.data() + line.size(), value);
+  if (result.ec != std::errc() || result.ptr == line.data() + line.size() ||
+      *result.ptr != ' ') {
+    return false;
+  }
+  line.remove_prefix(result.ptr - line.data() + 1);
+  return true;
+}
+
+} // namespace
+
+SourceIndexCache::SourceIndexCache(
+    const std::filesystem::path& cache_directory,
+    const std::string& source_root_directory)
+    : path_(cache_directory / "source_index.txt"),
+      source_root_directory_(source_root_directory) {
+  std::ifstream file(path_, std::ios_base::binary);
+  if (!file.is_open()) {
+    LOG(2, "No cached source index in `{}`.", path_.native());
+    return;
+  }
+
+  // The file is made of a header with the version and the source root
+  // directory, followed by `<size> <modification time> <classes> <path>` lines,
+  // each followed by the given number of class lines.
+  std::string line;
+  if (!std::getline(file, line) || line != std::to_string(k_version) ||
+      !std::getline(file, line) || line != source_root_directory_) {
+    LOG(2, "Cached source index is outdated, ignoring it.");
+    return;
+  }
+
+  while (std::getline(file, line)) {
+    auto view = std::string_view(line);
+    std::int64_t size = 0;
+    std::int64_t modification_time = 0;
+    std::int64_t number_classes = 0;
+    if (!parse_integer(view, size) ||
+        !parse_integer(view, modification_time) ||
+        !parse_integer(view, number_classes) || size < 0 ||
+        number_classes < 0) {
+      WARNING(
+          1, "Invalid cached source index `{}`, ignoring it.", path_.native());
+      previous_entries_.clear();
+      return;
+    }
+
+    Entry entry{
+        static_cast<std::uintmax_t>(size),
+        modification_time,
+        /* classes */ {}};
+    std::string path(view);
+    for (std::int64_t i = 0; i < number_classes; i++) {
+      if (!std::getline(file, line)) {
+        WARNING(
+            1,
+            "Invalid cached source index `{}`, ignoring it.",
+            path_.native());
+        previous_entries_.clear();
+        return;
+      }
+      entry.classes.push_back(line);
+    }
+    previous_entries_.insert_or_assign(std::move(path), std::move(entry));
+  }
+
+  LOG(2,
+      "Loaded the cached source index of {} files.",
+      previous_entries_.size());
+}
+
+std::optional<SourceIndexCache::Entry> SourceIndexCache::stat(
+    const std::string& path) const {
+  auto file_path = std::filesystem::path(source_root_directory_) / path;
+  std::error_code error;
+  auto size = std::filesystem::file_size(file_path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  auto modification_time = std::filesystem::last_write_time(file_path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  return Entry{
+      size,
+      static_cast<std::int64_t>(
+          modification_time.time_since_epoch().count()),
+      /* classes */ {}};
+}
+
+std::optional<std::vector<std::string>> SourceIndexCache::get(
+    const std::string& path) {
+  auto found = previous_entries_.find(path);
+  if (found == previous_entries_.end()) {
+    return std::nullopt;
+  }
+
+  auto entry = stat(path);
+  if (!entry || entry->size != found->second.size ||
+      entry->modification_time != found->second.modification_time) {
+    return std::nullopt;
+  }
+
+  hits_++;
+  entries_.emplace(path, found->second);
+  return found->second.classes;
+}
+
+void SourceIndexCache::set(
+    const std::string& path,
+    std::vector<std::string> classes) {
+  auto entry = stat(path);
+  if (!entry) {
+    return;
+  }
+  entry->classes = std::move(classes);
+  entries_.emplace(path, std::move(*entry));
+}
+
+void SourceIndexCache::store() const {
+  std::filesystem::create_directories(path_.parent_path());
+
+  // Write to a temporary file first, so that a concurrent or interrupted run
+  // never leaves a truncated cache.
+  auto temporary_path = path_;
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios_base::binary);
+    if (!file.is_open()) {
+      WARNING(
+          1,
+          "Unable to write the source index cache to `{}`.",
+          path_.native());
+      return;
+    }
+    file << k_version << '\n' << source_root_directory_ << '\n';
+    for (const auto& [path, entry] : entries_) {
+      file << entry.size << ' ' << entry.modification_time << ' '
+           << entry.classes.size() << ' ' << path << '\n';
+      for (const auto& class_name : entry.classes) {
+        file << class_name << '\n';
+      }
+    }
+  }
+  std::filesystem::rename(temporary_path, path_);
+
+  LOG(2, "Stored the source index of {} files.", entries_.size());
+}
+
+} // namespace marianatrench
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Cache of the top-level classes declared in each source file, across runs.
+ *
+ * Scanning every java and kotlin file dominates the cost of the source index,
+ * while only a few files change between runs. Entries are keyed by the path of
+ * the file and only reused when its size and modification time are unchanged.
+ */
+class SourceIndexCache final {
+ public:
+  /**
+   * Read the cache of the given source root directory, if any. An invalid or
+   * outdated cache is ignored.
+   */
+  SourceIndexCache(
+      const std::filesystem::path& cache_directory,
+      const std::string& source_root_directory);
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(SourceIndexCache)
+
+  /**
+   * Return the cached classes of the given file, or `std::nullopt` if the file
+   * changed. Either way, the file is kept in the next cache.
+   * This is thread-safe.
+   */
+  std::optional<std::vector<std::string>> get(const std::string& path);
+
+  /* This is thread-safe. */
+  void set(const std::string& path, std::vector<std::string> classes);
+
+  /* Write the entries of all files seen in this run. */
+  void store() const;
+
+  std::size_t hits() const {
+    return hits_;
+  }
+
+ private:
+  struct Entry {
+    std::uintmax_t size = 0;
+    std::int64_t modification_time = 0;
+    std::vector<std::string> classes;
+  };
+
+  /* Paths are relative to the source root directory, unless absolute. */
+  std::optional<Entry> stat(const std::string& path) const;
+
+ private:
+  std::filesystem::path path_;
+  std::string source_root_directory_;
+  std::unordered_map<std::string, Entry> previous_entries_;
+  ConcurrentMap<std::string, Entry> entries_;
+  std::atomic<std::size_t> hits_{0};
+};
+
+} // namespace marianatrench
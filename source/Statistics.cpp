@@ -6,15 +6,30 @@
  */
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include <fmt/format.h>
 
 #include <sparta/WorkQueue.h>
 
 #include <Show.h>
 
+#include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Statistics.h>
 
 namespace marianatrench {
 
+namespace {
+
+// Epochs of all statistics, so that the per-thread cache of an instance is
+// never mistaken for the one of another instance.
+std::atomic<std::uint64_t> next_epoch(1);
+
+} // namespace
+
+Statistics::Statistics() : epoch_(next_epoch++) {}
+
 void Statistics::log_number_iterations(std::size_t number_iterations) {
   std::lock_guard<std::mutex> lock(mutex_);
   number_iterations_ = number_iterations;
@@ -23,45 +38,196 @@ void Statistics::log_number_iterations(std::size_t number_iterations) {
 void Statistics::log_resident_set_size(double resident_set_size) {
   std::lock_guard<std::mutex> lock(mutex_);
   max_resident_set_size_ = std::max(max_resident_set_size_, resident_set_size);
+  if (trace_enabled_) {
+    trace_resident_set_sizes_.emplace_back(
+        std::chrono::steady_clock::now(), resident_set_size);
+  }
 }
 
 void Statistics::log_time(const std::string& name, const Timer& timer) {
   std::lock_guard<std::mutex> lock(mutex_);
   times_[name] = timer.duration_in_seconds();
+  add_trace_span(name, timer);
+  if (CacheStatistics::enabled()) {
+    auto counters = CacheStatistics::snapshot();
+    cache_statistics_.emplace_back(
+        name,
+        CacheStatistics::difference(counters, cache_counters_at_last_phase_));
+    cache_counters_at_last_phase_ = counters;
+  }
 }
 
 void Statistics::log_time(const Method* method, const Timer& timer) {
   double duration_in_seconds = timer.duration_in_seconds();
+  auto end = std::chrono::steady_clock::now();
+
+  auto& statistics = thread_statistics();
+  statistics.iteration.methods_analyzed++;
+  auto bucket = std::upper_bound(
+                    kAnalysisTimeBuckets.begin(),
+                    kAnalysisTimeBuckets.end(),
+                    duration_in_seconds) -
+      kAnalysisTimeBuckets.begin();
+  statistics.iteration.analysis_time_histogram[bucket]++;
+
+  if (trace_enabled_) {
+    auto& activity = statistics.trace_activity;
+    if (activity && timer.start() - activity->end <= kTraceActivityGap) {
+      activity->end = end;
+    } else {
+      if (activity) {
+        statistics.trace_spans.push_back(std::move(*activity));
+      }
+      activity = TraceSpan{"analyzing", statistics.thread, timer.start(), end};
+    }
+  }
+
+  add_slow_method(
+      statistics.slowest_methods,
+      SlowMethod{
+          method, duration_in_seconds, statistics.thread, timer.start()});
+}
+
+void Statistics::log_model_changed() {
+  thread_statistics().iteration.models_changed++;
+}
+
+void Statistics::log_dependents_enqueued(std::size_t dependents) {
+  thread_statistics().iteration.dependents_enqueued += dependents;
+}
+
+void Statistics::end_iteration() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  IterationStatistics iteration;
+  for (auto& [_, statistics] : thread_statistics_) {
+    iteration.join_with(statistics->iteration);
+    for (const auto& record : statistics->slowest_methods) {
+      add_slow_method(slowest_methods_, record);
+    }
+    if (statistics->trace_activity) {
+      statistics->trace_spans.push_back(std::move(*statistics->trace_activity));
+    }
+    trace_spans_.insert(
+        trace_spans_.end(),
+        std::make_move_iterator(statistics->trace_spans.begin()),
+        std::make_move_iterator(statistics->trace_spans.end()));
+  }
+  // Invalidate the cached entries before freeing them.
+  epoch_ = next_epoch++;
+  thread_statistics_.clear();
+  iterations_.push_back(iteration);
+}
+
+Statistics::ThreadStatistics& Statistics::thread_statistics() {
+  struct Cache {
+    std::uint64_t epoch = 0;
+    ThreadStatistics* statistics = nullptr;
+  };
+  thread_local Cache cache;
+
+  auto epoch = epoch_.load();
+  if (cache.epoch == epoch) {
+    return *cache.statistics;
+  }
 
   std::lock_guard<std::mutex> lock(mutex_);
+  auto& statistics = thread_statistics_[std::this_thread::get_id()];
+  if (statistics == nullptr) {
+    statistics = std::make_unique<ThreadStatistics>();
+    statistics->thread = trace_thread();
+  }
+  cache = Cache{epoch, statistics.get()};
+  return *statistics;
+}
 
-  if (slowest_methods_.size() >= Statistics::kRecordSlowestMethods &&
-      slowest_methods_.back().second > duration_in_seconds) {
+void Statistics::add_slow_method(
+    std::vector<SlowMethod>& slowest_methods,
+    const SlowMethod& record) {
+  if (slowest_methods.size() >= Statistics::kRecordSlowestMethods &&
+      slowest_methods.back().duration_in_seconds > record.duration_in_seconds) {
     return;
   }
 
   auto found = std::find_if(
-      slowest_methods_.begin(),
-      slowest_methods_.end(),
-      [=](const auto& record) { return record.first == method; });
-  if (found != slowest_methods_.end()) {
-    slowest_methods_.erase(found);
-  } else if (slowest_methods_.size() >= Statistics::kRecordSlowestMethods) {
-    slowest_methods_.pop_back();
+      slowest_methods.begin(),
+      slowest_methods.end(),
+      [&](const auto& slow_method) {
+        return slow_method.method == record.method;
+      });
+  if (found != slowest_methods.end()) {
+    if (found->duration_in_seconds >= record.duration_in_seconds) {
+      return;
+    }
+    slowest_methods.erase(found);
+  } else if (slowest_methods.size() >= Statistics::kRecordSlowestMethods) {
+    slowest_methods.pop_back();
   }
 
-  auto record = std::make_pair(method, duration_in_seconds);
-  slowest_methods_.insert(
+  slowest_methods.insert(
       std::upper_bound(
-          slowest_methods_.begin(),
-          slowest_methods_.end(),
+          slowest_methods.begin(),
+          slowest_methods.end(),
           record,
           [](const auto& left, const auto& right) {
-            return left.second > right.second;
+            return left.duration_in_seconds > right.duration_in_seconds;
           }),
       record);
 }
 
+void Statistics::IterationStatistics::join_with(
+    const IterationStatistics& other) {
+  methods_analyzed += other.methods_analyzed;
+  models_changed += other.models_changed;
+  dependents_enqueued += other.dependents_enqueued;
+  for (std::size_t bucket = 0; bucket < analysis_time_histogram.size();
+       bucket++) {
+    analysis_time_histogram[bucket] += other.analysis_time_histogram[bucket];
+  }
+}
+
+void Statistics::log_model_generator(ModelGeneratorProfile profile) {
+  std::sort(
+      profile.items.begin(),
+      profile.items.end(),
+      [](const auto& left, const auto& right) {
+        return left.time > right.time;
+      });
+  if (profile.items.size() > Statistics::kRecordSlowestModelGeneratorItems) {
+    profile.items.resize(Statistics::kRecordSlowestModelGeneratorItems);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  model_generators_.push_back(std::move(profile));
+}
+
+void Statistics::enable_trace() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trace_enabled_ = true;
+}
+
+void Statistics::log_trace_span(const std::string& name, const Timer& timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  add_trace_span(name, timer);
+}
+
+std::size_t Statistics::trace_thread() {
+  return trace_threads_
+      .try_emplace(std::this_thread::get_id(), trace_threads_.size())
+      .first->second;
+}
+
+void Statistics::add_trace_span(std::string name, const Timer& timer) {
+  if (!trace_enabled_) {
+    return;
+  }
+  trace_spans_.push_back(TraceSpan{
+      std::move(name),
+      trace_thread(),
+      timer.start(),
+      std::chrono::steady_clock::now()});
+}
+
 namespace {
 
 double round(double x, int digits) {
@@ -87,13 +253,147 @@ Json::Value Statistics::to_json() const {
   auto slowest_methods_value = Json::Value(Json::arrayValue);
   for (const auto& record : slowest_methods_) {
     auto slow_method_value = Json::Value(Json::arrayValue);
-    slow_method_value.append(Json::Value(show(record.first)));
-    slow_method_value.append(Json::Value(round(record.second, 3)));
+    slow_method_value.append(Json::Value(show(record.method)));
+    slow_method_value.append(Json::Value(round(record.duration_in_seconds, 3)));
     slowest_methods_value.append(slow_method_value);
   }
   value["slowest_methods"] = slowest_methods_value;
 
+  auto model_generators = model_generators_;
+  std::sort(
+      model_generators.begin(),
+      model_generators.end(),
+      [](const auto& left, const auto& right) {
+        return left.wall_time > right.wall_time;
+      });
+  auto model_generators_value = Json::Value(Json::arrayValue);
+  for (const auto& profile : model_generators) {
+    auto profile_value = Json::Value(Json::objectValue);
+    profile_value["name"] = Json::Value(profile.name);
+    profile_value["wall_time"] = Json::Value(round(profile.wall_time, 3));
+    profile_value["cpu_time"] = Json::Value(round(profile.cpu_time, 3));
+    profile_value["models"] =
+        Json::Value(static_cast<Json::UInt64>(profile.models));
+    profile_value["field_models"] =
+        Json::Value(static_cast<Json::UInt64>(profile.field_models));
+    auto items_value = Json::Value(Json::arrayValue);
+    for (const auto& item : profile.items) {
+      auto item_value = Json::Value(Json::objectValue);
+      item_value["name"] = Json::Value(item.name);
+      item_value["time"] = Json::Value(round(item.time, 3));
+      item_value["candidates"] =
+          Json::Value(static_cast<Json::UInt64>(item.candidates));
+      item_value["satisfy_evaluations"] =
+          Json::Value(static_cast<Json::UInt64>(item.satisfy_evaluations));
+      item_value["models"] =
+          Json::Value(static_cast<Json::UInt64>(item.models));
+      items_value.append(item_value);
+    }
+    profile_value["slowest_items"] = items_value;
+    model_generators_value.append(profile_value);
+  }
+  value["model_generators"] = model_generators_value;
+
+  auto buckets_value = Json::Value(Json::arrayValue);
+  for (auto bound : kAnalysisTimeBuckets) {
+    buckets_value.append(Json::Value(bound));
+  }
+  value["analysis_time_buckets"] = buckets_value;
+
+  auto iterations_value = Json::Value(Json::arrayValue);
+  for (const auto& iteration : iterations_) {
+    auto iteration_value = Json::Value(Json::objectValue);
+    iteration_value["methods_analyzed"] =
+        Json::Value(static_cast<Json::UInt64>(iteration.methods_analyzed));
+    iteration_value["models_changed"] =
+        Json::Value(static_cast<Json::UInt64>(iteration.models_changed));
+    iteration_value["dependents_enqueued"] =
+        Json::Value(static_cast<Json::UInt64>(iteration.dependents_enqueued));
+    auto histogram_value = Json::Value(Json::arrayValue);
+    for (auto count : iteration.analysis_time_histogram) {
+      histogram_value.append(Json::Value(static_cast<Json::UInt64>(count)));
+    }
+    iteration_value["analysis_time_histogram"] = histogram_value;
+    iterations_value.append(iteration_value);
+  }
+  value["fixpoint_iterations"] = iterations_value;
+
+  if (!cache_statistics_.empty()) {
+    auto cache_statistics_value = Json::Value(Json::objectValue);
+    for (const auto& [phase, counters] : cache_statistics_) {
+      cache_statistics_value[phase] = CacheStatistics::to_json(counters);
+    }
+    value["cache_statistics"] = cache_statistics_value;
+  }
+
   return value;
 }
 
+void Statistics::dump_trace(const std::filesystem::path& path) const {
+  // Timestamps are in microseconds since the statistics were created.
+  auto timestamp = [this](TimePoint time) {
+    return Json::Value(static_cast<Json::Int64>(std::max<std::int64_t>(
+        0,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            time - trace_start_)
+            .count())));
+  };
+  auto span_value = [&](const std::string& name,
+                        std::size_t thread,
+                        TimePoint begin,
+                        TimePoint end) {
+    auto value = Json::Value(Json::objectValue);
+    value["name"] = Json::Value(name);
+    value["ph"] = Json::Value("X");
+    value["pid"] = Json::Value(0);
+    value["tid"] = Json::Value(static_cast<Json::UInt64>(thread));
+    value["ts"] = timestamp(begin);
+    value["dur"] = Json::Value(static_cast<Json::Int64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+            .count()));
+    return value;
+  };
+
+  auto events = Json::Value(Json::arrayValue);
+  for (const auto& [_, thread] : trace_threads_) {
+    auto value = Json::Value(Json::objectValue);
+    value["name"] = Json::Value("thread_name");
+    value["ph"] = Json::Value("M");
+    value["pid"] = Json::Value(0);
+    value["tid"] = Json::Value(static_cast<Json::UInt64>(thread));
+    auto arguments = Json::Value(Json::objectValue);
+    arguments["name"] = Json::Value(fmt::format("thread {}", thread));
+    value["args"] = arguments;
+    events.append(value);
+  }
+  for (const auto& span : trace_spans_) {
+    events.append(span_value(span.name, span.thread, span.begin, span.end));
+  }
+  for (const auto& record : slowest_methods_) {
+    events.append(span_value(
+        show(record.method),
+        record.thread,
+        record.begin,
+        record.begin +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(record.duration_in_seconds))));
+  }
+  for (const auto& [time, resident_set_size] : trace_resident_set_sizes_) {
+    auto value = Json::Value(Json::objectValue);
+    value["name"] = Json::Value("rss");
+    value["ph"] = Json::Value("C");
+    value["pid"] = Json::Value(0);
+    value["ts"] = timestamp(time);
+    auto arguments = Json::Value(Json::objectValue);
+    arguments["GB"] = Json::Value(round(resident_set_size, 3));
+    value["args"] = arguments;
+    events.append(value);
+  }
+
+  auto value = Json::Value(Json::objectValue);
+  value["traceEvents"] = events;
+  value["displayTimeUnit"] = Json::Value("ms");
+  JsonValidation::write_json_file(path, value);
+}
+
 } // namespace marianatrench
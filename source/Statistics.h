@@ -7,37 +7,175 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include <json/json.h>
 
+#include <mariana-trench/CacheStatistics.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/Timer.h>
 
 namespace marianatrench {
 
+/**
+ * Profile of a single item (i.e, a set of constraints and a model template) of
+ * a model generator.
+ */
+struct ModelGeneratorItemProfile {
+  std::string name;
+  double time = 0.0;
+  /* Number of candidates returned by `may_satisfy`, or all methods if top. */
+  std::size_t candidates = 0;
+  /* Number of evaluations of `satisfy` by this item alone. */
+  std::size_t satisfy_evaluations = 0;
+  std::size_t models = 0;
+};
+
+struct ModelGeneratorProfile {
+  std::string name;
+  double wall_time = 0.0;
+  /* CPU time of the thread running the generator. */
+  double cpu_time = 0.0;
+  std::size_t models = 0;
+  std::size_t field_models = 0;
+  std::vector<ModelGeneratorItemProfile> items;
+};
+
 /**
  * Record various statistics during the analysis.
+ *
+ * Statistics about method analyses are recorded by worker threads concurrently
+ * during a fixpoint iteration. They are accumulated per thread, without
+ * locking, and merged by `end_iteration`, which must be called while worker
+ * threads are idle.
  */
 class Statistics final {
  public:
-  Statistics() = default;
+  Statistics();
 
   DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Statistics)
 
   void log_number_iterations(std::size_t number_iterations);
   void log_resident_set_size(double resident_set_size);
+  /**
+   * Record the time of a phase of the analysis. If cache statistics are
+   * enabled, this also records the cache counters since the previous phase.
+   */
   void log_time(const std::string& name, const Timer& timer);
+  /* Record the analysis of a method, in the current iteration. */
   void log_time(const Method* method, const Timer& timer);
+  void log_model_generator(ModelGeneratorProfile profile);
+
+  /* Record that the model of an analyzed method changed. */
+  void log_model_changed();
+  /* Record the number of methods enqueued because a callee changed. */
+  void log_dependents_enqueued(std::size_t dependents);
+
+  /**
+   * Merge the statistics of all threads into the current iteration, and start
+   * a new one. Fixpoints without global iterations call this once.
+   */
+  void end_iteration();
+
+  /**
+   * Record a timeline of the analysis, written by `dump_trace`. Once enabled,
+   * timers logged with `log_time` and `log_trace_span` become spans on the
+   * track of their thread, method analyses are merged into activity spans per
+   * thread, and resident set sizes become a counter track.
+   */
+  void enable_trace();
+  /* Record a span that is only part of the trace. */
+  void log_trace_span(const std::string& name, const Timer& timer);
+  /* Write the trace in the Chrome trace event format. */
+  void dump_trace(const std::filesystem::path& path) const;
 
   Json::Value to_json() const;
 
   /* Maximum number of slowest methods to record. */
   constexpr static std::size_t kRecordSlowestMethods = 20;
 
+  /* Maximum number of slowest items to record per model generator. */
+  constexpr static std::size_t kRecordSlowestModelGeneratorItems = 10;
+
+  /**
+   * Method analyses on the same thread separated by less than this are merged
+   * into a single activity span of the trace.
+   */
+  constexpr static std::chrono::milliseconds kTraceActivityGap{10};
+
+  /**
+   * Upper bounds (in seconds) of the buckets of the histogram of method
+   * analysis times. The last bucket has no upper bound.
+   */
+  constexpr static std::array<double, 5> kAnalysisTimeBuckets = {
+      0.001,
+      0.01,
+      0.1,
+      1.0,
+      10.0};
+
+ private:
+  using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
+
+  struct TraceSpan {
+    std::string name;
+    std::size_t thread;
+    TimePoint begin;
+    TimePoint end;
+  };
+
+  struct SlowMethod {
+    const Method* method;
+    double duration_in_seconds;
+    std::size_t thread;
+    TimePoint begin;
+  };
+
+  struct IterationStatistics {
+    std::size_t methods_analyzed = 0;
+    std::size_t models_changed = 0;
+    std::size_t dependents_enqueued = 0;
+    std::array<std::size_t, kAnalysisTimeBuckets.size() + 1>
+        analysis_time_histogram = {};
+
+    void join_with(const IterationStatistics& other);
+  };
+
+  /* Statistics of a single thread in the current iteration. */
+  struct ThreadStatistics {
+    std::size_t thread;
+    IterationStatistics iteration;
+    // Sorted from slowest to fastest, as `slowest_methods_`.
+    std::vector<SlowMethod> slowest_methods;
+    // Current activity span, not yet in `trace_spans`.
+    std::optional<TraceSpan> trace_activity;
+    std::vector<TraceSpan> trace_spans;
+  };
+
+  /* Index of the track of the current thread. Requires the lock. */
+  std::size_t trace_thread();
+  void add_trace_span(std::string name, const Timer& timer);
+
+  /* Statistics of the current thread, in the current iteration. */
+  ThreadStatistics& thread_statistics();
+
+  /* Insert in a sorted list of slowest methods, keeping the slowest time. */
+  static void add_slow_method(
+      std::vector<SlowMethod>& slowest_methods,
+      const SlowMethod& record);
+
  private:
   std::mutex mutex_;
 
@@ -51,7 +189,31 @@ class Statistics final {
   std::unordered_map<std::string, double> times_;
 
   // Sorted list of slowest methods to analyze (from slowest to fastest).
-  std::vector<std::pair<const Method*, double>> slowest_methods_;
+  std::vector<SlowMethod> slowest_methods_;
+
+  // Statistics of each completed iteration.
+  std::vector<IterationStatistics> iterations_;
+
+  // Per-thread statistics of the current iteration. Threads cache their entry,
+  // which is valid as long as `epoch_` does not change.
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadStatistics>>
+      thread_statistics_;
+  std::atomic<std::uint64_t> epoch_;
+
+  // Cache counters of each phase, in the order phases were logged.
+  std::vector<std::pair<std::string, CacheStatistics::Counters>>
+      cache_statistics_;
+  CacheStatistics::Counters cache_counters_at_last_phase_ = {};
+
+  // Profile of each model generator.
+  std::vector<ModelGeneratorProfile> model_generators_;
+
+  // Timeline of the analysis, if enabled.
+  std::atomic<bool> trace_enabled_ = false;
+  TimePoint trace_start_ = std::chrono::steady_clock::now();
+  std::unordered_map<std::thread::id, std::size_t> trace_threads_;
+  std::vector<TraceSpan> trace_spans_;
+  std::vector<std::pair<TimePoint, double>> trace_resident_set_sizes_;
 };
 
 } // namespace marianatrench
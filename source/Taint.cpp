@@ -92,6 +92,12 @@ void Taint::set_local_positions(const LocalPositionSet& positions) {
   });
 }
 
+void Taint::drop_inferred_features_and_local_positions() {
+  map_.transform([](LocalTaint* local_taint) -> void {
+    local_taint->drop_inferred_features_and_local_positions();
+  });
+}
+
 LocalPositionSet Taint::local_positions() const {
   auto result = LocalPositionSet::bottom();
   for (const auto& [_, callee_frames] : map_.bindings()) {
@@ -129,6 +135,23 @@ Taint Taint::propagate(
     const std::vector<std::optional<std::string>>& source_constant_arguments,
     const CallClassIntervalContext& class_interval_context,
     const ClassIntervals::Interval& caller_class_interval) const {
+  return propagate(
+      callee_port,
+      CallSitePropagation(
+          callee,
+          call_position,
+          maximum_source_sink_distance,
+          extra_features,
+          context,
+          source_register_types,
+          source_constant_arguments,
+          class_interval_context,
+          caller_class_interval));
+}
+
+Taint Taint::propagate(
+    const AccessPath& callee_port,
+    const CallSitePropagation& call_site) const {
   Taint result;
   for (const auto& [_, local_taint] : map_.bindings()) {
     if (local_taint.call_kind().is_propagation_without_trace()) {
@@ -137,21 +160,12 @@ Taint Taint::propagate(
       continue;
     }
 
-    auto propagated = local_taint.propagate(
-        callee,
-        callee_port,
-        call_position,
-        maximum_source_sink_distance,
-        context,
-        source_register_types,
-        source_constant_arguments,
-        class_interval_context,
-        caller_class_interval);
+    auto propagated = local_taint.propagate(callee_port, call_site);
     if (propagated.is_bottom()) {
       continue;
     }
 
-    propagated.add_locally_inferred_features(extra_features);
+    propagated.add_locally_inferred_features(call_site.extra_features());
     result.add(propagated);
   }
   return result;
@@ -167,14 +181,13 @@ Taint Taint::attach_position(const Position* position) const {
 
 Taint Taint::apply_transform(
     const KindFactory& kind_factory,
-    const TransformsFactory& transforms_factory,
     const UsedKinds& used_kinds,
     const TransformList* local_transforms) const {
   Taint result{};
 
   for (const auto& [_, local_taint] : map_.bindings()) {
-    auto new_callee_frames = local_taint.apply_transform(
-        kind_factory, transforms_factory, used_kinds, local_transforms);
+    auto new_callee_frames =
+        local_taint.apply_transform(kind_factory, used_kinds, local_transforms);
     if (new_callee_frames.is_bottom()) {
       continue;
     }
@@ -206,6 +219,16 @@ Json::Value Taint::to_json(ExportOriginsMode export_origins_mode) const {
   return taint;
 }
 
+void Taint::write_json(
+    JsonWriter& writer,
+    ExportOriginsMode export_origins_mode) const {
+  writer.begin_array();
+  for (const auto& [_, local_taint] : map_.bindings()) {
+    local_taint.write_json(writer, export_origins_mode);
+  }
+  writer.end_array();
+}
+
 std::ostream& operator<<(std::ostream& out, const Taint& taint) {
   out << "{";
   for (auto it = taint.map_.bindings().begin();
@@ -274,6 +297,18 @@ std::unordered_map<const Kind*, Taint> Taint::partition_by_kind() const {
   return partition_by_kind<const Kind*>([](const Kind* kind) { return kind; });
 }
 
+std::unordered_map<const Kind*, Taint> Taint::partition_by_kind_if(
+    const std::function<bool(const Kind*)>& keep) const {
+  std::unordered_map<const Kind*, Taint> result;
+  for (const auto& [_, local_taint] : map_.bindings()) {
+    for (const auto& [kind, kind_local_taint] :
+         local_taint.partition_by_kind_if(keep)) {
+      result[kind].add(kind_local_taint);
+    }
+  }
+  return result;
+}
+
 void Taint::intersect_intervals_with(const Taint& other) {
   std::unordered_set<CallClassIntervalContext> other_intervals;
 
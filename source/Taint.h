@@ -19,6 +19,7 @@
 #include <mariana-trench/CallInfo.h>
 #include <mariana-trench/Frame.h>
 #include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/KindFactory.h>
 #include <mariana-trench/LocalTaint.h>
 #include <mariana-trench/Log.h>
@@ -148,6 +149,9 @@ class Taint final : public sparta::AbstractDomain<Taint> {
 
   void set_local_positions(const LocalPositionSet& positions);
 
+  /* See `LocalTaint::drop_inferred_features_and_local_positions`. */
+  void drop_inferred_features_and_local_positions();
+
   LocalPositionSet local_positions() const;
 
   FeatureMayAlwaysSet locally_inferred_features(
@@ -174,6 +178,15 @@ class Taint final : public sparta::AbstractDomain<Taint> {
       const CallClassIntervalContext& class_interval_context,
       const ClassIntervals::Interval& caller_class_interval) const;
 
+  /**
+   * Propagate the taint of the given callee port to the call site. This
+   * shares computations across the ports of a callee model at the same call
+   * site.
+   */
+  Taint propagate(
+      const AccessPath& callee_port,
+      const CallSitePropagation& call_site) const;
+
   /* Return the set of leaf frames with the given position. */
   Taint attach_position(const Position* position) const;
 
@@ -204,11 +217,12 @@ class Taint final : public sparta::AbstractDomain<Taint> {
 
   Taint apply_transform(
       const KindFactory& kind_factory,
-      const TransformsFactory& transforms_factory,
       const UsedKinds& used_kinds,
       const TransformList* local_transforms) const;
 
   Json::Value to_json(ExportOriginsMode export_origins_mode) const;
+  void write_json(JsonWriter& writer, ExportOriginsMode export_origins_mode)
+      const;
 
   friend std::ostream& operator<<(std::ostream& out, const Taint& taint);
 
@@ -274,6 +288,13 @@ class Taint final : public sparta::AbstractDomain<Taint> {
     return result;
   }
 
+  /**
+   * Same as `partition_by_kind()`, for the kinds satisfying `keep` only.
+   * Frames of other kinds are not copied.
+   */
+  std::unordered_map<const Kind*, Taint> partition_by_kind_if(
+      const std::function<bool(const Kind*)>& keep) const;
+
   template <typename Key>
   std::unordered_map<Key, Taint> partition_by_call_kind(
       const std::function<Key(CallKind)>& map_call_kind) const {
@@ -89,25 +89,30 @@ AccessPath validate_and_infer_crtex_callee_port(
 
 } // namespace
 
-TaintConfig TaintConfig::from_json(const Json::Value& value, Context& context) {
+TaintConfig TaintConfig::from_json(
+    const Json::Value& value,
+    Context& context,
+    bool check_unexpected_members) {
   JsonValidation::validate_object(value);
-  JsonValidation::check_unexpected_members(
-      value,
-      {"port", // Only when called from `Model::from_json`
-       "caller_port", // Only when called from `Model::from_json`
-       "type", // Only when called from `Model::from_json` for effects
-       "kind",
-       "partial_label",
-       "callee_port",
-       "callee",
-       "call_position",
-       "distance",
-       "features",
-       "may_features",
-       "always_features",
-       "via_type_of",
-       "via_value_of",
-       "canonical_names"});
+  if (check_unexpected_members) {
+    JsonValidation::check_unexpected_members(
+        value,
+        {"port", // Only when called from `Model::from_json`
+         "caller_port", // Only when called from `Model::from_json`
+         "type", // Only when called from `Model::from_json` for effects
+         "kind",
+         "partial_label",
+         "callee_port",
+         "callee",
+         "call_position",
+         "distance",
+         "features",
+         "may_features",
+         "always_features",
+         "via_type_of",
+         "via_value_of",
+         "canonical_names"});
+  }
 
   const Kind* kind =
       Kind::from_json(value, context, /* check_unexpected_members */ false);
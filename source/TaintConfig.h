@@ -192,7 +192,10 @@ class TaintConfig final {
     return callee_ == nullptr;
   }
 
-  static TaintConfig from_json(const Json::Value& value, Context& context);
+  static TaintConfig from_json(
+      const Json::Value& value,
+      Context& context,
+      bool check_unexpected_members = true);
 
  private:
   /* Properties that are unique to a `Frame` within `Taint`. */
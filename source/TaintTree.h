@@ -15,7 +15,7 @@
 namespace marianatrench {
 
 struct TaintTreeConfiguration {
-  static std::size_t max_tree_height_after_widening() {
+  static constexpr std::size_t max_tree_height_after_widening() {
     return Heuristics::kSourceSinkTreeWideningHeight;
   }
 
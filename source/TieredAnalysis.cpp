@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <ControlFlow.h>
+#include <IRCode.h>
+#include <IRInstruction.h>
+
+#include <mariana-trench/CallGraph.h>
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/TieredAnalysis.h>
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+namespace {
+
+bool has_kinds(const Model& model) {
+  return !model.source_kinds().empty() || !model.sink_kinds().empty();
+}
+
+struct TaintedValueAccesses {
+  // A field or string literal with sources is accessed.
+  bool sources = false;
+  // A field with sinks is accessed.
+  bool sinks = false;
+};
+
+TaintedValueAccesses accesses_tainted_values(
+    const Method* method,
+    const CallGraph& call_graph,
+    const Registry& registry) {
+  TaintedValueAccesses accesses;
+  const auto* code = method->get_code();
+  if (code == nullptr || !code->cfg_built()) {
+    return accesses;
+  }
+  for (const auto* block : code->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      const auto* instruction = entry.insn;
+      if (instruction->opcode() == OPCODE_CONST_STRING &&
+          !registry.match_literal(instruction->get_string()).empty()) {
+        accesses.sources = true;
+      }
+      auto field_access =
+          call_graph.resolved_field_access(method, instruction);
+      if (field_access) {
+        auto field_model = registry.get(field_access->field);
+        accesses.sources |= !field_model.sources().is_bottom();
+        accesses.sinks |= !field_model.sinks().is_bottom();
+      }
+      if (accesses.sources && accesses.sinks) {
+        return accesses;
+      }
+    }
+  }
+  return accesses;
+}
+
+/* Add the transitive callers of the given methods to them. */
+void add_transitive_callers(
+    const Context& context,
+    ConcurrentSet<const Method*>& methods) {
+  std::vector<const Method*> worklist(methods.begin(), methods.end());
+  while (!worklist.empty()) {
+    const auto* method = worklist.back();
+    worklist.pop_back();
+    for (const auto* dependency : context.dependencies->dependencies(method)) {
+      if (methods.insert(dependency)) {
+        worklist.push_back(dependency);
+      }
+    }
+  }
+}
+
+std::size_t skip_methods(
+    Context& context,
+    Registry& registry,
+    const ConcurrentSet<const Method*>& analyzed_methods) {
+  std::atomic<std::size_t> skipped_methods(0);
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        if (analyzed_methods.count(method) > 0 ||
+            method->get_code() == nullptr ||
+            registry.get_snapshot(method)->skip_analysis()) {
+          return;
+        }
+        registry.update(method, [&context](Model& model) {
+          model.add_mode(Model::Mode::SkipAnalysis, context);
+          model.add_mode(Model::Mode::TaintInTaintOut, context);
+          model.add_mode(Model::Mode::TaintInTaintThis, context);
+        });
+        skipped_methods++;
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+  return skipped_methods.load();
+}
+
+} // namespace
+
+ConcurrentSet<const Method*> TieredAnalysis::relevant_methods(
+    const Context& context,
+    const Registry& registry) {
+  ConcurrentSet<const Method*> relevant_methods;
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        if (has_kinds(*registry.get_snapshot(method))) {
+          relevant_methods.insert(method);
+          return;
+        }
+        auto accesses =
+            accesses_tainted_values(method, *context.call_graph, registry);
+        if (accesses.sources || accesses.sinks) {
+          relevant_methods.insert(method);
+        }
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  // Callers of relevant methods are relevant.
+  add_transitive_callers(context, relevant_methods);
+  return relevant_methods;
+}
+
+std::size_t TieredAnalysis::skip_irrelevant_methods(
+    Context& context,
+    Registry& registry) {
+  auto relevant = relevant_methods(context, registry);
+  auto skipped_methods = skip_methods(context, registry, relevant);
+  LOG(1,
+      "Found {} methods that may hold taint, skipping the analysis of {} methods.",
+      relevant.size(),
+      skipped_methods);
+  return skipped_methods;
+}
+
+ConcurrentSet<const Method*> TieredAnalysis::sliced_methods(
+    const Context& context,
+    const Registry& registry) {
+  ConcurrentSet<const Method*> reaching_sources;
+  ConcurrentSet<const Method*> reaching_sinks;
+  auto queue = work_queue<const Method*>(
+      [&](const Method* method) {
+        auto model = registry.get_snapshot(method);
+        auto accesses =
+            accesses_tainted_values(method, *context.call_graph, registry);
+        if (!model->source_kinds().empty() || accesses.sources) {
+          reaching_sources.insert(method);
+        }
+        if (!model->sink_kinds().empty() || accesses.sinks) {
+          reaching_sinks.insert(method);
+        }
+      },
+      sparta::parallel::default_num_threads());
+  for (const auto* method : *context.methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  // Sources flow to the callers of their methods, and sinks are propagated to
+  // the callers of their methods.
+  add_transitive_callers(context, reaching_sources);
+  add_transitive_callers(context, reaching_sinks);
+
+  // Sources and sinks meet in the methods reaching both. The callees of these
+  // methods reaching either carry the taint to them.
+  std::unordered_map<const Method*, std::vector<const Method*>> callees;
+  for (const auto* reaching : {&reaching_sources, &reaching_sinks}) {
+    for (const auto* method : *reaching) {
+      for (const auto* caller : context.dependencies->dependencies(method)) {
+        callees[caller].push_back(method);
+      }
+    }
+  }
+  ConcurrentSet<const Method*> sliced_methods;
+  std::vector<const Method*> worklist;
+  for (const auto* method : reaching_sources) {
+    if (reaching_sinks.count(method) > 0) {
+      sliced_methods.insert(method);
+      worklist.push_back(method);
+    }
+  }
+  while (!worklist.empty()) {
+    const auto* method = worklist.back();
+    worklist.pop_back();
+    auto found = callees.find(method);
+    if (found == callees.end()) {
+      continue;
+    }
+    for (const auto* callee : found->second) {
+      if (sliced_methods.insert(callee)) {
+        worklist.push_back(callee);
+      }
+    }
+  }
+  return sliced_methods;
+}
+
+std::size_t TieredAnalysis::skip_methods_outside_slice(
+    Context& context,
+    Registry& registry) {
+  auto sliced = sliced_methods(context, registry);
+  auto skipped_methods = skip_methods(context, registry, sliced);
+  LOG(1,
+      "Found {} methods through which sources may reach sinks, skipping the analysis of {} methods.",
+      sliced.size(),
+      skipped_methods);
+  return skipped_methods;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Registry.h>
+
+namespace marianatrench {
+
+/**
+ * First tier of the analysis, with `--tiered-analysis`: a cheap reachability
+ * of source and sink kinds on the dependency graph, used to only analyze
+ * precisely the methods that may hold taint.
+ *
+ * A method may hold taint if its model has source or sink kinds, if it
+ * accesses a field with sources or sinks, if it loads a string literal with
+ * sources, or if it (transitively) calls such a method, including through
+ * overrides and artificial callees.
+ *
+ * Other methods can only pass taint through. They are not analyzed: their
+ * models are in `skip-analysis` mode with taint-in-taint-out and
+ * taint-in-taint-this propagations, which over-approximates their inferred
+ * propagations, except propagations into other arguments.
+ */
+class TieredAnalysis final {
+ public:
+  /* Methods that may hold taint. */
+  static ConcurrentSet<const Method*> relevant_methods(
+      const Context& context,
+      const Registry& registry);
+
+  /* Skip the analysis of the other methods. Return their number. */
+  static std::size_t skip_irrelevant_methods(
+      Context& context,
+      Registry& registry);
+
+  /**
+   * Methods through which a source may reach a sink, with
+   * `--source-sink-slicing`: methods (transitively) calling both a method
+   * with sources and a method with sinks, and their callees that (transitively)
+   * call either. Fields and string literals with models count as sources and
+   * sinks of the methods accessing them.
+   */
+  static ConcurrentSet<const Method*> sliced_methods(
+      const Context& context,
+      const Registry& registry);
+
+  /* Skip the analysis of the other methods. Return their number. */
+  static std::size_t skip_methods_outside_slice(
+      Context& context,
+      Registry& registry);
+};
+
+} // namespace marianatrench
@@ -27,6 +27,10 @@ class Timer final {
     return duration_in_milliseconds / 1000.0;
   }
 
+  std::chrono::time_point<std::chrono::steady_clock> start() const {
+    return start_;
+  }
+
  private:
   std::chrono::time_point<std::chrono::steady_clock> start_;
 };
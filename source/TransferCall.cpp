@@ -57,7 +57,8 @@ CallClassIntervalContext get_type_context(
     const MethodContext* context,
     const IRInstruction* instruction,
     bool is_this_call) {
-  if (instruction->opcode() != OPCODE_INVOKE_VIRTUAL) {
+  if (instruction->opcode() != OPCODE_INVOKE_VIRTUAL ||
+      !context->class_intervals.enabled()) {
     // Class intervals only apply to virtual calls.
     return CallClassIntervalContext();
   }
@@ -138,7 +139,8 @@ CalleeModel get_callee(
     const DexPosition* MT_NULLABLE dex_position,
     const std::vector<const DexType * MT_NULLABLE>& source_register_types,
     const std::vector<std::optional<std::string>>& source_constant_arguments,
-    bool is_this_call) {
+    bool is_this_call,
+    const std::optional<std::vector<bool>>& tainted_arguments) {
   mt_assert(opcode::is_an_invoke(instruction->opcode()));
 
   auto call_target = context->call_graph.callee(context->method(), instruction);
@@ -165,7 +167,8 @@ CalleeModel get_callee(
       position,
       source_register_types,
       source_constant_arguments,
-      class_interval_context);
+      class_interval_context,
+      tainted_arguments);
   LOG_OR_DUMP(context, 4, "Callee model: {}", model);
 
   // Avoid copies using `std::move`.
@@ -195,7 +198,8 @@ CalleeModel get_callee(
       position,
       /* source_register_types */ {},
       /* source_constant_arguments */ {},
-      /* class_interval_context */ CallClassIntervalContext());
+      /* class_interval_context */ CallClassIntervalContext(),
+      /* tainted_arguments */ std::nullopt);
   LOG_OR_DUMP(context, 4, "Callee model: {}", model);
 
   return CalleeModel{
@@ -314,6 +318,26 @@ MemoryLocation* MT_NULLABLE try_inline_invoke_as_getter(
   return memory_location;
 }
 
+AliasCalleeSummary alias_callee_summary(
+    const MethodContext* context,
+    const CalleeModel& callee) {
+  auto inline_as_getter = AccessPathConstantDomain::top();
+  if (auto access_path = callee.model.inline_as_getter().get_constant()) {
+    if (is_safe_to_inline(
+            context,
+            callee,
+            /* input */ *access_path,
+            /* output */ context->kind_factory.local_return(),
+            /* output_path */ Path{})) {
+      inline_as_getter = AccessPathConstantDomain(*access_path);
+    }
+  }
+
+  return AliasCalleeSummary{
+      std::move(inline_as_getter),
+      callee.model.alias_memory_location_on_invoke()};
+}
+
 std::optional<SetterInlineMemoryLocations> try_inline_invoke_as_setter(
     const MethodContext* context,
     const RegisterMemoryLocationsMap& register_memory_locations_map,
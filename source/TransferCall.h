@@ -49,13 +49,20 @@ bool get_is_this_call(
     const RegisterMemoryLocationsMap& register_memory_locations_map,
     const IRInstruction* instruction);
 
+/**
+ * Return the callee model at the given call site.
+ *
+ * If `tainted_arguments` is provided, sinks are only instantiated on the
+ * arguments marked as tainted. See `Model::at_callsite`.
+ */
 CalleeModel get_callee(
     const MethodContext* context,
     const IRInstruction* instruction,
     const DexPosition* MT_NULLABLE position,
     const std::vector<const DexType * MT_NULLABLE>& source_register_types,
     const std::vector<std::optional<std::string>>& source_constant_arguments,
-    bool is_this_call);
+    bool is_this_call,
+    const std::optional<std::vector<bool>>& tainted_arguments = std::nullopt);
 
 CalleeModel get_callee(
     const MethodContext* context,
@@ -70,6 +77,12 @@ MemoryLocation* MT_NULLABLE try_inline_invoke_as_getter(
     const IRInstruction* instruction,
     const CalleeModel& callee);
 
+/* Return the parts of the callee model that the forward alias analysis depends
+ * on. */
+AliasCalleeSummary alias_callee_summary(
+    const MethodContext* context,
+    const CalleeModel& callee);
+
 struct SetterInlineMemoryLocations {
   MemoryLocation* target;
   MemoryLocation* value;
@@ -45,10 +45,7 @@ TaintTree apply_propagation(
     output_taint_tree.write(
         path,
         taint.apply_transform(
-            context->kind_factory,
-            context->transforms_factory,
-            context->used_kinds,
-            all_transforms),
+            context->kind_factory, context->used_kinds, all_transforms),
         UpdateKind::Weak);
   }
 
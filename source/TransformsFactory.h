@@ -60,7 +60,8 @@ class TransformsFactory final {
   static const TransformsFactory& singleton();
 
  private:
-  UniquePointerFactory<std::string, Transform> transform_;
+  UniquePointerFactory<std::string, Transform> transform_{
+      CacheStatistics::Cache::Transforms};
   mutable InsertOnlyConcurrentSet<TransformList> transform_lists_;
 };
 
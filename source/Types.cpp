@@ -6,6 +6,10 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 #include <fmt/format.h>
 
@@ -19,8 +23,10 @@
 #include <Walkers.h>
 
 #include <mariana-trench/Assert.h>
+#include <mariana-trench/CacheStatistics.h>
 #include <mariana-trench/EventLogger.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/MemoryAccounting.h>
 #include <mariana-trench/OperatingSystem.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Timer.h>
@@ -134,6 +140,16 @@ bool should_log_method(
   return false;
 }
 
+const DexType* MT_NULLABLE
+find_type(const TypeEnvironment& environment, Register register_id) {
+  auto type = environment.find(register_id);
+  if (type == environment.end()) {
+    return nullptr;
+  }
+
+  return type->second;
+}
+
 std::string show_locally_inferred_types(const TypeEnvironment& environment) {
   std::string types_string = "(";
   for (const auto& [ir_register, type] : environment) {
@@ -147,14 +163,13 @@ std::string show_locally_inferred_types(const TypeEnvironment& environment) {
 }
 
 std::string show_globally_inferred_types(
-    const IRInstruction* instruction,
-    const RegTypeEnvironment& environment) {
+    const GlobalTypeAnalysisCache::RegisterTypes& register_types) {
   std::string types_string = "(";
-  for (const auto& ir_register : instruction->srcs()) {
+  for (const auto& [ir_register, type] : register_types) {
     types_string.append(fmt::format(
         "{}: {}, ",
         std::to_string(ir_register),
-        show(environment.get(ir_register).get_single_domain())));
+        type ? type->str() : "unknown"));
   }
   types_string.append(")");
   return types_string;
@@ -231,6 +246,80 @@ const DexType* MT_NULLABLE select_precise_singleton_type(
 
 } // namespace
 
+/**
+ * A thread-safe cache of type environments with a least recently used eviction
+ * policy. Methods are distributed across shards to reduce contention.
+ */
+class Types::EnvironmentsCache final {
+ private:
+  static constexpr std::size_t k_shards = 64;
+
+  using Entry =
+      std::pair<const Method*, std::shared_ptr<const TypeEnvironments>>;
+
+  struct Shard {
+    std::mutex mutex;
+    // Most recently used entries first.
+    std::list<Entry> entries;
+    std::unordered_map<const Method*, std::list<Entry>::iterator> index;
+  };
+
+ public:
+  explicit EnvironmentsCache(std::size_t maximum_methods)
+      : maximum_methods_per_shard_(
+            std::max<std::size_t>(1, maximum_methods / k_shards)) {}
+
+  template <typename Visitor>
+  void visit(Visitor&& visitor) {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (const auto& [method, environments] : shard.entries) {
+        visitor(*environments);
+      }
+    }
+  }
+
+  std::shared_ptr<const TypeEnvironments> get(const Method* method) {
+    auto& shard = shard_for(method);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(method);
+    if (found == shard.index.end()) {
+      return nullptr;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    return found->second->second;
+  }
+
+  void insert(
+      const Method* method,
+      std::shared_ptr<const TypeEnvironments> environments) {
+    auto& shard = shard_for(method);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.index.count(method) != 0) {
+      return;
+    }
+    shard.entries.emplace_front(method, std::move(environments));
+    shard.index.emplace(method, shard.entries.begin());
+    if (shard.entries.size() > maximum_methods_per_shard_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+    }
+  }
+
+ private:
+  Shard& shard_for(const Method* method) {
+    return shards_[std::hash<const Method*>()(method) % k_shards];
+  }
+
+ private:
+  std::size_t maximum_methods_per_shard_;
+  std::array<Shard, k_shards> shards_;
+};
+
+Types::Types() = default;
+
+Types::~Types() = default;
+
 Types::Types(const Options& options, const DexStoresVector& stores) {
   Scope scope = build_class_scope(stores);
   log_method_types_ = options.log_method_types();
@@ -242,17 +331,37 @@ Types::Types(const Options& options, const DexStoresVector& stores) {
       scope.end());
 
   if (!options.disable_global_type_analysis()) {
-    Timer global_timer;
-    type_analyzer::global::GlobalTypeAnalysis analysis(
-        /* max_global_analysis_iteration */ 10,
-        /* use_multiple_callee_callgraph */ true,
-        /* only_aggregate_safely_inferrable_fields */ false);
-    global_type_analyzer_ = analysis.analyze(scope);
-
-    LOG(1,
-        "Global analysis {:.2f}s. Memory used, RSS: {:.2f}GB",
-        global_timer.duration_in_seconds(),
-        resident_set_size_in_gb());
+    if (auto cache_directory = options.analysis_cache_directory()) {
+      global_types_cache_ =
+          std::make_unique<GlobalTypeAnalysisCache>(*cache_directory, stores);
+    }
+
+    if (global_types_cache_ != nullptr && global_types_cache_->load()) {
+      LOG(1, "Skipping global type analysis, using cached results.");
+    } else {
+      Timer global_timer;
+      type_analyzer::global::GlobalTypeAnalysis analysis(
+          /* max_global_analysis_iteration */ 10,
+          /* use_multiple_callee_callgraph */ true,
+          /* only_aggregate_safely_inferrable_fields */ false);
+      global_type_analyzer_ = analysis.analyze(scope);
+
+      LOG(1,
+          "Global analysis {:.2f}s. Memory used, RSS: {:.2f}GB",
+          global_timer.duration_in_seconds(),
+          resident_set_size_in_gb());
+
+      if (global_types_cache_ != nullptr) {
+        // Replay the analysis for all methods once, so that the analyzer can
+        // be discarded and the results reused in the next run.
+        walk::parallel::code(scope, [this](DexMethod* method, IRCode& code) {
+          global_types_cache_->set(
+              method, replay_global_types_for_method(method, code));
+        });
+        global_types_cache_->store();
+        global_type_analyzer_ = nullptr;
+      }
+    }
   } else {
     LOG(1, "Disabled global type analysis.");
     global_type_analyzer_ = nullptr;
@@ -358,52 +467,42 @@ std::unique_ptr<TypeEnvironments> Types::infer_types_for_method(
 
   // Call TypeInference first, then use GlobalTypeAnalyzer to refine results.
   auto environments = infer_local_types_for_method(method);
-  if (global_type_analyzer_ == nullptr) {
+  GlobalTypeAnalysisCache::MethodTypes replayed_types;
+  const GlobalTypeAnalysisCache::MethodTypes* global_types = nullptr;
+  if (global_types_cache_ != nullptr && global_type_analyzer_ == nullptr) {
+    global_types = global_types_cache_->get(method->dex_method());
+  } else if (global_type_analyzer_ != nullptr) {
+    replayed_types =
+        replay_global_types_for_method(method->dex_method(), *code);
+    global_types = &replayed_types;
+  }
+  if (global_types == nullptr) {
     return environments;
   }
-  auto per_method_global_type_analyzer =
-      global_type_analyzer_->get_replayable_local_analysis(
-          method->dex_method());
 
+  std::size_t index = 0;
+  auto global_types_iterator = global_types->begin();
   for (auto* block : code->cfg().blocks()) {
-    auto current_state =
-        per_method_global_type_analyzer->get_entry_state_at(block);
     for (auto& entry : InstructionIterable(block)) {
       auto* instruction = entry.insn;
-      per_method_global_type_analyzer->analyze_instruction(
-          instruction, &current_state);
-
-      if (!is_interesting_opcode(instruction->opcode())) {
+      auto instruction_index = index++;
+      if (global_types_iterator == global_types->end() ||
+          global_types_iterator->first != instruction_index) {
         continue;
       }
+      const auto& register_types = global_types_iterator->second;
+      ++global_types_iterator;
+
       auto found = environments->find(instruction);
       auto& environment_at_instruction = found->second;
 
-      const auto& global_type_environment = current_state.get_reg_environment();
       LOG(log_method ? 0 : 5,
           "Instruction: {}\nLocally Inferred types: {}\nGlobally Inferred types: {}",
           show(instruction),
           show_locally_inferred_types(environment_at_instruction),
-          show_globally_inferred_types(instruction, global_type_environment));
-      if (!global_type_environment.is_value()) {
-        continue;
-      }
-      for (auto& ir_register : instruction->srcs()) {
-        const auto& globally_inferred_type_domain =
-            global_type_environment.get(ir_register);
-
-        // DexTypeDomain is a ReducedProductAbstractDomain.
-        // i.e, if anyone of the abstract domains have a _|_ component, the
-        // DexTypeDomain is equated to _|_.
-        if (globally_inferred_type_domain.is_bottom()) {
-          continue;
-        }
-
-        const DexType* globally_inferred_type = nullptr;
-        if (auto result = globally_inferred_type_domain.get_dex_type()) {
-          globally_inferred_type = *result;
-        }
-
+          show_globally_inferred_types(register_types));
+      for (const auto& [ir_register, globally_inferred_type] :
+           register_types) {
         const DexType* local_type = nullptr;
         if (auto result = environment_at_instruction.find(ir_register);
             result != environment_at_instruction.end()) {
@@ -439,8 +538,63 @@ std::unique_ptr<TypeEnvironments> Types::infer_types_for_method(
   return environments;
 }
 
+GlobalTypeAnalysisCache::MethodTypes Types::replay_global_types_for_method(
+    const DexMethod* method,
+    const IRCode& code) const {
+  mt_assert(global_type_analyzer_ != nullptr);
+
+  GlobalTypeAnalysisCache::MethodTypes method_types;
+  auto per_method_global_type_analyzer =
+      global_type_analyzer_->get_replayable_local_analysis(method);
+
+  std::size_t index = 0;
+  for (auto* block : code.cfg().blocks()) {
+    auto current_state =
+        per_method_global_type_analyzer->get_entry_state_at(block);
+    for (auto& entry : InstructionIterable(block)) {
+      auto* instruction = entry.insn;
+      auto instruction_index = index++;
+      per_method_global_type_analyzer->analyze_instruction(
+          instruction, &current_state);
+
+      if (!is_interesting_opcode(instruction->opcode())) {
+        continue;
+      }
+      const auto& global_type_environment = current_state.get_reg_environment();
+      if (!global_type_environment.is_value()) {
+        continue;
+      }
+
+      GlobalTypeAnalysisCache::RegisterTypes register_types;
+      for (auto ir_register : instruction->srcs()) {
+        const auto& globally_inferred_type_domain =
+            global_type_environment.get(ir_register);
+
+        // DexTypeDomain is a ReducedProductAbstractDomain.
+        // i.e, if anyone of the abstract domains have a _|_ component, the
+        // DexTypeDomain is equated to _|_.
+        if (globally_inferred_type_domain.is_bottom()) {
+          continue;
+        }
+
+        const DexType* globally_inferred_type = nullptr;
+        if (auto result = globally_inferred_type_domain.get_dex_type()) {
+          globally_inferred_type = *result;
+        }
+        register_types.emplace_back(ir_register, globally_inferred_type);
+      }
+      method_types.emplace_back(instruction_index, std::move(register_types));
+    }
+  }
+
+  return method_types;
+}
+
 const TypeEnvironments& Types::environments(const Method* method) const {
   auto* environments = environments_.get(method, /* default */ nullptr);
+  CacheStatistics::lookup(
+      CacheStatistics::Cache::TypeEnvironments,
+      /* hit */ environments != nullptr);
   if (environments != nullptr) {
     return *environments;
   }
@@ -455,7 +609,12 @@ const TypeEnvironments& Types::environments(const Method* method) const {
     return empty_environments;
   }
 
-  environments_.emplace(method, this->infer_types_for_method(method));
+  if (environments_.emplace(method, this->infer_types_for_method(method))) {
+    CacheStatistics::insert(CacheStatistics::Cache::TypeEnvironments);
+  } else {
+    // Another thread inferred the types of this method concurrently.
+    CacheStatistics::contention(CacheStatistics::Cache::TypeEnvironments);
+  }
   return *environments_.at(method);
 }
 
@@ -473,6 +632,7 @@ const TypeEnvironments& Types::const_class_environments(
 const TypeEnvironment& Types::environment(
     const Method* method,
     const IRInstruction* instruction) const {
+  mt_assert(environments_cache_ == nullptr);
   const auto& environments = this->environments(method);
   auto environment = environments.find(instruction);
   if (environment == environments.end()) {
@@ -498,13 +658,62 @@ const DexType* MT_NULLABLE Types::register_type(
     const Method* method,
     const IRInstruction* instruction,
     Register register_id) const {
-  const auto& environment = this->environment(method, instruction);
-  auto type = environment.find(register_id);
-  if (type == environment.end()) {
+  if (environments_cache_ == nullptr) {
+    return find_type(this->environment(method, instruction), register_id);
+  }
+
+  auto environments = environments_cache_->get(method);
+  CacheStatistics::lookup(
+      CacheStatistics::Cache::TypeEnvironments,
+      /* hit */ environments != nullptr);
+  if (environments == nullptr) {
+    environments = this->infer_types_for_method(method);
+    environments_cache_->insert(method, environments);
+    CacheStatistics::insert(CacheStatistics::Cache::TypeEnvironments);
+  }
+  auto environment = environments->find(instruction);
+  if (environment == environments->end()) {
     return nullptr;
   }
+  return find_type(environment->second, register_id);
+}
 
-  return type->second;
+void Types::limit_cached_environments(std::size_t maximum_methods) {
+  environments_.clear();
+  environments_cache_ = std::make_unique<EnvironmentsCache>(maximum_methods);
+}
+
+namespace {
+
+std::size_t environments_memory_usage(const TypeEnvironments& environments) {
+  std::size_t bytes =
+      memory_usage::nodes<TypeEnvironments::value_type>(environments.size());
+  for (const auto& [instruction, environment] : environments) {
+    bytes += environment.capacity() * sizeof(TypeEnvironment::value_type);
+  }
+  return bytes;
+}
+
+} // namespace
+
+std::size_t Types::memory_usage(std::size_t sampling_rate) const {
+  std::size_t index = 0;
+  std::size_t sampled_bytes = 0;
+  auto add = [&](const TypeEnvironments& environments) {
+    if (index++ % sampling_rate == 0) {
+      sampled_bytes += environments_memory_usage(environments);
+    }
+  };
+  for (const auto& [method, environments] : environments_) {
+    add(*environments);
+  }
+  for (const auto& [method, environments] : const_class_environments_) {
+    add(*environments);
+  }
+  if (environments_cache_ != nullptr) {
+    environments_cache_->visit(add);
+  }
+  return sampled_bytes * sampling_rate;
 }
 
 const DexType* MT_NULLABLE Types::source_type(
@@ -531,12 +740,7 @@ const DexType* MT_NULLABLE Types::register_const_class_type(
     const IRInstruction* instruction,
     Register register_id) const {
   const auto& environment = this->const_class_environment(method, instruction);
-  auto type = environment.find(register_id);
-  if (type == environment.end()) {
-    return nullptr;
-  }
-
-  return type->second;
+  return find_type(environment, register_id);
 }
 
 } // namespace marianatrench
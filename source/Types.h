@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <boost/container/flat_map.hpp>
 
 #include <DexClass.h>
@@ -14,6 +16,7 @@
 
 #include <mariana-trench/Access.h>
 #include <mariana-trench/Compiler.h>
+#include <mariana-trench/GlobalTypeAnalysisCache.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/Method.h>
 #include <mariana-trench/Options.h>
@@ -27,12 +30,26 @@ using TypeEnvironments =
     std::unordered_map<const IRInstruction*, TypeEnvironment>;
 
 class Types final {
+ private:
+  class EnvironmentsCache;
+
  public:
-  Types() = default;
+  Types();
   explicit Types(const Options& options, const DexStoresVector& stores);
 
-  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(Types)
+  Types(const Types&) = delete;
+  Types(Types&&) = delete;
+  Types& operator=(const Types&) = delete;
+  Types& operator=(Types&&) = delete;
+  // Out of line since the caches are incomplete types here.
+  ~Types();
 
+  /**
+   * Return the type environment at the given instruction.
+   *
+   * This cannot be used once the number of cached environments is limited,
+   * since the returned reference could be invalidated by an eviction.
+   */
   const TypeEnvironment& environment(
       const Method* method,
       const IRInstruction* instruction) const;
@@ -79,6 +96,24 @@ class Types final {
       const IRInstruction* instruction,
       Register register_id) const;
 
+  /**
+   * Discard all type environments and, from now on, only keep the environments
+   * of the given number of methods, evicting the least recently used ones.
+   * Evicted environments are inferred again when needed.
+   *
+   * This is used to reclaim memory once the call graph is built, since the
+   * fixpoint only needs types at a few call sites of each method it analyzes.
+   *
+   * This is not thread-safe.
+   */
+  void limit_cached_environments(std::size_t maximum_methods);
+
+  /**
+   * Approximate memory used by the type environments, in bytes, measured on
+   * one method out of `sampling_rate`. This is not thread-safe.
+   */
+  std::size_t memory_usage(std::size_t sampling_rate) const;
+
  private:
   const TypeEnvironments& environments(const Method* method) const;
 
@@ -90,13 +125,19 @@ class Types final {
   std::unique_ptr<TypeEnvironments> infer_types_for_method(
       const Method* method) const;
 
+  GlobalTypeAnalysisCache::MethodTypes replay_global_types_for_method(
+      const DexMethod* method,
+      const IRCode& code) const;
+
  private:
   mutable UniquePointerConcurrentMap<const Method*, TypeEnvironments>
       environments_;
   mutable UniquePointerConcurrentMap<const DexMethod*, TypeEnvironments>
       const_class_environments_;
+  std::unique_ptr<EnvironmentsCache> MT_NULLABLE environments_cache_;
   std::unique_ptr<type_analyzer::global::GlobalTypeAnalyzer>
       global_type_analyzer_;
+  std::unique_ptr<GlobalTypeAnalysisCache> MT_NULLABLE global_types_cache_;
   std::vector<std::string> log_method_types_;
 };
 
@@ -71,6 +71,18 @@ class UniquePointerConcurrentMap final {
     return inserted;
   }
 
+  std::size_t size() const {
+    return map_.size();
+  }
+
+  /* This is not thread-safe. */
+  void clear() {
+    for (const auto& entry : map_) {
+      delete entry.second;
+    }
+    map_.clear();
+  }
+
   /**
    * Iterating on the container while calling `emplace` concurrently is unsafe.
    */
@@ -9,12 +9,16 @@
 
 #include <ConcurrentContainers.h>
 
+#include <mariana-trench/CacheStatistics.h>
 #include <mariana-trench/Compiler.h>
+#include <mariana-trench/MemoryAccounting.h>
 
 namespace marianatrench {
 
 /**
  * A thread-safe factory that returns a unique pointer for a given key.
+ *
+ * Lookups are recorded in the cache statistics under the given cache.
  */
 template <typename Key, typename Value, typename Hash = std::hash<Key>>
 class UniquePointerFactory final {
@@ -34,7 +38,7 @@ class UniquePointerFactory final {
   using const_pointer = const value_type*;
 
  public:
-  UniquePointerFactory() = default;
+  explicit UniquePointerFactory(CacheStatistics::Cache cache) : cache_(cache) {}
 
   UniquePointerFactory(const UniquePointerFactory&) = delete;
 
@@ -52,9 +56,21 @@ class UniquePointerFactory final {
     }
   }
 
-  /* Get or create a unique pointer for the given key. */
+  /**
+   * Get or create a unique pointer for the given key.
+   *
+   * Almost all calls are hits once the analysis started, hence the key is
+   * first looked up without locking. The map is only updated, under the lock
+   * of the key's bucket, when the key is missing.
+   */
   const Value* create(const Key& key) const {
+    if (const auto* existing = map_.get(key, nullptr)) {
+      CacheStatistics::lookup(cache_, /* hit */ true);
+      return existing;
+    }
+
     const Value* result = nullptr;
+    bool inserted = false;
     map_.update(
         key, [&](const Key& /* key */, const Value*& pointer, bool exists) {
           // This is an atomic block.
@@ -62,7 +78,12 @@ class UniquePointerFactory final {
             pointer = new Value(key);
           }
           result = pointer;
+          inserted = !exists;
         });
+    CacheStatistics::lookup(cache_, /* hit */ !inserted);
+    if (inserted) {
+      CacheStatistics::insert(cache_);
+    }
     return result;
   }
 
@@ -70,7 +91,13 @@ class UniquePointerFactory final {
    * already exists. Otherwise, Value is instantiated using the args. */
   template <class... Args>
   const Value* create(const Key& key, Args&&... args) const {
+    if (const auto* existing = map_.get(key, nullptr)) {
+      CacheStatistics::lookup(cache_, /* hit */ true);
+      return existing;
+    }
+
     const Value* result = nullptr;
+    bool inserted = false;
     map_.update(
         key, [&](const Key& /* key */, const Value*& pointer, bool exists) {
           // This is an atomic block.
@@ -78,7 +105,12 @@ class UniquePointerFactory final {
             pointer = new Value(std::forward<Args>(args)...);
           }
           result = pointer;
+          inserted = !exists;
         });
+    CacheStatistics::lookup(cache_, /* hit */ !inserted);
+    if (inserted) {
+      CacheStatistics::insert(cache_);
+    }
     return result;
   }
 
@@ -88,7 +120,23 @@ class UniquePointerFactory final {
    * Returns `nullptr` if the key does not exist in the factory.
    */
   const Value* MT_NULLABLE get(const Key& key) const {
-    return map_.get(key, nullptr);
+    const auto* result = map_.get(key, nullptr);
+    CacheStatistics::lookup(cache_, /* hit */ result != nullptr);
+    return result;
+  }
+
+  std::size_t size() const {
+    return map_.size();
+  }
+
+  /**
+   * Approximate memory used by the keys and values, in bytes. This does not
+   * account for memory owned by the values themselves.
+   */
+  std::size_t memory_usage() const {
+    return memory_usage::nodes<std::pair<const Key, const Value*>>(
+               map_.size()) +
+        map_.size() * sizeof(Value);
   }
 
   /**
@@ -104,6 +152,7 @@ class UniquePointerFactory final {
   }
 
  private:
+  CacheStatistics::Cache cache_;
   mutable Map map_;
 };
 
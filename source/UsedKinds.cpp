@@ -5,37 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <sparta/WorkQueue.h>
-
-#include <mariana-trench/ArtificialMethods.h>
-#include <mariana-trench/Methods.h>
 #include <mariana-trench/Rules.h>
 #include <mariana-trench/UsedKinds.h>
 
 namespace marianatrench {
 
-std::size_t UsedKinds::remove_unused_kinds(
-    const Rules& rules,
-    const KindFactory& kind_factory,
-    const Methods& methods,
-    ArtificialMethods& artificial_methods,
-    Registry& registry) {
-  auto unused_kinds = rules.collect_unused_kinds(kind_factory);
-  auto queue = sparta::work_queue<const Method*>(
-      [&registry, &unused_kinds](const Method* method) {
-        auto model = registry.get(method);
-        model.remove_kinds(unused_kinds);
-        registry.set(model);
-      },
-      sparta::parallel::default_num_threads());
-  for (const auto* method : methods) {
-    queue.add_item(method);
-  }
-  queue.run_all();
-  artificial_methods.set_unused_kinds(unused_kinds);
-  return unused_kinds.size();
-}
-
 namespace {
 
 void add_source_sink_transforms(
@@ -135,4 +109,41 @@ bool UsedKinds::should_keep(const TransformKind* transform_kind) const {
       valid_transforms->second.end();
 }
 
+const Kind* MT_NULLABLE UsedKinds::transform_kind(
+    const KindFactory& kind_factory,
+    const Kind* kind,
+    const TransformList* MT_NULLABLE local_transforms) const {
+  auto key = std::make_pair(kind, local_transforms);
+  if (auto cached = transformed_kinds_.get(key, /* default */ std::nullopt)) {
+    return *cached;
+  }
+
+  const Kind* base_kind = kind;
+  const TransformList* global_transforms = nullptr;
+  if (const auto* transform_kind = kind->as<TransformKind>()) {
+    // If the current kind is already a TransformKind, append existing
+    // local_transforms.
+    local_transforms = transforms_factory_.concat(
+        local_transforms, transform_kind->local_transforms());
+    global_transforms = transform_kind->global_transforms();
+    base_kind = transform_kind->base_kind();
+  } else if (kind->is<PropagationKind>()) {
+    // If the current kind is PropagationKind, set the transform as a global
+    // transform. This is done to track the next hops for propagation with
+    // trace.
+    global_transforms = local_transforms;
+    local_transforms = nullptr;
+  }
+
+  mt_assert(base_kind != nullptr);
+  const auto* transformed_kind = kind_factory.transform_kind(
+      base_kind, local_transforms, global_transforms);
+  const Kind* new_kind =
+      should_keep(transformed_kind) ? transformed_kind : nullptr;
+
+  // Concurrent computations for the same key find the same kind.
+  transformed_kinds_.emplace(key, new_kind);
+  return new_kind;
+}
+
 } // namespace marianatrench
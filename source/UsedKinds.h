@@ -7,6 +7,14 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/Compiler.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/IncludeMacros.h>
 #include <mariana-trench/KindFactory.h>
@@ -33,18 +41,6 @@ class UsedKinds {
       const Rules& rules,
       const TransformsFactory& transforms_factory);
 
-  /*
-   * Before the analysis begins, a context might contain Kinds that are built
-   * into the binary, or specified in a model generator, but aren't actually
-   * used in any rule. These can be removed to save memory/time.
-   */
-  std::size_t remove_unused_kinds(
-      const Rules& rules,
-      const KindFactory& kind_factory,
-      const Methods& methods,
-      ArtificialMethods& artificial_methods,
-      Registry& registry);
-
   std::size_t source_sink_size() const {
     return named_kind_to_transforms_.size();
   }
@@ -65,10 +61,28 @@ class UsedKinds {
 
   bool should_keep(const TransformKind* transform_kind) const;
 
+  /**
+   * Return the kind resulting from applying the local transforms to the given
+   * kind, or nullptr if it is not used by any rule. This is memoized, since
+   * the same transforms are applied at every flow through a propagation.
+   */
+  const Kind* MT_NULLABLE transform_kind(
+      const KindFactory& kind_factory,
+      const Kind* kind,
+      const TransformList* MT_NULLABLE local_transforms) const;
+
  private:
+  using TransformedKindKey = std::pair<const Kind*, const TransformList*>;
+
   const TransformsFactory& transforms_factory_;
   NamedKindToTransformsMap named_kind_to_transforms_;
   PropagationKindTransformsSet propagation_kind_to_transforms_;
+  // Results of `transform_kind`, nullptr if the kind is not used.
+  mutable ConcurrentMap<
+      TransformedKindKey,
+      std::optional<const Kind*>,
+      boost::hash<TransformedKindKey>>
+      transformed_kinds_;
 };
 
 } // namespace marianatrench
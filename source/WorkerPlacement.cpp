@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/OperatingSystem.h>
+#include <mariana-trench/WorkerPlacement.h>
+
+namespace marianatrench {
+
+namespace {
+
+std::atomic<std::size_t> next_placement_id = 0;
+
+} // namespace
+
+struct WorkerPlacement::PinnedThreads {
+  std::mutex mutex;
+  std::vector<std::pair<std::thread::native_handle_type, std::vector<int>>>
+      original_cpus;
+};
+
+WorkerPlacement::WorkerPlacement(
+    std::vector<std::vector<int>> node_cpus,
+    unsigned int threads)
+    : id_(next_placement_id++),
+      node_cpus_(std::move(node_cpus)),
+      threads_(std::max(threads, 1u)),
+      pinned_threads_(std::make_unique<PinnedThreads>()) {
+  // Every node needs at least one worker.
+  if (node_cpus_.size() > threads_) {
+    node_cpus_.resize(threads_);
+  }
+  // Hosts without NUMA information are a single node without pinning.
+  if (node_cpus_.empty()) {
+    node_cpus_.emplace_back();
+  }
+
+  auto nodes = node_cpus_.size();
+  for (std::size_t node = 0; node <= nodes; node++) {
+    first_worker_.push_back((node * threads_ + nodes - 1) / nodes);
+  }
+  next_worker_.assign(first_worker_.begin(), first_worker_.end() - 1);
+}
+
+WorkerPlacement::WorkerPlacement(WorkerPlacement&&) = default;
+
+WorkerPlacement::~WorkerPlacement() {
+  // Moved-from placements have no pinned threads.
+  if (pinned_threads_ == nullptr) {
+    return;
+  }
+  // Pool threads outlive the placement, so their handles are still valid.
+  for (const auto& [thread, cpus] : pinned_threads_->original_cpus) {
+    pin_thread(thread, cpus);
+  }
+}
+
+WorkerPlacement WorkerPlacement::from_host(unsigned int threads) {
+  auto node_cpus = numa_node_cpus();
+  if (node_cpus.empty()) {
+    WARNING(1, "Unable to find the NUMA nodes of the host.");
+  }
+  auto placement = WorkerPlacement(std::move(node_cpus), threads);
+  LOG(2,
+      "Placing {} worker threads on {} NUMA nodes.",
+      threads,
+      placement.nodes());
+  return placement;
+}
+
+std::size_t WorkerPlacement::nodes() const {
+  return node_cpus_.size();
+}
+
+std::size_t WorkerPlacement::node_of_worker(std::size_t worker_id) const {
+  mt_assert(worker_id < threads_);
+  return (worker_id * nodes()) / threads_;
+}
+
+std::size_t WorkerPlacement::next_worker(std::size_t node) {
+  mt_assert(node < nodes());
+  auto worker_id = next_worker_[node];
+  next_worker_[node] = worker_id + 1;
+  if (next_worker_[node] == first_worker_[node + 1]) {
+    next_worker_[node] = first_worker_[node];
+  }
+  return worker_id;
+}
+
+void WorkerPlacement::pin(std::size_t worker_id) const {
+  // Pool threads are shared by all work queues, and may run workers of
+  // different nodes or different placements over time.
+  thread_local std::optional<std::size_t> pinned_placement;
+  thread_local std::size_t pinned_node = 0;
+
+  auto node = node_of_worker(worker_id);
+  const auto& cpus = node_cpus_[node];
+  if (cpus.empty() || (pinned_placement == id_ && pinned_node == node)) {
+    return;
+  }
+
+  if (pinned_placement != id_) {
+    // Threads whose CPUs are unknown could not be restored.
+    auto original_cpus = current_thread_cpus();
+    if (original_cpus.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(pinned_threads_->mutex);
+    pinned_threads_->original_cpus.emplace_back(
+        current_thread_handle(), std::move(original_cpus));
+  }
+  // Failures are logged once per thread.
+  pin_current_thread(cpus);
+  pinned_placement = id_;
+  pinned_node = node;
+}
+
+} // namespace marianatrench
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Placement of the worker threads of a work queue on the NUMA nodes of the
+ * host, with `--pin-worker-threads`.
+ *
+ * Workers are assigned to nodes in contiguous blocks of (almost) equal size,
+ * and each worker thread is pinned to the CPUs of its node the first time it
+ * runs a task. Since memory is allocated on the node of the thread first
+ * touching it, the models built by a worker stay local to its node, as long as
+ * the items reading them are added to workers of the same node.
+ *
+ * Work queues run on the persistent threads of the `WorkerPool`, and worker 0
+ * is the thread calling `run_all`. The original CPUs of every pinned thread are
+ * restored when the placement is destroyed, at the end of the fixpoint.
+ */
+class WorkerPlacement final {
+ public:
+  /* Place `threads` workers on the nodes with the given CPUs. */
+  explicit WorkerPlacement(
+      std::vector<std::vector<int>> node_cpus,
+      unsigned int threads);
+
+  /* Place `threads` workers on the NUMA nodes of the host. */
+  static WorkerPlacement from_host(unsigned int threads);
+
+  WorkerPlacement(const WorkerPlacement&) = delete;
+  WorkerPlacement(WorkerPlacement&&);
+  WorkerPlacement& operator=(const WorkerPlacement&) = delete;
+  WorkerPlacement& operator=(WorkerPlacement&&) = delete;
+  ~WorkerPlacement();
+
+  /* Number of nodes with at least one worker. */
+  std::size_t nodes() const;
+
+  std::size_t node_of_worker(std::size_t worker_id) const;
+
+  /* Next worker of the given node to add an item to, in round robin. */
+  std::size_t next_worker(std::size_t node);
+
+  /*
+   * Pin the calling thread to the CPUs of the node of the given worker. This
+   * is a no-op if the thread is already pinned to that node.
+   */
+  void pin(std::size_t worker_id) const;
+
+ private:
+  struct PinnedThreads;
+
+  std::size_t id_;
+  std::vector<std::vector<int>> node_cpus_;
+  unsigned int threads_;
+  // Index of the first worker of each node, followed by `threads_`.
+  std::vector<std::size_t> first_worker_;
+  std::vector<std::size_t> next_worker_;
+  // Original CPUs of the threads pinned by `pin`.
+  std::unique_ptr<PinnedThreads> pinned_threads_;
+};
+
+} // namespace marianatrench
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <mariana-trench/WorkerPool.h>
+
+namespace marianatrench {
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  job_added_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+WorkerPool& WorkerPool::instance() {
+  static WorkerPool pool;
+  return pool;
+}
+
+void WorkerPool::run(
+    std::size_t workers,
+    const std::function<void(std::size_t)>& task) {
+  if (workers <= 1) {
+    task(0);
+    return;
+  }
+
+  Job job{&task, workers, /* next_worker */ 1, /* active_workers */ 0};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unstarted_workers_ += workers - 1;
+    while (idle_threads_ < unstarted_workers_) {
+      threads_.emplace_back([this]() { work(); });
+      idle_threads_++;
+    }
+    jobs_.push_back(&job);
+  }
+  job_added_.notify_all();
+
+  task(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // No other worker can start once the job is removed.
+  jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+  unstarted_workers_ -= job.workers - job.next_worker;
+  worker_done_.wait(lock, [&job]() { return job.active_workers == 0; });
+}
+
+void WorkerPool::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    Job* job = nullptr;
+    job_added_.wait(lock, [this, &job]() {
+      // Prefer the most recent jobs, which are nested in older jobs.
+      for (auto iterator = jobs_.rbegin(); iterator != jobs_.rend();
+           ++iterator) {
+        if ((*iterator)->next_worker < (*iterator)->workers) {
+          job = *iterator;
+          return true;
+        }
+      }
+      return shutdown_;
+    });
+    if (job == nullptr) {
+      return;
+    }
+
+    auto worker_id = job->next_worker++;
+    job->active_workers++;
+    idle_threads_--;
+    unstarted_workers_--;
+    lock.unlock();
+    (*job->task)(worker_id);
+    lock.lock();
+    job->active_workers--;
+    idle_threads_++;
+    worker_done_.notify_all();
+  }
+}
+
+} // namespace marianatrench
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sparta/WorkQueue.h>
+
+#include <mariana-trench/IncludeMacros.h>
+
+namespace marianatrench {
+
+/**
+ * Process-wide pool of threads shared by all parallel steps of the analysis.
+ *
+ * Threads are created on demand and persist across phases and global
+ * iterations, which removes the cost of spawning and joining threads for every
+ * step and lets thread-local data outlive a single step.
+ */
+class WorkerPool final {
+ private:
+  struct Job {
+    const std::function<void(std::size_t)>* task;
+    std::size_t workers;
+    std::size_t next_worker;
+    std::size_t active_workers;
+  };
+
+  WorkerPool() = default;
+
+ public:
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+  ~WorkerPool();
+
+  static WorkerPool& instance();
+
+  /**
+   * Run `task(worker_id)` for worker ids in `[0, workers)` and wait for them.
+   *
+   * Worker 0 runs on the calling thread. Other workers run on threads of the
+   * pool. Threads are started when there are fewer idle threads than workers
+   * waiting to start, so that jobs nested in busy or blocked workers of an
+   * outer job still run in parallel. Workers might start after worker 0 is
+   * done, hence the task of worker 0 must be able to complete the job alone.
+   */
+  void run(std::size_t workers, const std::function<void(std::size_t)>& task);
+
+ private:
+  void work();
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable job_added_;
+  std::condition_variable worker_done_;
+  std::vector<Job*> jobs_;
+  std::vector<std::thread> threads_;
+  // Threads waiting for a job.
+  std::size_t idle_threads_ = 0;
+  // Workers of the jobs that no thread has started yet.
+  std::size_t unstarted_workers_ = 0;
+  bool shutdown_ = false;
+};
+
+template <typename Input>
+class WorkQueue;
+
+/* State of a worker, given to tasks of a `WorkQueue`. */
+template <typename Input>
+class WorkerState final {
+ public:
+  explicit WorkerState(WorkQueue<Input>& queue, std::size_t worker_id)
+      : queue_(queue), worker_id_(worker_id) {}
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(WorkerState)
+
+  std::size_t worker_id() const {
+    return worker_id_;
+  }
+
+  /* Add an item to the queue of this worker while the queue is running. */
+  void push_task(Input input) {
+    queue_.push(worker_id_, std::move(input));
+  }
+
+ private:
+  WorkQueue<Input>& queue_;
+  std::size_t worker_id_;
+};
+
+/**
+ * Work-stealing queue running its items on the `WorkerPool`.
+ *
+ * This is a replacement for `sparta::work_queue` with the same interface.
+ * Items are distributed in a round-robin fashion unless a worker is given, and
+ * idle workers steal items from the other workers.
+ */
+template <typename Input>
+class WorkQueue final {
+ private:
+  struct WorkerItems {
+    std::mutex mutex;
+    std::deque<Input> items;
+  };
+
+ public:
+  explicit WorkQueue(
+      std::function<void(WorkerState<Input>*, Input&)> task,
+      unsigned int num_threads)
+      : task_(std::move(task)) {
+    for (unsigned int i = 0; i < std::max(num_threads, 1u); i++) {
+      workers_.push_back(std::make_unique<WorkerItems>());
+    }
+  }
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(WorkQueue)
+
+  void add_item(Input input) {
+    push(next_worker_++ % workers_.size(), std::move(input));
+  }
+
+  /* Add an item to the queue of the given worker, e.g. for placement. */
+  void add_item(Input input, std::size_t worker_id) {
+    push(worker_id % workers_.size(), std::move(input));
+  }
+
+  /* Run all items, including the ones pushed while running. */
+  void run_all() {
+    auto task = std::function<void(std::size_t)>(
+        [this](std::size_t worker_id) { run_worker(worker_id); });
+    WorkerPool::instance().run(workers_.size(), task);
+    if (exception_ != nullptr) {
+      std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+  }
+
+ private:
+  void push(std::size_t worker_id, Input input) {
+    pending_++;
+    {
+      std::lock_guard<std::mutex> lock(workers_[worker_id]->mutex);
+      workers_[worker_id]->items.push_back(std::move(input));
+      queued_++;
+    }
+    // Prevent lost wake ups, see `run_worker`.
+    { std::lock_guard<std::mutex> lock(idle_mutex_); }
+    idle_.notify_one();
+  }
+
+  std::optional<Input> pop(std::size_t worker_id) {
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+      auto& worker = *workers_[(worker_id + i) % workers_.size()];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (worker.items.empty()) {
+        continue;
+      }
+      // Own items are processed in order, stolen items from the back.
+      Input input = i == 0 ? std::move(worker.items.front())
+                           : std::move(worker.items.back());
+      if (i == 0) {
+        worker.items.pop_front();
+      } else {
+        worker.items.pop_back();
+      }
+      queued_--;
+      return input;
+    }
+    return std::nullopt;
+  }
+
+  void run_worker(std::size_t worker_id) {
+    WorkerState<Input> state(*this, worker_id);
+    while (pending_ > 0) {
+      auto input = pop(worker_id);
+      if (!input) {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_.wait(lock, [this]() { return pending_ == 0 || queued_ > 0; });
+        continue;
+      }
+
+      if (!failed_) {
+        try {
+          task_(&state, *input);
+        } catch (...) {
+          // Remaining items are dropped, and the first exception is rethrown.
+          if (!failed_.exchange(true)) {
+            exception_ = std::current_exception();
+          }
+        }
+      }
+
+      if (--pending_ == 0) {
+        { std::lock_guard<std::mutex> lock(idle_mutex_); }
+        idle_.notify_all();
+      }
+    }
+  }
+
+  friend class WorkerState<Input>;
+
+ private:
+  std::function<void(WorkerState<Input>*, Input&)> task_;
+  std::vector<std::unique_ptr<WorkerItems>> workers_;
+  std::size_t next_worker_ = 0;
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<bool> failed_{false};
+  std::exception_ptr exception_;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_;
+};
+
+/**
+ * Create a `WorkQueue` running `task` on `num_threads` workers. The task is
+ * called either with the item, or with the worker state and the item.
+ *
+ * Items can always be pushed while running, `push_tasks_while_running` is only
+ * kept for compatibility with `sparta::work_queue`.
+ */
+template <typename Input, typename Task>
+WorkQueue<Input> work_queue(
+    Task task,
+    unsigned int num_threads = sparta::parallel::default_num_threads(),
+    bool /* push_tasks_while_running */ = false) {
+  if constexpr (std::is_invocable_v<Task&, WorkerState<Input>*, Input&>) {
+    return WorkQueue<Input>(std::move(task), num_threads);
+  } else {
+    return WorkQueue<Input>(
+        [task = std::move(task)](WorkerState<Input>*, Input& input) mutable {
+          task(input);
+        },
+        num_threads);
+  }
+}
+
+} // namespace marianatrench
@@ -5,14 +5,26 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <mariana-trench/RE2.h>
 #include <mariana-trench/constraints/FieldConstraints.h>
 #include <mariana-trench/constraints/MethodConstraints.h>
 
 namespace marianatrench {
 
+FieldHashedSet FieldConstraint::may_satisfy(
+    const FieldMappings& /* field_mappings */) const {
+  return FieldHashedSet::top();
+}
+
 IsStaticFieldConstraint::IsStaticFieldConstraint(bool expected)
     : expected_(expected) {}
 
+FieldHashedSet IsStaticFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  return field_mappings.is_static_to_fields().get(
+      expected_, FieldHashedSet::bottom());
+}
+
 bool IsStaticFieldConstraint::satisfy(const Field* field) const {
   return ((field->dex_field()->get_access() & DexAccessFlags::ACC_STATIC) >
           0) == expected_;
@@ -30,6 +42,16 @@ bool IsStaticFieldConstraint::operator==(const FieldConstraint& other) const {
 FieldNameConstraint::FieldNameConstraint(const std::string& regex_string)
     : pattern_(regex_string) {}
 
+FieldHashedSet FieldNameConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  auto string_pattern = as_string_literal(pattern_);
+  if (!string_pattern) {
+    return FieldHashedSet::top();
+  }
+  return field_mappings.name_to_fields().get(
+      *string_pattern, FieldHashedSet::bottom());
+}
+
 bool FieldNameConstraint::satisfy(const Field* field) const {
   return re2::RE2::FullMatch(field->get_name(), pattern_);
 }
@@ -66,6 +88,12 @@ HasAnnotationFieldConstraint::HasAnnotationFieldConstraint(
     const std::optional<std::string>& annotation)
     : type_(type), annotation_(annotation) {}
 
+FieldHashedSet HasAnnotationFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  return field_mappings.annotation_type_to_fields().get(
+      type_, FieldHashedSet::bottom());
+}
+
 bool HasAnnotationFieldConstraint::satisfy(const Field* field) const {
   return has_annotation(field->dex_field()->get_anno_set(), type_, annotation_);
 }
@@ -87,6 +115,11 @@ ParentFieldConstraint::ParentFieldConstraint(
     std::unique_ptr<TypeConstraint> inner_constraint)
     : inner_constraint_(std::move(inner_constraint)) {}
 
+FieldHashedSet ParentFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  return inner_constraint_->may_satisfy_declaring_class(field_mappings);
+}
+
 bool ParentFieldConstraint::satisfy(const Field* field) const {
   return inner_constraint_->satisfy(field->get_class());
 }
@@ -104,6 +137,15 @@ AllOfFieldConstraint::AllOfFieldConstraint(
     std::vector<std::unique_ptr<FieldConstraint>> constraints)
     : constraints_(std::move(constraints)) {}
 
+FieldHashedSet AllOfFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  auto intersection_set = FieldHashedSet::top();
+  for (const auto& constraint : constraints_) {
+    intersection_set.meet_with(constraint->may_satisfy(field_mappings));
+  }
+  return intersection_set;
+}
+
 bool AllOfFieldConstraint::satisfy(const Field* field) const {
   return std::all_of(
       constraints_.begin(),
@@ -129,6 +171,17 @@ NotFieldConstraint::NotFieldConstraint(
     std::unique_ptr<FieldConstraint> constraint)
     : constraint_(std::move(constraint)) {}
 
+FieldHashedSet NotFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  auto child_fields = constraint_->may_satisfy(field_mappings);
+  if (child_fields.is_top() || child_fields.is_bottom()) {
+    return FieldHashedSet::top();
+  }
+  auto all_fields = field_mappings.all_fields();
+  all_fields.difference_with(child_fields);
+  return all_fields;
+}
+
 bool NotFieldConstraint::satisfy(const Field* field) const {
   return !constraint_->satisfy(field);
 }
@@ -146,6 +199,18 @@ AnyOfFieldConstraint::AnyOfFieldConstraint(
     std::vector<std::unique_ptr<FieldConstraint>> constraints)
     : constraints_(std::move(constraints)) {}
 
+FieldHashedSet AnyOfFieldConstraint::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  if (constraints_.empty()) {
+    return FieldHashedSet::top();
+  }
+  auto union_set = FieldHashedSet::bottom();
+  for (const auto& constraint : constraints_) {
+    union_set.join_with(constraint->may_satisfy(field_mappings));
+  }
+  return union_set;
+}
+
 bool AnyOfFieldConstraint::satisfy(const Field* field) const {
   // If there is no constraint, the field vacuously satisfies the constraint
   // This is different from the semantic of std::any_of
@@ -10,6 +10,7 @@
 #include <re2/re2.h>
 
 #include <mariana-trench/Field.h>
+#include <mariana-trench/FieldMappings.h>
 #include <mariana-trench/constraints/TypeConstraints.h>
 
 namespace marianatrench {
@@ -25,6 +26,8 @@ class FieldConstraint {
 
   static std::unique_ptr<FieldConstraint> from_json(
       const Json::Value& constraint);
+  /* Returns the candidate fields for `satisfy`, or top if they are unknown. */
+  virtual FieldHashedSet may_satisfy(const FieldMappings& field_mappings) const;
   virtual bool satisfy(const Field* field) const = 0;
   virtual bool operator==(const FieldConstraint& other) const = 0;
 };
@@ -32,6 +35,8 @@ class FieldConstraint {
 class FieldNameConstraint final : public FieldConstraint {
  public:
   explicit FieldNameConstraint(const std::string& regex_string);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -42,6 +47,8 @@ class FieldNameConstraint final : public FieldConstraint {
 class IsStaticFieldConstraint final : public FieldConstraint {
  public:
   explicit IsStaticFieldConstraint(bool expected);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -64,6 +71,8 @@ class HasAnnotationFieldConstraint final : public FieldConstraint {
   explicit HasAnnotationFieldConstraint(
       const std::string& type,
       const std::optional<std::string>& annotation);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -76,6 +85,8 @@ class ParentFieldConstraint final : public FieldConstraint {
  public:
   explicit ParentFieldConstraint(
       std::unique_ptr<TypeConstraint> inner_constraint);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -87,6 +98,8 @@ class AllOfFieldConstraint final : public FieldConstraint {
  public:
   explicit AllOfFieldConstraint(
       std::vector<std::unique_ptr<FieldConstraint>> constraints);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -97,6 +110,8 @@ class AllOfFieldConstraint final : public FieldConstraint {
 class NotFieldConstraint final : public FieldConstraint {
  public:
   explicit NotFieldConstraint(std::unique_ptr<FieldConstraint> constraint);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -108,6 +123,8 @@ class AnyOfFieldConstraint final : public FieldConstraint {
  public:
   explicit AnyOfFieldConstraint(
       std::vector<std::unique_ptr<FieldConstraint>> constraints);
+  FieldHashedSet may_satisfy(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const Field* field) const override;
   bool operator==(const FieldConstraint& other) const override;
 
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+
+#include <mariana-trench/Assert.h>
+#include <mariana-trench/Log.h>
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/constraints/MethodConstraintMatcher.h>
+
+namespace marianatrench {
+
+namespace {
+
+enum class Evaluation : std::uint8_t { Unknown, Satisfied, Unsatisfied };
+
+/* Per-worker state, reused across methods. */
+struct MatcherState {
+  std::vector<Evaluation> evaluations;
+  std::vector<std::size_t> evaluated;
+  std::vector<std::pair<std::size_t, const Method*>> matches;
+  std::vector<int> matched_patterns;
+};
+
+} // namespace
+
+std::size_t MethodConstraintMatcher::add(
+    const AllOfMethodConstraint& constraint) {
+  std::vector<std::size_t> conjunction;
+  for (const auto* child : constraint.children()) {
+    auto found = std::find_if(
+        constraints_.begin(),
+        constraints_.end(),
+        [child](const MethodConstraint* existing) {
+          return typeid(*existing) == typeid(*child) && *existing == *child;
+        });
+    if (found == constraints_.end()) {
+      conjunction.push_back(constraints_.size());
+      constraints_.push_back(child);
+      constraint_pattern_kinds_.push_back(std::nullopt);
+      if (const auto* method_pattern =
+              dynamic_cast<const MethodPatternConstraint*>(child)) {
+        add_pattern(PatternKind::Name, method_pattern->pattern());
+      } else if (
+          const auto* signature_pattern =
+              dynamic_cast<const SignaturePatternConstraint*>(child)) {
+        add_pattern(PatternKind::Signature, signature_pattern->pattern());
+      }
+    } else {
+      conjunction.push_back(found - constraints_.begin());
+    }
+  }
+  conjunctions_.push_back(std::move(conjunction));
+  return conjunctions_.size() - 1;
+}
+
+void MethodConstraintMatcher::add_pattern(
+    PatternKind kind,
+    const re2::RE2& pattern) {
+  auto& pattern_set = pattern_sets_[static_cast<std::size_t>(kind)];
+  if (pattern_set.set == nullptr) {
+    pattern_set.set = std::make_unique<re2::RE2::Set>(
+        pattern.options(), re2::RE2::ANCHOR_BOTH);
+  }
+
+  // Patterns that cannot be added to the set are matched individually.
+  if (pattern_set.set->Add(pattern.pattern(), /* error */ nullptr) < 0) {
+    return;
+  }
+  pattern_set.constraints.push_back(constraints_.size() - 1);
+  constraint_pattern_kinds_.back() = kind;
+}
+
+void MethodConstraintMatcher::run(const Methods& methods) {
+  LOG(1,
+      "Matching {} model generators with {} distinct constraints...",
+      conjunctions_.size(),
+      constraints_.size());
+
+  for (auto& pattern_set : pattern_sets_) {
+    if (pattern_set.set == nullptr || pattern_set.set->Compile()) {
+      continue;
+    }
+    WARNING(1, "Unable to compile pattern set, matching patterns one by one.");
+    for (auto index : pattern_set.constraints) {
+      constraint_pattern_kinds_[index] = std::nullopt;
+    }
+    pattern_set.set = nullptr;
+    pattern_set.constraints.clear();
+  }
+
+  matches_.assign(conjunctions_.size(), {});
+  if (conjunctions_.empty()) {
+    return;
+  }
+
+  auto number_of_threads = sparta::parallel::default_num_threads();
+  std::vector<MatcherState> worker_states(number_of_threads);
+  for (auto& worker_state : worker_states) {
+    worker_state.evaluations.resize(constraints_.size(), Evaluation::Unknown);
+  }
+
+  auto queue = work_queue<const Method*>(
+      [&](WorkerState<const Method*>* worker_state, const Method* method) {
+        auto& state = worker_states[worker_state->worker_id()];
+
+        // Evaluate all patterns of the given kind at once.
+        auto match_patterns = [&](PatternKind kind) {
+          const auto& pattern_set =
+              pattern_sets_[static_cast<std::size_t>(kind)];
+          for (auto index : pattern_set.constraints) {
+            state.evaluations[index] = Evaluation::Unsatisfied;
+            state.evaluated.push_back(index);
+          }
+
+          auto text = kind == PatternKind::Name
+              ? method->get_name()
+              : std::string_view(method->signature());
+          state.matched_patterns.clear();
+          pattern_set.set->Match(text, &state.matched_patterns);
+          for (auto pattern : state.matched_patterns) {
+            state.evaluations[pattern_set.constraints[pattern]] =
+                Evaluation::Satisfied;
+          }
+        };
+
+        auto satisfy = [&](std::size_t index) {
+          auto& evaluation = state.evaluations[index];
+          if (evaluation != Evaluation::Unknown) {
+            return evaluation == Evaluation::Satisfied;
+          }
+
+          if (auto kind = constraint_pattern_kinds_[index]) {
+            match_patterns(*kind);
+          } else {
+            evaluation = constraints_[index]->satisfy(method)
+                ? Evaluation::Satisfied
+                : Evaluation::Unsatisfied;
+            state.evaluated.push_back(index);
+          }
+          return evaluation == Evaluation::Satisfied;
+        };
+
+        for (std::size_t conjunction = 0; conjunction < conjunctions_.size();
+             conjunction++) {
+          const auto& indices = conjunctions_[conjunction];
+          if (std::all_of(indices.begin(), indices.end(), satisfy)) {
+            state.matches.emplace_back(conjunction, method);
+          }
+        }
+
+        // Reset the evaluations of this method.
+        for (auto index : state.evaluated) {
+          state.evaluations[index] = Evaluation::Unknown;
+        }
+        state.evaluated.clear();
+      },
+      number_of_threads);
+  for (const auto* method : methods) {
+    queue.add_item(method);
+  }
+  queue.run_all();
+
+  for (auto& worker_state : worker_states) {
+    for (const auto& [conjunction, method] : worker_state.matches) {
+      matches_[conjunction].push_back(method);
+    }
+  }
+}
+
+const std::vector<const Method*>& MethodConstraintMatcher::matches(
+    std::size_t conjunction) const {
+  mt_assert(conjunction < matches_.size());
+  return matches_[conjunction];
+}
+
+} // namespace marianatrench
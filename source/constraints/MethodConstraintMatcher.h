@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <re2/set.h>
+
+#include <mariana-trench/IncludeMacros.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/constraints/MethodConstraints.h>
+
+namespace marianatrench {
+
+/**
+ * Matches many conjunctions of method constraints against all methods in a
+ * single pass.
+ *
+ * Json model generators often share the same constraints (e.g, the same
+ * parent or name pattern). Equal constraints are only stored once, and are
+ * evaluated at most once per method, their result being shared by all
+ * conjunctions that use them.
+ *
+ * Name and signature pattern constraints are compiled into one `re2::RE2::Set`
+ * per kind, so that all patterns of a kind are matched in a single scan of the
+ * method name or signature.
+ */
+class MethodConstraintMatcher final {
+ public:
+  MethodConstraintMatcher() = default;
+
+  DELETE_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(MethodConstraintMatcher)
+
+  /**
+   * Add the conjunction of the children of the given constraint and return its
+   * index. The constraint must outlive the matcher.
+   */
+  std::size_t add(const AllOfMethodConstraint& constraint);
+
+  /* Number of distinct constraints across all conjunctions. */
+  std::size_t number_of_distinct_constraints() const {
+    return constraints_.size();
+  }
+
+  /* Find the methods satisfying each conjunction. */
+  void run(const Methods& methods);
+
+  /* Return the methods satisfying the given conjunction, after `run`. */
+  const std::vector<const Method*>& matches(std::size_t conjunction) const;
+
+ private:
+  /* Patterns of a given kind, matched together. */
+  struct PatternSet {
+    std::unique_ptr<re2::RE2::Set> set;
+    /* Constraint index of each pattern in the set. */
+    std::vector<std::size_t> constraints;
+  };
+
+  enum class PatternKind : std::size_t { Name = 0, Signature = 1 };
+  static constexpr std::size_t k_number_of_pattern_kinds = 2;
+
+  /* Add the pattern of the last added constraint to the given set. */
+  void add_pattern(PatternKind kind, const re2::RE2& pattern);
+
+ private:
+  std::vector<const MethodConstraint*> constraints_;
+  /* Pattern set of each constraint, if any. */
+  std::vector<std::optional<PatternKind>> constraint_pattern_kinds_;
+  std::array<PatternSet, k_number_of_pattern_kinds> pattern_sets_;
+  std::vector<std::vector<std::size_t>> conjunctions_;
+  std::vector<std::vector<const Method*>> matches_;
+};
+
+} // namespace marianatrench
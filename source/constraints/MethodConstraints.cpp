@@ -47,6 +47,22 @@ bool has_annotation(
   return false;
 }
 
+namespace {
+
+MethodHashedSet filter_methods(
+    const MethodHashedSet& candidates,
+    const MethodConstraint& constraint) {
+  auto methods = MethodHashedSet::bottom();
+  for (const auto* method : candidates.elements()) {
+    if (constraint.satisfy(method)) {
+      methods.add(method);
+    }
+  }
+  return methods;
+}
+
+} // namespace
+
 MethodPatternConstraint::MethodPatternConstraint(
     const std::string& regex_string)
     : pattern_(regex_string) {}
@@ -261,6 +277,18 @@ NumberParametersConstraint::NumberParametersConstraint(
     IntegerConstraint constraint)
     : constraint_(constraint){};
 
+MethodHashedSet NumberParametersConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  auto union_set = MethodHashedSet::bottom();
+  for (const auto& [number_of_parameters, methods] :
+       method_mappings.number_of_parameters_to_methods()) {
+    if (constraint_.satisfy(number_of_parameters)) {
+      union_set.join_with(methods);
+    }
+  }
+  return union_set;
+}
+
 bool NumberParametersConstraint::satisfy(const Method* method) const {
   return constraint_.satisfy(method->number_of_parameters());
 }
@@ -296,6 +324,12 @@ bool NumberOverridesConstraint::operator==(
 
 IsStaticConstraint::IsStaticConstraint(bool expected) : expected_(expected) {}
 
+MethodHashedSet IsStaticConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  return method_mappings.is_static_to_methods().get(
+      expected_, MethodHashedSet::bottom());
+}
+
 bool IsStaticConstraint::satisfy(const Method* method) const {
   return method->is_static() == expected_;
 }
@@ -312,6 +346,12 @@ bool IsStaticConstraint::operator==(const MethodConstraint& other) const {
 IsConstructorConstraint::IsConstructorConstraint(bool expected)
     : expected_(expected) {}
 
+MethodHashedSet IsConstructorConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  return method_mappings.is_constructor_to_methods().get(
+      expected_, MethodHashedSet::bottom());
+}
+
 bool IsConstructorConstraint::satisfy(const Method* method) const {
   return method->is_constructor() == expected_;
 }
@@ -388,6 +428,17 @@ NthParameterConstraint::NthParameterConstraint(
     std::unique_ptr<ParameterConstraint> inner_constraint)
     : index_(index), inner_constraint_(std::move(inner_constraint)) {}
 
+MethodHashedSet NthParameterConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  // Candidates have a matching parameter at some position. Keep the exact
+  // matches, since `NotMethodConstraint` relies on precise sets.
+  auto candidates = inner_constraint_->may_satisfy(method_mappings);
+  if (candidates.is_top()) {
+    return candidates;
+  }
+  return filter_methods(candidates, *this);
+}
+
 bool NthParameterConstraint::satisfy(const Method* method) const {
   const auto* type = method->parameter_type(index_);
   const auto* annotations_set = method->get_parameter_annotations(index_);
@@ -411,6 +462,17 @@ AnyParameterConstraint::AnyParameterConstraint(
     : start_index_(start_index),
       inner_constraint_(std::move(inner_constraint)) {}
 
+MethodHashedSet AnyParameterConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  // Candidates have a matching parameter at some position. Keep the exact
+  // matches, since `NotMethodConstraint` relies on precise sets.
+  auto candidates = inner_constraint_->may_satisfy(method_mappings);
+  if (candidates.is_top()) {
+    return candidates;
+  }
+  return filter_methods(candidates, *this);
+}
+
 bool AnyParameterConstraint::satisfy(const Method* method) const {
   ParameterPosition i;
   // always exclude `this`
@@ -446,8 +508,7 @@ MethodHashedSet SignaturePatternConstraint::may_satisfy(
   if (!string_pattern) {
     return MethodHashedSet::top();
   }
-  return method_mappings.signature_to_methods().get(
-      *string_pattern, MethodHashedSet::bottom());
+  return method_mappings.signature_to_methods(*string_pattern);
 }
 
 bool SignaturePatternConstraint::satisfy(const Method* method) const {
@@ -468,6 +529,12 @@ ReturnConstraint::ReturnConstraint(
     std::unique_ptr<TypeConstraint> inner_constraint)
     : inner_constraint_(std::move(inner_constraint)) {}
 
+MethodHashedSet ReturnConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  return inner_constraint_->may_satisfy(
+      method_mappings, MaySatisfyMethodConstraintKind::Return);
+}
+
 bool ReturnConstraint::satisfy(const Method* method) const {
   return inner_constraint_->satisfy(method->get_proto()->get_rtype());
 }
@@ -514,6 +581,18 @@ VisibilityMethodConstraint::VisibilityMethodConstraint(
     DexAccessFlags visibility)
     : visibility_(visibility) {}
 
+MethodHashedSet VisibilityMethodConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  auto union_set = MethodHashedSet::bottom();
+  for (const auto& [visibility, methods] :
+       method_mappings.visibility_to_methods()) {
+    if (visibility & visibility_) {
+      union_set.join_with(methods);
+    }
+  }
+  return union_set;
+}
+
 bool VisibilityMethodConstraint::satisfy(const Method* method) const {
   return method->get_access() & visibility_;
 }
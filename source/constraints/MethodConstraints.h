@@ -51,6 +51,10 @@ class MethodPatternConstraint final : public MethodConstraint {
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
+  const re2::RE2& pattern() const {
+    return pattern_;
+  }
+
  private:
   re2::RE2 pattern_;
 };
@@ -126,6 +130,8 @@ class NotMethodConstraint final : public MethodConstraint {
 class NumberParametersConstraint final : public MethodConstraint {
  public:
   explicit NumberParametersConstraint(IntegerConstraint constraint);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -149,6 +155,8 @@ class NumberOverridesConstraint final : public MethodConstraint {
 class IsStaticConstraint final : public MethodConstraint {
  public:
   explicit IsStaticConstraint(bool expected);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -159,6 +167,8 @@ class IsStaticConstraint final : public MethodConstraint {
 class IsConstructorConstraint final : public MethodConstraint {
  public:
   explicit IsConstructorConstraint(bool expected);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -206,6 +216,8 @@ class NthParameterConstraint final : public MethodConstraint {
   NthParameterConstraint(
       ParameterPosition index,
       std::unique_ptr<ParameterConstraint> inner_constraint);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -219,6 +231,8 @@ class AnyParameterConstraint final : public MethodConstraint {
   AnyParameterConstraint(
       std::optional<ParameterPosition> start_index,
       std::unique_ptr<ParameterConstraint> inner_constraint);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -235,6 +249,10 @@ class SignaturePatternConstraint final : public MethodConstraint {
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
+  const re2::RE2& pattern() const {
+    return pattern_;
+  }
+
  private:
   re2::RE2 pattern_;
 };
@@ -242,6 +260,8 @@ class SignaturePatternConstraint final : public MethodConstraint {
 class ReturnConstraint final : public MethodConstraint {
  public:
   explicit ReturnConstraint(std::unique_ptr<TypeConstraint> inner_constraint);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -262,6 +282,8 @@ class MethodHasStringConstraint final : public MethodConstraint {
 class VisibilityMethodConstraint final : public MethodConstraint {
  public:
   explicit VisibilityMethodConstraint(DexAccessFlags visibility);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(const Method* method) const override;
   bool operator==(const MethodConstraint& other) const override;
 
@@ -11,10 +11,24 @@
 
 namespace marianatrench {
 
+MethodHashedSet ParameterConstraint::may_satisfy(
+    const MethodMappings& /* method_mappings */) const {
+  return MethodHashedSet::top();
+}
+
 AllOfParameterConstraint::AllOfParameterConstraint(
     std::vector<std::unique_ptr<ParameterConstraint>> constraints)
     : constraints_(std::move(constraints)) {}
 
+MethodHashedSet AllOfParameterConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  auto intersection_set = MethodHashedSet::top();
+  for (const auto& constraint : constraints_) {
+    intersection_set.meet_with(constraint->may_satisfy(method_mappings));
+  }
+  return intersection_set;
+}
+
 bool AllOfParameterConstraint::satisfy(
     const DexAnnotationSet* MT_NULLABLE annotations_set,
     const DexType* type) const {
@@ -45,6 +59,18 @@ AnyOfParameterConstraint::AnyOfParameterConstraint(
     std::vector<std::unique_ptr<ParameterConstraint>> constraints)
     : constraints_(std::move(constraints)) {}
 
+MethodHashedSet AnyOfParameterConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  if (constraints_.empty()) {
+    return MethodHashedSet::top();
+  }
+  auto union_set = MethodHashedSet::bottom();
+  for (const auto& constraint : constraints_) {
+    union_set.join_with(constraint->may_satisfy(method_mappings));
+  }
+  return union_set;
+}
+
 bool AnyOfParameterConstraint::satisfy(
     const DexAnnotationSet* MT_NULLABLE annotations_set,
     const DexType* type) const {
@@ -126,6 +152,12 @@ TypeParameterConstraint::TypeParameterConstraint(
     std::unique_ptr<TypeConstraint> inner_constraint)
     : inner_constraint_(std::move(inner_constraint)) {}
 
+MethodHashedSet TypeParameterConstraint::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  return inner_constraint_->may_satisfy(
+      method_mappings, MaySatisfyMethodConstraintKind::Parameter);
+}
+
 bool TypeParameterConstraint::satisfy(
     const DexAnnotationSet* MT_NULLABLE /* unused */,
     const DexType* type) const {
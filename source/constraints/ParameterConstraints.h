@@ -22,6 +22,12 @@ class ParameterConstraint {
 
   static std::unique_ptr<ParameterConstraint> from_json(
       const Json::Value& constraint);
+  /**
+   * Returns a superset of the methods with a parameter at any position that
+   * satisfies this constraint, or top if it cannot be determined.
+   */
+  virtual MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const;
   virtual bool satisfy(
       const DexAnnotationSet* MT_NULLABLE annotations_set,
       const DexType* type) const = 0;
@@ -33,6 +39,8 @@ class AllOfParameterConstraint final : public ParameterConstraint {
  public:
   explicit AllOfParameterConstraint(
       std::vector<std::unique_ptr<ParameterConstraint>> constraints);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(
       const DexAnnotationSet* MT_NULLABLE annotations_set,
       const DexType* type) const override;
@@ -46,6 +54,8 @@ class AnyOfParameterConstraint final : public ParameterConstraint {
  public:
   explicit AnyOfParameterConstraint(
       std::vector<std::unique_ptr<ParameterConstraint>> constraints);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(
       const DexAnnotationSet* MT_NULLABLE annotations_set,
       const DexType* type) const override;
@@ -87,6 +97,8 @@ class TypeParameterConstraint final : public ParameterConstraint {
  public:
   explicit TypeParameterConstraint(
       std::unique_ptr<TypeConstraint> inner_constraint);
+  MethodHashedSet may_satisfy(
+      const MethodMappings& method_mappings) const override;
   bool satisfy(
       const DexAnnotationSet* MT_NULLABLE /* unused */,
       const DexType* type) const override;
@@ -19,6 +19,11 @@ MethodHashedSet TypeConstraint::may_satisfy(
   return MethodHashedSet::top();
 }
 
+FieldHashedSet TypeConstraint::may_satisfy_declaring_class(
+    const FieldMappings& /* field_mappings */) const {
+  return FieldHashedSet::top();
+}
+
 TypePatternConstraint::TypePatternConstraint(const std::string& regex_string)
     : pattern_(regex_string) {}
 
@@ -36,10 +41,26 @@ MethodHashedSet TypePatternConstraint::may_satisfy(
     case MaySatisfyMethodConstraintKind::Extends:
       return method_mappings.class_to_override_methods().get(
           *string_pattern, MethodHashedSet::bottom());
+    case MaySatisfyMethodConstraintKind::Return:
+      return method_mappings.return_type_to_methods().get(
+          *string_pattern, MethodHashedSet::bottom());
+    case MaySatisfyMethodConstraintKind::Parameter:
+      return method_mappings.parameter_type_to_methods().get(
+          *string_pattern, MethodHashedSet::bottom());
   }
   mt_unreachable();
 }
 
+FieldHashedSet TypePatternConstraint::may_satisfy_declaring_class(
+    const FieldMappings& field_mappings) const {
+  auto string_pattern = as_string_literal(pattern_);
+  if (!string_pattern) {
+    return FieldHashedSet::top();
+  }
+  return field_mappings.class_to_fields().get(
+      *string_pattern, FieldHashedSet::bottom());
+}
+
 bool TypePatternConstraint::satisfy(const DexType* type) const {
   return re2::RE2::FullMatch(type->str(), pattern_);
 }
@@ -66,10 +87,21 @@ MethodHashedSet TypeNameConstraint::may_satisfy(
     case MaySatisfyMethodConstraintKind::Extends:
       return method_mappings.class_to_override_methods().get(
           name_, MethodHashedSet::bottom());
+    case MaySatisfyMethodConstraintKind::Return:
+      return method_mappings.return_type_to_methods().get(
+          name_, MethodHashedSet::bottom());
+    case MaySatisfyMethodConstraintKind::Parameter:
+      return method_mappings.parameter_type_to_methods().get(
+          name_, MethodHashedSet::bottom());
   }
   mt_unreachable();
 }
 
+FieldHashedSet TypeNameConstraint::may_satisfy_declaring_class(
+    const FieldMappings& field_mappings) const {
+  return field_mappings.class_to_fields().get(name_, FieldHashedSet::bottom());
+}
+
 bool TypeNameConstraint::satisfy(const DexType* type) const {
   return type->str() == name_;
 }
@@ -114,9 +146,18 @@ ExtendsConstraint::ExtendsConstraint(
 
 MethodHashedSet ExtendsConstraint::may_satisfy(
     const MethodMappings& method_mappings,
-    MaySatisfyMethodConstraintKind /* constraint_kind */) const {
-  return inner_constraint_->may_satisfy(
-      method_mappings, MaySatisfyMethodConstraintKind::Extends);
+    MaySatisfyMethodConstraintKind constraint_kind) const {
+  switch (constraint_kind) {
+    case MaySatisfyMethodConstraintKind::Parent:
+    case MaySatisfyMethodConstraintKind::Extends:
+      return inner_constraint_->may_satisfy(
+          method_mappings, MaySatisfyMethodConstraintKind::Extends);
+    case MaySatisfyMethodConstraintKind::Return:
+    case MaySatisfyMethodConstraintKind::Parameter:
+      // There is no index on the parents of return or parameter types.
+      return MethodHashedSet::top();
+  }
+  mt_unreachable();
 };
 
 bool ExtendsConstraint::satisfy(const DexType* type) const {
@@ -240,6 +281,16 @@ MethodHashedSet AllOfTypeConstraint::may_satisfy(
   return intersection_set;
 }
 
+FieldHashedSet AllOfTypeConstraint::may_satisfy_declaring_class(
+    const FieldMappings& field_mappings) const {
+  auto intersection_set = FieldHashedSet::top();
+  for (const auto& constraint : inner_constraints_) {
+    intersection_set.meet_with(
+        constraint->may_satisfy_declaring_class(field_mappings));
+  }
+  return intersection_set;
+}
+
 bool AllOfTypeConstraint::satisfy(const DexType* type) const {
   return std::all_of(
       inner_constraints_.begin(),
@@ -279,6 +330,19 @@ MethodHashedSet AnyOfTypeConstraint::may_satisfy(
   return union_set;
 }
 
+FieldHashedSet AnyOfTypeConstraint::may_satisfy_declaring_class(
+    const FieldMappings& field_mappings) const {
+  if (inner_constraints_.empty()) {
+    return FieldHashedSet::top();
+  }
+  auto union_set = FieldHashedSet::bottom();
+  for (const auto& constraint : inner_constraints_) {
+    union_set.join_with(
+        constraint->may_satisfy_declaring_class(field_mappings));
+  }
+  return union_set;
+}
+
 bool AnyOfTypeConstraint::satisfy(const DexType* type) const {
   // If there is no constraint, the type vacuously satisfies the constraint
   // This is different from the semantic of std::any_of
@@ -311,6 +375,10 @@ NotTypeConstraint::NotTypeConstraint(std::unique_ptr<TypeConstraint> constraint)
 MethodHashedSet NotTypeConstraint::may_satisfy(
     const MethodMappings& method_mappings,
     MaySatisfyMethodConstraintKind constraint_kind) const {
+  if (constraint_kind == MaySatisfyMethodConstraintKind::Parameter) {
+    // The complement of an over-approximation is not an over-approximation.
+    return MethodHashedSet::top();
+  }
   MethodHashedSet child_methods =
       constraint_->may_satisfy(method_mappings, constraint_kind);
   if (child_methods.is_top() || child_methods.is_bottom()) {
@@ -321,6 +389,17 @@ MethodHashedSet NotTypeConstraint::may_satisfy(
   return all_methods;
 }
 
+FieldHashedSet NotTypeConstraint::may_satisfy_declaring_class(
+    const FieldMappings& field_mappings) const {
+  auto child_fields = constraint_->may_satisfy_declaring_class(field_mappings);
+  if (child_fields.is_top() || child_fields.is_bottom()) {
+    return FieldHashedSet::top();
+  }
+  auto all_fields = field_mappings.all_fields();
+  all_fields.difference_with(child_fields);
+  return all_fields;
+}
+
 bool NotTypeConstraint::satisfy(const DexType* type) const {
   return !constraint_->satisfy(type);
 }
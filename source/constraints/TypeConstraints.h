@@ -11,6 +11,7 @@
 
 #include <mariana-trench/Access.h>
 #include <mariana-trench/Context.h>
+#include <mariana-trench/FieldMappings.h>
 #include <mariana-trench/Model.h>
 #include <mariana-trench/constraints/IntegerConstraint.h>
 #include <mariana-trench/model-generator/ModelGenerator.h>
@@ -20,6 +21,9 @@ namespace marianatrench {
 enum class MaySatisfyMethodConstraintKind {
   Parent,
   Extends,
+  Return,
+  /* Over-approximates to methods with the type at any parameter position. */
+  Parameter,
 };
 
 class TypeConstraint {
@@ -36,6 +40,9 @@ class TypeConstraint {
   virtual MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const;
+  /* Candidate fields whose declaring class may satisfy the constraint. */
+  virtual FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const;
   virtual bool satisfy(const DexType* type) const = 0;
   virtual bool operator==(const TypeConstraint& other) const = 0;
 };
@@ -46,6 +53,8 @@ class TypePatternConstraint final : public TypeConstraint {
   MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const override;
+  FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const DexType* type) const override;
   bool operator==(const TypeConstraint& other) const override;
 
@@ -59,6 +68,8 @@ class TypeNameConstraint final : public TypeConstraint {
   MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const override;
+  FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const DexType* type) const override;
   bool operator==(const TypeConstraint& other) const override;
 
@@ -146,6 +157,8 @@ class AllOfTypeConstraint final : public TypeConstraint {
   MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const override;
+  FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const DexType* type) const override;
   bool operator==(const TypeConstraint& other) const override;
 
@@ -160,6 +173,8 @@ class AnyOfTypeConstraint final : public TypeConstraint {
   MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const override;
+  FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const DexType* type) const override;
   bool operator==(const TypeConstraint& other) const override;
 
@@ -173,6 +188,8 @@ class NotTypeConstraint final : public TypeConstraint {
   MethodHashedSet may_satisfy(
       const MethodMappings& method_mappings,
       MaySatisfyMethodConstraintKind constraint_kind) const override;
+  FieldHashedSet may_satisfy_declaring_class(
+      const FieldMappings& field_mappings) const override;
   bool satisfy(const DexType* type) const override;
   bool operator==(const TypeConstraint& other) const override;
 
@@ -5,17 +5,26 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+
 #include <mariana-trench/Model.h>
 #include <mariana-trench/model-generator/BuilderPatternGenerator.h>
 #include <mariana-trench/model-generator/ReturnsThisAnalyzer.h>
 
 namespace marianatrench {
 
+namespace {
+
+// The generator has no configuration.
+constexpr std::size_t k_configuration_hash = 0;
+
+} // namespace
+
 std::vector<Model> BuilderPatternGenerator::visit_method(
     const Method* method) const {
   std::vector<Model> models;
 
-  if (returns_this_analyzer::method_returns_this(method)) {
+  if (returns_this(method)) {
     models.push_back(
         Model(method, context_, Model::Mode::AliasMemoryLocationOnInvoke));
   }
@@ -23,4 +32,43 @@ std::vector<Model> BuilderPatternGenerator::visit_method(
   return models;
 }
 
+void BuilderPatternGenerator::load_cache(const ModelGeneratorCache& cache) {
+  auto matches = cache.load(name_, k_configuration_hash, context_);
+  if (!matches || matches->methods.size() != 1 || !matches->fields.empty()) {
+    return;
+  }
+  cached_methods_.emplace(
+      matches->methods.front().begin(), matches->methods.front().end());
+}
+
+void BuilderPatternGenerator::store_cache(
+    const ModelGeneratorCache& cache) const {
+  if (cached_methods_) {
+    return;
+  }
+
+  std::vector<const Method*> methods(methods_.begin(), methods_.end());
+  std::sort(
+      methods.begin(), methods.end(), [](const auto* left, const auto* right) {
+        return left->show() < right->show();
+      });
+  cache.store(
+      name_,
+      k_configuration_hash,
+      ModelGeneratorCache::Matches{
+          /* methods */ {std::move(methods)}, /* fields */ {}});
+}
+
+bool BuilderPatternGenerator::returns_this(const Method* method) const {
+  if (cached_methods_) {
+    return cached_methods_->count(method) > 0;
+  }
+
+  if (!returns_this_analyzer::method_returns_this(method)) {
+    return false;
+  }
+  methods_.insert(method);
+  return true;
+}
+
 } // namespace marianatrench
@@ -7,16 +7,41 @@
 
 #pragma once
 
+#include <optional>
+#include <unordered_set>
+
+#include <ConcurrentContainers.h>
+
+#include <mariana-trench/ModelGeneratorCache.h>
 #include <mariana-trench/model-generator/ModelGenerator.h>
 
 namespace marianatrench {
 
+/**
+ * Infers `alias-memory-location-on-invoke` for methods returning `this`.
+ *
+ * The methods returning `this` are stored in the model generator cache, so
+ * that the analysis of their bodies is skipped by the next runs on the same
+ * code.
+ */
 class BuilderPatternGenerator : public MethodVisitorModelGenerator {
  public:
   explicit BuilderPatternGenerator(Context& context)
       : MethodVisitorModelGenerator("BuilderPatternGenerator", context) {}
 
   std::vector<Model> visit_method(const Method* method) const override;
+
+  void load_cache(const ModelGeneratorCache& cache) override;
+  void store_cache(const ModelGeneratorCache& cache) const override;
+
+ private:
+  bool returns_this(const Method* method) const;
+
+ private:
+  /* Methods returning `this` according to the cache, if it is valid. */
+  std::optional<std::unordered_set<const Method*>> cached_methods_;
+  /* Methods returning `this` found by this run, recorded for the cache. */
+  mutable ConcurrentSet<const Method*> methods_;
 };
 
 } // namespace marianatrench
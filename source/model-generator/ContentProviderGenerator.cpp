@@ -11,6 +11,7 @@
 
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/WorkerPool.h>
 #include <mariana-trench/model-generator/ContentProviderGenerator.h>
 
 namespace marianatrench {
@@ -96,7 +97,7 @@ std::vector<Model> ContentProviderGenerator::emit_method_models(
 
   std::mutex mutex;
   std::vector<Model> models;
-  auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
+  auto queue = work_queue<const Method*>([&](const Method* method) {
     const auto& signature = method->signature();
     const auto outer_class = generator::get_outer_class(signature);
     if (manifest_providers.count(outer_class)) {
@@ -23,8 +23,9 @@ void FieldModelTemplate::add_model_generator(
 std::optional<FieldModel> FieldModelTemplate::instantiate(
     const Field* field) const {
   auto field_model = field_model_.instantiate(field);
-  return !field_model.empty() ? std::optional<FieldModel>{field_model}
-                              : std::nullopt;
+  return !field_model.empty()
+      ? std::optional<FieldModel>{std::move(field_model)}
+      : std::nullopt;
 }
 
 FieldModelTemplate FieldModelTemplate::from_json(
@@ -8,6 +8,7 @@
 #include <mariana-trench/EventLogger.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Log.h>
+#include <mariana-trench/Timer.h>
 #include <mariana-trench/model-generator/JsonModelGenerator.h>
 #include <mariana-trench/model-generator/ModelGeneratorNameFactory.h>
 
@@ -29,24 +30,40 @@ std::vector<Model> JsonModelGeneratorItem::emit_method_models_filtered(
   return this->run_impl(methods.elements().begin(), methods.elements().end());
 }
 
+std::vector<Model> JsonModelGeneratorItem::emit_method_models_matched(
+    const std::vector<const Method*>& methods) const {
+  std::vector<Model> models;
+  for (const auto* method : methods) {
+    if (auto model = instantiate(method)) {
+      model->add_model_generator_if_empty(name_);
+      models.push_back(std::move(*model));
+    }
+  }
+  return models;
+}
+
 std::vector<Model> JsonModelGeneratorItem::visit_method(
     const Method* method) const {
   std::vector<Model> models;
   if (constraint_->satisfy(method)) {
-    LOG(verbosity_,
-        "Method `{}{}` satisfies all constraints in json model generator {}",
-        method->is_static() ? "(static) " : "",
-        method->show(),
-        show(name_));
-    auto model = model_template_.instantiate(method, context_, verbosity_);
-    // If a method has an empty model, then don't add a model
-    if (model) {
-      models.push_back(*model);
+    if (auto model = instantiate(method)) {
+      models.push_back(std::move(*model));
     }
   }
   return models;
 }
 
+std::optional<Model> JsonModelGeneratorItem::instantiate(
+    const Method* method) const {
+  LOG(verbosity_,
+      "Method `{}{}` satisfies all constraints in json model generator {}",
+      method->is_static() ? "(static) " : "",
+      method->show(),
+      show(name_));
+  // If a method has an empty model, then don't add a model
+  return model_template_.instantiate(method, context_, verbosity_);
+}
+
 std::unordered_set<const MethodConstraint*>
 JsonModelGeneratorItem::constraint_leaves() const {
   std::unordered_set<const MethodConstraint*> flattened_constraints;
@@ -83,6 +100,28 @@ JsonFieldModelGeneratorItem::JsonFieldModelGeneratorItem(
       field_model_template_(std::move(field_model_template)),
       verbosity_(verbosity) {}
 
+std::vector<FieldModel> JsonFieldModelGeneratorItem::emit_field_models_filtered(
+    const FieldHashedSet& fields) {
+  return this->run_impl(fields.elements().begin(), fields.elements().end());
+}
+
+std::vector<FieldModel> JsonFieldModelGeneratorItem::emit_field_models_matched(
+    const std::vector<const Field*>& fields) const {
+  std::vector<FieldModel> field_models;
+  for (const auto* field : fields) {
+    auto field_model = field_model_template_.instantiate(field);
+    if (field_model) {
+      field_models.push_back(std::move(*field_model));
+    }
+  }
+  return field_models;
+}
+
+FieldHashedSet JsonFieldModelGeneratorItem::may_satisfy(
+    const FieldMappings& field_mappings) const {
+  return constraint_->may_satisfy(field_mappings);
+}
+
 std::vector<FieldModel> JsonFieldModelGeneratorItem::visit_field(
     const Field* field) const {
   std::vector<FieldModel> field_models;
@@ -94,7 +133,7 @@ std::vector<FieldModel> JsonFieldModelGeneratorItem::visit_field(
     auto field_model = field_model_template_.instantiate(field);
     // If a field has an empty model, then don't add it
     if (field_model) {
-      field_models.push_back(*field_model);
+      field_models.push_back(std::move(*field_model));
     }
   }
   return field_models;
@@ -106,7 +145,9 @@ JsonModelGenerator::JsonModelGenerator(
     const std::filesystem::path& json_configuration_file,
     const Json::Value& value)
     : ModelGenerator(name, context),
-      json_configuration_file_(json_configuration_file) {
+      json_configuration_file_(json_configuration_file),
+      configuration_hash_(
+          std::hash<std::string>()(JsonValidation::to_styled_string(value))) {
   JsonValidation::check_unexpected_members(value, {"model_generators"});
 
   int index = 0;
@@ -209,20 +250,82 @@ std::vector<Model> JsonModelGenerator::emit_method_models(
   return models;
 }
 
+void JsonModelGenerator::share_constraints(
+    MethodConstraintMatcher& matcher,
+    const MethodMappings& method_mappings) {
+  matcher_indices_.clear();
+  if (cached_matches_) {
+    return;
+  }
+
+  matcher_ = &matcher;
+  for (const auto& item : items_) {
+    if (item.may_satisfy(method_mappings).is_top()) {
+      matcher_indices_.push_back(matcher.add(item.constraint()));
+    } else {
+      matcher_indices_.push_back(std::nullopt);
+    }
+  }
+}
+
+void JsonModelGenerator::load_cache(const ModelGeneratorCache& cache) {
+  cached_matches_ = cache.load(name_, configuration_hash_, context_);
+  if (cached_matches_ &&
+      (cached_matches_->methods.size() != items_.size() ||
+       cached_matches_->fields.size() != field_items_.size())) {
+    cached_matches_ = std::nullopt;
+  }
+}
+
+void JsonModelGenerator::store_cache(const ModelGeneratorCache& cache) const {
+  if (cached_matches_) {
+    return;
+  }
+  cache.store(name_, configuration_hash_, matches_);
+}
+
 std::vector<Model> JsonModelGenerator::emit_method_models_optimized(
     const Methods& methods,
     const MethodMappings& method_mappings) {
   std::vector<Model> models;
-  for (auto& item : items_) {
-    MethodHashedSet filtered_methods = item.may_satisfy(method_mappings);
-    if (filtered_methods.is_bottom()) {
-      continue;
-    }
+  matches_.methods.assign(items_.size(), {});
+  item_profiles_.clear();
+  for (std::size_t index = 0; index < items_.size(); index++) {
+    auto& item = items_[index];
+    Timer item_timer;
+    ModelGeneratorItemProfile profile{show(item.name())};
     std::vector<Model> method_models;
-    if (filtered_methods.is_top()) {
-      method_models = item.emit_method_models(methods);
+    if (cached_matches_) {
+      const auto& matched = cached_matches_->methods[index];
+      profile.candidates = matched.size();
+      method_models = item.emit_method_models_matched(matched);
+    } else if (matcher_ != nullptr && matcher_indices_.at(index)) {
+      // Constraints are evaluated by the shared matcher, not by this item.
+      const auto& matched = matcher_->matches(*matcher_indices_[index]);
+      profile.candidates = matched.size();
+      method_models = item.emit_method_models_matched(matched);
     } else {
-      method_models = item.emit_method_models_filtered(filtered_methods);
+      MethodHashedSet filtered_methods = item.may_satisfy(method_mappings);
+      if (filtered_methods.is_bottom()) {
+        continue;
+      }
+      if (filtered_methods.is_top()) {
+        profile.candidates = methods.size();
+        method_models = item.emit_method_models(methods);
+      } else {
+        profile.candidates = filtered_methods.size();
+        method_models = item.emit_method_models_filtered(filtered_methods);
+      }
+      profile.satisfy_evaluations = profile.candidates;
+    }
+    profile.time = item_timer.duration_in_seconds();
+    profile.models = method_models.size();
+    item_profiles_.push_back(std::move(profile));
+
+    for (const auto& model : method_models) {
+      if (model.method() != nullptr) {
+        matches_.methods[index].push_back(model.method());
+      }
     }
 
     LOG(4,
@@ -242,9 +345,50 @@ std::vector<Model> JsonModelGenerator::emit_method_models_optimized(
 
 std::vector<FieldModel> JsonModelGenerator::emit_field_models(
     const Fields& fields) {
+  return emit_field_models_impl(fields, /* field_mappings */ nullptr);
+}
+
+std::vector<FieldModel> JsonModelGenerator::emit_field_models_optimized(
+    const Fields& fields,
+    const FieldMappings& field_mappings) {
+  return emit_field_models_impl(fields, &field_mappings);
+}
+
+std::vector<FieldModel> JsonModelGenerator::emit_field_models_impl(
+    const Fields& fields,
+    const FieldMappings* MT_NULLABLE field_mappings) {
   std::vector<FieldModel> models;
-  for (auto& item : field_items_) {
-    std::vector<FieldModel> field_models = item.emit_field_models(fields);
+  matches_.fields.assign(field_items_.size(), {});
+  for (std::size_t index = 0; index < field_items_.size(); index++) {
+    auto& item = field_items_[index];
+    Timer item_timer;
+    ModelGeneratorItemProfile profile{show(item.name())};
+    std::vector<FieldModel> field_models;
+    if (cached_matches_) {
+      profile.candidates = cached_matches_->fields[index].size();
+      field_models =
+          item.emit_field_models_matched(cached_matches_->fields[index]);
+    } else {
+      auto filtered_fields = field_mappings != nullptr
+          ? item.may_satisfy(*field_mappings)
+          : FieldHashedSet::top();
+      if (filtered_fields.is_top()) {
+        profile.candidates = fields.size();
+        field_models = item.emit_field_models(fields);
+      } else {
+        profile.candidates = filtered_fields.size();
+        field_models = item.emit_field_models_filtered(filtered_fields);
+      }
+      profile.satisfy_evaluations = profile.candidates;
+    }
+    profile.time = item_timer.duration_in_seconds();
+    profile.models = field_models.size();
+    item_profiles_.push_back(std::move(profile));
+    for (const auto& field_model : field_models) {
+      if (field_model.field() != nullptr) {
+        matches_.fields[index].push_back(field_model.field());
+      }
+    }
     models.insert(
         models.end(),
         std::make_move_iterator(field_models.begin()),
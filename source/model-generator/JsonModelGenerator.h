@@ -7,10 +7,15 @@
 
 #pragma once
 
+#include <optional>
+
+#include <mariana-trench/Compiler.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Model.h>
+#include <mariana-trench/ModelGeneratorCache.h>
 #include <mariana-trench/constraints/FieldConstraints.h>
+#include <mariana-trench/constraints/MethodConstraintMatcher.h>
 #include <mariana-trench/constraints/MethodConstraints.h>
 #include <mariana-trench/model-generator/FieldModelTemplate.h>
 #include <mariana-trench/model-generator/ModelGenerator.h>
@@ -29,12 +34,21 @@ class JsonModelGeneratorItem final : public MethodVisitorModelGenerator {
       int verbosity);
   std::vector<Model> emit_method_models_filtered(
       const MethodHashedSet& methods);
+  /* Emit models for methods already known to satisfy the constraints. */
+  std::vector<Model> emit_method_models_matched(
+      const std::vector<const Method*>& methods) const;
+  const AllOfMethodConstraint& constraint() const {
+    return *constraint_;
+  }
   std::unordered_set<const MethodConstraint*> constraint_leaves() const;
   /* Returns filtered method set to run full satisfy checks on. Returns Top if
    * filtered set cannot be determined. */
   MethodHashedSet may_satisfy(const MethodMappings& method_mappings) const;
   std::vector<Model> visit_method(const Method* method) const override;
 
+ private:
+  std::optional<Model> instantiate(const Method* method) const;
+
  private:
   std::unique_ptr<AllOfMethodConstraint> constraint_;
   ModelTemplate model_template_;
@@ -49,6 +63,14 @@ class JsonFieldModelGeneratorItem final : public FieldVisitorModelGenerator {
       std::unique_ptr<AllOfFieldConstraint> constraint,
       FieldModelTemplate field_model_template,
       int verbosity);
+  std::vector<FieldModel> emit_field_models_filtered(
+      const FieldHashedSet& fields);
+  /* Emit models for fields already known to satisfy the constraints. */
+  std::vector<FieldModel> emit_field_models_matched(
+      const std::vector<const Field*>& fields) const;
+  /* Returns filtered field set to run full satisfy checks on. Returns Top if
+   * filtered set cannot be determined. */
+  FieldHashedSet may_satisfy(const FieldMappings& field_mappings) const;
   std::vector<FieldModel> visit_field(const Field* field) const override;
 
  private:
@@ -83,16 +105,47 @@ class JsonModelGenerator final : public ModelGenerator {
       const std::filesystem::path& json_configuration_file,
       const Json::Value& json);
 
+  /* Items that would visit all methods are matched by the shared matcher. */
+  void share_constraints(
+      MethodConstraintMatcher& matcher,
+      const MethodMappings& method_mappings) override;
+
+  void load_cache(const ModelGeneratorCache& cache) override;
+  void store_cache(const ModelGeneratorCache& cache) const override;
+
   std::vector<Model> emit_method_models(const Methods&) override;
   std::vector<Model> emit_method_models_optimized(
       const Methods&,
       const MethodMappings& method_mappings) override;
   std::vector<FieldModel> emit_field_models(const Fields&) override;
+  std::vector<FieldModel> emit_field_models_optimized(
+      const Fields& fields,
+      const FieldMappings& field_mappings) override;
+
+  std::vector<ModelGeneratorItemProfile> item_profiles() const override {
+    return item_profiles_;
+  }
+
+ private:
+  /* Field items are filtered by their candidates, if mappings are given. */
+  std::vector<FieldModel> emit_field_models_impl(
+      const Fields& fields,
+      const FieldMappings* MT_NULLABLE field_mappings);
 
  private:
   std::filesystem::path json_configuration_file_;
+  std::size_t configuration_hash_;
   std::vector<JsonModelGeneratorItem> items_;
   std::vector<JsonFieldModelGeneratorItem> field_items_;
+  const MethodConstraintMatcher* MT_NULLABLE matcher_ = nullptr;
+  /* Conjunction index in the shared matcher of each item, if any. */
+  std::vector<std::optional<std::size_t>> matcher_indices_;
+  /* Matches reused from a previous run, if any. */
+  std::optional<ModelGeneratorCache::Matches> cached_matches_;
+  /* Matches of this run, recorded for the cache. */
+  ModelGeneratorCache::Matches matches_;
+  /* Profile of each item of the last run. */
+  std::vector<ModelGeneratorItemProfile> item_profiles_;
 };
 
 } // namespace marianatrench
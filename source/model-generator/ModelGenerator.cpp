@@ -61,11 +61,12 @@ ModelGeneratorResult ModelGenerator::run(
 ModelGeneratorResult ModelGenerator::run_optimized(
     const Methods& methods,
     const MethodMappings& method_mappings,
-    const Fields& fields) {
+    const Fields& fields,
+    const FieldMappings& field_mappings) {
   return {
       /* method_models */ emit_method_models_optimized(
           methods, method_mappings),
-      /* field_models */ emit_field_models(fields)};
+      /* field_models */ emit_field_models_optimized(fields, field_mappings)};
 }
 
 std::vector<Model> ModelGenerator::emit_method_models_optimized(
@@ -74,6 +75,12 @@ std::vector<Model> ModelGenerator::emit_method_models_optimized(
   return this->emit_method_models(methods);
 }
 
+std::vector<FieldModel> ModelGenerator::emit_field_models_optimized(
+    const Fields& fields,
+    const FieldMappings& /* field_mappings */) {
+  return this->emit_field_models(fields);
+}
+
 std::vector<Model> MethodVisitorModelGenerator::emit_method_models(
     const Methods& methods) {
   return this->run_impl(methods.begin(), methods.end());
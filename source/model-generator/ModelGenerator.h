@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <iterator>
 #include <optional>
 #include <string>
 
@@ -16,6 +17,7 @@
 #include <Walkers.h>
 
 #include <mariana-trench/Context.h>
+#include <mariana-trench/FieldMappings.h>
 #include <mariana-trench/FieldModel.h>
 #include <mariana-trench/Frame.h>
 #include <mariana-trench/MethodMappings.h>
@@ -23,11 +25,16 @@
 #include <mariana-trench/Model.h>
 #include <mariana-trench/Options.h>
 #include <mariana-trench/Overrides.h>
+#include <mariana-trench/Statistics.h>
 #include <mariana-trench/TaintConfig.h>
+#include <mariana-trench/WorkerPool.h>
 #include <mariana-trench/model-generator/ModelGeneratorName.h>
 
 namespace marianatrench {
 
+class MethodConstraintMatcher;
+class ModelGeneratorCache;
+
 struct ModelGeneratorResult {
   std::vector<Model> method_models;
   std::vector<FieldModel> field_models;
@@ -62,11 +69,47 @@ class ModelGenerator {
     return {};
   }
 
+  virtual std::vector<FieldModel> emit_field_models_optimized(
+      const Fields& fields,
+      const FieldMappings& field_mappings);
+
+  /**
+   * Register constraints that must be checked against all methods in the
+   * shared matcher, which runs before `run_optimized`. The matcher outlives
+   * the generator run.
+   */
+  virtual void share_constraints(
+      MethodConstraintMatcher& /* matcher */,
+      const MethodMappings& /* method_mappings */) {}
+
+  /**
+   * Reuse the results of a previous run from the cache, if they are still
+   * valid. This is called before `share_constraints`.
+   */
+  virtual void load_cache(const ModelGeneratorCache& /* cache */) {}
+
+  /* Store the results of `run_optimized` in the cache. */
+  virtual void store_cache(const ModelGeneratorCache& /* cache */) const {}
+
+  /* Profile of each item of the last `run_optimized`, if any. */
+  virtual std::vector<ModelGeneratorItemProfile> item_profiles() const {
+    return {};
+  }
+
   ModelGeneratorResult run(const Methods& methods, const Fields& fields);
   ModelGeneratorResult run_optimized(
       const Methods& methods,
       const MethodMappings& method_mappings,
-      const Fields& fields);
+      const Fields& fields,
+      const FieldMappings& field_mappings);
+
+ protected:
+  /**
+   * Visitor generators only start a thread pool when there are at least this
+   * many items to visit. Model generators run concurrently, and most of them
+   * only visit a few methods once filtered by method mappings.
+   */
+  static constexpr std::ptrdiff_t k_minimum_parallel_items = 1000;
 
  protected:
   const ModelGeneratorName* name_;
@@ -95,7 +138,7 @@ class MethodVisitorModelGenerator : public ModelGenerator {
     std::vector<Model> models;
     std::mutex mutex;
 
-    auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
+    auto visit = [&](const Method* method) {
       std::vector<Model> method_models = this->visit_method(method);
 
       if (method_models.empty()) {
@@ -113,7 +156,16 @@ class MethodVisitorModelGenerator : public ModelGenerator {
             std::make_move_iterator(method_models.begin()),
             std::make_move_iterator(method_models.end()));
       }
-    });
+    };
+
+    if (std::distance(begin, end) < k_minimum_parallel_items) {
+      for (auto iterator = begin; iterator != end; ++iterator) {
+        visit(*iterator);
+      }
+      return models;
+    }
+
+    auto queue = work_queue<const Method*>(visit);
     for (auto iterator = begin; iterator != end; ++iterator) {
       queue.add_item(*iterator);
     }
@@ -141,7 +193,7 @@ class FieldVisitorModelGenerator : public ModelGenerator {
     std::vector<FieldModel> models;
     std::mutex mutex;
 
-    auto queue = sparta::work_queue<const Field*>([&](const Field* field) {
+    auto visit = [&](const Field* field) {
       auto field_models = this->visit_field(field);
 
       if (field_models.empty()) {
@@ -159,7 +211,16 @@ class FieldVisitorModelGenerator : public ModelGenerator {
             std::make_move_iterator(field_models.begin()),
             std::make_move_iterator(field_models.end()));
       }
-    });
+    };
+
+    if (std::distance(begin, end) < k_minimum_parallel_items) {
+      for (auto iterator = begin; iterator != end; ++iterator) {
+        visit(*iterator);
+      }
+      return models;
+    }
+
+    auto queue = work_queue<const Field*>(visit);
     for (auto iterator = begin; iterator != end; ++iterator) {
       queue.add_item(*iterator);
     }
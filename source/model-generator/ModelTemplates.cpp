@@ -14,6 +14,37 @@
 
 namespace marianatrench {
 
+namespace {
+
+const Kind* propagation_kind(
+    const AccessPath& output_port,
+    const TransformList* MT_NULLABLE transforms,
+    Context& context) {
+  const PropagationKind* base_kind = nullptr;
+  if (output_port.root().is_return()) {
+    base_kind = context.kind_factory->local_return();
+  } else if (output_port.root().is_argument()) {
+    base_kind = context.kind_factory->local_argument(
+        output_port.root().parameter_position());
+  } else {
+    throw JsonValidationError(
+        output_port.to_json(),
+        /* field */ "output",
+        "an access path with a `Return` or `Argument(x)` root");
+  }
+
+  if (transforms == nullptr) {
+    return base_kind;
+  }
+  return context.kind_factory->transform_kind(
+      /* base_kind */ base_kind,
+      /* local_transforms */
+      transforms,
+      /* global_transforms */ nullptr);
+}
+
+} // namespace
+
 void TemplateVariableMapping::insert(
     const std::string& name,
     ParameterPosition index) {
@@ -37,6 +68,10 @@ ParameterPositionTemplate::ParameterPositionTemplate(
     std::string parameter_position)
     : parameter_position_(std::move(parameter_position)) {}
 
+bool ParameterPositionTemplate::is_variable() const {
+  return std::holds_alternative<std::string>(parameter_position_);
+}
+
 std::string ParameterPositionTemplate::to_string() const {
   if (std::holds_alternative<ParameterPosition>(parameter_position_)) {
     return std::to_string(std::get<ParameterPosition>(parameter_position_));
@@ -76,6 +111,10 @@ bool RootTemplate::is_argument() const {
   return kind_ == Root::Kind::Argument;
 }
 
+bool RootTemplate::is_variable() const {
+  return is_argument() && parameter_position_->is_variable();
+}
+
 std::string RootTemplate::to_string() const {
   return is_argument()
       ? fmt::format("Argument({})", parameter_position_->to_string())
@@ -166,13 +205,20 @@ PropagationTemplate::PropagationTemplate(
     FeatureMayAlwaysSet inferred_features,
     FeatureSet user_features,
     const TransformList* transforms,
-    CollapseDepth collapse_depth)
+    CollapseDepth collapse_depth,
+    Context& context)
     : input_(std::move(input)),
       output_(std::move(output)),
       inferred_features_(std::move(inferred_features)),
       user_features_(std::move(user_features)),
       transforms_(transforms),
-      collapse_depth_(collapse_depth) {}
+      collapse_depth_(collapse_depth),
+      kind_(nullptr) {
+  if (!output_.root().is_variable()) {
+    kind_ = propagation_kind(
+        output_.instantiate(TemplateVariableMapping()), transforms_, context);
+  }
+}
 
 PropagationTemplate PropagationTemplate::from_json(
     const Json::Value& value,
@@ -231,7 +277,8 @@ PropagationTemplate PropagationTemplate::from_json(
       inferred_features,
       user_features,
       transforms,
-      collapse_depth);
+      collapse_depth,
+      context);
 }
 
 void PropagationTemplate::instantiate(
@@ -240,27 +287,9 @@ void PropagationTemplate::instantiate(
     Context& context) const {
   auto input_port = input_.instantiate(parameter_positions);
   auto output_port = output_.instantiate(parameter_positions);
-  const PropagationKind* propagation_kind = nullptr;
-  if (output_port.root().is_return()) {
-    propagation_kind = context.kind_factory->local_return();
-  } else if (output_port.root().is_argument()) {
-    propagation_kind = context.kind_factory->local_argument(
-        output_port.root().parameter_position());
-  } else {
-    throw JsonValidationError(
-        output_port.to_json(),
-        /* field */ "output",
-        "an access path with a `Return` or `Argument(x)` root");
-  }
-
-  const Kind* kind = propagation_kind;
-  if (transforms_ != nullptr) {
-    kind = context.kind_factory->transform_kind(
-        /* base_kind */ propagation_kind,
-        /* local_transforms */
-        transforms_,
-        /* global_transforms */ nullptr);
-  }
+  const auto* kind = kind_ != nullptr
+      ? kind_
+      : propagation_kind(output_port, transforms_, context);
 
   model.add_propagation(PropagationConfig(
       input_port,
@@ -39,6 +39,9 @@ class ParameterPositionTemplate final {
 
   INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(ParameterPositionTemplate)
 
+  /* Whether the position is a variable name, bound on instantiation. */
+  bool is_variable() const;
+
   ParameterPosition instantiate(
       const TemplateVariableMapping& parameter_positions) const;
   std::string to_string() const;
@@ -58,6 +61,9 @@ class RootTemplate final {
 
   bool is_argument() const;
 
+  /* Whether the root is an argument with a variable position. */
+  bool is_variable() const;
+
   Root instantiate(const TemplateVariableMapping& parameter_positions) const;
   std::string to_string() const;
 
@@ -98,7 +104,8 @@ class PropagationTemplate final {
       FeatureMayAlwaysSet inferred_features,
       FeatureSet user_features,
       const TransformList* transforms,
-      CollapseDepth collapse_depth);
+      CollapseDepth collapse_depth,
+      Context& context);
 
   INCLUDE_DEFAULT_COPY_CONSTRUCTORS_AND_ASSIGNMENTS(PropagationTemplate)
 
@@ -117,6 +124,8 @@ class PropagationTemplate final {
   FeatureSet user_features_;
   const TransformList* transforms_;
   CollapseDepth collapse_depth_;
+  // Resolved on construction, unless the output root is a variable.
+  const Kind* MT_NULLABLE kind_;
 };
 
 class PortSanitizerTemplate final {
@@ -15,6 +15,7 @@
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/WorkerPool.h>
 #include <mariana-trench/model-generator/ServiceSourceGenerator.h>
 
 namespace marianatrench {
@@ -84,7 +85,7 @@ std::vector<Model> ServiceSourceGenerator::emit_method_models(
 
   std::mutex mutex;
   std::unordered_map<DexClass*, bool> permission_services = {};
-  auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
+  auto queue = work_queue<const Method*>([&](const Method* method) {
     auto method_name = generator::get_method_name(method);
     const auto argument_types = generator::get_argument_types(method);
     const auto class_name = generator::get_class_name(method);
@@ -5,8 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+
 #include <gtest/gtest.h>
 
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/ModelGeneratorCache.h>
 #include <mariana-trench/Redex.h>
 #include <mariana-trench/model-generator/BuilderPatternGenerator.h>
 #include <mariana-trench/model-generator/ReturnsThisAnalyzer.h>
@@ -93,3 +97,63 @@ TEST_F(BuilderPatternGeneratorTest, BuilderPatternModels) {
 
   EXPECT_EQ(builder_pattern_models.size(), 0);
 }
+
+TEST_F(BuilderPatternGeneratorTest, CachedMethods) {
+  Scope scope;
+  auto dex_methods = redex::create_methods(
+      scope,
+      "LClass;",
+      {
+          R"(
+            (method (public) "LClass;.method_1:()LClass;"
+            (
+              (load-param-object v1)
+              (return-object v1)
+            )
+            ))",
+          R"(
+            (method (public) "LClass;.method_2:(Z)Z;"
+            (
+              (load-param v1)
+              (return v1)
+            )
+            ))",
+      });
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto methods = get_methods(context, dex_methods);
+
+  auto cache_directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-builder-pattern-generator-test";
+  std::filesystem::remove_all(cache_directory);
+  std::filesystem::create_directories(cache_directory);
+  ModelGeneratorCache cache(cache_directory, context.stores);
+
+  {
+    auto generator = BuilderPatternGenerator(context);
+    generator.load_cache(cache);
+    EXPECT_EQ(generator.visit_method(methods[0]).size(), 1);
+    EXPECT_EQ(generator.visit_method(methods[1]).size(), 0);
+    generator.store_cache(cache);
+  }
+
+  // The next run uses the cached methods instead of analyzing their code.
+  auto cache_path =
+      cache_directory / "model_generators" / "BuilderPatternGenerator.json";
+  ASSERT_TRUE(std::filesystem::exists(cache_path));
+  auto cache_value = JsonValidation::parse_json_file(cache_path);
+  EXPECT_EQ(cache_value["methods"][0].size(), 1);
+  cache_value["methods"][0][0] = methods[1]->to_json();
+  JsonValidation::write_json_file(cache_path, cache_value);
+
+  auto generator = BuilderPatternGenerator(context);
+  generator.load_cache(cache);
+  EXPECT_THAT(
+      generator.visit_method(methods[1]),
+      testing::UnorderedElementsAre(Model(
+          methods[1], context, Model::Mode::AliasMemoryLocationOnInvoke)));
+  EXPECT_EQ(generator.visit_method(methods[0]).size(), 0);
+
+  std::filesystem::remove_all(cache_directory);
+}
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <mariana-trench/FieldMappings.h>
 #include <mariana-trench/Fields.h>
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Redex.h>
@@ -235,6 +236,78 @@ TEST_F(FieldConstraintTest, AnyOfFieldConstraintSatisfy) {
   }
 }
 
+TEST_F(FieldConstraintTest, FieldConstraintMaySatisfy) {
+  Scope scope;
+  auto dex_field_a = redex::create_field(
+      scope, "LClassA;", /* field */ {"field_a", type::java_lang_String()});
+  auto dex_field_b = redex::create_field(
+      scope,
+      "LClassB;",
+      /* field */
+      {"field_b",
+       type::java_lang_String(),
+       /* annotations */
+       {"Lcom/facebook/Annotation;"}},
+      /* super */ nullptr,
+      /* is_static */ true);
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* field_a = context.fields->get(dex_field_a);
+  auto* field_b = context.fields->get(dex_field_b);
+  FieldMappings field_mappings(*context.fields);
+
+  EXPECT_EQ(
+      FieldNameConstraint("field_a").may_satisfy(field_mappings),
+      FieldHashedSet({field_a}));
+  EXPECT_TRUE(
+      FieldNameConstraint("field_.*").may_satisfy(field_mappings).is_top());
+  EXPECT_TRUE(FieldNameConstraint("field_c")
+                  .may_satisfy(field_mappings)
+                  .is_bottom());
+  EXPECT_EQ(
+      IsStaticFieldConstraint(true).may_satisfy(field_mappings),
+      FieldHashedSet({field_b}));
+  EXPECT_EQ(
+      HasAnnotationFieldConstraint(
+          /* type */ "Lcom/facebook/Annotation;", /* annotation */ std::nullopt)
+          .may_satisfy(field_mappings),
+      FieldHashedSet({field_b}));
+  EXPECT_EQ(
+      ParentFieldConstraint(std::make_unique<TypeNameConstraint>("LClassA;"))
+          .may_satisfy(field_mappings),
+      FieldHashedSet({field_a}));
+  EXPECT_TRUE(ParentFieldConstraint(
+                  std::make_unique<TypePatternConstraint>("LClass.*;"))
+                  .may_satisfy(field_mappings)
+                  .is_top());
+
+  {
+    std::vector<std::unique_ptr<FieldConstraint>> constraints;
+    constraints.push_back(std::make_unique<FieldNameConstraint>("field_.*"));
+    constraints.push_back(std::make_unique<IsStaticFieldConstraint>(false));
+    EXPECT_EQ(
+        AllOfFieldConstraint(std::move(constraints))
+            .may_satisfy(field_mappings),
+        FieldHashedSet({field_a}));
+  }
+
+  {
+    std::vector<std::unique_ptr<FieldConstraint>> constraints;
+    constraints.push_back(std::make_unique<FieldNameConstraint>("field_a"));
+    constraints.push_back(std::make_unique<FieldNameConstraint>("field_b"));
+    EXPECT_EQ(
+        AnyOfFieldConstraint(std::move(constraints))
+            .may_satisfy(field_mappings),
+        FieldHashedSet({field_a, field_b}));
+  }
+
+  EXPECT_EQ(
+      NotFieldConstraint(std::make_unique<FieldNameConstraint>("field_a"))
+          .may_satisfy(field_mappings),
+      FieldHashedSet({field_b}));
+}
+
 TEST_F(FieldConstraintTest, FieldNameConstraintFromJson) {
   auto context = test::make_empty_context();
 
@@ -6,10 +6,11 @@
  */
 
 #include <Creators.h>
-#include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
 #include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Redex.h>
+#include <mariana-trench/constraints/MethodConstraintMatcher.h>
 #include <mariana-trench/model-generator/JsonModelGenerator.h>
 #include <mariana-trench/model-generator/ModelGeneratorNameFactory.h>
 #include <mariana-trench/tests/Test.h>
@@ -2386,6 +2387,107 @@ TEST_F(MethodConstraintTest, HasAnnotationConstraintMaySatisfy) {
                   .is_bottom());
 }
 
+TEST_F(MethodConstraintTest, IndexedConstraintsMaySatisfy) {
+  Scope scope;
+  auto context = test::make_empty_context();
+  auto dex_methods = redex::create_methods(
+      scope,
+      "LClass;",
+      {
+          R"(
+            (method (public static) "LClass;.method_1:(Landroid/content/Intent;I)V"
+            (
+              (return-void)
+            )
+            ))",
+          R"(
+            (method (private) "LClass;.method_2:(ILandroid/content/Intent;)I"
+            (
+              (const v0 0)
+              (return v0)
+            )
+            ))",
+      });
+  const auto* method_1 = context.methods->create(dex_methods[0]);
+  const auto* method_2 = context.methods->create(dex_methods[1]);
+  MethodMappings method_mappings{*context.methods};
+
+  EXPECT_EQ(
+      NthParameterConstraint(
+          0,
+          std::make_unique<TypeParameterConstraint>(
+              std::make_unique<TypeNameConstraint>("Landroid/content/Intent;")))
+          .may_satisfy(method_mappings),
+      marianatrench::MethodHashedSet({method_1}));
+  EXPECT_EQ(
+      NthParameterConstraint(
+          2,
+          std::make_unique<TypeParameterConstraint>(
+              std::make_unique<TypeNameConstraint>("Landroid/content/Intent;")))
+          .may_satisfy(method_mappings),
+      marianatrench::MethodHashedSet({method_2}));
+  EXPECT_TRUE(NthParameterConstraint(
+                  1,
+                  std::make_unique<TypeParameterConstraint>(
+                      std::make_unique<TypeNameConstraint>(
+                          "Landroid/content/Intent;")))
+                  .may_satisfy(method_mappings)
+                  .is_bottom());
+  EXPECT_TRUE(NthParameterConstraint(
+                  0,
+                  std::make_unique<TypeParameterConstraint>(
+                      std::make_unique<NotTypeConstraint>(
+                          std::make_unique<TypeNameConstraint>(
+                              "Landroid/content/Intent;"))))
+                  .may_satisfy(method_mappings)
+                  .is_top());
+  EXPECT_EQ(
+      AnyParameterConstraint(
+          /* start_index */ std::nullopt,
+          std::make_unique<TypeParameterConstraint>(
+              std::make_unique<TypePatternConstraint>(
+                  "Landroid/content/Intent;")))
+          .may_satisfy(method_mappings),
+      marianatrench::MethodHashedSet({method_1, method_2}));
+
+  auto returns_int =
+      ReturnConstraint(std::make_unique<TypeNameConstraint>("I"))
+          .may_satisfy(method_mappings);
+  EXPECT_TRUE(returns_int.contains(method_2));
+  EXPECT_FALSE(returns_int.contains(method_1));
+  EXPECT_TRUE(
+      ReturnConstraint(
+          std::make_unique<ExtendsConstraint>(
+              std::make_unique<TypeNameConstraint>("Ljava/lang/Object;")))
+          .may_satisfy(method_mappings)
+          .is_top());
+
+  auto static_methods =
+      IsStaticConstraint(true).may_satisfy(method_mappings);
+  EXPECT_TRUE(static_methods.contains(method_1));
+  EXPECT_FALSE(static_methods.contains(method_2));
+  auto instance_methods =
+      IsStaticConstraint(false).may_satisfy(method_mappings);
+  EXPECT_FALSE(instance_methods.contains(method_1));
+  EXPECT_TRUE(instance_methods.contains(method_2));
+
+  auto private_methods =
+      VisibilityMethodConstraint(ACC_PRIVATE).may_satisfy(method_mappings);
+  EXPECT_FALSE(private_methods.contains(method_1));
+  EXPECT_TRUE(private_methods.contains(method_2));
+
+  auto three_parameters =
+      NumberParametersConstraint(
+          IntegerConstraint(3, IntegerConstraint::Operator::EQ))
+          .may_satisfy(method_mappings);
+  EXPECT_FALSE(three_parameters.contains(method_1));
+  EXPECT_TRUE(three_parameters.contains(method_2));
+
+  EXPECT_TRUE(IsConstructorConstraint(true)
+                  .may_satisfy(method_mappings)
+                  .is_bottom());
+}
+
 TEST_F(MethodConstraintTest, UniqueConstraints) {
   Scope scope;
   DexStore store("stores");
@@ -2451,3 +2553,89 @@ TEST_F(MethodConstraintTest, UniqueConstraints) {
     EXPECT_EQ(generator.constraint_leaves(), expected_constraints);
   }
 }
+
+TEST_F(MethodConstraintTest, MethodConstraintMatcher) {
+  Scope scope;
+  auto context = test::make_empty_context();
+
+  auto* on_create = context.methods->create(
+      redex::create_void_method(scope, "LActivity;", "onCreate"));
+  auto* on_resume = context.methods->create(
+      redex::create_void_method(scope, "LActivity;", "onResume"));
+  context.methods->create(
+      redex::create_void_method(scope, "LOther;", "onCreate"));
+
+  auto make_parent_constraint = []() {
+    return std::make_unique<ParentConstraint>(
+        std::make_unique<TypePatternConstraint>("LActivity;"));
+  };
+
+  std::vector<std::unique_ptr<MethodConstraint>> first_constraints;
+  first_constraints.push_back(make_parent_constraint());
+  first_constraints.push_back(
+      std::make_unique<MethodNameConstraint>("onCreate"));
+  AllOfMethodConstraint first(std::move(first_constraints));
+
+  std::vector<std::unique_ptr<MethodConstraint>> second_constraints;
+  second_constraints.push_back(make_parent_constraint());
+  second_constraints.push_back(
+      std::make_unique<MethodPatternConstraint>("on.*"));
+  AllOfMethodConstraint second(std::move(second_constraints));
+
+  MethodConstraintMatcher matcher;
+  auto first_index = matcher.add(first);
+  auto second_index = matcher.add(second);
+  EXPECT_EQ(matcher.number_of_distinct_constraints(), 3);
+
+  matcher.run(*context.methods);
+  EXPECT_THAT(
+      matcher.matches(first_index), testing::UnorderedElementsAre(on_create));
+  EXPECT_THAT(
+      matcher.matches(second_index),
+      testing::UnorderedElementsAre(on_create, on_resume));
+}
+
+TEST_F(MethodConstraintTest, MethodConstraintMatcherPatternSets) {
+  Scope scope;
+  auto context = test::make_empty_context();
+
+  auto* on_create = context.methods->create(
+      redex::create_void_method(scope, "LActivity;", "onCreate"));
+  auto* on_resume = context.methods->create(
+      redex::create_void_method(scope, "LActivity;", "onResume"));
+  auto* other = context.methods->create(
+      redex::create_void_method(scope, "LOther;", "other"));
+
+  auto make_constraint = [](std::unique_ptr<MethodConstraint> constraint) {
+    std::vector<std::unique_ptr<MethodConstraint>> constraints;
+    constraints.push_back(std::move(constraint));
+    return AllOfMethodConstraint(std::move(constraints));
+  };
+  auto on_anything =
+      make_constraint(std::make_unique<MethodPatternConstraint>("on.*"));
+  auto on_resume_only =
+      make_constraint(std::make_unique<MethodPatternConstraint>("onRes.*"));
+  auto activity_signatures = make_constraint(
+      std::make_unique<SignaturePatternConstraint>("LActivity;\\..*"));
+  auto other_signatures = make_constraint(
+      std::make_unique<SignaturePatternConstraint>("LOther;\\..*"));
+
+  MethodConstraintMatcher matcher;
+  auto on_anything_index = matcher.add(on_anything);
+  auto on_resume_index = matcher.add(on_resume_only);
+  auto activity_index = matcher.add(activity_signatures);
+  auto other_index = matcher.add(other_signatures);
+  matcher.run(*context.methods);
+
+  EXPECT_THAT(
+      matcher.matches(on_anything_index),
+      testing::UnorderedElementsAre(on_create, on_resume));
+  EXPECT_THAT(
+      matcher.matches(on_resume_index),
+      testing::UnorderedElementsAre(on_resume));
+  EXPECT_THAT(
+      matcher.matches(activity_index),
+      testing::UnorderedElementsAre(on_create, on_resume));
+  EXPECT_THAT(
+      matcher.matches(other_index), testing::UnorderedElementsAre(other));
+}
@@ -193,12 +193,24 @@ TEST_F(ModelGeneratorTest, MappingGenerator) {
     EXPECT_EQ(
         class_to_override_methods_map, expected_class_to_override_methods);
 
-    std::unordered_map<std::string, std::vector<const Method*>>
-        signature_to_methods_map =
-            sort_mapping(method_mappings.signature_to_methods());
-    for (auto& pair : expected_signature_to_methods) {
-      std::sort(pair.second.begin(), pair.second.end(), compare_methods);
+    for (auto& [signature, expected_methods] : expected_signature_to_methods) {
+      const auto methods = method_mappings.signature_to_methods(signature);
+      std::vector<const Method*> sorted_methods(
+          methods.elements().begin(), methods.elements().end());
+      std::sort(sorted_methods.begin(), sorted_methods.end(), compare_methods);
+      std::sort(
+          expected_methods.begin(), expected_methods.end(), compare_methods);
+      EXPECT_EQ(sorted_methods, expected_methods);
     }
-    EXPECT_EQ(signature_to_methods_map, expected_signature_to_methods);
+    EXPECT_TRUE(method_mappings.signature_to_methods("LClass;.unknown:()V")
+                    .is_bottom());
+
+    // Methods created after an index is built are added to it.
+    auto* later_method = context.methods->create(
+        dex_base_method, {{1, DexType::get_type("LString;")}});
+    method_mappings.create_mappings_for_method(later_method);
+    EXPECT_TRUE(method_mappings.class_to_methods()
+                    .get("LClass;", MethodHashedSet::bottom())
+                    .contains(later_method));
   }
 }
@@ -5,13 +5,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
 #include <iterator>
+#include <optional>
 
 #include <boost/algorithm/string/join.hpp>
 
 #include <mariana-trench/EventLogger.h>
 #include <mariana-trench/IntentRoutingAnalyzer.h>
 #include <mariana-trench/Options.h>
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/constraints/MethodConstraintMatcher.h>
 #include <mariana-trench/shim-generator/ShimGeneration.h>
 #include <mariana-trench/shim-generator/ShimGenerator.h>
 #include <mariana-trench/shim-generator/Shims.h>
@@ -79,29 +83,74 @@ Shims ShimGeneration::run(
     }
   }
 
-  // Run the shim generator
-  Shims method_shims(all_shims.size(), intent_routing_analyzer);
-  std::size_t iteration = 0;
+  // Constraints of generators that would visit all methods are evaluated in a
+  // single pass, as for model generators.
+  MethodConstraintMatcher matcher;
+  std::vector<MethodHashedSet> filtered_methods;
+  std::vector<std::optional<std::size_t>> matcher_indices;
+  filtered_methods.reserve(all_shims.size());
+  matcher_indices.reserve(all_shims.size());
+  for (const auto& shim_generator : all_shims) {
+    auto methods = shim_generator.may_satisfy(method_mappings);
+    if (methods.is_top()) {
+      matcher_indices.push_back(matcher.add(shim_generator.constraint()));
+      methods = MethodHashedSet::bottom();
+    } else {
+      matcher_indices.push_back(std::nullopt);
+    }
+    filtered_methods.push_back(std::move(methods));
+  }
+  matcher.run(*context.methods);
 
-  for (auto& item : all_shims) {
-    LOG(1, "Running shim generator ({}/{})", ++iteration, all_shims.size());
+  // Shim generators are independent, so they run concurrently. Results are
+  // merged in the order of the configuration to keep the output deterministic.
+  std::vector<std::vector<InstantiatedShim>> results(all_shims.size());
+  std::atomic<std::size_t> iteration(0);
 
-    auto duplicate_shims = item.emit_method_shims(
-        method_shims, context.methods.get(), method_mappings);
+  unsigned int threads = sparta::parallel::default_num_threads();
+  if (context.options->sequential()) {
+    threads = 1u;
+  }
 
-    if (!duplicate_shims.empty()) {
-      std::vector<std::string> errors{};
-      std::transform(
-          duplicate_shims.cbegin(),
-          duplicate_shims.cend(),
-          std::back_inserter(errors),
-          [](const auto& shim) { return shim.method()->show(); });
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t index) {
+        LOG(1, "Running shim generator ({}/{})", ++iteration, all_shims.size());
+        const auto& shim_generator = all_shims[index];
+        if (auto matcher_index = matcher_indices[index]) {
+          results[index] = shim_generator.emit_method_shims_matched(
+              matcher.matches(*matcher_index));
+        } else if (!filtered_methods[index].is_bottom()) {
+          results[index] =
+              shim_generator.emit_method_shims_filtered(filtered_methods[index]);
+        }
+      },
+      threads);
+  for (std::size_t index = 0; index < all_shims.size(); index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
 
-      throw ShimGeneratorError(fmt::format(
-          "Duplicate shim defined for: {}", boost::join(errors, ", ")));
+  Shims method_shims(all_shims.size(), intent_routing_analyzer);
+  std::vector<std::string> duplicates;
+  for (const auto& shims : results) {
+    for (const auto& shim : shims) {
+      LOG(5, "Adding shim: {}", shim);
+      if (!method_shims.add_instantiated_shim(shim)) {
+        WARNING(
+            1,
+            "Shim for method: `{}` already exists. Following was not added: {}",
+            shim.method()->show(),
+            shim);
+        duplicates.push_back(shim.method()->show());
+      }
     }
   }
 
+  if (!duplicates.empty()) {
+    throw ShimGeneratorError(fmt::format(
+        "Duplicate shim defined for: {}", boost::join(duplicates, ", ")));
+  }
+
   return method_shims;
 }
 
@@ -35,23 +35,31 @@ std::optional<InstantiatedShim> ShimGenerator::visit_method(
   return std::nullopt;
 }
 
-std::vector<InstantiatedShim> ShimGenerator::emit_method_shims(
-    Shims& method_shims,
-    const Methods* methods,
-    const MethodMappings& method_mappings) {
-  MethodHashedSet filtered_methods = constraint_->may_satisfy(method_mappings);
-  if (filtered_methods.is_bottom()) {
-    return {};
-  }
+MethodHashedSet ShimGenerator::may_satisfy(
+    const MethodMappings& method_mappings) const {
+  return constraint_->may_satisfy(method_mappings);
+}
 
-  if (!filtered_methods.is_top()) {
-    return visit_methods(
-        method_shims,
-        filtered_methods.elements().begin(),
-        filtered_methods.elements().end());
+std::vector<InstantiatedShim> ShimGenerator::emit_method_shims_filtered(
+    const MethodHashedSet& methods) const {
+  std::vector<InstantiatedShim> shims;
+  for (const auto* method : methods.elements()) {
+    if (auto shim = visit_method(method)) {
+      shims.push_back(std::move(*shim));
+    }
   }
+  return shims;
+}
 
-  return visit_methods(method_shims, methods->begin(), methods->end());
+std::vector<InstantiatedShim> ShimGenerator::emit_method_shims_matched(
+    const std::vector<const Method*>& methods) const {
+  std::vector<InstantiatedShim> shims;
+  for (const auto* method : methods) {
+    if (auto shim = shim_template_.instantiate(methods_, method)) {
+      shims.push_back(std::move(*shim));
+    }
+  }
+  return shims;
 }
 
 } // namespace marianatrench
@@ -7,8 +7,6 @@
 
 #pragma once
 
-#include <mutex>
-
 #include <mariana-trench/Log.h>
 #include <mariana-trench/Methods.h>
 #include <mariana-trench/constraints/MethodConstraints.h>
@@ -25,50 +23,24 @@ class ShimGenerator final {
       ShimTemplate shim_template,
       const Methods* methods);
 
-  /* Returns a vector of duplicate shims. */
-  std::vector<InstantiatedShim> emit_method_shims(
-      Shims& method_shims,
-      const Methods* methods,
-      const MethodMappings& method_mappings);
-
- private:
-  std::optional<InstantiatedShim> visit_method(const Method* method) const;
-
-  template <typename InputIt>
-  std::vector<InstantiatedShim>
-  visit_methods(Shims& shims, InputIt begin, InputIt end) {
-    std::mutex mutex;
-    std::vector<InstantiatedShim> duplicates;
+  const AllOfMethodConstraint& constraint() const {
+    return *constraint_;
+  }
 
-    auto queue = sparta::work_queue<const Method*>([&](const Method* method) {
-      auto shim = this->visit_method(method);
-      if (!shim) {
-        return;
-      }
+  /* Returns filtered method set to run full satisfy checks on. Returns Top if
+   * filtered set cannot be determined. */
+  MethodHashedSet may_satisfy(const MethodMappings& method_mappings) const;
 
-      LOG(5, "Adding shim: {}", *shim);
-      bool inserted;
-      {
-        std::lock_guard<std::mutex> lock(mutex);
-        inserted = shims.add_instantiated_shim(*shim);
-      }
+  /* Emit shims for the given candidates satisfying the constraints. */
+  std::vector<InstantiatedShim> emit_method_shims_filtered(
+      const MethodHashedSet& methods) const;
 
-      if (!inserted) {
-        WARNING(
-            1,
-            "Shim for method: `{}` already exists. Following was not added: {}",
-            method->show(),
-            *shim);
-        duplicates.push_back(*shim);
-      }
-    });
+  /* Emit shims for methods already known to satisfy the constraints. */
+  std::vector<InstantiatedShim> emit_method_shims_matched(
+      const std::vector<const Method*>& methods) const;
 
-    for (auto iterator = begin; iterator != end; ++iterator) {
-      queue.add_item(*iterator);
-    }
-    queue.run_all();
-    return duplicates;
-  }
+ private:
+  std::optional<InstantiatedShim> visit_method(const Method* method) const;
 
  private:
   std::unique_ptr<AllOfMethodConstraint> constraint_;
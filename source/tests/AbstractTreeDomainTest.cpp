@@ -24,7 +24,7 @@ class AbstractTreeDomainTest : public test::Test {};
 using IntSet = sparta::PatriciaTreeSetAbstractDomain<unsigned>;
 
 struct IntSetTreeConfiguration {
-  static std::size_t max_tree_height_after_widening() {
+  static constexpr std::size_t max_tree_height_after_widening() {
     return 4;
   }
 
@@ -1641,6 +1641,37 @@ TEST_F(AbstractTreeDomainTest, Join) {
       }));
 }
 
+TEST_F(AbstractTreeDomainTest, JoinPreservesSharing) {
+  const auto x = PathElement::field("x");
+  const auto y = PathElement::field("y");
+  const auto z = PathElement::field("z");
+
+  const auto tree = IntSetTree{
+      {Path{x}, IntSet{1}},
+      {Path{x, y}, IntSet{2}},
+      {Path{y}, IntSet{3}},
+  };
+
+  // Joining with a copy leaves the tree physically unchanged.
+  auto copy = tree;
+  copy.join_with(tree);
+  EXPECT_TRUE(copy.successors().reference_equals(tree.successors()));
+
+  // Unchanged subtrees keep sharing their nodes.
+  auto joined = tree;
+  joined.join_with(IntSetTree{{Path{z}, IntSet{4}}});
+  EXPECT_EQ(
+      joined,
+      (IntSetTree{
+          {Path{x}, IntSet{1}},
+          {Path{x, y}, IntSet{2}},
+          {Path{y}, IntSet{3}},
+          {Path{z}, IntSet{4}},
+      }));
+  EXPECT_TRUE(joined.successor(x).successors().reference_equals(
+      tree.successor(x).successors()));
+}
+
 TEST_F(AbstractTreeDomainTest, JoinIndex) {
   const auto x = PathElement::field("x");
   const auto xi = PathElement::index("x");
@@ -2310,7 +2341,7 @@ TEST_F(AbstractTreeDomainTest, Shape) {
 }
 
 struct ScalarTreeConfiguration {
-  static std::size_t max_tree_height_after_widening() {
+  static constexpr std::size_t max_tree_height_after_widening() {
     return 4;
   }
 
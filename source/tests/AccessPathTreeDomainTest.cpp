@@ -20,7 +20,7 @@ class AccessPathTreeDomainTest : public test::Test {};
 using IntSet = sparta::PatriciaTreeSetAbstractDomain<unsigned>;
 
 struct IntTreeConfiguration {
-  static std::size_t max_tree_height_after_widening() {
+  static constexpr std::size_t max_tree_height_after_widening() {
     return 4;
   }
 
@@ -601,4 +601,54 @@ TEST_F(AccessPathTreeDomainTest, CollapseInvalid) {
       }));
 }
 
+TEST_F(AccessPathTreeDomainTest, LeavesOnly) {
+  const auto x = PathElement::field("x");
+
+  auto tree = IntSetAccessPathTree{
+      {AccessPath(Root(Root::Kind::Return)), IntSet{1}},
+      {AccessPath(Root(Root::Kind::Argument, 0)), IntSet{2}},
+      {AccessPath(Root(Root::Kind::Argument, 1), Path{x}), IntSet{3}},
+  };
+  auto expected = tree;
+
+  auto identity = [](IntSet value) { return value; };
+
+  // Trees without children are left untouched, others are still collapsed.
+  tree.collapse_invalid_paths<std::string>(
+      [](const std::string&, Path::Element) {
+        return std::make_pair(false, std::string(""));
+      },
+      [](const Root& root) { return root.to_string(); },
+      identity);
+  EXPECT_EQ(
+      tree,
+      (IntSetAccessPathTree{
+          {AccessPath(Root(Root::Kind::Return)), IntSet{1}},
+          {AccessPath(Root(Root::Kind::Argument, 0)), IntSet{2}},
+          {AccessPath(Root(Root::Kind::Argument, 1)), IntSet{3}},
+      }));
+
+  tree = expected;
+  tree.shape_with(
+      /* make_mold */ [](IntSet) { return IntSet{}; },
+      /* transform_on_collapse */ identity);
+  EXPECT_EQ(
+      tree,
+      (IntSetAccessPathTree{
+          {AccessPath(Root(Root::Kind::Return)), IntSet{1}},
+          {AccessPath(Root(Root::Kind::Argument, 0)), IntSet{2}},
+          {AccessPath(Root(Root::Kind::Argument, 1)), IntSet{3}},
+      }));
+
+  tree = expected;
+  tree.limit_leaves(/* max_leaves */ 0);
+  EXPECT_EQ(
+      tree,
+      (IntSetAccessPathTree{
+          {AccessPath(Root(Root::Kind::Return)), IntSet{1}},
+          {AccessPath(Root(Root::Kind::Argument, 0)), IntSet{2}},
+          {AccessPath(Root(Root::Kind::Argument, 1)), IntSet{3}},
+      }));
+}
+
 } // namespace marianatrench
@@ -35,6 +35,27 @@ TEST_F(AccessTest, PathExtend) {
   EXPECT_EQ(path, (Path{x, y, z, x}));
 }
 
+TEST_F(AccessTest, PathLongerThanInline) {
+  const auto x = PathElement::field("x");
+  const auto y = PathElement::field("y");
+
+  // Paths longer than the inline storage behave the same.
+  auto path = Path{x, y, x, y};
+  path.append(x);
+  path.extend(Path{y, x});
+  EXPECT_EQ(path, (Path{x, y, x, y, x, y, x}));
+  EXPECT_EQ(path.size(), 7);
+  EXPECT_TRUE((Path{x, y, x, y, x}).is_prefix_of(path));
+
+  auto copy = path;
+  copy.pop_back();
+  EXPECT_EQ(copy, (Path{x, y, x, y, x, y}));
+  EXPECT_EQ(path.size(), 7);
+
+  path.truncate(3);
+  EXPECT_EQ(path, (Path{x, y, x}));
+}
+
 TEST_F(AccessTest, PathTruncate) {
   const auto x = PathElement::field("x");
   const auto y = PathElement::field("y");
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/AnalysisCache.h>
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+namespace {
+
+class AnalysisCacheTest : public test::Test {};
+
+} // anonymous namespace
+
+TEST_F(AnalysisCacheTest, SkipUnchangedMethods) {
+  Scope scope;
+
+  auto* dex_bottom = redex::create_void_method(scope, "LBottom;", "bottom");
+  auto* dex_top = redex::create_method(scope, "LTop;", R"(
+    (method (public) "LTop;.top:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LBottom;.bottom:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_other = redex::create_void_method(scope, "LOther;", "other");
+
+  auto context = test::make_call_graph_context(scope);
+  auto* bottom = context.methods->get(dex_bottom);
+  auto* top = context.methods->get(dex_top);
+  auto* other = context.methods->get(dex_other);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto cache_directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-analysis-cache-test";
+  std::filesystem::remove_all(cache_directory);
+  std::filesystem::create_directories(cache_directory);
+
+  {
+    // Without a cache, every method is analyzed.
+    auto registry = Registry(context);
+    AnalysisCache cache(
+        cache_directory,
+        *context.options,
+        *context.methods,
+        *context.dependencies,
+        registry);
+    EXPECT_EQ(cache.skipped_methods_size(), 0);
+
+    // Analyzing `other` infers a model.
+    registry.set(Model(
+        /* method */ other,
+        context,
+        /* modes */ {},
+        /* frozen */ {},
+        /* generations */
+        {{AccessPath(Root(Root::Kind::Return)),
+          test::make_leaf_taint_config(source_kind)}}));
+    cache.store(registry);
+  }
+
+  {
+    auto registry = Registry(context);
+    AnalysisCache cache(
+        cache_directory,
+        *context.options,
+        *context.methods,
+        *context.dependencies,
+        registry);
+    EXPECT_TRUE(cache.skip(bottom));
+    EXPECT_TRUE(cache.skip(top));
+    EXPECT_FALSE(cache.skip(other));
+  }
+
+  {
+    // Changing the initial model of `bottom` invalidates its callers.
+    auto registry = Registry(context);
+    registry.set(Model(
+        /* method */ bottom,
+        context,
+        /* modes */ Model::Mode::AddViaObscureFeature));
+    AnalysisCache cache(
+        cache_directory,
+        *context.options,
+        *context.methods,
+        *context.dependencies,
+        registry);
+    EXPECT_FALSE(cache.skip(bottom));
+    EXPECT_FALSE(cache.skip(top));
+    EXPECT_FALSE(cache.skip(other));
+  }
+
+  std::filesystem::remove_all(cache_directory);
+}
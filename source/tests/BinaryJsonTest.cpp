@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sstream>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/BinaryJson.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class BinaryJsonTest : public test::Test {};
+
+TEST_F(BinaryJsonTest, RoundTrip) {
+  auto values = test::parse_json(R"([
+    {
+      "method": "LClass;.method:(LData;)V",
+      "generations": [
+        {"port": "Return", "taint": [{"kinds": [{"kind": "Source"}]}]},
+        {"port": "Argument(1)", "taint": [{"kinds": [{"kind": "Source"}]}]}
+      ],
+      "position": {"line": -1, "path": "Class.java"}
+    },
+    {
+      "method": "LClass;.method:(LData;)V",
+      "numbers": [0, -9223372036854775808, 18446744073709551615, 1.5],
+      "values": [true, false, null, "é\n", [], {}]
+    },
+    "string",
+    42
+  ])");
+  values[1]["values"].append(std::string("a\0b", 3));
+
+  BinaryJsonWriter writer;
+  for (const auto& value : values) {
+    writer.add(value);
+  }
+  std::stringstream stream;
+  writer.write(stream);
+
+  auto json = JsonValidation::to_styled_string(values);
+  EXPECT_LT(stream.str().size(), json.size());
+
+  BinaryJsonReader reader(stream);
+  auto decoded = Json::Value(Json::arrayValue);
+  while (auto value = reader.next()) {
+    decoded.append(*value);
+  }
+  EXPECT_EQ(decoded, values);
+  EXPECT_EQ(JsonValidation::to_styled_string(decoded), json);
+}
+
+TEST_F(BinaryJsonTest, InvalidInput) {
+  std::stringstream empty;
+  EXPECT_THROW(BinaryJsonReader{empty}, std::invalid_argument);
+
+  std::stringstream json("[1, 2]");
+  EXPECT_THROW(BinaryJsonReader{json}, std::invalid_argument);
+
+  BinaryJsonWriter writer;
+  writer.add(test::parse_json(R"({"key": "value"})"));
+  std::stringstream stream;
+  writer.write(stream);
+  auto truncated = stream.str();
+  truncated.pop_back();
+  std::stringstream truncated_stream(truncated);
+  BinaryJsonReader reader(truncated_stream);
+  EXPECT_THROW(reader.next(), std::invalid_argument);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/CacheStatistics.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class CacheStatisticsTest : public test::Test {};
+
+TEST_F(CacheStatisticsTest, CountsAcrossThreads) {
+  CacheStatistics::enable();
+  auto before = CacheStatistics::snapshot();
+
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back([]() {
+      for (int index = 0; index < 100; index++) {
+        CacheStatistics::lookup(
+            CacheStatistics::Cache::Kinds, /* hit */ index % 4 != 0);
+        if (index % 4 == 0) {
+          CacheStatistics::insert(CacheStatistics::Cache::Kinds);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  CacheStatistics::contention(CacheStatistics::Cache::TypeEnvironments);
+
+  auto value = CacheStatistics::to_json(
+      CacheStatistics::difference(CacheStatistics::snapshot(), before));
+  EXPECT_EQ(value["kinds"]["lookups"].asUInt64(), 400);
+  EXPECT_EQ(value["kinds"]["hits"].asUInt64(), 300);
+  EXPECT_EQ(value["kinds"]["inserts"].asUInt64(), 100);
+  EXPECT_EQ(value["kinds"]["contention"].asUInt64(), 0);
+  // Caches without lookups or inserts are omitted.
+  EXPECT_FALSE(value.isMember("type_environments"));
+  EXPECT_FALSE(value.isMember("positions"));
+}
+
+} // namespace marianatrench
@@ -246,6 +246,22 @@ TEST_F(CallGraphTest, ArtificialCallIndices) {
               context.methods->get(anonymous_class_for_iput_callees[1]),
               /* call_index */ 0),
       }));
+
+  // Visiting call targets yields the callees, then the artificial callees.
+  auto expected_targets = context.call_graph->callees(method);
+  EXPECT_EQ(
+      expected_targets.size(),
+      context.call_graph->call_targets(method).size());
+  expected_targets.insert(
+      expected_targets.end(),
+      artificial_callee_targets.begin(),
+      artificial_callee_targets.end());
+  std::vector<CallTarget> visited_targets;
+  context.call_graph->visit_call_targets(
+      method, [&visited_targets](const CallTarget& call_target) {
+        visited_targets.push_back(call_target);
+      });
+  EXPECT_EQ(visited_targets, expected_targets);
 }
 
 TEST_F(CallGraphTest, ShimCallIndices) {
@@ -461,4 +477,75 @@ TEST_F(CallGraphTest, ArrayAllocation) {
       expected_array_allocation_indices.end()));
 }
 
+TEST_F(CallGraphTest, ParameterTypeOverridesOfReadParameters) {
+  Scope scope;
+
+  auto* dex_anonymous_method =
+      redex::create_method(scope, "LMainActivity$1;", R"(
+        (method (public) "LMainActivity$1;.run:()V"
+         (
+          (load-param-object v0)
+          (return-void)
+         )
+        )
+      )");
+  auto dex_callees = redex::create_methods(
+      scope,
+      "LUtil;",
+      {R"(
+        (method (public static) "LUtil;.read:(LRunnable;)V"
+        (
+          (load-param-object v0)
+          (invoke-interface (v0) "LRunnable;.run:()V")
+          (return-void)
+        ))
+      )",
+       R"(
+        (method (public static) "LUtil;.ignore:(LRunnable;)V"
+        (
+          (load-param-object v0)
+          (return-void)
+        ))
+    )"});
+  auto* dex_method = redex::create_method(scope, "LMainActivity;", R"(
+    (method (public) "LMainActivity;.onCreate:()V"
+     (
+      (load-param-object v0)
+      (new-instance "LMainActivity$1;")
+      (move-result-pseudo-object v1)
+      (invoke-static (v1) "LUtil;.read:(LRunnable;)V")
+      (invoke-static (v1) "LUtil;.ignore:(LRunnable;)V")
+      (return-void)
+     )
+    )
+  )");
+  DexStore store("stores");
+  store.add_classes(scope);
+
+  auto context = test::make_context(store);
+  const auto* method = context.methods->get(dex_method);
+  auto parameter_type_overrides = ParameterTypeOverrides{
+      {0, dex_anonymous_method->get_class()}};
+  const auto* read =
+      context.methods->get(dex_callees[0], parameter_type_overrides);
+  const auto* ignore = context.methods->get(dex_callees[1]);
+
+  // The unread parameter of `ignore` does not create a variant.
+  std::vector<const Method*> callees;
+  for (const auto& callee : context.call_graph->callees(method)) {
+    callees.push_back(callee.resolved_base_callee());
+  }
+  EXPECT_THAT(callees, testing::UnorderedElementsAre(read, ignore));
+  EXPECT_EQ(context.methods->number_of_variants(), 1);
+
+  // Methods already having the maximum number of variants are not specialized.
+  EXPECT_EQ(
+      context.methods->create_bounded(
+          dex_callees[0],
+          ParameterTypeOverrides{{0, DexType::make_type("LOther$1;")}},
+          /* maximum_variants */ 0),
+      nullptr);
+  EXPECT_EQ(context.methods->number_of_bounded_variants(), 1);
+}
+
 } // namespace marianatrench
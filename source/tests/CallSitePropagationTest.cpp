@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <TypeUtil.h>
+
+#include <mariana-trench/CallSitePropagation.h>
+#include <mariana-trench/FeatureFactory.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class CallSitePropagationTest : public test::Test {};
+
+TEST_F(CallSitePropagationTest, ViaFeatures) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  const auto* callee = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "callee"));
+  const auto* type = type::java_lang_Object();
+
+  FeatureMayAlwaysSet extra_features;
+  std::vector<const DexType * MT_NULLABLE> source_register_types = {
+      type, nullptr};
+  std::vector<std::optional<std::string>> source_constant_arguments = {
+      std::nullopt, "constant"};
+  auto class_interval_context = CallClassIntervalContext();
+  auto caller_class_interval = ClassIntervals::Interval::top();
+  auto call_site = CallSitePropagation(
+      callee,
+      context.positions->get("Test.java", 1),
+      /* maximum_source_sink_distance */ 100,
+      extra_features,
+      context,
+      source_register_types,
+      source_constant_arguments,
+      class_interval_context,
+      caller_class_interval);
+
+  EXPECT_EQ(
+      call_site.via_type_of_feature(0),
+      context.feature_factory->get_via_type_of_feature(type));
+  // Features are materialized once per argument.
+  EXPECT_EQ(call_site.via_type_of_feature(0), call_site.via_type_of_feature(0));
+  EXPECT_EQ(
+      call_site.via_value_of_feature(1),
+      context.feature_factory->get_via_value_of_feature("constant"));
+  EXPECT_EQ(call_site.via_type_of_feature(2), nullptr);
+  EXPECT_EQ(call_site.via_value_of_feature(2), nullptr);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/CallsiteModelCache.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class CallsiteModelCacheTest : public test::Test {};
+
+TEST_F(CallsiteModelCacheTest, JoinedModels) {
+  Scope scope;
+  auto context = test::make_empty_context();
+  const auto* caller = context.methods->create(
+      redex::create_void_method(scope, "LCaller;", "caller"));
+  const auto* base = context.methods->create(
+      redex::create_void_method(scope, "LBase;", "callee"));
+
+  auto key = CallsiteModelCache::Key{
+      caller,
+      base,
+      /* position */ nullptr,
+      /* source_register_types */ {},
+      /* source_constant_arguments */ {},
+      CallClassIntervalContext(),
+      /* tainted_arguments */ std::nullopt};
+  auto base_model = std::make_shared<const Model>();
+  auto override_model = std::make_shared<const Model>();
+  auto joined_model = Model();
+
+  CallsiteModelCache cache;
+  EXPECT_EQ(cache.get_joined(key, {base_model, override_model}), std::nullopt);
+
+  cache.set_joined(key, {base_model, override_model}, joined_model);
+  EXPECT_EQ(
+      cache.get_joined(key, {base_model, override_model}), joined_model);
+
+  // Entries are invalidated by any change of the callee models.
+  auto new_override_model = std::make_shared<const Model>();
+  EXPECT_EQ(
+      cache.get_joined(key, {base_model, new_override_model}), std::nullopt);
+  EXPECT_EQ(cache.get_joined(key, {base_model}), std::nullopt);
+
+  // Non-joined entries are separate.
+  EXPECT_EQ(cache.get(key, base_model), std::nullopt);
+}
+
+TEST_F(CallsiteModelCacheTest, MaximumEntries) {
+  Scope scope;
+  auto context = test::make_empty_context();
+  const auto* caller = context.methods->create(
+      redex::create_void_method(scope, "LCaller;", "caller"));
+  const auto* one = context.methods->create(
+      redex::create_void_method(scope, "LOne;", "callee"));
+  const auto* two = context.methods->create(
+      redex::create_void_method(scope, "LTwo;", "callee"));
+
+  auto make_key = [caller](const Method* callee) {
+    return CallsiteModelCache::Key{
+        caller,
+        callee,
+        /* position */ nullptr,
+        /* source_register_types */ {},
+        /* source_constant_arguments */ {},
+        CallClassIntervalContext(),
+        /* tainted_arguments */ std::nullopt};
+  };
+  auto callee_model = std::make_shared<const Model>();
+  auto new_callee_model = std::make_shared<const Model>();
+
+  CallsiteModelCache cache(/* maximum_entries */ 1);
+  cache.set(make_key(one), callee_model, Model());
+  EXPECT_EQ(cache.size(), 1);
+
+  // New call sites are not cached once the cache is full.
+  cache.set(make_key(two), callee_model, Model());
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.get(make_key(two), callee_model), std::nullopt);
+
+  // Cached call sites are still updated.
+  cache.set(make_key(one), new_callee_model, Model());
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.get(make_key(one), new_callee_model), Model());
+}
+
+} // namespace marianatrench
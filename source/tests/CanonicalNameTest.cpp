@@ -9,6 +9,7 @@
 
 #include <mariana-trench/Access.h>
 #include <mariana-trench/CanonicalName.h>
+#include <mariana-trench/Frame.h>
 #include <mariana-trench/Redex.h>
 #include <mariana-trench/tests/Test.h>
 
@@ -73,4 +74,30 @@ TEST_F(CanonicalNameTest, Instantiate) {
       CanonicalName(CanonicalName::InstantiatedValue{"LClass;.one:()V"}));
 }
 
+TEST_F(CanonicalNameTest, Value) {
+  auto template_name = CanonicalName(CanonicalName::TemplateValue{"name"});
+  auto instantiated_name =
+      CanonicalName(CanonicalName::InstantiatedValue{"name"});
+
+  EXPECT_TRUE(template_name.is_template());
+  EXPECT_FALSE(template_name.is_instantiated());
+  EXPECT_TRUE(instantiated_name.is_instantiated());
+  EXPECT_EQ(template_name.value(), "name");
+  EXPECT_EQ(instantiated_name.value(), "name");
+
+  // Template and instantiated names with the same string are distinct.
+  EXPECT_NE(template_name, instantiated_name);
+  EXPECT_EQ(
+      (CanonicalNameSetAbstractDomain{template_name, instantiated_name})
+          .elements()
+          .size(),
+      2);
+
+  EXPECT_EQ(
+      template_name.to_json(), test::parse_json(R"({"template": "name"})"));
+  EXPECT_EQ(
+      instantiated_name.to_json(),
+      test::parse_json(R"({"instantiated": "name"})"));
+}
+
 } // namespace marianatrench
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <ControlFlow.h>
+#include <IRCode.h>
+
+#include <mariana-trench/Checkpoint.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class CheckpointTest : public test::Test {};
+
+TEST_F(CheckpointTest, RoundTrip) {
+  Scope scope;
+  auto* dex_method = redex::create_method(scope, "LClass;", R"(
+    (method (public) "LClass;.method:(Ljava/lang/Object;)Ljava/lang/Object;"
+     (
+      (load-param-object v0)
+      (load-param-object v1)
+      (return-object v1)
+     )
+    )
+  )");
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      "LClass;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* method = context.methods->get(dex_method);
+  const auto* callee = context.methods->get(dex_callee);
+
+  const IRInstruction* return_instruction = nullptr;
+  for (const auto* block : method->get_code()->cfg().blocks()) {
+    for (const auto& entry : InstructionIterable(block)) {
+      return_instruction = entry.insn;
+    }
+  }
+  ASSERT_NE(return_instruction, nullptr);
+  const auto* call_position = context.positions->get(
+      std::string("Class.java"),
+      /* line */ 2,
+      Root(Root::Kind::Return),
+      return_instruction);
+  const auto* local_position = context.positions->get(
+      std::string("Class.java"), /* line */ 1, std::nullopt, nullptr, 3, 7);
+
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  const auto* sink_kind = context.kind_factory->get("TestSink");
+  const auto* feature = context.feature_factory->get("feature");
+
+  auto model = Model(method, context);
+  model.add_generation(
+      AccessPath(Root(Root::Kind::Return)),
+      test::make_taint_config(
+          source_kind,
+          test::FrameProperties{
+              .callee_port = AccessPath(Root(Root::Kind::Return)),
+              .callee = callee,
+              .call_position = call_position,
+              .distance = 2,
+              .inferred_features = FeatureMayAlwaysSet::make_may({feature}),
+              .locally_inferred_features =
+                  FeatureMayAlwaysSet::make_always({feature}),
+              .local_positions = {local_position},
+              .call_kind = CallKind::callsite()}));
+  model.add_sink(
+      AccessPath(Root(Root::Kind::Argument, 1)),
+      test::make_leaf_taint_config(sink_kind));
+
+  auto path = std::filesystem::temp_directory_path() /
+      "mariana-trench-checkpoint.json";
+
+  {
+    auto registry = Registry(context);
+    registry.set(model);
+    ConcurrentMethodSet methods_to_analyze(*context.methods);
+    methods_to_analyze.insert(method);
+    Checkpoint::store(
+        path, /* iteration */ 3, methods_to_analyze, context, registry);
+  }
+
+  {
+    auto registry = Registry(context);
+    auto state = Checkpoint::load(path, context, registry);
+    EXPECT_EQ(state.iteration, 3);
+    EXPECT_EQ(state.methods_to_analyze, std::vector<const Method*>{method});
+    EXPECT_EQ(registry.get(method), model);
+    EXPECT_EQ(registry.get(callee), Model(callee, context));
+  }
+
+  std::filesystem::remove(path);
+}
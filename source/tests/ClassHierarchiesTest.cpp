@@ -93,4 +93,18 @@ TEST_F(ClassHierarchiesTest, ClassHierarchies) {
   EXPECT_TRUE(class_hierarchies.extends(dex_child_two->get_class()).empty());
   EXPECT_TRUE(
       class_hierarchies.extends(dex_child_one_child->get_class()).empty());
+
+  EXPECT_TRUE(class_hierarchies.has_extends(dex_child_one->get_class()));
+  EXPECT_FALSE(class_hierarchies.has_extends(dex_child_two->get_class()));
+
+  std::vector<const DexType*> visited;
+  class_hierarchies.visit_extends(
+      dex_parent->get_class(),
+      [&visited](const DexType* extend) { visited.push_back(extend); });
+  EXPECT_THAT(
+      visited,
+      testing::UnorderedElementsAre(
+          dex_child_one->get_class(),
+          dex_child_two->get_class(),
+          dex_child_one_child->get_class()));
 }
@@ -51,6 +51,7 @@ TEST_F(ClassIntervalsTest, IntervalComputation) {
       redex::create_class(scope, "LDerivedB1_1;", b1->get_type());
 
   auto context = test_context(scope);
+  EXPECT_TRUE(context.class_intervals->enabled());
 
   auto interval_a = context.class_intervals->get_interval(a->get_type());
   EXPECT_EQ(ClassIntervals::Interval::finite(2, 7), interval_a);
@@ -74,3 +75,25 @@ TEST_F(ClassIntervalsTest, IntervalComputation) {
       context.class_intervals->get_interval(type::java_lang_Object());
   EXPECT_EQ(ClassIntervals::Interval::finite(1, 14), interval_object);
 }
+
+TEST_F(ClassIntervalsTest, Snapshot) {
+  Scope scope;
+  const auto* base = redex::create_class(scope, "LBase;");
+  const auto* derived =
+      redex::create_class(scope, "LDerived;", base->get_type());
+
+  auto context = test_context(scope);
+  auto snapshot = context.class_intervals->to_snapshot();
+  auto class_intervals =
+      ClassIntervals::from_snapshot(*context.options, snapshot);
+  ASSERT_NE(class_intervals, nullptr);
+  EXPECT_EQ(class_intervals->to_json(), context.class_intervals->to_json());
+  EXPECT_EQ(
+      class_intervals->get_interval(derived->get_type()),
+      ClassIntervals::Interval::finite(3, 4));
+
+  // Snapshots with unknown classes are ignored.
+  snapshot.emplace_back("LUnknown;", std::vector<std::string>{"1", "2"});
+  EXPECT_EQ(
+      ClassIntervals::from_snapshot(*context.options, snapshot), nullptr);
+}
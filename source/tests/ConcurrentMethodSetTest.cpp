@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/ConcurrentMethodSet.h>
+#include <mariana-trench/Methods.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+namespace {
+
+class ConcurrentMethodSetTest : public test::Test {};
+
+} // namespace
+
+TEST_F(ConcurrentMethodSetTest, MethodIds) {
+  Scope scope;
+  auto* dex_one = redex::create_void_method(scope, "LClass;", "one");
+  auto* dex_two = redex::create_void_method(scope, "LClass;", "two");
+
+  Methods methods;
+  const auto* one = methods.create(dex_one);
+  const auto* two = methods.create(dex_two);
+  const auto* two_with_overrides =
+      methods.create(dex_two, {{0, type::java_lang_String()}});
+
+  EXPECT_EQ(one->id(), 0);
+  EXPECT_EQ(two->id(), 1);
+  EXPECT_EQ(two_with_overrides->id(), 2);
+  EXPECT_EQ(methods.create(dex_one), one);
+  EXPECT_EQ(methods.number_of_ids(), 3);
+}
+
+TEST_F(ConcurrentMethodSetTest, InsertContains) {
+  Scope scope;
+  auto* dex_one = redex::create_void_method(scope, "LClass;", "one");
+  auto* dex_two = redex::create_void_method(scope, "LClass;", "two");
+
+  Methods methods;
+  const auto* one = methods.create(dex_one);
+  const auto* two = methods.create(dex_two);
+
+  ConcurrentMethodSet set(methods);
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_TRUE(set.insert(one));
+  EXPECT_FALSE(set.insert(one));
+  EXPECT_EQ(set.size(), 1);
+  EXPECT_TRUE(set.contains(one));
+  EXPECT_FALSE(set.contains(two));
+
+  std::vector<const Method*> visited;
+  set.visit([&](const Method* method) { visited.push_back(method); });
+  EXPECT_THAT(visited, testing::ElementsAre(one));
+}
+
+} // namespace marianatrench
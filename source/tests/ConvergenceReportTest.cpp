@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/ConvergenceReport.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ConvergenceReportTest : public test::Test {};
+
+TEST_F(ConvergenceReportTest, Report) {
+  Scope scope;
+  auto* dex_callee =
+      redex::create_void_method(scope, "LCallee;", "callee", "LData;");
+  auto* dex_first_caller =
+      redex::create_void_method(scope, "LCaller;", "first", "LData;");
+  auto* dex_second_caller =
+      redex::create_void_method(scope, "LCaller;", "second", "LData;");
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* callee = context.methods->get(dex_callee);
+  auto* first_caller = context.methods->get(dex_first_caller);
+  auto* second_caller = context.methods->get(dex_second_caller);
+
+  auto previous_model = Model(callee, context);
+  auto new_model = Model(
+      callee,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */ {},
+      /* parameter_sources */ {},
+      /* sinks */
+      {{AccessPath(Root(Root::Kind::Argument, 1)),
+        test::make_leaf_taint_config(context.kind_factory->get("Sink"))}});
+  std::vector<const Method*> callers = {first_caller, second_caller};
+
+  ConvergenceReport report;
+  report.analyzed(/* iteration */ 1, callee);
+  report.changed(
+      /* iteration */ 1,
+      callee,
+      previous_model,
+      new_model,
+      ConvergenceReport::Callers(
+          callers.data(), callers.data() + callers.size()));
+  report.analyzed(/* iteration */ 1, first_caller);
+  report.analyzed(/* iteration */ 1, second_caller);
+  report.analyzed(/* iteration */ 2, first_caller);
+  EXPECT_EQ(report.analyses(first_caller), 2);
+  EXPECT_EQ(report.analyses(callee), 1);
+
+  auto value = report.to_json();
+  ASSERT_EQ(value["iterations"].size(), 2);
+  EXPECT_EQ(value["iterations"][0]["methods_analyzed"].asUInt(), 3);
+  EXPECT_EQ(value["iterations"][0]["models_changed"].asUInt(), 1);
+  EXPECT_EQ(
+      value["iterations"][0]["changed_components"]["sinks"].asUInt(), 1);
+  EXPECT_EQ(
+      value["iterations"][0]["changed_components"]["generations"].asUInt(),
+      0);
+  EXPECT_EQ(value["iterations"][1]["models_changed"].asUInt(), 0);
+
+  ASSERT_EQ(value["methods_with_most_analyses"].size(), 1);
+  const auto& most_analyses = value["methods_with_most_analyses"][0];
+  EXPECT_EQ(
+      most_analyses["method"].asString(), "LCaller;.first:(LData;)V");
+  EXPECT_EQ(most_analyses["analyses"].asUInt(), 2);
+  ASSERT_EQ(most_analyses["triggers"].size(), 1);
+  EXPECT_EQ(
+      most_analyses["triggers"][0]["callee"].asString(),
+      "LCallee;.callee:(LData;)V");
+
+  ASSERT_EQ(value["callees_causing_most_invalidations"].size(), 1);
+  const auto& most_invalidations =
+      value["callees_causing_most_invalidations"][0];
+  EXPECT_EQ(
+      most_invalidations["method"].asString(), "LCallee;.callee:(LData;)V");
+  EXPECT_EQ(most_invalidations["invalidations"].asUInt64(), 2);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Daemon.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class DaemonTest : public test::Test {};
+
+TEST_F(DaemonTest, Handle) {
+  Scope scope;
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      "LCallee;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LCallee;.callee:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* callee = context.methods->get(dex_callee);
+  const auto* caller = context.methods->get(dex_caller);
+
+  auto registry = Registry(context);
+  Daemon daemon(context, registry);
+
+  auto response = daemon.handle(
+      context,
+      registry,
+      test::parse_json(R"({
+        "models": [
+          {
+            "method": "LCallee;.callee:()Ljava/lang/Object;",
+            "generations": [{"kind": "TestSource", "port": "Return"}]
+          }
+        ]
+      })"));
+  EXPECT_EQ(JsonValidation::integer(response, "invalidated_methods"), 2);
+  EXPECT_FALSE(registry.get(callee).generations().is_bottom());
+  EXPECT_FALSE(registry.get(caller).generations().is_bottom());
+
+  // Requests for other methods keep the models joined by earlier requests.
+  daemon.handle(
+      context, registry, test::parse_json(R"({"classes": ["LCaller;"]})"));
+  EXPECT_FALSE(registry.get(caller).generations().is_bottom());
+
+  EXPECT_THROW(
+      daemon.handle(
+          context,
+          registry,
+          test::parse_json(R"({"methods": ["LUnknown;.unknown:()V"]})")),
+      JsonValidationError);
+}
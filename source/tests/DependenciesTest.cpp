@@ -57,8 +57,13 @@ Context test_dependencies(const Scope& scope) {
   context.types = std::make_unique<Types>(*context.options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
   context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
   context.fields = std::make_unique<Fields>();
   context.call_graph = std::make_unique<CallGraph>(
       *context.options,
@@ -156,6 +161,32 @@ TEST_F(DependenciesTest, InvokeDirect) {
       dependencies.dependencies(callee), testing::UnorderedElementsAre(caller));
 }
 
+TEST_F(DependenciesTest, DuplicateCalls) {
+  Scope scope;
+
+  auto* dex_callee = redex::create_void_method(scope, "LCallee;", "callee");
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public) "LCaller;.caller:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LCallee;.callee:()V")
+      (invoke-direct (v0) "LCallee;.callee:()V")
+      (invoke-direct (v0) "LCallee;.callee:()V")
+      (return-void)
+     )
+    )
+  )");
+
+  auto context = test_dependencies(scope);
+  const auto& dependencies = *context.dependencies;
+  auto* callee = context.methods->get(dex_callee);
+  auto* caller = context.methods->get(dex_caller);
+
+  EXPECT_TRUE(dependencies.dependencies(caller).empty());
+  EXPECT_THAT(
+      dependencies.dependencies(callee), testing::ElementsAre(caller));
+}
+
 TEST_F(DependenciesTest, Recursion) {
   Scope scope;
 
@@ -183,8 +214,9 @@ TEST_F(DependenciesTest, Recursion) {
 
   EXPECT_TRUE(call_graph.artificial_callees(recursive).empty());
 
-  EXPECT_EQ(dependencies.dependencies(recursive).size(), 1);
-  EXPECT_EQ(dependencies.dependencies(recursive).count(recursive), 1);
+  EXPECT_THAT(
+      dependencies.dependencies(recursive),
+      testing::ElementsAre(recursive));
 }
 
 TEST_F(DependenciesTest, MultipleCallees) {
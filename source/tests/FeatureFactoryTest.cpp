@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <DexClass.h>
+
+#include <mariana-trench/FeatureFactory.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class FeatureFactoryTest : public test::Test {};
+
+TEST_F(FeatureFactoryTest, MemoizedFeatures) {
+  FeatureFactory factory;
+  const auto* type = DexType::make_type("LClass;");
+
+  // Memoized features are the features of the corresponding strings.
+  const auto* via_type = factory.get_via_type_of_feature(type);
+  EXPECT_EQ(via_type, factory.get("via-type:LClass;"));
+  EXPECT_EQ(factory.get_via_type_of_feature(type), via_type);
+  EXPECT_EQ(
+      factory.get_via_type_of_feature(nullptr),
+      factory.get("via-type:unknown"));
+  EXPECT_EQ(factory.get_via_cast_feature(type), factory.get("via-cast:LClass;"));
+  EXPECT_NE(factory.get_via_cast_feature(type), via_type);
+  EXPECT_EQ(
+      factory.get_via_shim_feature(nullptr), factory.get("via-shim:unknown"));
+
+  EXPECT_EQ(
+      factory.get_widen_broadening_feature(),
+      factory.get("via-widen-broadening"));
+  EXPECT_EQ(
+      factory.get_issue_broadening_feature(),
+      factory.get("via-issue-broadening"));
+}
+
+} // namespace marianatrench
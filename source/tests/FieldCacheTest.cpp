@@ -47,8 +47,10 @@ Context test_fields(const Scope& scope) {
   context.types = std::make_unique<Types>(*context.options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
-  context.field_cache =
-      std::make_unique<FieldCache>(*context.class_hierarchies, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
+  context.field_cache = std::make_unique<FieldCache>(
+      *context.class_hierarchies, *context.class_intervals, context.stores);
   return context;
 }
 
@@ -69,6 +71,17 @@ TEST_F(FieldCacheTest, FieldCache) {
       {{"mDerived", type::java_lang_String()},
        {"mBase", redex::get_type("LBase;")}},
       /* super */ redex::get_type("LBase;"));
+  redex::create_fields(
+      scope,
+      /* class_name */ "LDerivedDerived;",
+      /* fields */
+      {{"mBase", redex::get_type("LDerived;")}},
+      /* super */ redex::get_type("LDerived;"));
+  redex::create_fields(
+      scope,
+      /* class_name */ "LOther;",
+      /* fields */
+      {{"mBase", type::java_lang_Object()}});
 
   auto context = test_fields(scope);
   const auto& field_cache = *context.field_cache;
@@ -77,7 +90,9 @@ TEST_F(FieldCacheTest, FieldCache) {
       field_cache.field_types(
           redex::get_type("LBase;"), DexString::make_string("mBase")),
       testing::UnorderedElementsAre(
-          type::java_lang_String(), redex::get_type("LBase;")));
+          type::java_lang_String(),
+          redex::get_type("LBase;"),
+          redex::get_type("LDerived;")));
   EXPECT_TRUE(field_cache
                   .field_types(
                       redex::get_type("LBase;"),
@@ -91,7 +106,14 @@ TEST_F(FieldCacheTest, FieldCache) {
       field_cache.field_types(
           redex::get_type("LDerived;"), DexString::make_string("mBase")),
       testing::UnorderedElementsAre(
-          type::java_lang_String(), redex::get_type("LBase;")));
+          type::java_lang_String(),
+          redex::get_type("LBase;"),
+          redex::get_type("LDerived;")));
+  // Siblings in the hierarchy are not included.
+  EXPECT_THAT(
+      field_cache.field_types(
+          redex::get_type("LOther;"), DexString::make_string("mBase")),
+      testing::UnorderedElementsAre(type::java_lang_Object()));
   EXPECT_TRUE(field_cache
                   .field_types(
                       redex::get_type("LClassDoesNotExist;"),
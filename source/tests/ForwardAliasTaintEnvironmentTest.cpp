@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/ForwardAliasTaintEnvironment.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ForwardAliasTaintEnvironmentTest : public test::Test {};
+
+TEST_F(ForwardAliasTaintEnvironmentTest, Product) {
+  auto context = test::make_empty_context();
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  EXPECT_TRUE(ForwardAliasTaintEnvironment().is_bottom());
+  auto initial = ForwardAliasTaintEnvironment::initial();
+  EXPECT_FALSE(initial.is_bottom());
+  EXPECT_TRUE(initial.taint().is_bottom());
+  EXPECT_TRUE(ForwardAliasTaintEnvironment().leq(initial));
+
+  auto tainted = ForwardAliasTaintEnvironment(
+      ForwardAliasEnvironment(),
+      ForwardTaintEnvironment(TaintEnvironment{
+          {nullptr,
+           TaintTree{Taint{test::make_leaf_taint_config(source_kind)}}}}));
+  EXPECT_FALSE(initial.leq(tainted));
+  EXPECT_FALSE(tainted.leq(initial));
+
+  auto joined = initial;
+  joined.join_with(tainted);
+  EXPECT_TRUE(initial.leq(joined));
+  EXPECT_TRUE(tainted.leq(joined));
+  EXPECT_TRUE(joined.alias().equals(initial.alias()));
+  EXPECT_TRUE(joined.taint().equals(tainted.taint()));
+}
+
+} // namespace marianatrench
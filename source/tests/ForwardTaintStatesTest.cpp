@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <IRCode.h>
+
+#include <mariana-trench/ForwardAliasFixpoint.h>
+#include <mariana-trench/ForwardAliasTransfer.h>
+#include <mariana-trench/ForwardTaintStates.h>
+#include <mariana-trench/ForwardTaintTransfer.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class ForwardTaintStatesTest : public test::Test {};
+
+TEST_F(ForwardTaintStatesTest, Run) {
+  Scope scope;
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      "LCallee;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LCallee;.callee:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* callee = context.methods->get(dex_callee);
+  const auto* caller = context.methods->get(dex_caller);
+  const auto& cfg = caller->get_code()->cfg();
+
+  auto registry = Registry(context);
+  auto forward_alias_results = std::make_shared<ForwardAliasResults>(caller);
+  ForwardTaintStates states;
+
+  auto analyze = [&](bool expected_incremental) {
+    auto previous_model = registry.get(caller);
+    auto new_model = previous_model.initial_model_for_iteration();
+    MethodContext method_context(
+        context,
+        registry,
+        previous_model,
+        new_model,
+        forward_alias_results,
+        Deadline());
+    ForwardAliasFixpoint(
+        method_context,
+        cfg,
+        InstructionAnalyzerCombiner<ForwardAliasTransfer>(&method_context))
+        .run(ForwardAliasEnvironment::initial());
+    auto fixpoint = ForwardTaintFixpoint(
+        method_context,
+        cfg,
+        InstructionAnalyzerCombiner<ForwardTaintTransfer>(&method_context));
+    EXPECT_EQ(states.run(method_context, cfg, fixpoint), expected_incremental);
+    return new_model;
+  };
+
+  auto model = analyze(/* expected_incremental */ false);
+  EXPECT_TRUE(model.generations().is_bottom());
+
+  // The call to the callee is analyzed again once its model changes.
+  auto callee_model = Model(callee, context);
+  callee_model.add_generation(
+      AccessPath(Root(Root::Kind::Return)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSource")));
+  registry.set(callee_model);
+  model = analyze(/* expected_incremental */ true);
+  EXPECT_FALSE(model.generations().is_bottom());
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/FrameInterner.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class FrameInternerTest : public test::Test {};
+
+TEST_F(FrameInternerTest, Intern) {
+  auto context = test::make_empty_context();
+  const auto* kind = context.kind_factory->get("TestSource");
+  const auto* feature = context.feature_factory->get("FeatureOne");
+
+  auto frame_one = test::make_taint_frame(
+      kind, test::FrameProperties{.distance = 1});
+  auto frame_two = test::make_taint_frame(
+      kind, test::FrameProperties{.distance = 1});
+  auto frame_three = test::make_taint_frame(
+      kind, test::FrameProperties{.distance = 2});
+
+  FrameInterner interner;
+  auto interned_one = interner.intern(frame_one);
+  auto interned_two = interner.intern(frame_two);
+  EXPECT_EQ(interner.size(), 1);
+  EXPECT_EQ(interned_one, frame_one);
+  EXPECT_EQ(interned_two, frame_two);
+
+  auto interned_three = interner.intern(frame_three);
+  EXPECT_EQ(interner.size(), 2);
+  EXPECT_EQ(interned_three, frame_three);
+
+  // Interned data is copied on write.
+  interned_two.add_user_features(FeatureSet{feature});
+  EXPECT_EQ(interned_one, frame_one);
+  EXPECT_NE(interned_two, frame_two);
+  EXPECT_EQ(interner.intern(interned_one), frame_one);
+  EXPECT_EQ(interner.size(), 2);
+
+  // Frames without data are not interned.
+  EXPECT_EQ(interner.intern(Frame::bottom()), Frame::bottom());
+  EXPECT_EQ(interner.size(), 2);
+}
+
+} // namespace marianatrench
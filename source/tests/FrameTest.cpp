@@ -524,4 +524,110 @@ TEST_F(FrameTest, FrameWithKind) {
   EXPECT_EQ(frame2.kind(), kind_b);
 }
 
+TEST_F(FrameTest, FrameCopyOnWrite) {
+  Scope scope;
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+
+  auto* one = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "one"));
+  auto* leaf =
+      context.access_path_factory->get(AccessPath(Root(Root::Kind::Leaf)));
+  auto* one_origin = context.origin_factory->method_origin(one, leaf);
+  auto* feature_one = context.feature_factory->get("FeatureOne");
+
+  auto frame1 = test::make_taint_frame(
+      /* kind */ context.kind_factory->get("TestSource"),
+      test::FrameProperties{.distance = 1});
+  auto frame2 = frame1;
+  EXPECT_TRUE(frame1.leq(frame2));
+  EXPECT_TRUE(frame1.equals(frame2));
+
+  // Modifying a copy does not modify the original frame.
+  frame2.add_origin(one, leaf);
+  frame2.add_user_features(FeatureSet{feature_one});
+  EXPECT_EQ(frame1.origins(), OriginSet{});
+  EXPECT_EQ(frame1.user_features(), FeatureSet{});
+  EXPECT_EQ(frame2.origins(), OriginSet{one_origin});
+  EXPECT_EQ(frame2.user_features(), FeatureSet{feature_one});
+  EXPECT_TRUE(frame1.leq(frame2));
+  EXPECT_FALSE(frame2.leq(frame1));
+
+  auto frame3 = frame2;
+  frame3.join_with(frame1);
+  EXPECT_EQ(frame3, frame2);
+  EXPECT_EQ(frame1.origins(), OriginSet{});
+
+  // Frames with the same data but different kinds are not comparable.
+  auto frame4 = frame1.with_kind(context.kind_factory->get("OtherSource"));
+  EXPECT_FALSE(frame4.leq(frame1));
+  EXPECT_FALSE(frame4.equals(frame1));
+}
+
+TEST_F(FrameTest, FrameExtraTraces) {
+  Scope scope;
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+
+  auto* one = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "one"));
+  const auto* kind = context.kind_factory->get("TestSource");
+  const auto* propagation_kind = context.kind_factory->local_return();
+  const auto* position = context.positions->get(std::nullopt, 1);
+  const auto* port =
+      context.access_path_factory->get(AccessPath(Root(Root::Kind::Return)));
+  auto make_extra_trace = [&](const Method* callee) {
+    return ExtraTrace(
+        propagation_kind,
+        callee,
+        position,
+        port,
+        CallKind::propagation_with_trace(CallKind::CallSite));
+  };
+
+  auto frame1 = test::make_taint_frame(kind, test::FrameProperties{});
+  auto frame2 = frame1;
+  frame1.add_extra_trace(make_extra_trace(one));
+  frame2.add_extra_trace(make_extra_trace(one));
+
+  EXPECT_TRUE(frame1.equals(frame2));
+  EXPECT_TRUE(test::make_taint_frame(kind, test::FrameProperties{})
+                  .leq(frame1));
+  EXPECT_FALSE(frame1.leq(
+      test::make_taint_frame(kind, test::FrameProperties{})));
+
+  auto frame3 = test::make_taint_frame(kind, test::FrameProperties{});
+  frame3.add_extra_trace(make_extra_trace(/* callee */ nullptr));
+  auto frame4 = frame1;
+  frame4.join_with(frame3);
+  EXPECT_EQ(frame4.extra_traces().size(), 2);
+  EXPECT_EQ(frame1.extra_traces().size(), 1);
+  EXPECT_TRUE(frame1.leq(frame4));
+  EXPECT_TRUE(frame3.leq(frame4));
+  EXPECT_FALSE(frame4.leq(frame1));
+}
+
+TEST_F(FrameTest, FrameHasViaPorts) {
+  auto context = test::make_empty_context();
+  const auto* kind = context.kind_factory->get("TestSource");
+
+  EXPECT_FALSE(Frame().has_via_ports());
+  EXPECT_FALSE(test::make_taint_frame(kind, test::FrameProperties{})
+                   .has_via_ports());
+  EXPECT_TRUE(test::make_taint_frame(
+                  kind,
+                  test::FrameProperties{
+                      .via_type_of_ports = RootSetAbstractDomain(
+                          {Root(Root::Kind::Argument, 1)})})
+                  .has_via_ports());
+  EXPECT_TRUE(test::make_taint_frame(
+                  kind,
+                  test::FrameProperties{
+                      .via_value_of_ports = RootSetAbstractDomain(
+                          {Root(Root::Kind::Argument, 0)})})
+                  .has_via_ports());
+}
+
 } // namespace marianatrench
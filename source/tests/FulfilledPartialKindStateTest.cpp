@@ -139,4 +139,69 @@ TEST_F(FulfilledPartialKindStateTest, Basic) {
           context.kind_factory->get_triggered(unfulfilled, rule_2.get())));
 }
 
+TEST_F(FulfilledPartialKindStateTest, FulfillTwice) {
+  auto scope = Scope();
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+
+  auto state = FulfilledPartialKindState();
+  EXPECT_TRUE(state.empty());
+
+  const auto feature_1 = context.feature_factory->get("Feature1");
+  const auto feature_2 = context.feature_factory->get("Feature2");
+  const auto* source_1 = context.kind_factory->get("Source1");
+  const auto* source_2 = context.kind_factory->get("Source2");
+  const auto* fulfilled = context.kind_factory->get_partial("Partial", "a");
+  const auto* unfulfilled = context.kind_factory->get_partial("Partial", "b");
+
+  auto rule = std::make_unique<MultiSourceMultiSinkRule>(
+      /* name */ "Rule",
+      /* code */ 1,
+      /* description */ "rule",
+      /* multi_source_kinds */
+      MultiSourceMultiSinkRule::MultiSourceKindsByLabel{
+          {"a", Rule::KindSet{source_1}}, {"b", Rule::KindSet{source_2}}},
+      /* partial_sink_kinds */
+      MultiSourceMultiSinkRule::PartialKindSet{fulfilled, unfulfilled});
+
+  auto sink = Taint{
+      test::make_taint_config(/* kind */ fulfilled, test::FrameProperties{})};
+  EXPECT_EQ(
+      std::nullopt,
+      state.fulfill_kind(
+          fulfilled,
+          rule.get(),
+          FeatureMayAlwaysSet{feature_1},
+          sink,
+          *context.kind_factory));
+  EXPECT_EQ(
+      std::nullopt,
+      state.fulfill_kind(
+          fulfilled,
+          rule.get(),
+          FeatureMayAlwaysSet{feature_2},
+          sink,
+          *context.kind_factory));
+
+  // The features of the first flow are kept.
+  EXPECT_FALSE(state.empty());
+  EXPECT_EQ(
+      FeatureMayAlwaysSet{feature_1}, state.get_features(fulfilled, rule.get()));
+  EXPECT_THROW(
+      state.get_features(unfulfilled, rule.get()), std::out_of_range);
+
+  // Fulfilling the counterpart triggers the rule and clears the state.
+  EXPECT_TRUE(state
+                  .fulfill_kind(
+                      unfulfilled,
+                      rule.get(),
+                      FeatureMayAlwaysSet{},
+                      Taint{test::make_taint_config(
+                          /* kind */ unfulfilled, test::FrameProperties{})},
+                      *context.kind_factory)
+                  .has_value());
+  EXPECT_TRUE(state.empty());
+}
+
 } // namespace marianatrench
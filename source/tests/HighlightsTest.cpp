@@ -5,6 +5,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+#include <fstream>
+
 #include <gmock/gmock.h>
 
 #include <IROpcode.h>
@@ -186,6 +189,45 @@ TEST_F(HighlightsTest, TestGeneratedBounds) {
           argument_port0));
 }
 
+TEST_F(HighlightsTest, TestFileLines) {
+  using FileLines = Highlights::FileLines;
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-highlights-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  auto path = directory / "File.java";
+  std::ofstream(path) << "class File {\n\n  method();\n}";
+  auto lines = FileLines(path);
+  EXPECT_FALSE(lines.has_line_number(0));
+  EXPECT_TRUE(lines.has_line_number(3));
+  EXPECT_EQ(lines.line(3), "  method();");
+  EXPECT_EQ(lines.line(1), "class File {");
+  EXPECT_EQ(lines.line(2), "");
+  EXPECT_EQ(lines.line(4), "}");
+  EXPECT_FALSE(lines.has_line_number(5));
+  EXPECT_EQ(lines.size(), 4);
+
+  path = directory / "Trailing.java";
+  std::ofstream(path) << "method();\n";
+  lines = FileLines(path);
+  EXPECT_EQ(lines.size(), 1);
+  EXPECT_EQ(lines.line(1), "method();");
+
+  path = directory / "Empty.java";
+  std::ofstream(path).close();
+  lines = FileLines(path);
+  EXPECT_EQ(lines.size(), 0);
+  EXPECT_FALSE(lines.has_line_number(1));
+
+  lines = FileLines(std::vector<std::string>{"", "method();", ""});
+  EXPECT_EQ(lines.size(), 3);
+  EXPECT_EQ(lines.line(2), "method();");
+  EXPECT_EQ(lines.line(3), "");
+
+  std::filesystem::remove_all(directory);
+}
+
 TEST_F(HighlightsTest, TestFilterOverlappingHighlights) {
   auto context = test::make_empty_context();
   const auto* position1 =
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/IndexedModelFile.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class IndexedModelFileTest : public test::Test {};
+
+TEST_F(IndexedModelFileTest, Visit) {
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-indexed-model-file-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  auto path = directory / "models.json";
+  std::ofstream(path) << R"([
+    {"method": "LClass;.one:()V", "generations": []},
+    {"method": {"name": "LClass;.two:()V"}, "sinks": []},
+    {"method": "LOther;.three:()V"}
+  ])";
+
+  auto visit = [&](const IndexedModelFile& file) {
+    std::mutex mutex;
+    std::vector<std::string> methods;
+    auto visited = file.visit(
+        [](std::string_view signature) {
+          return signature.rfind("LClass;", 0) == 0;
+        },
+        [&](const Json::Value& value) {
+          std::lock_guard<std::mutex> lock(mutex);
+          methods.push_back(JsonValidation::to_styled_string(value["method"]));
+        });
+    EXPECT_EQ(visited, methods.size());
+    return methods;
+  };
+  auto styled = [](const std::string& json) {
+    return JsonValidation::to_styled_string(test::parse_json(json));
+  };
+
+  {
+    IndexedModelFile file(path);
+    EXPECT_EQ(file.size(), 3);
+    EXPECT_THAT(
+        visit(file),
+        testing::UnorderedElementsAre(
+            styled(R"("LClass;.one:()V")"),
+            styled(R"({"name": "LClass;.two:()V"})")));
+  }
+  EXPECT_TRUE(std::filesystem::exists(IndexedModelFile::index_path(path)));
+
+  // The stored index gives the same models.
+  {
+    IndexedModelFile file(path);
+    EXPECT_EQ(file.size(), 3);
+    EXPECT_THAT(
+        visit(file),
+        testing::UnorderedElementsAre(
+            styled(R"("LClass;.one:()V")"),
+            styled(R"({"name": "LClass;.two:()V"})")));
+  }
+
+  // The index is rebuilt when the file changes.
+  std::ofstream(path) << R"([{"method": "LClass;.four:()V"}])";
+  std::filesystem::last_write_time(
+      path,
+      std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+  {
+    IndexedModelFile file(path);
+    EXPECT_EQ(file.size(), 1);
+    EXPECT_THAT(
+        visit(file),
+        testing::UnorderedElementsAre(styled(R"("LClass;.four:()V")")));
+  }
+
+  std::ofstream(path) << "[// comment\n]";
+  EXPECT_THROW(IndexedModelFile{path}, std::invalid_argument);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/IssueIndex.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/SourceSinkRule.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class IssueIndexTest : public test::Test {};
+
+TEST_F(IssueIndexTest, MergeAcrossMethods) {
+  auto context = test::make_empty_context();
+
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  const auto* other_source_kind = context.kind_factory->get("OtherSource");
+  const auto* sink_kind = context.kind_factory->get("TestSink");
+  SourceSinkRule rule(
+      "rule",
+      1,
+      "description",
+      {source_kind, other_source_kind},
+      {sink_kind},
+      /* transforms */ nullptr);
+  const auto* position_1 = context.positions->get(std::nullopt, 1);
+  const auto* position_2 = context.positions->get(std::nullopt, 2);
+
+  Scope scope;
+  const auto* one = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "one"));
+  const auto* two = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "two"));
+
+  IssueIndex index;
+  index.add(
+      one,
+      IssueSet{Issue(
+          /* source */ Taint{test::make_leaf_taint_config(source_kind)},
+          /* sink */ Taint{test::make_leaf_taint_config(sink_kind)},
+          &rule,
+          /* callee */ std::string(k_return_callee),
+          /* sink_index */ 0,
+          position_1)});
+  index.add(
+      two,
+      IssueSet{
+          Issue(
+              /* source */ Taint{
+                  test::make_leaf_taint_config(other_source_kind)},
+              /* sink */ Taint{test::make_leaf_taint_config(sink_kind)},
+              &rule,
+              /* callee */ std::string(k_return_callee),
+              /* sink_index */ 0,
+              position_1),
+          Issue(
+              /* source */ Taint{test::make_leaf_taint_config(source_kind)},
+              /* sink */ Taint{test::make_leaf_taint_config(sink_kind)},
+              &rule,
+              /* callee */ std::string(k_return_callee),
+              /* sink_index */ 0,
+              position_2)});
+  EXPECT_EQ(index.size(), 2);
+
+  auto issues = index.to_json(ExportOriginsMode::Always);
+  ASSERT_EQ(issues.size(), 2);
+  std::size_t merged_issues = 0;
+  for (const auto& issue : issues) {
+    if (issue["methods"].size() == 2) {
+      merged_issues++;
+      EXPECT_EQ(issue["methods"][0].asString(), one->show());
+      EXPECT_EQ(issue["methods"][1].asString(), two->show());
+    } else {
+      EXPECT_EQ(issue["methods"].size(), 1);
+      EXPECT_EQ(issue["methods"][0].asString(), two->show());
+    }
+  }
+  EXPECT_EQ(merged_issues, 1);
+}
+
+} // namespace marianatrench
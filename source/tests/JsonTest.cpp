@@ -5,6 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
 #include <gmock/gmock.h>
 
 #include <mariana-trench/Access.h>
@@ -14,7 +19,9 @@
 #include <mariana-trench/FieldModel.h>
 #include <mariana-trench/Fields.h>
 #include <mariana-trench/Frame.h>
+#include <mariana-trench/JsonReader.h>
 #include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
 #include <mariana-trench/LifecycleMethod.h>
 #include <mariana-trench/LifecycleMethods.h>
 #include <mariana-trench/LocalPositionSet.h>
@@ -2786,6 +2793,41 @@ TEST_F(JsonTest, Model) {
     })#"));
 }
 
+TEST_F(JsonTest, TrustedModel) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      /* class_name */ "LData;",
+      /* method_name */ "method",
+      /* parameter_types */ "LData;",
+      /* return_type*/ "V");
+
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+
+  auto value = test::parse_json(R"({
+    "sinks": [{"port": "Argument(1)", "kind": "TestSink", "unexpected": 1}],
+    "propagation": [
+      {"input": "Argument(1)", "output": "Return", "unexpected": 1}
+    ],
+    "attach_to_sinks": [
+      {"port": "Argument(1)", "features": ["feature"], "unexpected": 1}
+    ]
+  })");
+  EXPECT_THROW(Model::from_json(method, value, context), JsonValidationError);
+
+  // Members of trusted inputs are not checked.
+  auto expected_value = value;
+  for (const auto* member : {"sinks", "propagation", "attach_to_sinks"}) {
+    expected_value[member][0].removeMember("unexpected");
+  }
+  EXPECT_EQ(
+      Model::from_trusted_json(method, value, context),
+      Model::from_json(method, expected_value, context));
+}
+
 TEST_F(JsonTest, FieldModel) {
   Scope scope;
   const auto* dex_field = redex::create_field(
@@ -3145,4 +3187,250 @@ TEST_F(JsonTest, CallEffectModel) {
     })#"));
 }
 
+TEST_F(JsonTest, VisitJsonArrayFile) {
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-visit-json-array-file-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  auto visit = [&](const std::string& content) {
+    auto path = directory / "elements.json";
+    std::ofstream(path) << content;
+    std::mutex mutex;
+    std::vector<std::string> elements;
+    JsonValidation::visit_json_array_file(path, [&](const Json::Value& value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      elements.push_back(JsonValidation::to_styled_string(value));
+    });
+    std::sort(elements.begin(), elements.end());
+    return elements;
+  };
+  auto styled = [](const std::string& json) {
+    return JsonValidation::to_styled_string(test::parse_json(json));
+  };
+
+  EXPECT_TRUE(visit("[]").empty());
+  EXPECT_TRUE(visit("null").empty());
+  EXPECT_THAT(
+      visit(R"( [{"a": [1, 2]}, "x,]\"", 3] )"),
+      testing::UnorderedElementsAre(
+          styled(R"({"a": [1, 2]})"), styled(R"("x,]\"")"), styled("3")));
+  // Documents with comments are parsed as a whole.
+  EXPECT_THAT(
+      visit("[\n// comment\n{\"a\": 1}]"),
+      testing::UnorderedElementsAre(styled(R"({"a": 1})")));
+  EXPECT_THROW(visit(R"([{"a": 1}, {"a": ]])"), std::invalid_argument);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(JsonTest, ModelWriteJson) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      /* class_name */ "LData;",
+      /* method_name */ "method",
+      /* parameter_types */ "LData;LData;",
+      /* return_type*/ "V");
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      /* class_name */ "LCallee;",
+      /* method_name */ "callee",
+      /* parameter_types */ "Ljava/lang/String;",
+      /* return_type*/ "V");
+
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+  context.methods->get(dex_callee);
+
+  auto model = Model::from_json(
+      method,
+      test::parse_json(R"#({
+        "modes": ["skip-analysis", "taint-in-taint-out"],
+        "freeze": ["sinks"],
+        "generations": [
+          {
+            "kind": "Source",
+            "port": "Return",
+            "may_features": ["may-\"quoted\""],
+            "always_features": ["always-é"]
+          }
+        ],
+        "parameter_sources": [
+          {
+            "kind": "ParameterSource",
+            "port": "Argument(1).field",
+            "via_type_of": ["Argument(1)"],
+            "via_value_of": ["Argument(2)"]
+          }
+        ],
+        "sinks": [
+          {
+            "kind": "Sink",
+            "port": "Argument(2)",
+            "callee": "LCallee;.callee:(Ljava/lang/String;)V",
+            "callee_port": "Argument(0)",
+            "call_position": {"path": "Callee.java", "line": 2, "start": 3, "end": 4},
+            "distance": 2,
+            "features": ["via-sink"]
+          },
+          {
+            "kind": "OtherSink",
+            "port": "Argument(2)"
+          }
+        ],
+        "propagation": [
+          {"input": "Argument(1)", "output": "Return"},
+          {"input": "Argument(2).x", "output": "Argument(0).y"}
+        ],
+        "sanitizers": [
+          {"sanitize": "sources", "kinds": [{"kind": "Source"}]},
+          {"sanitize": "propagations", "port": "Argument(1)"}
+        ],
+        "attach_to_sinks": [
+          {"port": "Argument(1)", "features": ["via-method", "b-feature"]}
+        ],
+        "add_features_to_arguments": [
+          {"port": "Argument(2)", "features": ["via-argument"]}
+        ]
+      })#"),
+      context);
+
+  auto compact = [](const Json::Value& value) {
+    std::ostringstream output;
+    JsonValidation::compact_writer()->write(value, &output);
+    return output.str();
+  };
+
+  JsonWriter writer;
+  for (auto export_origins_mode :
+       {ExportOriginsMode::Always, ExportOriginsMode::OnlyOnOrigins}) {
+    writer.clear();
+    model.write_json(writer, export_origins_mode);
+    EXPECT_EQ(writer.str(), compact(model.to_json(export_origins_mode)));
+  }
+
+  writer.clear();
+  model.write_json(writer, context);
+  EXPECT_EQ(writer.str(), compact(model.to_json(context)));
+}
+
+TEST_F(JsonTest, JsonWriter) {
+  auto compact = [](const Json::Value& value) {
+    std::ostringstream output;
+    JsonValidation::compact_writer()->write(value, &output);
+    return output.str();
+  };
+
+  JsonWriter writer;
+  writer.begin_array();
+  writer.begin_object();
+  writer.key("b").value(std::int64_t{-1});
+  writer.key("a").begin_array();
+  writer.value("x\n\"é");
+  writer.value(nullptr);
+  writer.value(true);
+  writer.end_array();
+  writer.key("c").value(std::uint64_t{18446744073709551615u});
+  writer.key("b").value(2);
+  writer.end_object();
+  writer.value(test::parse_json(R"({"z": [1.5, {}], "y": "y"})"));
+  writer.begin_object();
+  writer.members(test::parse_json(R"({"z": 1, "x": 2})"));
+  writer.key("y").value(std::string_view("a\0b", 3));
+  writer.end_object();
+  writer.end_array();
+
+  auto expected = test::parse_json(R"([
+    {"a": ["x\n\"é", null, true], "b": 2, "c": 18446744073709551615},
+    {"y": "y", "z": [1.5, {}]},
+    {"x": 2, "z": 1}
+  ])");
+  expected[2]["y"] = std::string("a\0b", 3);
+  EXPECT_EQ(writer.str(), compact(expected));
+}
+
+TEST_F(JsonTest, JsonWriterStringTable) {
+  JsonStringTable string_table;
+  JsonWriter writer;
+  writer.set_string_table(&string_table);
+  writer.begin_object();
+  writer.key("method").value("LClass;.method:()V");
+  writer.key("sinks").value(test::parse_json(R"([
+    {"kind": "Sink", "path": "Class.java", "features": ["kind"]},
+    {"kind": "Other", "method": {"name": "LClass;.method:()V"}}
+  ])"));
+  writer.key("field").begin_object();
+  writer.key("name").value("field");
+  writer.end_object();
+  writer.end_object();
+
+  EXPECT_EQ(
+      writer.str(),
+      R"({"field":{"name":"field"},"method":0,"sinks":[)"
+      R"({"features":["kind"],"kind":1,"path":2},)"
+      R"({"kind":3,"method":{"name":"LClass;.method:()V"}}]})");
+  EXPECT_EQ(string_table.strings().size(), 4);
+  EXPECT_EQ(*string_table.strings()[0], "LClass;.method:()V");
+  EXPECT_EQ(*string_table.strings()[1], "Sink");
+  EXPECT_EQ(*string_table.strings()[2], "Class.java");
+  EXPECT_EQ(*string_table.strings()[3], "Other");
+}
+
+TEST_F(JsonTest, JsonReader) {
+  auto jsoncpp = [](const std::string& input) {
+    Json::CharReaderBuilder builder;
+    auto reader = std::unique_ptr<Json::CharReader>(builder.newCharReader());
+    Json::Value value;
+    std::string errors;
+    EXPECT_TRUE(reader->parse(
+        input.data(), input.data() + input.size(), &value, &errors));
+    return value;
+  };
+  auto expect_same = [&](const std::string& input) {
+    auto value = JsonReader::parse(input);
+    ASSERT_TRUE(value.has_value()) << input;
+    auto expected = jsoncpp(input);
+    EXPECT_EQ(value->type(), expected.type()) << input;
+    EXPECT_EQ(*value, expected) << input;
+    EXPECT_EQ(
+        JsonValidation::to_styled_string(*value),
+        JsonValidation::to_styled_string(expected));
+  };
+
+  expect_same("null");
+  expect_same(" true ");
+  expect_same("[false, 0, -0, 1.5e3, -2.5E-3]");
+  expect_same("[9223372036854775807, 9223372036854775808]");
+  expect_same("[-9223372036854775808, -9223372036854775809]");
+  expect_same("[18446744073709551615, 18446744073709551616]");
+  expect_same(R"("a\"\\\/\b\f\n\r\té€😀")");
+  expect_same(R"(["\u0000", {"k\u0000": 1}])");
+  expect_same(R"({"b": [1, {"c": {}}], "a": [], "b": "last"})");
+  expect_same(R"([
+    {
+      "method": "LClass;.method:(LData;)V",
+      "generations": [{"port": "Return", "taint": [{"kinds": [{"kind": "Source"}]}]}]
+    }
+  ])");
+
+  // Anything else is left to jsoncpp.
+  EXPECT_FALSE(JsonReader::parse(""));
+  EXPECT_FALSE(JsonReader::parse("// comment\n{}"));
+  EXPECT_FALSE(JsonReader::parse("{} {}"));
+  EXPECT_FALSE(JsonReader::parse("[1,]"));
+  EXPECT_FALSE(JsonReader::parse("01"));
+  EXPECT_FALSE(JsonReader::parse("1e999"));
+  EXPECT_FALSE(JsonReader::parse(R"("\ud800")"));
+  EXPECT_FALSE(JsonReader::parse("\"a\nb\""));
+  EXPECT_FALSE(JsonReader::parse(std::string(2000, '[')));
+
+  // Parsing functions fall back to jsoncpp.
+  EXPECT_EQ(
+      JsonValidation::parse_json("// comment\n[1]"), test::parse_json("[1]"));
+  EXPECT_THROW(JsonValidation::parse_json("[1,"), std::invalid_argument);
+}
+
 } // namespace marianatrench
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/KindCounters.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class KindCountersTest : public test::Test {};
+
+TEST_F(KindCountersTest, AddRemove) {
+  auto context = test::make_empty_context();
+  const auto* source = context.kind_factory->get("TestSource");
+  const auto* other_source = context.kind_factory->get("OtherSource");
+  const auto* sink = context.kind_factory->get("TestSink");
+
+  KindCounters counters;
+  auto first = KindCounters::ModelKinds{
+      /* source_kinds */ {source},
+      /* sink_kinds */ {sink},
+      /* local_transform_kinds */ {}};
+  auto second = KindCounters::ModelKinds{
+      /* source_kinds */ {source, other_source},
+      /* sink_kinds */ {},
+      /* local_transform_kinds */ {}};
+  counters.add(first);
+  counters.add(second);
+  EXPECT_THAT(
+      counters.used_sources(),
+      testing::UnorderedElementsAre(source, other_source));
+  EXPECT_THAT(counters.used_sinks(), testing::UnorderedElementsAre(sink));
+
+  // Kinds are used as long as one model has them.
+  counters.remove(second);
+  EXPECT_THAT(counters.used_sources(), testing::UnorderedElementsAre(source));
+  counters.remove(first);
+  EXPECT_TRUE(counters.used_sources().empty());
+  EXPECT_TRUE(counters.used_sinks().empty());
+  EXPECT_TRUE(counters.used_transforms().empty());
+}
+
+} // namespace marianatrench
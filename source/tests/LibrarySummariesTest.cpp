@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/LibrarySummaries.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+namespace {
+
+class LibrarySummariesTest : public test::Test {};
+
+} // anonymous namespace
+
+TEST_F(LibrarySummariesTest, Summary) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  auto* method = context.methods->create(redex::create_void_method(
+      scope,
+      "LLibrary;",
+      "method",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "Ljava/lang/Object;"));
+
+  auto model = Model::from_json(
+      method,
+      test::parse_json(R"({
+        "generations": [
+          {"kind": "TestSource", "port": "Return", "always_features": ["f"]}
+        ],
+        "sinks": [
+          {"kind": "TestSink", "port": "Argument(1)"},
+          {"kind": "TestPartialSink", "partial_label": "a", "port": "Argument(1)"}
+        ],
+        "propagation": [
+          {"input": "Argument(1).x", "output": "Return"}
+        ]
+      })"),
+      context);
+
+  auto summary = LibrarySummaries::summary(model);
+  ASSERT_TRUE(summary.has_value());
+
+  auto summarized_model = Model::from_json(method, *summary, context);
+  EXPECT_TRUE(summarized_model.skip_analysis());
+
+  model.add_mode(Model::Mode::SkipAnalysis, context);
+  EXPECT_EQ(summarized_model, model);
+}
+
+TEST_F(LibrarySummariesTest, InvalidateDependents) {
+  Scope scope;
+  auto* dex_bottom = redex::create_void_method(
+      scope,
+      "LLibrary;",
+      "bottom",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;");
+  auto* dex_top = redex::create_method(scope, "LLibrary;", R"(
+    (method (public) "LLibrary;.top:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LLibrary;.bottom:()Ljava/lang/Object;")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_other = redex::create_void_method(scope, "LApplication;", "other");
+
+  auto context = test::make_call_graph_context(scope);
+  auto* bottom = context.methods->get(dex_bottom);
+  auto* top = context.methods->get(dex_top);
+  auto* other = context.methods->get(dex_other);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto path = std::filesystem::temp_directory_path() /
+      "mariana-trench-library-summaries.json";
+
+  {
+    auto registry = Registry(context);
+    registry.set(Model(
+        /* method */ bottom,
+        context,
+        /* modes */ {},
+        /* frozen */ {},
+        /* generations */
+        {{AccessPath(Root(Root::Kind::Return)),
+          test::make_leaf_taint_config(source_kind)}}));
+    LibrarySummaries::store(
+        path, /* class_prefixes */ {"LLibrary;"}, context, registry);
+  }
+
+  {
+    auto registry = Registry(context);
+    EXPECT_EQ(LibrarySummaries::load(path, context, registry), 2);
+    EXPECT_TRUE(registry.get(bottom).skip_analysis());
+    EXPECT_FALSE(registry.get(bottom).generations().is_bottom());
+    EXPECT_TRUE(registry.get(top).skip_analysis());
+    EXPECT_FALSE(registry.get(other).skip_analysis());
+  }
+
+  {
+    // The summary of `top` depends on the summary of `bottom`.
+    auto value = JsonValidation::parse_json_file(path);
+    for (auto& summary : value["summaries"]) {
+      if (summary["method"].asString() == bottom->show()) {
+        summary["fingerprint"] = "changed";
+      }
+    }
+    JsonValidation::write_json_file(path, value);
+
+    auto registry = Registry(context);
+    EXPECT_EQ(LibrarySummaries::load(path, context, registry), 0);
+    EXPECT_FALSE(registry.get(bottom).skip_analysis());
+    EXPECT_FALSE(registry.get(top).skip_analysis());
+  }
+
+  std::filesystem::remove(path);
+}
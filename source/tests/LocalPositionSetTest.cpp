@@ -121,6 +121,31 @@ TEST_F(LocalPositionSetTest, Join) {
   EXPECT_TRUE(set.is_top());
 }
 
+TEST_F(LocalPositionSetTest, Meet) {
+  auto context = test::make_empty_context();
+  const auto* one = context.positions->get(std::nullopt, 1);
+  const auto* two = context.positions->get(std::nullopt, 2);
+  const auto* three = context.positions->get(std::nullopt, 3);
+
+  EXPECT_EQ(
+      (LocalPositionSet{one}).meet(LocalPositionSet::bottom()),
+      LocalPositionSet::bottom());
+  EXPECT_EQ(
+      (LocalPositionSet{one}).meet(LocalPositionSet::top()),
+      LocalPositionSet{one});
+  EXPECT_EQ(
+      LocalPositionSet::top().meet(LocalPositionSet{one}),
+      LocalPositionSet{one});
+  EXPECT_EQ(
+      (LocalPositionSet{one}).meet(LocalPositionSet{}), LocalPositionSet{});
+  EXPECT_EQ(
+      (LocalPositionSet{one, two}).meet(LocalPositionSet{two, three}),
+      LocalPositionSet{two});
+  EXPECT_EQ(
+      (LocalPositionSet{one, two, three}).meet(LocalPositionSet{one, three}),
+      (LocalPositionSet{one, three}));
+}
+
 TEST_F(LocalPositionSetTest, Add) {
   auto context = test::make_empty_context();
   const auto* one = context.positions->get(std::nullopt, 1);
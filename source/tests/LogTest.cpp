@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/Log.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+namespace {
+
+struct DumpContext {
+  bool dump_;
+
+  bool dump() const {
+    return dump_;
+  }
+};
+
+} // namespace
+
+class LogTest : public test::Test {};
+
+TEST_F(LogTest, ArgumentsOfDisabledLevelsAreNotEvaluated) {
+  auto previous_level = Logger::get_level();
+  Logger::set_level(1);
+
+  int evaluations = 0;
+  const auto argument = [&evaluations]() {
+    evaluations++;
+    return "argument";
+  };
+
+  LOG(2, "{}", argument());
+  WARNING(3, "{}", argument());
+  auto not_dumped = DumpContext{/* dump */ false};
+  LOG_OR_DUMP(&not_dumped, 4, "{}", argument());
+  EXPECT_EQ(evaluations, 0);
+
+#if MT_MAX_LOG_LEVEL >= 4
+  // Dumped methods are logged at level 1, unless compiled out.
+  auto dumped = DumpContext{/* dump */ true};
+  LOG_OR_DUMP(&dumped, 4, "{}", argument());
+  EXPECT_EQ(evaluations, 1);
+#endif
+
+  Logger::set_level(previous_level);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/MemoryAccounting.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Registry.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class MemoryAccountingTest : public test::Test {};
+
+TEST_F(MemoryAccountingTest, Record) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      "LClass;",
+      "method",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "Ljava/lang/Object;");
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+
+  auto registry = Registry(
+      context,
+      /* models */
+      {Model(
+          method,
+          context,
+          /* modes */ {},
+          /* frozen */ {},
+          /* generations */
+          {{AccessPath(Root(Root::Kind::Return)),
+            test::make_leaf_taint_config(
+                context.kind_factory->get("Source"))}},
+          /* parameter_sources */ {},
+          /* sinks */
+          {{AccessPath(Root(Root::Kind::Argument, 1)),
+            test::make_leaf_taint_config(
+                context.kind_factory->get("Sink"))}})},
+      /* field_models */ {});
+
+  MemoryAccounting memory_accounting(/* sampling_rate */ 1);
+  memory_accounting.record("before_registry", context, /* registry */ nullptr);
+  memory_accounting.record("fixpoint", context, &registry);
+
+  auto value = memory_accounting.to_json();
+  ASSERT_EQ(value.size(), 2);
+  EXPECT_EQ(value[0]["label"].asString(), "before_registry");
+  EXPECT_FALSE(value[0]["bytes"].isMember("models.sinks"));
+  EXPECT_TRUE(value[0]["bytes"].isMember("factories.kinds"));
+
+  EXPECT_EQ(value[1]["label"].asString(), "fixpoint");
+  const auto& bytes = value[1]["bytes"];
+  EXPECT_GT(bytes["models.generations"].asUInt64(), 0);
+  EXPECT_GT(bytes["models.sinks"].asUInt64(), 0);
+  EXPECT_EQ(bytes["models.propagations"].asUInt64(), 0);
+  EXPECT_EQ(bytes["models.issues"].asUInt64(), 0);
+  EXPECT_GE(
+      value[1]["total"].asUInt64(),
+      bytes["models.generations"].asUInt64() +
+          bytes["models.sinks"].asUInt64());
+}
+
+} // namespace marianatrench
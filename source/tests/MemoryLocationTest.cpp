@@ -5,6 +5,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
 #include <gtest/gtest.h>
 
 #include <mariana-trench/MemoryLocation.h>
@@ -82,4 +86,56 @@ TEST_F(TraceTest, MemoryLocationPath) {
   EXPECT_EQ(parameter_x_y_x->path(), Path{x});
 }
 
+TEST_F(TraceTest, MemoryLocationManyFields) {
+  auto parameter = std::make_unique<ParameterMemoryLocation>(1);
+
+  // Field locations keep their address as more fields are created.
+  std::vector<FieldMemoryLocation*> fields;
+  for (int index = 0; index < 100; index++) {
+    auto* field =
+        DexString::make_string(fmt::format("field{}", index % 50));
+    auto* location = parameter->make_field(field);
+    EXPECT_EQ(location->field(), field);
+    EXPECT_EQ(location->parent(), parameter.get());
+    EXPECT_EQ(location->make_field(field), location);
+    fields.push_back(location);
+  }
+  for (int index = 0; index < 50; index++) {
+    EXPECT_EQ(fields[index], fields[index + 50]);
+    EXPECT_EQ(
+        fields[index]->path(),
+        Path{PathElement::field(fmt::format("field{}", index))});
+  }
+}
+
+TEST_F(TraceTest, MemoryLocationConcurrentFields) {
+  auto parameter = std::make_unique<ParameterMemoryLocation>(1);
+  std::vector<const DexString*> names;
+  for (int index = 0; index < 100; index++) {
+    names.push_back(DexString::make_string(fmt::format("field{}", index)));
+  }
+  // The field storage of the root exists once it has a field.
+  auto* first = parameter->make_field(names.front());
+
+  // Concurrent fields of the same root are created once.
+  std::vector<FieldMemoryLocation*> left(names.size());
+  std::vector<FieldMemoryLocation*> right(names.size());
+  auto make_fields = [&](std::vector<FieldMemoryLocation*>& fields) {
+    for (std::size_t index = 0; index < names.size(); index++) {
+      fields[index] = first->make_field(names[index]);
+    }
+  };
+  std::thread left_thread([&]() { make_fields(left); });
+  std::thread right_thread([&]() { make_fields(right); });
+  left_thread.join();
+  right_thread.join();
+
+  EXPECT_EQ(left, right);
+  EXPECT_EQ(left.front(), first);
+  for (std::size_t index = 1; index < names.size(); index++) {
+    EXPECT_EQ(left[index]->parent(), first);
+    EXPECT_EQ(left[index]->root(), parameter.get());
+  }
+}
+
 } // namespace marianatrench
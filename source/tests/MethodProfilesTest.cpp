@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/MethodProfiles.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class MethodProfilesTest : public test::Test {};
+
+TEST_F(MethodProfilesTest, JoinWith) {
+  auto profile = MethodAnalysisProfile{
+      .analyses = 1,
+      .time = 1.0,
+      .forward_taint_block_visits = 3,
+      .callee_model_lookups = 2,
+      .instructions = 10,
+      .call_sites = 2,
+      .model_size = 4,
+  };
+  profile.join_with(MethodAnalysisProfile{
+      .analyses = 1,
+      .time = 0.5,
+      .forward_taint_block_visits = 4,
+      .callee_model_lookups = 1,
+      .instructions = 10,
+      .call_sites = 2,
+      .model_size = 6,
+  });
+
+  EXPECT_EQ(profile.analyses, 2);
+  EXPECT_DOUBLE_EQ(profile.time, 1.5);
+  EXPECT_EQ(profile.forward_taint_block_visits, 7);
+  EXPECT_EQ(profile.callee_model_lookups, 3);
+  // Code measures are the same for all analyses.
+  EXPECT_EQ(profile.instructions, 10);
+  EXPECT_EQ(profile.call_sites, 2);
+  // The model size is the one of the last analysis.
+  EXPECT_EQ(profile.model_size, 6);
+}
+
+TEST_F(MethodProfilesTest, Dump) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  auto* fast = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "fast"));
+  auto* slow = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "slow"));
+
+  MethodProfiles profiles;
+  profiles.add(fast, MethodAnalysisProfile{.analyses = 1, .time = 1.0});
+  profiles.add(slow, MethodAnalysisProfile{.analyses = 1, .time = 2.0});
+  profiles.add(fast, MethodAnalysisProfile{.analyses = 1, .time = 0.5});
+
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-method-profiles-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  profiles.dump(directory, /* batch_size */ 10);
+
+  std::ifstream file(directory / "method_profile@00000-of-00001.json");
+  std::vector<Json::Value> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.rfind("//", 0) == 0) {
+      continue;
+    }
+    lines.push_back(JsonValidation::parse_json(line));
+  }
+
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_EQ(lines[0]["method"].asString(), "LClass;.slow:()V");
+  EXPECT_EQ(lines[0]["analyses"].asUInt64(), 1);
+  EXPECT_EQ(lines[1]["method"].asString(), "LClass;.fast:()V");
+  EXPECT_EQ(lines[1]["analyses"].asUInt64(), 2);
+  EXPECT_DOUBLE_EQ(lines[1]["time"].asDouble(), 1.5);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(MethodProfilesTest, Read) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  auto* method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "method"));
+
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-method-profiles-read-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  {
+    std::ofstream file(directory / "method_profile@00000-of-00001.json");
+    file << "// @" << "generated\n";
+    file << R"({"method": "LClass;.method:()V", "analyses": 2, "time": 3.0, "instructions": 4})"
+         << "\n";
+    // Methods that no longer exist are ignored.
+    file << R"({"method": "LRemoved;.method:()V", "analyses": 1, "time": 1.0, "instructions": 1})"
+         << "\n";
+  }
+
+  auto profiles = MethodProfiles::read(directory, *context.methods);
+  ASSERT_EQ(profiles.size(), 1);
+  const auto& profile = profiles.at(method);
+  EXPECT_EQ(profile.analyses, 2);
+  EXPECT_DOUBLE_EQ(profile.time, 3.0);
+  EXPECT_EQ(profile.instructions, 4);
+
+  std::filesystem::remove_all(directory);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/MethodSampler.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class MethodSamplerTest : public test::Test {};
+
+TEST_F(MethodSamplerTest, TagThread) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  auto* method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "method"));
+
+  auto path =
+      std::filesystem::temp_directory_path() / "mariana-trench-samples.folded";
+  std::filesystem::remove(path);
+
+  {
+    MethodSampler sampler(/* frequency */ 99);
+    EXPECT_EQ(mariana_trench_analyzed_method, nullptr);
+    {
+      MethodSampler::MethodScope scope(&sampler, method);
+      EXPECT_EQ(
+          std::string(mariana_trench_analyzed_method), "LClass;.method:()V");
+    }
+    EXPECT_EQ(mariana_trench_analyzed_method, nullptr);
+
+    // Threads are not tagged without a sampler.
+    {
+      MethodSampler::MethodScope scope(/* sampler */ nullptr, method);
+      EXPECT_EQ(mariana_trench_analyzed_method, nullptr);
+    }
+
+    sampler.dump(path);
+    EXPECT_TRUE(std::filesystem::exists(path));
+  }
+
+  std::filesystem::remove(path);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Heuristics.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/ModelChanges.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ModelChangesTest : public test::Test {};
+
+namespace {
+
+AccessPath field_port(std::size_t index) {
+  return AccessPath(
+      Root(Root::Kind::Return),
+      Path{PathElement::field(fmt::format("field{}", index))});
+}
+
+/*
+ * Simulate the fixpoint on a model that gains a source on a new field at every
+ * analysis, as done in `Interprocedural.cpp`. Returns the number of changes.
+ */
+std::size_t iterate_growing_model(
+    Context& context,
+    const Method* method,
+    ModelChanges& model_changes,
+    Model& model) {
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  auto widening_features = FeatureMayAlwaysSet{
+      context.feature_factory->get_widen_broadening_feature()};
+
+  std::size_t changes = 0;
+  for (std::size_t iteration = 0;
+       iteration < Heuristics::kMaxNumberIterations;
+       iteration++) {
+    auto new_model = model;
+    new_model.add_generation(
+        field_port(iteration), test::make_leaf_taint_config(source_kind));
+    if (model_changes.widens(method)) {
+      new_model.reduce_precision(widening_features);
+    }
+    if (new_model.leq(model)) {
+      break;
+    }
+    new_model.join_with(model);
+    model_changes.record(method);
+    model = std::move(new_model);
+    changes++;
+  }
+  return changes;
+}
+
+} // namespace
+
+TEST_F(ModelChangesTest, NoWidening) {
+  Scope scope;
+  auto context = test::make_empty_context();
+  const auto* method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "method"));
+
+  ModelChanges model_changes(/* widen_changing_models */ false);
+  for (std::size_t change = 0;
+       change < Heuristics::kMaxModelChangesBeforeWidening;
+       change++) {
+    model_changes.record(method);
+  }
+  EXPECT_FALSE(model_changes.widens(method));
+
+  // Without widening, the model keeps changing until the iteration limit.
+  Model model;
+  EXPECT_EQ(
+      iterate_growing_model(context, method, model_changes, model),
+      Heuristics::kMaxNumberIterations);
+}
+
+TEST_F(ModelChangesTest, Widening) {
+  Scope scope;
+  auto context = test::make_empty_context();
+  const auto* method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "method"));
+  const auto* other_method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "other_method"));
+
+  ModelChanges model_changes(/* widen_changing_models */ true);
+  for (std::size_t change = 0;
+       change < Heuristics::kMaxModelChangesBeforeWidening - 1;
+       change++) {
+    model_changes.record(method);
+  }
+  EXPECT_FALSE(model_changes.widens(method));
+  model_changes.record(method);
+  EXPECT_TRUE(model_changes.widens(method));
+  EXPECT_FALSE(model_changes.widens(other_method));
+
+  // The model stabilizes right after it is widened.
+  Model model;
+  EXPECT_EQ(
+      iterate_growing_model(context, other_method, model_changes, model),
+      Heuristics::kMaxModelChangesBeforeWidening + 1);
+
+  // Sources are collapsed on the return value, and the widened model still
+  // holds the sources of all the fields.
+  EXPECT_FALSE(
+      model.generations().read(Root(Root::Kind::Return)).root().is_bottom());
+  for (std::size_t index = 0;
+       index <= Heuristics::kMaxModelChangesBeforeWidening;
+       index++) {
+    EXPECT_FALSE(model.generations().read(field_port(index)).is_bottom());
+  }
+}
+
+} // namespace marianatrench
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/ModelFingerprints.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ModelFingerprintsTest : public test::Test {};
+
+TEST_F(ModelFingerprintsTest, ReadWrite) {
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-model-fingerprints-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  auto path = directory / "model_fingerprints.txt";
+
+  ModelFingerprints fingerprints;
+  fingerprints.set("method LClass;.one:()V", 1);
+  fingerprints.set("field LClass;.field:I", 18446744073709551615ull);
+  fingerprints.set("literal some pattern", 3);
+  fingerprints.write(path);
+
+  auto read = ModelFingerprints::read(path);
+  EXPECT_EQ(read.size(), 3);
+  EXPECT_EQ(read.get("method LClass;.one:()V"), 1);
+  EXPECT_EQ(read.get("field LClass;.field:I"), 18446744073709551615ull);
+  EXPECT_EQ(read.get("literal some pattern"), 3);
+  EXPECT_EQ(read.get("method LClass;.two:()V"), std::nullopt);
+
+  ModelFingerprints current;
+  current.set("method LClass;.one:()V", 2);
+  current.set("method LClass;.two:()V", 4);
+  EXPECT_THAT(
+      current.removed_keys(read),
+      testing::ElementsAre("field LClass;.field:I", "literal some pattern"));
+
+  std::ofstream(path) << "not-a-hash method LClass;.one:()V\n";
+  EXPECT_THROW(ModelFingerprints::read(path), std::invalid_argument);
+  EXPECT_THROW(
+      ModelFingerprints::read(directory / "missing.txt"),
+      std::invalid_argument);
+}
+
+TEST_F(ModelFingerprintsTest, Hash) {
+  EXPECT_EQ(
+      ModelFingerprints::hash(test::parse_json(
+          R"({"method": "LClass;.one:()V", "sinks": [{"kind": "A"}, {"kind": "B"}]})")),
+      ModelFingerprints::hash(test::parse_json(
+          R"({"sinks": [{"kind": "B"}, {"kind": "A"}], "method": "LClass;.one:()V"})")));
+  EXPECT_NE(
+      ModelFingerprints::hash(test::parse_json(R"({"sinks": [{"kind": "A"}]})")),
+      ModelFingerprints::hash(test::parse_json(R"({"sinks": [{"kind": "B"}]})")));
+  EXPECT_NE(
+      ModelFingerprints::hash(test::parse_json(R"({"a": 1})")),
+      ModelFingerprints::hash(test::parse_json(R"({"a": "1"})")));
+  EXPECT_NE(
+      ModelFingerprints::hash(test::parse_json(R"([[1, 2], [3]])")),
+      ModelFingerprints::hash(test::parse_json(R"([[1], [2, 3]])")));
+}
+
+} // namespace marianatrench
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/FieldMappings.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/MethodMappings.h>
+#include <mariana-trench/ModelGeneratorCache.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/model-generator/JsonModelGenerator.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+namespace {
+
+class ModelGeneratorCacheTest : public test::Test {};
+
+std::vector<Model> run_generator(
+    Context& context,
+    const MethodMappings& method_mappings,
+    const ModelGeneratorCache& cache,
+    const Json::Value& configuration) {
+  auto generator = JsonModelGenerator::from_json(
+      "generator", context, "generator.json", configuration);
+  generator.load_cache(cache);
+  FieldMappings field_mappings(*context.fields);
+  auto result = generator.run_optimized(
+      *context.methods, method_mappings, *context.fields, field_mappings);
+  generator.store_cache(cache);
+  return result.method_models;
+}
+
+} // namespace
+
+TEST_F(ModelGeneratorCacheTest, ReuseMatches) {
+  Scope scope;
+  auto* dex_on_create =
+      redex::create_void_method(scope, "LClass;", "onCreate");
+  auto* dex_other = redex::create_void_method(scope, "LClass;", "other");
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* on_create = context.methods->get(dex_on_create);
+  auto* other = context.methods->get(dex_other);
+  MethodMappings method_mappings{*context.methods};
+
+  auto cache_directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-model-generator-cache-test";
+  std::filesystem::remove_all(cache_directory);
+  std::filesystem::create_directories(cache_directory);
+  ModelGeneratorCache cache(cache_directory, context.stores);
+
+  auto configuration = test::parse_json(R"({
+    "model_generators": [
+      {
+        "find": "methods",
+        "where": [{"constraint": "name", "pattern": "onCreate"}],
+        "model": {"sinks": [{"kind": "Sink", "port": "Argument(0)"}]}
+      }
+    ]
+  })");
+
+  auto models = run_generator(context, method_mappings, cache, configuration);
+  ASSERT_EQ(models.size(), 1);
+  EXPECT_EQ(models[0].method(), on_create);
+
+  // Cached matches are used instead of evaluating the constraints.
+  auto cache_path = cache_directory / "model_generators" / "generator.json";
+  ASSERT_TRUE(std::filesystem::exists(cache_path));
+  auto cache_value = JsonValidation::parse_json_file(cache_path);
+  cache_value["methods"][0][0] = other->to_json();
+  JsonValidation::write_json_file(cache_path, cache_value);
+
+  models = run_generator(context, method_mappings, cache, configuration);
+  ASSERT_EQ(models.size(), 1);
+  EXPECT_EQ(models[0].method(), other);
+
+  // A different configuration invalidates the cached matches.
+  configuration["model_generators"][0]["verbosity"] = 1;
+  models = run_generator(context, method_mappings, cache, configuration);
+  ASSERT_EQ(models.size(), 1);
+  EXPECT_EQ(models[0].method(), on_create);
+
+  std::filesystem::remove_all(cache_directory);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fmt/format.h>
+#include <gmock/gmock.h>
+
+#include <mariana-trench/ModelSizes.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Registry.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ModelSizesTest : public test::Test {};
+
+namespace {
+
+Model make_model(
+    const Method* method,
+    Context& context,
+    std::size_t number_of_sinks) {
+  std::vector<std::pair<AccessPath, TaintConfig>> sinks;
+  for (std::size_t index = 0; index < number_of_sinks; index++) {
+    sinks.emplace_back(
+        AccessPath(Root(Root::Kind::Argument, 0)),
+        test::make_leaf_taint_config(
+            context.kind_factory->get(fmt::format("Sink{}", index))));
+  }
+  return Model(
+      method,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(context.kind_factory->get("Source"))},
+       {AccessPath(Root(Root::Kind::Return), Path{PathElement::field("x")}),
+        test::make_leaf_taint_config(context.kind_factory->get("Other"))}},
+      /* parameter_sources */ {},
+      sinks);
+}
+
+} // namespace
+
+TEST_F(ModelSizesTest, FromModel) {
+  Scope scope;
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+
+  auto size = ModelSize::from_model(
+      make_model(/* method */ nullptr, context, /* number_of_sinks */ 2));
+  EXPECT_EQ(size.frames, 4);
+  EXPECT_EQ(size.frames_per_port.at("Return"), 2);
+  EXPECT_EQ(size.frames_per_port.at("Argument(0)"), 2);
+  EXPECT_EQ(size.leaves, 3);
+  EXPECT_EQ(size.maximum_depth, 1);
+  EXPECT_EQ(size.issues, 0);
+  EXPECT_EQ(
+      ModelSize::number_of_frames(
+          make_model(/* method */ nullptr, context, /* number_of_sinks */ 2)),
+      4);
+}
+
+TEST_F(ModelSizesTest, LargestModels) {
+  Scope scope;
+  auto* dex_small = redex::create_void_method(
+      scope,
+      "LClass;",
+      "small",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;");
+  auto* dex_large = redex::create_void_method(
+      scope,
+      "LClass;",
+      "large",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;");
+  DexStore store("stores");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* small = context.methods->get(dex_small);
+  auto* large = context.methods->get(dex_large);
+
+  ModelSizes sizes(/* warning_threshold */ 4);
+  sizes.add(small, make_model(small, context, /* number_of_sinks */ 1));
+  sizes.add(large, make_model(large, context, /* number_of_sinks */ 1));
+  sizes.add(large, make_model(large, context, /* number_of_sinks */ 3));
+  EXPECT_THAT(sizes.growth(small), testing::ElementsAre(3));
+  EXPECT_THAT(sizes.growth(large), testing::ElementsAre(3, 5));
+
+  auto registry = Registry(
+      context,
+      /* models */
+      {make_model(small, context, /* number_of_sinks */ 1),
+       make_model(large, context, /* number_of_sinks */ 3)},
+      /* field_models */ {});
+  auto value = sizes.to_json(registry);
+  ASSERT_EQ(value.size(), 2);
+  EXPECT_EQ(
+      value[0]["method"].asString(), "LClass;.large:()Ljava/lang/Object;");
+  EXPECT_EQ(value[0]["frames"].asUInt64(), 5);
+  EXPECT_EQ(value[0]["frames_per_analysis"].size(), 2);
+  EXPECT_EQ(
+      value[1]["method"].asString(), "LClass;.small:()Ljava/lang/Object;");
+  EXPECT_EQ(value[1]["frames"].asUInt64(), 3);
+}
+
+} // namespace marianatrench
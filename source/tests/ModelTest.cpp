@@ -568,6 +568,62 @@ TEST_F(ModelTest, LessOrEqual) {
       model_with_frozen_parameter_sources.leq(model_with_frozen_generation));
 }
 
+TEST_F(ModelTest, LessOrEqualCallerVisible) {
+  auto context = test::make_empty_context();
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  const auto* sink_kind = context.kind_factory->get("TestSink");
+  auto rule = std::make_unique<SourceSinkRule>(
+      "rule",
+      1,
+      "",
+      Rule::KindSet{source_kind},
+      Rule::KindSet{sink_kind},
+      /* transforms */ nullptr);
+
+  Model model_with_issue(
+      /* method */ nullptr,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */ {},
+      /* parameter_sources */ {},
+      /* sinks */ {},
+      /* propagations */ {},
+      /* global_sanitizers */ {},
+      /* port_sanitizers */ {},
+      /* attach_to_sources */ {},
+      /* attach_to_sinks */ {},
+      /* attach_to_propagations */ {},
+      /* add_features_to_arguments */ {},
+      /* inline_as_getter */ AccessPathConstantDomain::bottom(),
+      /* inline_as_setter */ SetterAccessPathConstantDomain::bottom(),
+      /* model_generators */ {},
+      /* issues */
+      IssueSet{Issue(
+          /* source */ Taint{test::make_leaf_taint_config(source_kind)},
+          /* sink */ Taint{test::make_leaf_taint_config(sink_kind)},
+          rule.get(),
+          /* callee */ std::string(k_return_callee),
+          /* sink_index */ 0,
+          context.positions->unknown())});
+
+  // Issues are not visible to callers.
+  EXPECT_FALSE(model_with_issue.leq(Model()));
+  EXPECT_TRUE(model_with_issue.leq_caller_visible(Model()));
+
+  Model model_with_source(
+      /* method */ nullptr,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind)}});
+  EXPECT_FALSE(model_with_source.leq(Model()));
+  EXPECT_FALSE(model_with_source.leq_caller_visible(Model()));
+  EXPECT_TRUE(Model().leq_caller_visible(model_with_source));
+}
+
 TEST_F(ModelTest, Join) {
   using PortTaint = std::pair<AccessPath, Taint>;
 
@@ -1272,4 +1328,76 @@ TEST_F(ModelTest, PropagationTransforms) {
       testing::UnorderedElementsAre(transform1));
 }
 
+TEST_F(ModelTest, ReducePrecision) {
+  auto context = test::make_empty_context();
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  const auto* feature = context.feature_factory->get("inferred");
+  const auto* user_feature = context.feature_factory->get("user");
+  const auto* local_position = context.positions->get(std::nullopt, 1);
+
+  auto source = test::make_taint_config(
+      source_kind,
+      test::FrameProperties{
+          .inferred_features = FeatureMayAlwaysSet::make_may({feature}),
+          .locally_inferred_features =
+              FeatureMayAlwaysSet::make_always({feature}),
+          .user_features = FeatureSet{user_feature},
+          .local_positions = {local_position}});
+  Model model(
+      /* method */ nullptr,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(
+            Root(Root::Kind::Return), Path{PathElement::field("x")}),
+        source},
+       {AccessPath(
+            Root(Root::Kind::Return), Path{PathElement::field("y")}),
+        source}});
+  model.reduce_precision(/* widening_features */ FeatureMayAlwaysSet{
+      context.feature_factory->get_widen_broadening_feature()});
+
+  // Leaves are collapsed, inferred features and local positions are dropped.
+  EXPECT_EQ(
+      model,
+      Model(
+          /* method */ nullptr,
+          context,
+          /* modes */ {},
+          /* frozen */ {},
+          /* generations */
+          {{AccessPath(Root(Root::Kind::Return)),
+            test::make_taint_config(
+                source_kind,
+                test::FrameProperties{
+                    .user_features = FeatureSet{user_feature}})}}));
+}
+
+TEST_F(ModelTest, CopiesShareColdParts) {
+  auto context = test::make_empty_context();
+  const auto* feature = context.feature_factory->get("feature");
+  auto root = Root(Root::Kind::Argument, 0);
+
+  Model model;
+  Model copy = model;
+  copy.add_attach_to_sources(root, FeatureSet{feature});
+  EXPECT_TRUE(model.empty());
+  EXPECT_EQ(copy.attach_to_sources(root), FeatureSet{feature});
+
+  // Modifying a copy does not modify the parts shared with the original.
+  Model other_copy = copy;
+  other_copy.add_attach_to_sinks(root, FeatureSet{feature});
+  EXPECT_TRUE(copy.attach_to_sinks(root).is_bottom());
+  EXPECT_EQ(other_copy.attach_to_sinks(root), FeatureSet{feature});
+  EXPECT_TRUE(copy.leq(other_copy));
+  EXPECT_FALSE(other_copy.leq(copy));
+
+  model.join_with(other_copy);
+  EXPECT_EQ(model, other_copy);
+  model.add_attach_to_propagations(root, FeatureSet{feature});
+  EXPECT_TRUE(other_copy.attach_to_propagations(root).is_bottom());
+  EXPECT_NE(model, other_copy);
+}
+
 } // namespace marianatrench
@@ -47,8 +47,13 @@ Context test_overrides(const Scope& scope) {
   context.types = std::make_unique<Types>(*context.options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
   context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
   return context;
 }
 
@@ -97,3 +102,105 @@ TEST_F(OverridesTest, Overrides) {
       testing::UnorderedElementsAre(indirect_override));
   EXPECT_TRUE(overrides.get(indirect_override).empty());
 }
+
+TEST_F(OverridesTest, SubclassesRange) {
+  Scope scope;
+
+  auto* dex_callee = redex::create_void_method(scope, "LCallee;", "callee");
+  auto* dex_override_one = redex::create_void_method(
+      scope,
+      "LSubclassOne;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_callee->get_class());
+  auto* dex_override_two = redex::create_void_method(
+      scope,
+      "LSubclassTwo;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_callee->get_class());
+  auto* dex_indirect_override = redex::create_void_method(
+      scope,
+      "LIndirectSubclass;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_override_two->get_class());
+
+  auto context = test_overrides(scope);
+  const auto& overrides = *context.overrides;
+  auto* callee = context.methods->get(dex_callee);
+  auto* override_two = context.methods->get(dex_override_two);
+  auto* indirect_override = context.methods->get(dex_indirect_override);
+
+  auto overrides_in_range = [&](const Method* method, const DexType* type) {
+    const auto& index = overrides.get_interval_index(method);
+    auto range = overrides.subclasses_range(index, type);
+    EXPECT_TRUE(range.has_value());
+    std::vector<const Method*> result;
+    for (auto i = range->first; i < range->second; i++) {
+      result.push_back(index[i].second);
+    }
+    return result;
+  };
+
+  EXPECT_EQ(overrides.get_interval_index(callee).size(), 3);
+  EXPECT_THAT(
+      overrides_in_range(callee, dex_callee->get_class()),
+      testing::UnorderedElementsAre(
+          context.methods->get(dex_override_one),
+          override_two,
+          indirect_override));
+  EXPECT_THAT(
+      overrides_in_range(callee, dex_override_two->get_class()),
+      testing::UnorderedElementsAre(indirect_override));
+  EXPECT_TRUE(
+      overrides_in_range(callee, dex_override_one->get_class()).empty());
+  EXPECT_THAT(
+      overrides_in_range(override_two, dex_override_two->get_class()),
+      testing::UnorderedElementsAre(indirect_override));
+  EXPECT_TRUE(overrides.get_interval_index(indirect_override).empty());
+}
+
+TEST_F(OverridesTest, SharedOverrideSets) {
+  Scope scope;
+
+  auto* dex_callee = redex::create_void_method(scope, "LCallee;", "callee");
+  auto* dex_override_one = redex::create_void_method(
+      scope,
+      "LSubclassOne;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_callee->get_class());
+  auto* dex_override_two = redex::create_void_method(
+      scope,
+      "LSubclassTwo;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_callee->get_class());
+  auto* dex_indirect_override = redex::create_void_method(
+      scope,
+      "LIndirectSubclass;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "V",
+      /* super */ dex_override_two->get_class());
+
+  auto context = test_overrides(scope);
+  auto& overrides = *context.overrides;
+  auto* override_one = context.methods->get(dex_override_one);
+  auto* override_two = context.methods->get(dex_override_two);
+  auto* indirect_override = context.methods->get(dex_indirect_override);
+  EXPECT_EQ(overrides.number_of_distinct_sets(), 2);
+
+  overrides.set(override_one, {indirect_override});
+  EXPECT_EQ(&overrides.get(override_one), &overrides.get(override_two));
+  EXPECT_EQ(
+      &overrides.get_interval_index(override_one),
+      &overrides.get_interval_index(override_two));
+  EXPECT_EQ(overrides.number_of_distinct_sets(), 2);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+#include <filesystem>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/Progress.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class ProgressTest : public test::Test {};
+
+TEST_F(ProgressTest, Status) {
+  auto context = test::make_empty_context();
+
+  Scope scope;
+  auto* method = context.methods->create(
+      redex::create_void_method(scope, "LClass;", "method"));
+
+  auto path =
+      std::filesystem::temp_directory_path() / "mariana-trench-status.json";
+  std::filesystem::remove(path);
+
+  {
+    Progress progress(path, /* interval */ std::chrono::hours(1));
+    progress.set_phase("fixpoint");
+    progress.start_iteration(/* iteration */ 2, /* work_items */ 3);
+    progress.add_work_items(1);
+
+    {
+      Progress::MethodScope scope(&progress, method);
+      auto value = progress.to_json();
+      EXPECT_EQ(value["phase"].asString(), "fixpoint");
+      EXPECT_EQ(value["iteration"].asUInt64(), 2);
+      EXPECT_EQ(value["work_items"].asUInt64(), 4);
+      EXPECT_EQ(value["work_items_remaining"].asUInt64(), 4);
+      ASSERT_EQ(value["running_methods"].size(), 1);
+      EXPECT_EQ(
+          value["running_methods"][0]["method"].asString(),
+          "LClass;.method:()V");
+    }
+    progress.complete_work_item();
+
+    // Nothing is written before the first interval.
+    EXPECT_FALSE(std::filesystem::exists(path));
+  }
+
+  // The final status is written on destruction.
+  auto value = JsonValidation::parse_json_file(path);
+  EXPECT_EQ(value["methods_analyzed"].asUInt64(), 1);
+  EXPECT_EQ(value["work_items_remaining"].asUInt64(), 3);
+  EXPECT_EQ(value["running_methods"].size(), 0);
+
+  std::filesystem::remove(path);
+}
+
+} // namespace marianatrench
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Reachability.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class ReachabilityTest : public test::Test {};
+
+TEST_F(ReachabilityTest, SkipUnreachableMethods) {
+  Scope scope;
+  auto* dex_callee = redex::create_method(scope, "LCallee;", R"(
+    (method (public static) "LCallee;.callee:()V"
+     (
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_entry = redex::create_method(scope, "LEntry;", R"(
+    (method (private) "LEntry;.onLifecycle:()V"
+     (
+      (load-param-object v0)
+      (invoke-static () "LCallee;.callee:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_unreachable = redex::create_method(scope, "LUnreachable;", R"(
+    (method (public static) "LUnreachable;.unreachable:()V"
+     (
+      (invoke-static () "LCallee;.callee:()V")
+      (return-void)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* callee = context.methods->get(dex_callee);
+  const auto* entry = context.methods->get(dex_entry);
+  const auto* unreachable = context.methods->get(dex_unreachable);
+
+  std::unordered_set<std::string> lifecycle_method_names = {"onLifecycle"};
+  auto reachable_methods =
+      Reachability::reachable_methods(context, lifecycle_method_names);
+  EXPECT_EQ(reachable_methods.count(entry), 1);
+  EXPECT_EQ(reachable_methods.count(callee), 1);
+  EXPECT_EQ(reachable_methods.count(unreachable), 0);
+
+  auto registry = Registry(context);
+  EXPECT_EQ(
+      Reachability::skip_unreachable_methods(
+          context, registry, lifecycle_method_names),
+      1);
+  EXPECT_FALSE(registry.get(entry).skip_analysis());
+  EXPECT_FALSE(registry.get(callee).skip_analysis());
+  EXPECT_TRUE(registry.get(unreachable).skip_analysis());
+}
@@ -5,6 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 
 #include <json/value.h>
@@ -13,6 +18,7 @@
 #include <mariana-trench/Context.h>
 #include <mariana-trench/Dependencies.h>
 #include <mariana-trench/Fields.h>
+#include <mariana-trench/JsonValidation.h>
 #include <mariana-trench/Model.h>
 #include <mariana-trench/Redex.h>
 #include <mariana-trench/Registry.h>
@@ -34,19 +40,15 @@ TEST_F(RegistryTest, remove_kinds) {
   store.add_classes(scope);
   auto context = test::make_context(store);
 
-  auto registry = Registry::load(
-      context,
-      *context.options,
-      /* generated_models */
-      context.artificial_methods->models(
-          context), // used to make sure we get ArrayAllocation
-      /* generated_field_models */ {});
   context.rules =
       std::make_unique<Rules>(Rules::load(context, *context.options));
   context.used_kinds = std::make_unique<UsedKinds>(
       UsedKinds::from_rules(*context.rules, *context.transforms_factory));
-  auto old_model_json = JsonValidation::null_or_array(
-      registry.models_to_json(), /* field */ "models");
+
+  // Used to make sure we get ArrayAllocation.
+  auto artificial_models = context.artificial_methods->models(context);
+  EXPECT_FALSE(artificial_models[0].sinks().is_bottom());
+
   auto unused_kinds =
       context.rules->collect_unused_kinds(*context.kind_factory);
   auto is_array_allocation = [](const Kind* kind) -> bool {
@@ -57,33 +59,16 @@ TEST_F(RegistryTest, remove_kinds) {
       std::find_if(
           unused_kinds.begin(), unused_kinds.end(), is_array_allocation),
       unused_kinds.end());
-  EXPECT_TRUE(old_model_json[0].isMember("sinks"));
-  // JSON model:
-  // [ "sinks": [
-  //   { "caller_port": "Argument(0)",
-  //     "taint": [
-  //       {
-  //         "call" : { /* callee, port, position */ },
-  //         "kinds" : [
-  //           { /* Frame */ "kind": "ArrayAllocation", distance: 2, }
-  //         ]
-  //       } // end "taint[0]"
-  //     ] // end "taint"
-  //   }
-  // ] ]
-  EXPECT_EQ(
-      old_model_json[0]["sinks"][0]["taint"][0]["kinds"][0]["kind"],
-      "ArrayAllocation");
-  context.used_kinds->remove_unused_kinds(
-      *context.rules,
-      *context.kind_factory,
-      *context.methods,
-      *context.artificial_methods,
-      registry);
-  auto new_model_json = JsonValidation::null_or_array(
+
+  // Unused kinds are dropped while loading the models.
+  auto registry = Registry::load(
+      context,
+      *context.options,
+      /* generated_models */ artificial_models,
+      /* generated_field_models */ {});
+  auto model_json = JsonValidation::null_or_array(
       registry.models_to_json(), /* field */ "models");
-  EXPECT_NE(new_model_json, old_model_json);
-  EXPECT_FALSE(new_model_json[0].isMember("sinks"));
+  EXPECT_FALSE(model_json[0].isMember("sinks"));
 }
 
 TEST_F(RegistryTest, JoinWith) {
@@ -149,6 +134,7 @@ TEST_F(RegistryTest, JoinWith) {
   EXPECT_EQ(
       registry.get(method).generations().elements().at(0).second.num_frames(),
       2);
+  EXPECT_FALSE(registry.may_have_field_model(dex_field));
 
   registry.join_with(Registry(
       context,
@@ -167,6 +153,11 @@ TEST_F(RegistryTest, JoinWith) {
                   .user_features = FeatureSet::bottom()})},
           /* sinks */ {})}));
   EXPECT_EQ(registry.get(field).sources().num_frames(), 1);
+  EXPECT_TRUE(registry.may_have_field_model(dex_field));
+  EXPECT_FALSE(registry.may_have_field_model(DexField::make_field(
+      dex_field->get_class(),
+      DexString::make_string("other"),
+      type::java_lang_String())));
 
   registry.join_with(Registry(
       context,
@@ -292,4 +283,266 @@ TEST_F(RegistryTest, ConstructorUseJoin) {
                    .user_features = FeatureSet::bottom()})}));
 }
 
+TEST_F(RegistryTest, Snapshot) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      /* class_name */ "LClass;",
+      /* method_name */ "method",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "Ljava/lang/Object;");
+
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto registry = Registry(context);
+  auto snapshot = registry.get_snapshot(method);
+  EXPECT_EQ(snapshot->method(), method);
+  EXPECT_TRUE(snapshot->generations().is_bottom());
+
+  registry.set(Model(
+      /* method */ method,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind)}}));
+
+  // Previous snapshots are not affected by updates.
+  EXPECT_TRUE(snapshot->generations().is_bottom());
+  EXPECT_FALSE(registry.get_snapshot(method)->generations().is_bottom());
+  EXPECT_EQ(*registry.get_snapshot(method), registry.get(method));
+}
+
+TEST_F(RegistryTest, UpdateInPlace) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(scope, "LClass;", "method");
+
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  const auto* other_source_kind = context.kind_factory->get("OtherSource");
+
+  auto registry = Registry(context);
+  registry.set(Model(method, context));
+
+  // Models without snapshots are updated in place.
+  const auto* address = registry.get_snapshot(method).get();
+  registry.update(method, [&](Model& model) {
+    model.add_generation(
+        AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind));
+  });
+  EXPECT_EQ(registry.get_snapshot(method).get(), address);
+
+  // Snapshots held by readers are not modified.
+  auto snapshot = registry.get_snapshot(method);
+  registry.update(method, [&](Model& model) {
+    model.add_generation(
+        AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(other_source_kind));
+  });
+  EXPECT_NE(registry.get_snapshot(method), snapshot);
+  EXPECT_FALSE(registry.get_snapshot(method)->leq(*snapshot));
+  EXPECT_TRUE(snapshot->leq(*registry.get_snapshot(method)));
+}
+
+TEST_F(RegistryTest, Freeze) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      /* class_name */ "LClass;",
+      /* method_name */ "method",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "Ljava/lang/Object;");
+
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto registry = Registry(context);
+  auto snapshot = registry.get_snapshot(method);
+  registry.freeze();
+  EXPECT_EQ(registry.get_snapshot(method), snapshot);
+
+  auto model = Model(
+      /* method */ method,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind)}});
+  registry.set(model);
+
+  // Models published while frozen are only read after unfreezing.
+  EXPECT_EQ(registry.get_snapshot(method), snapshot);
+  EXPECT_TRUE(registry.get(method).generations().is_bottom());
+  registry.unfreeze();
+  EXPECT_EQ(registry.get(method), model);
+}
+
+TEST_F(RegistryTest, Evict) {
+  Scope scope;
+  auto* dex_method = redex::create_void_method(
+      scope,
+      /* class_name */ "LClass;",
+      /* method_name */ "method",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "Ljava/lang/Object;");
+
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  auto* method = context.methods->get(dex_method);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto registry = Registry(context);
+  registry.set(Model(
+      /* method */ method,
+      context,
+      /* modes */ {},
+      /* frozen */ {},
+      /* generations */
+      {{AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind)}}));
+  auto models_size = registry.models_size();
+
+  // Snapshots held by readers are still valid.
+  auto snapshot = registry.get_snapshot(method);
+  registry.evict(method);
+  EXPECT_FALSE(snapshot->generations().is_bottom());
+  EXPECT_THROW(registry.get_snapshot(method), std::logic_error);
+  EXPECT_EQ(registry.models_size(), models_size);
+  EXPECT_EQ(registry.evicted_models_size(), 1);
+  EXPECT_EQ(registry.issues_size(), 0);
+}
+
+TEST_F(RegistryTest, MatchLiteral) {
+  Scope scope;
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* regex_kind = context.kind_factory->get("Regex");
+  const auto* api_key_kind = context.kind_factory->get("GoogleAPIKey");
+  const auto* select_kind = context.kind_factory->get("Select");
+
+  auto registry = Registry(
+      context,
+      /* models_value */ test::parse_json(R"([])"),
+      /* field_models_value */ test::parse_json(R"([])"),
+      /* literal_models_value */ test::parse_json(R"([
+          {
+            "pattern": "SELECT \\*.*",
+            "sources": [{"kind": "Regex"}]
+          },
+          {
+            "pattern": "AI[0-9A-Z]{16}",
+            "sources": [{"kind": "GoogleAPIKey"}]
+          }
+        ])"));
+
+  EXPECT_THAT(
+      registry.match_literal("SELECT * FROM table").sources().kinds(),
+      testing::UnorderedElementsAre(regex_kind));
+  EXPECT_THAT(
+      registry.match_literal("AI0123456789ABCDEF").sources().kinds(),
+      testing::UnorderedElementsAre(api_key_kind));
+  EXPECT_TRUE(registry.match_literal("AI0123456789ABCDEFG").empty());
+  EXPECT_TRUE(registry.match_literal("Hello").empty());
+
+  const auto* select = DexString::make_string("SELECT * FROM table");
+  const auto* hello = DexString::make_string("Hello");
+  EXPECT_THAT(
+      registry.match_literal(select).sources().kinds(),
+      testing::UnorderedElementsAre(regex_kind));
+  EXPECT_TRUE(registry.match_literal(hello).empty());
+
+  // Memoized results are invalidated when literal models are added.
+  registry.join_with(Registry(
+      context,
+      /* models_value */ test::parse_json(R"([])"),
+      /* field_models_value */ test::parse_json(R"([])"),
+      /* literal_models_value */ test::parse_json(R"([
+          {
+            "pattern": "SELECT .*",
+            "sources": [{"kind": "Select"}]
+          }
+        ])")));
+  EXPECT_THAT(
+      registry.match_literal(select).sources().kinds(),
+      testing::UnorderedElementsAre(regex_kind, select_kind));
+  EXPECT_TRUE(registry.match_literal(hello).empty());
+}
+
+TEST_F(RegistryTest, DumpModelIndex) {
+  Scope scope;
+  std::vector<DexMethod*> dex_methods;
+  for (const auto* name : {"one", "two", "three"}) {
+    dex_methods.push_back(redex::create_void_method(scope, "LClass;", name));
+  }
+
+  DexStore store("store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* source_kind = context.kind_factory->get("TestSource");
+
+  auto registry = Registry(context);
+  for (auto* dex_method : dex_methods) {
+    registry.set(Model(
+        /* method */ context.methods->get(dex_method),
+        context,
+        /* modes */ {},
+        /* frozen */ {},
+        /* generations */
+        {{AccessPath(Root(Root::Kind::Return)),
+          test::make_leaf_taint_config(source_kind)}}));
+  }
+
+  auto directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-model-index-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  auto index_path = directory / "model_index.json";
+  registry.dump_models(
+      directory,
+      /* shard_limit */ 2,
+      /* compression_level */ 0,
+      /* string_tables */ false,
+      index_path);
+
+  std::ifstream index(index_path);
+  std::string line;
+  std::size_t entries = 0;
+  while (std::getline(index, line)) {
+    if (line.rfind("//", 0) == 0) {
+      continue;
+    }
+    auto entry = test::parse_json(line);
+    if (entries % 2 == 0) {
+      EXPECT_EQ(
+          entry["offset"].asUInt64(), JsonValidation::json_lines_header_size());
+    }
+    entries++;
+
+    // Each entry points at the line of its model, including the newline.
+    std::ifstream shard(directory / entry["shard"].asString());
+    ASSERT_TRUE(shard.is_open());
+    shard.seekg(entry["offset"].asUInt64());
+    std::string model(entry["length"].asUInt64(), '\0');
+    shard.read(model.data(), model.size());
+    EXPECT_EQ(model.back(), '\n');
+    EXPECT_EQ(test::parse_json(model)["method"], entry["method"]);
+  }
+  EXPECT_EQ(entries, 3);
+}
+
 } // namespace marianatrench
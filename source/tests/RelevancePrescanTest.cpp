@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/RelevancePrescan.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class RelevancePrescanTest : public test::Test {};
+
+TEST_F(RelevancePrescanTest, MayChangeModel) {
+  Scope scope;
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      "LCallee;",
+      "callee",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LCallee;.callee:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  auto* dex_identity = redex::create_method(scope, "LIdentity;", R"(
+    (method (public static) "LIdentity;.identity:(Ljava/lang/Object;)Ljava/lang/Object;"
+     (
+      (load-param-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* callee = context.methods->get(dex_callee);
+  const auto* caller = context.methods->get(dex_caller);
+  const auto* identity = context.methods->get(dex_identity);
+
+  auto registry = Registry(context);
+  RelevancePrescan prescan;
+  EXPECT_FALSE(
+      prescan.may_change_model(context, registry, registry.get(caller)));
+  EXPECT_TRUE(
+      prescan.may_change_model(context, registry, registry.get(identity)));
+  EXPECT_FALSE(RelevancePrescan::may_introduce_forward_taint(
+      context, registry, registry.get(caller)));
+
+  // Changes of callee models are seen by the next query.
+  auto callee_model = Model(callee, context);
+  callee_model.add_generation(
+      AccessPath(Root(Root::Kind::Return)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSource")));
+  registry.set(callee_model);
+  EXPECT_TRUE(
+      prescan.may_change_model(context, registry, registry.get(caller)));
+  EXPECT_TRUE(RelevancePrescan::may_introduce_forward_taint(
+      context, registry, registry.get(caller)));
+}
+
+TEST_F(RelevancePrescanTest, MayIntroduceBackwardTaint) {
+  Scope scope;
+  auto* dex_callee = redex::create_void_method(
+      scope,
+      "LCallee;",
+      "callee",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "V",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:(Ljava/lang/Object;)V"
+     (
+      (load-param-object v0)
+      (invoke-static (v0) "LCallee;.callee:(Ljava/lang/Object;)V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_identity = redex::create_method(scope, "LIdentity;", R"(
+    (method (public static) "LIdentity;.identity:(Ljava/lang/Object;)Ljava/lang/Object;"
+     (
+      (load-param-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* callee = context.methods->get(dex_callee);
+  const auto* caller = context.methods->get(dex_caller);
+  const auto* identity = context.methods->get(dex_identity);
+
+  auto registry = Registry(context);
+  EXPECT_FALSE(RelevancePrescan::may_introduce_backward_taint(
+      context, registry, registry.get(caller)));
+  // Returned values are tainted with the local return kind.
+  EXPECT_TRUE(RelevancePrescan::may_introduce_backward_taint(
+      context, registry, registry.get(identity)));
+
+  auto callee_model = Model(callee, context);
+  callee_model.add_sink(
+      AccessPath(Root(Root::Kind::Argument, 0)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSink")));
+  registry.set(callee_model);
+  EXPECT_TRUE(RelevancePrescan::may_introduce_backward_taint(
+      context, registry, registry.get(caller)));
+}
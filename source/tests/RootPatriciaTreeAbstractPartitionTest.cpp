@@ -233,4 +233,49 @@ TEST_F(RootPatriciaTreeAbstractPartitionTest, Iterator) {
           Pair{Root(Root::Kind::Argument, 1), IntSet{3}}));
 }
 
+TEST_F(RootPatriciaTreeAbstractPartitionTest, FlatAndMapRoots) {
+  using Pair = std::pair<Root, IntSet>;
+  std::vector<Pair> elements;
+
+  // Arguments with a large position are stored in the patricia tree map.
+  auto map = RootToIntSetPartition{
+      {Root(Root::Kind::Return), IntSet{1}},
+      {Root(Root::Kind::Argument, 20), IntSet{2}},
+      {Root(Root::Kind::Leaf), IntSet{3}},
+  };
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(map.get(Root(Root::Kind::Argument, 20)), IntSet{2});
+  EXPECT_EQ(map.get(Root(Root::Kind::Argument, 0)), IntSet::bottom());
+  elements = {map.begin(), map.end()};
+  EXPECT_THAT(
+      elements,
+      testing::UnorderedElementsAre(
+          Pair{Root(Root::Kind::Return), IntSet{1}},
+          Pair{Root(Root::Kind::Argument, 20), IntSet{2}},
+          Pair{Root(Root::Kind::Leaf), IntSet{3}}));
+
+  // Copies are independent.
+  auto copy = map;
+  copy.set(Root(Root::Kind::Return), IntSet::bottom());
+  copy.set(Root(Root::Kind::Argument, 1), IntSet{4});
+  EXPECT_EQ(map.get(Root(Root::Kind::Return)), IntSet{1});
+  EXPECT_EQ(map.get(Root(Root::Kind::Argument, 1)), IntSet::bottom());
+  EXPECT_EQ(copy.size(), 3);
+  EXPECT_FALSE(map.leq(copy));
+  EXPECT_FALSE(copy.leq(map));
+
+  copy.join_with(map);
+  EXPECT_TRUE(map.leq(copy));
+  EXPECT_EQ(copy.size(), 4);
+
+  copy.difference_with(map);
+  EXPECT_EQ(
+      copy,
+      (RootToIntSetPartition{{Root(Root::Kind::Argument, 1), IntSet{4}}}));
+
+  copy.set(Root(Root::Kind::Argument, 1), IntSet::bottom());
+  EXPECT_TRUE(copy.is_bottom());
+  EXPECT_EQ(copy, RootToIntSetPartition::bottom());
+}
+
 } // namespace marianatrench
@@ -153,6 +153,22 @@ TEST_F(RuleTest, Rules) {
       to_codes(rules.partial_rules(source_a, partial_sink_lbl_b)),
       testing::UnorderedElementsAre(5));
   EXPECT_TRUE(rules.partial_rules(source_b, partial_sink_lbl_b).empty());
+
+  /* Tests for the matrices of kinds with rules. */
+  auto index = [&rules](const Kind* kind) { return *rules.kind_index(kind); };
+  EXPECT_FALSE(rules.kind_index(sink_z).has_value());
+  EXPECT_TRUE(rules.may_have_rules(index(source_a), index(sink_x)));
+  EXPECT_FALSE(rules.may_have_rules(index(sink_x), index(source_a)));
+  EXPECT_FALSE(rules.may_have_rules(index(source_a), index(source_b)));
+  EXPECT_TRUE(
+      rules.may_have_rules(index(source_a), index(triggered_sink_lbl_a)));
+  EXPECT_FALSE(
+      rules.may_have_rules(index(source_b), index(triggered_sink_lbl_b)));
+  EXPECT_TRUE(rules.may_have_partial_rules(
+      index(source_a), index(partial_sink_lbl_a)));
+  EXPECT_FALSE(rules.may_have_partial_rules(
+      index(source_b), index(partial_sink_lbl_b)));
+  EXPECT_FALSE(rules.may_have_partial_rules(index(source_a), index(sink_x)));
 }
 
 TEST_F(RuleTest, TransformRules) {
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <mariana-trench/ConcurrentMethodSet.h>
+#include <mariana-trench/Dependencies.h>
+#include <mariana-trench/Method.h>
+#include <mariana-trench/Partitions.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Scheduler.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+namespace {
+
+class SchedulerTest : public test::Test {};
+
+} // anonymous namespace
+
+TEST_F(SchedulerTest, ComponentGraph) {
+  Scope scope;
+
+  /*
+   *    Top
+   *  /     \
+   * Left - Right
+   *   \    /
+   *   Bottom
+   */
+  auto* dex_bottom = redex::create_void_method(scope, "LBottom;", "bottom");
+  auto* dex_left = redex::create_method(scope, "LLeft;", R"(
+    (method (public) "LLeft;.left:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LBottom;.bottom:()V")
+      (invoke-direct (v0) "LRight;.right:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_right = redex::create_method(scope, "LRight;", R"(
+    (method (public) "LRight;.right:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LBottom;.bottom:()V")
+      (invoke-direct (v0) "LLeft;.left:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_top = redex::create_method(scope, "LTop;", R"(
+    (method (public) "LTop;.top:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LLeft;.left:()V")
+      (invoke-direct (v0) "LRight;.right:()V")
+      (return-void)
+     )
+    )
+  )");
+
+  auto context = test::make_call_graph_context(scope);
+  auto* bottom = context.methods->get(dex_bottom);
+  auto* top = context.methods->get(dex_top);
+  auto* left = context.methods->get(dex_left);
+  auto* right = context.methods->get(dex_right);
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+
+  auto bottom_component = scheduler.component_of(bottom);
+  auto left_component = scheduler.component_of(left);
+  auto right_component = scheduler.component_of(right);
+  auto top_component = scheduler.component_of(top);
+
+  EXPECT_EQ(left_component, right_component);
+  EXPECT_LT(bottom_component, left_component);
+  EXPECT_LT(left_component, top_component);
+
+  EXPECT_THAT(
+      scheduler.component(left_component),
+      testing::UnorderedElementsAre(left, right));
+
+  EXPECT_EQ(scheduler.callee_components_size(bottom_component), 0);
+  EXPECT_EQ(scheduler.callee_components_size(left_component), 1);
+  EXPECT_EQ(scheduler.callee_components_size(top_component), 1);
+
+  EXPECT_THAT(
+      scheduler.dependent_components(bottom_component),
+      testing::ElementsAre(left_component));
+  EXPECT_THAT(
+      scheduler.dependent_components(left_component),
+      testing::ElementsAre(top_component));
+  EXPECT_TRUE(scheduler.dependent_components(top_component).empty());
+}
+
+TEST_F(SchedulerTest, ScheduleBalancesCost) {
+  Scope scope;
+
+  /*
+   *    Top
+   *  /     \
+   * Left  Right
+   *   \    /
+   *   Bottom
+   */
+  auto* dex_bottom = redex::create_void_method(scope, "LBottom;", "bottom");
+  auto* dex_left = redex::create_method(scope, "LLeft;", R"(
+    (method (public) "LLeft;.left:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LBottom;.bottom:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_right = redex::create_method(scope, "LRight;", R"(
+    (method (public) "LRight;.right:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LBottom;.bottom:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_top = redex::create_method(scope, "LTop;", R"(
+    (method (public) "LTop;.top:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LLeft;.left:()V")
+      (invoke-direct (v0) "LRight;.right:()V")
+      (return-void)
+     )
+    )
+  )");
+
+  auto context = test::make_call_graph_context(scope);
+  auto* bottom = context.methods->get(dex_bottom);
+  auto* top = context.methods->get(dex_top);
+  auto* left = context.methods->get(dex_left);
+  auto* right = context.methods->get(dex_right);
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+  scheduler.log_analysis_time(bottom, 10.0);
+  scheduler.log_analysis_time(left, 1.0);
+  scheduler.log_analysis_time(right, 1.0);
+  scheduler.log_analysis_time(top, 1.0);
+
+  ConcurrentMethodSet methods(*context.methods);
+  methods.insert(bottom);
+  methods.insert(left);
+  methods.insert(right);
+  methods.insert(top);
+
+  std::vector<const Method*> order;
+  std::unordered_map<const Method*, std::size_t> threads;
+  scheduler.schedule(
+      methods,
+      [&](const Method* method, std::size_t thread) {
+        order.push_back(method);
+        threads.emplace(method, thread);
+      },
+      /* threads */ 2);
+
+  EXPECT_EQ(order.size(), 4);
+  EXPECT_EQ(order.front(), bottom);
+  EXPECT_EQ(order.back(), top);
+  EXPECT_NE(threads.at(bottom), threads.at(left));
+  EXPECT_EQ(threads.at(left), threads.at(right));
+  EXPECT_EQ(threads.at(left), threads.at(top));
+}
+
+TEST_F(SchedulerTest, ScheduleSplitsLargeComponents) {
+  Scope scope;
+
+  // First -> Second -> Third -> Fourth -> First
+  std::vector<std::string> names = {"First", "Second", "Third", "Fourth"};
+  std::vector<DexMethod*> dex_methods;
+  for (std::size_t i = 0; i < names.size(); i++) {
+    const auto& name = names[i];
+    const auto& callee = names[(i + 1) % names.size()];
+    dex_methods.push_back(redex::create_method(
+        scope,
+        "L" + name + ";",
+        fmt::format(
+            R"(
+      (method (public) "L{0};.call:()V"
+       (
+        (load-param-object v0)
+        (invoke-direct (v0) "L{1};.call:()V")
+        (return-void)
+       )
+      ))",
+            name,
+            callee)));
+  }
+
+  auto context = test::make_call_graph_context(scope);
+  std::vector<const Method*> methods_vector;
+  ConcurrentMethodSet methods(*context.methods);
+  for (auto* dex_method : dex_methods) {
+    const auto* method = context.methods->get(dex_method);
+    methods_vector.push_back(method);
+    methods.insert(method);
+  }
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+  auto component = scheduler.component_of(methods_vector.front());
+  EXPECT_EQ(scheduler.component(component).size(), 4);
+  EXPECT_TRUE(scheduler.is_large_component(component, /* threads */ 2));
+  EXPECT_FALSE(scheduler.is_large_component(component, /* threads */ 1));
+
+  std::unordered_map<const Method*, std::size_t> threads;
+  scheduler.schedule(
+      methods,
+      [&](const Method* method, std::size_t thread) {
+        threads.emplace(method, thread);
+      },
+      /* threads */ 2);
+
+  // The methods of the component are balanced across threads.
+  EXPECT_EQ(threads.size(), 4);
+  std::size_t first_thread_methods = 0;
+  for (const auto& [_, thread] : threads) {
+    if (thread == 0) {
+      first_thread_methods++;
+    }
+  }
+  EXPECT_EQ(first_thread_methods, 2);
+}
+
+TEST_F(SchedulerTest, PriorityPromotesWidelyCalledMethods) {
+  Scope scope;
+
+  /*
+   * First  Second  Third  Other
+   *    \     |     /        |
+   *        Hub            Leaf
+   */
+  auto* dex_leaf = redex::create_void_method(scope, "LLeaf;", "leaf");
+  auto* dex_hub = redex::create_void_method(scope, "LHub;", "hub");
+  auto* dex_other = redex::create_method(scope, "LOther;", R"(
+    (method (public) "LOther;.other:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LLeaf;.leaf:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto dex_callers = redex::create_methods(
+      scope,
+      "LCaller;",
+      std::vector<std::string>{
+          R"(
+            (method (public) "LCaller;.first:()V"
+             (
+              (load-param-object v0)
+              (invoke-direct (v0) "LHub;.hub:()V")
+              (return-void)
+             )
+            )
+          )",
+          R"(
+            (method (public) "LCaller;.second:()V"
+             (
+              (load-param-object v0)
+              (invoke-direct (v0) "LHub;.hub:()V")
+              (return-void)
+             )
+            )
+          )",
+          R"(
+            (method (public) "LCaller;.third:()V"
+             (
+              (load-param-object v0)
+              (invoke-direct (v0) "LHub;.hub:()V")
+              (return-void)
+             )
+            )
+          )"});
+
+  auto context = test::make_call_graph_context(scope);
+  auto* leaf = context.methods->get(dex_leaf);
+  auto* hub = context.methods->get(dex_hub);
+  auto* other = context.methods->get(dex_other);
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+  EXPECT_LT(scheduler.priority(hub), scheduler.priority(leaf));
+  EXPECT_LT(scheduler.priority(leaf), scheduler.priority(other));
+  for (auto* dex_caller : dex_callers) {
+    auto* caller = context.methods->get(dex_caller);
+    EXPECT_LT(scheduler.priority(hub), scheduler.priority(caller));
+  }
+
+  std::vector<const Method*> methods = {other, leaf, hub};
+  scheduler.sort_by_priority(methods);
+  EXPECT_THAT(methods, testing::ElementsAre(hub, leaf, other));
+}
+
+TEST_F(SchedulerTest, PartitionsKeepCallersWithCallees) {
+  Scope scope;
+
+  /*
+   * First -> FirstLeaf
+   * Second -> SecondLeaf
+   */
+  auto* dex_first_leaf =
+      redex::create_void_method(scope, "LFirstLeaf;", "leaf");
+  auto* dex_second_leaf =
+      redex::create_void_method(scope, "LSecondLeaf;", "leaf");
+  auto* dex_first = redex::create_method(scope, "LFirst;", R"(
+    (method (public) "LFirst;.first:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LFirstLeaf;.leaf:()V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_second = redex::create_method(scope, "LSecond;", R"(
+    (method (public) "LSecond;.second:()V"
+     (
+      (load-param-object v0)
+      (invoke-direct (v0) "LSecondLeaf;.leaf:()V")
+      (return-void)
+     )
+    )
+  )");
+
+  auto context = test::make_call_graph_context(scope);
+  auto* first_leaf = context.methods->get(dex_first_leaf);
+  auto* second_leaf = context.methods->get(dex_second_leaf);
+  auto* first = context.methods->get(dex_first);
+  auto* second = context.methods->get(dex_second);
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+  Partitions partitions(scheduler, /* partitions */ 2);
+  EXPECT_EQ(partitions.size(), 2);
+  EXPECT_EQ(
+      partitions.partition_of(first), partitions.partition_of(first_leaf));
+  EXPECT_EQ(
+      partitions.partition_of(second), partitions.partition_of(second_leaf));
+  EXPECT_NE(partitions.partition_of(first), partitions.partition_of(second));
+  EXPECT_FALSE(partitions.is_exported(scheduler.component_of(first_leaf)));
+
+  auto value = partitions.to_json();
+  EXPECT_EQ(value["cut_edges"].asUInt64(), 0);
+  EXPECT_EQ(value["partitions"][0]["methods"].asUInt64(), 2);
+  EXPECT_EQ(value["partitions"][1]["methods"].asUInt64(), 2);
+  EXPECT_EQ(value["partitions"][0]["exported_components"].asUInt64(), 0);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Scheduler.h>
+#include <mariana-trench/Shard.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class ShardTest : public test::Test {};
+
+TEST_F(ShardTest, StoreLoadAndMerge) {
+  Scope scope;
+
+  /*
+   * First -> Leaf
+   * Second -> Leaf
+   */
+  auto* dex_leaf = redex::create_void_method(
+      scope,
+      "LLeaf;",
+      "leaf",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_first = redex::create_method(scope, "LFirst;", R"(
+    (method (public static) "LFirst;.first:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LLeaf;.leaf:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  auto* dex_second = redex::create_method(scope, "LSecond;", R"(
+    (method (public static) "LSecond;.second:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LLeaf;.leaf:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* leaf = context.methods->get(dex_leaf);
+  const auto* first = context.methods->get(dex_first);
+  const auto* second = context.methods->get(dex_second);
+
+  auto directory =
+      std::filesystem::temp_directory_path() / "mariana-trench-shards";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  Scheduler scheduler(*context.methods, *context.dependencies);
+  Shard first_shard(scheduler, /* shards */ 2, /* index */ 0, directory);
+  Shard second_shard(scheduler, /* shards */ 2, /* index */ 1, directory);
+  Shard merger(scheduler, /* shards */ 2, /* index */ std::nullopt, directory);
+  EXPECT_FALSE(first_shard.merging());
+  EXPECT_TRUE(merger.merging());
+  for (const auto* method : {leaf, first, second}) {
+    EXPECT_NE(first_shard.analyzes(method), second_shard.analyzes(method));
+    EXPECT_TRUE(merger.analyzes(method));
+  }
+  // Shards are balanced, hence a caller of the leaf is in another shard.
+  EXPECT_TRUE(
+      first_shard.analyzes(first) != first_shard.analyzes(leaf) ||
+      first_shard.analyzes(second) != first_shard.analyzes(leaf));
+  const auto& leaf_shard =
+      first_shard.analyzes(leaf) ? first_shard : second_shard;
+  const auto& other_shard =
+      first_shard.analyzes(leaf) ? second_shard : first_shard;
+
+  const auto* source_kind = context.kind_factory->get("TestSource");
+  auto registry = Registry(context);
+  for (const auto* method : {leaf, first, second}) {
+    auto model = Model(method, context);
+    model.add_generation(
+        AccessPath(Root(Root::Kind::Return)),
+        test::make_leaf_taint_config(source_kind));
+    registry.set(model);
+  }
+
+  EXPECT_TRUE(leaf_shard.store(context, registry));
+  EXPECT_FALSE(leaf_shard.store(context, registry));
+  EXPECT_TRUE(other_shard.store(context, registry));
+
+  {
+    auto shard_registry = Registry(context);
+    EXPECT_EQ(other_shard.load_boundaries(context, shard_registry), 1);
+    EXPECT_EQ(shard_registry.get(leaf), registry.get(leaf));
+  }
+
+  {
+    auto merged_registry = Registry(context);
+    merger.merge(context, merged_registry);
+    for (const auto* method : {leaf, first, second}) {
+      EXPECT_EQ(merged_registry.get(method), registry.get(method));
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+}
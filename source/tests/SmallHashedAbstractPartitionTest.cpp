@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gmock/gmock.h>
+
+#include <sparta/PatriciaTreeSetAbstractDomain.h>
+
+#include <mariana-trench/SmallHashedAbstractPartition.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class SmallHashedAbstractPartitionTest : public test::Test {};
+
+using IntSet = sparta::PatriciaTreeSetAbstractDomain<unsigned>;
+using IntToIntSetPartition = SmallHashedAbstractPartition<unsigned, IntSet>;
+
+namespace {
+
+IntToIntSetPartition make_partition(
+    std::initializer_list<std::pair<unsigned, IntSet>> bindings) {
+  auto partition = IntToIntSetPartition::bottom();
+  for (const auto& binding : bindings) {
+    partition.update(binding.first, [&binding](IntSet* domain) {
+      domain->join_with(binding.second);
+    });
+  }
+  return partition;
+}
+
+} // namespace
+
+TEST_F(SmallHashedAbstractPartitionTest, Update) {
+  auto partition = IntToIntSetPartition();
+  EXPECT_TRUE(partition.is_bottom());
+  EXPECT_EQ(partition.size(), 0);
+
+  partition.update(1, [](IntSet* set) { set->join_with(IntSet{1}); });
+  EXPECT_FALSE(partition.is_bottom());
+  EXPECT_EQ(partition.size(), 1);
+  EXPECT_EQ(partition.get(1), IntSet{1});
+  EXPECT_TRUE(partition.get(2).is_bottom());
+
+  partition.update(2, [](IntSet* set) { set->join_with(IntSet{2}); });
+  EXPECT_EQ(partition.size(), 2);
+  EXPECT_EQ(partition.get(1), IntSet{1});
+  EXPECT_EQ(partition.get(2), IntSet{2});
+
+  partition.update(1, [](IntSet* set) { set->set_to_bottom(); });
+  EXPECT_EQ(partition.size(), 1);
+  EXPECT_TRUE(partition.get(1).is_bottom());
+  EXPECT_EQ(partition.get(2), IntSet{2});
+
+  partition.update(2, [](IntSet* set) { set->set_to_bottom(); });
+  EXPECT_TRUE(partition.is_bottom());
+}
+
+TEST_F(SmallHashedAbstractPartitionTest, LessOrEqual) {
+  EXPECT_TRUE(IntToIntSetPartition::bottom().leq(IntToIntSetPartition()));
+  EXPECT_TRUE(IntToIntSetPartition().leq(make_partition({{1, IntSet{1}}})));
+  EXPECT_FALSE(make_partition({{1, IntSet{1}}}).leq(IntToIntSetPartition()));
+
+  EXPECT_TRUE(make_partition({{1, IntSet{1}}})
+                  .leq(make_partition({{1, IntSet{1, 2}}})));
+  EXPECT_FALSE(make_partition({{1, IntSet{1}}})
+                   .leq(make_partition({{2, IntSet{1}}})));
+  EXPECT_TRUE(make_partition({{1, IntSet{1}}})
+                  .leq(make_partition({{1, IntSet{1}}, {2, IntSet{2}}})));
+  EXPECT_FALSE(make_partition({{1, IntSet{1}}, {2, IntSet{2}}})
+                   .leq(make_partition({{1, IntSet{1}}})));
+  EXPECT_TRUE(make_partition({{1, IntSet{1}}, {2, IntSet{2}}})
+                  .leq(make_partition({{1, IntSet{1}}, {2, IntSet{2, 3}}})));
+}
+
+TEST_F(SmallHashedAbstractPartitionTest, Equals) {
+  EXPECT_TRUE(IntToIntSetPartition().equals(IntToIntSetPartition::bottom()));
+  EXPECT_TRUE(make_partition({{1, IntSet{1}}})
+                  .equals(make_partition({{1, IntSet{1}}})));
+  EXPECT_FALSE(make_partition({{1, IntSet{1}}})
+                   .equals(make_partition({{2, IntSet{1}}})));
+  EXPECT_FALSE(make_partition({{1, IntSet{1}}})
+                   .equals(make_partition({{1, IntSet{1}}, {2, IntSet{2}}})));
+  EXPECT_TRUE(make_partition({{1, IntSet{1}}, {2, IntSet{2}}})
+                  .equals(make_partition({{2, IntSet{2}}, {1, IntSet{1}}})));
+}
+
+TEST_F(SmallHashedAbstractPartitionTest, JoinWith) {
+  auto partition = IntToIntSetPartition();
+  partition.join_with(make_partition({{1, IntSet{1}}}));
+  EXPECT_EQ(partition.size(), 1);
+  EXPECT_EQ(partition.get(1), IntSet{1});
+
+  partition.join_with(make_partition({{1, IntSet{2}}}));
+  EXPECT_EQ(partition.size(), 1);
+  EXPECT_EQ(partition.get(1), (IntSet{1, 2}));
+
+  partition.join_with(make_partition({{2, IntSet{3}}}));
+  EXPECT_EQ(partition.size(), 2);
+  EXPECT_EQ(partition.get(1), (IntSet{1, 2}));
+  EXPECT_EQ(partition.get(2), IntSet{3});
+
+  partition.join_with(make_partition({{2, IntSet{4}}, {3, IntSet{5}}}));
+  EXPECT_EQ(partition.size(), 3);
+  EXPECT_EQ(partition.get(2), (IntSet{3, 4}));
+  EXPECT_EQ(partition.get(3), IntSet{5});
+}
+
+TEST_F(SmallHashedAbstractPartitionTest, Transform) {
+  auto partition = make_partition({{1, IntSet{1}}, {2, IntSet{2}}});
+  partition.transform([](IntSet* set) {
+    if (set->contains(1)) {
+      set->set_to_bottom();
+    }
+  });
+  EXPECT_TRUE(partition.equals(make_partition({{2, IntSet{2}}})));
+
+  std::vector<unsigned> labels;
+  partition.visit([&labels](unsigned label, const IntSet& /* set */) {
+    labels.push_back(label);
+  });
+  EXPECT_EQ(labels, std::vector<unsigned>{2});
+}
+
+TEST_F(SmallHashedAbstractPartitionTest, DifferenceLikeOperation) {
+  auto difference = [](IntSet* left, const IntSet& right) {
+    if (left->leq(right)) {
+      left->set_to_bottom();
+    }
+  };
+
+  auto partition = make_partition({{1, IntSet{1}}, {2, IntSet{2}}});
+  partition.difference_like_operation(
+      make_partition({{1, IntSet{1, 2}}}), difference);
+  EXPECT_TRUE(partition.equals(make_partition({{2, IntSet{2}}})));
+
+  partition.difference_like_operation(
+      make_partition({{2, IntSet{3}}}), difference);
+  EXPECT_TRUE(partition.equals(make_partition({{2, IntSet{2}}})));
+
+  partition.difference_like_operation(
+      make_partition({{2, IntSet{2}}, {3, IntSet{3}}}), difference);
+  EXPECT_TRUE(partition.is_bottom());
+}
+
+} // namespace marianatrench
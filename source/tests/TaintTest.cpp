@@ -3188,6 +3188,13 @@ TEST_F(TaintTest, PartitionByKind) {
                   .callee = method_two2,
                   .call_kind = CallKind::callsite(),
               })}));
+
+  // Only the kinds satisfying the predicate are kept.
+  const auto* source_three = context.kind_factory->get("TestSource3");
+  auto taint_by_kept_kind = taint.partition_by_kind_if(
+      [source_three](const Kind* kind) { return kind == source_three; });
+  EXPECT_EQ(taint_by_kept_kind.size(), 1);
+  EXPECT_EQ(taint_by_kept_kind[source_three], taint_by_kind[source_three]);
 }
 
 TEST_F(TaintTest, PartitionByKindGeneric) {
@@ -69,8 +69,13 @@ Context make_context(const DexStore& store) {
   context.types = std::make_unique<Types>(*context.options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
   context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
   MethodMappings method_mappings{*context.methods};
   auto intent_routing_analyzer = IntentRoutingAnalyzer::run(context);
   auto shims =
@@ -105,6 +110,52 @@ Context make_context(const DexStore& store) {
   return context;
 }
 
+Context make_call_graph_context(const Scope& scope) {
+  Context context;
+  context.options = make_default_options();
+  DexStore store("test_store");
+  store.add_classes(scope);
+  context.stores = {store};
+  context.artificial_methods = std::make_unique<ArtificialMethods>(
+      *context.kind_factory, context.stores);
+  context.methods = std::make_unique<Methods>(context.stores);
+  MethodMappings method_mappings{*context.methods};
+  auto intent_routing_analyzer = IntentRoutingAnalyzer::run(context);
+  context.control_flow_graphs =
+      std::make_unique<ControlFlowGraphs>(context.stores);
+  context.types = std::make_unique<Types>(*context.options, context.stores);
+  context.class_hierarchies =
+      std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
+  context.overrides = std::make_unique<Overrides>(
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
+  context.fields = std::make_unique<Fields>();
+  context.call_graph = std::make_unique<CallGraph>(
+      *context.options,
+      *context.types,
+      *context.class_hierarchies,
+      LifecycleMethods{},
+      Shims{/* global_shims_size */ 0, intent_routing_analyzer},
+      *context.feature_factory,
+      *context.methods,
+      *context.fields,
+      *context.overrides,
+      method_mappings);
+  context.rules = std::make_unique<Rules>(context);
+  auto registry = Registry(context);
+  context.dependencies = std::make_unique<Dependencies>(
+      *context.options,
+      *context.methods,
+      *context.overrides,
+      *context.call_graph,
+      registry);
+  return context;
+}
+
 std::unique_ptr<Options> make_default_options() {
   return std::make_unique<Options>(
       /* models_paths */ std::vector<std::string>{},
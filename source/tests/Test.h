@@ -61,6 +61,12 @@ class ContextGuard {
 Context make_empty_context();
 Context make_context(const DexStore& store);
 
+/**
+ * Context with the call graph and the dependencies of the given scope, without
+ * shims nor models.
+ */
+Context make_call_graph_context(const Scope& scope);
+
 std::unique_ptr<Options> make_default_options();
 
 struct FrameProperties {
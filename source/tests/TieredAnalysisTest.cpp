@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/TieredAnalysis.h>
+#include <mariana-trench/tests/Test.h>
+
+using namespace marianatrench;
+
+class TieredAnalysisTest : public test::Test {};
+
+TEST_F(TieredAnalysisTest, SkipIrrelevantMethods) {
+  Scope scope;
+  auto* dex_source = redex::create_void_method(
+      scope,
+      "LSource;",
+      "source",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LSource;.source:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  auto* dex_unrelated = redex::create_method(scope, "LUnrelated;", R"(
+    (method (public static) "LUnrelated;.unrelated:(Ljava/lang/Object;)Ljava/lang/Object;"
+     (
+      (load-param-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* source = context.methods->get(dex_source);
+  const auto* caller = context.methods->get(dex_caller);
+  const auto* unrelated = context.methods->get(dex_unrelated);
+
+  auto registry = Registry(context);
+  auto source_model = Model(source, context);
+  source_model.add_generation(
+      AccessPath(Root(Root::Kind::Return)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSource")));
+  registry.set(source_model);
+
+  auto relevant_methods = TieredAnalysis::relevant_methods(context, registry);
+  EXPECT_EQ(relevant_methods.count(source), 1);
+  EXPECT_EQ(relevant_methods.count(caller), 1);
+  EXPECT_EQ(relevant_methods.count(unrelated), 0);
+
+  EXPECT_EQ(TieredAnalysis::skip_irrelevant_methods(context, registry), 1);
+  EXPECT_FALSE(registry.get(caller).skip_analysis());
+  auto unrelated_model = registry.get(unrelated);
+  EXPECT_TRUE(unrelated_model.skip_analysis());
+  EXPECT_FALSE(unrelated_model.propagations().is_bottom());
+}
+
+TEST_F(TieredAnalysisTest, SkipMethodsOutsideSlice) {
+  Scope scope;
+  auto* dex_source = redex::create_void_method(
+      scope,
+      "LSource;",
+      "source",
+      /* parameter_types */ "",
+      /* return_type */ "Ljava/lang/Object;",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_sink = redex::create_void_method(
+      scope,
+      "LSink;",
+      "sink",
+      /* parameter_types */ "Ljava/lang/Object;",
+      /* return_type */ "V",
+      /* super */ nullptr,
+      /* is_static */ true);
+  auto* dex_caller = redex::create_method(scope, "LCaller;", R"(
+    (method (public static) "LCaller;.caller:()V"
+     (
+      (invoke-static () "LSource;.source:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (invoke-static (v0) "LSink;.sink:(Ljava/lang/Object;)V")
+      (return-void)
+     )
+    )
+  )");
+  auto* dex_only_source = redex::create_method(scope, "LOnlySource;", R"(
+    (method (public static) "LOnlySource;.only_source:()Ljava/lang/Object;"
+     (
+      (invoke-static () "LSource;.source:()Ljava/lang/Object;")
+      (move-result-object v0)
+      (return-object v0)
+     )
+    )
+  )");
+  DexStore store("test_store");
+  store.add_classes(scope);
+  auto context = test::make_context(store);
+  const auto* source = context.methods->get(dex_source);
+  const auto* sink = context.methods->get(dex_sink);
+  const auto* caller = context.methods->get(dex_caller);
+  const auto* only_source = context.methods->get(dex_only_source);
+
+  auto registry = Registry(context);
+  auto source_model = Model(source, context);
+  source_model.add_generation(
+      AccessPath(Root(Root::Kind::Return)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSource")));
+  registry.set(source_model);
+  auto sink_model = Model(sink, context);
+  sink_model.add_sink(
+      AccessPath(Root(Root::Kind::Argument, 0)),
+      test::make_leaf_taint_config(context.kind_factory->get("TestSink")));
+  registry.set(sink_model);
+
+  // `only_source` holds taint, but does not lead to a sink.
+  auto sliced_methods = TieredAnalysis::sliced_methods(context, registry);
+  EXPECT_EQ(sliced_methods.count(caller), 1);
+  EXPECT_EQ(sliced_methods.count(source), 1);
+  EXPECT_EQ(sliced_methods.count(sink), 1);
+  EXPECT_EQ(sliced_methods.count(only_source), 0);
+  EXPECT_EQ(TieredAnalysis::relevant_methods(context, registry).count(
+                only_source),
+            1);
+
+  TieredAnalysis::skip_methods_outside_slice(context, registry);
+  EXPECT_FALSE(registry.get(caller).skip_analysis());
+  EXPECT_TRUE(registry.get(only_source).skip_analysis());
+}
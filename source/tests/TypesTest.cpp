@@ -231,6 +231,55 @@ TEST_F(TypesTest, LocalInvokeVirtualTypes) {
   EXPECT_TRUE(missing_invoke_register_types[1] == nullptr);
 }
 
+TEST_F(TypesTest, LimitCachedEnvironments) {
+  Scope scope;
+
+  redex::create_void_method(scope, "LCallee;", "callee");
+  auto* dex_first_caller = redex::create_method(
+      scope,
+      "LFirstCaller;",
+      R"(
+          (method (public) "LFirstCaller;.caller:()V"
+            (
+              (new-instance "LCallee;")
+              (move-result-object v0)
+              (invoke-direct (v0) "LCallee;.callee:()V")
+              (return-void)
+            )
+          )
+      )");
+  auto* dex_second_caller = redex::create_method(
+      scope,
+      "LSecondCaller;",
+      R"(
+          (method (public) "LSecondCaller;.caller:(LCallee;)V"
+            (
+              (load-param-object v0)
+              (load-param-object v1)
+              (invoke-direct (v1) "LCallee;.callee:()V")
+              (return-void)
+            )
+          )
+      )");
+
+  auto context = test_types(scope);
+  auto* first_caller = context.methods->get(dex_first_caller);
+  auto* second_caller = context.methods->get(dex_second_caller);
+  auto* callee_type = DexType::make_type(DexString::make_string("LCallee;"));
+
+  EXPECT_EQ(
+      register_types_for_method(context, first_caller).at(0), callee_type);
+
+  // Types are inferred again once evicted.
+  context.types->limit_cached_environments(/* maximum_methods */ 1);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(
+        register_types_for_method(context, first_caller).at(0), callee_type);
+    EXPECT_EQ(
+        register_types_for_method(context, second_caller).at(1), callee_type);
+  }
+}
+
 TEST_F(TypesTest, GlobalInvokeVirtualTypes) {
   Scope scope;
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/UniquePointerFactory.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class UniquePointerFactoryTest : public test::Test {};
+
+namespace {
+
+struct Value {
+  explicit Value(const std::string& name) : name(name) {}
+
+  std::string name;
+};
+
+} // namespace
+
+TEST_F(UniquePointerFactoryTest, CreateAcrossThreads) {
+  UniquePointerFactory<std::string, Value> factory(
+      CacheStatistics::Cache::Kinds);
+  EXPECT_EQ(factory.get("a"), nullptr);
+
+  std::vector<std::vector<const Value*>> results(4);
+  std::vector<std::thread> threads;
+  for (std::size_t thread = 0; thread < results.size(); thread++) {
+    threads.emplace_back([&factory, &results, thread]() {
+      for (int index = 0; index < 100; index++) {
+        results[thread].push_back(factory.create(std::to_string(index % 10)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Hits and insertions return the same pointer for a given key.
+  EXPECT_EQ(factory.size(), 10);
+  for (const auto& thread_results : results) {
+    EXPECT_EQ(thread_results, results.front());
+  }
+  const auto* value = factory.get("3");
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(value->name, "3");
+  EXPECT_EQ(factory.create("3"), value);
+  EXPECT_EQ(factory.create("3", std::string("other")), value);
+}
+
+} // namespace marianatrench
@@ -12,6 +12,7 @@
 #include <mariana-trench/SourceSinkRule.h>
 #include <mariana-trench/TransformList.h>
 #include <mariana-trench/TransformsFactory.h>
+#include <mariana-trench/UsedKinds.h>
 #include <mariana-trench/tests/Test.h>
 
 namespace marianatrench {
@@ -135,4 +136,38 @@ TEST_F(UsedKindsTest, UsedTransformKinds) {
           "4"));
 }
 
+TEST_F(UsedKindsTest, TransformKind) {
+  auto context = test::make_empty_context();
+  const auto* source_a = context.kind_factory->get("A");
+  const auto* sink_x = context.kind_factory->get("X");
+  const auto* t1 = context.transforms_factory->create({"1"}, context);
+  const auto* t2 = context.transforms_factory->create({"2"}, context);
+
+  std::vector<std::unique_ptr<Rule>> rule_list;
+  rule_list.push_back(std::make_unique<SourceSinkRule>(
+      /* name */ "Rule1",
+      /* code */ 1,
+      /* description */ "Test rule 1",
+      /* source_kinds */ Rule::KindSet{source_a},
+      /* sink_kinds */ Rule::KindSet{sink_x},
+      /* transforms */ t1));
+
+  auto rules = Rules(context, std::move(rule_list));
+  auto used_kinds = UsedKinds::from_rules(rules, *context.transforms_factory);
+
+  const auto* transformed_kind =
+      used_kinds.transform_kind(*context.kind_factory, source_a, t1);
+  EXPECT_EQ(
+      transformed_kind,
+      context.kind_factory->transform_kind(
+          source_a,
+          /* local_transforms */ t1,
+          /* global_transforms */ nullptr));
+  EXPECT_EQ(
+      used_kinds.transform_kind(*context.kind_factory, source_a, t1),
+      transformed_kind);
+  EXPECT_EQ(
+      used_kinds.transform_kind(*context.kind_factory, source_a, t2), nullptr);
+}
+
 } // namespace marianatrench
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mariana-trench/OperatingSystem.h>
+#include <mariana-trench/WorkerPlacement.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class WorkerPlacementTest : public test::Test {};
+
+TEST_F(WorkerPlacementTest, ContiguousBlocks) {
+  auto placement =
+      WorkerPlacement({{0, 1, 2, 3}, {4, 5, 6, 7}}, /* threads */ 5);
+  EXPECT_EQ(placement.nodes(), 2);
+  EXPECT_EQ(placement.node_of_worker(0), 0);
+  EXPECT_EQ(placement.node_of_worker(2), 0);
+  EXPECT_EQ(placement.node_of_worker(3), 1);
+  EXPECT_EQ(placement.node_of_worker(4), 1);
+
+  EXPECT_EQ(placement.next_worker(0), 0);
+  EXPECT_EQ(placement.next_worker(0), 1);
+  EXPECT_EQ(placement.next_worker(0), 2);
+  EXPECT_EQ(placement.next_worker(0), 0);
+  EXPECT_EQ(placement.next_worker(1), 3);
+  EXPECT_EQ(placement.next_worker(1), 4);
+  EXPECT_EQ(placement.next_worker(1), 3);
+}
+
+TEST_F(WorkerPlacementTest, MoreNodesThanThreads) {
+  auto placement = WorkerPlacement({{0}, {1}, {2}}, /* threads */ 2);
+  EXPECT_EQ(placement.nodes(), 2);
+  EXPECT_EQ(placement.node_of_worker(1), 1);
+
+  auto single_node = WorkerPlacement({}, /* threads */ 4);
+  EXPECT_EQ(single_node.nodes(), 1);
+  EXPECT_EQ(single_node.node_of_worker(3), 0);
+  EXPECT_EQ(single_node.next_worker(0), 0);
+  EXPECT_EQ(single_node.next_worker(0), 1);
+  // Nodes without CPUs are never pinned.
+  single_node.pin(/* worker_id */ 0);
+}
+
+TEST_F(WorkerPlacementTest, RestoresAffinity) {
+  auto original_cpus = current_thread_cpus();
+  if (original_cpus.empty()) {
+    GTEST_SKIP() << "Thread affinity is not supported.";
+  }
+
+  {
+    auto placement = WorkerPlacement({{original_cpus[0]}}, /* threads */ 1);
+    placement.pin(/* worker_id */ 0);
+    EXPECT_EQ(current_thread_cpus(), std::vector<int>{original_cpus[0]});
+
+    // Moving the placement keeps the pinned threads.
+    auto moved_placement = std::move(placement);
+    EXPECT_EQ(current_thread_cpus(), std::vector<int>{original_cpus[0]});
+  }
+  EXPECT_EQ(current_thread_cpus(), original_cpus);
+
+  // A new placement pins the thread again.
+  {
+    auto placement = WorkerPlacement({{original_cpus[0]}}, /* threads */ 1);
+    placement.pin(/* worker_id */ 0);
+    EXPECT_EQ(current_thread_cpus(), std::vector<int>{original_cpus[0]});
+  }
+  EXPECT_EQ(current_thread_cpus(), original_cpus);
+}
+
+} // namespace marianatrench
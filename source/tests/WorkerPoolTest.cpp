@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+#include <gmock/gmock.h>
+
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/tests/Test.h>
+
+namespace marianatrench {
+
+class WorkerPoolTest : public test::Test {};
+
+TEST_F(WorkerPoolTest, PushedAndNestedItems) {
+  std::atomic<std::size_t> sum(0);
+  std::atomic<std::size_t> nested(0);
+  auto queue = work_queue<std::size_t>(
+      [&](WorkerState<std::size_t>* worker_state, std::size_t item) {
+        EXPECT_LT(worker_state->worker_id(), 4);
+        sum += item;
+        if (item > 1) {
+          worker_state->push_task(item / 2);
+        }
+        if (item == 100) {
+          auto nested_queue = work_queue<std::size_t>(
+              [&](std::size_t nested_item) { nested += nested_item; },
+              /* num_threads */ 4);
+          for (std::size_t i = 0; i < 10; i++) {
+            nested_queue.add_item(1);
+          }
+          nested_queue.run_all();
+        }
+      },
+      /* num_threads */ 4,
+      /* push_tasks_while_running */ true);
+
+  std::size_t expected_sum = 0;
+  for (std::size_t i = 0; i <= 100; i++) {
+    queue.add_item(i);
+    for (auto item = i; item > 0; item /= 2) {
+      expected_sum += item;
+    }
+  }
+  queue.run_all();
+  EXPECT_EQ(sum, expected_sum);
+  EXPECT_EQ(nested, 10);
+
+  // Threads are reused by the next queues.
+  std::atomic<std::size_t> count(0);
+  for (std::size_t run = 0; run < 10; run++) {
+    auto reused_queue = work_queue<std::size_t>(
+        [&](std::size_t /* item */) { count++; }, /* num_threads */ 4);
+    for (std::size_t i = 0; i < 100; i++) {
+      reused_queue.add_item(i);
+    }
+    reused_queue.run_all();
+  }
+  EXPECT_EQ(count, 1000);
+}
+
+TEST_F(WorkerPoolTest, NestedQueueThreads) {
+  std::mutex mutex;
+  std::condition_variable started;
+  std::size_t outer_items = 0;
+  std::unordered_set<std::thread::id> threads;
+
+  auto queue = work_queue<int>(
+      [&](int item) {
+        // Wait for all the workers of the outer queue to run an item, then
+        // only the first item continues and the other workers are idle.
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          outer_items++;
+          started.notify_all();
+          started.wait_for(lock, std::chrono::seconds(10), [&]() {
+            return outer_items == 4;
+          });
+        }
+        if (item != 0) {
+          return;
+        }
+
+        auto nested_queue = work_queue<int>(
+            [&](int /* nested_item */) {
+              // Each item waits for another thread to run an item.
+              std::unique_lock<std::mutex> lock(mutex);
+              threads.insert(std::this_thread::get_id());
+              started.notify_all();
+              started.wait_for(lock, std::chrono::seconds(10), [&]() {
+                return threads.size() > 1;
+              });
+            },
+            /* num_threads */ 4);
+        for (int i = 0; i < 4; i++) {
+          nested_queue.add_item(i);
+        }
+        nested_queue.run_all();
+      },
+      /* num_threads */ 4);
+  for (int i = 0; i < 4; i++) {
+    queue.add_item(i);
+  }
+  queue.run_all();
+  EXPECT_EQ(outer_items, 4);
+  EXPECT_GT(threads.size(), 1);
+}
+
+TEST_F(WorkerPoolTest, ItemsOfWorkers) {
+  std::atomic<std::size_t> sum(0);
+  auto queue = work_queue<std::size_t>(
+      [&](std::size_t item) { sum += item; }, /* num_threads */ 2);
+  for (std::size_t i = 0; i < 100; i++) {
+    // Worker ids wrap around the number of workers.
+    queue.add_item(i, /* worker_id */ i % 5);
+  }
+  queue.run_all();
+  EXPECT_EQ(sum, 4950);
+}
+
+TEST_F(WorkerPoolTest, Exception) {
+  auto queue = work_queue<int>(
+      [](int item) {
+        if (item == 1) {
+          throw std::runtime_error("error");
+        }
+      },
+      /* num_threads */ 2);
+  queue.add_item(0);
+  queue.add_item(1);
+  EXPECT_THROW(queue.run_all(), std::runtime_error);
+}
+
+} // namespace marianatrench
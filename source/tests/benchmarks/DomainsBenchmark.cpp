@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include <mariana-trench/KindFrames.h>
+#include <mariana-trench/LocalTaint.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Taint.h>
+#include <mariana-trench/TaintTree.h>
+#include <mariana-trench/tests/Test.h>
+
+/**
+ * Benchmarks of the core abstract domains.
+ *
+ * The size argument of each benchmark is the number of frames of the taint
+ * being operated on (or the width of the tree, for tree benchmarks). Operands
+ * are built once, outside of the timed loop. Operations that modify their
+ * operand work on a copy, which is cheap since the underlying patricia trees
+ * share their nodes.
+ */
+
+namespace marianatrench {
+
+namespace {
+
+constexpr std::size_t k_number_of_methods = 64;
+constexpr std::size_t k_number_of_kinds = 16;
+constexpr std::size_t k_number_of_features = 16;
+constexpr std::size_t k_tree_depth = 3;
+constexpr std::size_t k_frames_per_tree_node = 4;
+
+/* Values shared by the operands of a benchmark. */
+class Environment final {
+ public:
+  Environment() : context(test::make_empty_context()) {
+    for (std::size_t index = 0; index < k_number_of_methods; index++) {
+      methods.push_back(context.methods->create(redex::create_void_method(
+          scope,
+          fmt::format("LBenchmark{};", index),
+          fmt::format("method{}", index))));
+    }
+    for (std::size_t index = 0; index < k_number_of_kinds; index++) {
+      kinds.push_back(context.kind_factory->get(fmt::format("Kind{}", index)));
+    }
+    for (std::size_t index = 0; index < k_number_of_features; index++) {
+      features.push_back(
+          context.feature_factory->get(fmt::format("via-feature-{}", index)));
+    }
+    leaf =
+        context.access_path_factory->get(AccessPath(Root(Root::Kind::Leaf)));
+    broadening_features = FeatureMayAlwaysSet{
+        context.feature_factory->get("via-broadening")};
+  }
+
+  /**
+   * Build a taint with `size` frames, spread over kinds, callees, ports and
+   * positions. Taint built with different `seed`s overlap partially.
+   */
+  Taint make_taint(std::size_t size, std::size_t seed = 0) {
+    Taint taint;
+    for (std::size_t index = 0; index < size; index++) {
+      auto key = index + seed;
+      const auto* kind = kinds[key % k_number_of_kinds];
+      if (key % 8 == 0) {
+        taint.add(test::make_leaf_taint_config(kind));
+        continue;
+      }
+      const auto* callee = methods[key % k_number_of_methods];
+      taint.add(test::make_taint_config(
+          kind,
+          test::FrameProperties{
+              .callee_port = AccessPath(Root(
+                  Root::Kind::Argument,
+                  static_cast<ParameterPosition>(index % 4))),
+              .callee = callee,
+              .call_position =
+                  context.positions->get("Benchmark.java", index % 16),
+              .distance = static_cast<int>(key % 5) + 1,
+              .origins = OriginSet{context.origin_factory->method_origin(
+                  methods[(key * 7) % k_number_of_methods], leaf)},
+              .inferred_features =
+                  FeatureMayAlwaysSet{features[key % k_number_of_features]},
+              .call_kind = CallKind::callsite(),
+          }));
+    }
+    return taint;
+  }
+
+  /* Build a local taint of a single callee with `size` frames. */
+  LocalTaint make_local_taint(std::size_t size, std::size_t seed = 0) {
+    LocalTaint local_taint;
+    for (std::size_t index = 0; index < size; index++) {
+      auto key = index + seed;
+      local_taint.add(test::make_taint_config(
+          kinds[key % k_number_of_kinds],
+          test::FrameProperties{
+              .callee_port = AccessPath(Root(Root::Kind::Return)),
+              .callee = methods[0],
+              .call_position = context.positions->get("Benchmark.java", 1),
+              .distance = static_cast<int>(key % 5) + 1,
+              .origins = OriginSet{context.origin_factory->method_origin(
+                  methods[key % k_number_of_methods], leaf)},
+              .inferred_features =
+                  FeatureMayAlwaysSet{features[key % k_number_of_features]},
+              .call_kind = CallKind::callsite(),
+          }));
+    }
+    return local_taint;
+  }
+
+  /* Build the frames of a single kind with `size` distinct origins. */
+  KindFrames make_kind_frames(std::size_t size, std::size_t seed = 0) {
+    KindFrames frames;
+    for (std::size_t index = 0; index < size; index++) {
+      auto key = index + seed;
+      frames.add(test::make_taint_config(
+          kinds[0],
+          test::FrameProperties{
+              .distance = static_cast<int>(key % 5),
+              .origins = OriginSet{context.origin_factory->method_origin(
+                  methods[key % k_number_of_methods], leaf)},
+              .inferred_features =
+                  FeatureMayAlwaysSet{features[key % k_number_of_features]},
+              .call_kind = CallKind::origin(),
+          }));
+    }
+    return frames;
+  }
+
+  /* Build a frame with `size` origins and features. */
+  Frame make_frame(std::size_t size, std::size_t seed = 0) {
+    OriginSet origins;
+    FeatureMayAlwaysSet inferred_features;
+    for (std::size_t index = 0; index < size; index++) {
+      auto key = index + seed;
+      origins.add(context.origin_factory->method_origin(
+          methods[key % k_number_of_methods], leaf));
+      inferred_features.add_may(features[key % k_number_of_features]);
+    }
+    return test::make_taint_frame(
+        kinds[0],
+        test::FrameProperties{
+            .origins = origins,
+            .inferred_features = inferred_features,
+            .call_kind = CallKind::origin(),
+        });
+  }
+
+  /**
+   * Build a complete tree of the given width and depth `k_tree_depth`, with
+   * taint on every node.
+   */
+  TaintTree make_taint_tree(std::size_t width, std::size_t seed = 0) {
+    TaintTree tree;
+    std::size_t node = 0;
+    write_subtree(tree, Path{}, width, k_tree_depth, seed, node);
+    return tree;
+  }
+
+  TaintAccessPathTree make_taint_access_path_tree(
+      std::size_t width,
+      std::size_t seed = 0) {
+    TaintAccessPathTree tree;
+    for (ParameterPosition position = 0; position < 4; position++) {
+      tree.write(
+          AccessPath(Root(Root::Kind::Argument, position)),
+          make_taint_tree(width, seed + position),
+          UpdateKind::Weak);
+    }
+    return tree;
+  }
+
+ private:
+  void write_subtree(
+      TaintTree& tree,
+      const Path& path,
+      std::size_t width,
+      std::size_t depth,
+      std::size_t seed,
+      std::size_t& node) {
+    tree.write(
+        path,
+        make_taint(k_frames_per_tree_node, seed + node++),
+        UpdateKind::Weak);
+    if (depth == 0) {
+      return;
+    }
+    for (std::size_t index = 0; index < width; index++) {
+      auto child = path;
+      child.append(PathElement::field(fmt::format("field{}", index)));
+      write_subtree(tree, child, width, depth - 1, seed, node);
+    }
+  }
+
+ private:
+  // Must outlive everything below.
+  test::ContextGuard guard_;
+
+ public:
+  Context context;
+  Scope scope;
+  std::vector<const Method*> methods;
+  std::vector<const Kind*> kinds;
+  std::vector<const Feature*> features;
+  const AccessPath* leaf;
+  FeatureMayAlwaysSet broadening_features;
+};
+
+template <typename Domain>
+void benchmark_join(benchmark::State& state, Domain left, const Domain& right) {
+  for (auto _ : state) {
+    auto result = left;
+    result.join_with(right);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+template <typename Domain>
+void benchmark_widen(
+    benchmark::State& state,
+    Domain left,
+    const Domain& right) {
+  for (auto _ : state) {
+    auto result = left;
+    result.widen_with(right);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+template <typename Domain>
+void benchmark_leq(benchmark::State& state, Domain left, const Domain& right) {
+  // Compare against the join, so that the full structure is traversed.
+  auto joined = left;
+  joined.join_with(right);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(left.leq(joined));
+  }
+}
+
+} // namespace
+
+/* Frame */
+
+static void FrameJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state, env.make_frame(state.range(0)), env.make_frame(state.range(0), 3));
+}
+BENCHMARK(FrameJoin)->RangeMultiplier(4)->Range(1, 64);
+
+static void FrameLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state, env.make_frame(state.range(0)), env.make_frame(state.range(0), 3));
+}
+BENCHMARK(FrameLeq)->RangeMultiplier(4)->Range(1, 64);
+
+/* KindFrames */
+
+static void KindFramesJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state,
+      env.make_kind_frames(state.range(0)),
+      env.make_kind_frames(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(KindFramesJoin)->RangeMultiplier(4)->Range(4, 256);
+
+static void KindFramesLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state,
+      env.make_kind_frames(state.range(0)),
+      env.make_kind_frames(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(KindFramesLeq)->RangeMultiplier(4)->Range(4, 256);
+
+static void KindFramesWiden(benchmark::State& state) {
+  Environment env;
+  benchmark_widen(
+      state,
+      env.make_kind_frames(state.range(0)),
+      env.make_kind_frames(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(KindFramesWiden)->RangeMultiplier(4)->Range(4, 256);
+
+/* LocalTaint */
+
+static void LocalTaintJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state,
+      env.make_local_taint(state.range(0)),
+      env.make_local_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(LocalTaintJoin)->RangeMultiplier(4)->Range(4, 256);
+
+static void LocalTaintLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state,
+      env.make_local_taint(state.range(0)),
+      env.make_local_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(LocalTaintLeq)->RangeMultiplier(4)->Range(4, 256);
+
+static void LocalTaintWiden(benchmark::State& state) {
+  Environment env;
+  benchmark_widen(
+      state,
+      env.make_local_taint(state.range(0)),
+      env.make_local_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(LocalTaintWiden)->RangeMultiplier(4)->Range(4, 256);
+
+static void LocalTaintAttachPosition(benchmark::State& state) {
+  Environment env;
+  auto local_taint = env.make_local_taint(state.range(0));
+  const auto* position = env.context.positions->get("Benchmark.java", 42);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(local_taint.attach_position(position));
+  }
+}
+BENCHMARK(LocalTaintAttachPosition)->RangeMultiplier(4)->Range(4, 256);
+
+/* Taint */
+
+static void TaintJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state,
+      env.make_taint(state.range(0)),
+      env.make_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(TaintJoin)->RangeMultiplier(4)->Range(4, 1024);
+
+static void TaintLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state,
+      env.make_taint(state.range(0)),
+      env.make_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(TaintLeq)->RangeMultiplier(4)->Range(4, 1024);
+
+static void TaintWiden(benchmark::State& state) {
+  Environment env;
+  benchmark_widen(
+      state,
+      env.make_taint(state.range(0)),
+      env.make_taint(state.range(0), state.range(0) / 2));
+}
+BENCHMARK(TaintWiden)->RangeMultiplier(4)->Range(4, 1024);
+
+static void TaintPropagate(benchmark::State& state) {
+  Environment env;
+  auto taint = env.make_taint(state.range(0));
+  const auto* callee = env.methods[1];
+  const auto* call_position = env.context.positions->get("Benchmark.java", 42);
+  auto extra_features = FeatureMayAlwaysSet{env.features[0]};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taint.propagate(
+        callee,
+        /* callee_port */ AccessPath(Root(Root::Kind::Argument, 1)),
+        call_position,
+        /* maximum_source_sink_distance */ 100,
+        extra_features,
+        env.context,
+        /* source_register_types */ {},
+        /* source_constant_arguments */ {},
+        CallClassIntervalContext(),
+        ClassIntervals::Interval::top()));
+  }
+}
+BENCHMARK(TaintPropagate)->RangeMultiplier(4)->Range(4, 1024);
+
+static void TaintAttachPosition(benchmark::State& state) {
+  Environment env;
+  auto taint = env.make_taint(state.range(0));
+  const auto* position = env.context.positions->get("Benchmark.java", 42);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taint.attach_position(position));
+  }
+}
+BENCHMARK(TaintAttachPosition)->RangeMultiplier(4)->Range(4, 1024);
+
+/* TaintTree (AbstractTreeDomain) */
+
+static void TaintTreeJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state,
+      env.make_taint_tree(state.range(0)),
+      env.make_taint_tree(state.range(0), 5));
+}
+BENCHMARK(TaintTreeJoin)->DenseRange(1, 7, 2);
+
+static void TaintTreeLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state,
+      env.make_taint_tree(state.range(0)),
+      env.make_taint_tree(state.range(0), 5));
+}
+BENCHMARK(TaintTreeLeq)->DenseRange(1, 7, 2);
+
+static void TaintTreeWiden(benchmark::State& state) {
+  Environment env;
+  benchmark_widen(
+      state,
+      env.make_taint_tree(state.range(0)),
+      env.make_taint_tree(state.range(0), 5));
+}
+BENCHMARK(TaintTreeWiden)->DenseRange(1, 7, 2);
+
+static void TaintTreeCollapseDeeperThan(benchmark::State& state) {
+  Environment env;
+  auto tree = env.make_taint_tree(state.range(0));
+  for (auto _ : state) {
+    auto result = tree;
+    result.collapse_deeper_than(/* height */ 1, env.broadening_features);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(TaintTreeCollapseDeeperThan)->DenseRange(1, 7, 2);
+
+static void TaintTreeLimitLeaves(benchmark::State& state) {
+  Environment env;
+  auto tree = env.make_taint_tree(state.range(0));
+  for (auto _ : state) {
+    auto result = tree;
+    result.limit_leaves(/* max_leaves */ 20, env.broadening_features);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(TaintTreeLimitLeaves)->DenseRange(1, 7, 2);
+
+/* TaintAccessPathTree */
+
+static void TaintAccessPathTreeJoin(benchmark::State& state) {
+  Environment env;
+  benchmark_join(
+      state,
+      env.make_taint_access_path_tree(state.range(0)),
+      env.make_taint_access_path_tree(state.range(0), 5));
+}
+BENCHMARK(TaintAccessPathTreeJoin)->DenseRange(1, 7, 2);
+
+static void TaintAccessPathTreeLeq(benchmark::State& state) {
+  Environment env;
+  benchmark_leq(
+      state,
+      env.make_taint_access_path_tree(state.range(0)),
+      env.make_taint_access_path_tree(state.range(0), 5));
+}
+BENCHMARK(TaintAccessPathTreeLeq)->DenseRange(1, 7, 2);
+
+static void TaintAccessPathTreeWiden(benchmark::State& state) {
+  Environment env;
+  benchmark_widen(
+      state,
+      env.make_taint_access_path_tree(state.range(0)),
+      env.make_taint_access_path_tree(state.range(0), 5));
+}
+BENCHMARK(TaintAccessPathTreeWiden)->DenseRange(1, 7, 2);
+
+static void TaintAccessPathTreeLimitLeaves(benchmark::State& state) {
+  Environment env;
+  auto tree = env.make_taint_access_path_tree(state.range(0));
+  for (auto _ : state) {
+    auto result = tree;
+    result.limit_leaves(/* max_leaves */ 20, env.broadening_features);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(TaintAccessPathTreeLimitLeaves)->DenseRange(1, 7, 2);
+
+} // namespace marianatrench
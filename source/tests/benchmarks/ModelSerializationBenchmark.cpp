@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <json/json.h>
+
+#include <DexClass.h>
+#include <IRCode.h>
+
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/JsonWriter.h>
+#include <mariana-trench/Model.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Timer.h>
+#include <mariana-trench/WorkerPool.h>
+#include <mariana-trench/tests/Test.h>
+
+/**
+ * Round-trip benchmark of the serialization of models, on the `model@*.json`
+ * shards of a previous run of the analysis.
+ *
+ * The directory of shards is given by the `MARIANA_TRENCH_BENCHMARK_MODELS`
+ * environment variable. Methods of the models are created as stubs, since the
+ * classes of the analyzed program are not available. Field and literal models
+ * are ignored.
+ *
+ * Each iteration parses the lines of the shards, builds the models, writes
+ * them back with the streaming writer and then writes them as shards, and
+ * reports the throughput of each phase as counters. Written models are
+ * compared to their input, without the method position, which is not known
+ * without the program. The number of differing models is reported as
+ * `mismatches`, and should be 0.
+ */
+
+namespace marianatrench {
+
+namespace {
+
+constexpr const char* k_models_variable = "MARIANA_TRENCH_BENCHMARK_MODELS";
+
+/* Lines of the uncompressed model shards of the given directory. */
+std::vector<std::string> read_model_lines(
+    const std::filesystem::path& directory) {
+  std::vector<std::string> lines;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    auto filename = entry.path().filename().native();
+    if (filename.rfind("model@", 0) != 0 ||
+        entry.path().extension() != ".json") {
+      continue;
+    }
+    std::ifstream file(entry.path(), std::ios_base::binary);
+    std::string line;
+    while (std::getline(file, line)) {
+      // Skip the `@generated` header.
+      if (line.empty() || line.rfind("//", 0) == 0) {
+        continue;
+      }
+      lines.push_back(std::move(line));
+    }
+  }
+  return lines;
+}
+
+bool is_method_signature(std::string_view string) {
+  return !string.empty() && string.front() == 'L' &&
+      string.find(";.") != std::string_view::npos &&
+      string.find(":(") != std::string_view::npos;
+}
+
+/* Create a stub for each method signature found in the given value. */
+void create_stub_methods(const Json::Value& value) {
+  if (value.isString()) {
+    auto signature = value.asString();
+    if (is_method_signature(signature) &&
+        redex::get_method(signature) == nullptr) {
+      DexMethod::make_method(signature)->make_concrete(
+          DexAccessFlags::ACC_PUBLIC,
+          std::unique_ptr<IRCode>(),
+          /* is_virtual */ true);
+    }
+  } else if (value.isArray() || value.isObject()) {
+    for (const auto& element : value) {
+      create_stub_methods(element);
+    }
+  }
+}
+
+template <typename Function>
+void run_parallel(
+    std::size_t items,
+    unsigned int num_threads,
+    const Function& function) {
+  auto queue = work_queue<std::size_t>(
+      [&function](std::size_t index) { function(index); }, num_threads);
+  for (std::size_t index = 0; index < items; index++) {
+    queue.add_item(index);
+  }
+  queue.run_all();
+}
+
+double megabytes(std::size_t bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+static void ModelRoundTrip(benchmark::State& state) {
+  const char* directory = std::getenv(k_models_variable);
+  if (directory == nullptr) {
+    state.SkipWithError(
+        fmt::format("`{}` is not set", k_models_variable).c_str());
+    return;
+  }
+  auto num_threads = static_cast<unsigned int>(state.range(0));
+
+  test::ContextGuard guard;
+  auto context = test::make_empty_context();
+
+  // Keep model lines only, and compute their expected output once.
+  std::vector<std::string> lines;
+  std::vector<std::string> expected_lines;
+  std::size_t input_bytes = 0;
+  auto writer = JsonValidation::compact_writer();
+  for (auto& line : read_model_lines(directory)) {
+    auto value = JsonValidation::parse_json(line);
+    if (!value.isObject() || !value.isMember("method")) {
+      continue;
+    }
+    create_stub_methods(value);
+    value.removeMember("position");
+    std::ostringstream expected;
+    writer->write(value, &expected);
+    input_bytes += line.size();
+    lines.push_back(std::move(line));
+    expected_lines.push_back(expected.str());
+  }
+  if (lines.empty()) {
+    state.SkipWithError(fmt::format("No models in `{}`", directory).c_str());
+    return;
+  }
+
+  auto output_directory = std::filesystem::temp_directory_path() /
+      "mariana-trench-serialization-benchmark";
+
+  std::vector<Json::Value> values(lines.size());
+  std::vector<Model> models(lines.size());
+  std::vector<std::string> output_lines(lines.size());
+  double parse_seconds = 0.0;
+  double construct_seconds = 0.0;
+  double serialize_seconds = 0.0;
+  double write_seconds = 0.0;
+  std::size_t output_bytes = 0;
+  std::size_t mismatches = 0;
+
+  for (auto _ : state) {
+    Timer parse_timer;
+    run_parallel(lines.size(), num_threads, [&](std::size_t index) {
+      values[index] = JsonValidation::parse_json(lines[index]);
+    });
+    parse_seconds += parse_timer.duration_in_seconds();
+
+    Timer construct_timer;
+    run_parallel(lines.size(), num_threads, [&](std::size_t index) {
+      models[index] = Model::from_trusted_json(
+          Method::from_json(values[index]["method"], context),
+          values[index],
+          context);
+    });
+    construct_seconds += construct_timer.duration_in_seconds();
+
+    Timer serialize_timer;
+    run_parallel(lines.size(), num_threads, [&](std::size_t index) {
+      thread_local JsonWriter model_writer;
+      model_writer.clear();
+      models[index].write_json(model_writer, ExportOriginsMode::Always);
+      output_lines[index] = model_writer.str();
+    });
+    serialize_seconds += serialize_timer.duration_in_seconds();
+
+    std::filesystem::remove_all(output_directory);
+    std::filesystem::create_directories(output_directory);
+    Timer write_timer;
+    JsonValidation::write_sharded_json_lines(
+        output_directory,
+        /* batch_size */ 1000,
+        /* total_elements */ output_lines.size(),
+        "model@",
+        [&](std::size_t index, std::ostream& output) {
+          output << output_lines[index];
+        });
+    write_seconds += write_timer.duration_in_seconds();
+
+    output_bytes = 0;
+    mismatches = 0;
+    for (std::size_t index = 0; index < lines.size(); index++) {
+      output_bytes += output_lines[index].size();
+      if (output_lines[index] != expected_lines[index]) {
+        mismatches++;
+      }
+    }
+  }
+  std::filesystem::remove_all(output_directory);
+
+  auto iterations = static_cast<double>(state.iterations());
+  auto number_of_models = static_cast<double>(lines.size()) * iterations;
+  state.counters["models"] = static_cast<double>(lines.size());
+  state.counters["input_mb"] = megabytes(input_bytes);
+  state.counters["parse_mb_per_s"] =
+      megabytes(input_bytes) * iterations / parse_seconds;
+  state.counters["construct_models_per_s"] =
+      number_of_models / construct_seconds;
+  state.counters["serialize_models_per_s"] =
+      number_of_models / serialize_seconds;
+  state.counters["serialize_mb_per_s"] =
+      megabytes(output_bytes) * iterations / serialize_seconds;
+  state.counters["write_mb_per_s"] =
+      megabytes(output_bytes) * iterations / write_seconds;
+  state.counters["mismatches"] = static_cast<double>(mismatches);
+}
+// Argument: number of threads. Shards are always written by the default
+// number of threads.
+BENCHMARK(ModelRoundTrip)
+    ->ArgNames({"threads"})
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kSecond)
+    ->Iterations(3);
+
+} // namespace marianatrench
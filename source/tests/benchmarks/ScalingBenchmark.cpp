@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <json/json.h>
+
+#include <DexStore.h>
+
+#include <mariana-trench/Context.h>
+#include <mariana-trench/JsonValidation.h>
+#include <mariana-trench/MarianaTrench.h>
+#include <mariana-trench/Redex.h>
+#include <mariana-trench/Statistics.h>
+#include <mariana-trench/Timer.h>
+#include <mariana-trench/tests/Test.h>
+
+/**
+ * End-to-end benchmark of the analysis on synthetic programs.
+ *
+ * A synthetic program is made of static methods
+ * `LSynthetic/Class<c>;.method<m>:(Ljava/lang/Object;)Ljava/lang/Object;`
+ * which pass their argument along to their callees, and return it:
+ * - Methods are grouped in strongly connected components of the given size,
+ *   each method calling the next one of its component.
+ * - Each method calls `fan_out - 1` other methods, in later components, so
+ *   that components form a DAG.
+ * - Classes form override chains of the given depth, through a virtual `run`
+ *   method returning its argument, which is called on the root of the chain
+ *   once per component.
+ * - Methods call the source and the sink every `1000 / density` methods.
+ *
+ * Each benchmark runs `MarianaTrench::analyze` and reports the analysis
+ * statistics as counters: per-phase time (in seconds), number of global
+ * iterations and peak resident set size (in GB).
+ */
+
+namespace marianatrench {
+
+namespace {
+
+constexpr std::size_t k_methods_per_class = 8;
+constexpr std::string_view k_origin_class = "LSynthetic/Origin;";
+constexpr std::string_view k_method_prototype =
+    "(Ljava/lang/Object;)Ljava/lang/Object;";
+
+struct ProgramShape {
+  std::size_t methods;
+  std::size_t fan_out;
+  std::size_t component_size;
+  std::size_t override_depth;
+  std::size_t density_per_thousand;
+
+  static ProgramShape from_state(const benchmark::State& state) {
+    return ProgramShape{
+        .methods = static_cast<std::size_t>(state.range(0)),
+        .fan_out = static_cast<std::size_t>(state.range(1)),
+        .component_size = static_cast<std::size_t>(state.range(2)),
+        .override_depth = static_cast<std::size_t>(state.range(3)),
+        .density_per_thousand = static_cast<std::size_t>(state.range(4)),
+    };
+  }
+
+  std::size_t classes() const {
+    return (methods + k_methods_per_class - 1) / k_methods_per_class;
+  }
+};
+
+std::string class_name(std::size_t klass) {
+  return fmt::format("LSynthetic/Class{};", klass);
+}
+
+std::string method_name(std::size_t method) {
+  return fmt::format(
+      "{}.method{}:{}",
+      class_name(method / k_methods_per_class),
+      method % k_methods_per_class,
+      k_method_prototype);
+}
+
+/* Root of the override chain of the given class. */
+std::size_t chain_root(const ProgramShape& shape, std::size_t klass) {
+  return klass - klass % std::max<std::size_t>(shape.override_depth, 1);
+}
+
+std::string method_body(const ProgramShape& shape, std::size_t method) {
+  std::string body = "(load-param-object v0)\n";
+
+  auto source_sink_period = shape.density_per_thousand == 0
+      ? 0
+      : std::max<std::size_t>(1000 / shape.density_per_thousand, 1);
+  bool has_source_and_sink =
+      source_sink_period != 0 && method % source_sink_period == 0;
+  if (has_source_and_sink) {
+    body += fmt::format(
+        "(invoke-static () \"{}.source:()Ljava/lang/Object;\")\n"
+        "(move-result-object v0)\n",
+        k_origin_class);
+  }
+
+  // Call the next method of the component.
+  auto component_begin = method - method % shape.component_size;
+  auto next = component_begin + (method + 1 - component_begin) %
+          shape.component_size;
+  if (next < shape.methods && next != method) {
+    body += fmt::format(
+        "(invoke-static (v0) \"{}\")\n(move-result-object v0)\n",
+        method_name(next));
+  }
+
+  // Call methods in later components.
+  auto later_begin = component_begin + shape.component_size;
+  if (later_begin < shape.methods) {
+    auto later_methods = shape.methods - later_begin;
+    for (std::size_t index = 1; index < shape.fan_out; index++) {
+      auto callee =
+          later_begin + (method * 7919 + index * 104729) % later_methods;
+      body += fmt::format(
+          "(invoke-static (v0) \"{}\")\n(move-result-object v0)\n",
+          method_name(callee));
+    }
+  }
+
+  // Call the override chain once per component.
+  if (method == component_begin) {
+    auto root = class_name(chain_root(shape, method / k_methods_per_class));
+    body += fmt::format(
+        "(new-instance \"{0}\")\n"
+        "(move-result-pseudo-object v1)\n"
+        "(invoke-virtual (v1 v0) \"{0}.run:{1}\")\n"
+        "(move-result-object v0)\n",
+        root,
+        k_method_prototype);
+  }
+
+  if (has_source_and_sink) {
+    body += fmt::format(
+        "(invoke-static (v0) \"{}.sink:(Ljava/lang/Object;)V\")\n",
+        k_origin_class);
+  }
+
+  body += "(return-object v0)\n";
+  return fmt::format(
+      "(method (public static) \"{}\"\n(\n{}))",
+      method_name(method),
+      body);
+}
+
+void create_program(Scope& scope, const ProgramShape& shape) {
+  redex::create_methods(
+      scope,
+      std::string(k_origin_class),
+      std::vector<std::string>{
+          fmt::format(
+              R"((method (public static) "{}.source:()Ljava/lang/Object;"
+                  (
+                    (const v0 0)
+                    (return-object v0)
+                  )))",
+              k_origin_class),
+          fmt::format(
+              R"((method (public static) "{}.sink:(Ljava/lang/Object;)V"
+                  (
+                    (load-param-object v0)
+                    (return-void)
+                  )))",
+              k_origin_class),
+      });
+
+  for (std::size_t klass = 0; klass < shape.classes(); klass++) {
+    auto name = class_name(klass);
+    std::vector<std::string> bodies;
+    auto end = std::min(shape.methods, (klass + 1) * k_methods_per_class);
+    for (auto method = klass * k_methods_per_class; method < end; method++) {
+      bodies.push_back(method_body(shape, method));
+    }
+    bodies.push_back(fmt::format(
+        R"((method (public) "{}.run:{}"
+            (
+              (load-param-object v0)
+              (load-param-object v1)
+              (return-object v1)
+            )))",
+        name,
+        k_method_prototype));
+
+    const DexType* super = nullptr;
+    if (chain_root(shape, klass) != klass) {
+      super = redex::get_type(class_name(klass - 1));
+    }
+    redex::create_methods(scope, name, bodies, super);
+  }
+}
+
+void write_configuration(const std::filesystem::path& directory) {
+  auto models = test::parse_json(fmt::format(
+      R"([
+        {{
+          "method": "{0}.source:()Ljava/lang/Object;",
+          "generations": [{{"kind": "Source", "port": "Return"}}]
+        }},
+        {{
+          "method": "{0}.sink:(Ljava/lang/Object;)V",
+          "sinks": [{{"kind": "Sink", "port": "Argument(0)"}}]
+        }}
+      ])",
+      k_origin_class));
+  JsonValidation::write_json_file(directory / "models.json", models);
+
+  auto rules = test::parse_json(R"([
+    {
+      "name": "Flow",
+      "code": 1,
+      "description": "",
+      "sources": ["Source"],
+      "sinks": ["Sink"]
+    }
+  ])");
+  JsonValidation::write_json_file(directory / "rules.json", rules);
+}
+
+double peak_resident_set_size_in_gb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  // Reported in bytes on macOS, in kilobytes on Linux.
+  return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0 * 1024.0);
+#else
+  return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#endif
+}
+
+void report_statistics(benchmark::State& state, const Statistics& statistics) {
+  auto value = statistics.to_json();
+  state.counters["iterations"] = value["iterations"].asDouble();
+  state.counters["peak_rss_gb"] = peak_resident_set_size_in_gb();
+  for (const auto& name : value["times"].getMemberNames()) {
+    state.counters[name] = value["times"][name].asDouble();
+  }
+}
+
+} // namespace
+
+static void EndToEnd(benchmark::State& state) {
+  auto shape = ProgramShape::from_state(state);
+
+  auto directory =
+      std::filesystem::temp_directory_path() / "mariana-trench-benchmark";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  write_configuration(directory);
+
+  for (auto _ : state) {
+    test::ContextGuard guard;
+    Context context;
+    context.options = std::make_unique<Options>(
+        /* models_paths */
+        std::vector<std::string>{(directory / "models.json").native()},
+        /* field_models_path */ std::vector<std::string>{},
+        /* literal_models_path */ std::vector<std::string>{},
+        /* rules_paths */
+        std::vector<std::string>{(directory / "rules.json").native()},
+        /* lifecycles_paths */ std::vector<std::string>{},
+        /* shims_path */ std::vector<std::string>{},
+        /* graphql_metadata_paths */ std::string{},
+        /* proguard_configuration_paths */ std::vector<std::string>{},
+        /* sequential */ false,
+        /* skip_source_indexing */ true,
+        /* skip_analysis */ false,
+        /* model_generators_configuration */
+        std::vector<ModelGeneratorConfiguration>{},
+        /* model_generator_search_paths */ std::vector<std::string>{},
+        /* remove_unreachable_code */ false,
+        /* emit_all_via_cast_features */ false);
+
+    Scope scope;
+    create_program(scope, shape);
+    DexStore store("synthetic");
+    store.add_classes(scope);
+    context.stores.push_back(store);
+
+    // Only time the analysis, not the generation of the program.
+    Timer timer;
+    auto registry = MarianaTrench().analyze(context);
+    state.SetIterationTime(timer.duration_in_seconds());
+
+    benchmark::DoNotOptimize(registry);
+    report_statistics(state, *context.statistics);
+  }
+
+  state.counters["methods"] = static_cast<double>(shape.methods);
+  std::filesystem::remove_all(directory);
+}
+// Arguments: methods, fan-out, component size, override depth, source and
+// sink density (per thousand methods).
+BENCHMARK(EndToEnd)
+    ->ArgNames({"methods", "fan_out", "scc", "depth", "density"})
+    ->Args({1000, 2, 1, 1, 10})
+    ->Args({10000, 2, 1, 1, 10})
+    ->Args({100000, 2, 1, 1, 10})
+    ->Args({10000, 8, 1, 1, 10})
+    ->Args({10000, 2, 16, 1, 10})
+    ->Args({10000, 2, 256, 1, 10})
+    ->Args({10000, 2, 1, 16, 10})
+    ->Args({10000, 2, 1, 1, 200})
+    ->Unit(benchmark::kSecond)
+    ->UseManualTime()
+    ->Iterations(1);
+
+} // namespace marianatrench
@@ -5,6 +5,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <string>
+#include <tuple>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 #include <fmt/format.h>
@@ -17,6 +20,7 @@
 #include <JarLoader.h>
 #include <RedexContext.h>
 
+#include <mariana-trench/Assert.h>
 #include <mariana-trench/Context.h>
 #include <mariana-trench/Filesystem.h>
 #include <mariana-trench/JsonValidation.h>
@@ -31,6 +35,32 @@ namespace {
 struct IntegrationTest : public test::ContextGuard,
                          public testing::TestWithParam<std::string> {};
 
+enum class Fixpoint {
+  GlobalIterations,
+  Worklist,
+  StronglyConnectedComponents,
+  Deterministic,
+};
+
+std::string show(Fixpoint fixpoint) {
+  switch (fixpoint) {
+    case Fixpoint::GlobalIterations:
+      return "global_iterations";
+    case Fixpoint::Worklist:
+      return "worklist";
+    case Fixpoint::StronglyConnectedComponents:
+      return "scc";
+    case Fixpoint::Deterministic:
+      return "deterministic";
+  }
+  mt_unreachable();
+}
+
+/* Check that other fixpoints compute the models of the global iterations. */
+struct IntegrationFixpointTest
+    : public test::ContextGuard,
+      public testing::TestWithParam<std::tuple<std::string, Fixpoint>> {};
+
 std::filesystem::path root_directory() {
   return std::filesystem::path(__FILE__).parent_path() / "code";
 }
@@ -76,28 +106,12 @@ void compare_expected(
   compare_expected(directory, filename, expected, actual_string.str());
 }
 
-} // namespace
-
-namespace marianatrench {
-
-TEST_P(IntegrationTest, CompareFlows) {
-  std::filesystem::path name = GetParam();
-  LOG(1, "Test case `{}`", name);
+Registry analyze(
+    Context& context,
+    const std::filesystem::path& name,
+    Fixpoint fixpoint) {
   std::filesystem::path directory = root_directory() / name;
 
-  std::string expected_output =
-      load_expected_json(directory, "expected_output.json");
-  std::string expected_class_hierarchies =
-      load_expected_json(directory, "expected_class_hierarchies.json");
-  std::string expected_overrides =
-      load_expected_json(directory, "expected_overrides.json");
-  std::string expected_call_graph =
-      load_expected_json(directory, "expected_call_graph.json");
-  std::string expected_dependencies =
-      load_expected_json(directory, "expected_dependencies.json");
-
-  Context context;
-
   std::vector<std::string> lifecycles_paths;
   auto lifecycles_path = directory / "lifecycles.json";
   if (std::filesystem::exists(lifecycles_path)) {
@@ -170,7 +184,11 @@ TEST_P(IntegrationTest, CompareFlows) {
       /* source_root_directory */ directory.string(),
       /* enable_cross_component_analysis */ true,
       /* export_origins_mode */ ExportOriginsMode::Always,
-      propagate_across_arguments);
+      propagate_across_arguments,
+      /* enable_worklist_fixpoint */ fixpoint == Fixpoint::Worklist,
+      /* enable_scc_fixpoint */ fixpoint ==
+          Fixpoint::StronglyConnectedComponents,
+      /* deterministic */ fixpoint == Fixpoint::Deterministic);
 
   // Load test Java classes
   std::filesystem::path dex_path = test::find_dex_path(directory);
@@ -185,7 +203,31 @@ TEST_P(IntegrationTest, CompareFlows) {
 
   // Run the analysis.
   auto tool = MarianaTrench();
-  auto registry = tool.analyze(context);
+  return tool.analyze(context);
+}
+
+} // namespace
+
+namespace marianatrench {
+
+TEST_P(IntegrationTest, CompareFlows) {
+  std::filesystem::path name = GetParam();
+  LOG(1, "Test case `{}`", name);
+  std::filesystem::path directory = root_directory() / name;
+
+  std::string expected_output =
+      load_expected_json(directory, "expected_output.json");
+  std::string expected_class_hierarchies =
+      load_expected_json(directory, "expected_class_hierarchies.json");
+  std::string expected_overrides =
+      load_expected_json(directory, "expected_overrides.json");
+  std::string expected_call_graph =
+      load_expected_json(directory, "expected_call_graph.json");
+  std::string expected_dependencies =
+      load_expected_json(directory, "expected_dependencies.json");
+
+  Context context;
+  auto registry = analyze(context, name, Fixpoint::GlobalIterations);
 
   // Compare the results.
   compare_expected(
@@ -220,4 +262,39 @@ MT_INSTANTIATE_TEST_SUITE_P(
     IntegrationTest,
     testing::ValuesIn(test::sub_directories(root_directory())));
 
+TEST_P(IntegrationFixpointTest, CompareModels) {
+  std::filesystem::path name = std::get<0>(GetParam());
+  auto fixpoint = std::get<1>(GetParam());
+  LOG(1, "Test case `{}` with the {} fixpoint", name, show(fixpoint));
+  std::filesystem::path directory = root_directory() / name;
+
+  std::string expected_output =
+      load_expected_json(directory, "expected_output.json");
+
+  Context context;
+  auto registry = analyze(context, name, fixpoint);
+
+  compare_expected(
+      directory,
+      fmt::format("expected_output.json.{}", show(fixpoint)),
+      expected_output,
+      registry.dump_models());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Integration,
+    IntegrationFixpointTest,
+    testing::Combine(
+        testing::ValuesIn(test::sub_directories(root_directory())),
+        testing::Values(
+            Fixpoint::Worklist,
+            Fixpoint::StronglyConnectedComponents,
+            Fixpoint::Deterministic)),
+    [](const ::testing::TestParamInfo<IntegrationFixpointTest::ParamType>&
+           info) -> std::string {
+      std::filesystem::path name = std::get<0>(info.param);
+      return fmt::format(
+          "{}_{}", name.stem().string(), show(std::get<1>(info.param)));
+    });
+
 } // namespace marianatrench
@@ -102,8 +102,13 @@ TEST_P(JsonModelGeneratorIntegrationTest, CompareModels) {
   context.types = std::make_unique<Types>(*context.options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
   context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
   context.call_graph = std::make_unique<CallGraph>(
       *context.options,
       *context.types,
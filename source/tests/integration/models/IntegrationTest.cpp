@@ -499,10 +499,15 @@ TEST_P(IntegrationTest, ReturnsExpectedModel) {
   context.types = std::make_unique<Types>(options, context.stores);
   context.class_hierarchies =
       std::make_unique<ClassHierarchies>(*context.options, context.stores);
-  context.field_cache =
-      std::make_unique<FieldCache>(*context.class_hierarchies, context.stores);
+  context.class_intervals =
+      std::make_unique<ClassIntervals>(*context.options, context.stores);
+  context.field_cache = std::make_unique<FieldCache>(
+      *context.class_hierarchies, *context.class_intervals, context.stores);
   context.overrides = std::make_unique<Overrides>(
-      *context.options, *context.methods, context.stores);
+      *context.options,
+      *context.methods,
+      *context.class_intervals,
+      context.stores);
   context.call_graph = std::make_unique<CallGraph>(
       *context.options,
       *context.types,
@@ -517,8 +522,6 @@ TEST_P(IntegrationTest, ReturnsExpectedModel) {
   context.rules = std::make_unique<Rules>(context, rules);
   context.used_kinds = std::make_unique<UsedKinds>(
       UsedKinds::from_rules(*context.rules, *context.transforms_factory));
-  context.class_intervals =
-      std::make_unique<ClassIntervals>(*context.options, context.stores);
 
   Registry registry(context);
   registry.join_with(Registry(